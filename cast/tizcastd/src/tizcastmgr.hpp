@@ -129,6 +129,16 @@ namespace tiz
        */
       std::string device_name_or_ip () const;
 
+      /**
+       * Retrieve the file descriptor of the socket connected to the
+       * Chromecast device. This may change after a poll command has been
+       * dispatched.
+       *
+       * @return The socket's file descriptor, or -1 if there is no connection
+       * at the moment.
+       */
+      int socket_fd () const;
+
     private:
       OMX_ERRORTYPE start_fsm ();
 
@@ -158,6 +158,11 @@ void cast::ops::do_poll (int poll_time_ms)
   }
 }
 
+int cast::ops::socket_fd () const
+{
+  return p_cc_ ? tiz_chromecast_get_socket_fd (p_cc_) : -1;
+}
+
 void cast::ops::do_load_url (const std::string &url,
                              const std::string &mime_type,
                              const std::string &title,
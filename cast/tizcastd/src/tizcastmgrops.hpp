@@ -95,6 +95,8 @@ namespace tiz
       int internal_error () const;
       std::string internal_error_msg () const;
 
+      int socket_fd () const;
+
     private:
       cast::uuid_t uuid () const;
 
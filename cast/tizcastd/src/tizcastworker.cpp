@@ -30,6 +30,10 @@
 #endif
 
 #include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <vector>
@@ -52,6 +56,10 @@
 
 #define TIZ_CAST_WORKER_QUEUE_MAX_ITEMS 30
 
+// How often the Chromecast clients get polled, regardless of the activity on
+// their sockets (this is for heartbeats, reconnections, etc)
+#define TIZ_CAST_WORKER_HOUSEKEEPING_MS 1000
+
 namespace cast = tiz::cast;
 
 namespace
@@ -61,6 +69,13 @@ namespace
   {
     return operand.type () == typeid (T);
   }
+
+  uint64_t now_ms ()
+  {
+    struct timespec ts;
+    (void)clock_gettime (CLOCK_MONOTONIC, &ts);
+    return static_cast< uint64_t > (ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+  }
 }  // namespace
 
 void *cast::thread_func (void *p_arg)
@@ -68,10 +83,13 @@ void *cast::thread_func (void *p_arg)
   worker *p_worker = static_cast< worker * > (p_arg);
   void *p_data = NULL;
   bool done = false;
-  int poll_time_ms = 100;  // ms
-  // Pre-allocated poll command
+  // Pre-allocated poll command. A poll time of zero tells the Chromecast
+  // client that there is something to do, i.e. it need not wait on the
+  // socket itself.
   uuid_t null_uuid;
-  cast::cmd cmd (null_uuid, cast::poll_evt (poll_time_ms));
+  cast::cmd cmd (null_uuid, cast::poll_evt (0));
+  std::vector< int > ready_fds;
+  uint64_t next_housekeeping_ms = now_ms () + TIZ_CAST_WORKER_HOUSEKEEPING_MS;
 
   assert (p_worker);
 
@@ -80,21 +98,43 @@ void *cast::thread_func (void *p_arg)
 
   while (!done)
   {
-    tiz_queue_timed_receive (p_worker->p_queue_, &p_data, poll_time_ms);
+    // Sleep until a command is posted or a device has sent something. The
+    // Python interpreter is only entered when there is something to do.
+    const uint64_t now = now_ms ();
+    const int timeout_ms
+        = p_worker->clients_.empty ()
+              ? -1
+              : static_cast< int > (next_housekeeping_ms > now
+                                        ? next_housekeeping_ms - now
+                                        : 0);
+    p_worker->wait_for_events (timeout_ms, ready_fds);
 
     // Dispatch events from the command queue
-    if (p_data)
+    while (!done && tiz_queue_length (p_worker->p_queue_) > 0)
     {
+      tiz_check_omx_ret_null (
+          tiz_queue_receive (p_worker->p_queue_, &p_data));
       cast::cmd *p_cmd = static_cast< cast::cmd * > (p_data);
       done = cast::worker::dispatch_cmd (p_worker, p_cmd);
       delete p_cmd;
       p_data = NULL;
     }
 
-    // This is to poll the chromecast sockets periodically
+    // Let the clients process what they've received on their sockets
     if (!done)
     {
-      cast::worker::poll_mgrs (p_worker, &cmd);
+      const bool housekeeping = now_ms () >= next_housekeeping_ms;
+      if (housekeeping)
+      {
+        next_housekeeping_ms = now_ms () + TIZ_CAST_WORKER_HOUSEKEEPING_MS;
+        // Housekeeping polls every client anyway; give the sockets that hung
+        // up another chance, in case a reconnection has reused their fds
+        p_worker->hungup_fds_.clear ();
+      }
+      if (housekeeping || !ready_fds.empty ())
+      {
+        cast::worker::poll_mgrs (p_worker, &cmd, ready_fds, housekeeping);
+      }
     }
   }
 
@@ -117,9 +157,13 @@ cast::worker::worker (cast_status_cback_t cast_cb,
     thread_ (),
     mutex_ (),
     sem_ (),
-    p_queue_ (NULL)
+    p_queue_ (NULL),
+    wake_fds_ (),
+    pfds_ (),
+    hungup_fds_ ()
 {
   TIZ_LOG (TIZ_PRIORITY_TRACE, "Constructing...");
+  wake_fds_[0] = wake_fds_[1] = -1;
   int rc = tiz_chromecast_ctx_init (&(p_cc_ctx_));
   assert (0 == rc);
 }
@@ -251,6 +295,8 @@ cast::worker::create_cmd_queue ()
   tiz_check_omx_ret_oom (tiz_sem_init (&sem_, 0));
   tiz_check_omx_ret_oom (
       tiz_queue_init (&p_queue_, TIZ_CAST_WORKER_QUEUE_MAX_ITEMS));
+  tiz_check_true_ret_val (0 == pipe2 (wake_fds_, O_NONBLOCK | O_CLOEXEC),
+                          OMX_ErrorInsufficientResources);
   return OMX_ErrorNone;
 }
 
@@ -259,6 +305,14 @@ void cast::worker::destroy_cmd_queue ()
   tiz_mutex_destroy (&mutex_);
   tiz_sem_destroy (&sem_);
   tiz_queue_destroy (p_queue_);
+  for (int i = 0; i < 2; ++i)
+  {
+    if (wake_fds_[i] >= 0)
+    {
+      (void)close (wake_fds_[i]);
+      wake_fds_[i] = -1;
+    }
+  }
 }
 
 OMX_ERRORTYPE
@@ -271,9 +325,82 @@ cast::worker::post_cmd (cast::cmd *p_cmd)
   tiz_check_omx_ret_oom (tiz_queue_send (p_queue_, p_cmd));
   tiz_check_omx_ret_oom (tiz_mutex_unlock (&mutex_));
 
+  // Wake up the worker thread. If the pipe is full, the thread has plenty of
+  // wake-ups pending already.
+  const char wake = 1;
+  ssize_t ret = 0;
+  do
+  {
+    ret = write (wake_fds_[1], &wake, sizeof (wake));
+  } while (ret < 0 && EINTR == errno);
+
   return OMX_ErrorNone;
 }
 
+void cast::worker::wait_for_events (const int timeout_ms,
+                                    std::vector< int > &ready_fds)
+{
+  struct pollfd pfd;
+  std::vector< int > hungup_fds;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+
+  pfds_.clear ();
+  pfd.fd = wake_fds_[0];
+  pfds_.push_back (pfd);
+  BOOST_FOREACH (const clients_pair_t &clnt, clients_)
+  {
+    pfd.fd = clnt.second.p_cast_mgr_->socket_fd ();
+    if (pfd.fd >= 0)
+    {
+      if (std::find (hungup_fds_.begin (), hungup_fds_.end (), pfd.fd)
+          != hungup_fds_.end ())
+      {
+        // Still the socket that hung up; the client hasn't reconnected yet
+        hungup_fds.push_back (pfd.fd);
+      }
+      else
+      {
+        pfds_.push_back (pfd);
+      }
+    }
+  }
+  // Forget the sockets that the clients have replaced
+  hungup_fds_.swap (hungup_fds);
+
+  ready_fds.clear ();
+  if (poll (&(pfds_[0]), pfds_.size (), timeout_ms) <= 0)
+  {
+    // Timeout (or EINTR): it is probably time for housekeeping
+    return;
+  }
+
+  if (pfds_[0].revents & POLLIN)
+  {
+    // Drain the wake-up pipe; the commands are in the queue
+    char buf[64];
+    while (read (wake_fds_[0], buf, sizeof (buf)) > 0)
+    {
+    }
+  }
+
+  for (size_t i = 1; i < pfds_.size (); ++i)
+  {
+    if (pfds_[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+    {
+      // The client needs to see this to start reconnecting, but the socket
+      // stays 'ready' until it is closed. So it is left out of the poll set
+      // until the client replaces it, or until the next housekeeping.
+      hungup_fds_.push_back (pfds_[i].fd);
+      ready_fds.push_back (pfds_[i].fd);
+    }
+    else if (pfds_[i].revents & POLLIN)
+    {
+      ready_fds.push_back (pfds_[i].fd);
+    }
+  }
+}
+
 void cast::worker::remove_client (const uuid_t &uuid, cast::mgr *p_mgr)
 {
   assert (p_mgr);
@@ -374,7 +501,9 @@ bool cast::worker::dispatch_cmd (cast::worker *p_worker, const cast::cmd *p_cmd)
   return false;
 }
 
-void cast::worker::poll_mgrs (cast::worker *p_worker, const cast::cmd *p_cmd)
+void cast::worker::poll_mgrs (cast::worker *p_worker, const cast::cmd *p_cmd,
+                              const std::vector< int > &ready_fds,
+                              const bool housekeeping)
 {
   int i = 0;
   std::vector< clients_pair_t > finished_clients;
@@ -389,7 +518,14 @@ void cast::worker::poll_mgrs (cast::worker *p_worker, const cast::cmd *p_cmd)
     assert (p_mgr);
     if (!p_mgr->terminated ())
     {
-      (void)p_mgr->dispatch_cmd (p_cmd);
+      // Devices without a connection are only polled for housekeeping
+      if (housekeeping
+          || std::find (ready_fds.begin (), ready_fds.end (),
+                        p_mgr->socket_fd ())
+                 != ready_fds.end ())
+      {
+        (void)p_mgr->dispatch_cmd (p_cmd);
+      }
     }
     else
     {
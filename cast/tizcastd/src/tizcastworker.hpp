@@ -31,6 +31,9 @@
 
 #include <map>
 #include <string>
+#include <vector>
+
+#include <poll.h>
 
 #include <boost/function.hpp>
 
@@ -225,7 +228,12 @@ namespace tiz
 
       static bool dispatch_cmd (worker *p_worker, const cmd *p_cmd);
 
-      static void poll_mgrs (worker *p_worker, const cmd *p_cmd);
+      void wait_for_events (const int timeout_ms,
+                            std::vector< int > &ready_fds);
+
+      static void poll_mgrs (worker *p_worker, const cmd *p_cmd,
+                             const std::vector< int > &ready_fds,
+                             const bool housekeeping);
 
     private:
       struct client_info
@@ -269,6 +277,13 @@ namespace tiz
       tiz_mutex_t mutex_;
       tiz_sem_t sem_;
       tiz_queue_t *p_queue_;
+      // A pipe used to wake up the worker thread when a command is posted,
+      // as it spends its time waiting on the devices' sockets.
+      int wake_fds_[2];
+      std::vector< struct pollfd > pfds_;
+      // Sockets that have hung up and have not been replaced yet by their
+      // clients' reconnection logic
+      std::vector< int > hungup_fds_;
     };
 
     typedef boost::shared_ptr< worker > worker_ptr_t;
@@ -38,6 +38,7 @@ from pychromecast.controllers.media import MEDIA_PLAYER_STATE_UNKNOWN
 from pychromecast.controllers.media import STREAM_TYPE_BUFFERED
 from pychromecast.controllers.media import STREAM_TYPE_LIVE
 from pychromecast.controllers.media import STREAM_TYPE_UNKNOWN
+from pychromecast.error import ChromecastConnectionError
 from pychromecast.error import PyChromecastError
 
 # For use during debugging
@@ -226,27 +227,54 @@ class tizchromecastproxy(object):
             exc_type, value, traceback = sys.exc_info()
             print_exception(exc_type, value, traceback)
 
+    def socket_fileno(self):
+        """Return the file descriptor of the socket connected to the device, or
+        -1 if there is no connection at the moment.
+
+        """
+        sock = self.cast.socket_client.get_socket() if self.cast else None
+        if sock:
+            return sock.fileno()
+        return -1
+
     def poll_socket(self, polltime_ms):
-        print_nfo("[Chromecast] [{0}] [poll_socket start]".format(
-            to_ascii(self.ip_addr)))
-        polltime_s = polltime_ms / 1000
+        """Process the events received on the device socket.
+
+        Wait for up to 'polltime_ms' for the socket to become readable. A poll
+        time of zero means that the caller already knows that there is
+        something to do (the socket is readable, or it is time for the
+        connection's housekeeping), and the socket client is run
+        unconditionally.
+
+        Return the socket's file descriptor (which changes when pychromecast
+        reconnects), or -1. Raise ChromecastConnectionError once pychromecast
+        has given up reconnecting to the device.
+
+        """
         sock = self.cast.socket_client.get_socket()
-        if sock and sock.fileno() != -1:
-            can_read, _, _ = select.select([sock], [], [], 0.1)
-            # can_read = True
-            if can_read:
-                print_nfo("[Chromecast] [{0}] [poll_socket can_read]".format(
-                    to_ascii(self.ip_addr)))
-                # Received something on the socket, gets handled with run_once()
-                try:
-                    self.cast.socket_client.run_once()
-                    print_nfo(
-                        "[Chromecast] [{0}] [poll_socket read_once]".format(
-                            to_ascii(self.ip_addr)))
-                except Exception as exception:
-                    pass
-        print_wrn("[Chromecast] [{0}] [poll_socket end]".format(
-            to_ascii(self.ip_addr)))
+        connected = sock is not None and sock.fileno() != -1
+        can_read = polltime_ms == 0
+        if not can_read and connected:
+            can_read, _, _ = select.select([sock], [], [],
+                                           polltime_ms / 1000.0)
+        if can_read:
+            # Received something on the socket, or the connection was lost;
+            # run_once() handles both, reconnecting if needed
+            stop = 0
+            try:
+                stop = self.cast.socket_client.run_once()
+                # TLS records already decrypted and buffered in the ssl
+                # object won't make the socket readable again
+                while stop == 0 and connected and sock.fileno() != -1 \
+                      and hasattr(sock, "pending") and sock.pending() > 0:
+                    stop = self.cast.socket_client.run_once()
+            except Exception as exception:
+                pass
+            if stop == 1:
+                raise ChromecastConnectionError(
+                    "Lost the connection to {0}".format(
+                        to_ascii(self.ip_addr)))
+        return self.socket_fileno()
 
     def media_load(
             self,
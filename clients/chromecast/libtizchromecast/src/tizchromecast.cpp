@@ -41,11 +41,37 @@
 
 namespace bp = boost::python;
 
+namespace
+{
+  // Holds the Python interpreter lock for as long as the object is alive.
+  // The interpreter is shared with the other client libraries, which may be
+  // using it from their own threads.
+  class gil_lock
+  {
+  public:
+    gil_lock () : state_ (PyGILState_Ensure ())
+    {
+    }
+    ~gil_lock ()
+    {
+      PyGILState_Release (state_);
+    }
+
+  private:
+    gil_lock (const gil_lock &);
+    gil_lock &operator= (const gil_lock &);
+
+  private:
+    PyGILState_STATE state_;
+  };
+}  // namespace
+
 /* This macro assumes the existence of an "tiz_chromecast_error_t rc" local
  * variable */
 #define try_catch_wrapper(expr)                                  \
   do                                                             \
     {                                                            \
+      gil_lock gil;                                              \
       try                                                        \
         {                                                        \
           (expr);                                                \
@@ -75,7 +101,8 @@ tizchromecast::tizchromecast (const tizchromecastctx &cc_ctx,
   : cc_ctx_ (cc_ctx),
     name_or_ip_ (name_or_ip),
     cbacks_ (),
-    p_user_data_ (ap_user_data)
+    p_user_data_ (ap_user_data),
+    socket_fd_ (-1)
 {
   if (ap_cbacks)
     {
@@ -113,6 +140,11 @@ tiz_chromecast_error_t tizchromecast::start ()
           bp::make_function (cast_status_handler),
           bp::make_function (media_status_handler)));
     }
+  if (ETizCcErrorNoError == rc)
+    {
+      try_catch_wrapper (socket_fd_ = bp::extract< int > (
+                             py_cc_proxy.attr ("socket_fileno") ()));
+    }
   // std::cout << "tizchromecast::start: rc " << rc << std::endl;
   return rc;
 }
@@ -126,6 +158,7 @@ void tizchromecast::stop ()
           cc_ctx_.get_cc_proxy (name_or_ip_).attr ("deactivate") ());
       try_catch_wrapper (cc_ctx_.destroy_cc_proxy (name_or_ip_));
     }
+  socket_fd_ = -1;
   (void)rc;
 }
 
@@ -140,13 +173,19 @@ tiz_chromecast_error_t tizchromecast::poll_socket (int a_poll_time_ms)
 
   if (cc_ctx_.cc_proxy_exists (name_or_ip_))
     {
-      try_catch_wrapper (
-          cc_ctx_.get_cc_proxy (name_or_ip_)
-              .attr ("poll_socket") (bp::object (a_poll_time_ms)));
+      try_catch_wrapper (socket_fd_ = bp::extract< int > (
+                             cc_ctx_.get_cc_proxy (name_or_ip_)
+                                 .attr ("poll_socket") (
+                                     bp::object (a_poll_time_ms))));
     }
   return rc;
 }
 
+int tizchromecast::socket_fd () const
+{
+  return socket_fd_;
+}
+
 tiz_chromecast_error_t tizchromecast::media_load (
     const std::string &url, const std::string &content_type,
     const std::string &title, const std::string &album_art)
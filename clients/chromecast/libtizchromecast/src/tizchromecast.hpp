@@ -85,6 +85,7 @@ public:
   void deinit ();
 
   tiz_chromecast_error_t poll_socket (int a_poll_time_ms);
+  int socket_fd () const;
 
   tiz_chromecast_error_t media_load (const std::string &url,
                                      const std::string &content_type,
@@ -110,6 +111,7 @@ private:
   std::string title_;
   tiz_chromecast_callbacks_t cbacks_;
   void *p_user_data_;
+  int socket_fd_;  // Updated on every poll; read without the GIL
 };
 
 #endif  // TIZCHROMECAST_HPP
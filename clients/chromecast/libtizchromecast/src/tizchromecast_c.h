@@ -76,18 +76,40 @@ extern "C"
 
   /**
    * Poll to read any events received on the chromecast socket. This function
-   * needs to be called periodically (e.g. from the client's event loop).
+   * needs to be called when the socket returned by
+   * tiz_chromecast_get_socket_fd is readable, and also periodically (about
+   * once a second) so that the connection's housekeeping (heartbeats and
+   * reconnections) can take place.
    *
    * @ingroup libtizchromecast
    *
    * @param ap_chromecast The Tizonia Chromecast handle.
-   * @param a_poll_time_ms The polling time, in milliseconds.
+   * @param a_poll_time_ms The polling time, in milliseconds. Zero means that
+   * the socket is known to be readable, or that it is time for housekeeping.
    *
    * @return ETizCcErrorNoError on success.
    */
   tiz_chromecast_error_t tiz_chromecast_poll (tiz_chromecast_t *ap_chromecast,
                                               int a_poll_time_ms);
 
+  /**
+   * Retrieve the file descriptor of the socket connected to the Chromecast
+   * device, so that the client can wait on it in its own event loop. The
+   * descriptor may change after a call to tiz_chromecast_poll (e.g. if the
+   * connection is re-established), so it needs to be retrieved again every
+   * time.
+   *
+   * This function does not enter the Python interpreter.
+   *
+   * @ingroup libtizchromecast
+   *
+   * @param ap_chromecast The Tizonia Chromecast handle.
+   *
+   * @return The socket's file descriptor, or -1 if there is no connection
+   * at the moment.
+   */
+  int tiz_chromecast_get_socket_fd (const tiz_chromecast_t *ap_chromecast);
+
   /**
    * Load a new audio stream URL on the Chromecast device's default media
    * application.
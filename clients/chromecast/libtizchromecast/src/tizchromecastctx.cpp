@@ -40,9 +40,35 @@
 
 namespace bp = boost::python;
 
+namespace
+{
+  // Holds the Python interpreter lock for as long as the object is alive.
+  // The interpreter is shared with the other client libraries, which may be
+  // using it from their own threads.
+  class gil_lock
+  {
+  public:
+    gil_lock () : state_ (PyGILState_Ensure ())
+    {
+    }
+    ~gil_lock ()
+    {
+      PyGILState_Release (state_);
+    }
+
+  private:
+    gil_lock (const gil_lock &);
+    gil_lock &operator= (const gil_lock &);
+
+  private:
+    PyGILState_STATE state_;
+  };
+}  // namespace
+
 #define try_catch_wrapper(expr)                                  \
   do                                                             \
     {                                                            \
+      gil_lock gil;                                              \
       try                                                        \
         {                                                        \
           (expr);                                                \
@@ -64,14 +90,23 @@ namespace bp = boost::python;
 
 namespace
 {
-  void init_cc_ctx (bp::object &py_main, bp::object &py_global,
-                    bp::object &py_chromecastproxy)
+  void init_python ()
   {
     if (!Py_IsInitialized ())
       {
         Py_Initialize ();
+#if PY_VERSION_HEX < 0x03070000
+        PyEval_InitThreads ();
+#endif
+        // Release the lock acquired by the initialisation; from now on it is
+        // taken by whichever thread needs the interpreter.
+        (void)PyEval_SaveThread ();
       }
+  }
 
+  void init_cc_ctx (bp::object &py_main, bp::object &py_global,
+                    bp::object &py_chromecastproxy)
+  {
     // Import the Chromecast proxy module
     py_main = bp::import ("tizchromecastproxy");
 
@@ -84,21 +119,25 @@ namespace
 
 tizchromecastctx::tizchromecastctx ()
 {
+  init_python ();
   try_catch_wrapper (init_cc_ctx (py_main_, py_global_, py_chromecastproxy_));
 }
 
 tizchromecastctx::~tizchromecastctx ()
 {
-  // boost::python doesn't support Py_Finalize() yet!
+  // boost::python doesn't support Py_Finalize() yet! But the references held
+  // here need to be released while holding the interpreter lock.
+  gil_lock gil;
+  instances_.clear ();
+  py_chromecastproxy_ = bp::object ();
+  py_global_ = bp::object ();
+  py_main_ = bp::object ();
 }
 
 bp::object &tizchromecastctx::create_cc_proxy (
     const std::string &name_or_ip) const
 {
-  if (instances_.count (name_or_ip))
-    {
-      instances_.erase (name_or_ip);
-    }
+  destroy_cc_proxy (name_or_ip);
   try_catch_wrapper (instances_[name_or_ip]
                      = py_chromecastproxy_ (name_or_ip.c_str ()));
   return instances_[name_or_ip];
@@ -106,6 +145,7 @@ bp::object &tizchromecastctx::create_cc_proxy (
 
 void tizchromecastctx::destroy_cc_proxy (const std::string &name_or_ip) const
 {
+  gil_lock gil;
   if (instances_.count (name_or_ip))
     {
       instances_.erase (name_or_ip);
@@ -30,13 +30,20 @@
 #include <config.h>
 #endif
 
+#include <arpa/inet.h>
 #include <assert.h>
 #include <check.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "tizchromecast_c.h"
@@ -52,19 +59,165 @@
 /* #define URL "http://server6.20comunicacion.com:8102/" */
 #define CONTENT_TYPE "audio/mpeg"
 #define TITLE "Tizonia Audio Stream"
+#define ALBUM_ART "https://avatars0.githubusercontent.com/u/3161606?v=3&s=400"
 
-void chromecast_new_media_status (void *ap_user_data)
+/* See fakecastserver.py */
+#define FAKE_CAST_HOST "127.0.0.1"
+#define FAKE_CAST_HTTP_PORT 8008
+#define FAKE_CAST_VOLUME 50
+#define FAKE_CAST_NEW_VOLUME 25
+#define FAKE_CAST_WAIT_MS 5000
+
+typedef struct fake_cast_data fake_cast_data_t;
+struct fake_cast_data
+{
+  int ncast_status;
+  int volume;
+};
+
+void chromecast_new_cast_status (void *ap_user_data,
+                                 tiz_chromecast_cast_status_t a_status,
+                                 int a_volume)
+{
+  printf ("New cast status [%d] volume [%d]\n", a_status, a_volume);
+  if (ap_user_data)
+    {
+      fake_cast_data_t *p_data = ap_user_data;
+      p_data->ncast_status++;
+      p_data->volume = a_volume;
+    }
+}
+
+void chromecast_new_media_status (void *ap_user_data,
+                                  tiz_chromecast_media_status_t a_status,
+                                  int a_volume)
 {
-  printf ("New media status!!!\n");
+  printf ("New media status [%d] volume [%d]\n", a_status, a_volume);
+}
+
+static long
+elapsed_ms (const struct timespec *ap_start)
+{
+  struct timespec now;
+  (void) clock_gettime (CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - ap_start->tv_sec) * 1000
+         + (now.tv_nsec - ap_start->tv_nsec) / 1000000;
+}
+
+static pid_t
+start_fake_cast_server (void)
+{
+  struct sockaddr_in addr;
+  struct timespec start;
+  pid_t pid = fork ();
+  ck_assert (pid >= 0);
+  if (0 == pid)
+    {
+      execlp ("python3", "python3", TIZ_CHROMECAST_FAKE_SERVER, (char *) NULL);
+      _exit (EXIT_FAILURE);
+    }
+
+  /* The server's HTTP port is the last one to be opened */
+  memset (&addr, 0, sizeof (addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons (FAKE_CAST_HTTP_PORT);
+  addr.sin_addr.s_addr = inet_addr (FAKE_CAST_HOST);
+  (void) clock_gettime (CLOCK_MONOTONIC, &start);
+  while (elapsed_ms (&start) < FAKE_CAST_WAIT_MS * 2)
+    {
+      int fd = socket (AF_INET, SOCK_STREAM, 0);
+      int rc = connect (fd, (struct sockaddr *) &addr, sizeof (addr));
+      close (fd);
+      if (0 == rc)
+        {
+          return pid;
+        }
+      usleep (100000);
+    }
+  kill (pid, SIGTERM);
+  (void) waitpid (pid, NULL, 0);
+  ck_abort_msg ("The fake cast server did not start");
+  return -1;
 }
 
+static int
+wait_for_socket (const int a_fd, const int a_timeout_ms)
+{
+  struct pollfd pfd;
+  pfd.fd = a_fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  return poll (&pfd, 1, a_timeout_ms) > 0 ? pfd.revents : 0;
+}
+
+START_TEST (test_chromecast_fake_device)
+{
+  tiz_chromecast_ctx_t *p_cc_ctx = NULL;
+  tiz_chromecast_t *p_chromecast = NULL;
+  tiz_chromecast_callbacks_t cbacks
+    = {chromecast_new_cast_status, chromecast_new_media_status};
+  fake_cast_data_t data = {0, -1};
+  struct timespec start;
+  int fd = -1;
+  int revents = 0;
+  pid_t server = start_fake_cast_server ();
+
+  ck_assert (0 == tiz_chromecast_ctx_init (&p_cc_ctx));
+  ck_assert (ETizCcErrorNoError
+             == tiz_chromecast_init (&p_chromecast, p_cc_ctx, FAKE_CAST_HOST,
+                                     &cbacks, &data));
+
+  /* The initial receiver status has been received during init */
+  fd = tiz_chromecast_get_socket_fd (p_chromecast);
+  fprintf (stderr, "test_chromecast_fake_device: socket fd [%d]\n", fd);
+  ck_assert (fd >= 0);
+
+  /* The status pushed by the device must wake up a waiter on the socket; the
+     client library is only entered once the socket is readable */
+  (void) clock_gettime (CLOCK_MONOTONIC, &start);
+  while (data.volume != FAKE_CAST_NEW_VOLUME
+         && elapsed_ms (&start) < FAKE_CAST_WAIT_MS)
+    {
+      revents = wait_for_socket (fd, FAKE_CAST_WAIT_MS);
+      if (revents)
+        {
+          ck_assert (ETizCcErrorNoError
+                     == tiz_chromecast_poll (p_chromecast, 0));
+          fd = tiz_chromecast_get_socket_fd (p_chromecast);
+          ck_assert (fd >= 0);
+        }
+    }
+  fprintf (stderr, "test_chromecast_fake_device: cast status [%d] vol [%d]\n",
+           data.ncast_status, data.volume);
+  ck_assert_int_eq (data.volume, FAKE_CAST_NEW_VOLUME);
+
+  /* The device going away must wake up a waiter too; a socket that never
+     reports this would leave the cast daemon blind to the disconnection */
+  revents = wait_for_socket (fd, FAKE_CAST_WAIT_MS);
+  fprintf (stderr, "test_chromecast_fake_device: revents [0x%x]\n", revents);
+  ck_assert (revents & (POLLIN | POLLERR | POLLHUP));
+  (void) tiz_chromecast_poll (p_chromecast, 0);
+
+  tiz_chromecast_destroy (p_chromecast);
+  tiz_chromecast_ctx_destroy (&p_cc_ctx);
+
+  kill (server, SIGTERM);
+  (void) waitpid (server, NULL, 0);
+}
+END_TEST
+
 START_TEST (test_chromecast)
 {
+  tiz_chromecast_ctx_t *p_cc_ctx = NULL;
   tiz_chromecast_t *p_chromecast = NULL;
+  tiz_chromecast_callbacks_t cbacks
+    = {chromecast_new_cast_status, chromecast_new_media_status};
   pid_t pid = getpid ();
-  int rc = tiz_chromecast_init (&p_chromecast, CHROMECAST_DEVICE_NAME,
-                                chromecast_new_media_status, NULL);
+  int rc = tiz_chromecast_ctx_init (&p_cc_ctx);
   int i = 0;
+  ck_assert (0 == rc);
+  rc = tiz_chromecast_init (&p_chromecast, p_cc_ctx, CHROMECAST_DEVICE_NAME,
+                            &cbacks, NULL);
   fprintf (stderr, "test_chromecast:init [%d] = %d\n", pid, rc);
   ck_assert (0 == rc);
   ck_assert (p_chromecast);
@@ -76,7 +229,8 @@ START_TEST (test_chromecast)
     }
 
   fprintf (stderr, "\n\n\ntest_chromecast:load [%d] = before \n", pid);
-  rc = tiz_chromecast_load_url (p_chromecast, URL, CONTENT_TYPE, TITLE);
+  rc = tiz_chromecast_load_url (p_chromecast, URL, CONTENT_TYPE, TITLE,
+                                ALBUM_ART);
   fprintf (stderr, "test_chromecast:load [%d] = %d \n", pid, rc);
   ck_assert (0 == rc);
 
@@ -162,6 +316,7 @@ START_TEST (test_chromecast)
 
   fprintf (stderr, "\n\n\ntest_chromecast:destroy [%d] = %d \n", pid, rc);
   tiz_chromecast_destroy (p_chromecast);
+  tiz_chromecast_ctx_destroy (&p_cc_ctx);
 }
 END_TEST
 
@@ -173,6 +328,7 @@ Suite *chromecast_suite (void)
   /* test case */
   tc_chromecast = tcase_create ("Chromecast client lib unit tests");
   tcase_set_timeout (tc_chromecast, CHROMECAST_TEST_TIMEOUT);
+  tcase_add_test (tc_chromecast, test_chromecast_fake_device);
   tcase_add_test (tc_chromecast, test_chromecast);
   suite_add_tcase (s, tc_chromecast);
 
@@ -0,0 +1,207 @@
+# Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+#
+# This file is part of Tizonia
+#
+# Tizonia is free software: you can redistribute it and/or modify it under the
+# terms of the GNU Lesser General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option)
+# any later version.
+#
+# Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+# more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+
+"""A fake Chromecast device, listening on 127.0.0.1, for check_tizchromecast.
+
+It answers the device description request on port 8008 and speaks just enough
+of the cast protocol on port 8009 (TLS, length-prefixed protobuf messages) to
+let pychromecast connect. One second after the first receiver status has been
+sent, it pushes an unsolicited status with the volume set to
+FAKE_CAST_NEW_VOLUME, and one second later it drops the connection.
+
+"""
+
+import http.server
+import json
+import os
+import select
+import socket
+import ssl
+import struct
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+
+try:
+    from pychromecast.generated import cast_channel_pb2
+except ImportError:
+    from pychromecast import cast_channel_pb2
+
+FAKE_CAST_HOST = "127.0.0.1"
+FAKE_CAST_HTTP_PORT = 8008
+FAKE_CAST_PORT = 8009
+FAKE_CAST_VOLUME = 0.5
+FAKE_CAST_NEW_VOLUME = 0.25
+
+NS_CONNECTION = "urn:x-cast:com.google.cast.tp.connection"
+NS_HEARTBEAT = "urn:x-cast:com.google.cast.tp.heartbeat"
+NS_RECEIVER = "urn:x-cast:com.google.cast.receiver"
+
+EUREKA_INFO = {
+    "name": "Fake-Chromecast",
+    "ssdp_udn": "7e5cf4a2-3f6e-4b8e-9c2d-1a2b3c4d5e6f",
+    "detail": {
+        "model_name": "Chromecast Audio",
+        "manufacturer": "Google Inc."
+    }
+}
+
+
+class EurekaHandler(http.server.BaseHTTPRequestHandler):
+    """Answers pychromecast's device description request."""
+
+    def do_GET(self):
+        body = json.dumps(EUREKA_INFO).encode("utf-8")
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, *args):
+        pass
+
+
+def make_certificate(workdir):
+    """Create a throwaway self-signed certificate; pychromecast doesn't
+    verify it."""
+    cert = os.path.join(workdir, "cert.pem")
+    key = os.path.join(workdir, "key.pem")
+    subprocess.check_call([
+        "openssl", "req", "-x509", "-newkey", "rsa:2048", "-nodes", "-days",
+        "1", "-subj", "/CN=fake-chromecast", "-keyout", key, "-out", cert
+    ], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    return cert, key
+
+
+def send_msg(conn, source, destination, namespace, data):
+    msg = cast_channel_pb2.CastMessage()
+    msg.protocol_version = msg.CASTV2_1_0
+    msg.source_id = source
+    msg.destination_id = destination
+    msg.namespace = namespace
+    msg.payload_type = cast_channel_pb2.CastMessage.STRING
+    msg.payload_utf8 = json.dumps(data)
+    payload = msg.SerializeToString()
+    conn.sendall(struct.pack(">I", len(payload)) + payload)
+
+
+def recv_exactly(conn, size):
+    data = b""
+    while len(data) < size:
+        chunk = conn.recv(size - len(data))
+        if not chunk:
+            return None
+        data += chunk
+    return data
+
+
+def recv_msg(conn):
+    header = recv_exactly(conn, 4)
+    if header is None:
+        return None
+    payload = recv_exactly(conn, struct.unpack(">I", header)[0])
+    if payload is None:
+        return None
+    msg = cast_channel_pb2.CastMessage()
+    msg.ParseFromString(payload)
+    return msg
+
+
+def receiver_status(request_id, volume):
+    return {
+        "type": "RECEIVER_STATUS",
+        "requestId": request_id,
+        "status": {
+            "volume": {
+                "level": volume,
+                "muted": False
+            },
+            "applications": []
+        }
+    }
+
+
+def serve_client(conn):
+    status_sent_at = None
+    pushed_at = None
+    while True:
+        now = time.time()
+        if pushed_at is not None and now - pushed_at >= 1.0:
+            # Drop the connection without notice, like a device that has
+            # been switched off would
+            return
+        if status_sent_at is not None and pushed_at is None \
+           and now - status_sent_at >= 1.0:
+            send_msg(conn, "receiver-0", "*", NS_RECEIVER,
+                     receiver_status(0, FAKE_CAST_NEW_VOLUME))
+            pushed_at = now
+            continue
+
+        if conn.pending() == 0:
+            readable, _, _ = select.select([conn], [], [], 0.1)
+            if not readable:
+                continue
+        msg = recv_msg(conn)
+        if msg is None:
+            return
+        data = json.loads(msg.payload_utf8) if msg.payload_utf8 else {}
+        if msg.namespace == NS_HEARTBEAT and data.get("type") == "PING":
+            send_msg(conn, msg.destination_id, msg.source_id, NS_HEARTBEAT,
+                     {"type": "PONG"})
+        elif msg.namespace == NS_RECEIVER \
+             and data.get("type") == "GET_STATUS":
+            send_msg(conn, msg.destination_id, msg.source_id, NS_RECEIVER,
+                     receiver_status(data.get("requestId", 0),
+                                     FAKE_CAST_VOLUME))
+            if status_sent_at is None:
+                status_sent_at = time.time()
+
+
+def main():
+    workdir = tempfile.mkdtemp(prefix="fakecast")
+    cert, key = make_certificate(workdir)
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    context.load_cert_chain(cert, key)
+
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    listener.bind((FAKE_CAST_HOST, FAKE_CAST_PORT))
+    listener.listen(1)
+
+    # The HTTP server goes last: the test waits until it accepts connections
+    httpd = http.server.HTTPServer((FAKE_CAST_HOST, FAKE_CAST_HTTP_PORT),
+                                   EurekaHandler)
+    thread = threading.Thread(target=httpd.serve_forever)
+    thread.daemon = True
+    thread.start()
+
+    raw, _ = listener.accept()
+    conn = context.wrap_socket(raw, server_side=True)
+    try:
+        serve_client(conn)
+    finally:
+        conn.close()
+        listener.close()
+        httpd.shutdown()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
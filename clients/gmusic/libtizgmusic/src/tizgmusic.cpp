@@ -37,10 +37,36 @@
 
 namespace bp = boost::python;
 
+namespace
+{
+  // Holds the Python interpreter lock for as long as the object is alive.
+  // The interpreter is accessed from the component's thread and from the
+  // metadata refresh thread.
+  class gil_lock
+  {
+  public:
+    gil_lock () : state_ (PyGILState_Ensure ())
+    {
+    }
+    ~gil_lock ()
+    {
+      PyGILState_Release (state_);
+    }
+
+  private:
+    gil_lock (const gil_lock &);
+    gil_lock &operator= (const gil_lock &);
+
+  private:
+    PyGILState_STATE state_;
+  };
+}  // namespace
+
 /* This macro assumes the existence of an "int rc" local variable */
 #define try_catch_wrapper(expr)                                  \
   do                                                             \
     {                                                            \
+      gil_lock gil;                                              \
       try                                                        \
         {                                                        \
           if (!rc)                                               \
@@ -71,8 +97,18 @@ namespace
   int check_deps ()
   {
     int rc = 1;
-    Py_Initialize ();
+    if (!Py_IsInitialized ())
+      {
+        Py_Initialize ();
+#if PY_VERSION_HEX < 0x03070000
+        PyEval_InitThreads ();
+#endif
+        // Release the lock acquired by the initialisation; from now on it is
+        // taken by whichever thread needs the interpreter.
+        (void)PyEval_SaveThread ();
+      }
 
+    gil_lock gil;
     try
       {
         // Import the Google Play Music proxy module
@@ -83,14 +119,14 @@ namespace
 
         // Check the existence of the 'gmusicapi' module
         bp::object ignored = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('gmusicapi')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
 
         // Check the existence of the 'fuzzywuzzy' module
         bp::object ignored2 = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('fuzzywuzzy')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
@@ -134,12 +170,25 @@ namespace
 
 tizgmusic::tizgmusic (const std::string &user, const std::string &pass,
                       const std::string &device_id)
-  : user_ (user), pass_ (pass), device_id_ (device_id)
-{
+  : user_ (user),
+    pass_ (pass),
+    device_id_ (device_id),
+    md_thread_ (),
+    md_thread_running_ (false),
+    md_thread_stop_ (false),
+    md_requested_ (0),
+    md_refreshed_ (0),
+    md_published_ (0)
+{
+  pthread_mutex_init (&md_mutex_, NULL);
+  pthread_cond_init (&md_cond_, NULL);
 }
 
 tizgmusic::~tizgmusic ()
 {
+  stop ();
+  pthread_cond_destroy (&md_cond_);
+  pthread_mutex_destroy (&md_mutex_);
 }
 
 int tizgmusic::init ()
@@ -157,19 +206,45 @@ int tizgmusic::start ()
   int rc = 0;
   try_catch_wrapper (
       start_gmusic (py_global_, py_gm_proxy_, user_, pass_, device_id_));
+  if (!rc && !md_thread_running_)
+    {
+      md_thread_stop_ = false;
+      // If the thread can't be created, the metadata is refreshed
+      // synchronously instead (see request_metadata_refresh).
+      md_thread_running_
+          = (0 == pthread_create (&md_thread_, NULL,
+                                  &tizgmusic::metadata_thread_func, this));
+    }
   return rc;
 }
 
 void tizgmusic::stop ()
 {
   int rc = 0;
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      md_thread_stop_ = true;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+      pthread_join (md_thread_, NULL);
+      md_thread_running_ = false;
+    }
   try_catch_wrapper (py_gm_proxy_.attr ("logout") ());
   (void)rc;
 }
 
 void tizgmusic::deinit ()
 {
-  // boost::python doesn't support Py_Finalize() yet!
+  // boost::python doesn't support Py_Finalize() yet! But the references held
+  // here need to be released while holding the interpreter lock.
+  if (Py_IsInitialized ())
+    {
+      gil_lock gil;
+      py_gm_proxy_ = bp::object ();
+      py_global_ = bp::object ();
+      py_main_ = bp::object ();
+    }
 }
 
 int tizgmusic::play_library ()
@@ -298,88 +373,82 @@ int tizgmusic::play_promoted_tracks ()
 
 const char *tizgmusic::get_next_url ()
 {
+  int rc = 0;
   current_url_.clear ();
-  try
-    {
-      current_url_
-          = bp::extract< std::string > (py_gm_proxy_.attr ("next_url") ());
-      get_current_song ();
-    }
-  catch (bp::error_already_set &e)
-    {
-      PyErr_PrintEx (0);
-    }
-  catch (...)
+  try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                         py_gm_proxy_.attr ("next_url") ()));
+  if (!current_url_.empty ())
     {
+      request_metadata_refresh ();
     }
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
 const char *tizgmusic::get_prev_url ()
 {
+  int rc = 0;
   current_url_.clear ();
-  try
-    {
-      current_url_
-          = bp::extract< std::string > (py_gm_proxy_.attr ("prev_url") ());
-      get_current_song ();
-    }
-  catch (bp::error_already_set &e)
-    {
-      PyErr_PrintEx (0);
-    }
-  catch (...)
+  try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                         py_gm_proxy_.attr ("prev_url") ()));
+  if (!current_url_.empty ())
     {
+      request_metadata_refresh ();
     }
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
 const char *tizgmusic::get_current_song_artist ()
 {
-  return current_artist_.empty () ? NULL : current_artist_.c_str ();
+  (void)publish_metadata (true);
+  return current_.artist.empty () ? NULL : current_.artist.c_str ();
 }
 
 const char *tizgmusic::get_current_song_title ()
 {
-  return current_title_.empty () ? NULL : current_title_.c_str ();
+  (void)publish_metadata (true);
+  return current_.title.empty () ? NULL : current_.title.c_str ();
 }
 
 const char *tizgmusic::get_current_song_album ()
 {
-  return current_album_.empty () ? NULL : current_album_.c_str ();
+  (void)publish_metadata (true);
+  return current_.album.empty () ? NULL : current_.album.c_str ();
 }
 
 const char *tizgmusic::get_current_song_duration ()
 {
-  return current_duration_.empty () ? NULL : current_duration_.c_str ();
+  (void)publish_metadata (true);
+  return current_.duration.empty () ? NULL : current_.duration.c_str ();
 }
 
 const char *tizgmusic::get_current_song_track_number ()
 {
-  return current_track_num_.empty () ? NULL : current_track_num_.c_str ();
+  (void)publish_metadata (true);
+  return current_.track_number.empty () ? NULL : current_.track_number.c_str ();
 }
 
 const char *tizgmusic::get_current_song_tracks_in_album ()
 {
-  return current_song_tracks_total_.empty ()
-             ? NULL
-             : current_song_tracks_total_.c_str ();
+  (void)publish_metadata (true);
+  return current_.tracks_in_album.empty () ? NULL : current_.tracks_in_album.c_str ();
 }
 
 const char *tizgmusic::get_current_song_year ()
 {
-  return current_song_year_.empty () ? NULL : current_song_year_.c_str ();
+  (void)publish_metadata (true);
+  return current_.year.empty () ? NULL : current_.year.c_str ();
 }
 
 const char *tizgmusic::get_current_song_genre ()
 {
-  return current_song_genre_.empty () ? NULL : current_song_genre_.c_str ();
+  (void)publish_metadata (true);
+  return current_.genre.empty () ? NULL : current_.genre.c_str ();
 }
 
 const char *tizgmusic::get_current_song_album_art ()
 {
-  return current_song_album_art_.empty () ? NULL
-                                          : current_song_album_art_.c_str ();
+  (void)publish_metadata (true);
+  return current_.album_art.empty () ? NULL : current_.album_art.c_str ();
 }
 
 void tizgmusic::clear_queue ()
@@ -413,25 +482,19 @@ void tizgmusic::set_playback_mode (const playback_mode mode)
   (void)rc;
 }
 
-void tizgmusic::get_current_song ()
+void tizgmusic::get_current_song (song_metadata &metadata)
 {
-  current_artist_.clear ();
-  current_title_.clear ();
-  current_song_genre_.clear ();
-  current_song_album_art_.clear ();
-
   const bp::tuple &info1 = bp::extract< bp::tuple > (
       py_gm_proxy_.attr ("current_song_title_and_artist") ());
-  current_artist_ = bp::extract< std::string > (info1[0]);
-  current_title_ = bp::extract< std::string > (info1[1]);
+  metadata.artist = bp::extract< std::string > (info1[0]);
+  metadata.title = bp::extract< std::string > (info1[1]);
 
   const bp::tuple &info2 = bp::extract< bp::tuple > (
       py_gm_proxy_.attr ("current_song_album_and_duration") ());
-  current_album_ = bp::extract< std::string > (info2[0]);
+  metadata.album = bp::extract< std::string > (info2[0]);
   int duration = bp::extract< int > (info2[1]);
 
   int seconds = 0;
-  current_duration_.clear ();
   if (duration)
     {
       duration /= 1000;
@@ -447,38 +510,120 @@ void tizgmusic::get_current_song ()
 
       if (hours > 0)
         {
-          current_duration_.append (boost::lexical_cast< std::string > (hours));
-          current_duration_.append ("h:");
+          metadata.duration.append (boost::lexical_cast< std::string > (hours));
+          metadata.duration.append ("h:");
         }
 
       if (minutes > 0)
         {
-          current_duration_.append (
+          metadata.duration.append (
               boost::lexical_cast< std::string > (minutes));
-          current_duration_.append ("m:");
+          metadata.duration.append ("m:");
         }
     }
 
   char seconds_str[6];
   sprintf (seconds_str, "%02i", seconds);
-  current_duration_.append (seconds_str);
-  current_duration_.append ("s");
+  metadata.duration.append (seconds_str);
+  metadata.duration.append ("s");
 
   const bp::tuple &info3 = bp::extract< bp::tuple > (
       py_gm_proxy_.attr ("current_track_and_album_total") ());
   const int track_num = bp::extract< int > (info3[0]);
   const int total_tracks = bp::extract< int > (info3[1]);
 
-  current_track_num_.assign (boost::lexical_cast< std::string > (track_num));
-  current_song_tracks_total_.assign (
+  metadata.track_number.assign (boost::lexical_cast< std::string > (track_num));
+  metadata.tracks_in_album.assign (
       boost::lexical_cast< std::string > (total_tracks));
 
-  current_song_year_
+  metadata.year
       = bp::extract< std::string > (py_gm_proxy_.attr ("current_song_year") ());
 
-  current_song_genre_ = bp::extract< std::string > (
+  metadata.genre = bp::extract< std::string > (
       py_gm_proxy_.attr ("current_song_genre") ());
 
-  current_song_album_art_ = bp::extract< std::string > (
+  metadata.album_art = bp::extract< std::string > (
       py_gm_proxy_.attr ("current_song_album_art") ());
 }
+
+void tizgmusic::request_metadata_refresh ()
+{
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      ++md_requested_;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+    }
+  else
+    {
+      int rc = 0;
+      song_metadata metadata;
+      try_catch_wrapper (get_current_song (metadata));
+      (void)rc;
+      refreshed_ = metadata;
+      md_refreshed_ = ++md_requested_;
+    }
+}
+
+bool tizgmusic::publish_metadata (const bool wait)
+{
+  bool ready = false;
+  pthread_mutex_lock (&md_mutex_);
+  while (wait && md_thread_running_ && md_refreshed_ != md_requested_)
+    {
+      pthread_cond_wait (&md_cond_, &md_mutex_);
+    }
+  ready = (md_refreshed_ == md_requested_);
+  if (ready && md_published_ != md_refreshed_)
+    {
+      current_ = refreshed_;
+      md_published_ = md_refreshed_;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+  return ready;
+}
+
+const tizgmusic::song_metadata *tizgmusic::get_current_song_metadata ()
+{
+  return publish_metadata (false) ? &current_ : NULL;
+}
+
+void tizgmusic::metadata_loop ()
+{
+  pthread_mutex_lock (&md_mutex_);
+  while (!md_thread_stop_)
+    {
+      if (md_refreshed_ == md_requested_)
+        {
+          pthread_cond_wait (&md_cond_, &md_mutex_);
+          continue;
+        }
+
+      const unsigned long request = md_requested_;
+      song_metadata metadata;
+      int rc = 0;
+      pthread_mutex_unlock (&md_mutex_);
+      try_catch_wrapper (get_current_song (metadata));
+      (void)rc;
+      pthread_mutex_lock (&md_mutex_);
+
+      // If the queue moved again in the meantime, this snapshot is stale and
+      // is simply discarded
+      if (request == md_requested_)
+        {
+          refreshed_ = metadata;
+          md_refreshed_ = request;
+          pthread_cond_broadcast (&md_cond_);
+        }
+    }
+  pthread_mutex_unlock (&md_mutex_);
+}
+
+void *tizgmusic::metadata_thread_func (void *p_arg)
+{
+  tizgmusic *p_this = static_cast< tizgmusic * > (p_arg);
+  assert (p_this);
+  p_this->metadata_loop ();
+  return NULL;
+}
@@ -32,6 +32,8 @@
 
 #include <boost/python.hpp>
 
+#include <pthread.h>
+
 #include <string>
 
 class tizgmusic
@@ -47,6 +49,22 @@ public:
     PlaybackModeMax
   };
 
+  /**
+   * The metadata of the song currently selected in the playback queue.
+   */
+  struct song_metadata
+  {
+    std::string artist;
+    std::string title;
+    std::string album;
+    std::string duration;
+    std::string track_number;
+    std::string tracks_in_album;
+    std::string year;
+    std::string genre;
+    std::string album_art;
+  };
+
 public:
   tizgmusic (const std::string &user, const std::string &pass,
              const std::string &device_id);
@@ -76,6 +94,9 @@ public:
 
   const char *get_next_url ();
   const char *get_prev_url ();
+
+  const song_metadata *get_current_song_metadata ();
+
   const char *get_current_song_artist ();
   const char *get_current_song_title ();
   const char *get_current_song_album ();
@@ -87,22 +108,27 @@ public:
   const char *get_current_song_album_art ();
 
 private:
-  void get_current_song ();
+  void get_current_song (song_metadata &metadata);
+  void request_metadata_refresh ();
+  bool publish_metadata (const bool wait);
+  void metadata_loop ();
+  static void *metadata_thread_func (void *p_arg);
 
 private:
   std::string user_;
   std::string pass_;
   std::string device_id_;
   std::string current_url_;
-  std::string current_artist_;
-  std::string current_title_;
-  std::string current_album_;
-  std::string current_duration_;
-  std::string current_track_num_;
-  std::string current_song_tracks_total_;
-  std::string current_song_year_;
-  std::string current_song_genre_;
-  std::string current_song_album_art_;
+  song_metadata current_;
+  song_metadata refreshed_;
+  pthread_t md_thread_;
+  pthread_mutex_t md_mutex_;
+  pthread_cond_t md_cond_;
+  bool md_thread_running_;
+  bool md_thread_stop_;
+  unsigned long md_requested_;
+  unsigned long md_refreshed_;
+  unsigned long md_published_;
   boost::python::object py_main_;
   boost::python::object py_global_;
   boost::python::object py_gm_proxy_;
@@ -227,6 +227,35 @@ extern "C" const char *tiz_gmusic_get_prev_url (tiz_gmusic_t *ap_gmusic)
   return ap_gmusic->p_proxy_->get_prev_url ();
 }
 
+static const char *metadata_item (const std::string &item)
+{
+  return item.empty () ? NULL : item.c_str ();
+}
+
+extern "C" int tiz_gmusic_get_current_song_metadata (
+    tiz_gmusic_t *ap_gmusic, tiz_gmusic_metadata_t *ap_metadata)
+{
+  assert (ap_gmusic);
+  assert (ap_gmusic->p_proxy_);
+  assert (ap_metadata);
+  const tizgmusic::song_metadata *p_md
+      = ap_gmusic->p_proxy_->get_current_song_metadata ();
+  if (!p_md)
+    {
+      return 1;
+    }
+  ap_metadata->p_artist = metadata_item (p_md->artist);
+  ap_metadata->p_title = metadata_item (p_md->title);
+  ap_metadata->p_album = metadata_item (p_md->album);
+  ap_metadata->p_duration = metadata_item (p_md->duration);
+  ap_metadata->p_track_number = metadata_item (p_md->track_number);
+  ap_metadata->p_tracks_in_album = metadata_item (p_md->tracks_in_album);
+  ap_metadata->p_year = metadata_item (p_md->year);
+  ap_metadata->p_genre = metadata_item (p_md->genre);
+  ap_metadata->p_album_art = metadata_item (p_md->album_art);
+  return 0;
+}
+
 extern "C" const char *tiz_gmusic_get_current_song_artist (
     tiz_gmusic_t *ap_gmusic)
 {
@@ -64,6 +64,24 @@ extern "C"
     ETIZGmusicPlaybackModeMax
   } tiz_gmusic_playback_mode_t;
 
+  /**
+   * A snapshot of the metadata of the song currently selected in the
+   * playback queue. Fields are NULL when the item is not available.
+   * @ingroup libtizgmusic
+   */
+  typedef struct tiz_gmusic_metadata
+  {
+    const char *p_artist;
+    const char *p_title;
+    const char *p_album;
+    const char *p_duration;
+    const char *p_track_number;
+    const char *p_tracks_in_album;
+    const char *p_year;
+    const char *p_genre;
+    const char *p_album_art;
+  } tiz_gmusic_metadata_t;
+
   /**
    * Initialize the gmusic handle.
    *
@@ -315,6 +333,25 @@ extern "C"
    */
   const char *tiz_gmusic_get_prev_url (tiz_gmusic_t *ap_gmusic);
 
+  /**
+   * Retrieve all the metadata of the current song in one go.
+   *
+   * The metadata is retrieved on a background thread every time the playback
+   * queue moves (see tiz_gmusic_get_next_url and tiz_gmusic_get_prev_url).
+   * This function does not call into the Python interpreter and never blocks.
+   *
+   * @ingroup libtizgmusic
+   *
+   * @param ap_gmusic The gmusic handle.
+   * @param ap_metadata The snapshot to be filled in. The strings remain valid
+   * until the next call to any of the tiz_gmusic_get_current_* functions.
+   *
+   * @return 0 on success, 1 if the metadata of the current song is still
+   * being retrieved (ap_metadata is not modified).
+   */
+  int tiz_gmusic_get_current_song_metadata (
+      tiz_gmusic_t *ap_gmusic, tiz_gmusic_metadata_t *ap_metadata);
+
   /**
    * Retrieve the current song's artist.
    *
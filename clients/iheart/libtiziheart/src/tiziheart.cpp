@@ -37,10 +37,36 @@
 
 namespace bp = boost::python;
 
+namespace
+{
+  // Holds the Python interpreter lock for as long as the object is alive.
+  // The interpreter is accessed from the component's thread and from the
+  // metadata refresh thread.
+  class gil_lock
+  {
+  public:
+    gil_lock () : state_ (PyGILState_Ensure ())
+    {
+    }
+    ~gil_lock ()
+    {
+      PyGILState_Release (state_);
+    }
+
+  private:
+    gil_lock (const gil_lock &);
+    gil_lock &operator= (const gil_lock &);
+
+  private:
+    PyGILState_STATE state_;
+  };
+}  // namespace
+
 /* This macro assumes the existence of an "int rc" local variable */
 #define try_catch_wrapper(expr)                                  \
   do                                                             \
     {                                                            \
+      gil_lock gil;                                              \
       try                                                        \
         {                                                        \
           (expr);                                                \
@@ -66,8 +92,18 @@ namespace
   int check_deps ()
   {
     int rc = 1;
-    Py_Initialize ();
+    if (!Py_IsInitialized ())
+      {
+        Py_Initialize ();
+#if PY_VERSION_HEX < 0x03070000
+        PyEval_InitThreads ();
+#endif
+        // Release the lock acquired by the initialisation; from now on it is
+        // taken by whichever thread needs the interpreter.
+        (void)PyEval_SaveThread ();
+      }
 
+    gil_lock gil;
     try
       {
         // Import the Tizonia Plex proxy module
@@ -78,14 +114,14 @@ namespace
 
         // Check the existence of the 'joblib' module
         bp::object ignored = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('joblib')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
 
         // Check the existence of the 'fuzzywuzzy' module
         bp::object ignored2 = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('fuzzywuzzy')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
@@ -127,12 +163,23 @@ namespace
 tiziheart::tiziheart ()
   : current_url_ (),
     current_radio_index_ (),
-    current_queue_length_ ()
+    current_queue_length_ (),
+    md_thread_ (),
+    md_thread_running_ (false),
+    md_thread_stop_ (false),
+    md_requested_ (0),
+    md_refreshed_ (0),
+    md_published_ (0)
 {
+  pthread_mutex_init (&md_mutex_, NULL);
+  pthread_cond_init (&md_cond_, NULL);
 }
 
 tiziheart::~tiziheart ()
 {
+  stop ();
+  pthread_cond_destroy (&md_cond_);
+  pthread_mutex_destroy (&md_mutex_);
 }
 
 int tiziheart::init ()
@@ -149,19 +196,42 @@ int tiziheart::start ()
 {
   int rc = 0;
   try_catch_wrapper (start_iheart (py_global_, py_iheart_proxy_));
+  if (!rc && !md_thread_running_)
+    {
+      md_thread_stop_ = false;
+      // If the thread can't be created, the metadata is refreshed
+      // synchronously instead (see request_metadata_refresh).
+      md_thread_running_
+          = (0 == pthread_create (&md_thread_, NULL,
+                                  &tiziheart::metadata_thread_func, this));
+    }
   return rc;
 }
 
 void tiziheart::stop ()
 {
-  int rc = 0;
-  // try_catch_wrapper (py_iheart_proxy_.attr ("logout")());
-  (void)rc;
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      md_thread_stop_ = true;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+      pthread_join (md_thread_, NULL);
+      md_thread_running_ = false;
+    }
 }
 
 void tiziheart::deinit ()
 {
-  // boost::python doesn't support Py_Finalize() yet!
+  // boost::python doesn't support Py_Finalize() yet! But the references held
+  // here need to be released while holding the interpreter lock.
+  if (Py_IsInitialized ())
+    {
+      gil_lock gil;
+      py_iheart_proxy_ = bp::object ();
+      py_global_ = bp::object ();
+      py_main_ = bp::object ();
+    }
 }
 
 int tiziheart::play_radios (const std::string &query,
@@ -178,106 +248,93 @@ int tiziheart::play_radios (const std::string &query,
 
 const char *tiziheart::get_url (const int a_position)
 {
-  try
+  int rc = 0;
+  const int queue_length = get_current_queue_length_as_int ();
+  current_url_.clear ();
+  if (queue_length > 0 && a_position >= 0 && queue_length >= a_position)
     {
-      int queue_length = get_current_queue_length_as_int();
-      current_url_.clear ();
-      if (queue_length > 0 && a_position >= 0 && queue_length >= a_position)
+      const int pos = (0 == a_position) ? queue_length : a_position;
+      try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                             py_iheart_proxy_.attr ("get_url") (bp::object (pos))));
+      if (!current_url_.empty ())
         {
-          const int pos = (0 == a_position) ? queue_length : a_position;
-          current_url_ = bp::extract< std::string > (
-              py_iheart_proxy_.attr ("get_url") (bp::object (pos)));
-          get_current_radio ();
+          request_metadata_refresh ();
         }
     }
-  catch (bp::error_already_set &e)
-    {
-      PyErr_PrintEx (0);
-    }
-  catch (...)
-    {
-    }
+  (void)rc;
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
 const char *tiziheart::get_next_url (const bool a_remove_current_url)
 {
+  int rc = 0;
   current_url_.clear ();
-  try
+  if (a_remove_current_url)
     {
-      if (a_remove_current_url)
-        {
-          py_iheart_proxy_.attr ("remove_current_url") ();
-        }
-      current_url_
-          = bp::extract< std::string > (py_iheart_proxy_.attr ("next_url") ());
-      get_current_radio ();
-    }
-  catch (bp::error_already_set &e)
-    {
-      PyErr_PrintEx (0);
+      try_catch_wrapper (py_iheart_proxy_.attr ("remove_current_url") ());
     }
-  catch (...)
+  try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                         py_iheart_proxy_.attr ("next_url") ()));
+  if (!current_url_.empty ())
     {
+      request_metadata_refresh ();
     }
+  (void)rc;
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
 const char *tiziheart::get_prev_url (const bool a_remove_current_url)
 {
+  int rc = 0;
   current_url_.clear ();
-  try
-    {
-      if (a_remove_current_url)
-        {
-          py_iheart_proxy_.attr ("remove_current_url") ();
-        }
-      current_url_
-          = bp::extract< std::string > (py_iheart_proxy_.attr ("prev_url") ());
-      get_current_radio ();
-    }
-  catch (bp::error_already_set &e)
+  if (a_remove_current_url)
     {
-      PyErr_PrintEx (0);
+      try_catch_wrapper (py_iheart_proxy_.attr ("remove_current_url") ());
     }
-  catch (...)
+  try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                         py_iheart_proxy_.attr ("prev_url") ()));
+  if (!current_url_.empty ())
     {
+      request_metadata_refresh ();
     }
+  (void)rc;
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
 const char *tiziheart::get_current_radio_name ()
 {
-  return current_radio_name_.empty () ? NULL : current_radio_name_.c_str ();
+  (void)publish_metadata (true);
+  return current_.name.empty () ? NULL : current_.name.c_str ();
 }
 
 const char *tiziheart::get_current_radio_description ()
 {
-  return current_radio_description_.empty () ? NULL : current_radio_description_.c_str ();
+  (void)publish_metadata (true);
+  return current_.description.empty () ? NULL : current_.description.c_str ();
 }
 
 const char *tiziheart::get_current_radio_city ()
 {
-  return current_radio_city_.empty ()
-             ? NULL
-             : current_radio_city_.c_str ();
+  (void)publish_metadata (true);
+  return current_.city.empty () ? NULL : current_.city.c_str ();
 }
 
 const char *tiziheart::get_current_radio_state ()
 {
-  return current_radio_state_.empty () ? NULL : current_radio_state_.c_str ();
+  (void)publish_metadata (true);
+  return current_.state.empty () ? NULL : current_.state.c_str ();
 }
 
 const char *tiziheart::get_current_radio_audio_encoding ()
 {
-  return current_radio_audio_encoding_.empty () ? NULL : current_radio_audio_encoding_.c_str ();
+  (void)publish_metadata (true);
+  return current_.audio_encoding.empty () ? NULL : current_.audio_encoding.c_str ();
 }
 
 const char *tiziheart::get_current_radio_website_url ()
 {
-  return current_radio_website_url_.empty ()
-             ? NULL
-             : current_radio_website_url_.c_str ();
+  (void)publish_metadata (true);
+  return current_.website_url.empty () ? NULL : current_.website_url.c_str ();
 }
 
 const char *tiziheart::get_current_radio_stream_url ()
@@ -287,7 +344,8 @@ const char *tiziheart::get_current_radio_stream_url ()
 
 const char *tiziheart::get_current_radio_thumbnail_url ()
 {
-  return current_radio_thumbnail_url_.empty () ? NULL : current_radio_thumbnail_url_.c_str ();
+  (void)publish_metadata (true);
+  return current_.thumbnail_url.empty () ? NULL : current_.thumbnail_url.c_str ();
 }
 
 void tiziheart::clear_queue ()
@@ -306,18 +364,21 @@ void tiziheart::print_queue ()
 
 const char *tiziheart::get_current_radio_index ()
 {
+  gil_lock gil;
   obtain_current_queue_progress ();
   return current_radio_index_.empty () ? NULL : current_radio_index_.c_str ();
 }
 
 const char *tiziheart::get_current_queue_length ()
 {
+  gil_lock gil;
   obtain_current_queue_progress ();
   return current_queue_length_.empty () ? NULL : current_queue_length_.c_str ();
 }
 
 int tiziheart::get_current_queue_length_as_int ()
 {
+  gil_lock gil;
   obtain_current_queue_progress ();
   if (current_queue_length_.empty())
     {
@@ -329,6 +390,7 @@ int tiziheart::get_current_queue_length_as_int ()
 
 const char *tiziheart::get_current_queue_progress ()
 {
+  gil_lock gil;
     const bp::tuple &queue_info = bp::extract< bp::tuple > (
       py_iheart_proxy_.attr ("current_radio_queue_index_and_queue_length") ());
   const int queue_index = bp::extract< int > (queue_info[0]);
@@ -370,33 +432,39 @@ void tiziheart::set_playback_mode (const playback_mode mode)
   (void)rc;
 }
 
-void tiziheart::get_current_radio ()
+void tiziheart::get_current_radio (radio_metadata &metadata)
 {
-  current_radio_name_.clear ();
-
-  obtain_current_queue_progress ();
+  const bp::tuple &queue_info = bp::extract< bp::tuple > (
+      py_iheart_proxy_.attr ("current_radio_queue_index_and_queue_length") ());
+  const int queue_index = bp::extract< int > (queue_info[0]);
+  const int queue_length = bp::extract< int > (queue_info[1]);
+  metadata.index.assign (boost::lexical_cast< std::string > (queue_index));
+  metadata.queue_length.assign (
+      boost::lexical_cast< std::string > (queue_length));
+  metadata.queue_progress.assign (metadata.index);
+  metadata.queue_progress.append (" of ");
+  metadata.queue_progress.append (metadata.queue_length);
 
-  current_radio_name_ = bp::extract< std::string > (
+  metadata.name = bp::extract< std::string > (
       py_iheart_proxy_.attr ("current_radio_name") ());
 
-  current_radio_description_ = bp::extract< std::string > (
+  metadata.description = bp::extract< std::string > (
       py_iheart_proxy_.attr ("current_radio_description") ());
 
-  current_radio_city_ = bp::extract< std::string > (
+  metadata.city = bp::extract< std::string > (
       py_iheart_proxy_.attr ("current_radio_city") ());
 
-  current_radio_state_ = bp::extract< std::string > (
+  metadata.state = bp::extract< std::string > (
       py_iheart_proxy_.attr ("current_radio_state") ());
 
-  current_radio_audio_encoding_ = bp::extract< std::string > (
+  metadata.audio_encoding = bp::extract< std::string > (
       py_iheart_proxy_.attr ("current_radio_audio_encoding") ());
 
-  current_radio_website_url_ = bp::extract< std::string > (
+  metadata.website_url = bp::extract< std::string > (
       py_iheart_proxy_.attr ("current_radio_website_url") ());
 
-  current_radio_thumbnail_url_ = bp::extract< std::string > (
+  metadata.thumbnail_url = bp::extract< std::string > (
       py_iheart_proxy_.attr ("current_radio_thumbnail_url") ());
-
 }
 
 void tiziheart::obtain_current_queue_progress ()
@@ -413,3 +481,85 @@ void tiziheart::obtain_current_queue_progress ()
   current_queue_length_.assign (
       boost::lexical_cast< std::string > (queue_length));
 }
+
+void tiziheart::request_metadata_refresh ()
+{
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      ++md_requested_;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+    }
+  else
+    {
+      int rc = 0;
+      radio_metadata metadata;
+      try_catch_wrapper (get_current_radio (metadata));
+      (void)rc;
+      refreshed_ = metadata;
+      md_refreshed_ = ++md_requested_;
+    }
+}
+
+bool tiziheart::publish_metadata (const bool wait)
+{
+  bool ready = false;
+  pthread_mutex_lock (&md_mutex_);
+  while (wait && md_thread_running_ && md_refreshed_ != md_requested_)
+    {
+      pthread_cond_wait (&md_cond_, &md_mutex_);
+    }
+  ready = (md_refreshed_ == md_requested_);
+  if (ready && md_published_ != md_refreshed_)
+    {
+      current_ = refreshed_;
+      md_published_ = md_refreshed_;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+  return ready;
+}
+
+const tiziheart::radio_metadata *tiziheart::get_current_radio_metadata ()
+{
+  return publish_metadata (false) ? &current_ : NULL;
+}
+
+void tiziheart::metadata_loop ()
+{
+  pthread_mutex_lock (&md_mutex_);
+  while (!md_thread_stop_)
+    {
+      if (md_refreshed_ == md_requested_)
+        {
+          pthread_cond_wait (&md_cond_, &md_mutex_);
+          continue;
+        }
+
+      const unsigned long request = md_requested_;
+      radio_metadata metadata;
+      int rc = 0;
+      pthread_mutex_unlock (&md_mutex_);
+      try_catch_wrapper (get_current_radio (metadata));
+      (void)rc;
+      pthread_mutex_lock (&md_mutex_);
+
+      // If the queue moved again in the meantime, this snapshot is stale and
+      // is simply discarded
+      if (request == md_requested_)
+        {
+          refreshed_ = metadata;
+          md_refreshed_ = request;
+          pthread_cond_broadcast (&md_cond_);
+        }
+    }
+  pthread_mutex_unlock (&md_mutex_);
+}
+
+void *tiziheart::metadata_thread_func (void *p_arg)
+{
+  tiziheart *p_this = static_cast< tiziheart * > (p_arg);
+  assert (p_this);
+  p_this->metadata_loop ();
+  return NULL;
+}
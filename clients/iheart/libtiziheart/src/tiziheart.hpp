@@ -31,6 +31,8 @@
 
 #include <boost/python.hpp>
 
+#include <pthread.h>
+
 #include <string>
 
 class tiziheart
@@ -46,6 +48,24 @@ public:
       PlaybackModeMax
     };
 
+  /**
+   * The metadata of the radio station currently selected in the playback
+   * queue.
+   */
+  struct radio_metadata
+  {
+    std::string index;
+    std::string queue_length;
+    std::string queue_progress;
+    std::string name;
+    std::string description;
+    std::string city;
+    std::string state;
+    std::string audio_encoding;
+    std::string website_url;
+    std::string thumbnail_url;
+  };
+
 public:
   tiziheart ();
   ~tiziheart ();
@@ -69,6 +89,9 @@ public:
   const char *get_url (const int a_position);
   const char *get_next_url (const bool a_remove_current_url);
   const char *get_prev_url (const bool a_remove_current_url);
+
+  const radio_metadata *get_current_radio_metadata ();
+
   const char *get_current_radio_name ();
   const char *get_current_radio_description ();
   const char *get_current_radio_city ();
@@ -80,20 +103,27 @@ public:
 
 private:
   void obtain_current_queue_progress();
-  void get_current_radio ();
+  void get_current_radio (radio_metadata &metadata);
+  void request_metadata_refresh ();
+  bool publish_metadata (const bool wait);
+  void metadata_loop ();
+  static void *metadata_thread_func (void *p_arg);
 
 private:
   std::string current_url_;
   std::string current_radio_index_;
   std::string current_queue_length_;
-  std::string current_radio_name_;
-  std::string current_radio_description_;
-  std::string current_radio_city_;
-  std::string current_radio_state_;
-  std::string current_radio_audio_encoding_;
-  std::string current_radio_website_url_;
-  std::string current_radio_thumbnail_url_;
   std::string current_queue_progress_;
+  radio_metadata current_;
+  radio_metadata refreshed_;
+  pthread_t md_thread_;
+  pthread_mutex_t md_mutex_;
+  pthread_cond_t md_cond_;
+  bool md_thread_running_;
+  bool md_thread_stop_;
+  unsigned long md_requested_;
+  unsigned long md_refreshed_;
+  unsigned long md_published_;
   boost::python::object py_main_;
   boost::python::object py_global_;
   boost::python::object py_iheart_proxy_;
@@ -189,6 +189,36 @@ extern "C" const char *tiz_iheart_get_prev_url (tiz_iheart_t *ap_iheart,
   return ap_iheart->p_proxy_->get_prev_url (a_remove_current_url);
 }
 
+static const char *metadata_item (const std::string &item)
+{
+  return item.empty () ? NULL : item.c_str ();
+}
+
+extern "C" int tiz_iheart_get_current_radio_metadata (
+    tiz_iheart_t *ap_iheart, tiz_iheart_metadata_t *ap_metadata)
+{
+  assert (ap_iheart);
+  assert (ap_iheart->p_proxy_);
+  assert (ap_metadata);
+  const tiziheart::radio_metadata *p_md
+      = ap_iheart->p_proxy_->get_current_radio_metadata ();
+  if (!p_md)
+    {
+      return 1;
+    }
+  ap_metadata->p_index = metadata_item (p_md->index);
+  ap_metadata->p_queue_length = metadata_item (p_md->queue_length);
+  ap_metadata->p_queue_progress = metadata_item (p_md->queue_progress);
+  ap_metadata->p_name = metadata_item (p_md->name);
+  ap_metadata->p_description = metadata_item (p_md->description);
+  ap_metadata->p_city = metadata_item (p_md->city);
+  ap_metadata->p_state = metadata_item (p_md->state);
+  ap_metadata->p_audio_encoding = metadata_item (p_md->audio_encoding);
+  ap_metadata->p_website_url = metadata_item (p_md->website_url);
+  ap_metadata->p_thumbnail_url = metadata_item (p_md->thumbnail_url);
+  return 0;
+}
+
 extern "C" const char *tiz_iheart_get_current_radio_name (
     tiz_iheart_t *ap_iheart)
 {
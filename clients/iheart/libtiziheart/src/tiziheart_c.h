@@ -63,6 +63,25 @@ extern "C"
     ETIZIheartPlaybackModeMax
   } tiz_iheart_playback_mode_t;
 
+  /**
+   * A snapshot of the metadata of the radio station currently selected in the
+   * playback queue. Fields are NULL when the item is not available.
+   * @ingroup libtiziheart
+   */
+  typedef struct tiz_iheart_metadata
+  {
+    const char *p_index;
+    const char *p_queue_length;
+    const char *p_queue_progress;
+    const char *p_name;
+    const char *p_description;
+    const char *p_city;
+    const char *p_state;
+    const char *p_audio_encoding;
+    const char *p_website_url;
+    const char *p_thumbnail_url;
+  } tiz_iheart_metadata_t;
+
   /**
    * Initialize the iheart handle.
    *
@@ -213,6 +232,25 @@ extern "C"
   const char *tiz_iheart_get_prev_url (tiz_iheart_t *ap_iheart,
                                        const bool a_remove_current_url);
 
+  /**
+   * Retrieve all the metadata of the current radio station in one go.
+   *
+   * The metadata is retrieved on a background thread every time the playback
+   * queue moves (see tiz_iheart_get_next_url and tiz_iheart_get_prev_url).
+   * This function does not call into the Python interpreter and never blocks.
+   *
+   * @ingroup libtiziheart
+   *
+   * @param ap_iheart The iheart handle.
+   * @param ap_metadata The snapshot to be filled in. The strings remain valid
+   * until the next call to any of the tiz_iheart_get_current_* functions.
+   *
+   * @return 0 on success, 1 if the metadata of the current radio station is still
+   * being retrieved (ap_metadata is not modified).
+   */
+  int tiz_iheart_get_current_radio_metadata (
+      tiz_iheart_t *ap_iheart, tiz_iheart_metadata_t *ap_metadata);
+
   /**
    * Retrieve the current station's name.
    *
@@ -37,10 +37,36 @@
 
 namespace bp = boost::python;
 
+namespace
+{
+  // Holds the Python interpreter lock for as long as the object is alive.
+  // The interpreter is accessed from the component's thread and from the
+  // metadata refresh thread.
+  class gil_lock
+  {
+  public:
+    gil_lock () : state_ (PyGILState_Ensure ())
+    {
+    }
+    ~gil_lock ()
+    {
+      PyGILState_Release (state_);
+    }
+
+  private:
+    gil_lock (const gil_lock &);
+    gil_lock &operator= (const gil_lock &);
+
+  private:
+    PyGILState_STATE state_;
+  };
+}  // namespace
+
 /* This macro assumes the existence of an "int rc" local variable */
 #define try_catch_wrapper(expr)                                  \
   do                                                             \
     {                                                            \
+      gil_lock gil;                                              \
       try                                                        \
         {                                                        \
           if (!rc)                                               \
@@ -71,8 +97,18 @@ namespace
   int check_deps ()
   {
     int rc = 1;
-    Py_Initialize ();
+    if (!Py_IsInitialized ())
+      {
+        Py_Initialize ();
+#if PY_VERSION_HEX < 0x03070000
+        PyEval_InitThreads ();
+#endif
+        // Release the lock acquired by the initialisation; from now on it is
+        // taken by whichever thread needs the interpreter.
+        (void)PyEval_SaveThread ();
+      }
 
+    gil_lock gil;
     try
       {
         // Import the Tizonia Plex proxy module
@@ -83,14 +119,14 @@ namespace
 
         // Check the existence of the 'plexapi' module
         bp::object ignored = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('plexapi')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
 
         // Check the existence of the 'fuzzywuzzy' module
         bp::object ignored2 = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('fuzzywuzzy')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
@@ -138,24 +174,22 @@ tizplex::tizplex (const std::string &base_url, const std::string &auth_token,
     auth_token_ (auth_token),
     music_section_ (music_section),
     current_url_ (),
-    current_track_index_ (),
-    current_queue_length_ (),
-    current_track_title_ (),
-    current_track_artist_ (),
-    current_track_album_ (),
-    current_track_year_ (),
-    current_track_file_size_ (),
-    current_track_file_size_as_int_ (0),
-    current_track_duration_ (),
-    current_track_bitrate_ (),
-    current_track_codec_ (),
-    current_track_album_art_ (),
-    current_queue_progress_ ()
+    md_thread_ (),
+    md_thread_running_ (false),
+    md_thread_stop_ (false),
+    md_requested_ (0),
+    md_refreshed_ (0),
+    md_published_ (0)
 {
+  pthread_mutex_init (&md_mutex_, NULL);
+  pthread_cond_init (&md_cond_, NULL);
 }
 
 tizplex::~tizplex ()
 {
+  stop ();
+  pthread_cond_destroy (&md_cond_);
+  pthread_mutex_destroy (&md_mutex_);
 }
 
 int tizplex::init ()
@@ -173,19 +207,42 @@ int tizplex::start ()
   int rc = 0;
   try_catch_wrapper (start_plex (py_global_, py_plex_proxy_, base_url_,
                                  auth_token_, music_section_));
+  if (!rc && !md_thread_running_)
+    {
+      md_thread_stop_ = false;
+      // If the thread can't be created, the metadata is refreshed
+      // synchronously instead (see request_metadata_refresh).
+      md_thread_running_
+          = (0 == pthread_create (&md_thread_, NULL,
+                                  &tizplex::metadata_thread_func, this));
+    }
   return rc;
 }
 
 void tizplex::stop ()
 {
-  int rc = 0;
-  // try_catch_wrapper (py_plex_proxy_.attr ("logout")());
-  (void)rc;
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      md_thread_stop_ = true;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+      pthread_join (md_thread_, NULL);
+      md_thread_running_ = false;
+    }
 }
 
 void tizplex::deinit ()
 {
-  // boost::python doesn't support Py_Finalize() yet!
+  // boost::python doesn't support Py_Finalize() yet! But the references held
+  // here need to be released while holding the interpreter lock.
+  if (Py_IsInitialized ())
+    {
+      gil_lock gil;
+      py_plex_proxy_ = bp::object ();
+      py_global_ = bp::object ();
+      py_main_ = bp::object ();
+    }
 }
 
 int tizplex::play_audio_tracks (const std::string &tracks)
@@ -222,46 +279,36 @@ int tizplex::play_audio_playlist (const std::string &playlist)
 
 const char *tizplex::get_next_url (const bool a_remove_current_url)
 {
+  int rc = 0;
   current_url_.clear ();
-  try
-    {
-      if (a_remove_current_url)
-        {
-          py_plex_proxy_.attr ("remove_current_url") ();
-        }
-      current_url_
-          = bp::extract< std::string > (py_plex_proxy_.attr ("next_url") ());
-      get_current_track ();
-    }
-  catch (bp::error_already_set &e)
+  if (a_remove_current_url)
     {
-      PyErr_PrintEx (0);
+      try_catch_wrapper (py_plex_proxy_.attr ("remove_current_url") ());
     }
-  catch (...)
+  rc = 0;
+  try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                         py_plex_proxy_.attr ("next_url") ()));
+  if (!current_url_.empty ())
     {
+      request_metadata_refresh ();
     }
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
 const char *tizplex::get_prev_url (const bool a_remove_current_url)
 {
+  int rc = 0;
   current_url_.clear ();
-  try
-    {
-      if (a_remove_current_url)
-        {
-          py_plex_proxy_.attr ("remove_current_url") ();
-        }
-      current_url_
-          = bp::extract< std::string > (py_plex_proxy_.attr ("prev_url") ());
-      get_current_track ();
-    }
-  catch (bp::error_already_set &e)
+  if (a_remove_current_url)
     {
-      PyErr_PrintEx (0);
+      try_catch_wrapper (py_plex_proxy_.attr ("remove_current_url") ());
     }
-  catch (...)
+  rc = 0;
+  try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                         py_plex_proxy_.attr ("prev_url") ()));
+  if (!current_url_.empty ())
     {
+      request_metadata_refresh ();
     }
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
@@ -275,20 +322,20 @@ void tizplex::clear_queue ()
 
 const char *tizplex::get_current_audio_track_index ()
 {
-  return current_track_index_.empty () ? NULL : current_track_index_.c_str ();
+  (void)publish_metadata (true);
+  return current_.index.empty () ? NULL : current_.index.c_str ();
 }
 
 const char *tizplex::get_current_queue_length ()
 {
-  return current_queue_length_.empty () ? NULL : current_queue_length_.c_str ();
+  (void)publish_metadata (true);
+  return current_.queue_length.empty () ? NULL : current_.queue_length.c_str ();
 }
 
 const char *tizplex::get_current_queue_progress ()
 {
-  current_queue_progress_.assign (get_current_audio_track_index ());
-  current_queue_progress_.append (" of ");
-  current_queue_progress_.append (get_current_queue_length ());
-  return current_queue_progress_.c_str ();
+  (void)publish_metadata (true);
+  return current_.queue_progress.empty () ? NULL : current_.queue_progress.c_str ();
 }
 
 void tizplex::set_playback_mode (const playback_mode mode)
@@ -317,101 +364,98 @@ void tizplex::set_playback_mode (const playback_mode mode)
 
 const char *tizplex::get_current_audio_track_title ()
 {
-  return current_track_title_.empty () ? NULL : current_track_title_.c_str ();
+  (void)publish_metadata (true);
+  return current_.title.empty () ? NULL : current_.title.c_str ();
 }
 
 const char *tizplex::get_current_audio_track_artist ()
 {
-  return current_track_artist_.empty () ? NULL : current_track_artist_.c_str ();
+  (void)publish_metadata (true);
+  return current_.artist.empty () ? NULL : current_.artist.c_str ();
 }
 
 const char *tizplex::get_current_audio_track_album ()
 {
-  return current_track_album_.empty () ? NULL : current_track_album_.c_str ();
+  (void)publish_metadata (true);
+  return current_.album.empty () ? NULL : current_.album.c_str ();
 }
 
 const char *tizplex::get_current_audio_track_year ()
 {
-  return current_track_year_.empty () ? NULL : current_track_year_.c_str ();
+  (void)publish_metadata (true);
+  return current_.year.empty () ? NULL : current_.year.c_str ();
 }
 
 const char *tizplex::get_current_audio_track_file_size ()
 {
-  return current_track_file_size_.empty () ? NULL
-                                           : current_track_file_size_.c_str ();
+  (void)publish_metadata (true);
+  return current_.file_size.empty () ? NULL : current_.file_size.c_str ();
 }
 
 int tizplex::get_current_audio_track_file_size_as_int ()
 {
-  return current_track_file_size_as_int_;
+  (void)publish_metadata (true);
+  return current_.file_size_as_int;
 }
 
 const char *tizplex::get_current_audio_track_duration ()
 {
-  return current_track_duration_.empty () ? NULL
-                                          : current_track_duration_.c_str ();
+  (void)publish_metadata (true);
+  return current_.duration.empty () ? NULL : current_.duration.c_str ();
 }
 
 const char *tizplex::get_current_audio_track_bitrate ()
 {
-  return current_track_bitrate_.empty () ? NULL
-                                         : current_track_bitrate_.c_str ();
+  (void)publish_metadata (true);
+  return current_.bitrate.empty () ? NULL : current_.bitrate.c_str ();
 }
 
 const char *tizplex::get_current_audio_track_codec ()
 {
-  return current_track_codec_.empty () ? NULL : current_track_codec_.c_str ();
+  (void)publish_metadata (true);
+  return current_.codec.empty () ? NULL : current_.codec.c_str ();
 }
 
 const char *tizplex::get_current_audio_track_album_art ()
 {
-  return current_track_album_art_.empty () ? NULL
-                                           : current_track_album_art_.c_str ();
+  (void)publish_metadata (true);
+  return current_.album_art.empty () ? NULL : current_.album_art.c_str ();
 }
 
-void tizplex::get_current_track ()
+void tizplex::get_current_track (track_metadata &metadata)
 {
-  current_track_index_.clear ();
-  current_queue_length_.clear ();
-  current_track_title_.clear ();
-  current_track_artist_.clear ();
-  current_track_album_.clear ();
-  current_track_year_.clear ();
-  current_track_file_size_.clear ();
-  current_track_duration_.clear ();
-  current_track_bitrate_.clear ();
-  current_track_codec_.clear ();
-  current_track_album_art_.clear ();
-
   const bp::tuple &queue_info = bp::extract< bp::tuple > (py_plex_proxy_.attr (
       "current_audio_track_queue_index_and_queue_length") ());
   const int queue_index = bp::extract< int > (queue_info[0]);
   const int queue_length = bp::extract< int > (queue_info[1]);
-  current_track_index_.assign (
+  metadata.index.assign (
       boost::lexical_cast< std::string > (queue_index));
-  current_queue_length_.assign (
+  metadata.queue_length.assign (
       boost::lexical_cast< std::string > (queue_length));
+  metadata.queue_progress.assign (metadata.index);
+  metadata.queue_progress.append (" of ");
+  metadata.queue_progress.append (metadata.queue_length);
 
-  current_track_title_ = bp::extract< std::string > (
+  metadata.title = bp::extract< std::string > (
       py_plex_proxy_.attr ("current_audio_track_title") ());
 
-  current_track_artist_ = bp::extract< std::string > (
+  metadata.artist = bp::extract< std::string > (
       py_plex_proxy_.attr ("current_audio_track_artist") ());
 
-  current_track_album_ = bp::extract< std::string > (
+  metadata.album = bp::extract< std::string > (
       py_plex_proxy_.attr ("current_audio_track_album") ());
 
   const int year = bp::extract< int > (
       py_plex_proxy_.attr ("current_audio_track_year") ());
-  current_track_year_.assign (boost::lexical_cast< std::string > (year));
+  metadata.year.assign (boost::lexical_cast< std::string > (year));
 
   const int file_size = bp::extract< int > (
       py_plex_proxy_.attr ("current_audio_track_file_size") ());
   char file_size_str[20];
   sprintf (file_size_str, "%.2g", (float)file_size / (1024 * 1024));
-  current_track_file_size_.assign (file_size_str);
-  current_track_file_size_.append (" MiB");
-  current_track_file_size_as_int_ = file_size;
+  metadata.file_size.assign (file_size_str);
+  metadata.file_size.append (" MiB");
+  metadata.file_size_as_int = file_size;
 
   const int duration = bp::extract< float > (
       py_plex_proxy_.attr ("current_audio_track_duration") ());
@@ -427,16 +471,16 @@ void tizplex::get_current_track ()
 
   if (hours > 0)
     {
-      current_track_duration_.assign (
+      metadata.duration.assign (
           boost::lexical_cast< std::string > (hours));
-      current_track_duration_.append ("h:");
+      metadata.duration.append ("h:");
     }
 
   if (minutes > 0)
     {
-      current_track_duration_.append (
+      metadata.duration.append (
           boost::lexical_cast< std::string > (minutes));
-      current_track_duration_.append ("m:");
+      metadata.duration.append ("m:");
     }
 
   char seconds_str[10];
@@ -448,16 +492,98 @@ void tizplex::get_current_track ()
     {
       sprintf (seconds_str, "%02i", seconds);
     }
-  current_track_duration_.append (seconds_str);
-  current_track_duration_.append ("s");
+  metadata.duration.append (seconds_str);
+  metadata.duration.append ("s");
 
   const int bitrate = bp::extract< int > (
       py_plex_proxy_.attr ("current_audio_track_bitrate") ());
-  current_track_bitrate_.assign (boost::lexical_cast< std::string > (bitrate));
+  metadata.bitrate.assign (boost::lexical_cast< std::string > (bitrate));
 
-  current_track_codec_ = bp::extract< std::string > (
+  metadata.codec = bp::extract< std::string > (
       py_plex_proxy_.attr ("current_audio_track_codec") ());
 
-  current_track_album_art_ = bp::extract< std::string > (
+  metadata.album_art = bp::extract< std::string > (
       py_plex_proxy_.attr ("current_audio_track_album_art") ());
 }
+
+void tizplex::request_metadata_refresh ()
+{
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      ++md_requested_;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+    }
+  else
+    {
+      int rc = 0;
+      track_metadata metadata;
+      try_catch_wrapper (get_current_track (metadata));
+      (void)rc;
+      refreshed_ = metadata;
+      md_refreshed_ = ++md_requested_;
+    }
+}
+
+bool tizplex::publish_metadata (const bool wait)
+{
+  bool ready = false;
+  pthread_mutex_lock (&md_mutex_);
+  while (wait && md_thread_running_ && md_refreshed_ != md_requested_)
+    {
+      pthread_cond_wait (&md_cond_, &md_mutex_);
+    }
+  ready = (md_refreshed_ == md_requested_);
+  if (ready && md_published_ != md_refreshed_)
+    {
+      current_ = refreshed_;
+      md_published_ = md_refreshed_;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+  return ready;
+}
+
+const tizplex::track_metadata *tizplex::get_current_audio_track_metadata ()
+{
+  return publish_metadata (false) ? &current_ : NULL;
+}
+
+void tizplex::metadata_loop ()
+{
+  pthread_mutex_lock (&md_mutex_);
+  while (!md_thread_stop_)
+    {
+      if (md_refreshed_ == md_requested_)
+        {
+          pthread_cond_wait (&md_cond_, &md_mutex_);
+          continue;
+        }
+
+      const unsigned long request = md_requested_;
+      track_metadata metadata;
+      int rc = 0;
+      pthread_mutex_unlock (&md_mutex_);
+      try_catch_wrapper (get_current_track (metadata));
+      (void)rc;
+      pthread_mutex_lock (&md_mutex_);
+
+      // If the queue moved again in the meantime, this snapshot is stale and
+      // is simply discarded
+      if (request == md_requested_)
+        {
+          refreshed_ = metadata;
+          md_refreshed_ = request;
+          pthread_cond_broadcast (&md_cond_);
+        }
+    }
+  pthread_mutex_unlock (&md_mutex_);
+}
+
+void *tizplex::metadata_thread_func (void *p_arg)
+{
+  tizplex *p_this = static_cast< tizplex * > (p_arg);
+  assert (p_this);
+  p_this->metadata_loop ();
+  return NULL;
+}
@@ -32,6 +32,8 @@
 
 #include <boost/python.hpp>
 
+#include <pthread.h>
+
 #include <string>
 
 class tizplex
@@ -47,6 +49,29 @@ public:
     PlaybackModeMax
   };
 
+  /**
+   * The metadata of the track currently selected in the playback queue.
+   */
+  struct track_metadata
+  {
+    track_metadata () : file_size_as_int (0)
+    {
+    }
+    std::string index;
+    std::string queue_length;
+    std::string queue_progress;
+    std::string title;
+    std::string artist;
+    std::string album;
+    std::string year;
+    std::string file_size;
+    int file_size_as_int;
+    std::string duration;
+    std::string bitrate;
+    std::string codec;
+    std::string album_art;
+  };
+
 public:
   tizplex (const std::string &base_url, const std::string &auth_token,
            const std::string &music_section);
@@ -71,6 +96,9 @@ public:
   const char *get_next_url (const bool a_remove_current_url);
   const char *get_prev_url (const bool a_remove_current_url);
 
+  const track_metadata *get_current_audio_track_metadata ();
+
+
   const char *get_current_audio_track_title ();
   const char *get_current_audio_track_artist ();
   const char *get_current_audio_track_album ();
@@ -83,26 +111,27 @@ public:
   const char *get_current_audio_track_album_art ();
 
 private:
-  void get_current_track ();
+  void get_current_track (track_metadata &metadata);
+  void request_metadata_refresh ();
+  bool publish_metadata (const bool wait);
+  void metadata_loop ();
+  static void *metadata_thread_func (void *p_arg);
 
 private:
   std::string base_url_;
   std::string auth_token_;
   std::string music_section_;
   std::string current_url_;
-  std::string current_track_index_;
-  std::string current_queue_length_;
-  std::string current_track_title_;
-  std::string current_track_artist_;
-  std::string current_track_album_;
-  std::string current_track_year_;
-  std::string current_track_file_size_;
-  int current_track_file_size_as_int_;
-  std::string current_track_duration_;
-  std::string current_track_bitrate_;
-  std::string current_track_codec_;
-  std::string current_track_album_art_;
-  std::string current_queue_progress_;
+  track_metadata current_;
+  track_metadata refreshed_;
+  pthread_t md_thread_;
+  pthread_mutex_t md_mutex_;
+  pthread_cond_t md_cond_;
+  bool md_thread_running_;
+  bool md_thread_stop_;
+  unsigned long md_requested_;
+  unsigned long md_refreshed_;
+  unsigned long md_published_;
   boost::python::object py_main_;
   boost::python::object py_global_;
   boost::python::object py_plex_proxy_;
@@ -214,6 +214,38 @@ extern "C" const char *tiz_plex_get_prev_url (tiz_plex_t *ap_plex,
   return ap_plex->p_proxy_->get_prev_url (a_remove_current_url);
 }
 
+static const char *metadata_item (const std::string &item)
+{
+  return item.empty () ? NULL : item.c_str ();
+}
+
+extern "C" int tiz_plex_get_current_audio_track_metadata (
+    tiz_plex_t *ap_plex, tiz_plex_metadata_t *ap_metadata)
+{
+  assert (ap_plex);
+  assert (ap_plex->p_proxy_);
+  assert (ap_metadata);
+  const tizplex::track_metadata *p_md
+      = ap_plex->p_proxy_->get_current_audio_track_metadata ();
+  if (!p_md)
+    {
+      return 1;
+    }
+  ap_metadata->p_index = metadata_item (p_md->index);
+  ap_metadata->p_queue_length = metadata_item (p_md->queue_length);
+  ap_metadata->p_queue_progress = metadata_item (p_md->queue_progress);
+  ap_metadata->p_title = metadata_item (p_md->title);
+  ap_metadata->p_artist = metadata_item (p_md->artist);
+  ap_metadata->p_album = metadata_item (p_md->album);
+  ap_metadata->p_year = metadata_item (p_md->year);
+  ap_metadata->p_file_size = metadata_item (p_md->file_size);
+  ap_metadata->p_duration = metadata_item (p_md->duration);
+  ap_metadata->p_bitrate = metadata_item (p_md->bitrate);
+  ap_metadata->p_codec = metadata_item (p_md->codec);
+  ap_metadata->p_album_art = metadata_item (p_md->album_art);
+  return 0;
+}
+
 extern "C" const char *tiz_plex_get_current_audio_track_title (
     tiz_plex_t *ap_plex)
 {
@@ -64,6 +64,27 @@ extern "C"
     ETIZPlexPlaybackModeMax
   } tiz_plex_playback_mode_t;
 
+  /**
+   * A snapshot of the metadata of the audio track currently selected in the
+   * playback queue. Fields are NULL when the item is not available.
+   * @ingroup libtizplex
+   */
+  typedef struct tiz_plex_metadata
+  {
+    const char *p_index;
+    const char *p_queue_length;
+    const char *p_queue_progress;
+    const char *p_title;
+    const char *p_artist;
+    const char *p_album;
+    const char *p_year;
+    const char *p_file_size;
+    const char *p_duration;
+    const char *p_bitrate;
+    const char *p_codec;
+    const char *p_album_art;
+  } tiz_plex_metadata_t;
+
   /**
    * Initialize the tiz_plex handle.
    *
@@ -225,6 +246,25 @@ extern "C"
   const char *tiz_plex_get_prev_url (tiz_plex_t *ap_plex,
                                      const bool a_remove_current_url);
 
+  /**
+   * Retrieve all the metadata of the current audio track in one go.
+   *
+   * The metadata is retrieved on a background thread every time the playback
+   * queue moves (see tiz_plex_get_next_url and tiz_plex_get_prev_url).
+   * This function does not call into the Python interpreter and never blocks.
+   *
+   * @ingroup libtizplex
+   *
+   * @param ap_plex The plex handle.
+   * @param ap_metadata The snapshot to be filled in. The strings remain valid
+   * until the next call to any of the tiz_plex_get_current_* functions.
+   *
+   * @return 0 on success, 1 if the metadata of the current audio track is still
+   * being retrieved (ap_metadata is not modified).
+   */
+  int tiz_plex_get_current_audio_track_metadata (
+      tiz_plex_t *ap_plex, tiz_plex_metadata_t *ap_metadata);
+
   /**
    * Retrieve the current audio track's title.
    *
@@ -37,10 +37,36 @@
 
 namespace bp = boost::python;
 
+namespace
+{
+  // Holds the Python interpreter lock for as long as the object is alive.
+  // The interpreter is accessed from the component's thread and from the
+  // metadata refresh thread.
+  class gil_lock
+  {
+  public:
+    gil_lock () : state_ (PyGILState_Ensure ())
+    {
+    }
+    ~gil_lock ()
+    {
+      PyGILState_Release (state_);
+    }
+
+  private:
+    gil_lock (const gil_lock &);
+    gil_lock &operator= (const gil_lock &);
+
+  private:
+    PyGILState_STATE state_;
+  };
+}  // namespace
+
 /* This macro assumes the existence of an "int rc" local variable */
 #define try_catch_wrapper(expr)                                  \
   do                                                             \
     {                                                            \
+      gil_lock gil;                                              \
       try                                                        \
         {                                                        \
           if (!rc)                                               \
@@ -71,8 +97,18 @@ namespace
   int check_deps ()
   {
     int rc = 1;
-    Py_Initialize ();
+    if (!Py_IsInitialized ())
+      {
+        Py_Initialize ();
+#if PY_VERSION_HEX < 0x03070000
+        PyEval_InitThreads ();
+#endif
+        // Release the lock acquired by the initialisation; from now on it is
+        // taken by whichever thread needs the interpreter.
+        (void)PyEval_SaveThread ();
+      }
 
+    gil_lock gil;
     try
       {
         // Import the Google Play Music proxy module
@@ -83,14 +119,14 @@ namespace
 
         // Check the existence of the 'soundcloud' module
         bp::object ignored = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('soundcloud')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
 
         // Check the existence of the 'fuzzywuzzy' module
         bp::object ignored2 = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('fuzzywuzzy')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
@@ -131,12 +167,23 @@ namespace
 }  // namespace
 
 tizsoundcloud::tizsoundcloud (const std::string &oauth_token)
-  : oauth_token_ (oauth_token)
+  : oauth_token_ (oauth_token),
+    md_thread_ (),
+    md_thread_running_ (false),
+    md_thread_stop_ (false),
+    md_requested_ (0),
+    md_refreshed_ (0),
+    md_published_ (0)
 {
+  pthread_mutex_init (&md_mutex_, NULL);
+  pthread_cond_init (&md_cond_, NULL);
 }
 
 tizsoundcloud::~tizsoundcloud ()
 {
+  stop ();
+  pthread_cond_destroy (&md_cond_);
+  pthread_mutex_destroy (&md_mutex_);
 }
 
 int tizsoundcloud::init ()
@@ -153,19 +200,42 @@ int tizsoundcloud::start ()
 {
   int rc = 0;
   try_catch_wrapper (start_soundcloud (py_global_, py_gm_proxy_, oauth_token_));
+  if (!rc && !md_thread_running_)
+    {
+      md_thread_stop_ = false;
+      // If the thread can't be created, the metadata is refreshed
+      // synchronously instead (see request_metadata_refresh).
+      md_thread_running_
+          = (0 == pthread_create (&md_thread_, NULL,
+                                  &tizsoundcloud::metadata_thread_func, this));
+    }
   return rc;
 }
 
 void tizsoundcloud::stop ()
 {
-  int rc = 0;
-  // try_catch_wrapper (py_gm_proxy_.attr ("logout")());
-  (void)rc;
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      md_thread_stop_ = true;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+      pthread_join (md_thread_, NULL);
+      md_thread_running_ = false;
+    }
 }
 
 void tizsoundcloud::deinit ()
 {
-  // boost::python doesn't support Py_Finalize() yet!
+  // boost::python doesn't support Py_Finalize() yet! But the references held
+  // here need to be released while holding the interpreter lock.
+  if (Py_IsInitialized ())
+    {
+      gil_lock gil;
+      py_gm_proxy_ = bp::object ();
+      py_global_ = bp::object ();
+      py_main_ = bp::object ();
+    }
 }
 
 int tizsoundcloud::play_user_stream ()
@@ -231,84 +301,76 @@ int tizsoundcloud::play_tags (const std::string &tags)
 
 const char *tizsoundcloud::get_next_url ()
 {
+  int rc = 0;
   current_url_.clear ();
-  try
-    {
-      current_url_
-          = bp::extract< std::string > (py_gm_proxy_.attr ("next_url") ());
-      get_current_track ();
-    }
-  catch (bp::error_already_set &e)
-    {
-      PyErr_PrintEx (0);
-    }
-  catch (...)
+  try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                         py_gm_proxy_.attr ("next_url") ()));
+  if (!current_url_.empty ())
     {
+      request_metadata_refresh ();
     }
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
 const char *tizsoundcloud::get_prev_url ()
 {
+  int rc = 0;
   current_url_.clear ();
-  try
-    {
-      current_url_
-          = bp::extract< std::string > (py_gm_proxy_.attr ("prev_url") ());
-      get_current_track ();
-    }
-  catch (bp::error_already_set &e)
-    {
-      PyErr_PrintEx (0);
-    }
-  catch (...)
+  try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                         py_gm_proxy_.attr ("prev_url") ()));
+  if (!current_url_.empty ())
     {
+      request_metadata_refresh ();
     }
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
 const char *tizsoundcloud::get_current_track_user ()
 {
-  return current_user_.empty () ? NULL : current_user_.c_str ();
+  (void)publish_metadata (true);
+  return current_.user.empty () ? NULL : current_.user.c_str ();
 }
 
 const char *tizsoundcloud::get_current_track_title ()
 {
-  return current_title_.empty () ? NULL : current_title_.c_str ();
+  (void)publish_metadata (true);
+  return current_.title.empty () ? NULL : current_.title.c_str ();
 }
 
 const char *tizsoundcloud::get_current_track_duration ()
 {
-  return current_duration_.empty () ? NULL : current_duration_.c_str ();
+  (void)publish_metadata (true);
+  return current_.duration.empty () ? NULL : current_.duration.c_str ();
 }
 
 const char *tizsoundcloud::get_current_track_year ()
 {
-  return current_track_year_.empty () ? NULL : current_track_year_.c_str ();
+  (void)publish_metadata (true);
+  return current_.year.empty () ? NULL : current_.year.c_str ();
 }
 
 const char *tizsoundcloud::get_current_track_permalink ()
 {
-  return current_track_permalink_.empty () ? NULL
-                                           : current_track_permalink_.c_str ();
+  (void)publish_metadata (true);
+  return current_.permalink.empty () ? NULL : current_.permalink.c_str ();
 }
 
 const char *tizsoundcloud::get_current_track_license ()
 {
-  return current_track_license_.empty () ? NULL
-                                         : current_track_license_.c_str ();
+  (void)publish_metadata (true);
+  return current_.license.empty () ? NULL : current_.license.c_str ();
 }
 
 const char *tizsoundcloud::get_current_track_likes ()
 {
-  return current_track_likes_.empty () ? NULL : current_track_likes_.c_str ();
+  (void)publish_metadata (true);
+  return current_.likes.empty () ? NULL : current_.likes.c_str ();
 }
 
 const char *tizsoundcloud::get_current_track_user_avatar ()
 {
-  return current_track_user_avatar_.empty ()
-             ? NULL
-             : current_track_user_avatar_.c_str ();
+  (void)publish_metadata (true);
+  return current_.user_avatar.empty () ? NULL : current_.user_avatar.c_str ();
 }
 
 void tizsoundcloud::clear_queue ()
@@ -342,21 +404,17 @@ void tizsoundcloud::set_playback_mode (const playback_mode mode)
   (void)rc;
 }
 
-void tizsoundcloud::get_current_track ()
+void tizsoundcloud::get_current_track (track_metadata &metadata)
 {
-  current_user_.clear ();
-  current_title_.clear ();
-
   const bp::tuple &info1 = bp::extract< bp::tuple > (
       py_gm_proxy_.attr ("current_track_title_and_user") ());
-  current_user_ = bp::extract< std::string > (info1[0]);
-  current_title_ = bp::extract< std::string > (info1[1]);
+  metadata.user = bp::extract< std::string > (info1[0]);
+  metadata.title = bp::extract< std::string > (info1[1]);
 
   int duration
       = bp::extract< int > (py_gm_proxy_.attr ("current_track_duration") ());
 
   int seconds = 0;
-  current_duration_.clear ();
   if (duration)
     {
       duration /= 1000;
@@ -372,38 +430,120 @@ void tizsoundcloud::get_current_track ()
 
       if (hours > 0)
         {
-          current_duration_.append (boost::lexical_cast< std::string > (hours));
-          current_duration_.append ("h:");
+          metadata.duration.append (boost::lexical_cast< std::string > (hours));
+          metadata.duration.append ("h:");
         }
 
       if (minutes > 0)
         {
-          current_duration_.append (
+          metadata.duration.append (
               boost::lexical_cast< std::string > (minutes));
-          current_duration_.append ("m:");
+          metadata.duration.append ("m:");
         }
     }
 
   char seconds_str[6];
   sprintf (seconds_str, "%02i", seconds);
-  current_duration_.append (seconds_str);
-  current_duration_.append ("s");
+  metadata.duration.append (seconds_str);
+  metadata.duration.append ("s");
 
   const int track_year
       = bp::extract< int > (py_gm_proxy_.attr ("current_track_year") ());
-  current_track_year_.assign (boost::lexical_cast< std::string > (track_year));
+  metadata.year.assign (boost::lexical_cast< std::string > (track_year));
 
-  current_track_permalink_ = bp::extract< std::string > (
+  metadata.permalink = bp::extract< std::string > (
       py_gm_proxy_.attr ("current_track_permalink") ());
 
-  current_track_license_ = bp::extract< std::string > (
+  metadata.license = bp::extract< std::string > (
       py_gm_proxy_.attr ("current_track_license") ());
 
   const int track_likes
       = bp::extract< int > (py_gm_proxy_.attr ("current_track_likes") ());
-  current_track_likes_.assign (
+  metadata.likes.assign (
       boost::lexical_cast< std::string > (track_likes));
 
-  current_track_user_avatar_ = bp::extract< std::string > (
+  metadata.user_avatar = bp::extract< std::string > (
       py_gm_proxy_.attr ("current_track_user_avatar") ());
 }
+
+void tizsoundcloud::request_metadata_refresh ()
+{
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      ++md_requested_;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+    }
+  else
+    {
+      int rc = 0;
+      track_metadata metadata;
+      try_catch_wrapper (get_current_track (metadata));
+      (void)rc;
+      refreshed_ = metadata;
+      md_refreshed_ = ++md_requested_;
+    }
+}
+
+bool tizsoundcloud::publish_metadata (const bool wait)
+{
+  bool ready = false;
+  pthread_mutex_lock (&md_mutex_);
+  while (wait && md_thread_running_ && md_refreshed_ != md_requested_)
+    {
+      pthread_cond_wait (&md_cond_, &md_mutex_);
+    }
+  ready = (md_refreshed_ == md_requested_);
+  if (ready && md_published_ != md_refreshed_)
+    {
+      current_ = refreshed_;
+      md_published_ = md_refreshed_;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+  return ready;
+}
+
+const tizsoundcloud::track_metadata *tizsoundcloud::get_current_track_metadata ()
+{
+  return publish_metadata (false) ? &current_ : NULL;
+}
+
+void tizsoundcloud::metadata_loop ()
+{
+  pthread_mutex_lock (&md_mutex_);
+  while (!md_thread_stop_)
+    {
+      if (md_refreshed_ == md_requested_)
+        {
+          pthread_cond_wait (&md_cond_, &md_mutex_);
+          continue;
+        }
+
+      const unsigned long request = md_requested_;
+      track_metadata metadata;
+      int rc = 0;
+      pthread_mutex_unlock (&md_mutex_);
+      try_catch_wrapper (get_current_track (metadata));
+      (void)rc;
+      pthread_mutex_lock (&md_mutex_);
+
+      // If the queue moved again in the meantime, this snapshot is stale and
+      // is simply discarded
+      if (request == md_requested_)
+        {
+          refreshed_ = metadata;
+          md_refreshed_ = request;
+          pthread_cond_broadcast (&md_cond_);
+        }
+    }
+  pthread_mutex_unlock (&md_mutex_);
+}
+
+void *tizsoundcloud::metadata_thread_func (void *p_arg)
+{
+  tizsoundcloud *p_this = static_cast< tizsoundcloud * > (p_arg);
+  assert (p_this);
+  p_this->metadata_loop ();
+  return NULL;
+}
@@ -32,6 +32,8 @@
 
 #include <boost/python.hpp>
 
+#include <pthread.h>
+
 #include <string>
 
 class tizsoundcloud
@@ -47,6 +49,21 @@ public:
     PlaybackModeMax
   };
 
+  /**
+   * The metadata of the track currently selected in the playback queue.
+   */
+  struct track_metadata
+  {
+    std::string user;
+    std::string title;
+    std::string duration;
+    std::string year;
+    std::string permalink;
+    std::string license;
+    std::string likes;
+    std::string user_avatar;
+  };
+
 public:
   tizsoundcloud (const std::string &oauth_token);
   ~tizsoundcloud ();
@@ -70,6 +87,9 @@ public:
 
   const char *get_next_url ();
   const char *get_prev_url ();
+
+  const track_metadata *get_current_track_metadata ();
+
   const char *get_current_track_user ();
   const char *get_current_track_title ();
   const char *get_current_track_duration ();
@@ -80,19 +100,25 @@ public:
   const char *get_current_track_user_avatar ();
 
 private:
-  void get_current_track ();
+  void get_current_track (track_metadata &metadata);
+  void request_metadata_refresh ();
+  bool publish_metadata (const bool wait);
+  void metadata_loop ();
+  static void *metadata_thread_func (void *p_arg);
 
 private:
   std::string oauth_token_;
   std::string current_url_;
-  std::string current_user_;
-  std::string current_title_;
-  std::string current_duration_;
-  std::string current_track_year_;
-  std::string current_track_permalink_;
-  std::string current_track_license_;
-  std::string current_track_likes_;
-  std::string current_track_user_avatar_;
+  track_metadata current_;
+  track_metadata refreshed_;
+  pthread_t md_thread_;
+  pthread_mutex_t md_mutex_;
+  pthread_cond_t md_cond_;
+  bool md_thread_running_;
+  bool md_thread_stop_;
+  unsigned long md_requested_;
+  unsigned long md_refreshed_;
+  unsigned long md_published_;
   boost::python::object py_main_;
   boost::python::object py_global_;
   boost::python::object py_gm_proxy_;
@@ -194,6 +194,34 @@ extern "C" const char *tiz_scloud_get_prev_url (tiz_scloud_t *ap_scloud)
   return ap_scloud->p_proxy_->get_prev_url ();
 }
 
+static const char *metadata_item (const std::string &item)
+{
+  return item.empty () ? NULL : item.c_str ();
+}
+
+extern "C" int tiz_scloud_get_current_track_metadata (
+    tiz_scloud_t *ap_scloud, tiz_scloud_metadata_t *ap_metadata)
+{
+  assert (ap_scloud);
+  assert (ap_scloud->p_proxy_);
+  assert (ap_metadata);
+  const tizsoundcloud::track_metadata *p_md
+      = ap_scloud->p_proxy_->get_current_track_metadata ();
+  if (!p_md)
+    {
+      return 1;
+    }
+  ap_metadata->p_user = metadata_item (p_md->user);
+  ap_metadata->p_title = metadata_item (p_md->title);
+  ap_metadata->p_duration = metadata_item (p_md->duration);
+  ap_metadata->p_year = metadata_item (p_md->year);
+  ap_metadata->p_permalink = metadata_item (p_md->permalink);
+  ap_metadata->p_license = metadata_item (p_md->license);
+  ap_metadata->p_likes = metadata_item (p_md->likes);
+  ap_metadata->p_user_avatar = metadata_item (p_md->user_avatar);
+  return 0;
+}
+
 extern "C" const char *tiz_scloud_get_current_track_user (
     tiz_scloud_t *ap_scloud)
 {
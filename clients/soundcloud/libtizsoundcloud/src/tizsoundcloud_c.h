@@ -64,6 +64,23 @@ extern "C"
     ETIZScloudPlaybackModeMax
   } tiz_scloud_playback_mode_t;
 
+  /**
+   * A snapshot of the metadata of the track currently selected in the
+   * playback queue. Fields are NULL when the item is not available.
+   * @ingroup libtizsoundcloud
+   */
+  typedef struct tiz_scloud_metadata
+  {
+    const char *p_user;
+    const char *p_title;
+    const char *p_duration;
+    const char *p_year;
+    const char *p_permalink;
+    const char *p_license;
+    const char *p_likes;
+    const char *p_user_avatar;
+  } tiz_scloud_metadata_t;
+
   /**
    * Initialize the soundcloud handle.
    *
@@ -240,6 +257,25 @@ extern "C"
    */
   const char *tiz_scloud_get_prev_url (tiz_scloud_t *ap_scloud);
 
+  /**
+   * Retrieve all the metadata of the current track in one go.
+   *
+   * The metadata is retrieved on a background thread every time the playback
+   * queue moves (see tiz_scloud_get_next_url and tiz_scloud_get_prev_url).
+   * This function does not call into the Python interpreter and never blocks.
+   *
+   * @ingroup libtizsoundcloud
+   *
+   * @param ap_scloud The scloud handle.
+   * @param ap_metadata The snapshot to be filled in. The strings remain valid
+   * until the next call to any of the tiz_scloud_get_current_* functions.
+   *
+   * @return 0 on success, 1 if the metadata of the current track is still
+   * being retrieved (ap_metadata is not modified).
+   */
+  int tiz_scloud_get_current_track_metadata (
+      tiz_scloud_t *ap_scloud, tiz_scloud_metadata_t *ap_metadata);
+
   /**
    * Retrieve the current track's uploader/creator/artist.
    *
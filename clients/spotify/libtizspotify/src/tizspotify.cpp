@@ -37,10 +37,36 @@
 
 namespace bp = boost::python;
 
+namespace
+{
+  // Holds the Python interpreter lock for as long as the object is alive.
+  // The interpreter is shared with the other client libraries, which may be
+  // using it from their own threads.
+  class gil_lock
+  {
+  public:
+    gil_lock () : state_ (PyGILState_Ensure ())
+    {
+    }
+    ~gil_lock ()
+    {
+      PyGILState_Release (state_);
+    }
+
+  private:
+    gil_lock (const gil_lock &);
+    gil_lock &operator= (const gil_lock &);
+
+  private:
+    PyGILState_STATE state_;
+  };
+}  // namespace
+
 /* This macro assumes the existence of an "int rc" local variable */
 #define try_catch_wrapper(expr)                                  \
   do                                                             \
     {                                                            \
+      gil_lock gil;                                              \
       try                                                        \
         {                                                        \
           if (!rc)                                               \
@@ -71,8 +97,18 @@ namespace
   int check_deps ()
   {
     int rc = 1;
-    Py_Initialize ();
+    if (!Py_IsInitialized ())
+      {
+        Py_Initialize ();
+#if PY_VERSION_HEX < 0x03070000
+        PyEval_InitThreads ();
+#endif
+        // Release the lock acquired by the initialisation; from now on it is
+        // taken by whichever thread needs the interpreter.
+        (void)PyEval_SaveThread ();
+      }
 
+    gil_lock gil;
     try
       {
         // Import the Tizonia Spotify proxy module
@@ -83,14 +119,14 @@ namespace
 
         // Check the existence of the 'spotipy' module
         bp::object ignored = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('spotipy')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
 
         // Check the existence of the 'fuzzywuzzy' module
         bp::object ignored2 = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('fuzzywuzzy')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
@@ -178,7 +214,15 @@ void tizspotify::stop ()
 
 void tizspotify::deinit ()
 {
-  // boost::python doesn't support Py_Finalize() yet!
+  // boost::python doesn't support Py_Finalize() yet! But the references held
+  // here need to be released while holding the interpreter lock.
+  if (Py_IsInitialized ())
+    {
+      gil_lock gil;
+      py_spotify_proxy_ = bp::object ();
+      py_global_ = bp::object ();
+      py_main_ = bp::object ();
+    }
 }
 
 int tizspotify::play_tracks (const std::string &tracks)
@@ -297,6 +341,7 @@ int tizspotify::play_recommendations_by_genre (const std::string &genre)
 
 const char *tizspotify::get_next_uri (const bool a_remove_current_uri)
 {
+  gil_lock gil;
   current_uri_.clear ();
   try
     {
@@ -327,6 +372,7 @@ const char *tizspotify::get_next_uri (const bool a_remove_current_uri)
 
 const char *tizspotify::get_prev_uri (const bool a_remove_current_uri)
 {
+  gil_lock gil;
   current_uri_.clear ();
   try
     {
@@ -37,10 +37,36 @@
 
 namespace bp = boost::python;
 
+namespace
+{
+  // Holds the Python interpreter lock for as long as the object is alive.
+  // The interpreter is accessed from the component's thread and from the
+  // metadata refresh thread.
+  class gil_lock
+  {
+  public:
+    gil_lock () : state_ (PyGILState_Ensure ())
+    {
+    }
+    ~gil_lock ()
+    {
+      PyGILState_Release (state_);
+    }
+
+  private:
+    gil_lock (const gil_lock &);
+    gil_lock &operator= (const gil_lock &);
+
+  private:
+    PyGILState_STATE state_;
+  };
+}  // namespace
+
 /* This macro assumes the existence of an "int rc" local variable */
 #define try_catch_wrapper(expr)                                  \
   do                                                             \
     {                                                            \
+      gil_lock gil;                                              \
       try                                                        \
         {                                                        \
           (expr);                                                \
@@ -66,8 +92,18 @@ namespace
   int check_deps ()
   {
     int rc = 1;
-    Py_Initialize ();
+    if (!Py_IsInitialized ())
+      {
+        Py_Initialize ();
+#if PY_VERSION_HEX < 0x03070000
+        PyEval_InitThreads ();
+#endif
+        // Release the lock acquired by the initialisation; from now on it is
+        // taken by whichever thread needs the interpreter.
+        (void)PyEval_SaveThread ();
+      }
 
+    gil_lock gil;
     try
       {
         // Import the Tizonia Plex proxy module
@@ -78,14 +114,14 @@ namespace
 
         // Check the existence of the 'joblib' module
         bp::object ignored = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('joblib')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
 
         // Check the existence of the 'fuzzywuzzy' module
         bp::object ignored2 = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('fuzzywuzzy')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
@@ -122,15 +158,43 @@ namespace
     bp::object pytuneinproxy = py_global["tiztuneinproxy"];
     py_tunein_proxy = pytuneinproxy ();
   }
+
+  // Urls resolved in advance are discarded after this many seconds
+  const unsigned int default_url_lookahead_ttl = 300;
+
+  time_t monotonic_seconds ()
+  {
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return now.tv_sec;
+  }
 }  // namespace
 
 tiztunein::tiztunein ()
-  : current_url_ (), current_radio_index_ (), current_queue_length_ ()
+  : current_url_ (),
+    current_radio_index_ (),
+    current_queue_length_ (),
+    md_thread_ (),
+    md_thread_running_ (false),
+    md_thread_stop_ (false),
+    md_requested_ (0),
+    md_refreshed_ (0),
+    md_published_ (0),
+    lookahead_next_ (),
+    lookahead_prev_ (),
+    la_requested_ (0),
+    la_resolved_ (0),
+    la_ttl_ (default_url_lookahead_ttl)
 {
+  pthread_mutex_init (&md_mutex_, NULL);
+  pthread_cond_init (&md_cond_, NULL);
 }
 
 tiztunein::~tiztunein ()
 {
+  stop ();
+  pthread_cond_destroy (&md_cond_);
+  pthread_mutex_destroy (&md_mutex_);
 }
 
 int tiztunein::init ()
@@ -147,19 +211,42 @@ int tiztunein::start ()
 {
   int rc = 0;
   try_catch_wrapper (start_tunein (py_global_, py_tunein_proxy_));
+  if (!rc && !md_thread_running_)
+    {
+      md_thread_stop_ = false;
+      // If the thread can't be created, the metadata is refreshed
+      // synchronously instead (see request_metadata_refresh).
+      md_thread_running_
+          = (0 == pthread_create (&md_thread_, NULL,
+                                  &tiztunein::metadata_thread_func, this));
+    }
   return rc;
 }
 
 void tiztunein::stop ()
 {
-  int rc = 0;
-  // try_catch_wrapper (py_tunein_proxy_.attr ("logout")());
-  (void)rc;
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      md_thread_stop_ = true;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+      pthread_join (md_thread_, NULL);
+      md_thread_running_ = false;
+    }
 }
 
 void tiztunein::deinit ()
 {
-  // boost::python doesn't support Py_Finalize() yet!
+  // boost::python doesn't support Py_Finalize() yet! But the references held
+  // here need to be released while holding the interpreter lock.
+  if (Py_IsInitialized ())
+    {
+      gil_lock gil;
+      py_tunein_proxy_ = bp::object ();
+      py_global_ = bp::object ();
+      py_main_ = bp::object ();
+    }
 }
 
 int tiztunein::play_radios (const std::string &query,
@@ -171,6 +258,7 @@ int tiztunein::play_radios (const std::string &query,
   try_catch_wrapper (py_tunein_proxy_.attr ("enqueue_radios") (
       bp::object (query), bp::object (keywords1), bp::object (keywords2),
       bp::object (keywords3)));
+  reset_url_lookahead (false);
   return rc;
 }
 
@@ -183,77 +271,91 @@ int tiztunein::play_category (const std::string &category,
   try_catch_wrapper (py_tunein_proxy_.attr ("enqueue_category") (
       bp::object (category), bp::object (keywords1), bp::object (keywords2),
       bp::object (keywords3)));
+  reset_url_lookahead (false);
   return rc;
 }
 
-const char *tiztunein::get_next_url (const bool a_remove_current_url)
+const char *tiztunein::move_queue (const char *p_method, const int offset,
+                                   const bool a_remove_current_url)
 {
+  int rc = 0;
+  int position = -1;
   current_url_.clear ();
-  try
+  if (a_remove_current_url)
     {
-      if (a_remove_current_url)
+      // This shifts the queue positions, so the urls resolved in advance
+      // can't be used
+      try_catch_wrapper (py_tunein_proxy_.attr ("remove_current_url") ());
+      rc = 0;
+    }
+  else if (take_resolved_url (offset, position))
+    {
+      // The proxy only needs to update its queue position
+      try_catch_wrapper (
+          py_tunein_proxy_.attr ("skip_to") (bp::object (position)));
+      if (rc)
         {
-          py_tunein_proxy_.attr ("remove_current_url") ();
+          current_url_.clear ();
+          rc = 0;
         }
-      current_url_
-          = bp::extract< std::string > (py_tunein_proxy_.attr ("next_url") ());
-      get_current_radio ();
     }
-  catch (bp::error_already_set &e)
+
+  if (current_url_.empty ())
     {
-      PyErr_PrintEx (0);
+      try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                             py_tunein_proxy_.attr (p_method) ()));
     }
-  catch (...)
+  (void)rc;
+
+  if (!current_url_.empty ())
     {
+      // The queue has moved; the new item's metadata and the urls of its
+      // neighbours are retrieved in the background
+      request_metadata_refresh ();
     }
+  reset_url_lookahead (!current_url_.empty ());
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
+const char *tiztunein::get_next_url (const bool a_remove_current_url)
+{
+  return move_queue ("next_url", 1, a_remove_current_url);
+}
+
 const char *tiztunein::get_prev_url (const bool a_remove_current_url)
 {
-  current_url_.clear ();
-  try
-    {
-      if (a_remove_current_url)
-        {
-          py_tunein_proxy_.attr ("remove_current_url") ();
-        }
-      current_url_
-          = bp::extract< std::string > (py_tunein_proxy_.attr ("prev_url") ());
-      get_current_radio ();
-    }
-  catch (bp::error_already_set &e)
-    {
-      PyErr_PrintEx (0);
-    }
-  catch (...)
-    {
-    }
-  return current_url_.empty () ? NULL : current_url_.c_str ();
+  return move_queue ("prev_url", -1, a_remove_current_url);
+}
+
+void tiztunein::set_url_lookahead_ttl (const unsigned int seconds)
+{
+  pthread_mutex_lock (&md_mutex_);
+  la_ttl_ = seconds;
+  pthread_mutex_unlock (&md_mutex_);
 }
 
 const char *tiztunein::get_current_radio_name ()
 {
-  return current_radio_name_.empty () ? NULL : current_radio_name_.c_str ();
+  (void)publish_metadata (true);
+  return current_.name.empty () ? NULL : current_.name.c_str ();
 }
 
 const char *tiztunein::get_current_radio_description ()
 {
-  return current_radio_description_.empty ()
-             ? NULL
-             : current_radio_description_.c_str ();
+  (void)publish_metadata (true);
+  return current_.description.empty () ? NULL : current_.description.c_str ();
 }
 
 const char *tiztunein::get_current_radio_reliability ()
 {
-  return current_radio_reliability_.empty ()
-             ? NULL
-             : current_radio_reliability_.c_str ();
+  (void)publish_metadata (true);
+  return current_.reliability.empty () ? NULL : current_.reliability.c_str ();
 }
 
 const char *tiztunein::get_current_radio_type ()
 {
-  return current_radio_type_.empty () ? NULL : current_radio_type_.c_str ();
+  (void)publish_metadata (true);
+  return current_.type.empty () ? NULL : current_.type.c_str ();
 }
 
 const char *tiztunein::get_current_radio_website ()
@@ -264,13 +366,14 @@ const char *tiztunein::get_current_radio_website ()
 
 const char *tiztunein::get_current_radio_bitrate ()
 {
-  return current_radio_bitrate_.empty () ? NULL
-                                         : current_radio_bitrate_.c_str ();
+  (void)publish_metadata (true);
+  return current_.bitrate.empty () ? NULL : current_.bitrate.c_str ();
 }
 
 const char *tiztunein::get_current_radio_format ()
 {
-  return current_radio_format_.empty () ? NULL : current_radio_format_.c_str ();
+  (void)publish_metadata (true);
+  return current_.format.empty () ? NULL : current_.format.c_str ();
 }
 
 const char *tiztunein::get_current_radio_stream_url ()
@@ -280,32 +383,35 @@ const char *tiztunein::get_current_radio_stream_url ()
 
 const char *tiztunein::get_current_radio_thumbnail_url ()
 {
-  return current_radio_thumbnail_url_.empty ()
-             ? NULL
-             : current_radio_thumbnail_url_.c_str ();
+  (void)publish_metadata (true);
+  return current_.thumbnail_url.empty () ? NULL : current_.thumbnail_url.c_str ();
 }
 
 void tiztunein::clear_queue ()
 {
   int rc = 0;
   try_catch_wrapper (py_tunein_proxy_.attr ("clear_queue") ());
+  reset_url_lookahead (false);
   (void)rc;
 }
 
 const char *tiztunein::get_current_radio_index ()
 {
+  gil_lock gil;
   obtain_current_queue_progress ();
   return current_radio_index_.empty () ? NULL : current_radio_index_.c_str ();
 }
 
 const char *tiztunein::get_current_queue_length ()
 {
+  gil_lock gil;
   obtain_current_queue_progress ();
   return current_queue_length_.empty () ? NULL : current_queue_length_.c_str ();
 }
 
 int tiztunein::get_current_queue_length_as_int ()
 {
+  gil_lock gil;
   obtain_current_queue_progress ();
   if (current_queue_length_.empty ())
     {
@@ -317,6 +423,7 @@ int tiztunein::get_current_queue_length_as_int ()
 
 const char *tiztunein::get_current_queue_progress ()
 {
+  gil_lock gil;
   const bp::tuple &queue_info = bp::extract< bp::tuple > (
       py_tunein_proxy_.attr ("current_radio_queue_index_and_queue_length") ());
   const int queue_index = bp::extract< int > (queue_info[0]);
@@ -355,6 +462,7 @@ void tiztunein::set_playback_mode (const playback_mode mode)
         }
         break;
     };
+  reset_url_lookahead (false);
   (void)rc;
 }
 
@@ -389,31 +497,38 @@ void tiztunein::set_search_mode (const search_mode mode)
   (void)rc;
 }
 
-void tiztunein::get_current_radio ()
+void tiztunein::get_current_radio (radio_metadata &metadata)
 {
-  current_radio_name_.clear ();
-
-  obtain_current_queue_progress ();
+  const bp::tuple &queue_info = bp::extract< bp::tuple > (
+      py_tunein_proxy_.attr ("current_radio_queue_index_and_queue_length") ());
+  const int queue_index = bp::extract< int > (queue_info[0]);
+  const int queue_length = bp::extract< int > (queue_info[1]);
+  metadata.index.assign (boost::lexical_cast< std::string > (queue_index));
+  metadata.queue_length.assign (
+      boost::lexical_cast< std::string > (queue_length));
+  metadata.queue_progress.assign (metadata.index);
+  metadata.queue_progress.append (" of ");
+  metadata.queue_progress.append (metadata.queue_length);
 
-  current_radio_name_ = bp::extract< std::string > (
+  metadata.name = bp::extract< std::string > (
       py_tunein_proxy_.attr ("current_radio_name") ());
 
-  current_radio_description_ = bp::extract< std::string > (
+  metadata.description = bp::extract< std::string > (
       py_tunein_proxy_.attr ("current_radio_description") ());
 
-  current_radio_reliability_ = bp::extract< std::string > (
+  metadata.reliability = bp::extract< std::string > (
       py_tunein_proxy_.attr ("current_radio_reliability") ());
 
-  current_radio_type_ = bp::extract< std::string > (
+  metadata.type = bp::extract< std::string > (
       py_tunein_proxy_.attr ("current_radio_type") ());
 
-  current_radio_bitrate_ = bp::extract< std::string > (
+  metadata.bitrate = bp::extract< std::string > (
       py_tunein_proxy_.attr ("current_radio_bitrate") ());
 
-  current_radio_format_ = bp::extract< std::string > (
+  metadata.format = bp::extract< std::string > (
       py_tunein_proxy_.attr ("current_radio_formats") ());
 
-  current_radio_thumbnail_url_ = bp::extract< std::string > (
+  metadata.thumbnail_url = bp::extract< std::string > (
       py_tunein_proxy_.attr ("current_radio_thumbnail_url") ());
 }
 
@@ -431,3 +546,167 @@ void tiztunein::obtain_current_queue_progress ()
   current_queue_length_.assign (
       boost::lexical_cast< std::string > (queue_length));
 }
+
+void tiztunein::request_metadata_refresh ()
+{
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      ++md_requested_;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+    }
+  else
+    {
+      int rc = 0;
+      radio_metadata metadata;
+      try_catch_wrapper (get_current_radio (metadata));
+      (void)rc;
+      refreshed_ = metadata;
+      md_refreshed_ = ++md_requested_;
+    }
+}
+
+bool tiztunein::publish_metadata (const bool wait)
+{
+  bool ready = false;
+  pthread_mutex_lock (&md_mutex_);
+  while (wait && md_thread_running_ && md_refreshed_ != md_requested_)
+    {
+      pthread_cond_wait (&md_cond_, &md_mutex_);
+    }
+  ready = (md_refreshed_ == md_requested_);
+  if (ready && md_published_ != md_refreshed_)
+    {
+      current_ = refreshed_;
+      md_published_ = md_refreshed_;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+  return ready;
+}
+
+const tiztunein::radio_metadata *tiztunein::get_current_radio_metadata ()
+{
+  return publish_metadata (false) ? &current_ : NULL;
+}
+
+void tiztunein::refresh_metadata ()
+{
+  // Called with md_mutex_ held
+  const unsigned long request = md_requested_;
+  radio_metadata metadata;
+  int rc = 0;
+  pthread_mutex_unlock (&md_mutex_);
+  try_catch_wrapper (get_current_radio (metadata));
+  (void)rc;
+  pthread_mutex_lock (&md_mutex_);
+
+  // If the queue moved again in the meantime, this snapshot is stale and
+  // is simply discarded
+  if (request == md_requested_)
+    {
+      refreshed_ = metadata;
+      md_refreshed_ = request;
+      pthread_cond_broadcast (&md_cond_);
+    }
+}
+
+void tiztunein::reset_url_lookahead (const bool a_resolve)
+{
+  pthread_mutex_lock (&md_mutex_);
+  lookahead_next_ = resolved_url ();
+  lookahead_prev_ = resolved_url ();
+  ++la_requested_;
+  if (a_resolve && md_thread_running_ && la_ttl_ > 0)
+    {
+      pthread_cond_broadcast (&md_cond_);
+    }
+  else
+    {
+      la_resolved_ = la_requested_;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+}
+
+bool tiztunein::take_resolved_url (const int offset, int &position)
+{
+  bool found = false;
+  pthread_mutex_lock (&md_mutex_);
+  const resolved_url &resolved = offset > 0 ? lookahead_next_ : lookahead_prev_;
+  if (la_resolved_ == la_requested_ && resolved.position >= 0
+      && monotonic_seconds () < resolved.expiry)
+    {
+      position = resolved.position;
+      current_url_ = resolved.url;
+      found = true;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+  return found;
+}
+
+void tiztunein::resolve_urls ()
+{
+  // Called with md_mutex_ held
+  const unsigned long request = la_requested_;
+  resolved_url next;
+  resolved_url prev;
+  int rc = 0;
+  pthread_mutex_unlock (&md_mutex_);
+  try_catch_wrapper (resolve_url (1, next));
+  rc = 0;
+  try_catch_wrapper (resolve_url (-1, prev));
+  (void)rc;
+  pthread_mutex_lock (&md_mutex_);
+
+  // As with the metadata, the results are discarded if the queue changed in
+  // the meantime
+  if (request == la_requested_)
+    {
+      next.expiry = prev.expiry = monotonic_seconds () + la_ttl_;
+      lookahead_next_ = next;
+      lookahead_prev_ = prev;
+      la_resolved_ = request;
+    }
+}
+
+void tiztunein::resolve_url (const int offset, resolved_url &resolved)
+{
+  const bp::tuple &info = bp::extract< bp::tuple > (
+      py_tunein_proxy_.attr ("peek_url") (bp::object (offset)));
+  const std::string url = bp::extract< std::string > (info[1]);
+  if (!url.empty ())
+    {
+      resolved.position = bp::extract< int > (info[0]);
+      resolved.url = url;
+    }
+}
+
+void tiztunein::metadata_loop ()
+{
+  pthread_mutex_lock (&md_mutex_);
+  while (!md_thread_stop_)
+    {
+      if (md_refreshed_ != md_requested_)
+        {
+          // The metadata goes first; the component is waiting for it
+          refresh_metadata ();
+        }
+      else if (la_resolved_ != la_requested_)
+        {
+          resolve_urls ();
+        }
+      else
+        {
+          pthread_cond_wait (&md_cond_, &md_mutex_);
+        }
+    }
+  pthread_mutex_unlock (&md_mutex_);
+}
+
+void *tiztunein::metadata_thread_func (void *p_arg)
+{
+  tiztunein *p_this = static_cast< tiztunein * > (p_arg);
+  assert (p_this);
+  p_this->metadata_loop ();
+  return NULL;
+}
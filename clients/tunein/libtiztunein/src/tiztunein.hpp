@@ -31,6 +31,9 @@
 
 #include <boost/python.hpp>
 
+#include <pthread.h>
+#include <time.h>
+
 #include <string>
 
 class tiztunein
@@ -57,6 +60,24 @@ public:
     SearchModeMax
   };
 
+  /**
+   * The metadata of the radio station currently selected in the playback
+   * queue.
+   */
+  struct radio_metadata
+  {
+    std::string index;
+    std::string queue_length;
+    std::string queue_progress;
+    std::string name;
+    std::string description;
+    std::string reliability;
+    std::string type;
+    std::string bitrate;
+    std::string format;
+    std::string thumbnail_url;
+  };
+
 public:
   tiztunein ();
   ~tiztunein ();
@@ -74,6 +95,7 @@ public:
 
   void clear_queue ();
   void set_playback_mode (const playback_mode mode);
+  void set_url_lookahead_ttl (const unsigned int seconds);
   void set_search_mode (const search_mode mode);
 
   const char *get_current_radio_index ();
@@ -82,6 +104,9 @@ public:
   const char *get_current_queue_progress ();
   const char *get_next_url (const bool a_remove_current_url);
   const char *get_prev_url (const bool a_remove_current_url);
+
+  const radio_metadata *get_current_radio_metadata ();
+
   const char *get_current_radio_name ();
   const char *get_current_radio_description ();
   const char *get_current_radio_reliability ();
@@ -93,22 +118,55 @@ public:
   const char *get_current_radio_thumbnail_url ();
 
 private:
+  /**
+   * A url resolved ahead of time, and the queue position it belongs to.
+   */
+  struct resolved_url
+  {
+    resolved_url () : position (-1), url (), expiry (0)
+    {
+    }
+    int position;
+    std::string url;
+    time_t expiry;
+  };
+
+private:
+  const char *move_queue (const char *p_method, const int offset,
+                          const bool a_remove_current_url);
   void obtain_current_queue_progress ();
-  void get_current_radio ();
+  void get_current_radio (radio_metadata &metadata);
+  void request_metadata_refresh ();
+  bool publish_metadata (const bool wait);
+  void refresh_metadata ();
+  void reset_url_lookahead (const bool a_resolve);
+  bool take_resolved_url (const int offset, int &position);
+  void resolve_urls ();
+  void resolve_url (const int offset, resolved_url &resolved);
+  void metadata_loop ();
+  static void *metadata_thread_func (void *p_arg);
 
 private:
   std::string current_url_;
   std::string current_radio_index_;
   std::string current_queue_length_;
-  std::string current_radio_name_;
-  std::string current_radio_description_;
-  std::string current_radio_reliability_;
-  std::string current_radio_type_;
   std::string current_radio_website_;
-  std::string current_radio_bitrate_;
-  std::string current_radio_format_;
-  std::string current_radio_thumbnail_url_;
   std::string current_queue_progress_;
+  radio_metadata current_;
+  radio_metadata refreshed_;
+  pthread_t md_thread_;
+  pthread_mutex_t md_mutex_;
+  pthread_cond_t md_cond_;
+  bool md_thread_running_;
+  bool md_thread_stop_;
+  unsigned long md_requested_;
+  unsigned long md_refreshed_;
+  unsigned long md_published_;
+  resolved_url lookahead_next_;
+  resolved_url lookahead_prev_;
+  unsigned long la_requested_;
+  unsigned long la_resolved_;
+  unsigned int la_ttl_;
   boost::python::object py_main_;
   boost::python::object py_global_;
   boost::python::object py_tunein_proxy_;
@@ -107,6 +107,14 @@ extern "C" void tiz_tunein_set_playback_mode (
       static_cast< tiztunein::playback_mode > (mode));
 }
 
+extern "C" void tiz_tunein_set_url_lookahead_ttl (
+    tiz_tunein_t *ap_tunein, const unsigned int a_ttl_secs)
+{
+  assert (ap_tunein);
+  assert (ap_tunein->p_proxy_);
+  ap_tunein->p_proxy_->set_url_lookahead_ttl (a_ttl_secs);
+}
+
 extern "C" void tiz_tunein_set_search_mode (tiz_tunein_t *ap_tunein,
                                             const tiz_tunein_search_mode_t mode)
 {
@@ -210,6 +218,36 @@ extern "C" const char *tiz_tunein_get_prev_url (tiz_tunein_t *ap_tunein,
   return ap_tunein->p_proxy_->get_prev_url (a_remove_current_url);
 }
 
+static const char *metadata_item (const std::string &item)
+{
+  return item.empty () ? NULL : item.c_str ();
+}
+
+extern "C" int tiz_tunein_get_current_radio_metadata (
+    tiz_tunein_t *ap_tunein, tiz_tunein_metadata_t *ap_metadata)
+{
+  assert (ap_tunein);
+  assert (ap_tunein->p_proxy_);
+  assert (ap_metadata);
+  const tiztunein::radio_metadata *p_md
+      = ap_tunein->p_proxy_->get_current_radio_metadata ();
+  if (!p_md)
+    {
+      return 1;
+    }
+  ap_metadata->p_index = metadata_item (p_md->index);
+  ap_metadata->p_queue_length = metadata_item (p_md->queue_length);
+  ap_metadata->p_queue_progress = metadata_item (p_md->queue_progress);
+  ap_metadata->p_name = metadata_item (p_md->name);
+  ap_metadata->p_description = metadata_item (p_md->description);
+  ap_metadata->p_reliability = metadata_item (p_md->reliability);
+  ap_metadata->p_type = metadata_item (p_md->type);
+  ap_metadata->p_bitrate = metadata_item (p_md->bitrate);
+  ap_metadata->p_format = metadata_item (p_md->format);
+  ap_metadata->p_thumbnail_url = metadata_item (p_md->thumbnail_url);
+  return 0;
+}
+
 extern "C" const char *tiz_tunein_get_current_radio_name (
     tiz_tunein_t *ap_tunein)
 {
@@ -77,6 +77,25 @@ extern "C"
     ETIZTuneinSearchModeMax
   } tiz_tunein_search_mode_t;
 
+  /**
+   * A snapshot of the metadata of the radio station currently selected in the
+   * playback queue. Fields are NULL when the item is not available.
+   * @ingroup libtiztunein
+   */
+  typedef struct tiz_tunein_metadata
+  {
+    const char *p_index;
+    const char *p_queue_length;
+    const char *p_queue_progress;
+    const char *p_name;
+    const char *p_description;
+    const char *p_reliability;
+    const char *p_type;
+    const char *p_bitrate;
+    const char *p_format;
+    const char *p_thumbnail_url;
+  } tiz_tunein_metadata_t;
+
   /**
    * Initialize the tunein handle.
    *
@@ -100,6 +119,24 @@ extern "C"
   void tiz_tunein_set_playback_mode (tiz_tunein_t *ap_tunein,
                                      const tiz_tunein_playback_mode_t a_mode);
 
+  /**
+   * Set the time-to-live of the urls resolved in advance.
+   *
+   * After every move in the playback queue, the urls of the next and
+   * previous items are resolved in the background, so that the following
+   * call to tiz_tunein_get_next_url or tiz_tunein_get_prev_url can return
+   * without waiting for the service. Urls older than this are resolved again
+   * on demand.
+   *
+   * @ingroup libtiztunein
+   *
+   * @param ap_tunein The tunein handle.
+   * @param a_ttl_secs The time-to-live in seconds (default: 300). Zero
+   * disables the look-ahead.
+   */
+  void tiz_tunein_set_url_lookahead_ttl (tiz_tunein_t *ap_tunein,
+                                         const unsigned int a_ttl_secs);
+
   /**
    * Set the search mode.
    *
@@ -236,6 +273,25 @@ extern "C"
   const char *tiz_tunein_get_prev_url (tiz_tunein_t *ap_tunein,
                                        const bool a_remove_current_url);
 
+  /**
+   * Retrieve all the metadata of the current radio station in one go.
+   *
+   * The metadata is retrieved on a background thread every time the playback
+   * queue moves (see tiz_tunein_get_next_url and tiz_tunein_get_prev_url).
+   * This function does not call into the Python interpreter and never blocks.
+   *
+   * @ingroup libtiztunein
+   *
+   * @param ap_tunein The tunein handle.
+   * @param ap_metadata The snapshot to be filled in. The strings remain valid
+   * until the next call to any of the tiz_tunein_get_current_* functions.
+   *
+   * @return 0 on success, 1 if the metadata of the current radio station is
+   * still being retrieved (ap_metadata is not modified).
+   */
+  int tiz_tunein_get_current_radio_metadata (
+      tiz_tunein_t *ap_tunein, tiz_tunein_metadata_t *ap_metadata);
+
   /**
    * Retrieve the current station's name.
    *
@@ -858,6 +858,45 @@ class tiztuneinproxy(object):
             del self.queue[self.queue_index]
             return self.prev_url()
 
+    def peek_url(self, offset):
+        """ Resolve the url of a neighbour of the current station, without
+        moving the playback queue.
+
+        :param offset: 1 for the next station, -1 for the previous one.
+        :return: a (position, url) tuple, where position is the queue index
+        that next_url or prev_url would move to; (-1, "") if the url could not
+        be resolved.
+
+        """
+        logging.info("peek_url")
+        try:
+            if not len(self.queue):
+                return -1, ""
+            position = self.queue_index + offset
+            if position >= len(self.queue):
+                position = 0
+            elif position < 0:
+                position = len(self.queue) - 1
+            url = self._resolve_station_url(self.play_queue_order[position])
+            if not url:
+                return -1, ""
+            return position, url
+
+        except (KeyError, AttributeError, IOError):
+            logging.info("Could not resolve the url at offset %d", offset)
+            return -1, ""
+
+    def skip_to(self, position):
+        """ Move the playback queue to a position previously returned by
+        peek_url.
+
+        """
+        logging.info("skip_to")
+        self.queue_index = position
+        station = self.queue[self.play_queue_order[position]]
+        print_wrn("[TuneIn] Playing '{0}'.".format(station["text"]))
+        self.now_playing_radio = station
+
     def _enqueue_category(self,
                           category,
                           keywords1="",
@@ -1109,16 +1148,25 @@ class tiztuneinproxy(object):
             self._filter_play_queue("Podcast", remaining_keywords)
 
     def _retrieve_station_url(self, station_idx):
-        """ Retrieve a station url
+        """ Retrieve a station url, and make it the station now playing
 
         """
         logging.info("_retrieve_station_url")
+        station_url = self._resolve_station_url(station_idx)
+        station = self.queue[station_idx]
+        print_wrn("[TuneIn] Playing '{0}'.".format(station["text"]))
+        self.now_playing_radio = station
+        return station_url
+
+    def _resolve_station_url(self, station_idx):
+        """ Resolve the url of the station at a queue index
+
+        """
+        logging.info("_resolve_station_url")
         try:
             station = self.queue[station_idx]
             station_url = ""
-            name = station["text"]
             streamurls = self.tunein.tune(station)
-            print_wrn("[TuneIn] Playing '{0}'.".format(name))
             if len(streamurls) > 0:
                 urls = self.tunein.parse_stream_url(streamurls[0])
                 if len(urls) > 0:
@@ -1128,7 +1176,6 @@ class tiztuneinproxy(object):
             # Add the url key
             station["streamurl"] = station_url
             self.queue[station_idx] = station
-            self.now_playing_radio = station
             return station_url
 
         except AttributeError:
@@ -42,10 +42,36 @@
 
 namespace bp = boost::python;
 
+namespace
+{
+  // Holds the Python interpreter lock for as long as the object is alive.
+  // The interpreter is accessed from the component's thread and from the
+  // metadata refresh thread.
+  class gil_lock
+  {
+  public:
+    gil_lock () : state_ (PyGILState_Ensure ())
+    {
+    }
+    ~gil_lock ()
+    {
+      PyGILState_Release (state_);
+    }
+
+  private:
+    gil_lock (const gil_lock &);
+    gil_lock &operator= (const gil_lock &);
+
+  private:
+    PyGILState_STATE state_;
+  };
+}  // namespace
+
 /* This macro assumes the existence of an "int rc" local variable */
 #define try_catch_wrapper(expr)                                  \
   do                                                             \
     {                                                            \
+      gil_lock gil;                                              \
       try                                                        \
         {                                                        \
           if (!rc)                                               \
@@ -76,8 +102,18 @@ namespace
   int check_deps ()
   {
     int rc = 1;
-    Py_Initialize ();
+    if (!Py_IsInitialized ())
+      {
+        Py_Initialize ();
+#if PY_VERSION_HEX < 0x03070000
+        PyEval_InitThreads ();
+#endif
+        // Release the lock acquired by the initialisation; from now on it is
+        // taken by whichever thread needs the interpreter.
+        (void)PyEval_SaveThread ();
+      }
 
+    gil_lock gil;
     try
       {
         // Import Tizonia YouTube proxy module
@@ -88,28 +124,28 @@ namespace
 
         // Check the existence of the 'pafy' module
         bp::object ignored = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('pafy')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
 
         // Check the existence of the 'youtube_dl' module
         bp::object ignored2 = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('youtube_dl')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
 
         // Check the existence of the 'joblib' module
         bp::object ignored3 = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('joblib')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
 
         // Check the existence of the 'fuzzywuzzy' module
         bp::object ignored4 = exec (
-            "import importlib\n"
+            "import importlib.util\n"
             "spec = importlib.util.find_spec('fuzzywuzzy')\n"
             "if not spec:\n raise ValueError\n",
             py_global);
@@ -147,29 +183,44 @@ namespace
     bp::object pyyoutubeproxy = py_global["tizyoutubeproxy"];
     py_yt_proxy = pyyoutubeproxy (api_key.c_str ());
   }
+
+  // Urls resolved in advance are discarded after this many seconds
+  const unsigned int default_url_lookahead_ttl = 300;
+
+  time_t monotonic_seconds ()
+  {
+    struct timespec now;
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    return now.tv_sec;
+  }
 }  // namespace
 
 tizyoutube::tizyoutube (const std::string &api_key)
   : api_key_ (api_key),
     current_url_ (),
-    current_stream_index_ (),
-    current_queue_length_ (),
-    current_stream_title_ (),
-    current_stream_author_ (),
-    current_stream_file_size_ (),
-    current_stream_duration_ (),
-    current_stream_bitrate_ (),
-    current_stream_view_count_ (),
-    current_stream_description_ (),
-    current_stream_file_extension_ (),
-    current_stream_video_id_ (),
-    current_stream_published_ (),
-    current_queue_progress_ ()
-{
+    current_ (),
+    refreshed_ (),
+    md_thread_ (),
+    md_thread_running_ (false),
+    md_thread_stop_ (false),
+    md_requested_ (0),
+    md_refreshed_ (0),
+    md_published_ (0),
+    lookahead_next_ (),
+    lookahead_prev_ (),
+    la_requested_ (0),
+    la_resolved_ (0),
+    la_ttl_ (default_url_lookahead_ttl)
+{
+  pthread_mutex_init (&md_mutex_, NULL);
+  pthread_cond_init (&md_cond_, NULL);
 }
 
 tizyoutube::~tizyoutube ()
 {
+  stop ();
+  pthread_cond_destroy (&md_cond_);
+  pthread_mutex_destroy (&md_mutex_);
 }
 
 int tizyoutube::init ()
@@ -186,19 +237,42 @@ int tizyoutube::start ()
 {
   int rc = 0;
   try_catch_wrapper (start_youtube (py_global_, py_yt_proxy_, api_key_));
+  if (!rc && !md_thread_running_)
+    {
+      md_thread_stop_ = false;
+      // If the thread can't be created, the metadata is refreshed
+      // synchronously instead (see request_metadata_refresh).
+      md_thread_running_
+          = (0 == pthread_create (&md_thread_, NULL,
+                                  &tizyoutube::metadata_thread_func, this));
+    }
   return rc;
 }
 
 void tizyoutube::stop ()
 {
-  int rc = 0;
-  // try_catch_wrapper (py_yt_proxy_.attr ("logout")());
-  (void)rc;
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      md_thread_stop_ = true;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+      pthread_join (md_thread_, NULL);
+      md_thread_running_ = false;
+    }
 }
 
 void tizyoutube::deinit ()
 {
-  // boost::python doesn't support Py_Finalize() yet!
+  // boost::python doesn't support Py_Finalize() yet! But the references held
+  // here need to be released while holding the interpreter lock.
+  if (Py_IsInitialized ())
+    {
+      gil_lock gil;
+      py_yt_proxy_ = bp::object ();
+      py_global_ = bp::object ();
+      py_main_ = bp::object ();
+    }
 }
 
 int tizyoutube::play_audio_stream (const std::string &url_or_id)
@@ -206,6 +280,7 @@ int tizyoutube::play_audio_stream (const std::string &url_or_id)
   int rc = 0;
   try_catch_wrapper (
       py_yt_proxy_.attr ("enqueue_audio_stream") (bp::object (url_or_id)));
+  reset_url_lookahead (false);
   return rc;
 }
 
@@ -214,6 +289,7 @@ int tizyoutube::play_audio_playlist (const std::string &url_or_id)
   int rc = 0;
   try_catch_wrapper (
       py_yt_proxy_.attr ("enqueue_audio_playlist") (bp::object (url_or_id)));
+  reset_url_lookahead (false);
   return rc;
 }
 
@@ -222,6 +298,7 @@ int tizyoutube::play_audio_mix (const std::string &url_or_id)
   int rc = 0;
   try_catch_wrapper (
       py_yt_proxy_.attr ("enqueue_audio_mix") (bp::object (url_or_id)));
+  reset_url_lookahead (false);
   return rc;
 }
 
@@ -230,6 +307,7 @@ int tizyoutube::play_audio_search (const std::string &search)
   int rc = 0;
   try_catch_wrapper (
       py_yt_proxy_.attr ("enqueue_audio_search") (bp::object (search)));
+  reset_url_lookahead (false);
   return rc;
 }
 
@@ -238,6 +316,7 @@ int tizyoutube::play_audio_mix_search (const std::string &search)
   int rc = 0;
   try_catch_wrapper (
       py_yt_proxy_.attr ("enqueue_audio_mix_search") (bp::object (search)));
+  reset_url_lookahead (false);
   return rc;
 }
 
@@ -246,6 +325,7 @@ int tizyoutube::play_audio_channel_uploads (const std::string &channel)
   int rc = 0;
   try_catch_wrapper (py_yt_proxy_.attr ("enqueue_audio_channel_uploads") (
       bp::object (channel)));
+  reset_url_lookahead (false);
   return rc;
 }
 
@@ -269,78 +349,92 @@ int tizyoutube::play_audio_channel_playlist (
       try_catch_wrapper (py_yt_proxy_.attr ("enqueue_audio_channel_playlist") (
           bp::object (channel), bp::object (playlist)));
     }
+  reset_url_lookahead (false);
   return rc;
 }
 
-const char *tizyoutube::get_next_url (const bool a_remove_current_url)
+const char *tizyoutube::move_queue (const char *p_method, const int offset,
+                                    const bool a_remove_current_url)
 {
+  int rc = 0;
+  int position = -1;
   current_url_.clear ();
-  try
+  if (a_remove_current_url)
     {
-      if (a_remove_current_url)
+      // This shifts the queue positions, so the urls resolved in advance
+      // can't be used
+      try_catch_wrapper (py_yt_proxy_.attr ("remove_current_url") ());
+      rc = 0;
+    }
+  else if (take_resolved_url (offset, position))
+    {
+      // The proxy only needs to update its queue position
+      try_catch_wrapper (py_yt_proxy_.attr ("skip_to") (bp::object (position)));
+      if (rc)
         {
-          py_yt_proxy_.attr ("remove_current_url") ();
+          current_url_.clear ();
+          rc = 0;
         }
-      current_url_
-          = bp::extract< std::string > (py_yt_proxy_.attr ("next_url") ());
-      get_current_stream ();
     }
-  catch (bp::error_already_set &e)
+
+  if (current_url_.empty ())
     {
-      PyErr_PrintEx (0);
+      try_catch_wrapper (current_url_ = bp::extract< std::string > (
+                             py_yt_proxy_.attr (p_method) ()));
     }
-  catch (...)
+  (void)rc;
+
+  if (!current_url_.empty ())
     {
+      // The queue has moved; the new item's metadata and the urls of its
+      // neighbours are retrieved in the background
+      request_metadata_refresh ();
     }
+  reset_url_lookahead (!current_url_.empty ());
   return current_url_.empty () ? NULL : current_url_.c_str ();
 }
 
+const char *tizyoutube::get_next_url (const bool a_remove_current_url)
+{
+  return move_queue ("next_url", 1, a_remove_current_url);
+}
+
 const char *tizyoutube::get_prev_url (const bool a_remove_current_url)
 {
-  current_url_.clear ();
-  try
-    {
-      if (a_remove_current_url)
-        {
-          py_yt_proxy_.attr ("remove_current_url") ();
-        }
-      current_url_
-          = bp::extract< std::string > (py_yt_proxy_.attr ("prev_url") ());
-      get_current_stream ();
-    }
-  catch (bp::error_already_set &e)
-    {
-      PyErr_PrintEx (0);
-    }
-  catch (...)
-    {
-    }
-  return current_url_.empty () ? NULL : current_url_.c_str ();
+  return move_queue ("prev_url", -1, a_remove_current_url);
+}
+
+void tizyoutube::set_url_lookahead_ttl (const unsigned int seconds)
+{
+  pthread_mutex_lock (&md_mutex_);
+  la_ttl_ = seconds;
+  pthread_mutex_unlock (&md_mutex_);
 }
 
 void tizyoutube::clear_queue ()
 {
   int rc = 0;
   try_catch_wrapper (py_yt_proxy_.attr ("clear_queue") ());
+  reset_url_lookahead (false);
   (void)rc;
 }
 
 const char *tizyoutube::get_current_audio_stream_index ()
 {
-  return current_stream_index_.empty () ? NULL : current_stream_index_.c_str ();
+  (void)publish_metadata (true);
+  return current_.index.empty () ? NULL : current_.index.c_str ();
 }
 
 const char *tizyoutube::get_current_queue_length ()
 {
-  return current_queue_length_.empty () ? NULL : current_queue_length_.c_str ();
+  (void)publish_metadata (true);
+  return current_.queue_length.empty () ? NULL : current_.queue_length.c_str ();
 }
 
 const char *tizyoutube::get_current_queue_progress ()
 {
-  current_queue_progress_.assign (get_current_audio_stream_index ());
-  current_queue_progress_.append (" of ");
-  current_queue_progress_.append (get_current_queue_length ());
-  return current_queue_progress_.c_str ();
+  (void)publish_metadata (true);
+  return current_.queue_progress.empty () ? NULL : current_.queue_progress.c_str ();
 }
 
 void tizyoutube::set_playback_mode (const playback_mode mode)
@@ -364,108 +458,95 @@ void tizyoutube::set_playback_mode (const playback_mode mode)
         }
         break;
     };
+  reset_url_lookahead (false);
   (void)rc;
 }
 
 const char *tizyoutube::get_current_audio_stream_title ()
 {
-  return current_stream_title_.empty () ? NULL : current_stream_title_.c_str ();
+  (void)publish_metadata (true);
+  return current_.title.empty () ? NULL : current_.title.c_str ();
 }
 
 const char *tizyoutube::get_current_audio_stream_author ()
 {
-  return current_stream_author_.empty () ? NULL
-                                         : current_stream_author_.c_str ();
+  (void)publish_metadata (true);
+  return current_.author.empty () ? NULL : current_.author.c_str ();
 }
 
 const char *tizyoutube::get_current_audio_stream_file_size ()
 {
-  return current_stream_file_size_.empty ()
-             ? NULL
-             : current_stream_file_size_.c_str ();
+  (void)publish_metadata (true);
+  return current_.file_size.empty () ? NULL : current_.file_size.c_str ();
 }
 
 const char *tizyoutube::get_current_audio_stream_duration ()
 {
-  return current_stream_duration_.empty () ? NULL
-                                           : current_stream_duration_.c_str ();
+  (void)publish_metadata (true);
+  return current_.duration.empty () ? NULL : current_.duration.c_str ();
 }
 
 const char *tizyoutube::get_current_audio_stream_bitrate ()
 {
-  return current_stream_bitrate_.empty () ? NULL
-                                          : current_stream_bitrate_.c_str ();
+  (void)publish_metadata (true);
+  return current_.bitrate.empty () ? NULL : current_.bitrate.c_str ();
 }
 
 const char *tizyoutube::get_current_audio_stream_view_count ()
 {
-  return current_stream_view_count_.empty ()
-             ? NULL
-             : current_stream_view_count_.c_str ();
+  (void)publish_metadata (true);
+  return current_.view_count.empty () ? NULL : current_.view_count.c_str ();
 }
 
 const char *tizyoutube::get_current_audio_stream_description ()
 {
-  return current_stream_description_.empty ()
-             ? NULL
-             : current_stream_description_.c_str ();
+  (void)publish_metadata (true);
+  return current_.description.empty () ? NULL : current_.description.c_str ();
 }
 
 const char *tizyoutube::get_current_audio_stream_file_extension ()
 {
-  return current_stream_file_extension_.empty ()
-             ? NULL
-             : current_stream_file_extension_.c_str ();
+  (void)publish_metadata (true);
+  return current_.file_extension.empty () ? NULL : current_.file_extension.c_str ();
 }
 
 const char *tizyoutube::get_current_audio_stream_video_id ()
 {
-  return current_stream_video_id_.empty () ? NULL
-                                           : current_stream_video_id_.c_str ();
+  (void)publish_metadata (true);
+  return current_.video_id.empty () ? NULL : current_.video_id.c_str ();
 }
 
 const char *tizyoutube::get_current_audio_stream_published ()
 {
-  return current_stream_published_.empty ()
-             ? NULL
-             : current_stream_published_.c_str ();
+  (void)publish_metadata (true);
+  return current_.published.empty () ? NULL : current_.published.c_str ();
 }
 
-void tizyoutube::get_current_stream ()
+void tizyoutube::get_current_stream (stream_metadata &metadata)
 {
-  current_stream_index_.clear ();
-  current_queue_length_.clear ();
-  current_stream_title_.clear ();
-  current_stream_author_.clear ();
-  current_stream_file_size_.clear ();
-  current_stream_duration_.clear ();
-  current_stream_bitrate_.clear ();
-  current_stream_view_count_.clear ();
-  current_stream_description_.clear ();
-  current_stream_file_extension_.clear ();
-  current_stream_video_id_.clear ();
-  current_stream_published_.clear ();
-
   const bp::tuple &queue_info = bp::extract< bp::tuple > (py_yt_proxy_.attr (
       "current_audio_stream_queue_index_and_queue_length") ());
   const int queue_index = bp::extract< int > (queue_info[0]);
   const int queue_length = bp::extract< int > (queue_info[1]);
-  current_stream_index_.assign (
+  metadata.index.assign (
       boost::lexical_cast< std::string > (queue_index));
-  current_queue_length_.assign (
+  metadata.queue_length.assign (
       boost::lexical_cast< std::string > (queue_length));
+  metadata.queue_progress.assign (metadata.index);
+  metadata.queue_progress.append (" of ");
+  metadata.queue_progress.append (metadata.queue_length);
 
-  current_stream_title_ = bp::extract< std::string > (
+  metadata.title = bp::extract< std::string > (
       py_yt_proxy_.attr ("current_audio_stream_title") ());
 
-  current_stream_author_ = bp::extract< std::string > (
+  metadata.author = bp::extract< std::string > (
       py_yt_proxy_.attr ("current_audio_stream_author") ());
 
   const int file_size = bp::extract< int > (
       py_yt_proxy_.attr ("current_audio_stream_file_size") ());
-  current_stream_file_size_.assign (
+  metadata.file_size.assign (
       boost::lexical_cast< std::string > (file_size / (1024 * 1024)));
-  current_stream_file_size_.append (" MiB");
+  metadata.file_size.append (" MiB");
 
   std::string duration = bp::extract< std::string > (
       py_yt_proxy_.attr ("current_audio_stream_duration") ());
@@ -504,43 +585,208 @@ void tizyoutube::get_current_stream ()
 
       for (size_t i = 0; i < num_non_empty; ++i)
         {
-          current_stream_duration_ = strs[i] + current_stream_duration_;
+          metadata.duration = strs[i] + metadata.duration;
           if ((num_non_empty - 1) != i)
             {
-              current_stream_duration_ = ":" + current_stream_duration_;
+              metadata.duration = ":" + metadata.duration;
             }
         }
     }
 
-  current_stream_bitrate_ = bp::extract< std::string > (
+  metadata.bitrate = bp::extract< std::string > (
       py_yt_proxy_.attr ("current_audio_stream_bitrate") ());
 
   const int view_count = bp::extract< int > (
       py_yt_proxy_.attr ("current_audio_stream_view_count") ());
-  current_stream_view_count_.assign (
+  metadata.view_count.assign (
       boost::lexical_cast< std::string > (view_count));
 
   std::string description = bp::extract< std::string > (
       py_yt_proxy_.attr ("current_audio_stream_description") ());
   if (description.length ())
     {
-      current_stream_description_ = description;
-      current_stream_description_.erase (
-          std::remove (current_stream_description_.begin (),
-                       current_stream_description_.end (), '\n'),
-          current_stream_description_.end ());
-      current_stream_description_.erase (
-          std::remove (current_stream_description_.begin (),
-                       current_stream_description_.end (), '\r'),
-          current_stream_description_.end ());
+      metadata.description = description;
+      metadata.description.erase (
+          std::remove (metadata.description.begin (),
+                       metadata.description.end (), '\n'),
+          metadata.description.end ());
+      metadata.description.erase (
+          std::remove (metadata.description.begin (),
+                       metadata.description.end (), '\r'),
+          metadata.description.end ());
     }
 
-  current_stream_file_extension_ = bp::extract< std::string > (
+  metadata.file_extension = bp::extract< std::string > (
       py_yt_proxy_.attr ("current_audio_stream_file_extension") ());
 
-  current_stream_video_id_ = bp::extract< std::string > (
+  metadata.video_id = bp::extract< std::string > (
       py_yt_proxy_.attr ("current_audio_stream_video_id") ());
 
-  current_stream_published_ = bp::extract< std::string > (
+  metadata.published = bp::extract< std::string > (
       py_yt_proxy_.attr ("current_audio_stream_published") ());
 }
+
+void tizyoutube::request_metadata_refresh ()
+{
+  if (md_thread_running_)
+    {
+      pthread_mutex_lock (&md_mutex_);
+      ++md_requested_;
+      pthread_cond_broadcast (&md_cond_);
+      pthread_mutex_unlock (&md_mutex_);
+    }
+  else
+    {
+      int rc = 0;
+      stream_metadata metadata;
+      try_catch_wrapper (get_current_stream (metadata));
+      (void)rc;
+      refreshed_ = metadata;
+      md_refreshed_ = ++md_requested_;
+    }
+}
+
+bool tizyoutube::publish_metadata (const bool wait)
+{
+  bool ready = false;
+  pthread_mutex_lock (&md_mutex_);
+  while (wait && md_thread_running_ && md_refreshed_ != md_requested_)
+    {
+      pthread_cond_wait (&md_cond_, &md_mutex_);
+    }
+  ready = (md_refreshed_ == md_requested_);
+  if (ready && md_published_ != md_refreshed_)
+    {
+      current_ = refreshed_;
+      md_published_ = md_refreshed_;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+  return ready;
+}
+
+const tizyoutube::stream_metadata *
+tizyoutube::get_current_audio_stream_metadata ()
+{
+  return publish_metadata (false) ? &current_ : NULL;
+}
+
+void tizyoutube::refresh_metadata ()
+{
+  // Called with md_mutex_ held
+  const unsigned long request = md_requested_;
+  stream_metadata metadata;
+  int rc = 0;
+  pthread_mutex_unlock (&md_mutex_);
+  try_catch_wrapper (get_current_stream (metadata));
+  (void)rc;
+  pthread_mutex_lock (&md_mutex_);
+
+  // If the queue moved again in the meantime, this snapshot is stale and
+  // is simply discarded
+  if (request == md_requested_)
+    {
+      refreshed_ = metadata;
+      md_refreshed_ = request;
+      pthread_cond_broadcast (&md_cond_);
+    }
+}
+
+void tizyoutube::reset_url_lookahead (const bool a_resolve)
+{
+  pthread_mutex_lock (&md_mutex_);
+  lookahead_next_ = resolved_url ();
+  lookahead_prev_ = resolved_url ();
+  ++la_requested_;
+  if (a_resolve && md_thread_running_ && la_ttl_ > 0)
+    {
+      pthread_cond_broadcast (&md_cond_);
+    }
+  else
+    {
+      la_resolved_ = la_requested_;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+}
+
+bool tizyoutube::take_resolved_url (const int offset, int &position)
+{
+  bool found = false;
+  pthread_mutex_lock (&md_mutex_);
+  const resolved_url &resolved = offset > 0 ? lookahead_next_ : lookahead_prev_;
+  if (la_resolved_ == la_requested_ && resolved.position >= 0
+      && monotonic_seconds () < resolved.expiry)
+    {
+      position = resolved.position;
+      current_url_ = resolved.url;
+      found = true;
+    }
+  pthread_mutex_unlock (&md_mutex_);
+  return found;
+}
+
+void tizyoutube::resolve_urls ()
+{
+  // Called with md_mutex_ held
+  const unsigned long request = la_requested_;
+  resolved_url next;
+  resolved_url prev;
+  int rc = 0;
+  pthread_mutex_unlock (&md_mutex_);
+  try_catch_wrapper (resolve_url (1, next));
+  rc = 0;
+  try_catch_wrapper (resolve_url (-1, prev));
+  (void)rc;
+  pthread_mutex_lock (&md_mutex_);
+
+  // As with the metadata, the results are discarded if the queue changed in
+  // the meantime
+  if (request == la_requested_)
+    {
+      next.expiry = prev.expiry = monotonic_seconds () + la_ttl_;
+      lookahead_next_ = next;
+      lookahead_prev_ = prev;
+      la_resolved_ = request;
+    }
+}
+
+void tizyoutube::resolve_url (const int offset, resolved_url &resolved)
+{
+  const bp::tuple &info = bp::extract< bp::tuple > (
+      py_yt_proxy_.attr ("peek_url") (bp::object (offset)));
+  const std::string url = bp::extract< std::string > (info[1]);
+  if (!url.empty ())
+    {
+      resolved.position = bp::extract< int > (info[0]);
+      resolved.url = url;
+    }
+}
+
+void tizyoutube::metadata_loop ()
+{
+  pthread_mutex_lock (&md_mutex_);
+  while (!md_thread_stop_)
+    {
+      if (md_refreshed_ != md_requested_)
+        {
+          // The metadata goes first; the component is waiting for it
+          refresh_metadata ();
+        }
+      else if (la_resolved_ != la_requested_)
+        {
+          resolve_urls ();
+        }
+      else
+        {
+          pthread_cond_wait (&md_cond_, &md_mutex_);
+        }
+    }
+  pthread_mutex_unlock (&md_mutex_);
+}
+
+void *tizyoutube::metadata_thread_func (void *p_arg)
+{
+  tizyoutube *p_yt = static_cast< tizyoutube * > (p_arg);
+  assert (p_yt);
+  p_yt->metadata_loop ();
+  return NULL;
+}
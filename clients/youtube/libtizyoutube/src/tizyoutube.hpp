@@ -32,6 +32,9 @@
 
 #include <boost/python.hpp>
 
+#include <pthread.h>
+#include <time.h>
+
 #include <string>
 
 class tizyoutube
@@ -47,6 +50,26 @@ public:
     PlaybackModeMax
   };
 
+  /**
+   * The metadata of the stream currently selected in the playback queue.
+   */
+  struct stream_metadata
+  {
+    std::string index;
+    std::string queue_length;
+    std::string queue_progress;
+    std::string title;
+    std::string author;
+    std::string file_size;
+    std::string duration;
+    std::string bitrate;
+    std::string view_count;
+    std::string description;
+    std::string file_extension;
+    std::string video_id;
+    std::string published;
+  };
+
 public:
   tizyoutube (const std::string &api_key);
   ~tizyoutube ();
@@ -65,6 +88,7 @@ public:
   int play_audio_channel_playlist (const std::string &channel_and_playlist);
 
   void set_playback_mode (const playback_mode mode);
+  void set_url_lookahead_ttl (const unsigned int seconds);
   void clear_queue ();
   const char *get_current_audio_stream_index ();
   const char *get_current_queue_length ();
@@ -73,6 +97,8 @@ public:
   const char *get_next_url (const bool a_remove_current_url);
   const char *get_prev_url (const bool a_remove_current_url);
 
+  const stream_metadata *get_current_audio_stream_metadata ();
+
   const char *get_current_audio_stream_title ();
   const char *get_current_audio_stream_author ();
   const char *get_current_audio_stream_file_size ();
@@ -85,24 +111,51 @@ public:
   const char *get_current_audio_stream_published ();
 
 private:
-  void get_current_stream ();
+  /**
+   * A url resolved ahead of time, and the queue position it belongs to.
+   */
+  struct resolved_url
+  {
+    resolved_url () : position (-1), url (), expiry (0)
+    {
+    }
+    int position;
+    std::string url;
+    time_t expiry;
+  };
+
+private:
+  const char *move_queue (const char *p_method, const int offset,
+                          const bool a_remove_current_url);
+  void get_current_stream (stream_metadata &metadata);
+  void request_metadata_refresh ();
+  bool publish_metadata (const bool wait);
+  void refresh_metadata ();
+  void reset_url_lookahead (const bool a_resolve);
+  bool take_resolved_url (const int offset, int &position);
+  void resolve_urls ();
+  void resolve_url (const int offset, resolved_url &resolved);
+  void metadata_loop ();
+  static void *metadata_thread_func (void *p_arg);
 
 private:
   std::string api_key_;
   std::string current_url_;
-  std::string current_stream_index_;
-  std::string current_queue_length_;
-  std::string current_stream_title_;
-  std::string current_stream_author_;
-  std::string current_stream_file_size_;
-  std::string current_stream_duration_;
-  std::string current_stream_bitrate_;
-  std::string current_stream_view_count_;
-  std::string current_stream_description_;
-  std::string current_stream_file_extension_;
-  std::string current_stream_video_id_;
-  std::string current_stream_published_;
-  std::string current_queue_progress_;
+  stream_metadata current_;
+  stream_metadata refreshed_;
+  pthread_t md_thread_;
+  pthread_mutex_t md_mutex_;
+  pthread_cond_t md_cond_;
+  bool md_thread_running_;
+  bool md_thread_stop_;
+  unsigned long md_requested_;
+  unsigned long md_refreshed_;
+  unsigned long md_published_;
+  resolved_url lookahead_next_;
+  resolved_url lookahead_prev_;
+  unsigned long la_requested_;
+  unsigned long la_resolved_;
+  unsigned int la_ttl_;
   boost::python::object py_main_;
   boost::python::object py_global_;
   boost::python::object py_yt_proxy_;
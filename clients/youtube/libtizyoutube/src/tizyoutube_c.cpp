@@ -142,6 +142,14 @@ extern "C" void tiz_youtube_set_playback_mode (
       static_cast< tizyoutube::playback_mode > (mode));
 }
 
+extern "C" void tiz_youtube_set_url_lookahead_ttl (
+    tiz_youtube_t *ap_youtube, const unsigned int a_ttl_secs)
+{
+  assert (ap_youtube);
+  assert (ap_youtube->p_proxy_);
+  ap_youtube->p_proxy_->set_url_lookahead_ttl (a_ttl_secs);
+}
+
 extern "C" int tiz_youtube_play_audio_stream (tiz_youtube_t *ap_youtube,
                                               const char *ap_url_or_id)
 {
@@ -215,6 +223,39 @@ extern "C" const char *tiz_youtube_get_prev_url (
   return ap_youtube->p_proxy_->get_prev_url (a_remove_current_url);
 }
 
+static const char *metadata_item (const std::string &item)
+{
+  return item.empty () ? NULL : item.c_str ();
+}
+
+extern "C" int tiz_youtube_get_current_audio_stream_metadata (
+    tiz_youtube_t *ap_youtube, tiz_youtube_metadata_t *ap_metadata)
+{
+  assert (ap_youtube);
+  assert (ap_youtube->p_proxy_);
+  assert (ap_metadata);
+  const tizyoutube::stream_metadata *p_md
+      = ap_youtube->p_proxy_->get_current_audio_stream_metadata ();
+  if (!p_md)
+    {
+      return 1;
+    }
+  ap_metadata->p_index = metadata_item (p_md->index);
+  ap_metadata->p_queue_length = metadata_item (p_md->queue_length);
+  ap_metadata->p_queue_progress = metadata_item (p_md->queue_progress);
+  ap_metadata->p_title = metadata_item (p_md->title);
+  ap_metadata->p_author = metadata_item (p_md->author);
+  ap_metadata->p_file_size = metadata_item (p_md->file_size);
+  ap_metadata->p_duration = metadata_item (p_md->duration);
+  ap_metadata->p_bitrate = metadata_item (p_md->bitrate);
+  ap_metadata->p_view_count = metadata_item (p_md->view_count);
+  ap_metadata->p_description = metadata_item (p_md->description);
+  ap_metadata->p_file_extension = metadata_item (p_md->file_extension);
+  ap_metadata->p_video_id = metadata_item (p_md->video_id);
+  ap_metadata->p_published = metadata_item (p_md->published);
+  return 0;
+}
+
 extern "C" const char *tiz_youtube_get_current_audio_stream_title (
     tiz_youtube_t *ap_youtube)
 {
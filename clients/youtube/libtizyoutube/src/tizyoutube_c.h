@@ -64,6 +64,28 @@ extern "C"
     ETIZYoutubePlaybackModeMax
   } tiz_youtube_playback_mode_t;
 
+  /**
+   * A snapshot of the metadata of the audio stream currently selected in the
+   * playback queue. Fields are NULL when the item is not available.
+   * @ingroup libtizyoutube
+   */
+  typedef struct tiz_youtube_metadata
+  {
+    const char *p_index;
+    const char *p_queue_length;
+    const char *p_queue_progress;
+    const char *p_title;
+    const char *p_author;
+    const char *p_file_size;
+    const char *p_duration;
+    const char *p_bitrate;
+    const char *p_view_count;
+    const char *p_description;
+    const char *p_file_extension;
+    const char *p_video_id;
+    const char *p_published;
+  } tiz_youtube_metadata_t;
+
   /**
    * Initialize the tiz_youtube handle.
    *
@@ -126,6 +148,24 @@ extern "C"
   void tiz_youtube_set_playback_mode (tiz_youtube_t *ap_youtube,
                                       const tiz_youtube_playback_mode_t mode);
 
+  /**
+   * Set the time-to-live of the urls resolved in advance.
+   *
+   * After every move in the playback queue, the urls of the next and
+   * previous items are resolved in the background, so that the following
+   * call to tiz_youtube_get_next_url or tiz_youtube_get_prev_url can return
+   * without waiting for the service. Urls older than this are resolved again
+   * on demand.
+   *
+   * @ingroup libtizyoutube
+   *
+   * @param ap_youtube The youtube handle.
+   * @param a_ttl_secs The time-to-live in seconds (default: 300). Zero
+   * disables the look-ahead.
+   */
+  void tiz_youtube_set_url_lookahead_ttl (tiz_youtube_t *ap_youtube,
+                                          const unsigned int a_ttl_secs);
+
   /**
    * Add a YouTube audio stream to the playback queue.
    *
@@ -277,6 +317,25 @@ extern "C"
   const char *tiz_youtube_get_prev_url (tiz_youtube_t *ap_youtube,
                                         const bool a_remove_current_url);
 
+  /**
+   * Retrieve all the metadata of the current audio stream in one go.
+   *
+   * The metadata is retrieved on a background thread every time the playback
+   * queue moves (see tiz_youtube_get_next_url and tiz_youtube_get_prev_url).
+   * This function does not call into the Python interpreter and never blocks.
+   *
+   * @ingroup libtizyoutube
+   *
+   * @param ap_youtube The tiz_youtube handle.
+   * @param ap_metadata The snapshot to be filled in. The strings remain valid
+   * until the next call to any of the tiz_youtube_get_current_* functions.
+   *
+   * @return 0 on success, 1 if the current stream's metadata is still being
+   * retrieved (ap_metadata is not modified).
+   */
+  int tiz_youtube_get_current_audio_stream_metadata (
+      tiz_youtube_t *ap_youtube, tiz_youtube_metadata_t *ap_metadata);
+
   /**
    * Retrieve the current audio stream's title.
    *
@@ -36,9 +36,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <tizplatform.h>
 
 #include "tizyoutube_c.h"
 
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.youtube.check"
+#endif
+
 #define YOUTUBE_TEST_TIMEOUT 2500
 
 #define CMD_LEN 1000
@@ -118,10 +127,144 @@ static void play_track (const char *p_next_url)
   ck_assert (-1 != system (cmd));
 }
 
+static double now_ms (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* Runs against the network-free proxy in the 'stub' directory. Each of the
+   stub's metadata accessors sleeps for TIZ_YOUTUBE_STUB_DELAY_MS. */
+START_TEST (test_youtube_metadata_snapshot)
+{
+  tiz_youtube_t *p_youtube = NULL;
+  tiz_youtube_metadata_t md;
+  double start = 0, sync_ms = 0, snapshot_ms = 0;
+  int rc = 0;
+  int i = 0;
+
+  setenv ("PYTHONPATH", TIZ_YOUTUBE_STUB_DIR, 1);
+  setenv ("TIZ_YOUTUBE_STUB_DELAY_MS", "1", 1);
+
+  rc = tiz_youtube_init (&p_youtube, NULL);
+  ck_assert (0 == rc);
+  ck_assert (p_youtube != NULL);
+
+  rc = tiz_youtube_play_audio_search (p_youtube, YOUTUBE_SEARCH_TERM);
+  ck_assert (0 == rc);
+
+  for (i = 0; i < 10; ++i)
+    {
+      const char *next_url = NULL;
+
+      /* Per-item getters: these wait for the refresh to complete */
+      start = now_ms ();
+      next_url = tiz_youtube_get_next_url (p_youtube, false);
+      ck_assert (next_url != NULL);
+      ck_assert (tiz_youtube_get_current_audio_stream_title (p_youtube));
+      ck_assert (tiz_youtube_get_current_audio_stream_author (p_youtube));
+      ck_assert (tiz_youtube_get_current_queue_progress (p_youtube));
+      ck_assert (tiz_youtube_get_current_audio_stream_video_id (p_youtube));
+      ck_assert (tiz_youtube_get_current_audio_stream_duration (p_youtube));
+      ck_assert (
+          tiz_youtube_get_current_audio_stream_file_extension (p_youtube));
+      ck_assert (tiz_youtube_get_current_audio_stream_bitrate (p_youtube));
+      ck_assert (tiz_youtube_get_current_audio_stream_file_size (p_youtube));
+      ck_assert (tiz_youtube_get_current_audio_stream_view_count (p_youtube));
+      ck_assert (tiz_youtube_get_current_audio_stream_description (p_youtube));
+      ck_assert (tiz_youtube_get_current_audio_stream_published (p_youtube));
+      sync_ms += now_ms () - start;
+
+      /* Snapshot: returns straight away; poll until the refresh is done */
+      start = now_ms ();
+      next_url = tiz_youtube_get_next_url (p_youtube, false);
+      ck_assert (next_url != NULL);
+      rc = tiz_youtube_get_current_audio_stream_metadata (p_youtube, &md);
+      snapshot_ms += now_ms () - start;
+      while (0 != rc)
+        {
+          usleep (1000);
+          rc = tiz_youtube_get_current_audio_stream_metadata (p_youtube, &md);
+        }
+      ck_assert (md.p_title && md.p_author && md.p_queue_progress);
+      ck_assert (md.p_video_id && strstr (next_url, md.p_video_id));
+      ck_assert (NULL == strchr (md.p_description, '\n'));
+    }
+
+  TIZ_LOG (TIZ_PRIORITY_NOTICE,
+           "per-item getters [%.3f ms/track] - snapshot [%.3f ms/track]",
+           sync_ms / i, snapshot_ms / i);
+
+  tiz_youtube_destroy (p_youtube);
+}
+END_TEST
+
+/* Runs against the stub proxy, where resolving a url takes
+   TIZ_YOUTUBE_STUB_URL_DELAY_MS. */
+START_TEST (test_youtube_url_lookahead)
+{
+  tiz_youtube_t *p_youtube = NULL;
+  const char *url = NULL;
+  double start = 0;
+  int rc = 0;
+
+  setenv ("PYTHONPATH", TIZ_YOUTUBE_STUB_DIR, 1);
+  setenv ("TIZ_YOUTUBE_STUB_DELAY_MS", "0", 1);
+  setenv ("TIZ_YOUTUBE_STUB_URL_DELAY_MS", "100", 1);
+
+  rc = tiz_youtube_init (&p_youtube, NULL);
+  ck_assert (0 == rc);
+  ck_assert (p_youtube != NULL);
+
+  rc = tiz_youtube_play_audio_search (p_youtube, YOUTUBE_SEARCH_TERM);
+  ck_assert (0 == rc);
+
+  /* Nothing has been resolved in advance yet */
+  start = now_ms ();
+  url = tiz_youtube_get_next_url (p_youtube, false);
+  ck_assert (url && strstr (url, "stub00"));
+  ck_assert (now_ms () - start >= 100);
+
+  /* Both neighbours are resolved in the background */
+  usleep (500000);
+  start = now_ms ();
+  url = tiz_youtube_get_next_url (p_youtube, false);
+  ck_assert (now_ms () - start < 50);
+  ck_assert (url && strstr (url, "stub01"));
+
+  usleep (500000);
+  start = now_ms ();
+  url = tiz_youtube_get_prev_url (p_youtube, false);
+  ck_assert (now_ms () - start < 50);
+  ck_assert (url && strstr (url, "stub00"));
+
+  /* Expired urls are resolved again */
+  tiz_youtube_set_url_lookahead_ttl (p_youtube, 1);
+  (void) tiz_youtube_get_next_url (p_youtube, false);
+  usleep (1500000);
+  start = now_ms ();
+  url = tiz_youtube_get_next_url (p_youtube, false);
+  ck_assert (now_ms () - start >= 100);
+  ck_assert (url && strstr (url, "stub02"));
+
+  /* No look-ahead */
+  tiz_youtube_set_url_lookahead_ttl (p_youtube, 0);
+  (void) tiz_youtube_get_next_url (p_youtube, false);
+  usleep (500000);
+  start = now_ms ();
+  url = tiz_youtube_get_next_url (p_youtube, false);
+  ck_assert (now_ms () - start >= 100);
+  ck_assert (url && strstr (url, "stub04"));
+
+  tiz_youtube_destroy (p_youtube);
+}
+END_TEST
+
 START_TEST (test_youtube_play_audio_stream)
 {
   tiz_youtube_t *p_youtube = NULL;
-  int rc = tiz_youtube_init (&p_youtube);
+  int rc = tiz_youtube_init (&p_youtube, NULL);
   ck_assert (0 == rc);
   ck_assert (p_youtube != NULL);
 
@@ -144,7 +287,7 @@ END_TEST
 START_TEST (test_youtube_play_audio_playlist)
 {
   tiz_youtube_t *p_youtube = NULL;
-  int rc = tiz_youtube_init (&p_youtube);
+  int rc = tiz_youtube_init (&p_youtube, NULL);
   int i = 0;
   ck_assert (0 == rc);
   ck_assert (p_youtube != NULL);
@@ -170,7 +313,7 @@ END_TEST
 START_TEST (test_youtube_play_audio_search)
 {
   tiz_youtube_t *p_youtube = NULL;
-  int rc = tiz_youtube_init (&p_youtube);
+  int rc = tiz_youtube_init (&p_youtube, NULL);
   int i = 0;
   ck_assert (0 == rc);
   ck_assert (p_youtube != NULL);
@@ -201,6 +344,8 @@ Suite *youtube_suite (void)
   /* test case */
   tc_youtube = tcase_create ("YouTube audio client lib unit tests");
   tcase_set_timeout (tc_youtube, YOUTUBE_TEST_TIMEOUT);
+  tcase_add_test (tc_youtube, test_youtube_metadata_snapshot);
+  tcase_add_test (tc_youtube, test_youtube_url_lookahead);
   tcase_add_test (tc_youtube, test_youtube_play_audio_stream);
   tcase_add_test (tc_youtube, test_youtube_play_audio_playlist);
   tcase_add_test (tc_youtube, test_youtube_play_audio_search);
@@ -213,10 +358,12 @@ int main (void)
 {
   int number_failed = 1;
   SRunner *sr = srunner_create (youtube_suite ());
+  tiz_log_init ();
   srunner_set_log (sr, "-");
   srunner_run_all (sr, CK_VERBOSE);
   number_failed = srunner_ntests_failed (sr);
   srunner_free (sr);
+  tiz_log_deinit ();
   return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
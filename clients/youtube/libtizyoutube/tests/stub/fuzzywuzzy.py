@@ -0,0 +1 @@
+# Empty stand-in module; see tizyoutubeproxy.py
@@ -0,0 +1,130 @@
+# Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+#
+# This file is part of Tizonia
+#
+# Tizonia is free software: you can redistribute it and/or modify it under the
+# terms of the GNU Lesser General Public License as published by the Free
+# Software Foundation, either version 3 of the License, or (at your option)
+# any later version.
+#
+# Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+# more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Network-free stand-in for the YouTube proxy, used by libtizyoutube's
+unit tests. Each metadata accessor takes TIZ_YOUTUBE_STUB_DELAY_MS
+milliseconds, to mimic the cost of the real accessors (e.g. the file size,
+which pafy obtains with an HTTP request). Resolving a url takes
+TIZ_YOUTUBE_STUB_URL_DELAY_MS milliseconds.
+
+"""
+
+import os
+import time
+
+DELAY = float(os.environ.get("TIZ_YOUTUBE_STUB_DELAY_MS", "0")) / 1000.0
+URL_DELAY = float(os.environ.get("TIZ_YOUTUBE_STUB_URL_DELAY_MS",
+                                 "0")) / 1000.0
+
+
+def _delay():
+    if DELAY > 0:
+        time.sleep(DELAY)
+
+
+def _url_delay():
+    if URL_DELAY > 0:
+        time.sleep(URL_DELAY)
+
+
+class tizyoutubeproxy(object):
+    """A fixed playback queue of ten streams."""
+
+    def __init__(self, api_key=""):
+        self.queue = ["stub%02d" % i for i in range(10)]
+        self.queue_index = -1
+
+    def set_play_mode(self, mode):
+        pass
+
+    def enqueue_audio_stream(self, arg):
+        pass
+
+    def enqueue_audio_playlist(self, arg):
+        pass
+
+    def enqueue_audio_search(self, arg):
+        pass
+
+    def clear_queue(self):
+        self.queue_index = -1
+
+    def remove_current_url(self):
+        pass
+
+    def _url(self, position):
+        _url_delay()
+        return "http://localhost/%s.webm" % self.queue[position]
+
+    def next_url(self):
+        self.queue_index = (self.queue_index + 1) % len(self.queue)
+        return self._url(self.queue_index)
+
+    def prev_url(self):
+        self.queue_index = (self.queue_index - 1) % len(self.queue)
+        return self._url(self.queue_index)
+
+    def peek_url(self, offset):
+        position = (self.queue_index + offset) % len(self.queue)
+        return position, self._url(position)
+
+    def skip_to(self, position):
+        self.queue_index = position
+
+    def current_audio_stream_queue_index_and_queue_length(self):
+        _delay()
+        return self.queue_index + 1, len(self.queue)
+
+    def current_audio_stream_title(self):
+        _delay()
+        return "Title %s" % self.queue[self.queue_index]
+
+    def current_audio_stream_author(self):
+        _delay()
+        return "Author"
+
+    def current_audio_stream_file_size(self):
+        _delay()
+        return 4 * 1024 * 1024
+
+    def current_audio_stream_duration(self):
+        _delay()
+        return "00:03:25"
+
+    def current_audio_stream_bitrate(self):
+        _delay()
+        return "160k"
+
+    def current_audio_stream_view_count(self):
+        _delay()
+        return 1000
+
+    def current_audio_stream_description(self):
+        _delay()
+        return "Description\nof the stream"
+
+    def current_audio_stream_file_extension(self):
+        _delay()
+        return "webm"
+
+    def current_audio_stream_video_id(self):
+        _delay()
+        return self.queue[self.queue_index]
+
+    def current_audio_stream_published(self):
+        _delay()
+        return "2020-01-01 00:00:00"
@@ -871,6 +871,40 @@ class tizyoutubeproxy(object):
             logging.info("IOError exception")
             return self.next_url()
 
+    def peek_url(self, offset):
+        """ Resolve the url of a neighbour of the current stream, without
+        moving the playback queue.
+
+        :param offset: 1 for the next stream, -1 for the previous one.
+        :return: a (position, url) tuple, where position is the queue index
+        that next_url or prev_url would move to; (-1, "") if the url could not
+        be resolved.
+
+        """
+        logging.info("")
+        try:
+            if not len(self.queue):
+                return -1, ""
+            position = self.queue_index + offset
+            if position >= len(self.queue):
+                position = 0
+            elif position < 0:
+                position = len(self.queue) - 1
+            url = self._resolve_stream_url(self.play_queue_order[position])
+            return position, url.rstrip()
+        except (KeyError, AttributeError, IOError):
+            logging.info("Could not resolve the url at offset %d", offset)
+            return -1, ""
+
+    def skip_to(self, position):
+        """ Move the playback queue to a position previously returned by
+        peek_url.
+
+        """
+        logging.info("")
+        self.queue_index = position
+        self.now_playing_stream = self.queue[self.play_queue_order[position]]
+
     def _update_play_queue_order(self):
         """ Update the queue playback order.
 
@@ -889,7 +923,15 @@ class tizyoutubeproxy(object):
                 "[YouTube] [Streams in queue] '{0}'.".format(total_streams))
 
     def _retrieve_stream_url(self, stream, queue_index):
-        """ Retrieve a stream url
+        """ Retrieve a stream url, and make it the stream now playing
+
+        """
+        url = self._resolve_stream_url(queue_index)
+        self.now_playing_stream = self.queue[queue_index]
+        return url
+
+    def _resolve_stream_url(self, queue_index):
+        """ Resolve the url of the stream at a queue index
 
         """
         try:
@@ -921,7 +963,6 @@ class tizyoutubeproxy(object):
             # pprint.pprint(streams)
             # dump_stream_info(streams)
 
-            self.now_playing_stream = stream
             return stream["a"].url
 
         except AttributeError:
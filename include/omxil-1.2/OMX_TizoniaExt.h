@@ -124,6 +124,15 @@
 #define OMX_TizoniaIndexParamStreamingBuffer \
   OMX_IndexVendorStartUnused                 \
     + 24 /**< reference: OMX_TIZONIA_STREAMINGBUFFERTYPE */
+#define OMX_TizoniaIndexConfigAudioPcmBuffering \
+  OMX_IndexVendorStartUnused                    \
+    + 25 /**< reference: OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE */
+#define OMX_TizoniaIndexConfigAudioPcmDelay \
+  OMX_IndexVendorStartUnused                \
+    + 26 /**< reference: OMX_TIZONIA_AUDIO_CONFIG_PCMDELAYTYPE */
+#define OMX_TizoniaIndexParamBufferInPlaceMode \
+  OMX_IndexVendorStartUnused                   \
+    + 27 /**< reference: OMX_TIZONIA_PARAM_BUFFER_INPLACEMODETYPE */
 
 /**
  * OMX_AUDIO_CODINGTYPE extensions
@@ -162,6 +171,28 @@ typedef struct OMX_TIZONIA_PARAM_BUFFER_PREANNOUNCEMENTSMODETYPE
   OMX_BOOL bEnabled;
 } OMX_TIZONIA_PARAM_BUFFER_PREANNOUNCEMENTSMODETYPE;
 
+/**
+ * The name of the in-place buffer processing mode extension.
+ */
+#define OMX_TIZONIA_INDEX_PARAM_BUFFER_INPLACEMODE \
+  "OMX.Tizonia.index.param.inplacemode"
+
+/**
+ * In-place buffer processing on an input port. When enabled, the component
+ * may read the data directly from the buffers it receives, holding on to
+ * each buffer until all of its data has been consumed, instead of copying
+ * the data into an internal store first. Disabled by default. Components
+ * that don't support this mode ignore it. The new value takes effect on the
+ * next Idle->Executing transition or port enablement.
+ */
+typedef struct OMX_TIZONIA_PARAM_BUFFER_INPLACEMODETYPE
+{
+  OMX_U32 nSize;
+  OMX_VERSIONTYPE nVersion;
+  OMX_U32 nPortIndex;
+  OMX_BOOL bEnabled;
+} OMX_TIZONIA_PARAM_BUFFER_INPLACEMODETYPE;
+
 /**
  * Extension to jump to another track in a playlist.
  */
@@ -189,6 +220,42 @@ typedef struct OMX_TIZONIA_STREAMINGBUFFERTYPE
     nHighWaterMark; /**< A percentage of the total capacity, in the range 0-100. */
 } OMX_TIZONIA_STREAMINGBUFFERTYPE;
 
+/**
+ * PCM renderer device buffering. The new values are applied the next time
+ * the audio device is prepared (i.e. Idle->Executing transition or port
+ * re-enablement). They can only be set in OMX_StateLoaded or while the port
+ * is disabled.
+ */
+typedef struct OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE
+{
+  OMX_U32 nSize;
+  OMX_VERSIONTYPE nVersion;
+  OMX_U32 nPortIndex;
+  OMX_U32 nPeriodSize;  /**< Period size, in frames. 0 selects the component's
+                           default latency. */
+  OMX_U32 nPeriodCount; /**< Number of periods in the device buffer. 0 selects
+                           the component's default latency. */
+  OMX_BOOL bMmapAccess; /**< Write samples directly into the device's DMA
+                           area, when the device supports it. */
+} OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE;
+
+/**
+ * PCM renderer device delay (read-only).
+ */
+typedef struct OMX_TIZONIA_AUDIO_CONFIG_PCMDELAYTYPE
+{
+  OMX_U32 nSize;
+  OMX_VERSIONTYPE nVersion;
+  OMX_U32 nPortIndex;
+  OMX_U32 nDelay;       /**< Frames written to the device that have not been
+                           played yet. */
+  OMX_U32 nDelayUs;     /**< Same as nDelay, in microseconds. */
+  OMX_U32 nPeriodSize;  /**< Period size negotiated with the device, in
+                           frames. */
+  OMX_U32 nBufferSize;  /**< Buffer size negotiated with the device, in
+                           frames. */
+} OMX_TIZONIA_AUDIO_CONFIG_PCMDELAYTYPE;
+
 /**
  * Icecast-like audio renderer components
  */
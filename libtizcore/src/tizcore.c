@@ -739,7 +739,7 @@ find_component_paths (unsigned long * ap_npaths)
   int i = 0;
   assert (ap_npaths);
 
-  val_lst = tiz_rcfile_get_value_list ("il-core", "component-paths", ap_npaths);
+  val_lst = tiz_rcfile_get_value_list ("ilcore", "component-paths", ap_npaths);
 
   if (!val_lst || 0 == *ap_npaths)
     {
@@ -253,6 +253,7 @@ static void *
 krn_ctor (void * ap_obj, va_list * app)
 {
   tiz_krn_t * p_obj = super_ctor (typeOf (ap_obj, "tizkrn"), ap_obj, app);
+  tiz_srv_set_queue_key_func (p_obj, &krn_msg_keys);
   tiz_check_omx_ret_null (init_ports_and_lists (p_obj));
   return p_obj;
 }
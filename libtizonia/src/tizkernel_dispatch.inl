@@ -78,14 +78,14 @@ static OMX_ERRORTYPE dispatch_port_disable (
        * kernel's servant queue into the corresponding port ingress list. This
        * guarantees that all buffers received by the component on this port are
        * correctly returned during port stop */
-      tiz_srv_remove_from_queue (ap_obj, &process_efb_from_servant_queue, i,
-                                 p_obj);
+      tiz_srv_remove_from_queue_by_port (
+        ap_obj, &process_efb_from_servant_queue, i, p_obj);
       /* This will move this port's processor callbacks currently queued in the
        * kernel's servant queue into the corresponding port egress list. This
        * guarantees that all buffers held by the component on this port are
        * correctly returned during port stop */
-      tiz_srv_remove_from_queue (ap_obj, &process_cbacks_from_servant_queue, i,
-                                 p_obj);
+      tiz_srv_remove_from_queue_by_port (
+        ap_obj, &process_cbacks_from_servant_queue, i, p_obj);
 
       if (TIZ_PORT_IS_TUNNELED_AND_SUPPLIER (p_port))
         {
@@ -132,7 +132,7 @@ static OMX_ERRORTYPE dispatch_port_disable (
                                  "HEADER [%p] BUFFER [%p]...",
                                  pid, nhdrs, *pp_hdr, (*pp_hdr)->pBuffer);
 
-                      tiz_srv_remove_from_queue (
+                      tiz_srv_remove_from_queue_by_hdr (
                           ap_obj, &remove_buffer_from_servant_queue,
                           ETIZKrnMsgCallback, *pp_hdr);
 
@@ -375,15 +375,15 @@ static OMX_ERRORTYPE dispatch_port_flush (void *ap_obj, OMX_HANDLETYPE ap_hdl,
            * guarantees that all buffers received by the component on this port
            * are
            * correctly returned during port flush */
-          tiz_srv_remove_from_queue (ap_obj, &process_efb_from_servant_queue, i,
-                                     p_obj);
+          tiz_srv_remove_from_queue_by_port (
+            ap_obj, &process_efb_from_servant_queue, i, p_obj);
 
           /* This will move this port's processor callbacks currently queued in
            * the kernel's servant queue into the corresponding port egress
            * list. This guarantees that all buffers held by the component on
            * this port are correctly returned during port flush */
-          tiz_srv_remove_from_queue (ap_obj, &process_cbacks_from_servant_queue,
-                                     i, p_obj);
+          tiz_srv_remove_from_queue_by_port (
+            ap_obj, &process_cbacks_from_servant_queue, i, p_obj);
 
           if (TIZ_PORT_IS_TUNNELED_AND_SUPPLIER (p_port))
             {
@@ -699,9 +699,9 @@ static OMX_ERRORTYPE depopulate_port (tiz_krn_t *ap_krn, OMX_PTR ap_port,
                          "HEADER [%p]...",
                          a_pid, nhdrs, *pp_hdr);
 
-              tiz_srv_remove_from_queue (ap_krn,
-                                         &remove_buffer_from_servant_queue,
-                                         ETIZKrnMsgCallback, *pp_hdr);
+              tiz_srv_remove_from_queue_by_hdr (
+                ap_krn, &remove_buffer_from_servant_queue, ETIZKrnMsgCallback,
+                *pp_hdr);
 
               /* NOTE : 2nd and 3rd parameters are dummy ones, the
                * processor servant implementation of
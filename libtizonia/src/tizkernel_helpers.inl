@@ -832,6 +832,37 @@ static OMX_ERRORTYPE complete_ongoing_transitions (const void *ap_obj,
   return rc;
 }
 
+static void krn_msg_keys (void *ap_data, OMX_S32 *ap_port, void **app_hdr)
+{
+  tiz_krn_msg_t *p_msg = ap_data;
+
+  assert (ap_data);
+  assert (ap_port);
+  assert (app_hdr);
+
+  /* Index buffer-related messages by port and header, so that flushes and
+   * port disables only visit the messages they are going to remove */
+  switch (p_msg->class)
+    {
+      case ETIZKrnMsgEmptyThisBuffer:
+        *ap_port = (OMX_S32)p_msg->ef.p_hdr->nInputPortIndex;
+        *app_hdr = p_msg->ef.p_hdr;
+        break;
+      case ETIZKrnMsgFillThisBuffer:
+        *ap_port = (OMX_S32)p_msg->ef.p_hdr->nOutputPortIndex;
+        *app_hdr = p_msg->ef.p_hdr;
+        break;
+      case ETIZKrnMsgCallback:
+        *ap_port = (OMX_S32)p_msg->cb.pid;
+        *app_hdr = p_msg->cb.p_hdr;
+        break;
+      default:
+        *ap_port = -1;
+        *app_hdr = NULL;
+        break;
+    };
+}
+
 static OMX_BOOL remove_buffer_from_servant_queue (OMX_PTR ap_elem,
                                                   OMX_S32 a_data1,
                                                   OMX_PTR ap_data2)
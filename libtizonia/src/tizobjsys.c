@@ -31,6 +31,8 @@
 #endif
 
 #include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
 #include <string.h>
 
 #include <tizplatform.h>
@@ -86,12 +88,12 @@
 #define TIZ_LOG_CATEGORY_NAME "tiz.tizonia.objsys"
 #endif
 
-struct tiz_os
-{
-  tiz_map_t * p_map;
-  OMX_HANDLETYPE p_hdl;
-  tiz_soa_t * p_soa;
-};
+/* The number of buckets in the process-wide type name index (a power of
+   two, comfortably larger than the number of built-in types) */
+#define TIZ_OS_NAME_INDEX_SIZE 256
+
+/* Alignment of the class objects cloned into a handle's base type block */
+#define TIZ_OS_CLONE_ALIGN 16
 
 typedef enum tiz_os_type tiz_os_type_t;
 enum tiz_os_type
@@ -180,10 +182,55 @@ enum tiz_os_type
   ETIZDemuxercfgport,
   ETIZMp4port_class,
   ETIZMp4port,
+  ETIZTypeMax
 };
 
 #define TIZ_OS_BASE_TYPE_END ETIZConfigport
 
+/* A type registered by the component itself (e.g. its processor class) */
+typedef struct tiz_os_comp_type tiz_os_comp_type_t;
+struct tiz_os_comp_type
+{
+  char * p_name;
+  void * p_obj;
+};
+
+struct tiz_os
+{
+  /* The built-in types, indexed by type id */
+  void ** pp_types;
+  /* The memory block holding the built-in types cloned from the
+     process-wide templates, if any */
+  OMX_U8 * p_base_block;
+  size_t base_block_size;
+  tiz_vector_t * p_comp_types;
+  OMX_HANDLETYPE p_hdl;
+  tiz_soa_t * p_soa;
+};
+
+/* A process-wide copy of a built-in class object, as produced by its type
+   init function. Class objects only differ between handles in their class,
+   super class, object system and handle pointers, so a handle gets its own
+   copy by cloning the template and re-pointing those four fields. */
+typedef struct tiz_os_template tiz_os_template_t;
+struct tiz_os_template
+{
+  void * p_obj;
+  size_t size;
+  OMX_S32 class_id;
+  OMX_S32 super_id;
+  /* Offset within a handle's base type block */
+  size_t offset;
+};
+
+static tiz_os_template_t g_templates[ETIZTypeMax];
+static size_t g_base_block_size = 0;
+static bool g_base_templates_ready = false;
+static pthread_mutex_t g_templates_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static OMX_S32 g_name_index[TIZ_OS_NAME_INDEX_SIZE];
+static pthread_once_t g_name_index_once = PTHREAD_ONCE_INIT;
+
 static const tiz_os_type_init_f tiz_os_type_to_fnt_tbl[] = {
   tiz_class_init,
   tiz_object_init,
@@ -399,30 +446,98 @@ os_strndup (tiz_soa_t * p_soa, const char * s, size_t n)
   return (char *) memcpy (result, s, len);
 }
 
-static OMX_S32
-os_map_compare_func (OMX_PTR ap_key1, OMX_PTR ap_key2)
+static OMX_U32
+hash_type_name (const char * ap_name)
 {
-  return strncmp ((const char *) ap_key1, (const char *) ap_key2,
-                  OMX_MAX_STRINGNAME_SIZE);
+  /* FNV-1a */
+  OMX_U32 hash = 2166136261u;
+  assert (ap_name);
+  while (*ap_name)
+    {
+      hash ^= (OMX_U8) *ap_name++;
+      hash *= 16777619u;
+    }
+  return hash;
 }
 
 static void
-os_map_free_func (OMX_PTR ap_key, OMX_PTR ap_value)
+init_name_index (void)
+{
+  OMX_S32 type_id = 0;
+
+  assert (sizeof (tiz_os_type_to_str_tbl) / sizeof (tiz_os_type_str_t)
+          == ETIZTypeMax);
+  assert (ETIZTypeMax < TIZ_OS_NAME_INDEX_SIZE);
+
+  for (type_id = 0; type_id < TIZ_OS_NAME_INDEX_SIZE; ++type_id)
+    {
+      g_name_index[type_id] = -1;
+    }
+
+  for (type_id = 0; type_id < ETIZTypeMax; ++type_id)
+    {
+      OMX_U32 bucket
+        = hash_type_name (tiz_os_type_to_str_tbl[type_id].str)
+          & (TIZ_OS_NAME_INDEX_SIZE - 1);
+      assert (tiz_os_type_to_str_tbl[type_id].type == type_id);
+      while (g_name_index[bucket] >= 0)
+        {
+          bucket = (bucket + 1) & (TIZ_OS_NAME_INDEX_SIZE - 1);
+        }
+      g_name_index[bucket] = type_id;
+    }
+}
+
+/* Returns the id of a built-in type, or -1 if the name is unknown */
+static OMX_S32
+find_type_id (const char * ap_name)
 {
-  /* Don't bother deleting the keys here as they are allocated from the chunk
-       of memory provided by the small object allocator, which gets released when
-       the component is deinited. */
-  tiz_mem_free (ap_value);
+  OMX_U32 bucket = 0;
+
+  (void) pthread_once (&g_name_index_once, init_name_index);
+
+  bucket = hash_type_name (ap_name) & (TIZ_OS_NAME_INDEX_SIZE - 1);
+  while (g_name_index[bucket] >= 0)
+    {
+      const OMX_S32 type_id = g_name_index[bucket];
+      if (0 == strcmp (ap_name, tiz_os_type_to_str_tbl[type_id].str))
+        {
+          return type_id;
+        }
+      bucket = (bucket + 1) & (TIZ_OS_NAME_INDEX_SIZE - 1);
+    }
+  return -1;
 }
 
-#ifdef _DEBUG
 static OMX_S32
-print_function (OMX_PTR ap_key, OMX_PTR ap_value, OMX_PTR ap_arg)
+find_type_id_by_obj (const tiz_os_t * ap_os, const void * ap_obj)
 {
-  const char * name = ap_key;
-  tiz_os_t * p_os = ap_arg;
-  TIZ_TRACE (p_os->p_hdl, "type [%s]->[%p]", name, ap_value);
-  return 0;
+  OMX_S32 type_id = 0;
+  assert (ap_os);
+  for (type_id = 0; type_id < ETIZTypeMax; ++type_id)
+    {
+      if (ap_os->pp_types[type_id] == ap_obj)
+        {
+          return type_id;
+        }
+    }
+  return -1;
+}
+
+static inline bool
+in_base_block (const tiz_os_t * ap_os, const void * ap_obj)
+{
+  assert (ap_os);
+  return (ap_os->p_base_block && (const OMX_U8 *) ap_obj >= ap_os->p_base_block
+          && (const OMX_U8 *) ap_obj
+               < ap_os->p_base_block + ap_os->base_block_size);
+}
+
+#ifdef _DEBUG
+static void
+print_type (const tiz_os_t * ap_os, const char * ap_name, const void * ap_obj)
+{
+  TIZ_TRACE (ap_os->p_hdl, "type [%s]->[%p]", ap_name, ap_obj);
 }
 #endif
 
@@ -430,71 +545,331 @@ static void
 print_types (const tiz_os_t * ap_os)
 {
 #ifdef _DEBUG
+  OMX_S32 i = 0;
   assert (ap_os);
-  assert (ap_os->p_map);
-  tiz_map_for_each (ap_os->p_map, print_function, (tiz_os_t *) ap_os);
+  for (i = 0; i < ETIZTypeMax; ++i)
+    {
+      if (ap_os->pp_types[i])
+        {
+          print_type (ap_os, tiz_os_type_to_str_tbl[i].str, ap_os->pp_types[i]);
+        }
+    }
+  for (i = 0; i < tiz_vector_length (ap_os->p_comp_types); ++i)
+    {
+      const tiz_os_comp_type_t * p_type
+        = tiz_vector_at (ap_os->p_comp_types, i);
+      print_type (ap_os, p_type->p_name, p_type->p_obj);
+    }
 #endif
 }
 
+/* Keeps a process-wide copy of a built-in class object that has just been
+   built by its init function. Called with g_templates_mutex held. */
+static void
+capture_template (const tiz_os_t * ap_os, const OMX_S32 a_type_id)
+{
+  const tiz_class_t * p_obj = NULL;
+  tiz_os_template_t * p_tmpl = NULL;
+  const void * const * p_word = NULL;
+  const void * const * p_end = NULL;
+  size_t size = 0;
+  OMX_S32 class_id = -1;
+  OMX_S32 super_id = -1;
+
+  assert (ap_os);
+  assert (a_type_id >= 0 && a_type_id < ETIZTypeMax);
+
+  p_obj = ap_os->pp_types[a_type_id];
+  p_tmpl = &(g_templates[a_type_id]);
+  if (!p_obj || p_tmpl->p_obj)
+    {
+      return;
+    }
+
+  size = sizeOf (p_obj);
+  class_id = find_type_id_by_obj (ap_os, classOf (p_obj));
+  super_id = find_type_id_by_obj (ap_os, p_obj->super);
+  if (class_id < 0 || super_id < 0)
+    {
+      return;
+    }
+
+  /* Everything past the class header is expected to be method pointers; a
+     class holding references to other per-handle objects can't be cloned,
+     and is left to be built by its init function every time */
+  p_word = (const void * const *) ((const OMX_U8 *) p_obj
+                                   + offsetof (tiz_class_t, ctor));
+  p_end = (const void * const *) ((const OMX_U8 *) p_obj + size);
+  for (; p_word < p_end; ++p_word)
+    {
+      if (*p_word
+          && (*p_word == ap_os || *p_word == ap_os->p_hdl
+              || find_type_id_by_obj (ap_os, *p_word) >= 0))
+        {
+          TIZ_TRACE (ap_os->p_hdl, "[%s] can't be shared",
+                     tiz_os_type_to_str_tbl[a_type_id].str);
+          return;
+        }
+    }
+
+  if ((p_tmpl->p_obj = tiz_mem_alloc (size)))
+    {
+      memcpy (p_tmpl->p_obj, p_obj, size);
+      p_tmpl->size = size;
+      p_tmpl->class_id = class_id;
+      p_tmpl->super_id = super_id;
+    }
+}
+
+static void
+capture_base_templates (const tiz_os_t * ap_os)
+{
+  OMX_S32 type_id = 0;
+  size_t offset = 0;
+  bool ready = true;
+
+  assert (ap_os);
+
+  pthread_mutex_lock (&g_templates_mutex);
+  if (!g_base_templates_ready)
+    {
+      for (type_id = 0; type_id <= TIZ_OS_BASE_TYPE_END; ++type_id)
+        {
+          capture_template (ap_os, type_id);
+          if (!g_templates[type_id].p_obj)
+            {
+              ready = false;
+              continue;
+            }
+          g_templates[type_id].offset = offset;
+          offset += (g_templates[type_id].size + TIZ_OS_CLONE_ALIGN - 1)
+                    & ~(TIZ_OS_CLONE_ALIGN - 1);
+        }
+      g_base_block_size = offset;
+      g_base_templates_ready = ready;
+    }
+  pthread_mutex_unlock (&g_templates_mutex);
+}
+
+/* Copies a template into this handle and re-points it to the handle's own
+   class and super class objects, which must exist already. */
+static void
+relocate_template (tiz_os_t * ap_os, const tiz_os_template_t * ap_tmpl,
+                   void * ap_dst)
+{
+  void * p_class = NULL;
+  void * p_super = NULL;
+  const void * p_tos = ap_os;
+  const void * p_hdl = NULL;
+
+  assert (ap_os);
+  assert (ap_tmpl);
+  assert (ap_dst);
+
+  p_class = ap_os->pp_types[ap_tmpl->class_id];
+  p_super = ap_os->pp_types[ap_tmpl->super_id];
+  p_hdl = ap_os->p_hdl;
+  assert (p_class);
+  assert (p_super);
+
+  memcpy (ap_dst, ap_tmpl->p_obj, ap_tmpl->size);
+  /* The class header fields are const; they are patched the same way
+     tiz_object_init does */
+  memcpy ((char *) ap_dst, (char *) &p_class, sizeof (tiz_class_t *));
+  memcpy ((char *) ap_dst + offsetof (tiz_class_t, super), (char *) &p_super,
+          sizeof (tiz_class_t *));
+  memcpy ((char *) ap_dst + offsetof (tiz_class_t, tos), (char *) &p_tos,
+          sizeof (void *));
+  memcpy ((char *) ap_dst + offsetof (tiz_class_t, hdl), (char *) &p_hdl,
+          sizeof (void *));
+}
+
+static OMX_ERRORTYPE
+clone_base_types (tiz_os_t * ap_os)
+{
+  OMX_S32 type_id = 0;
+
+  assert (ap_os);
+  assert (g_base_templates_ready);
+
+  if (!(ap_os->p_base_block = tiz_mem_alloc (g_base_block_size)))
+    {
+      return OMX_ErrorInsufficientResources;
+    }
+  ap_os->base_block_size = g_base_block_size;
+
+  /* The base types refer to each other (tizclass and tizobject form a
+     cycle); all addresses are assigned before any of them is relocated */
+  for (type_id = 0; type_id <= TIZ_OS_BASE_TYPE_END; ++type_id)
+    {
+      ap_os->pp_types[type_id] = ap_os->p_base_block + g_templates[type_id].offset;
+    }
+
+  for (type_id = 0; type_id <= TIZ_OS_BASE_TYPE_END; ++type_id)
+    {
+      relocate_template (ap_os, &(g_templates[type_id]),
+                         ap_os->pp_types[type_id]);
+    }
+
+  TIZ_TRACE (ap_os->p_hdl, "Cloned [%d] base types - [%zu] bytes",
+             TIZ_OS_BASE_TYPE_END + 1, g_base_block_size);
+
+  return OMX_ErrorNone;
+}
+
 static OMX_ERRORTYPE
 os_register_type (tiz_os_t * ap_os, const tiz_os_type_init_f a_type_init_f,
                   const char * a_type_name, const OMX_S32 a_type_id)
 {
-  OMX_ERRORTYPE rc = OMX_ErrorInsufficientResources;
   void * p_obj = NULL;
 
   assert (ap_os);
-  assert (ap_os->p_map);
   assert (a_type_init_f);
   assert (a_type_name);
   assert (strnlen (a_type_name, OMX_MAX_STRINGNAME_SIZE)
           < OMX_MAX_STRINGNAME_SIZE);
-  assert (a_type_id >= 0);
 
   /* Call the type init function */
   p_obj = a_type_init_f (ap_os, ap_os->p_hdl);
 
-  if (p_obj)
+  if (!p_obj)
     {
-      /* Register the class or object type */
-      TIZ_TRACE (ap_os->p_hdl,
-                 "Registering type #[%d] : [%s] -> [%p] "
-                 "nameOf [%s]",
-                 a_type_id, a_type_name, p_obj, nameOf (p_obj));
-      rc = tiz_map_insert (
-        ap_os->p_map,
-        os_strndup (ap_os->p_soa, a_type_name, OMX_MAX_STRINGNAME_SIZE), p_obj,
-        (OMX_U32 *) (&a_type_id));
+      return OMX_ErrorInsufficientResources;
     }
 
-  /*   print_types (ap_os); */
+  /* Register the class or object type */
+  TIZ_TRACE (ap_os->p_hdl,
+             "Registering type #[%d] : [%s] -> [%p] "
+             "nameOf [%s]",
+             a_type_id, a_type_name, p_obj, nameOf (p_obj));
 
-  return rc;
+  if (a_type_id >= 0)
+    {
+      assert (a_type_id < ETIZTypeMax);
+      assert (!ap_os->pp_types[a_type_id]);
+      ap_os->pp_types[a_type_id] = p_obj;
+    }
+  else
+    {
+      tiz_os_comp_type_t comp_type;
+      comp_type.p_obj = p_obj;
+      comp_type.p_name
+        = os_strndup (ap_os->p_soa, a_type_name, OMX_MAX_STRINGNAME_SIZE);
+      if (!comp_type.p_name
+          || OMX_ErrorNone
+               != tiz_vector_push_back (ap_os->p_comp_types, &comp_type))
+        {
+          os_free (ap_os->p_soa, comp_type.p_name);
+          factory_delete (p_obj);
+          return OMX_ErrorInsufficientResources;
+        }
+    }
+
+  return OMX_ErrorNone;
 }
 
 static OMX_ERRORTYPE
 register_base_types (tiz_os_t * ap_os)
 {
   OMX_ERRORTYPE rc = OMX_ErrorNone;
-  const OMX_S32 count
-    = sizeof (tiz_os_type_to_str_tbl) / sizeof (tiz_os_type_str_t);
   OMX_S32 type_id = 0;
-  OMX_S32 last_element = 0;
+  bool ready = false;
 
   assert (ap_os);
-  assert (count >= TIZ_OS_BASE_TYPE_END);
-  last_element = TIZ_OS_BASE_TYPE_END;
+  assert (ETIZTypeMax > TIZ_OS_BASE_TYPE_END);
+
+  pthread_mutex_lock (&g_templates_mutex);
+  ready = g_base_templates_ready;
+  pthread_mutex_unlock (&g_templates_mutex);
+
+  if (ready)
+    {
+      return clone_base_types (ap_os);
+    }
 
-  for (type_id = 0; type_id <= last_element && OMX_ErrorNone == rc; ++type_id)
+  /* First handle in the process: build the types with their init functions,
+     and keep them as templates for the handles that follow */
+  for (type_id = 0; type_id <= TIZ_OS_BASE_TYPE_END && OMX_ErrorNone == rc;
+       ++type_id)
     {
       TIZ_TRACE (ap_os->p_hdl, "Registering type [%s]...",
                  tiz_os_type_to_str_tbl[type_id].str);
       rc = os_register_type (ap_os, tiz_os_type_to_fnt_tbl[type_id],
                              tiz_os_type_to_str_tbl[type_id].str, type_id);
     }
+
+  if (OMX_ErrorNone == rc)
+    {
+      capture_base_templates (ap_os);
+    }
+
+  return rc;
+}
+
+static void *
+os_get_type_by_id (tiz_os_t * ap_os, const OMX_S32 a_type_id);
+
+static OMX_ERRORTYPE
+register_additional_type (tiz_os_t * ap_os, const OMX_S32 a_type_id)
+{
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  tiz_os_template_t tmpl;
+
+  assert (ap_os);
+  assert (a_type_id > TIZ_OS_BASE_TYPE_END && a_type_id < ETIZTypeMax);
+
+  /* Templates are never modified once captured, so it is enough to hold the
+     lock while taking a copy of the descriptor */
+  pthread_mutex_lock (&g_templates_mutex);
+  tmpl = g_templates[a_type_id];
+  pthread_mutex_unlock (&g_templates_mutex);
+
+  if (tmpl.p_obj && os_get_type_by_id (ap_os, tmpl.class_id)
+      && os_get_type_by_id (ap_os, tmpl.super_id))
+    {
+      void * p_obj = tiz_mem_alloc (tmpl.size);
+      if (!p_obj)
+        {
+          return OMX_ErrorInsufficientResources;
+        }
+      relocate_template (ap_os, &tmpl, p_obj);
+      ap_os->pp_types[a_type_id] = p_obj;
+      TIZ_TRACE (ap_os->p_hdl, "Cloned additional type [%s]",
+                 tiz_os_type_to_str_tbl[a_type_id].str);
+    }
+  else
+    {
+      TIZ_TRACE (ap_os->p_hdl, "Registering additional type [%s]...",
+                 tiz_os_type_to_str_tbl[a_type_id].str);
+      rc = os_register_type (ap_os, tiz_os_type_to_fnt_tbl[a_type_id],
+                             tiz_os_type_to_str_tbl[a_type_id].str,
+                             a_type_id);
+      if (OMX_ErrorNone == rc)
+        {
+          pthread_mutex_lock (&g_templates_mutex);
+          capture_template (ap_os, a_type_id);
+          pthread_mutex_unlock (&g_templates_mutex);
+        }
+    }
+
   return rc;
 }
 
+static void *
+os_get_type_by_id (tiz_os_t * ap_os, const OMX_S32 a_type_id)
+{
+  assert (ap_os);
+  assert (a_type_id >= 0 && a_type_id < ETIZTypeMax);
+  if (!ap_os->pp_types[a_type_id] && a_type_id > TIZ_OS_BASE_TYPE_END)
+    {
+      if (OMX_ErrorNone == register_additional_type (ap_os, a_type_id))
+        {
+          print_types (ap_os);
+        }
+    }
+  return ap_os->pp_types[a_type_id];
+}
+
 OMX_ERRORTYPE
 tiz_os_init (tiz_os_t ** app_os, const OMX_HANDLETYPE ap_hdl,
              tiz_soa_t * ap_soa)
@@ -513,10 +888,12 @@ tiz_os_init (tiz_os_t ** app_os, const OMX_HANDLETYPE ap_hdl,
 
   assert (p_os);
 
-  if (OMX_ErrorNone
-      != tiz_map_init (&(p_os->p_map), os_map_compare_func, os_map_free_func,
-                       NULL))
+  if (!(p_os->pp_types = tiz_mem_calloc (ETIZTypeMax, sizeof (void *)))
+      || OMX_ErrorNone
+           != tiz_vector_init (&(p_os->p_comp_types),
+                               sizeof (tiz_os_comp_type_t)))
     {
+      tiz_mem_free (p_os->pp_types);
       os_free (ap_soa, p_os);
       p_os = NULL;
       return OMX_ErrorInsufficientResources;
@@ -535,11 +912,23 @@ tiz_os_destroy (tiz_os_t * ap_os)
 {
   if (ap_os)
     {
-      while (!tiz_map_empty (ap_os->p_map))
+      OMX_S32 i = 0;
+      for (i = 0; i < tiz_vector_length (ap_os->p_comp_types); ++i)
         {
-          tiz_map_erase_at (ap_os->p_map, 0);
-        };
-      tiz_map_destroy (ap_os->p_map);
+          tiz_os_comp_type_t * p_type = tiz_vector_at (ap_os->p_comp_types, i);
+          tiz_mem_free (p_type->p_obj);
+          os_free (ap_os->p_soa, p_type->p_name);
+        }
+      tiz_vector_destroy (ap_os->p_comp_types);
+      for (i = 0; i < ETIZTypeMax; ++i)
+        {
+          if (!in_base_block (ap_os, ap_os->pp_types[i]))
+            {
+              tiz_mem_free (ap_os->pp_types[i]);
+            }
+        }
+      tiz_mem_free (ap_os->pp_types);
+      tiz_mem_free (ap_os->p_base_block);
       os_free (ap_os->p_soa, ap_os);
     }
 }
@@ -549,8 +938,9 @@ tiz_os_register_type (tiz_os_t * ap_os, const tiz_os_type_init_f a_type_init_f,
                       const OMX_STRING a_type_name)
 {
   assert (ap_os);
-  return os_register_type (ap_os, a_type_init_f, a_type_name,
-                           tiz_map_size (ap_os->p_map));
+  /* Component types are never shared between handles: their init functions
+     live in the component's own library, which may be unloaded */
+  return os_register_type (ap_os, a_type_init_f, a_type_name, -1);
 }
 
 OMX_ERRORTYPE
@@ -560,51 +950,34 @@ tiz_os_register_base_types (tiz_os_t * ap_os)
   return register_base_types (ap_os);
 }
 
-static OMX_ERRORTYPE
-register_additional_type (tiz_os_t * ap_os, const char * a_type_name)
-{
-  OMX_ERRORTYPE rc = OMX_ErrorNone;
-  const OMX_S32 count
-    = sizeof (tiz_os_type_to_str_tbl) / sizeof (tiz_os_type_str_t);
-  OMX_S32 type_id = TIZ_OS_BASE_TYPE_END + 1;
-
-  assert (ap_os);
-
-  for (; type_id < count && OMX_ErrorNone == rc; ++type_id)
-    {
-      if (0
-          == strncmp (a_type_name, tiz_os_type_to_str_tbl[type_id].str,
-                      OMX_MAX_STRINGNAME_SIZE))
-        {
-          TIZ_TRACE (ap_os->p_hdl, "Registering additional type [%s]...",
-                     a_type_name);
-          rc = os_register_type (ap_os, tiz_os_type_to_fnt_tbl[type_id],
-                                 a_type_name, type_id);
-          break;
-        }
-    }
-  return rc;
-}
-
 void *
 tiz_os_get_type (const tiz_os_t * ap_os, const char * a_type_name)
 {
   void * res = NULL;
+  OMX_S32 type_id = -1;
   assert (ap_os);
-  assert (ap_os->p_map);
   assert (a_type_name);
-  res = tiz_map_find (ap_os->p_map, (OMX_PTR) a_type_name);
-  TIZ_TRACE (ap_os->p_hdl, "Get type [%s]->[%p] - total types [%d]",
-             a_type_name, res, tiz_map_size (ap_os->p_map));
-  if (!res)
+
+  if ((type_id = find_type_id (a_type_name)) >= 0)
+    {
+      res = os_get_type_by_id ((tiz_os_t *) ap_os, type_id);
+    }
+  else
     {
-      if (OMX_ErrorNone
-          == register_additional_type ((tiz_os_t *) ap_os, a_type_name))
+      OMX_S32 i = 0;
+      for (i = 0; i < tiz_vector_length (ap_os->p_comp_types); ++i)
         {
-          print_types (ap_os);
-          res = tiz_map_find (ap_os->p_map, (OMX_PTR) a_type_name);
+          const tiz_os_comp_type_t * p_type
+            = tiz_vector_at (ap_os->p_comp_types, i);
+          if (0 == strcmp (a_type_name, p_type->p_name))
+            {
+              res = p_type->p_obj;
+              break;
+            }
         }
     }
+
+  TIZ_TRACE (ap_os->p_hdl, "Get type [%s]->[%p]", a_type_name, res);
   assert (res);
   return res;
 }
@@ -624,3 +997,13 @@ tiz_os_free (const tiz_os_t * ap_os, void * ap_addr)
   assert (ap_os->p_soa);
   os_free (ap_os->p_soa, ap_addr);
 }
+
+static void __attribute__ ((destructor)) os_unload (void)
+{
+  OMX_S32 type_id = 0;
+  for (type_id = 0; type_id < ETIZTypeMax; ++type_id)
+    {
+      tiz_mem_free (g_templates[type_id].p_obj);
+      g_templates[type_id].p_obj = NULL;
+    }
+}
@@ -167,17 +167,17 @@ get_mark_info (const tiz_port_t * ap_obj, OMX_U32 a_mark_idx)
 static OMX_U8 *
 default_alloc_hook (OMX_U32 * ap_size, OMX_PTR * app_port_priv, void * ap_args)
 {
-  OMX_U8 * p = NULL;
   assert (ap_size && *ap_size > 0);
-  p = tiz_mem_calloc ((size_t) *ap_size, sizeof (OMX_U8));
-  return p;
+  /* Buffers come from the process-wide pool, so that they can be re-used
+     when ports are re-populated */
+  return tiz_bufpool_alloc ((size_t) *ap_size);
 }
 
 static void
 default_free_hook (OMX_PTR ap_buf, OMX_PTR ap_port_priv, void * ap_args)
 {
   assert (ap_buf);
-  tiz_mem_free (ap_buf);
+  tiz_bufpool_free (ap_buf);
 }
 
 static OMX_ERRORTYPE
@@ -314,6 +314,7 @@ port_ctor (void * ap_obj, va_list * app)
   OMX_INDEXTYPE id2 = OMX_IndexParamCompBufferSupplier;
   OMX_INDEXTYPE id3 = OMX_IndexConfigTunneledPortStatus;
   OMX_INDEXTYPE id4 = OMX_TizoniaIndexParamBufferPreAnnouncementsMode;
+  OMX_INDEXTYPE id5 = OMX_TizoniaIndexParamBufferInPlaceMode;
 
   assert (ap_obj);
 
@@ -324,6 +325,7 @@ port_ctor (void * ap_obj, va_list * app)
   tiz_check_omx_ret_null (tiz_vector_push_back (p_obj->p_indexes_, &id2));
   tiz_check_omx_ret_null (tiz_vector_push_back (p_obj->p_indexes_, &id3));
   tiz_check_omx_ret_null (tiz_vector_push_back (p_obj->p_indexes_, &id4));
+  tiz_check_omx_ret_null (tiz_vector_push_back (p_obj->p_indexes_, &id5));
 
   /* Init buffer headers list */
   tiz_check_omx_ret_null (
@@ -397,6 +399,7 @@ port_ctor (void * ap_obj, va_list * app)
   p_obj->claimed_count_ = 0;
 
   p_obj->announce_bufs_ = OMX_TRUE; /* Default to 1.1.2 behaviour */
+  p_obj->in_place_ = OMX_FALSE;
 
   p_obj->peer_port_status_.nSize
     = (OMX_U32) sizeof (OMX_CONFIG_TUNNELEDPORTSTATUSTYPE);
@@ -486,6 +489,12 @@ port_GetParameter (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
               p_pm->nVersion.nVersion = (OMX_U32) OMX_VERSION;
               p_pm->bEnabled = p_obj->announce_bufs_;
             }
+          else if (OMX_TizoniaIndexParamBufferInPlaceMode == a_index)
+            {
+              OMX_TIZONIA_PARAM_BUFFER_INPLACEMODETYPE * p_ipm = ap_struct;
+              p_ipm->nVersion.nVersion = (OMX_U32) OMX_VERSION;
+              p_ipm->bEnabled = p_obj->in_place_;
+            }
           else
             {
               TIZ_ERROR (ap_hdl,
@@ -613,6 +622,14 @@ port_SetParameter (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
               TIZ_TRACE (ap_hdl, "Preannouncements - [%s]...",
                          p_pm->bEnabled == OMX_TRUE ? "ENABLED" : "DISABLED");
             }
+          else if (OMX_TizoniaIndexParamBufferInPlaceMode == a_index)
+            {
+              const OMX_TIZONIA_PARAM_BUFFER_INPLACEMODETYPE * p_ipm
+                = ap_struct;
+              p_obj->in_place_ = p_ipm->bEnabled;
+              TIZ_TRACE (ap_hdl, "In-place mode - [%s]...",
+                         p_ipm->bEnabled == OMX_TRUE ? "ENABLED" : "DISABLED");
+            }
           else
             {
               TIZ_ERROR (ap_hdl,
@@ -716,6 +733,14 @@ port_GetExtensionIndex (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
       *ap_index_type = OMX_TizoniaIndexParamBufferPreAnnouncementsMode;
       rc = OMX_ErrorNone;
     }
+  else if (0
+           == strncmp (ap_param_name,
+                       OMX_TIZONIA_INDEX_PARAM_BUFFER_INPLACEMODE,
+                       strlen (OMX_TIZONIA_INDEX_PARAM_BUFFER_INPLACEMODE)))
+    {
+      *ap_index_type = OMX_TizoniaIndexParamBufferInPlaceMode;
+      rc = OMX_ErrorNone;
+    }
 
   return rc;
 }
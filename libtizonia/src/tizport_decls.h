@@ -59,6 +59,7 @@ extern "C"
     OMX_BOOL contiguity_pref_;
     OMX_PARAM_BUFFERSUPPLIERTYPE bufsupplier_;
     OMX_BOOL announce_bufs_;
+    OMX_BOOL in_place_;
     OMX_CONFIG_TUNNELEDPORTSTATUSTYPE peer_port_status_;
     tiz_eglimage_hook_t eglimage_hook_; /* EGL image validation hook */
   };
@@ -531,6 +531,28 @@ remove_buffer_from_servant_queue (OMX_PTR ap_elem, OMX_S32 a_data1,
   return rc;
 }
 
+static void
+prc_msg_keys (void * ap_data, OMX_S32 * ap_port, void ** app_hdr)
+{
+  tiz_prc_msg_t * p_msg = ap_data;
+
+  assert (p_msg);
+  assert (ap_port);
+  assert (app_hdr);
+
+  /* Only buffers-ready messages are ever removed from the queue */
+  if (ETIZPrcMsgBuffersReady == p_msg->class)
+    {
+      *ap_port = (OMX_S32) p_msg->br.pid;
+      *app_hdr = p_msg->br.p_buffer;
+    }
+  else
+    {
+      *ap_port = -1;
+      *app_hdr = NULL;
+    }
+}
+
 /*
  * tiz_prc
  */
@@ -538,7 +560,9 @@ remove_buffer_from_servant_queue (OMX_PTR ap_elem, OMX_S32 a_data1,
 static void *
 prc_ctor (void * ap_obj, va_list * app)
 {
-  return super_ctor (typeOf (ap_obj, "tizprc"), ap_obj, app);
+  tiz_prc_t * p_obj = super_ctor (typeOf (ap_obj, "tizprc"), ap_obj, app);
+  tiz_srv_set_queue_key_func (p_obj, &prc_msg_keys);
+  return p_obj;
 }
 
 static void *
@@ -629,12 +653,11 @@ static void
 prc_remove_from_queue (const void * ap_obj, tiz_pq_func_f apf_func,
                        OMX_S32 a_data1, OMX_PTR ap_data2)
 {
-  tiz_srv_t * p_obj = (tiz_srv_t *) ap_obj;
   /* Actual implementation is in the parent class */
-  /* Replace dummy parameters apf_func and a_data1 */
-  tiz_srv_super_remove_from_queue (typeOf (ap_obj, "tizprc"), p_obj,
-                                   &remove_buffer_from_servant_queue,
-                                   ETIZPrcMsgBuffersReady, ap_data2);
+  /* Replace dummy parameters apf_func and a_data1; only the messages of this
+     header need to be visited */
+  tiz_srv_remove_from_queue_by_hdr (ap_obj, &remove_buffer_from_servant_queue,
+                                    ETIZPrcMsgBuffersReady, ap_data2);
 }
 
 static OMX_ERRORTYPE
@@ -1698,7 +1698,6 @@ configure_port_preannouncements (tiz_scheduler_t * ap_sched,
                                  OMX_HANDLETYPE ap_hdl, OMX_PTR p_port)
 {
   OMX_ERRORTYPE rc = OMX_ErrorNone;
-  const char * p_preannounce_disabled = NULL;
   char fqd_key[OMX_MAX_STRINGNAME_SIZE];
   char port_num[OMX_MAX_STRINGNAME_SIZE];
   OMX_U32 pid = tiz_port_index (p_port);
@@ -1712,10 +1711,7 @@ configure_port_preannouncements (tiz_scheduler_t * ap_sched,
            OMX_MAX_STRINGNAME_SIZE - strlen (fqd_key) - 1);
   strncat (fqd_key, port_num, OMX_MAX_STRINGNAME_SIZE - strlen (fqd_key) - 1);
 
-  p_preannounce_disabled = tiz_rcfile_get_value ("plugins", fqd_key);
-
-  if (!p_preannounce_disabled
-      || (0 != strncmp (p_preannounce_disabled, "true", 4)))
+  if (!tiz_rcfile_get_bool (TIZ_RCFILE_PLUGINS_DATA_SECTION, fqd_key, false))
     {
       TIZ_TRACE (ap_hdl,
                  "[%s:port-%d] Preannouncements are "
@@ -1744,6 +1740,43 @@ configure_port_preannouncements (tiz_scheduler_t * ap_sched,
   return rc;
 }
 
+static OMX_ERRORTYPE
+configure_port_in_place (tiz_scheduler_t * ap_sched, OMX_HANDLETYPE ap_hdl,
+                         OMX_PTR p_port)
+{
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  char fqd_key[OMX_MAX_STRINGNAME_SIZE];
+  char port_num[OMX_MAX_STRINGNAME_SIZE];
+  OMX_U32 pid = tiz_port_index (p_port);
+
+  /* OMX.component.name.key */
+  (void) snprintf (port_num, OMX_MAX_STRINGNAME_SIZE, "%u", (unsigned int) pid);
+  strncpy (fqd_key, ap_sched->cname, OMX_MAX_STRINGNAME_SIZE - 1);
+  /* Make sure fqd_key is null-terminated */
+  fqd_key[OMX_MAX_STRINGNAME_SIZE - 1] = '\0';
+  strncat (fqd_key, ".inplace_enabled.port",
+           OMX_MAX_STRINGNAME_SIZE - strlen (fqd_key) - 1);
+  strncat (fqd_key, port_num, OMX_MAX_STRINGNAME_SIZE - strlen (fqd_key) - 1);
+
+  if (tiz_rcfile_get_bool (TIZ_RCFILE_PLUGINS_DATA_SECTION, fqd_key, false))
+    {
+      OMX_TIZONIA_PARAM_BUFFER_INPLACEMODETYPE ipmode;
+
+      TIZ_TRACE (ap_hdl, "[%s:port-%d] In-place mode is [ENABLED]...",
+                 ap_sched->cname, pid);
+
+      ipmode.nSize = sizeof (OMX_TIZONIA_PARAM_BUFFER_INPLACEMODETYPE);
+      ipmode.nVersion.nVersion = OMX_VERSION;
+      ipmode.nPortIndex = pid;
+      ipmode.bEnabled = OMX_TRUE;
+
+      rc = tiz_api_SetParameter (
+        p_port, ap_hdl, OMX_TizoniaIndexParamBufferInPlaceMode, &ipmode);
+    }
+
+  return rc;
+}
+
 static OMX_ERRORTYPE
 sched_ComponentDeInit (OMX_HANDLETYPE ap_hdl)
 {
@@ -2688,6 +2721,10 @@ init_and_register_role (tiz_scheduler_t * ap_sched, const OMX_U32 a_role_pos)
       tiz_check_omx_ret_oom (tiz_krn_register_port (
         ap_sched->child.p_ker, p_port, OMX_FALSE)); /* not a config port */
       rc = configure_port_preannouncements (ap_sched, p_hdl, p_port);
+      if (OMX_ErrorNone == rc)
+        {
+          rc = configure_port_in_place (ap_sched, p_hdl, p_port);
+        }
     }
 
   if (OMX_ErrorNone == rc)
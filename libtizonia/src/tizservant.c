@@ -133,6 +133,7 @@ srv_ctor (void * ap_obj, va_list * app)
   /* NOTE: The priority queue is initialised only when the allocator is set via
      * set_allocator */
   p_srv->p_pq_ = NULL;
+  p_srv->pf_pq_key_ = NULL;
   p_srv->p_soa_ = NULL;
   /* We also lazily initialise the watchers map, when the first watcher is
        allocated */
@@ -178,8 +179,14 @@ srv_set_allocator (void * ap_obj, tiz_soa_t * p_soa)
   assert (ap_obj);
   assert (p_soa);
   p_srv->p_soa_ = p_soa;
-  return tiz_pqueue_init (&p_srv->p_pq_, 5, &pqueue_cmp, p_soa,
-                          nameOf (ap_obj));
+  tiz_check_omx (tiz_pqueue_init (&p_srv->p_pq_, 5, &pqueue_cmp, p_soa,
+                                  nameOf (ap_obj)));
+  if (p_srv->pf_pq_key_)
+    {
+      tiz_check_omx (
+        tiz_pqueue_set_key_func (p_srv->p_pq_, p_srv->pf_pq_key_));
+    }
+  return OMX_ErrorNone;
 }
 
 OMX_ERRORTYPE
@@ -339,6 +346,37 @@ tiz_srv_super_remove_from_queue (const void * a_class, const void * ap_obj,
   superclass->remove_from_queue (ap_obj, apf_func, a_data1, ap_data2);
 }
 
+void
+tiz_srv_set_queue_key_func (void * ap_obj, tiz_pq_key_f apf_key)
+{
+  tiz_srv_t * p_srv = ap_obj;
+  assert (p_srv);
+  assert (!p_srv->p_pq_);
+  p_srv->pf_pq_key_ = apf_key;
+}
+
+void
+tiz_srv_remove_from_queue_by_port (const void * ap_obj, tiz_pq_func_f apf_func,
+                                   OMX_U32 a_pid, OMX_PTR ap_data2)
+{
+  tiz_srv_t * p_srv = (tiz_srv_t *) ap_obj;
+  assert (p_srv);
+  /* OMX_ALL is negative as a port key, and makes this a full scan */
+  tiz_pqueue_remove_func_port (p_srv->p_pq_, apf_func, (OMX_S32) a_pid,
+                               (OMX_S32) a_pid, ap_data2);
+}
+
+void
+tiz_srv_remove_from_queue_by_hdr (const void * ap_obj, tiz_pq_func_f apf_func,
+                                  OMX_S32 a_data1,
+                                  OMX_BUFFERHEADERTYPE * ap_hdr)
+{
+  tiz_srv_t * p_srv = (tiz_srv_t *) ap_obj;
+  assert (p_srv);
+  tiz_pqueue_remove_func_hdr (p_srv->p_pq_, apf_func, ap_hdr, a_data1,
+                              ap_hdr);
+}
+
 static OMX_ERRORTYPE
 srv_dispatch_msg (const void * ap_obj, OMX_PTR ap_data)
 {
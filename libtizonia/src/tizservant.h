@@ -67,6 +67,22 @@ extern "C"
                              /*@null@*/ tiz_pq_func_f apf_func, OMX_S32 a_data1,
                              OMX_PTR ap_data2);
 
+  /* Secondary indexes of the message queue. The key function extracts the
+   * port and buffer header a message refers to; it must be set before the
+   * allocator. */
+  void
+  tiz_srv_set_queue_key_func (void * ap_obj, tiz_pq_key_f apf_key);
+
+  void
+  tiz_srv_remove_from_queue_by_port (const void * ap_obj,
+                                     tiz_pq_func_f apf_func, OMX_U32 a_pid,
+                                     OMX_PTR ap_data2);
+
+  void
+  tiz_srv_remove_from_queue_by_hdr (const void * ap_obj,
+                                    tiz_pq_func_f apf_func, OMX_S32 a_data1,
+                                    OMX_BUFFERHEADERTYPE * ap_hdr);
+
   OMX_ERRORTYPE
   tiz_srv_dispatch_msg (const void * ap_obj, OMX_PTR ap_data);
 
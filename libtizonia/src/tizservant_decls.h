@@ -43,6 +43,7 @@ extern "C"
     /* Object */
     const tiz_api_t _;
     tiz_pqueue_t * p_pq_;
+    tiz_pq_key_f pf_pq_key_;
     tiz_soa_t * p_soa_; /* Not owned */
     tiz_map_t * p_watchers_;
     uint32_t watcher_id_;
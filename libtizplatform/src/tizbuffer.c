@@ -30,10 +30,16 @@
 #include <config.h>
 #endif
 
+#define _GNU_SOURCE
+
 #include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include "tizmem.h"
 #include "tizlog.h"
@@ -45,6 +51,10 @@
 #define TIZ_LOG_CATEGORY_NAME "tiz.platform.buffer"
 #endif
 
+/* In non-seekable mode, the store is a ring of memfd pages that are mapped
+   twice, back to back. The unread data is always contiguous in memory, however
+   it wraps around the ring, so pushes never need to move it. The plain heap
+   store is used in seekable mode, or when the ring can't be mapped. */
 struct tiz_buffer
 {
   unsigned char * p_store;
@@ -52,6 +62,8 @@ struct tiz_buffer
   int filled_len;
   int offset;
   int seek_mode;
+  bool mirrored;
+  int head; /* Index of the current position in the ring (mirrored only) */
 };
 
 static long
@@ -61,6 +73,72 @@ abs_of (const long v)
   return (v + mask) ^ mask;
 }
 
+static size_t
+ring_size (const size_t nbytes)
+{
+  const long page = sysconf (_SC_PAGESIZE);
+  const size_t pg = page > 0 ? (size_t) page : 4096;
+  return ((nbytes + pg - 1) / pg) * pg;
+}
+
+static unsigned char *
+map_ring (const size_t nbytes)
+{
+  unsigned char * p_ring = NULL;
+#ifdef HAVE_MEMFD_CREATE
+  void * p_addr = MAP_FAILED;
+  int fd = -1;
+
+  assert (nbytes > 0);
+  assert (ring_size (nbytes) == nbytes);
+
+  if (nbytes > INT_MAX / 2
+      || (fd = memfd_create ("tizbuffer", MFD_CLOEXEC)) < 0)
+    {
+      return NULL;
+    }
+
+  /* Reserve twice the size, then map the same pages over both halves */
+  if (0 == ftruncate (fd, nbytes)
+      && MAP_FAILED
+           != (p_addr = mmap (NULL, 2 * nbytes, PROT_NONE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)))
+    {
+      if (MAP_FAILED != mmap (p_addr, nbytes, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_FIXED, fd, 0)
+          && MAP_FAILED
+               != mmap ((unsigned char *) p_addr + nbytes, nbytes,
+                        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0))
+        {
+          p_ring = p_addr;
+        }
+      else
+        {
+          (void) munmap (p_addr, 2 * nbytes);
+        }
+    }
+
+  if (!p_ring)
+    {
+      TIZ_LOG (TIZ_PRIORITY_NOTICE, "mirrored ring failed (%s); using heap",
+               strerror (errno));
+    }
+  (void) close (fd);
+#else
+  (void) nbytes;
+#endif
+  return p_ring;
+}
+
+static inline void
+unmap_ring (unsigned char * ap_ring, const size_t nbytes)
+{
+  if (ap_ring)
+    {
+      (void) munmap (ap_ring, 2 * nbytes);
+    }
+}
+
 static inline void *
 alloc_data_store (tiz_buffer_t * ap_buf, const size_t nbytes)
 {
@@ -69,14 +147,21 @@ alloc_data_store (tiz_buffer_t * ap_buf, const size_t nbytes)
 
   if (nbytes > 0)
     {
-      ap_buf->p_store = tiz_mem_calloc (1, nbytes);
-      if (ap_buf->p_store)
+      const size_t ring_len = ring_size (nbytes);
+      if ((ap_buf->p_store = map_ring (ring_len)))
+        {
+          ap_buf->alloc_len = ring_len;
+          ap_buf->mirrored = true;
+        }
+      else if ((ap_buf->p_store = tiz_mem_calloc (1, nbytes)))
         {
           ap_buf->alloc_len = nbytes;
-          ap_buf->filled_len = 0;
-          ap_buf->offset = 0;
-          ap_buf->seek_mode = TIZ_BUFFER_NON_SEEKABLE;
+          ap_buf->mirrored = false;
         }
+      ap_buf->filled_len = 0;
+      ap_buf->offset = 0;
+      ap_buf->head = 0;
+      ap_buf->seek_mode = TIZ_BUFFER_NON_SEEKABLE;
     }
   return ap_buf->p_store;
 }
@@ -89,15 +174,130 @@ dealloc_data_store (
 {
   if (ap_buf)
     {
-      tiz_mem_free (ap_buf->p_store);
+      if (ap_buf->mirrored)
+        {
+          unmap_ring (ap_buf->p_store, ap_buf->alloc_len);
+        }
+      else
+        {
+          tiz_mem_free (ap_buf->p_store);
+        }
       ap_buf->p_store = NULL;
       ap_buf->alloc_len = 0;
       ap_buf->filled_len = 0;
       ap_buf->offset = 0;
+      ap_buf->head = 0;
+      ap_buf->mirrored = false;
       ap_buf->seek_mode = TIZ_BUFFER_NON_SEEKABLE;
     }
 }
 
+/* The data behind the current position that is still in the store */
+static inline unsigned char *
+mirrored_start (const tiz_buffer_t * ap_buf)
+{
+  assert (ap_buf);
+  assert (ap_buf->mirrored);
+  return ap_buf->p_store
+         + (ap_buf->head - ap_buf->offset + ap_buf->alloc_len)
+             % ap_buf->alloc_len;
+}
+
+static bool
+mirror (tiz_buffer_t * ap_buf)
+{
+  const size_t ring_len = ring_size (ap_buf->alloc_len);
+  unsigned char * p_ring = NULL;
+
+  assert (ap_buf);
+  assert (!ap_buf->mirrored);
+
+  if (!(p_ring = map_ring (ring_len)))
+    {
+      return false;
+    }
+  memcpy (p_ring, ap_buf->p_store, ap_buf->offset + ap_buf->filled_len);
+  tiz_mem_free (ap_buf->p_store);
+  ap_buf->p_store = p_ring;
+  ap_buf->alloc_len = ring_len;
+  ap_buf->head = ap_buf->offset;
+  ap_buf->mirrored = true;
+  return true;
+}
+
+static bool
+unmirror (tiz_buffer_t * ap_buf)
+{
+  unsigned char * p_store = NULL;
+
+  assert (ap_buf);
+  assert (ap_buf->mirrored);
+
+  if (!(p_store = tiz_mem_alloc (ap_buf->alloc_len)))
+    {
+      return false;
+    }
+  memcpy (p_store, mirrored_start (ap_buf),
+          ap_buf->offset + ap_buf->filled_len);
+  unmap_ring (ap_buf->p_store, ap_buf->alloc_len);
+  ap_buf->p_store = p_store;
+  ap_buf->head = 0;
+  ap_buf->mirrored = false;
+  return true;
+}
+
+static void
+grow_ring (tiz_buffer_t * ap_buf, const size_t a_need)
+{
+  size_t ring_len = ap_buf->alloc_len * 2;
+  unsigned char * p_ring = NULL;
+
+  assert (ap_buf);
+  assert (ap_buf->mirrored);
+
+  while (ring_len < a_need)
+    {
+      ring_len *= 2;
+    }
+
+  /* Only the unread data is carried over */
+  if ((p_ring = map_ring (ring_len)))
+    {
+      memcpy (p_ring, ap_buf->p_store + ap_buf->head, ap_buf->filled_len);
+      unmap_ring (ap_buf->p_store, ap_buf->alloc_len);
+      ap_buf->p_store = p_ring;
+      ap_buf->alloc_len = ring_len;
+      ap_buf->head = 0;
+      ap_buf->offset = 0;
+    }
+}
+
+static int
+mirrored_push (tiz_buffer_t * ap_buf, const void * ap_data,
+               const size_t a_nbytes)
+{
+  size_t nbytes_to_copy = 0;
+
+  assert (ap_buf);
+  assert (ap_buf->mirrored);
+
+  if (a_nbytes > (size_t) (ap_buf->alloc_len - ap_buf->filled_len))
+    {
+      grow_ring (ap_buf, ap_buf->filled_len + a_nbytes);
+    }
+
+  /* The data behind the current position gets discarded. The tail may be in
+     the second mapping, but there is always room for a full ring after the
+     current position. */
+  ap_buf->offset = 0;
+  nbytes_to_copy
+    = MIN (a_nbytes, (size_t) (ap_buf->alloc_len - ap_buf->filled_len));
+  memcpy (ap_buf->p_store + ap_buf->head + ap_buf->filled_len, ap_data,
+          nbytes_to_copy);
+  ap_buf->filled_len += nbytes_to_copy;
+  return nbytes_to_copy;
+}
+
 OMX_ERRORTYPE
 tiz_buffer_init (/*@null@ */ tiz_buffer_ptr_t * app_buf, const size_t a_nbytes)
 {
@@ -153,6 +353,16 @@ tiz_buffer_seek_mode (tiz_buffer_t * ap_buf, const int a_seek_mode)
       || a_seek_mode == TIZ_BUFFER_NON_SEEKABLE)
     {
       assert (ap_buf);
+      if (a_seek_mode == TIZ_BUFFER_SEEKABLE && ap_buf->mirrored
+          && !unmirror (ap_buf))
+        {
+          return -1;
+        }
+      if (a_seek_mode == TIZ_BUFFER_NON_SEEKABLE && !ap_buf->mirrored)
+        {
+          /* Otherwise, stay on the heap */
+          (void) mirror (ap_buf);
+        }
       old_val = ap_buf->seek_mode;
       ap_buf->seek_mode = a_seek_mode;
     }
@@ -168,7 +378,11 @@ tiz_buffer_push (tiz_buffer_t * ap_buf, const void * ap_data,
   assert (ap_buf);
   assert (ap_buf->alloc_len >= (ap_buf->offset + ap_buf->filled_len));
 
-  if (ap_data && a_nbytes > 0)
+  if (ap_data && a_nbytes > 0 && ap_buf->mirrored)
+    {
+      nbytes_to_copy = mirrored_push (ap_buf, ap_data, a_nbytes);
+    }
+  else if (ap_data && a_nbytes > 0)
     {
       size_t avail = 0;
 
@@ -223,7 +437,8 @@ tiz_buffer_get (const tiz_buffer_t * ap_buf)
 {
   assert (ap_buf);
   assert (ap_buf->alloc_len >= (ap_buf->offset + ap_buf->filled_len));
-  return (ap_buf->p_store + ap_buf->offset);
+  return ap_buf->mirrored ? (ap_buf->p_store + ap_buf->head)
+                          : (ap_buf->p_store + ap_buf->offset);
 }
 
 int
@@ -236,6 +451,10 @@ tiz_buffer_advance (tiz_buffer_t * ap_buf, const int nbytes)
       min_nbytes = MIN (nbytes, tiz_buffer_available (ap_buf));
       ap_buf->offset += min_nbytes;
       ap_buf->filled_len -= min_nbytes;
+      if (ap_buf->mirrored)
+        {
+          ap_buf->head = (ap_buf->head + min_nbytes) % ap_buf->alloc_len;
+        }
     }
   return min_nbytes;
 }
@@ -248,6 +467,7 @@ tiz_buffer_seek (tiz_buffer_t * ap_buf, const long offset, const int whence)
   assert (ap_buf->alloc_len >= (ap_buf->offset + ap_buf->filled_len));
 
   int total = ap_buf->offset + ap_buf->filled_len;
+  int old_offset = ap_buf->offset;
   if (whence == TIZ_BUFFER_SEEK_SET)
     {
       ap_buf->offset = MIN (offset, total);
@@ -275,6 +495,12 @@ tiz_buffer_seek (tiz_buffer_t * ap_buf, const long offset, const int whence)
   if (0 == rc)
     {
       ap_buf->filled_len = total - ap_buf->offset;
+      if (ap_buf->mirrored)
+        {
+          ap_buf->head = (ap_buf->head + ap_buf->offset - old_offset
+                          + ap_buf->alloc_len)
+                         % ap_buf->alloc_len;
+        }
     }
   assert (total == ap_buf->offset + ap_buf->filled_len);
   assert (ap_buf->alloc_len >= (ap_buf->offset + ap_buf->filled_len));
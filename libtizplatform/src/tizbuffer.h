@@ -39,6 +39,11 @@ extern "C"
 *
 * Dynamically re-sizeable buffer of contiguous binary data.
 *
+* In non-seekable mode, and where memfd_create is available, the data store is
+* a ring whose pages are mapped twice, back to back. The data available is
+* always contiguous, and pushing never moves it. Seekable buffers use a plain
+* heap allocation.
+*
 * @ingroup libtizplatform
 */
 
@@ -95,7 +100,8 @@ extern "C"
  * @param ap_buf The dynamic buffer handle.
  * @param a_seek_mode TIZ_BUFFER_NON_SEEKABLE (default) or
  * TIZ_BUFFER_SEEKABLE.
- * @return The old seek mode, or -1 on error.
+ * @return The old seek mode, or -1 on error (including failure to move the
+ * data to a seekable store).
  */
   int
   tiz_buffer_seek_mode (tiz_buffer_t * ap_buf, const int a_seek_mode);
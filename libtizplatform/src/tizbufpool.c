@@ -0,0 +1,392 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   tizbufpool.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia Platform - Process-wide pool of aligned data buffers
+ *
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "tizmem.h"
+#include "tizlog.h"
+#include "tizmacros.h"
+#include "tizmap.h"
+#include "tizrc.h"
+#include "tizbufpool.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.platform.bufpool"
+#endif
+
+#define TIZ_BUFPOOL_RC_SECTION "ilcore"
+
+/* Smallest size class; also the alignment of the buffers smaller than a
+   page (a cache line) */
+#define TIZ_BUFPOOL_MIN_SIZE 64
+/* Each power of two is split into this many size classes, so that rounding
+   up to a class wastes at most 25% */
+#define TIZ_BUFPOOL_STEPS 4
+/* Classes up to 64 MB are cached; larger buffers go straight to the system */
+#define TIZ_BUFPOOL_MAX_CLASS_LOG2 26
+#define TIZ_BUFPOOL_NUM_CLASSES \
+  ((TIZ_BUFPOOL_MAX_CLASS_LOG2 - 6) * TIZ_BUFPOOL_STEPS + 1)
+#define TIZ_BUFPOOL_DEFAULT_MAX_CACHED_MB 64
+#define TIZ_BUFPOOL_HUGEPAGE_SIZE (2 * 1024 * 1024)
+
+typedef struct tiz_bufpool tiz_bufpool_t;
+struct tiz_bufpool
+{
+  pthread_mutex_t mutex;
+  bool enabled;
+  bool zero_buffers;
+  bool hugepages;
+  size_t page_size;
+  /* Unused buffers; each links to the next through its first bytes */
+  void * free_lists[TIZ_BUFPOOL_NUM_CLASSES];
+  /* Buffers handed out -> their allocation size */
+  tiz_map_t * p_in_use;
+  tiz_bufpool_stats_t stats;
+};
+
+static tiz_bufpool_t g_bufpool = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+static pthread_once_t g_bufpool_once = PTHREAD_ONCE_INIT;
+
+static OMX_S32
+in_use_map_compare_func (OMX_PTR ap_key1, OMX_PTR ap_key2)
+{
+  const uintptr_t key1 = (uintptr_t) ap_key1;
+  const uintptr_t key2 = (uintptr_t) ap_key2;
+  return (key1 < key2 ? -1 : (key1 > key2 ? 1 : 0));
+}
+
+static void
+in_use_map_free_func (OMX_PTR ap_key, OMX_PTR ap_value)
+{
+  /* Nothing to release; the value is the size of the buffer */
+}
+
+static void
+init_bufpool (void)
+{
+  long page_size = sysconf (_SC_PAGESIZE);
+  long max_cached_mb = 0;
+
+  g_bufpool.page_size = page_size > 0 ? (size_t) page_size : 4096;
+  g_bufpool.enabled = tiz_rcfile_get_bool (TIZ_BUFPOOL_RC_SECTION,
+                                           "buffer-pool.enabled", true);
+  g_bufpool.zero_buffers = tiz_rcfile_get_bool (
+    TIZ_BUFPOOL_RC_SECTION, "buffer-pool.zero-buffers", true);
+  g_bufpool.hugepages = tiz_rcfile_get_bool (TIZ_BUFPOOL_RC_SECTION,
+                                             "buffer-pool.hugepages", false);
+
+  max_cached_mb
+    = tiz_rcfile_get_int (TIZ_BUFPOOL_RC_SECTION, "buffer-pool.max-cached-mb",
+                          TIZ_BUFPOOL_DEFAULT_MAX_CACHED_MB);
+  if (max_cached_mb < 0)
+    {
+      max_cached_mb = 0;
+    }
+  g_bufpool.stats.max_cached_bytes = (size_t) max_cached_mb * 1024 * 1024;
+
+  if (g_bufpool.enabled
+      && OMX_ErrorNone
+           != tiz_map_init (&(g_bufpool.p_in_use), in_use_map_compare_func,
+                            in_use_map_free_func, NULL))
+    {
+      g_bufpool.enabled = false;
+    }
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE,
+           "enabled [%s] max cached [%zu] zero [%s] hugepages [%s]",
+           g_bufpool.enabled ? "YES" : "NO", g_bufpool.stats.max_cached_bytes,
+           g_bufpool.zero_buffers ? "YES" : "NO",
+           g_bufpool.hugepages ? "YES" : "NO");
+}
+
+/* Returns the size class index, or -1 if the size is too large to be
+   cached. On return, ap_class_size holds the size actually allocated. */
+static int
+size_class (const size_t a_size, size_t * ap_class_size)
+{
+  size_t base = TIZ_BUFPOOL_MIN_SIZE;
+  size_t step = 0;
+  size_t n = 0;
+  int idx = 0;
+
+  assert (ap_class_size);
+
+  if (a_size <= base)
+    {
+      *ap_class_size = base;
+      return 0;
+    }
+
+  while (base * 2 < a_size)
+    {
+      base *= 2;
+      idx += TIZ_BUFPOOL_STEPS;
+    }
+
+  /* base < a_size <= 2 * base */
+  step = base / TIZ_BUFPOOL_STEPS;
+  n = (a_size - base + step - 1) / step;
+  idx += (int) n;
+  *ap_class_size = base + n * step;
+
+  if (idx >= TIZ_BUFPOOL_NUM_CLASSES)
+    {
+      *ap_class_size = a_size;
+      return -1;
+    }
+  return idx;
+}
+
+static size_t
+class_size_of (const int a_idx)
+{
+  size_t base = TIZ_BUFPOOL_MIN_SIZE;
+  assert (a_idx >= 0 && a_idx < TIZ_BUFPOOL_NUM_CLASSES);
+  if (0 == a_idx)
+    {
+      return base;
+    }
+  base <<= (a_idx - 1) / TIZ_BUFPOOL_STEPS;
+  return base
+         + ((a_idx - 1) % TIZ_BUFPOOL_STEPS + 1) * (base / TIZ_BUFPOOL_STEPS);
+}
+
+static inline bool
+use_hugepages (const size_t a_size)
+{
+  return (g_bufpool.hugepages && a_size >= TIZ_BUFPOOL_HUGEPAGE_SIZE);
+}
+
+static void *
+system_alloc (const size_t a_size)
+{
+  void * p_buf = NULL;
+
+  if (use_hugepages (a_size))
+    {
+      p_buf = mmap (NULL, a_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (MAP_FAILED == p_buf)
+        {
+          return NULL;
+        }
+#ifdef MADV_HUGEPAGE
+      (void) madvise (p_buf, a_size, MADV_HUGEPAGE);
+#endif
+    }
+  else
+    {
+      const size_t alignment = a_size < g_bufpool.page_size
+                                 ? TIZ_BUFPOOL_MIN_SIZE
+                                 : g_bufpool.page_size;
+      if (0 != posix_memalign (&p_buf, alignment, a_size))
+        {
+          return NULL;
+        }
+    }
+
+  return p_buf;
+}
+
+static void
+system_free (void * ap_buf, const size_t a_size)
+{
+  if (use_hugepages (a_size))
+    {
+      (void) munmap (ap_buf, a_size);
+    }
+  else
+    {
+      free (ap_buf);
+    }
+}
+
+/* Called with the mutex held */
+static void
+trim_to (const size_t a_max_bytes)
+{
+  int idx = TIZ_BUFPOOL_NUM_CLASSES - 1;
+
+  /* The largest buffers go first */
+  for (; idx >= 0 && g_bufpool.stats.cached_bytes > a_max_bytes; --idx)
+    {
+      while (g_bufpool.free_lists[idx]
+             && g_bufpool.stats.cached_bytes > a_max_bytes)
+        {
+          void * p_buf = g_bufpool.free_lists[idx];
+          const size_t class_size = class_size_of (idx);
+          g_bufpool.free_lists[idx] = *(void **) p_buf;
+          system_free (p_buf, class_size);
+          g_bufpool.stats.cached_bytes -= class_size;
+          g_bufpool.stats.cached_buffers--;
+        }
+    }
+}
+
+OMX_U8 *
+tiz_bufpool_alloc (const size_t a_size)
+{
+  void * p_buf = NULL;
+  size_t class_size = 0;
+  OMX_U32 index = 0;
+  int idx = -1;
+
+  (void) pthread_once (&g_bufpool_once, init_bufpool);
+
+  if (!g_bufpool.enabled)
+    {
+      return tiz_mem_calloc (a_size, sizeof (OMX_U8));
+    }
+
+  idx = size_class (a_size, &class_size);
+
+  pthread_mutex_lock (&g_bufpool.mutex);
+  if (idx >= 0 && g_bufpool.free_lists[idx])
+    {
+      p_buf = g_bufpool.free_lists[idx];
+      g_bufpool.free_lists[idx] = *(void **) p_buf;
+      g_bufpool.stats.cached_bytes -= class_size;
+      g_bufpool.stats.cached_buffers--;
+      g_bufpool.stats.hits++;
+    }
+  else
+    {
+      /* Don't hold the lock while the system allocator runs */
+      pthread_mutex_unlock (&g_bufpool.mutex);
+      p_buf = system_alloc (class_size);
+      pthread_mutex_lock (&g_bufpool.mutex);
+      g_bufpool.stats.misses++;
+    }
+
+  if (p_buf)
+    {
+      if (OMX_ErrorNone
+          != tiz_map_insert (g_bufpool.p_in_use, p_buf,
+                             (OMX_PTR) (uintptr_t) class_size, &index))
+        {
+          pthread_mutex_unlock (&g_bufpool.mutex);
+          system_free (p_buf, class_size);
+          return NULL;
+        }
+      g_bufpool.stats.in_use_bytes += class_size;
+      g_bufpool.stats.in_use_buffers++;
+    }
+  pthread_mutex_unlock (&g_bufpool.mutex);
+
+  if (p_buf && g_bufpool.zero_buffers)
+    {
+      memset (p_buf, 0, a_size);
+    }
+
+  return p_buf;
+}
+
+void
+tiz_bufpool_free (OMX_U8 * ap_buf)
+{
+  size_t class_size = 0;
+  int idx = -1;
+
+  if (!ap_buf)
+    {
+      return;
+    }
+
+  (void) pthread_once (&g_bufpool_once, init_bufpool);
+
+  if (!g_bufpool.enabled)
+    {
+      tiz_mem_free (ap_buf);
+      return;
+    }
+
+  pthread_mutex_lock (&g_bufpool.mutex);
+  class_size = (size_t) (uintptr_t) tiz_map_find (g_bufpool.p_in_use, ap_buf);
+  assert (class_size > 0);
+  tiz_map_erase (g_bufpool.p_in_use, ap_buf);
+  g_bufpool.stats.in_use_bytes -= class_size;
+  g_bufpool.stats.in_use_buffers--;
+
+  idx = size_class (class_size, &class_size);
+  if (idx >= 0
+      && g_bufpool.stats.cached_bytes + class_size
+           <= g_bufpool.stats.max_cached_bytes)
+    {
+      *(void **) ap_buf = g_bufpool.free_lists[idx];
+      g_bufpool.free_lists[idx] = ap_buf;
+      g_bufpool.stats.cached_bytes += class_size;
+      g_bufpool.stats.cached_buffers++;
+      ap_buf = NULL;
+    }
+  pthread_mutex_unlock (&g_bufpool.mutex);
+
+  if (ap_buf)
+    {
+      system_free (ap_buf, class_size);
+    }
+}
+
+void
+tiz_bufpool_trim (void)
+{
+  (void) pthread_once (&g_bufpool_once, init_bufpool);
+  pthread_mutex_lock (&g_bufpool.mutex);
+  trim_to (0);
+  pthread_mutex_unlock (&g_bufpool.mutex);
+}
+
+void
+tiz_bufpool_get_stats (tiz_bufpool_stats_t * ap_stats)
+{
+  assert (ap_stats);
+  (void) pthread_once (&g_bufpool_once, init_bufpool);
+  pthread_mutex_lock (&g_bufpool.mutex);
+  *ap_stats = g_bufpool.stats;
+  pthread_mutex_unlock (&g_bufpool.mutex);
+}
+
+static void __attribute__ ((destructor)) bufpool_unload (void)
+{
+  if (g_bufpool.enabled)
+    {
+      pthread_mutex_lock (&g_bufpool.mutex);
+      trim_to (0);
+      pthread_mutex_unlock (&g_bufpool.mutex);
+    }
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   tizbufpool.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - Process-wide pool of aligned data buffers.
+ *
+ *
+ */
+
+#ifndef TIZBUFPOOL_H
+#define TIZBUFPOOL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+* @defgroup tizbufpool Process-wide pool of aligned data buffers.
+*
+* A size-classed cache of the data buffers allocated by OpenMAX IL ports. The
+* buffers released by a port are kept for re-use by any port in the process,
+* so that port re-population (e.g. on Idle->Loaded->Idle transitions) doesn't
+* go back to the system allocator. Buffers smaller than a page are cache-line
+* aligned; the rest are page aligned, and optionally backed by transparent
+* huge pages.
+*
+* The pool is configured in the [ilcore] section of tizonia.conf:
+*
+* - buffer-pool.enabled = true | false (Default: true)
+* - buffer-pool.max-cached-mb = maximum amount of memory kept in the pool
+*   while unused (Default: 64)
+* - buffer-pool.zero-buffers = true | false. Zero-fill every buffer handed out,
+*   as calloc did before the pool existed (Default: true)
+* - buffer-pool.hugepages = true | false. Use transparent huge pages for
+*   buffers of 2 MB or more (Default: false)
+*
+* @ingroup libtizplatform
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <OMX_Core.h>
+#include <OMX_Types.h>
+
+  /**
+ * Buffer pool usage statistics.
+ * @ingroup tizbufpool
+ */
+  typedef struct tiz_bufpool_stats tiz_bufpool_stats_t;
+  struct tiz_bufpool_stats
+  {
+    size_t cached_buffers; /**< Buffers kept in the pool, unused */
+    size_t cached_bytes;   /**< Memory kept in the pool, unused */
+    size_t in_use_buffers; /**< Buffers handed out and not yet released */
+    size_t in_use_bytes;   /**< Memory handed out and not yet released */
+    size_t max_cached_bytes; /**< Upper limit of cached_bytes */
+    OMX_U64 hits;   /**< Allocations served from the pool */
+    OMX_U64 misses; /**< Allocations that went to the system allocator */
+  };
+
+  /**
+ * @brief Allocate a buffer of at least @a a_size bytes.
+ *
+ * The contents of the buffer are undefined, unless zero-filling has been
+ * enabled in the configuration.
+ *
+ * @ingroup tizbufpool
+ * @param a_size The minimum size of the buffer, in bytes.
+ * @return The buffer, or NULL if OOM.
+ */
+  OMX_U8 *
+  tiz_bufpool_alloc (const size_t a_size);
+
+  /**
+ * @brief Return a buffer to the pool.
+ *
+ * @ingroup tizbufpool
+ * @param ap_buf A buffer obtained with tiz_bufpool_alloc, or NULL.
+ */
+  void
+  tiz_bufpool_free (OMX_U8 * ap_buf);
+
+  /**
+ * @brief Release all the unused buffers kept in the pool.
+ *
+ * @ingroup tizbufpool
+ */
+  void
+  tiz_bufpool_trim (void);
+
+  /**
+ * @brief Retrieve the pool's usage statistics.
+ *
+ * @ingroup tizbufpool
+ * @param ap_stats On return, the current statistics.
+ */
+  void
+  tiz_bufpool_get_stats (tiz_bufpool_stats_t * ap_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIZBUFPOOL_H */
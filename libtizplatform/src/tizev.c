@@ -35,6 +35,7 @@
 #include <string.h>
 #include <assert.h>
 #include <pthread.h>
+#include <time.h>
 
 #include "tizplatform.h"
 #include "tizplatform_internal.h"
@@ -67,6 +68,9 @@
 
 #define TIZ_EVENT_LOOP_THREAD_NAME "evloop"
 
+/* The resolution of the timer wheel, in ticks per second */
+#define TIZ_EVENT_TIMER_TICKS_PER_SEC 1000
+
 struct tiz_event_io
 {
   ev_io io;
@@ -81,10 +85,12 @@ struct tiz_event_io
 
 struct tiz_event_timer
 {
-  ev_timer timer;
+  tiz_wheel_timer_t node; /* must be the first member */
   tiz_event_timer_cb_f pf_cback;
   void * p_arg0;
   void * p_arg1;
+  double after;
+  double repeat;
   bool once;
   uint32_t id;
   bool started;
@@ -122,6 +128,13 @@ struct tiz_event_loop
   struct ev_loop * p_loop;
   tiz_event_loop_state_t state;
   tiz_rcfile_t * p_rcfile;
+  ev_stat rcfile_watchers[TIZ_RCFILE_NUM_FILES];
+  /* All the timers share one wheel, serviced by a single libev timer */
+  tiz_mutex_t wheel_mutex;
+  tiz_wheel_t * p_wheel;
+  ev_timer wheel_watcher;
+  uint64_t wheel_deadline;
+  bool wheel_rearm;
 };
 
 static pthread_once_t g_event_loop_once = PTHREAD_ONCE_INIT;
@@ -134,11 +147,7 @@ enum tiz_event_loop_msg_class
   ETIZEventLoopMsgIoStop,
   ETIZEventLoopMsgIoDestroy,
   ETIZEventLoopMsgIoAny,
-  ETIZEventLoopMsgTimerStart,
-  ETIZEventLoopMsgTimerRestart,
-  ETIZEventLoopMsgTimerStop,
   ETIZEventLoopMsgTimerDestroy,
-  ETIZEventLoopMsgTimerAny,
   ETIZEventLoopMsgStatStart,
   ETIZEventLoopMsgStatStop,
   ETIZEventLoopMsgStatDestroy,
@@ -188,12 +197,6 @@ do_io_stop (tiz_event_loop_msg_t *);
 static OMX_ERRORTYPE
 do_io_destroy (tiz_event_loop_msg_t *);
 static OMX_ERRORTYPE
-do_timer_start (tiz_event_loop_msg_t *);
-static OMX_ERRORTYPE
-do_timer_restart (tiz_event_loop_msg_t *);
-static OMX_ERRORTYPE
-do_timer_stop (tiz_event_loop_msg_t *);
-static OMX_ERRORTYPE
 do_timer_destroy (tiz_event_loop_msg_t *);
 static OMX_ERRORTYPE
 do_stat_start (tiz_event_loop_msg_t *);
@@ -209,11 +212,7 @@ static const tiz_event_loop_msg_dispatch_f tiz_event_loop_msg_to_fnt_tbl[] = {
   do_io_stop,
   do_io_destroy,
   NULL, /* ETIZEventLoopMsgIoAny, no handler */
-  do_timer_start,
-  do_timer_restart,
-  do_timer_stop,
   do_timer_destroy,
-  NULL, /* ETIZEventLoopMsgTimerAny, no handler */
   do_stat_start,
   do_stat_stop,
   do_stat_destroy,
@@ -235,11 +234,7 @@ static tiz_event_loop_msg_str_t tiz_event_loop_msg_to_str_tbl[] = {
   {ETIZEventLoopMsgIoStop, "ETIZEventLoopMsgIoStop"},
   {ETIZEventLoopMsgIoDestroy, "ETIZEventLoopMsgIoDestroy"},
   {ETIZEventLoopMsgIoAny, "ETIZEventLoopMsgIoAny"},
-  {ETIZEventLoopMsgTimerStart, "ETIZEventLoopMsgTimerStart"},
-  {ETIZEventLoopMsgTimerRestart, "ETIZEventLoopMsgTimerRestart"},
-  {ETIZEventLoopMsgTimerStop, "ETIZEventLoopMsgTimerStop"},
   {ETIZEventLoopMsgTimerDestroy, "ETIZEventLoopMsgTimerDestroy"},
-  {ETIZEventLoopMsgTimerAny, "ETIZEventLoopMsgTimerAny"},
   {ETIZEventLoopMsgStatStart, "ETIZEventLoopMsgStatStart"},
   {ETIZEventLoopMsgStatStop, "ETIZEventLoopMsgStatStop"},
   {ETIZEventLoopMsgStatDestroy, "ETIZEventLoopMsgStatDestroy"},
@@ -290,8 +285,6 @@ init_event_loop_msg (tiz_event_loop_t * ap_event_loop,
       switch (a_msg_class)
         {
           case ETIZEventLoopMsgIoStart:
-          case ETIZEventLoopMsgTimerStart:
-          case ETIZEventLoopMsgTimerRestart:
           case ETIZEventLoopMsgStatStart:
             {
               /* Lowest priority */
@@ -299,7 +292,6 @@ init_event_loop_msg (tiz_event_loop_t * ap_event_loop,
             }
             break;
           case ETIZEventLoopMsgIoStop:
-          case ETIZEventLoopMsgTimerStop:
           case ETIZEventLoopMsgStatStop:
             {
               /* Medium priority */
@@ -377,10 +369,7 @@ enqueue_timer_msg (tiz_event_timer_t * ap_ev_timer, const uint32_t a_id,
   tiz_event_loop_msg_timer_t * p_msg_timer = NULL;
 
   assert (ap_ev_timer);
-  assert (ETIZEventLoopMsgTimerStart == a_class
-          || ETIZEventLoopMsgTimerStop == a_class
-          || ETIZEventLoopMsgTimerRestart == a_class
-          || ETIZEventLoopMsgTimerDestroy == a_class);
+  assert (ETIZEventLoopMsgTimerDestroy == a_class);
 
   tiz_check_omx (tiz_mutex_lock (&(gp_event_loop->mutex)));
   tiz_goto_end_on_null (
@@ -511,49 +500,6 @@ ev_io_msg_dequeue (void * ap_elem, OMX_S32 a_data1, void * ap_data2)
   return rc;
 }
 
-static OMX_BOOL
-ev_timer_msg_dequeue (void * ap_elem, OMX_S32 a_data1, void * ap_data2)
-{
-  OMX_BOOL rc = OMX_FALSE;
-  tiz_event_loop_msg_t * p_msg = ap_elem;
-  const tiz_event_loop_msg_class_t class_to_delete = a_data1;
-  tiz_event_loop_msg_class_t elem_class = ETIZEventLoopMsgMax;
-  bool elem_class_is_timer = false;
-
-  assert (p_msg);
-  assert (ETIZEventLoopMsgTimerStart == class_to_delete
-          || ETIZEventLoopMsgTimerStop == class_to_delete
-          || ETIZEventLoopMsgTimerDestroy == class_to_delete
-          || ETIZEventLoopMsgTimerAny == class_to_delete);
-
-  elem_class = p_msg->class;
-  elem_class_is_timer = (ETIZEventLoopMsgTimerStart == elem_class
-                         || ETIZEventLoopMsgTimerStop == elem_class
-                         || ETIZEventLoopMsgTimerDestroy == elem_class);
-
-  if (class_to_delete == p_msg->class
-      || (elem_class_is_timer && class_to_delete == ETIZEventLoopMsgTimerAny))
-    {
-      tiz_event_loop_msg_timer_t * p_msg_timer = NULL;
-      tiz_event_timer_t * p_ev_timer = NULL;
-      p_msg_timer = &(p_msg->timer);
-      assert (p_msg_timer);
-      p_ev_timer = p_msg_timer->p_ev_timer;
-      assert (p_ev_timer);
-      if (ap_data2 == p_ev_timer)
-        {
-          tiz_event_timer_t * p_ev_timer_needle = ap_data2;
-          if (p_ev_timer_needle->id == p_msg_timer->id)
-            {
-              /* Found, return TRUE so that the msg will be removed from the
-                   queue */
-              rc = OMX_TRUE;
-            }
-        }
-    }
-  return rc;
-}
-
 static OMX_BOOL
 ev_stat_msg_dequeue (void * ap_elem, OMX_S32 a_data1, void * ap_data2)
 {
@@ -695,92 +641,6 @@ do_io_destroy (tiz_event_loop_msg_t * ap_msg)
   return OMX_ErrorNone;
 }
 
-static OMX_ERRORTYPE
-do_timer_start (tiz_event_loop_msg_t * ap_msg)
-{
-  tiz_event_loop_msg_timer_t * p_msg_timer = NULL;
-  tiz_event_timer_t * p_ev_timer = NULL;
-
-  assert (gp_event_loop);
-  assert (ap_msg);
-  assert (ETIZEventLoopStateStarted == gp_event_loop->state);
-
-  p_msg_timer = &(ap_msg->timer);
-  assert (p_msg_timer);
-  p_ev_timer = p_msg_timer->p_ev_timer;
-  assert (p_ev_timer);
-  /* debug: Verify that ids don't get repeated */
-  if (p_ev_timer->id != 0 && p_ev_timer->id == p_msg_timer->id)
-    {
-      assert (p_ev_timer->id != p_msg_timer->id);
-    }
-  p_ev_timer->id = p_msg_timer->id;
-  p_ev_timer->started = true;
-  ev_timer_start (gp_event_loop->p_loop, (ev_timer *) (p_ev_timer));
-
-  return OMX_ErrorNone;
-}
-
-static OMX_ERRORTYPE
-do_timer_restart (tiz_event_loop_msg_t * ap_msg)
-{
-  tiz_event_loop_msg_timer_t * p_msg_timer = NULL;
-  tiz_event_timer_t * p_ev_timer = NULL;
-
-  assert (gp_event_loop);
-  assert (ap_msg);
-  assert (ETIZEventLoopStateStarted == gp_event_loop->state);
-
-  p_msg_timer = &(ap_msg->timer);
-  assert (p_msg_timer);
-  p_ev_timer = p_msg_timer->p_ev_timer;
-  assert (p_ev_timer);
-  /* debug: Verify that ids don't get repeated */
-  if (p_ev_timer->id != 0 && p_ev_timer->id == p_msg_timer->id)
-    {
-      assert (p_ev_timer->id != p_msg_timer->id);
-    }
-  p_ev_timer->id = p_msg_timer->id;
-  p_ev_timer->started = true;
-  ev_timer_again (gp_event_loop->p_loop, (ev_timer *) (p_ev_timer));
-
-  return OMX_ErrorNone;
-}
-
-static OMX_ERRORTYPE
-do_timer_stop (tiz_event_loop_msg_t * ap_msg)
-{
-  tiz_event_loop_msg_timer_t * p_msg_timer = NULL;
-  tiz_event_timer_t * p_ev_timer = NULL;
-
-  assert (gp_event_loop);
-  assert (ap_msg);
-  assert (ETIZEventLoopStateStarted == gp_event_loop->state);
-
-  p_msg_timer = &(ap_msg->timer);
-  assert (p_msg_timer);
-  p_ev_timer = p_msg_timer->p_ev_timer;
-  assert (p_ev_timer);
-  if (p_ev_timer->started)
-    {
-      /* The timer watcher has been started, let's stop it */
-      ev_timer_stop (gp_event_loop->p_loop, (ev_timer *) (p_ev_timer));
-      p_ev_timer->started = false;
-    }
-  else
-    {
-      /* The timer watcher hasn't been started, let's make sure there are no
-           start
-           requests in the queue */
-      const tiz_event_loop_msg_class_t class_to_be_deleted
-        = ETIZEventLoopMsgTimerStart;
-      tiz_pqueue_remove_func (gp_event_loop->p_pq, ev_timer_msg_dequeue,
-                              (OMX_S32) class_to_be_deleted, p_ev_timer);
-    }
-
-  return OMX_ErrorNone;
-}
-
 static OMX_ERRORTYPE
 do_timer_destroy (tiz_event_loop_msg_t * ap_msg)
 {
@@ -795,20 +655,10 @@ do_timer_destroy (tiz_event_loop_msg_t * ap_msg)
   assert (p_msg_timer);
   p_ev_timer = p_msg_timer->p_ev_timer;
   assert (p_ev_timer);
-  if (p_ev_timer->started)
-    {
-      /* The timer watcher has been started, let's stop it */
-      ev_timer_stop (gp_event_loop->p_loop, (ev_timer *) (p_ev_timer));
-    }
-  {
-    /* Now remove any references to this watcher that might be present in the
-           queue */
-    tiz_event_loop_msg_class_t class_to_be_deleted = ETIZEventLoopMsgTimerAny;
-    tiz_pqueue_remove_func (gp_event_loop->p_pq, ev_timer_msg_dequeue,
-                            (OMX_S32) class_to_be_deleted, p_ev_timer);
-  }
 
-  /* And now it should be safe to delete the timer event */
+  /* The timer has already been removed from the wheel. Releasing it here, in
+     the event loop thread, guarantees that its callback is not running. */
+  assert (!tiz_wheel_timer_is_pending (&(p_ev_timer->node)));
   tiz_mem_free (p_ev_timer);
   p_msg_timer->p_ev_timer = NULL;
 
@@ -913,6 +763,113 @@ do_stat_destroy (tiz_event_loop_msg_t * ap_msg)
   return OMX_ErrorNone;
 }
 
+static uint64_t
+now_ticks (void)
+{
+  struct timespec ts;
+  (void) clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * TIZ_EVENT_TIMER_TICKS_PER_SEC
+         + (uint64_t) ts.tv_nsec / (1000000000 / TIZ_EVENT_TIMER_TICKS_PER_SEC);
+}
+
+static uint64_t
+secs_to_ticks (const double a_secs)
+{
+  /* Round up; timers must never fire early */
+  const double ticks = a_secs * TIZ_EVENT_TIMER_TICKS_PER_SEC;
+  uint64_t rounded = 0;
+  if (ticks > 0)
+    {
+      rounded = (uint64_t) ticks;
+      if ((double) rounded < ticks)
+        {
+          ++rounded;
+        }
+    }
+  return rounded;
+}
+
+/* To be called from the event loop thread, with the wheel mutex held */
+static void
+arm_wheel_watcher (tiz_event_loop_t * ap_lp)
+{
+  uint64_t next = 0;
+
+  assert (ap_lp);
+
+  next = tiz_wheel_next_expiry (ap_lp->p_wheel);
+  ap_lp->wheel_deadline = next;
+  ap_lp->wheel_rearm = false;
+  ev_timer_stop (ap_lp->p_loop, &(ap_lp->wheel_watcher));
+  if (UINT64_MAX != next)
+    {
+      const uint64_t now = now_ticks ();
+      ev_timer_set (&(ap_lp->wheel_watcher),
+                    next > now ? (double) (next - now)
+                                   / TIZ_EVENT_TIMER_TICKS_PER_SEC
+                               : 0.,
+                    0.);
+      ev_timer_start (ap_lp->p_loop, &(ap_lp->wheel_watcher));
+    }
+}
+
+static OMX_ERRORTYPE
+schedule_timer (tiz_event_timer_t * ap_ev_timer, const double a_after,
+                const uint32_t a_id)
+{
+  bool wakeup = false;
+  uint64_t now = 0;
+  uint64_t expiry = 0;
+
+  assert (gp_event_loop);
+  assert (ap_ev_timer);
+
+  tiz_check_omx (tiz_mutex_lock (&(gp_event_loop->wheel_mutex)));
+  now = now_ticks ();
+  if (0 == tiz_wheel_count (gp_event_loop->p_wheel))
+    {
+      /* The wheel is not advanced while empty; bring it up to date */
+      (void) tiz_wheel_expire (gp_event_loop->p_wheel, now - 1);
+    }
+  /* The current tick is partly elapsed; one more makes sure the timer never
+     fires early */
+  expiry = now + secs_to_ticks (a_after) + (a_after > 0 ? 1 : 0);
+  ap_ev_timer->id = a_id;
+  ap_ev_timer->started = true;
+  tiz_wheel_add (gp_event_loop->p_wheel, &(ap_ev_timer->node), expiry);
+  if (expiry < gp_event_loop->wheel_deadline)
+    {
+      /* The wheel's libev timer needs to be brought forward. This is the only
+         case that requires the event loop thread's attention. */
+      gp_event_loop->wheel_deadline = expiry;
+      gp_event_loop->wheel_rearm = true;
+      wakeup = true;
+    }
+  tiz_check_omx (tiz_mutex_unlock (&(gp_event_loop->wheel_mutex)));
+
+  if (wakeup)
+    {
+      ev_async_send (gp_event_loop->p_loop, gp_event_loop->p_async_watcher);
+    }
+
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+unschedule_timer (tiz_event_timer_t * ap_ev_timer)
+{
+  assert (gp_event_loop);
+  assert (ap_ev_timer);
+
+  /* If this leaves the wheel's libev timer armed too early, it will just
+     find nothing to do */
+  tiz_check_omx (tiz_mutex_lock (&(gp_event_loop->wheel_mutex)));
+  tiz_wheel_remove (gp_event_loop->p_wheel, &(ap_ev_timer->node));
+  ap_ev_timer->started = false;
+  tiz_check_omx (tiz_mutex_unlock (&(gp_event_loop->wheel_mutex)));
+  return OMX_ErrorNone;
+}
+
 static void
 async_watcher_cback (struct ev_loop * ap_loop, ev_async * ap_watcher,
                      int a_revents)
@@ -946,6 +903,15 @@ async_watcher_cback (struct ev_loop * ap_loop, ev_async * ap_watcher,
               tiz_soa_free (gp_event_loop->p_soa, p_msg);
             }
           (void) tiz_mutex_unlock (&(gp_event_loop->mutex));
+
+          /* A timer may have been scheduled earlier than the wheel's
+             deadline */
+          (void) tiz_mutex_lock (&(gp_event_loop->wheel_mutex));
+          if (gp_event_loop->wheel_rearm)
+            {
+              arm_wheel_watcher (gp_event_loop);
+            }
+          (void) tiz_mutex_unlock (&(gp_event_loop->wheel_mutex));
         }
     }
 }
@@ -973,19 +939,52 @@ io_watcher_cback (struct ev_loop * ap_loop, ev_io * ap_watcher, int a_revents)
 }
 
 static void
-timer_watcher_cback (struct ev_loop * ap_loop, ev_timer * ap_watcher,
+wheel_watcher_cback (struct ev_loop * ap_loop, ev_timer * ap_watcher,
                      int a_revents)
 {
   (void) ap_loop;
+  (void) ap_watcher;
   (void) a_revents;
 
   if (gp_event_loop)
     {
-      tiz_event_timer_t * p_timer_event = (tiz_event_timer_t *) ap_watcher;
-      assert (p_timer_event);
-      assert (p_timer_event->pf_cback);
-      p_timer_event->pf_cback (p_timer_event->p_arg0, p_timer_event,
-                               p_timer_event->p_arg1, p_timer_event->id);
+      tiz_wheel_timer_t * p_node = NULL;
+      const uint64_t now = now_ticks ();
+
+      (void) tiz_mutex_lock (&(gp_event_loop->wheel_mutex));
+      while ((p_node = tiz_wheel_expire (gp_event_loop->p_wheel, now)))
+        {
+          tiz_event_timer_t * p_timer_event = (tiz_event_timer_t *) p_node;
+          tiz_event_timer_cb_f pf_cback = p_timer_event->pf_cback;
+          void * p_arg0 = p_timer_event->p_arg0;
+          void * p_arg1 = p_timer_event->p_arg1;
+          const uint32_t id = p_timer_event->id;
+
+          assert (pf_cback);
+
+          if (p_timer_event->once)
+            {
+              p_timer_event->started = false;
+            }
+          else
+            {
+              /* Re-arm relative to the scheduled time, so that repeating
+                 timers don't drift */
+              const uint64_t repeat
+                = MAX (secs_to_ticks (p_timer_event->repeat), 1);
+              tiz_wheel_add (gp_event_loop->p_wheel, p_node,
+                             MAX (p_node->expiry + repeat, now + 1));
+            }
+
+          /* The timer may be stopped or restarted from the callback, or from
+             any other thread, while the mutex is released. It can't be
+             released though, as that happens in this thread. */
+          (void) tiz_mutex_unlock (&(gp_event_loop->wheel_mutex));
+          pf_cback (p_arg0, p_timer_event, p_arg1, id);
+          (void) tiz_mutex_lock (&(gp_event_loop->wheel_mutex));
+        }
+      arm_wheel_watcher (gp_event_loop);
+      (void) tiz_mutex_unlock (&(gp_event_loop->wheel_mutex));
     }
 }
 
@@ -1006,6 +1005,44 @@ stat_watcher_cback (struct ev_loop * ap_loop, ev_stat * ap_watcher,
     }
 }
 
+static void
+rcfile_watcher_cback (struct ev_loop * ap_loop, ev_stat * ap_watcher,
+                      int a_revents)
+{
+  (void) ap_loop;
+  (void) a_revents;
+
+  if (gp_event_loop && gp_event_loop->p_rcfile)
+    {
+      assert (ap_watcher);
+      TIZ_LOG (TIZ_PRIORITY_DEBUG, "[%s] changed; reloading...",
+               ap_watcher->path);
+      (void) tiz_rcfile_reload (gp_event_loop->p_rcfile);
+    }
+}
+
+static void
+start_rcfile_watchers (tiz_event_loop_t * ap_lp)
+{
+  int i = 0;
+  assert (ap_lp);
+  assert (ap_lp->p_loop);
+
+  /* Watch all the locations, as a file with higher priority may appear */
+  for (i = 0; i < TIZ_RCFILE_NUM_FILES; ++i)
+    {
+      const char * p_path = tiz_rcfile_get_path (i);
+      if (p_path && '\0' != p_path[0])
+        {
+          ev_stat_init (&(ap_lp->rcfile_watchers[i]), rcfile_watcher_cback,
+                        p_path, 0.);
+          ev_stat_start (ap_lp->p_loop, &(ap_lp->rcfile_watchers[i]));
+          /* These watchers must not keep the loop alive */
+          ev_unref (ap_lp->p_loop);
+        }
+    }
+}
+
 static void *
 event_loop_thread_func (void * p_arg)
 {
@@ -1071,6 +1108,18 @@ clean_up_thread_data (tiz_event_loop_t * ap_lp)
           ap_lp->p_soa = NULL;
         }
 
+      if (ap_lp->p_wheel)
+        {
+          tiz_wheel_destroy (ap_lp->p_wheel);
+          ap_lp->p_wheel = NULL;
+        }
+
+      if (ap_lp->wheel_mutex)
+        {
+          (void) tiz_mutex_destroy (&(ap_lp->wheel_mutex));
+          ap_lp->wheel_mutex = NULL;
+        }
+
       tiz_mem_free (gp_event_loop);
       gp_event_loop = NULL;
     }
@@ -1136,12 +1185,26 @@ init_event_loop_thread (void)
                          gp_event_loop->p_soa, TIZ_EVENT_LOOP_THREAD_NAME),
         "Error initializing pqueue.");
 
+      /* Init the timer wheel */
+      tiz_goto_end_on_omx_err (tiz_mutex_init (&(gp_event_loop->wheel_mutex)),
+                               "Error initializing mutex.");
+      tiz_goto_end_on_omx_err (
+        tiz_wheel_init (&(gp_event_loop->p_wheel), now_ticks ()),
+        "Error initializing the timer wheel.");
+      gp_event_loop->wheel_deadline = UINT64_MAX;
+      gp_event_loop->wheel_rearm = false;
+      ev_timer_init (&(gp_event_loop->wheel_watcher), wheel_watcher_cback, 0.,
+                     0.);
+
       /* All good */
       rc = OMX_ErrorNone;
 
       ev_async_init (gp_event_loop->p_async_watcher, async_watcher_cback);
       ev_async_start (gp_event_loop->p_loop, gp_event_loop->p_async_watcher);
 
+      /* Reload the configuration file when it changes */
+      start_rcfile_watchers (gp_event_loop);
+
       assert (gp_event_loop);
     }
 
@@ -1307,13 +1370,15 @@ tiz_event_timer_init (tiz_event_timer_t ** app_ev_timer, void * ap_arg0,
   if ((p_ev_timer
        = (tiz_event_timer_t *) tiz_mem_calloc (1, sizeof (tiz_event_timer_t))))
     {
+      tiz_wheel_timer_init (&(p_ev_timer->node));
       p_ev_timer->pf_cback = ap_cback;
       p_ev_timer->p_arg0 = ap_arg0;
       p_ev_timer->p_arg1 = ap_arg1;
-      p_ev_timer->once = false;
+      p_ev_timer->after = 0.;
+      p_ev_timer->repeat = 0.;
+      p_ev_timer->once = true;
       p_ev_timer->id = 0;
       p_ev_timer->started = false;
-      ev_init ((ev_timer *) p_ev_timer, timer_watcher_cback);
       rc = OMX_ErrorNone;
     }
 
@@ -1328,8 +1393,11 @@ tiz_event_timer_set (tiz_event_timer_t * ap_ev_timer, double a_after,
 {
   assert (ap_ev_timer);
   (void) get_event_loop ();
+  (void) tiz_mutex_lock (&(gp_event_loop->wheel_mutex));
   ap_ev_timer->once = a_repeat ? false : true;
-  ev_timer_set ((ev_timer *) ap_ev_timer, a_after, a_repeat);
+  ap_ev_timer->after = a_after;
+  ap_ev_timer->repeat = a_repeat;
+  (void) tiz_mutex_unlock (&(gp_event_loop->wheel_mutex));
 }
 
 OMX_ERRORTYPE
@@ -1337,7 +1405,7 @@ tiz_event_timer_start (tiz_event_timer_t * ap_ev_timer, const uint32_t a_id)
 {
   assert (ap_ev_timer);
   (void) get_event_loop ();
-  return enqueue_timer_msg (ap_ev_timer, a_id, ETIZEventLoopMsgTimerStart);
+  return schedule_timer (ap_ev_timer, ap_ev_timer->after, a_id);
 }
 
 OMX_ERRORTYPE
@@ -1345,7 +1413,13 @@ tiz_event_timer_restart (tiz_event_timer_t * ap_ev_timer, const uint32_t a_id)
 {
   assert (ap_ev_timer);
   (void) get_event_loop ();
-  return enqueue_timer_msg (ap_ev_timer, a_id, ETIZEventLoopMsgTimerRestart);
+  /* Same semantics as ev_timer_again: a repeating timer is (re)started with
+     its repeat value; a non-repeating timer is stopped */
+  if (ap_ev_timer->once)
+    {
+      return unschedule_timer (ap_ev_timer);
+    }
+  return schedule_timer (ap_ev_timer, ap_ev_timer->repeat, a_id);
 }
 
 OMX_ERRORTYPE
@@ -1353,8 +1427,7 @@ tiz_event_timer_stop (tiz_event_timer_t * ap_ev_timer)
 {
   assert (ap_ev_timer);
   (void) get_event_loop ();
-  return enqueue_timer_msg (ap_ev_timer, ap_ev_timer->id,
-                            ETIZEventLoopMsgTimerStop);
+  return unschedule_timer (ap_ev_timer);
 }
 
 bool
@@ -1370,6 +1443,7 @@ tiz_event_timer_destroy (tiz_event_timer_t * ap_ev_timer)
   if (ap_ev_timer)
     {
       (void) get_event_loop ();
+      (void) unschedule_timer (ap_ev_timer);
       (void) enqueue_timer_msg (ap_ev_timer, ap_ev_timer->id,
                                 ETIZEventLoopMsgTimerDestroy);
     }
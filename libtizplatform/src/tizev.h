@@ -39,6 +39,10 @@ extern "C"
  *
  * Global event loop, async io and timers.
  *
+ * Timers have a resolution of one millisecond. They are kept in a single
+ * timer wheel (see @ref tizwheel), so starting, restarting and stopping a
+ * timer doesn't require a round trip to the event loop thread.
+ *
  * @ingroup libtizplatform
  */
 
@@ -0,0 +1,342 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   tizicy.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia Platform - HTTP response header and ICY metadata parsing
+ *
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#define _GNU_SOURCE
+
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include <strings.h>
+
+#include "tizmem.h"
+#include "tizlog.h"
+#include "tizmacros.h"
+#include "tizicy.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.platform.icy"
+#endif
+
+#define TIZ_ICY_STREAM_TITLE "StreamTitle='"
+#define TIZ_ICY_STREAM_TITLE_LEN (sizeof (TIZ_ICY_STREAM_TITLE) - 1)
+
+typedef enum tiz_icy_state tiz_icy_state_t;
+enum tiz_icy_state
+{
+  ETIZIcyStateAudio,
+  ETIZIcyStateLength,
+  ETIZIcyStateMetadata
+};
+
+struct tiz_icy
+{
+  size_t metaint;
+  size_t audio_left;
+  size_t meta_left;
+  size_t meta_fill;
+  tiz_icy_state_t state;
+  bool new_title;
+  char meta[TIZ_ICY_MAX_METADATA_SIZE + 1];
+  char title[TIZ_ICY_MAX_METADATA_SIZE + 1];
+};
+
+static inline bool
+is_blank (const char c)
+{
+  return (unsigned char) c <= 0x20;
+}
+
+/* The delimiter searches below rely on memchr and memmem, which the C
+   library implements with vector instructions where available */
+bool
+tiz_http_header_parse (const char * ap_line, const size_t a_len,
+                       tiz_http_header_t * ap_hdr)
+{
+  const char * p_colon = NULL;
+  const char * p_end = NULL;
+  const char * p_value = NULL;
+  const char * p_name_end = NULL;
+
+  assert (ap_line);
+  assert (ap_hdr);
+
+  if (!(p_colon = memchr (ap_line, ':', a_len)) || p_colon == ap_line)
+    {
+      return false;
+    }
+
+  p_name_end = p_colon;
+  while (p_name_end > ap_line && is_blank (p_name_end[-1]))
+    {
+      --p_name_end;
+    }
+
+  p_value = p_colon + 1;
+  p_end = ap_line + a_len;
+  while (p_value < p_end && is_blank (*p_value))
+    {
+      ++p_value;
+    }
+  while (p_end > p_value && is_blank (p_end[-1]))
+    {
+      --p_end;
+    }
+
+  ap_hdr->p_name = ap_line;
+  ap_hdr->name_len = p_name_end - ap_line;
+  ap_hdr->p_value = p_value;
+  ap_hdr->value_len = p_end - p_value;
+  return (ap_hdr->name_len > 0);
+}
+
+bool
+tiz_http_header_is (const tiz_http_header_t * ap_hdr, const char * ap_name)
+{
+  assert (ap_hdr);
+  assert (ap_name);
+  return (strlen (ap_name) == ap_hdr->name_len
+          && strncasecmp (ap_hdr->p_name, ap_name, ap_hdr->name_len) == 0);
+}
+
+char *
+tiz_http_header_value (const tiz_http_header_t * ap_hdr, char * ap_dst,
+                       const size_t a_dst_size)
+{
+  size_t len = 0;
+  assert (ap_hdr);
+  assert (ap_dst);
+  assert (a_dst_size > 0);
+  len = MIN (ap_hdr->value_len, a_dst_size - 1);
+  memcpy (ap_dst, ap_hdr->p_value, len);
+  ap_dst[len] = '\0';
+  return ap_dst;
+}
+
+long
+tiz_http_header_int (const tiz_http_header_t * ap_hdr)
+{
+  long val = 0;
+  size_t i = 0;
+  assert (ap_hdr);
+
+  if (0 == ap_hdr->value_len)
+    {
+      return -1;
+    }
+
+  for (i = 0; i < ap_hdr->value_len; ++i)
+    {
+      const char c = ap_hdr->p_value[i];
+      if (c < '0' || c > '9' || val > (LONG_MAX - 9) / 10)
+        {
+          return -1;
+        }
+      val = val * 10 + (c - '0');
+    }
+  return val;
+}
+
+static void
+parse_metadata (tiz_icy_t * ap_icy)
+{
+  const char * p_start = NULL;
+  const char * p_end = NULL;
+  const char * p_meta_end = NULL;
+  size_t len = 0;
+
+  assert (ap_icy);
+
+  /* The block is NUL-padded to a multiple of 16 bytes */
+  ap_icy->meta[ap_icy->meta_fill] = '\0';
+  p_meta_end = ap_icy->meta + strlen (ap_icy->meta);
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "ICY metadata [%s]", ap_icy->meta);
+
+  if (!(p_start = memmem (ap_icy->meta, p_meta_end - ap_icy->meta,
+                          TIZ_ICY_STREAM_TITLE, TIZ_ICY_STREAM_TITLE_LEN)))
+    {
+      return;
+    }
+
+  p_start += TIZ_ICY_STREAM_TITLE_LEN;
+
+  /* Titles may contain single quotes; the field ends at "';" (or at the last
+     quote, for servers that omit the final semicolon) */
+  if (!(p_end = memmem (p_start, p_meta_end - p_start, "';", 2))
+      && !(p_end = memrchr (p_start, '\'', p_meta_end - p_start)))
+    {
+      return;
+    }
+
+  len = p_end - p_start;
+  if (len != strlen (ap_icy->title) || memcmp (ap_icy->title, p_start, len))
+    {
+      memcpy (ap_icy->title, p_start, len);
+      ap_icy->title[len] = '\0';
+      ap_icy->new_title = true;
+    }
+}
+
+OMX_ERRORTYPE
+tiz_icy_init (tiz_icy_ptr_t * app_icy, const size_t a_metaint)
+{
+  tiz_icy_t * p_icy = NULL;
+
+  assert (app_icy);
+
+  if (0 == a_metaint)
+    {
+      return OMX_ErrorBadParameter;
+    }
+
+  if (!(p_icy = (tiz_icy_t *) tiz_mem_calloc (1, sizeof (tiz_icy_t))))
+    {
+      return OMX_ErrorInsufficientResources;
+    }
+
+  tiz_icy_reset (p_icy, a_metaint);
+  *app_icy = p_icy;
+  return OMX_ErrorNone;
+}
+
+void
+tiz_icy_destroy (tiz_icy_t * ap_icy)
+{
+  tiz_mem_free (ap_icy);
+}
+
+void
+tiz_icy_reset (tiz_icy_t * ap_icy, const size_t a_metaint)
+{
+  assert (ap_icy);
+  assert (a_metaint > 0);
+  ap_icy->metaint = a_metaint;
+  ap_icy->audio_left = a_metaint;
+  ap_icy->meta_left = 0;
+  ap_icy->meta_fill = 0;
+  ap_icy->state = ETIZIcyStateAudio;
+  ap_icy->new_title = false;
+  ap_icy->title[0] = '\0';
+}
+
+size_t
+tiz_icy_audio_ahead (const tiz_icy_t * ap_icy)
+{
+  assert (ap_icy);
+  return (ETIZIcyStateAudio == ap_icy->state ? ap_icy->audio_left : 0);
+}
+
+size_t
+tiz_icy_demux (tiz_icy_t * ap_icy, const OMX_U8 * ap_data, const size_t a_len,
+               size_t * ap_audio_len)
+{
+  size_t nbytes = 0;
+
+  assert (ap_icy);
+  assert (ap_data);
+  assert (ap_audio_len);
+
+  *ap_audio_len = 0;
+
+  if (0 == a_len)
+    {
+      return 0;
+    }
+
+  switch (ap_icy->state)
+    {
+      case ETIZIcyStateAudio:
+        {
+          nbytes = MIN (a_len, ap_icy->audio_left);
+          ap_icy->audio_left -= nbytes;
+          *ap_audio_len = nbytes;
+          if (0 == ap_icy->audio_left)
+            {
+              ap_icy->state = ETIZIcyStateLength;
+            }
+        }
+        break;
+
+      case ETIZIcyStateLength:
+        {
+          nbytes = 1;
+          ap_icy->meta_left = ap_data[0] * 16;
+          ap_icy->meta_fill = 0;
+          if (ap_icy->meta_left > 0)
+            {
+              ap_icy->state = ETIZIcyStateMetadata;
+            }
+          else
+            {
+              /* No metadata in this interval */
+              ap_icy->audio_left = ap_icy->metaint;
+              ap_icy->state = ETIZIcyStateAudio;
+            }
+        }
+        break;
+
+      case ETIZIcyStateMetadata:
+        {
+          nbytes = MIN (a_len, ap_icy->meta_left);
+          assert (ap_icy->meta_fill + nbytes <= TIZ_ICY_MAX_METADATA_SIZE);
+          memcpy (ap_icy->meta + ap_icy->meta_fill, ap_data, nbytes);
+          ap_icy->meta_fill += nbytes;
+          ap_icy->meta_left -= nbytes;
+          if (0 == ap_icy->meta_left)
+            {
+              parse_metadata (ap_icy);
+              ap_icy->audio_left = ap_icy->metaint;
+              ap_icy->state = ETIZIcyStateAudio;
+            }
+        }
+        break;
+
+      default:
+        assert (0);
+        break;
+    };
+
+  return nbytes;
+}
+
+const char *
+tiz_icy_take_title (tiz_icy_t * ap_icy)
+{
+  assert (ap_icy);
+  if (ap_icy->new_title)
+    {
+      ap_icy->new_title = false;
+      return ap_icy->title;
+    }
+  return NULL;
+}
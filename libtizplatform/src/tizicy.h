@@ -0,0 +1,192 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   tizicy.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia Platform - HTTP response header and ICY metadata parsing
+ *
+ *
+ */
+
+#ifndef TIZICY_H
+#define TIZICY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+* @defgroup tizicy HTTP response header and ICY metadata parsing
+*
+* Helpers to split HTTP/ICY response header lines, and a demultiplexer for
+* the in-band metadata blocks that Icecast/Shoutcast servers interleave with
+* the audio data when the client sends 'Icy-MetaData:1'.
+*
+* The demultiplexer never copies the audio payload: it only reports where the
+* audio spans are in the data passed in. Only the metadata bytes are kept.
+*
+* @ingroup libtizplatform
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <OMX_Types.h>
+
+  /**
+ * The maximum size of an ICY metadata block (255 * 16 bytes).
+ * @ingroup tizicy
+ */
+#define TIZ_ICY_MAX_METADATA_SIZE 4080
+
+  /**
+ * A header line, split into trimmed name and value. The pointers point into
+ * the line that was parsed; the strings are not zero-terminated.
+ * @ingroup tizicy
+ */
+  typedef struct tiz_http_header tiz_http_header_t;
+  struct tiz_http_header
+  {
+    const char * p_name;
+    size_t name_len;
+    const char * p_value;
+    size_t value_len;
+  };
+
+  /**
+ * @brief Split a header line ("Name: value\r\n") into name and value.
+ *
+ * @ingroup tizicy
+ * @param ap_line The header line (need not be zero-terminated).
+ * @param a_len The length of the line.
+ * @param ap_hdr On return, the name and value spans.
+ * @return false if the line isn't a header line (e.g. the status line).
+ */
+  bool
+  tiz_http_header_parse (const char * ap_line, const size_t a_len,
+                         tiz_http_header_t * ap_hdr);
+
+  /**
+ * @brief Case-insensitive comparison of a header's name.
+ *
+ * @ingroup tizicy
+ */
+  bool
+  tiz_http_header_is (const tiz_http_header_t * ap_hdr, const char * ap_name);
+
+  /**
+ * @brief Copy a header's value to a zero-terminated string.
+ *
+ * @ingroup tizicy
+ * @param ap_hdr The parsed header.
+ * @param ap_dst The destination buffer.
+ * @param a_dst_size The size of the destination buffer. The value is
+ * truncated if needed.
+ * @return ap_dst.
+ */
+  char *
+  tiz_http_header_value (const tiz_http_header_t * ap_hdr, char * ap_dst,
+                         const size_t a_dst_size);
+
+  /**
+ * @brief Parse a header's value as a decimal integer.
+ *
+ * @ingroup tizicy
+ * @return The value, or -1 if the value is not a valid non-negative integer.
+ */
+  long
+  tiz_http_header_int (const tiz_http_header_t * ap_hdr);
+
+  /**
+ * ICY metadata demultiplexer opaque structure.
+ * @ingroup tizicy
+ */
+  typedef struct tiz_icy tiz_icy_t;
+  typedef /*@null@ */ tiz_icy_t * tiz_icy_ptr_t;
+
+  /**
+ * @brief Initialise a demultiplexer.
+ *
+ * @ingroup tizicy
+ * @param app_icy On return, the demultiplexer.
+ * @param a_metaint The number of audio bytes between metadata blocks, as
+ * found in the 'icy-metaint' response header.
+ * @return OMX_ErrorNone, OMX_ErrorBadParameter if a_metaint is 0, or
+ * OMX_ErrorInsufficientResources if OOM.
+ */
+  OMX_ERRORTYPE
+  tiz_icy_init (tiz_icy_ptr_t * app_icy, const size_t a_metaint);
+
+  void
+  tiz_icy_destroy (tiz_icy_t * ap_icy);
+
+  /**
+ * @brief Reset the demultiplexer to the start of a new stream.
+ *
+ * @ingroup tizicy
+ */
+  void
+  tiz_icy_reset (tiz_icy_t * ap_icy, const size_t a_metaint);
+
+  /**
+ * @brief The number of audio bytes expected before the next metadata block.
+ *
+ * @ingroup tizicy
+ * @return The number of bytes, or 0 if a metadata block is being read.
+ */
+  size_t
+  tiz_icy_audio_ahead (const tiz_icy_t * ap_icy);
+
+  /**
+ * @brief Consume the leading run of audio or metadata bytes in a chunk of
+ * stream data.
+ *
+ * Call repeatedly, advancing the data pointer by the returned amount, until
+ * the whole chunk has been consumed.
+ *
+ * @ingroup tizicy
+ * @param ap_icy The demultiplexer.
+ * @param ap_data The stream data.
+ * @param a_len The length of the data.
+ * @param ap_audio_len On return, the number of audio bytes at the start of
+ * ap_data (equal to the return value), or 0 if metadata bytes were consumed.
+ * @return The number of bytes consumed.
+ */
+  size_t
+  tiz_icy_demux (tiz_icy_t * ap_icy, const OMX_U8 * ap_data,
+                 const size_t a_len, size_t * ap_audio_len);
+
+  /**
+ * @brief Retrieve the stream title, if it has changed since the last call.
+ *
+ * @ingroup tizicy
+ * @return The zero-terminated title, or NULL if there is no new title. The
+ * string is owned by the demultiplexer.
+ */
+  const char *
+  tiz_icy_take_title (tiz_icy_t * ap_icy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIZICY_H */
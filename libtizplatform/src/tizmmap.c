@@ -0,0 +1,402 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   tizmmap.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia Platform - Memory-mapped sequential file input
+ *
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/vfs.h>
+
+#include "tizmem.h"
+#include "tizlog.h"
+#include "tizmacros.h"
+#include "tizmmap.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.platform.mmap"
+#endif
+
+/* Amount of data the kernel is asked to page in ahead of the current
+   position */
+#define TIZ_MMAP_READAHEAD_SIZE (1024 * 1024)
+
+/* Remote file systems where a mapping may fault (SIGBUS) if the file changes
+   or the server goes away; these are read through stdio instead. */
+#define TIZ_MMAP_NFS_SUPER_MAGIC 0x6969
+#define TIZ_MMAP_SMB_SUPER_MAGIC 0x517B
+#define TIZ_MMAP_CIFS_MAGIC_NUMBER 0xFF534D42
+#define TIZ_MMAP_SMB2_MAGIC_NUMBER 0xFE534D42
+#define TIZ_MMAP_FUSE_SUPER_MAGIC 0x65735546
+#define TIZ_MMAP_V9FS_MAGIC 0x01021997
+#define TIZ_MMAP_CODA_SUPER_MAGIC 0x73757245
+#define TIZ_MMAP_AFS_SUPER_MAGIC 0x5346414F
+
+struct tiz_mmap
+{
+  int fd;
+  FILE * p_file;
+  OMX_U8 * p_data;
+  size_t map_size;
+  size_t size;
+  size_t pos;
+  size_t readahead_pos;
+  bool eof;
+};
+
+static bool
+is_remote_fs (const int a_fd)
+{
+  struct statfs fs;
+  if (fstatfs (a_fd, &fs) != 0)
+    {
+      return true;
+    }
+
+  switch ((unsigned long) fs.f_type)
+    {
+      case TIZ_MMAP_NFS_SUPER_MAGIC:
+      case TIZ_MMAP_SMB_SUPER_MAGIC:
+      case TIZ_MMAP_CIFS_MAGIC_NUMBER:
+      case TIZ_MMAP_SMB2_MAGIC_NUMBER:
+      case TIZ_MMAP_FUSE_SUPER_MAGIC:
+      case TIZ_MMAP_V9FS_MAGIC:
+      case TIZ_MMAP_CODA_SUPER_MAGIC:
+      case TIZ_MMAP_AFS_SUPER_MAGIC:
+        return true;
+      default:
+        return false;
+    };
+}
+
+static void
+map_file (tiz_mmap_t * ap_map)
+{
+  struct stat st;
+  void * p_data = NULL;
+
+  assert (ap_map);
+
+  if (fstat (ap_map->fd, &st) != 0 || !S_ISREG (st.st_mode) || st.st_size <= 0
+      || (OMX_U64) st.st_size > (OMX_U64) ((size_t) -1)
+      || is_remote_fs (ap_map->fd))
+    {
+      return;
+    }
+
+  /* A read-only mapping; consumers that need to modify the data must work on
+     a copy of it (see tiz_mmap_read) */
+  p_data = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, ap_map->fd, 0);
+  if (MAP_FAILED == p_data)
+    {
+      TIZ_LOG (TIZ_PRIORITY_NOTICE, "mmap failed (%s); using stdio",
+               strerror (errno));
+      return;
+    }
+
+  (void) madvise (p_data, st.st_size, MADV_SEQUENTIAL);
+  ap_map->p_data = p_data;
+  ap_map->map_size = st.st_size;
+  ap_map->size = st.st_size;
+}
+
+static void
+clamp_to_file_size (tiz_mmap_t * ap_map)
+{
+  struct stat st;
+  assert (ap_map);
+  assert (ap_map->p_data);
+
+  /* Touching the pages of the mapping that lie past the end of a file that
+     has been truncated raises SIGBUS. The file size is re-checked before
+     each access to the mapping, and the readable size is reduced
+     accordingly. */
+  if (fstat (ap_map->fd, &st) == 0 && st.st_size >= 0
+      && (OMX_U64) st.st_size < (OMX_U64) ap_map->size)
+    {
+      TIZ_LOG (TIZ_PRIORITY_NOTICE, "file truncated [%zu] -> [%lld]",
+               ap_map->size, (long long) st.st_size);
+      ap_map->size = (size_t) st.st_size;
+      ap_map->pos = MIN (ap_map->pos, ap_map->size);
+    }
+}
+
+static void
+readahead_hint (tiz_mmap_t * ap_map)
+{
+  assert (ap_map);
+  assert (ap_map->p_data);
+
+  /* Ask for the next window once the previous one has started to be
+     consumed */
+  if (ap_map->pos >= ap_map->readahead_pos
+      || 0 == ap_map->readahead_pos)
+    {
+      const long page_size = sysconf (_SC_PAGESIZE);
+      const size_t start
+        = ap_map->pos - (ap_map->pos % (page_size > 0 ? page_size : 4096));
+      size_t len = TIZ_MMAP_READAHEAD_SIZE;
+      if (start >= ap_map->size)
+        {
+          return;
+        }
+      if (start + len > ap_map->size)
+        {
+          len = ap_map->size - start;
+        }
+      (void) madvise (ap_map->p_data + start, len, MADV_WILLNEED);
+      ap_map->readahead_pos = start + len / 2;
+    }
+}
+
+OMX_ERRORTYPE
+tiz_mmap_init (tiz_mmap_ptr_t * app_map, const char * ap_path)
+{
+  tiz_mmap_t * p_map = NULL;
+
+  assert (app_map);
+  assert (ap_path);
+
+  if (!(p_map = (tiz_mmap_t *) tiz_mem_calloc (1, sizeof (tiz_mmap_t))))
+    {
+      return OMX_ErrorInsufficientResources;
+    }
+
+  if ((p_map->fd = open (ap_path, O_RDONLY)) < 0)
+    {
+      TIZ_LOG (TIZ_PRIORITY_ERROR, "Unable to open [%s] (%s)", ap_path,
+               strerror (errno));
+      tiz_mem_free (p_map);
+      return OMX_ErrorContentURIError;
+    }
+
+  map_file (p_map);
+
+  if (!p_map->p_data)
+    {
+      /* Fallback: buffered reads */
+      if (!(p_map->p_file = fdopen (p_map->fd, "r")))
+        {
+          close (p_map->fd);
+          tiz_mem_free (p_map);
+          return OMX_ErrorInsufficientResources;
+        }
+      (void) posix_fadvise (p_map->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+  else
+    {
+      readahead_hint (p_map);
+    }
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "[%s] mapped [%s] size [%zu]", ap_path,
+           p_map->p_data ? "YES" : "NO", p_map->size);
+
+  *app_map = p_map;
+  return OMX_ErrorNone;
+}
+
+void
+tiz_mmap_destroy (tiz_mmap_t * ap_map)
+{
+  if (ap_map)
+    {
+      if (ap_map->p_data)
+        {
+          (void) munmap (ap_map->p_data, ap_map->map_size);
+          close (ap_map->fd);
+        }
+      else if (ap_map->p_file)
+        {
+          /* This closes the descriptor too */
+          fclose (ap_map->p_file);
+        }
+      tiz_mem_free (ap_map);
+    }
+}
+
+bool
+tiz_mmap_is_mapped (const tiz_mmap_t * ap_map)
+{
+  assert (ap_map);
+  return (NULL != ap_map->p_data);
+}
+
+int
+tiz_mmap_fd (const tiz_mmap_t * ap_map)
+{
+  assert (ap_map);
+  return ap_map->fd;
+}
+
+long
+tiz_mmap_size (const tiz_mmap_t * ap_map)
+{
+  struct stat st;
+  assert (ap_map);
+  if (ap_map->p_data)
+    {
+      return (long) ap_map->size;
+    }
+  return ((fstat (ap_map->fd, &st) == 0 && S_ISREG (st.st_mode))
+            ? (long) st.st_size
+            : -1);
+}
+
+size_t
+tiz_mmap_read (tiz_mmap_t * ap_map, void * ap_dst, const size_t a_nbytes)
+{
+  size_t nbytes = 0;
+  assert (ap_map);
+  assert (ap_dst);
+
+  if (ap_map->p_data)
+    {
+      clamp_to_file_size (ap_map);
+      nbytes = MIN (a_nbytes, ap_map->size - ap_map->pos);
+      memcpy (ap_dst, ap_map->p_data + ap_map->pos, nbytes);
+      (void) tiz_mmap_advance (ap_map, nbytes);
+    }
+  else
+    {
+      nbytes = fread (ap_dst, 1, a_nbytes, ap_map->p_file);
+      ap_map->eof = (feof (ap_map->p_file) != 0);
+    }
+
+  return nbytes;
+}
+
+const OMX_U8 *
+tiz_mmap_get (tiz_mmap_t * ap_map, size_t * ap_avail)
+{
+  assert (ap_map);
+  assert (ap_avail);
+
+  if (!ap_map->p_data)
+    {
+      *ap_avail = 0;
+      return NULL;
+    }
+
+  clamp_to_file_size (ap_map);
+  *ap_avail = ap_map->size - ap_map->pos;
+  return ap_map->p_data + ap_map->pos;
+}
+
+size_t
+tiz_mmap_advance (tiz_mmap_t * ap_map, const size_t a_nbytes)
+{
+  size_t nbytes = 0;
+  assert (ap_map);
+
+  if (ap_map->p_data)
+    {
+      nbytes = MIN (a_nbytes, ap_map->size - ap_map->pos);
+      ap_map->pos += nbytes;
+      ap_map->eof = (ap_map->pos >= ap_map->size);
+      readahead_hint (ap_map);
+    }
+  else if (fseek (ap_map->p_file, (long) a_nbytes, SEEK_CUR) == 0)
+    {
+      nbytes = a_nbytes;
+    }
+
+  return nbytes;
+}
+
+int
+tiz_mmap_seek (tiz_mmap_t * ap_map, const long a_offset, const int a_whence)
+{
+  long base = 0;
+  long new_pos = 0;
+  assert (ap_map);
+
+  if (!ap_map->p_data)
+    {
+      const int rc = fseek (ap_map->p_file, a_offset, a_whence);
+      if (0 == rc)
+        {
+          ap_map->eof = false;
+        }
+      return rc;
+    }
+
+  clamp_to_file_size (ap_map);
+
+  switch (a_whence)
+    {
+      case TIZ_MMAP_SEEK_SET:
+        base = 0;
+        break;
+      case TIZ_MMAP_SEEK_CUR:
+        base = (long) ap_map->pos;
+        break;
+      case TIZ_MMAP_SEEK_END:
+        base = (long) ap_map->size;
+        break;
+      default:
+        errno = EINVAL;
+        return -1;
+    };
+
+  new_pos = base + a_offset;
+  if (new_pos < 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  /* Like fseek, positioning past the end of file is allowed */
+  ap_map->pos = MIN ((size_t) new_pos, ap_map->size);
+  ap_map->eof = false;
+  ap_map->readahead_pos = 0;
+  readahead_hint (ap_map);
+  return 0;
+}
+
+long
+tiz_mmap_tell (const tiz_mmap_t * ap_map)
+{
+  assert (ap_map);
+  return (ap_map->p_data ? (long) ap_map->pos : ftell (ap_map->p_file));
+}
+
+bool
+tiz_mmap_eof (const tiz_mmap_t * ap_map)
+{
+  assert (ap_map);
+  return ap_map->eof;
+}
@@ -0,0 +1,198 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   tizmmap.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - Memory-mapped sequential file input.
+ *
+ *
+ */
+
+#ifndef TIZMMAP_H
+#define TIZMMAP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+* @defgroup tizmmap Memory-mapped sequential file input.
+*
+* Read-only access to a local file through a private memory mapping, with
+* sequential access and read-ahead hints given to the kernel. Files that
+* can't be mapped (pipes, character devices, network file systems, empty
+* files) are transparently read through buffered stdio instead. If the file
+* is truncated while it is mapped, the data past the new end of file is no
+* longer returned.
+*
+* @ingroup libtizplatform
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <OMX_Core.h>
+#include <OMX_Types.h>
+
+/* The possibilities for the third argument to 'tiz_mmap_seek'.
+   These values should not be changed.  */
+#define TIZ_MMAP_SEEK_SET 0 /** Seek from beginning of file.  */
+#define TIZ_MMAP_SEEK_CUR 1 /** Seek from current position.  */
+#define TIZ_MMAP_SEEK_END 2 /** Seek from end of file.  */
+
+  /**
+ * Memory-mapped file object opaque handle.
+ * @ingroup tizmmap
+ */
+  typedef struct tiz_mmap tiz_mmap_t;
+  typedef /*@null@ */ tiz_mmap_t * tiz_mmap_ptr_t;
+
+  /**
+ * Open a file for sequential reading.
+ *
+ * @ingroup tizmmap
+ * @param app_map A file map handle to be initialised.
+ * @param ap_path The path of the file.
+ * @return OMX_ErrorNone on success, OMX_ErrorInsufficientResources if OOM,
+ * or OMX_ErrorContentURIError if the file could not be opened.
+ */
+  OMX_ERRORTYPE
+  tiz_mmap_init (/*@null@ */ tiz_mmap_ptr_t * app_map, const char * ap_path);
+
+  /**
+ * Unmap and close the file.
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ */
+  void
+  tiz_mmap_destroy (tiz_mmap_t * ap_map);
+
+  /**
+ * Whether the file contents are accessed through a memory mapping.
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ * @return true if mapped, false if the stdio fallback is in use.
+ */
+  bool
+  tiz_mmap_is_mapped (const tiz_mmap_t * ap_map);
+
+  /**
+ * Retrieve the underlying file descriptor (e.g. for pread).
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ * @return The file descriptor.
+ */
+  int
+  tiz_mmap_fd (const tiz_mmap_t * ap_map);
+
+  /**
+ * Retrieve the size of the file.
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ * @return The size in bytes, or -1 if unknown (e.g. pipes).
+ */
+  long
+  tiz_mmap_size (const tiz_mmap_t * ap_map);
+
+  /**
+ * Copy up to @a a_nbytes from the current position and advance it.
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ * @param ap_dst The destination buffer.
+ * @param a_nbytes The maximum number of bytes to copy.
+ * @return The number of bytes copied; zero at end of file.
+ */
+  size_t
+  tiz_mmap_read (tiz_mmap_t * ap_map, void * ap_dst, const size_t a_nbytes);
+
+  /**
+ * @brief Retrieve a pointer to the data at the current position, without
+ * copying it.
+ *
+ * The position is not modified; use tiz_mmap_advance to consume the data.
+ * The pointer remains valid until the map is destroyed. The data is mapped
+ * read-only; use tiz_mmap_read to obtain a copy that can be modified.
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ * @param ap_avail On return, the number of bytes available from the position
+ * returned to the end of file.
+ * @return The pointer to the current position, or NULL if the file is not
+ * mapped.
+ */
+  const OMX_U8 *
+  tiz_mmap_get (tiz_mmap_t * ap_map, size_t * ap_avail);
+
+  /**
+ * @brief Advance the current position.
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ * @param a_nbytes The number of bytes to advance the position by.
+ * @return The number of bytes actually advanced.
+ */
+  size_t
+  tiz_mmap_advance (tiz_mmap_t * ap_map, const size_t a_nbytes);
+
+  /**
+ * @brief Re-position the current position, with fseek semantics.
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ * @param a_offset The new position is obtained by adding a_offset bytes to the
+ * position specified by a_whence.
+ * @param a_whence TIZ_MMAP_SEEK_SET, TIZ_MMAP_SEEK_CUR, or TIZ_MMAP_SEEK_END.
+ * @return 0 on success, -1 on error.
+ */
+  int
+  tiz_mmap_seek (tiz_mmap_t * ap_map, const long a_offset, const int a_whence);
+
+  /**
+ * @brief Retrieve the current position.
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ * @return The offset from the beginning of the file, or -1 on error.
+ */
+  long
+  tiz_mmap_tell (const tiz_mmap_t * ap_map);
+
+  /**
+ * @brief Whether the end of file has been reached.
+ *
+ * @ingroup tizmmap
+ * @param ap_map The file map handle.
+ * @return true if there is no more data to read.
+ */
+  bool
+  tiz_mmap_eof (const tiz_mmap_t * ap_map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIZMMAP_H */
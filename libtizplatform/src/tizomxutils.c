@@ -659,6 +659,14 @@ static const tiz_idx_str_t tiz_idx_to_str_tbl[] = {
    (const OMX_STRING) "OMX_TizoniaIndexParamAudioPlexSession"},
   {OMX_TizoniaIndexParamAudioPlexPlaylist,
    (const OMX_STRING) "OMX_TizoniaIndexParamAudioPlexPlaylist"},
+  {OMX_TizoniaIndexParamStreamingBuffer,
+   (const OMX_STRING) "OMX_TizoniaIndexParamStreamingBuffer"},
+  {OMX_TizoniaIndexConfigAudioPcmBuffering,
+   (const OMX_STRING) "OMX_TizoniaIndexConfigAudioPcmBuffering"},
+  {OMX_TizoniaIndexConfigAudioPcmDelay,
+   (const OMX_STRING) "OMX_TizoniaIndexConfigAudioPcmDelay"},
+  {OMX_TizoniaIndexParamBufferInPlaceMode,
+   (const OMX_STRING) "OMX_TizoniaIndexParamBufferInPlaceMode"},
   {OMX_IndexKhronosExtensions, (const OMX_STRING) "OMX_IndexKhronosExtensions"},
   {OMX_IndexVendorStartUnused, (const OMX_STRING) "OMX_IndexVendorStartUnused"},
   {OMX_IndexMax, (const OMX_STRING) "OMX_IndexMax"}};
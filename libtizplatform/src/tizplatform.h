@@ -42,6 +42,8 @@
 #include "tizqueue.h"
 #include "tizpqueue.h"
 #include "tizbuffer.h"
+#include "tizbufpool.h"
+#include "tizmmap.h"
 #include "tizvector.h"
 #include "tizsync.h"
 #include "tizthread.h"
@@ -49,8 +51,10 @@
 #include "tizomxutils.h"
 #include "tizrc.h"
 #include "tizsoa.h"
+#include "tizwheel.h"
 #include "tizev.h"
 #include "tizhttp.h"
+#include "tizicy.h"
 #include "tizmap.h"
 #include "tizlimits.h"
 #include "tizprintf.h"
@@ -31,32 +31,25 @@
 #define TIZINT_H
 
 /**
- * Value struct used in the Tizonia Platform config file data structure
+ * Number of locations where the Tizonia config file is searched for
  *
  * @private
  */
-typedef struct value value_t;
-struct value
-{
-  char * p_value;
-  value_t * p_next;
-};
+#define TIZ_RCFILE_NUM_FILES 3
 
 /**
- * Key-value pair structure used in the Tizonia Platform config file data
- * structure
+ * An immutable (section, key) entry of a config file snapshot
  *
  * @private
  */
-typedef struct keyval keyval_t;
-struct keyval
-{
-  char * p_key;
-  value_t * p_value_list;
-  value_t * p_value_iter;
-  int valcount;
-  keyval_t * p_next;
-};
+typedef struct tiz_rcfile_entry tiz_rcfile_entry_t;
+
+/**
+ * An immutable, hashed snapshot of the contents of the config file
+ *
+ * @private
+ */
+typedef struct tiz_rcfile_snapshot tiz_rcfile_snapshot_t;
 
 /**
  * Handle to the Tizonia Platform config file data structure
@@ -66,8 +59,9 @@ struct keyval
 typedef struct tiz_rcfile tiz_rcfile_t;
 struct tiz_rcfile
 {
-  keyval_t * p_keyvals;
-  int count;
+  tiz_rcfile_snapshot_t * p_snapshot; /* The current snapshot; swapped
+                                         atomically on reload */
+  tiz_rcfile_snapshot_t * p_retired;  /* Snapshots replaced by a reload */
 };
 
 /**
@@ -94,6 +88,33 @@ tiz_rcfile_init (tiz_rcfile_t ** rcfile);
 void
 tiz_rcfile_destroy (tiz_rcfile_t * rcfile);
 
+/**
+ * Re-read the config file and publish its contents as a new snapshot. The
+ * current snapshot is kept if the file can't be loaded.
+ *
+ * @private
+ *
+ * @note To be called from the event loop thread only.
+ *
+ * @param rcfile The handle to the Tizonia config file data structure
+ *
+ * @return OMX_ErrorNone on success. OMX_ErrorInsuficientResources otherwise.
+ */
+OMX_ERRORTYPE
+tiz_rcfile_reload (tiz_rcfile_t * rcfile);
+
+/**
+ * Retrieve one of the paths where the config file is searched for
+ *
+ * @private
+ *
+ * @param index A number between 0 and TIZ_RCFILE_NUM_FILES - 1
+ *
+ * @return The path, or NULL if the index is out of range
+ */
+const char *
+tiz_rcfile_get_path (const int index);
+
 /**
  * Retrieve the config file handle from the event loop thread
  *
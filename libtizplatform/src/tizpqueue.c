@@ -33,6 +33,7 @@
 #include "tizplatform.h"
 
 #include <assert.h>
+#include <stdint.h>
 #include <string.h>
 
 #ifdef TIZ_LOG_CATEGORY_NAME
@@ -52,6 +53,10 @@ _pq_dump_item (const char *ap_name, void    *ap_data,
 }
 #endif
 
+/* Number of buckets in the secondary indexes; must be powers of two */
+#define TIZ_PQUEUE_PORT_BUCKETS 8
+#define TIZ_PQUEUE_HDR_BUCKETS 64
+
 typedef struct tiz_pqueue_item tiz_pqueue_item_t;
 struct tiz_pqueue_item
 {
@@ -59,6 +64,20 @@ struct tiz_pqueue_item
   OMX_S32 priority;
   tiz_pqueue_item_t * p_prev;
   tiz_pqueue_item_t * p_next;
+  /* Secondary index links; only used when the queue has a key function */
+  OMX_S32 port_key;
+  void * p_hdr_key;
+  tiz_pqueue_item_t * p_port_prev;
+  tiz_pqueue_item_t * p_port_next;
+  tiz_pqueue_item_t * p_hdr_prev;
+  tiz_pqueue_item_t * p_hdr_next;
+};
+
+typedef struct tiz_pqueue_chain tiz_pqueue_chain_t;
+struct tiz_pqueue_chain
+{
+  tiz_pqueue_item_t * p_first;
+  tiz_pqueue_item_t * p_last;
 };
 
 struct tiz_pqueue
@@ -69,6 +88,9 @@ struct tiz_pqueue
   OMX_S32 length;
   OMX_S32 max_prio;
   tiz_pq_cmp_f pf_cmp;
+  tiz_pq_key_f pf_key;
+  /*@null@ */ tiz_pqueue_chain_t * p_port_idx;
+  /*@null@ */ tiz_pqueue_chain_t * p_hdr_idx;
   tiz_soa_t * p_soa;
   char name[TIZ_PQUEUE_MAX_NAME_LEN];
 };
@@ -124,6 +146,171 @@ hook_last (tiz_pqueue_t * p_q, tiz_pqueue_item_t * p_new)
     }
 }
 
+static inline tiz_pqueue_chain_t *
+port_chain (tiz_pqueue_t * p_q, const OMX_S32 a_port)
+{
+  return &(p_q->p_port_idx[a_port & (TIZ_PQUEUE_PORT_BUCKETS - 1)]);
+}
+
+static inline tiz_pqueue_chain_t *
+hdr_chain (tiz_pqueue_t * p_q, const void * ap_hdr)
+{
+  /* Headers are heap objects; their lowest bits carry no information */
+  const uintptr_t addr = (uintptr_t) ap_hdr;
+  return &(p_q->p_hdr_idx[((addr >> 4) ^ (addr >> 10))
+                          & (TIZ_PQUEUE_HDR_BUCKETS - 1)]);
+}
+
+static void
+index_item (tiz_pqueue_t * p_q, tiz_pqueue_item_t * p_new)
+{
+  assert (p_q);
+  assert (p_new);
+
+  p_new->port_key = -1;
+  p_new->p_hdr_key = NULL;
+
+  if (!p_q->pf_key)
+    {
+      return;
+    }
+
+  p_q->pf_key (p_new->p_data, &(p_new->port_key), &(p_new->p_hdr_key));
+
+  /* Chains are kept in send order */
+  if (p_new->port_key >= 0)
+    {
+      tiz_pqueue_chain_t * p_chain = port_chain (p_q, p_new->port_key);
+      p_new->p_port_prev = p_chain->p_last;
+      if (p_chain->p_last)
+        {
+          p_chain->p_last->p_port_next = p_new;
+        }
+      else
+        {
+          p_chain->p_first = p_new;
+        }
+      p_chain->p_last = p_new;
+    }
+
+  if (p_new->p_hdr_key)
+    {
+      tiz_pqueue_chain_t * p_chain = hdr_chain (p_q, p_new->p_hdr_key);
+      p_new->p_hdr_prev = p_chain->p_last;
+      if (p_chain->p_last)
+        {
+          p_chain->p_last->p_hdr_next = p_new;
+        }
+      else
+        {
+          p_chain->p_first = p_new;
+        }
+      p_chain->p_last = p_new;
+    }
+}
+
+static void
+unindex_item (tiz_pqueue_t * p_q, tiz_pqueue_item_t * p_cur)
+{
+  assert (p_q);
+  assert (p_cur);
+
+  if (p_cur->port_key >= 0)
+    {
+      tiz_pqueue_chain_t * p_chain = port_chain (p_q, p_cur->port_key);
+      if (p_cur->p_port_prev)
+        {
+          p_cur->p_port_prev->p_port_next = p_cur->p_port_next;
+        }
+      else
+        {
+          p_chain->p_first = p_cur->p_port_next;
+        }
+      if (p_cur->p_port_next)
+        {
+          p_cur->p_port_next->p_port_prev = p_cur->p_port_prev;
+        }
+      else
+        {
+          p_chain->p_last = p_cur->p_port_prev;
+        }
+    }
+
+  if (p_cur->p_hdr_key)
+    {
+      tiz_pqueue_chain_t * p_chain = hdr_chain (p_q, p_cur->p_hdr_key);
+      if (p_cur->p_hdr_prev)
+        {
+          p_cur->p_hdr_prev->p_hdr_next = p_cur->p_hdr_next;
+        }
+      else
+        {
+          p_chain->p_first = p_cur->p_hdr_next;
+        }
+      if (p_cur->p_hdr_next)
+        {
+          p_cur->p_hdr_next->p_hdr_prev = p_cur->p_hdr_prev;
+        }
+      else
+        {
+          p_chain->p_last = p_cur->p_hdr_prev;
+        }
+    }
+}
+
+/* Unlink an item from the queue and its indexes, and release it */
+static void
+unlink_item (tiz_pqueue_t * p_q, tiz_pqueue_item_t * p_cur)
+{
+  tiz_pqueue_item_t * p_next = NULL;
+  tiz_pqueue_item_t * p_prev = NULL;
+
+  assert (p_q);
+  assert (p_cur);
+
+  p_next = p_cur->p_next;
+  p_prev = p_cur->p_prev;
+
+  if (p_next)
+    {
+      p_next->p_prev = p_prev;
+    }
+
+  if (p_prev)
+    {
+      p_prev->p_next = p_next;
+    }
+
+  if (p_q->p_first == p_cur)
+    {
+      p_q->p_first = p_next;
+    }
+
+  if (p_q->p_last == p_cur)
+    {
+      p_q->p_last = p_prev;
+    }
+
+  if (p_q->pp_store[p_cur->priority] == p_cur)
+    {
+      if ((p_next) && (p_next->priority == p_cur->priority))
+        {
+          p_q->pp_store[p_cur->priority] = p_next;
+        }
+      else
+        {
+          p_q->pp_store[p_cur->priority] = NULL;
+        }
+    }
+
+  unindex_item (p_q, p_cur);
+  pqueue_free (p_q->p_soa, p_cur);
+  p_q->length--;
+
+  assert (p_q->length >= 0);
+  assert (p_q->length > 0 ? (p_q->p_first && p_q->p_last) : 1);
+}
+
 OMX_ERRORTYPE
 tiz_pqueue_init (tiz_pqueue_t ** pp_q, OMX_S32 a_max_prio,
                  tiz_pq_cmp_f a_pf_cmp, tiz_soa_t * ap_soa,
@@ -178,6 +365,11 @@ tiz_pqueue_destroy (tiz_pqueue_t * p_q)
       assert (p_q->p_first == NULL);
       assert (p_q->length == 0);
 
+      if (p_q->p_port_idx)
+        {
+          tiz_mem_free (p_q->p_port_idx);
+          tiz_mem_free (p_q->p_hdr_idx);
+        }
       pqueue_free (p_q->p_soa, p_q->pp_store);
       pqueue_free (p_q->p_soa, p_q);
     }
@@ -225,6 +417,7 @@ tiz_pqueue_send (tiz_pqueue_t * p_q, void * ap_data, OMX_S32 a_priority)
 
       p_new->p_data = ap_data;
       p_new->priority = a_priority;
+      index_item (p_q, p_new);
       p_q->length++;
 
       assert (p_q->p_first);
@@ -253,42 +446,10 @@ tiz_pqueue_receive (tiz_pqueue_t * p_q, void ** app_data)
     }
   else
     {
-      tiz_pqueue_item_t * p_cur = NULL;
-      tiz_pqueue_item_t * p_next = NULL;
-
-      p_cur = p_q->p_first;
+      tiz_pqueue_item_t * p_cur = p_q->p_first;
       assert (p_cur);
-      p_next = p_cur->p_next;
-      p_q->p_first = p_next;
-
-      if (p_next)
-        {
-          p_next->p_prev = NULL;
-        }
-      else
-        {
-          p_q->p_last = NULL;
-          assert (p_q->length == 1);
-        }
-
-      if (p_q->pp_store[p_cur->priority] == p_cur)
-        {
-          if ((p_next) && (p_next->priority == p_cur->priority))
-            {
-              p_q->pp_store[p_cur->priority] = p_next;
-            }
-          else
-            {
-              p_q->pp_store[p_cur->priority] = NULL;
-            }
-        }
-
-      p_q->length--;
       *app_data = p_cur->p_data;
-      pqueue_free (p_q->p_soa, p_cur);
-
-      assert (p_q->length >= 0);
-      assert (p_q->length > 0 ? (p_q->p_first && p_q->p_last) : 1);
+      unlink_item (p_q, p_cur);
     }
 
   TIZ_LOG (TIZ_PRIORITY_TRACE, "[%s], pq[%p] len[%d] fst [%p] lst [%p]",
@@ -302,8 +463,6 @@ tiz_pqueue_remove (tiz_pqueue_t * p_q, void * ap_data)
 {
   OMX_ERRORTYPE rc = OMX_ErrorNoMore;
   tiz_pqueue_item_t * p_cur = NULL;
-  tiz_pqueue_item_t * p_next = NULL;
-  tiz_pqueue_item_t * p_prev = NULL;
 
   assert (p_q);
   assert (ap_data);
@@ -313,43 +472,7 @@ tiz_pqueue_remove (tiz_pqueue_t * p_q, void * ap_data)
     {
       if (p_q->pf_cmp (p_cur->p_data, ap_data) == 0)
         {
-          p_next = p_cur->p_next;
-          p_prev = p_cur->p_prev;
-
-          if (p_next)
-            {
-              p_next->p_prev = p_prev;
-            }
-
-          if (p_prev)
-            {
-              p_prev->p_next = p_next;
-            }
-
-          if (p_q->p_first == p_cur)
-            {
-              p_q->p_first = p_next;
-            }
-
-          if (p_q->p_last == p_cur)
-            {
-              p_q->p_last = p_prev;
-            }
-
-          if (p_q->pp_store[p_cur->priority] == p_cur)
-            {
-              if ((p_next) && (p_next->priority == p_cur->priority))
-                {
-                  p_q->pp_store[p_cur->priority] = p_next;
-                }
-              else
-                {
-                  p_q->pp_store[p_cur->priority] = NULL;
-                }
-            }
-
-          pqueue_free (p_q->p_soa, p_cur);
-          p_q->length--;
+          unlink_item (p_q, p_cur);
           rc = OMX_ErrorNone;
           /* DONE */
           break;
@@ -365,8 +488,6 @@ tiz_pqueue_removep (tiz_pqueue_t * p_q, void * ap_data, OMX_S32 a_priority)
 {
   OMX_ERRORTYPE rc = OMX_ErrorNoMore;
   tiz_pqueue_item_t * p_cur = NULL;
-  tiz_pqueue_item_t * p_next = NULL;
-  tiz_pqueue_item_t * p_prev = NULL;
 
   assert (p_q);
   assert (ap_data != NULL);
@@ -378,43 +499,7 @@ tiz_pqueue_removep (tiz_pqueue_t * p_q, void * ap_data, OMX_S32 a_priority)
     {
       if (p_q->pf_cmp (p_cur->p_data, ap_data) == 0)
         {
-          p_next = p_cur->p_next;
-          p_prev = p_cur->p_prev;
-
-          if (p_next)
-            {
-              p_next->p_prev = p_prev;
-            }
-
-          if (p_prev)
-            {
-              p_prev->p_next = p_next;
-            }
-
-          if (p_q->p_first == p_cur)
-            {
-              p_q->p_first = p_next;
-            }
-
-          if (p_q->p_last == p_cur)
-            {
-              p_q->p_last = p_prev;
-            }
-
-          if (p_q->pp_store[p_cur->priority] == p_cur)
-            {
-              if ((p_next) && (p_next->priority == p_cur->priority))
-                {
-                  p_q->pp_store[p_cur->priority] = p_next;
-                }
-              else
-                {
-                  p_q->pp_store[p_cur->priority] = NULL;
-                }
-            }
-
-          pqueue_free (p_q->p_soa, p_cur);
-          p_q->length--;
+          unlink_item (p_q, p_cur);
           rc = OMX_ErrorNone;
           /* DONE */
           break;
@@ -431,7 +516,6 @@ tiz_pqueue_remove_func (tiz_pqueue_t * p_q, tiz_pq_func_f a_pf_func,
 {
   tiz_pqueue_item_t * p_cur = NULL;
   tiz_pqueue_item_t * p_next = NULL;
-  tiz_pqueue_item_t * p_prev = NULL;
   OMX_S32 initial_item_count = 0;
 
   assert (p_q);
@@ -443,56 +527,113 @@ tiz_pqueue_remove_func (tiz_pqueue_t * p_q, tiz_pq_func_f a_pf_func,
   p_cur = p_q->p_first;
   while (p_cur)
     {
+      p_next = p_cur->p_next;
       if (OMX_TRUE == a_pf_func (p_cur->p_data, a_data1, ap_data2))
         {
-          p_next = p_cur->p_next;
-          p_prev = p_cur->p_prev;
-
-          if (p_next)
-            {
-              p_next->p_prev = p_prev;
-            }
-
-          if (p_prev)
-            {
-              p_prev->p_next = p_next;
-            }
-
-          if (p_q->p_first == p_cur)
-            {
-              p_q->p_first = p_next;
-            }
-
-          if (p_q->p_last == p_cur)
-            {
-              p_q->p_last = p_prev;
-            }
-
-          if (p_q->pp_store[p_cur->priority] == p_cur)
-            {
-              if ((p_next) && (p_next->priority == p_cur->priority))
-                {
-                  p_q->pp_store[p_cur->priority] = p_next;
-                }
-              else
-                {
-                  p_q->pp_store[p_cur->priority] = NULL;
-                }
-            }
-
-          {
-            tiz_pqueue_item_t * p_to_delete = p_cur;
-            p_cur = p_cur->p_next;
-            pqueue_free (p_q->p_soa, p_to_delete);
-            p_q->length--;
-            /* NOTE: We continue here to remove as many matching items as
-                 * possible */
-          }
+          /* NOTE: We continue here to remove as many matching items as
+           * possible */
+          unlink_item (p_q, p_cur);
         }
-      else
+      p_cur = p_next;
+    }
+
+  return (initial_item_count - p_q->length);
+}
+
+OMX_ERRORTYPE
+tiz_pqueue_set_key_func (tiz_pqueue_t * p_q, tiz_pq_key_f a_pf_key)
+{
+  assert (p_q);
+  assert (a_pf_key);
+  assert (0 == p_q->length);
+
+  /* The bucket arrays are larger than the soa's biggest slice */
+  if (!p_q->p_port_idx)
+    {
+      if (NULL
+          == (p_q->p_port_idx = (tiz_pqueue_chain_t *) tiz_mem_calloc (
+                TIZ_PQUEUE_PORT_BUCKETS, sizeof (tiz_pqueue_chain_t))))
+        {
+          return OMX_ErrorInsufficientResources;
+        }
+      if (NULL
+          == (p_q->p_hdr_idx = (tiz_pqueue_chain_t *) tiz_mem_calloc (
+                TIZ_PQUEUE_HDR_BUCKETS, sizeof (tiz_pqueue_chain_t))))
+        {
+          tiz_mem_free (p_q->p_port_idx);
+          p_q->p_port_idx = NULL;
+          return OMX_ErrorInsufficientResources;
+        }
+    }
+
+  p_q->pf_key = a_pf_key;
+  return OMX_ErrorNone;
+}
+
+OMX_S32
+tiz_pqueue_remove_func_port (tiz_pqueue_t * p_q, tiz_pq_func_f a_pf_func,
+                             OMX_S32 a_port, OMX_S32 a_data1,
+                             void * ap_data2)
+{
+  tiz_pqueue_item_t * p_cur = NULL;
+  tiz_pqueue_item_t * p_next = NULL;
+  OMX_S32 initial_item_count = 0;
+
+  assert (p_q);
+  assert (a_pf_func);
+  assert (ap_data2);
+
+  if (!p_q->pf_key || a_port < 0)
+    {
+      return tiz_pqueue_remove_func (p_q, a_pf_func, a_data1, ap_data2);
+    }
+
+  initial_item_count = p_q->length;
+
+  p_cur = port_chain (p_q, a_port)->p_first;
+  while (p_cur)
+    {
+      p_next = p_cur->p_port_next;
+      if (p_cur->port_key == a_port
+          && OMX_TRUE == a_pf_func (p_cur->p_data, a_data1, ap_data2))
+        {
+          unlink_item (p_q, p_cur);
+        }
+      p_cur = p_next;
+    }
+
+  return (initial_item_count - p_q->length);
+}
+
+OMX_S32
+tiz_pqueue_remove_func_hdr (tiz_pqueue_t * p_q, tiz_pq_func_f a_pf_func,
+                            void * ap_hdr, OMX_S32 a_data1, void * ap_data2)
+{
+  tiz_pqueue_item_t * p_cur = NULL;
+  tiz_pqueue_item_t * p_next = NULL;
+  OMX_S32 initial_item_count = 0;
+
+  assert (p_q);
+  assert (a_pf_func);
+  assert (ap_data2);
+
+  if (!p_q->pf_key || !ap_hdr)
+    {
+      return tiz_pqueue_remove_func (p_q, a_pf_func, a_data1, ap_data2);
+    }
+
+  initial_item_count = p_q->length;
+
+  p_cur = hdr_chain (p_q, ap_hdr)->p_first;
+  while (p_cur)
+    {
+      p_next = p_cur->p_hdr_next;
+      if (p_cur->p_hdr_key == ap_hdr
+          && OMX_TRUE == a_pf_func (p_cur->p_data, a_data1, ap_data2))
         {
-          p_cur = p_cur->p_next;
+          unlink_item (p_q, p_cur);
         }
+      p_cur = p_next;
     }
 
   return (initial_item_count - p_q->length);
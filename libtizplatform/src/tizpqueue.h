@@ -82,6 +82,18 @@ extern "C"
   typedef OMX_BOOL (*tiz_pq_func_f) (void * ap_elem, OMX_S32 a_data1,
                                      void * ap_data2);
 
+  /**
+ * \typedef The function used to extract the secondary keys of an item (see
+ * tiz_pqueue_set_key_func).
+ * @param ap_data The item being added to the queue
+ * @param ap_port On return, the port the item belongs to, or a negative value
+ * if the item should not be indexed by port
+ * @param app_hdr On return, the buffer header the item refers to, or NULL if
+ * the item should not be indexed by header
+ */
+  typedef void (*tiz_pq_key_f) (void * ap_data, OMX_S32 * ap_port,
+                                void ** app_hdr);
+
   /**
  * \typedef Function callback that receives the contents of a node from the
  * queue.
@@ -206,6 +218,47 @@ extern "C"
   tiz_pqueue_remove_func (tiz_pqueue_t * ap_pq, tiz_pq_func_f apf_func,
                           OMX_S32 a_data1, void * ap_data2);
 
+  /**
+ * Enable the per-port and per-header secondary indexes of the queue. The key
+ * function is invoked once for every item sent to the queue, and the item is
+ * linked into the indexes according to the keys returned. The priority
+ * semantics of the queue are not affected.
+ * @pre The queue must be empty.
+ * @ingroup tizpqueue
+ * @param apf_key The key extraction function.
+ * @return OMX_ErrorNone if success, OMX_ErrorInsufficientResources otherwise
+ */
+  OMX_ERRORTYPE
+  tiz_pqueue_set_key_func (tiz_pqueue_t * ap_pq, tiz_pq_key_f apf_key);
+
+  /**
+ * Remove from the queue all the items indexed under port a_port that are
+ * found using the comparison function apf_func. Only the items of that port
+ * are visited, in the order in which they were sent to the queue. If the
+ * queue has no key function, or a_port is negative, this is equivalent to
+ * tiz_pqueue_remove_func.
+ * @ingroup tizpqueue
+ * @return The number of items removed from the queue.
+ */
+  OMX_S32
+  tiz_pqueue_remove_func_port (tiz_pqueue_t * ap_pq, tiz_pq_func_f apf_func,
+                               OMX_S32 a_port, OMX_S32 a_data1,
+                               void * ap_data2);
+
+  /**
+ * Remove from the queue all the items indexed under header ap_hdr that are
+ * found using the comparison function apf_func. Only the items of that header
+ * are visited, in the order in which they were sent to the queue. If the
+ * queue has no key function, or ap_hdr is NULL, this is equivalent to
+ * tiz_pqueue_remove_func.
+ * @ingroup tizpqueue
+ * @return The number of items removed from the queue.
+ */
+  OMX_S32
+  tiz_pqueue_remove_func_hdr (tiz_pqueue_t * ap_pq, tiz_pq_func_f apf_func,
+                              void * ap_hdr, OMX_S32 a_data1,
+                              void * ap_data2);
+
   /**
  * Return a reference to the first item in the queue.
  *
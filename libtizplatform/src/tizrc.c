@@ -23,8 +23,12 @@
  *
  * @brief Tizonia Platform - Configuration file utility functions
  *
- * Very naive implementation of a ini file parser (to be replaced in the near
- * future with a json-based utility).
+ * A simple ini file parser. The file is parsed once, into an immutable
+ * snapshot: a hash table of (section, key) entries whose values are
+ * shell-expanded, and parsed as integers and booleans, at load time. Lookups
+ * read the current snapshot pointer and never take a lock. When the file
+ * changes, a new snapshot is built in the event loop thread and published
+ * with an atomic pointer swap.
  *
  */
 
@@ -33,9 +37,11 @@
 #endif
 
 #include <assert.h>
+#include <errno.h>
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -59,8 +65,10 @@
 #define FILE_PATH_MAX (PATH_MAX + NAME_MAX - 2)
 #define PAT_SIZE PATH_MAX
 
-static char delim[2] = {';', '\0'};
-static char pat[PAT_SIZE];
+/* Minimum number of slots in a snapshot's hash table */
+#define RC_TABLE_MIN_SIZE 64
+
+static const char delim[2] = {';', '\0'};
 
 typedef struct file_info file_info_t;
 struct file_info
@@ -76,12 +84,72 @@ static char * g_list_value_keys[] = {
 
 static const int g_num_list_value_keys = 1;
 
-static file_info_t g_rcfiles[] = {{"$SYSCONFDIR/tizonia/tizonia.conf"},
-                                  {"$HOME/.config/tizonia/tizonia.conf"},
-                                  {"$TIZONIA_RC_FILE/tizonia.conf"}};
+static file_info_t g_rcfiles[TIZ_RCFILE_NUM_FILES]
+  = {{"$SYSCONFDIR/tizonia/tizonia.conf"},
+     {"$HOME/.config/tizonia/tizonia.conf"},
+     {"$TIZONIA_RC_FILE/tizonia.conf"}};
 
 static const int g_num_rcfiles = sizeof (g_rcfiles) / sizeof (g_rcfiles[0]);
 
+/* Parse-time representation of the values of a key */
+typedef struct value value_t;
+struct value
+{
+  char * p_value;
+  value_t * p_next;
+};
+
+/* Parse-time representation of a (section, key) pair */
+typedef struct keyval keyval_t;
+struct keyval
+{
+  char * p_section;
+  char * p_key;
+  value_t * p_value_list;
+  unsigned long valcount;
+  keyval_t * p_next;
+};
+
+typedef struct rc_parser rc_parser_t;
+struct rc_parser
+{
+  char line[PAT_SIZE];
+  char section[PAT_SIZE];
+  keyval_t * p_keyvals;
+  keyval_t * p_tail;
+  keyval_t * p_last_kv; /* The key that a continuation line belongs to */
+  size_t count;
+};
+
+/* An entry of a snapshot; immutable once published */
+struct tiz_rcfile_entry
+{
+  const tiz_rcfile_snapshot_t * p_snapshot;
+  OMX_U32 hash;
+  char * p_section;
+  char * p_key;
+  char ** pp_values; /* Shell-expanded, NULL-terminated */
+  unsigned long nvalues;
+  long int_value;
+  bool is_int;
+  bool bool_value;
+  bool is_bool;
+};
+
+struct tiz_rcfile_snapshot
+{
+  tiz_rcfile_entry_t * p_entries;
+  size_t nentries;
+  tiz_rcfile_entry_t ** pp_table;
+  size_t table_mask;
+  unsigned long generation;
+  tiz_rcfile_snapshot_t * p_next_retired;
+};
+
+/* Snapshot generations are never re-used, even across a destroy and a new
+   init, so that call-site caches can tell a freed entry from a live one */
+static unsigned long g_rcfile_generation = 0;
+
 static char *
 trimwhitespace (char * str)
 {
@@ -112,6 +180,9 @@ trimlistseparator (char * str)
 {
   char * end;
 
+  if (*str == 0)
+    return str;
+
   /* Trim trailing ';' */
   end = str + strlen (str) - 1;
   while (end > str && ';' == (*end))
@@ -132,6 +203,9 @@ trimsectioning (char * str)
   while ('[' == (*str))
     str++;
 
+  if (*str == 0)
+    return str;
+
   /* Trim trailing ']' */
   end = str + strlen (str) - 1;
   while (end > str && ']' == (*end))
@@ -143,40 +217,6 @@ trimsectioning (char * str)
   return str;
 }
 
-static char *
-trimcommenting (char * str)
-{
-
-  /* Trim leading '#' */
-  while ('#' == (*str))
-    str++;
-
-  return str;
-}
-
-static keyval_t *
-find_node (const tiz_rcfile_t * ap_rc, const char * key)
-{
-  keyval_t * p_kvs = NULL;
-
-  assert (ap_rc);
-  assert (key);
-
-  p_kvs = ap_rc->p_keyvals;
-
-  while (p_kvs && p_kvs->p_key)
-    {
-      if (0 == strncmp (p_kvs->p_key, key, PATH_MAX))
-        {
-          return p_kvs;
-        }
-      p_kvs = p_kvs->p_next;
-    }
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE, "Key not found [%s] [%p]", key, p_kvs);
-  return NULL;
-}
-
 static bool
 is_list (const char * key)
 {
@@ -192,353 +232,519 @@ is_list (const char * key)
   return false;
 }
 
-static int
-get_node (const tiz_rcfile_t * ap_rc, char * str, keyval_t ** app_kv)
+static char *
+shell_expand_value (const char * p_value)
 {
-  int ret = 0;
-  char * needle = strstr (str, "=");
-  char * key = strndup (trimwhitespace (str), needle - str);
-  char * value_start = str + (needle - str) + 1;
-  char * value = strndup (trimlistseparator (trimwhitespace (value_start)),
-                          strlen (str) - (needle - str));
-  keyval_t * p_kv = NULL;
-  value_t * p_v = NULL;
-  value_t * p_next_v = NULL;
-
-  assert (ap_rc);
-  assert (str);
-  assert (app_kv);
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE, "key : [%s]", trimwhitespace (key));
-  TIZ_LOG (TIZ_PRIORITY_TRACE, "val : [%s]",
-           trimlistseparator (trimwhitespace (value)));
-
-  /*   if (strstr (value, "\"")) */
-  /*     { */
-  /*       char quoted[PATH_MAX]; */
-  /*       printf ("vakue : %s\n", value); */
-  /*       if (sscanf (str, "%*[^\"]\"%31[^\"]\"", quoted) == 1) */
-  /*         { */
-  /*           free (value); value = NULL; */
-  /*           value = strdup (quoted); */
-  /*           printf ("got '%s'\n", value); */
-  /*         } */
-  /*     } */
-
-  /* Find if the key exists already */
-  p_kv = find_node (ap_rc, key);
-  if (!p_kv)
-    {
-      p_kv = (keyval_t *) tiz_mem_calloc (1, sizeof (keyval_t));
-      p_v = (value_t *) tiz_mem_calloc (1, sizeof (value_t));
-
-      if (!p_kv || !p_v)
-        {
-          tiz_mem_free (p_kv);
-          p_kv = NULL;
-          tiz_mem_free (p_v);
-          p_v = NULL;
-          tiz_mem_free (value);
-          value = NULL;
-          tiz_mem_free (key);
-          key = NULL;
-          ret = -1;
-        }
-      else
-        {
-          p_kv->p_key = key;
-          p_kv->p_value_list = p_v;
-          p_kv->p_value_iter = p_v;
-          p_kv->valcount++;
-          p_kv->p_next = NULL;
-          if (is_list (key))
-            {
-              char * token = strtok (value, delim);
-              while (token)
-                {
-                  p_v->p_value = strndup (token, PATH_MAX);
-                  token = strtok (0, delim);
-                  if (token)
-                    {
-                      p_v->p_next
-                        = (value_t *) tiz_mem_calloc (1, sizeof (value_t));
-                      p_v = p_v->p_next;
-                      p_kv->valcount++;
-                    }
-                }
-              tiz_mem_free (value);
-              value = NULL;
-            }
-          else
-            {
-              p_v->p_value = value;
-            }
-          ret = 1;
-        }
-    }
-  else
+  char * p_expanded = NULL;
+  if (p_value)
     {
-      /* There is already a node with that key */
-      /* Need to check if this node holds value lists */
-      if (is_list (key))
+      wordexp_t p;
+      if (0 == wordexp (p_value, &p, 0))
         {
-          /* Add another value to the list */
-          p_v = (value_t *) tiz_mem_calloc (1, sizeof (value_t));
-          p_v->p_value = value;
-
-          p_next_v = p_kv->p_value_list;
-
-          for (;;)
+          if (p.we_wordc > 0)
             {
-              if (!p_next_v->p_next)
-                {
-                  p_next_v->p_next = p_v;
-                  p_kv->valcount++;
-                  break;
-                }
-              p_next_v = p_next_v->p_next;
+              p_expanded = strndup (p.we_wordv[0], PATH_MAX);
             }
-
-          ret = 0;
+          wordfree (&p);
         }
-      else
+      if (!p_expanded)
         {
-          /* Replace the existing value */
-          tiz_mem_free (p_kv->p_value_list->p_value);
-          p_kv->p_value_list->p_value = value;
-          p_kv->valcount = 1;
-          ret = 0;
+          p_expanded = strndup (p_value, PATH_MAX);
         }
-      tiz_mem_free (key);
-      key = NULL;
     }
+  return p_expanded;
+}
+
+/*
+ * Parsing
+ */
 
-  if (-1 != ret)
+static void
+free_values (value_t * ap_values)
+{
+  while (ap_values)
     {
-      *app_kv = p_kv;
+      value_t * p_next = ap_values->p_next;
+      tiz_mem_free (ap_values->p_value);
+      tiz_mem_free (ap_values);
+      ap_values = p_next;
     }
+}
 
-  return ret;
+static void
+free_keyvals (rc_parser_t * ap_parser)
+{
+  keyval_t * p_kv = NULL;
+  assert (ap_parser);
+  p_kv = ap_parser->p_keyvals;
+  while (p_kv)
+    {
+      keyval_t * p_next = p_kv->p_next;
+      tiz_mem_free (p_kv->p_section);
+      tiz_mem_free (p_kv->p_key);
+      free_values (p_kv->p_value_list);
+      tiz_mem_free (p_kv);
+      p_kv = p_next;
+    }
+  ap_parser->p_keyvals = NULL;
+  ap_parser->p_tail = NULL;
+  ap_parser->p_last_kv = NULL;
+  ap_parser->count = 0;
 }
 
-static int
-extractkeyval (FILE * ap_file, char * ap_str, keyval_t ** app_last_kv,
-               tiz_rcfile_t * ap_tiz_rcfile)
+static keyval_t *
+find_node (const rc_parser_t * ap_parser, const char * ap_section,
+           const char * ap_key)
 {
-  int len;
-  int ret = 0;
-  int is_new = 0;
   keyval_t * p_kv = NULL;
-  value_t *p_v = NULL, *p_next_v = NULL;
 
-  is_new = get_node (ap_tiz_rcfile, ap_str, &p_kv);
+  assert (ap_parser);
+  assert (ap_section);
+  assert (ap_key);
 
-  if (!p_kv)
+  /* NOTE: Parse time only; lookups go through the snapshot's hash table */
+  for (p_kv = ap_parser->p_keyvals; p_kv; p_kv = p_kv->p_next)
     {
-      TIZ_LOG (TIZ_PRIORITY_ERROR,
-               "Could not allocate memory "
-               "for keyval_t...");
-      return OMX_ErrorInsufficientResources;
+      if (0 == strcmp (p_kv->p_key, ap_key)
+          && 0 == strcmp (p_kv->p_section, ap_section))
+        {
+          return p_kv;
+        }
     }
+  return NULL;
+}
 
-  /* Check if this is an existent node or not */
-  if (is_new)
-    {
-      /* This is a new node */
-      (*app_last_kv) = p_kv;
-      p_v = p_kv->p_value_list;
-    }
-  else
+static bool
+append_value (keyval_t * ap_kv, const char * ap_value)
+{
+  value_t * p_v = NULL;
+  value_t ** pp_last = NULL;
+
+  assert (ap_kv);
+  assert (ap_value);
+
+  if (!(p_v = (value_t *) tiz_mem_calloc (1, sizeof (value_t)))
+      || !(p_v->p_value = strndup (ap_value, PATH_MAX)))
     {
-      p_v = p_kv->p_value_list;
-      for (;;)
-        {
-          if (!p_v->p_next)
-            {
-              break;
-            }
-          p_v = p_v->p_next;
-        }
+      tiz_mem_free (p_v);
+      return false;
     }
 
-  while (fgets (pat, PAT_SIZE, ap_file) != NULL)
+  for (pp_last = &(ap_kv->p_value_list); *pp_last;
+       pp_last = &((*pp_last)->p_next))
     {
-      if (strstr (pat, ";"))
-        {
-          p_next_v = (value_t *) tiz_mem_calloc (1, sizeof (value_t));
+    }
+  *pp_last = p_v;
+  ap_kv->valcount++;
+  return true;
+}
 
-          p_next_v->p_value
-            = strndup (trimlistseparator (trimwhitespace (pat)), PATH_MAX);
+static int
+add_values (keyval_t * ap_kv, char * ap_value)
+{
+  assert (ap_kv);
+  assert (ap_value);
 
-          p_v->p_next = p_next_v;
-          p_v = p_next_v;
-          p_kv->valcount++;
-        }
-      else
+  if (is_list (ap_kv->p_key))
+    {
+      char * p_save = NULL;
+      char * p_token = strtok_r (ap_value, delim, &p_save);
+      while (p_token)
         {
-          len = strlen (pat);
-          if (pat[len - 1] == '\n')
-            {
-              pat[len - 1] = '\0';
-            }
-
-          if (strlen (pat) > 1)
+          p_token = trimwhitespace (p_token);
+          if (*p_token && !append_value (ap_kv, p_token))
             {
-              ret = 1;
+              return -1;
             }
-          break;
+          p_token = strtok_r (NULL, delim, &p_save);
         }
+      return 0;
     }
 
-  return ret;
+  return append_value (ap_kv, trimlistseparator (ap_value)) ? 0 : -1;
 }
 
-static char *
-shell_expand_value (char * p_value)
+static int
+add_keyval (rc_parser_t * ap_parser, char * ap_str)
 {
-  char * p_expanded = p_value;
-  if (p_value)
+  char * p_eq = strchr (ap_str, '=');
+  char * p_key = NULL;
+  char * p_value = NULL;
+  keyval_t * p_kv = NULL;
+
+  assert (ap_parser);
+  assert (p_eq);
+
+  *p_eq = '\0';
+  p_key = trimwhitespace (ap_str);
+  p_value = trimlistseparator (trimwhitespace (p_eq + 1));
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "[%s] key : [%s] val : [%s]",
+           ap_parser->section, p_key, p_value);
+
+  if (!(p_kv = find_node (ap_parser, ap_parser->section, p_key)))
     {
-      wordexp_t p;
-      wordexp (p_value, &p, 0);
-      if (p.we_wordc > 0)
+      if (!(p_kv = (keyval_t *) tiz_mem_calloc (1, sizeof (keyval_t)))
+          || !(p_kv->p_section = strndup (ap_parser->section, PATH_MAX))
+          || !(p_kv->p_key = strndup (p_key, PATH_MAX)))
         {
-          char ** w;
-          w = p.we_wordv;
-          p_expanded = strndup (w[0], PATH_MAX);
+          if (p_kv)
+            {
+              tiz_mem_free (p_kv->p_section);
+              tiz_mem_free (p_kv);
+            }
+          return -1;
+        }
+      if (ap_parser->p_tail)
+        {
+          ap_parser->p_tail->p_next = p_kv;
         }
       else
         {
-          p_expanded = strndup (p_value, PATH_MAX);
+          ap_parser->p_keyvals = p_kv;
         }
-      wordfree (&p);
+      ap_parser->p_tail = p_kv;
+      ap_parser->count++;
     }
-  return p_expanded;
-}
-
-static char *
-shell_expand_value_in_place (char * p_value, value_t * p_value_list)
-{
-  char * p_expanded = p_value;
-  assert (p_value_list);
-  if (p_value && p_value_list)
+  else if (!is_list (p_key))
     {
-      wordexp_t p;
-      if (0 == wordexp (p_value, &p, 0) && p.we_wordc > 0)
-        {
-          char ** w;
-          w = p.we_wordv;
-          p_expanded = strndup (w[0], PATH_MAX);
-          /* Replace the existing value */
-          tiz_mem_free (p_value_list->p_value);
-          p_value_list->p_value = p_expanded;
-          wordfree (&p);
-        }
+      /* Replace the existing value */
+      free_values (p_kv->p_value_list);
+      p_kv->p_value_list = NULL;
+      p_kv->valcount = 0;
     }
-  return p_expanded;
+
+  ap_parser->p_last_kv = p_kv;
+  return add_values (p_kv, p_value);
 }
 
 static int
-analyze_pattern (FILE * ap_file, char * ap_str, keyval_t ** app_last_kv,
-                 tiz_rcfile_t * ap_tiz_rcfile)
+parse_line (rc_parser_t * ap_parser, char * ap_line)
 {
-  char * p_comment_ptr = NULL;
-  if ((p_comment_ptr = strstr (ap_str, "#")))
+  keyval_t * p_last_kv = NULL;
+  char * p_comment = NULL;
+  char * p_str = NULL;
+  size_t len = 0;
+
+  assert (ap_parser);
+  assert (ap_line);
+
+  /* A continuation line must immediately follow its key */
+  p_last_kv = ap_parser->p_last_kv;
+  ap_parser->p_last_kv = NULL;
+
+  /* Ignore the commented section of this line */
+  if ((p_comment = strchr (ap_line, '#')))
     {
-      char * str = trimcommenting (trimwhitespace (ap_str));
-      TIZ_LOG (TIZ_PRIORITY_TRACE, "Comment : [%s]", trimwhitespace (str));
-      (void) str;
-      /* Ignore the commented section of this line */
-      *p_comment_ptr = '\0';
+      *p_comment = '\0';
     }
 
-  if ('[' == ap_str[0] && ']' == ap_str[strlen (ap_str) - 1])
+  p_str = trimwhitespace (ap_line);
+  len = strlen (p_str);
+  if (0 == len)
     {
-      char * str = trimsectioning (ap_str);
-      TIZ_LOG (TIZ_PRIORITY_TRACE, "Section : [%s]", str);
-      (void) str;
+      return 0;
     }
-  else if (strstr (ap_str, "="))
+
+  if ('[' == p_str[0] && ']' == p_str[len - 1])
     {
-      char * str = trimwhitespace (ap_str);
-      TIZ_LOG (TIZ_PRIORITY_TRACE, "key-value pair : [%s]", str);
-      return extractkeyval (ap_file, str, app_last_kv, ap_tiz_rcfile);
+      snprintf (ap_parser->section, sizeof (ap_parser->section), "%s",
+                trimwhitespace (trimsectioning (p_str)));
+      TIZ_LOG (TIZ_PRIORITY_TRACE, "Section : [%s]", ap_parser->section);
+    }
+  else if (strchr (p_str, '='))
+    {
+      return add_keyval (ap_parser, p_str);
+    }
+  else if (p_last_kv && strchr (p_str, ';'))
+    {
+      /* More values for the previous key */
+      ap_parser->p_last_kv = p_last_kv;
+      return add_values (p_last_kv, p_str);
     }
 
   return 0;
 }
 
 static int
-load_rc_file (const file_info_t * ap_finfo, tiz_rcfile_t * ap_tiz_rcfile)
+load_rc_file (const file_info_t * ap_finfo, rc_parser_t * ap_parser)
 {
   FILE * p_file = 0;
-  int len;
-  keyval_t **pp_last_kv = NULL, *p_kv = NULL;
+  int ret = 0;
 
   assert (ap_finfo);
-  assert (ap_finfo->name);
-  assert (ap_tiz_rcfile);
+  assert (ap_parser);
 
   if ((p_file = fopen (ap_finfo->name, "r")) == 0)
     {
       return -1;
     }
 
-  if (!ap_tiz_rcfile->p_keyvals)
+  ap_parser->section[0] = '\0';
+  ap_parser->p_last_kv = NULL;
+
+  while (0 == ret && fgets (ap_parser->line, PAT_SIZE, p_file) != NULL)
     {
-      pp_last_kv = &ap_tiz_rcfile->p_keyvals;
+      ret = parse_line (ap_parser, ap_parser->line);
     }
-  else
+
+  fclose (p_file);
+
+  if (0 != ret)
+    {
+      TIZ_LOG (TIZ_PRIORITY_ERROR, "Could not allocate memory for [%s]",
+               ap_finfo->name);
+    }
+
+  return ret;
+}
+
+/*
+ * Snapshots
+ */
+
+static OMX_U32
+hash_key (const char * ap_section, const char * ap_key)
+{
+  /* FNV-1a over "section\0key" */
+  OMX_U32 hash = 2166136261u;
+  const unsigned char * p = NULL;
+  for (p = (const unsigned char *) ap_section; *p; ++p)
+    {
+      hash = (hash ^ *p) * 16777619u;
+    }
+  hash *= 16777619u;
+  for (p = (const unsigned char *) ap_key; *p; ++p)
     {
-      p_kv = ap_tiz_rcfile->p_keyvals;
-      for (;;)
+      hash = (hash ^ *p) * 16777619u;
+    }
+  return hash;
+}
+
+static void
+parse_typed_values (tiz_rcfile_entry_t * ap_entry)
+{
+  const char * p_value = NULL;
+  char * p_end = NULL;
+
+  assert (ap_entry);
+
+  if (0 == ap_entry->nvalues)
+    {
+      return;
+    }
+
+  p_value = ap_entry->pp_values[0];
+
+  errno = 0;
+  ap_entry->int_value = strtol (p_value, &p_end, 0);
+  ap_entry->is_int = (p_end != p_value && 0 == errno);
+  while (ap_entry->is_int && *p_end)
+    {
+      ap_entry->is_int = isspace (*p_end++);
+    }
+
+  if (0 == strcasecmp (p_value, "true") || 0 == strcasecmp (p_value, "yes")
+      || 0 == strcasecmp (p_value, "on") || 0 == strcmp (p_value, "1"))
+    {
+      ap_entry->bool_value = true;
+      ap_entry->is_bool = true;
+    }
+  else if (0 == strcasecmp (p_value, "false")
+           || 0 == strcasecmp (p_value, "no")
+           || 0 == strcasecmp (p_value, "off") || 0 == strcmp (p_value, "0"))
+    {
+      ap_entry->bool_value = false;
+      ap_entry->is_bool = true;
+    }
+}
+
+static void
+destroy_snapshot (tiz_rcfile_snapshot_t * ap_snap)
+{
+  if (ap_snap)
+    {
+      size_t i = 0;
+      for (i = 0; i < ap_snap->nentries; ++i)
         {
-          if (!p_kv || !p_kv->p_next)
+          tiz_rcfile_entry_t * p_entry = &(ap_snap->p_entries[i]);
+          unsigned long j = 0;
+          tiz_mem_free (p_entry->p_section);
+          tiz_mem_free (p_entry->p_key);
+          for (j = 0; p_entry->pp_values && j < p_entry->nvalues; ++j)
             {
-              pp_last_kv = &p_kv->p_next;
-              break;
+              tiz_mem_free (p_entry->pp_values[j]);
             }
-          p_kv = p_kv->p_next;
+          tiz_mem_free (p_entry->pp_values);
         }
+      tiz_mem_free (ap_snap->p_entries);
+      tiz_mem_free (ap_snap->pp_table);
+      tiz_mem_free (ap_snap);
+    }
+}
+
+static OMX_ERRORTYPE
+build_snapshot (rc_parser_t * ap_parser, tiz_rcfile_snapshot_t ** app_snap)
+{
+  tiz_rcfile_snapshot_t * p_snap = NULL;
+  keyval_t * p_kv = NULL;
+  size_t table_size = RC_TABLE_MIN_SIZE;
+  size_t i = 0;
+
+  assert (ap_parser);
+  assert (app_snap);
+
+  while (table_size < 2 * ap_parser->count)
+    {
+      table_size <<= 1;
+    }
+
+  if (!(p_snap = (tiz_rcfile_snapshot_t *) tiz_mem_calloc (
+          1, sizeof (tiz_rcfile_snapshot_t)))
+      || !(p_snap->p_entries = (tiz_rcfile_entry_t *) tiz_mem_calloc (
+             ap_parser->count, sizeof (tiz_rcfile_entry_t)))
+      || !(p_snap->pp_table = (tiz_rcfile_entry_t **) tiz_mem_calloc (
+             table_size, sizeof (tiz_rcfile_entry_t *))))
+    {
+      destroy_snapshot (p_snap);
+      return OMX_ErrorInsufficientResources;
     }
+  p_snap->table_mask = table_size - 1;
+  p_snap->generation
+    = __atomic_add_fetch (&g_rcfile_generation, 1, __ATOMIC_RELAXED);
 
-  for (;;)
+  for (p_kv = ap_parser->p_keyvals; p_kv; p_kv = p_kv->p_next, ++i)
     {
-      if (fgets (pat, PAT_SIZE, p_file) == NULL)
+      tiz_rcfile_entry_t * p_entry = &(p_snap->p_entries[i]);
+      value_t * p_v = NULL;
+      size_t slot = 0;
+
+      /* The entry takes over the parsed strings */
+      p_entry->p_snapshot = p_snap;
+      p_entry->p_section = p_kv->p_section;
+      p_entry->p_key = p_kv->p_key;
+      p_kv->p_section = NULL;
+      p_kv->p_key = NULL;
+      p_snap->nentries++;
+
+      if (!(p_entry->pp_values = (char **) tiz_mem_calloc (
+              p_kv->valcount + 1, sizeof (char *))))
         {
-          break;
+          destroy_snapshot (p_snap);
+          return OMX_ErrorInsufficientResources;
         }
 
-      len = strlen (pat);
-      if (len <= 1)
+      for (p_v = p_kv->p_value_list; p_v; p_v = p_v->p_next)
         {
-          continue;
+          char * p_expanded = shell_expand_value (p_v->p_value);
+          if (!p_expanded)
+            {
+              destroy_snapshot (p_snap);
+              return OMX_ErrorInsufficientResources;
+            }
+          p_entry->pp_values[p_entry->nvalues++] = p_expanded;
         }
 
-      if (pat[len - 1] == '\n')
+      parse_typed_values (p_entry);
+
+      p_entry->hash = hash_key (p_entry->p_section, p_entry->p_key);
+      slot = p_entry->hash & p_snap->table_mask;
+      while (p_snap->pp_table[slot])
         {
-          pat[len - 1] = '\0';
+          slot = (slot + 1) & p_snap->table_mask;
         }
+      p_snap->pp_table[slot] = p_entry;
+    }
 
-      while (analyze_pattern (p_file, pat, pp_last_kv, ap_tiz_rcfile))
-        {
-          if (pp_last_kv && *pp_last_kv)
-            {
-              pp_last_kv = &(*pp_last_kv)->p_next;
-              ap_tiz_rcfile->count++;
-            }
-        };
+  *app_snap = p_snap;
+  return OMX_ErrorNone;
+}
+
+static const tiz_rcfile_entry_t *
+lookup (const tiz_rcfile_snapshot_t * ap_snap, const char * ap_section,
+        const char * ap_key)
+{
+  const OMX_U32 hash = hash_key (ap_section, ap_key);
+  size_t slot = 0;
+  const tiz_rcfile_entry_t * p_entry = NULL;
 
-      if (pp_last_kv && *pp_last_kv)
+  assert (ap_snap);
+
+  slot = hash & ap_snap->table_mask;
+  while ((p_entry = ap_snap->pp_table[slot]))
+    {
+      if (p_entry->hash == hash && 0 == strcmp (p_entry->p_key, ap_key)
+          && 0 == strcmp (p_entry->p_section, ap_section))
         {
-          pp_last_kv = &(*pp_last_kv)->p_next;
-          ap_tiz_rcfile->count++;
+          return p_entry;
         }
+      slot = (slot + 1) & ap_snap->table_mask;
     }
+  return NULL;
+}
 
-  fclose (p_file);
+static inline const tiz_rcfile_snapshot_t *
+current_snapshot (void)
+{
+  tiz_rcfile_t * p_rc = tiz_rcfile_get_handle ();
+  return p_rc ? __atomic_load_n (&(p_rc->p_snapshot), __ATOMIC_ACQUIRE)
+              : NULL;
+}
 
-  return 0;
+static const tiz_rcfile_entry_t *
+find_entry (const char * ap_section, const char * ap_key)
+{
+  const tiz_rcfile_snapshot_t * p_snap = current_snapshot ();
+  const tiz_rcfile_entry_t * p_entry = NULL;
+
+  assert (ap_section);
+  assert (ap_key);
+
+  if (p_snap && !(p_entry = lookup (p_snap, ap_section, ap_key)))
+    {
+      TIZ_LOG (TIZ_PRIORITY_TRACE, "Key not found [%s] in section [%s]",
+               ap_key, ap_section);
+    }
+  return p_entry;
+}
+
+static const tiz_rcfile_entry_t *
+find_entry_cached (tiz_rcfile_cache_t * ap_cache, const char * ap_section,
+                   const char * ap_key)
+{
+  const tiz_rcfile_snapshot_t * p_snap = current_snapshot ();
+  const tiz_rcfile_entry_t * p_entry = NULL;
+
+  assert (ap_cache);
+
+  if (!p_snap)
+    {
+      return NULL;
+    }
+
+  /* A cached entry may belong to a snapshot freed by tiz_rcfile_destroy, so
+     it is only dereferenced if it was stored with the current generation.
+     The entry is stored before its generation; an entry seen through a
+     matching generation is at worst from a retired (but not freed) snapshot
+     of the same configuration store. */
+  if (__atomic_load_n (&(ap_cache->generation), __ATOMIC_ACQUIRE)
+      == p_snap->generation)
+    {
+      p_entry = __atomic_load_n (&(ap_cache->p_entry), __ATOMIC_RELAXED);
+      if (p_entry && p_entry->p_snapshot == p_snap)
+        {
+          return p_entry;
+        }
+    }
+
+  if ((p_entry = find_entry (ap_section, ap_key)))
+    {
+      __atomic_store_n (&(ap_cache->p_entry), (const void *) p_entry,
+                        __ATOMIC_RELAXED);
+      __atomic_store_n (&(ap_cache->generation),
+                        p_entry->p_snapshot->generation, __ATOMIC_RELEASE);
+    }
+  return p_entry;
 }
 
 static int
@@ -587,18 +793,23 @@ obtain_xdg_config_dir (void)
   char rcfile[PATH_MAX + NAME_MAX - 2];
   char * p_env_str = NULL;
 
-  if ((p_env_str = getenv ("XDG_CONFIG_DIRS")))
+  /* NOTE: The search runs again on every reload; work on a copy so that the
+     environment is left untouched */
+  if ((p_env_str = getenv ("XDG_CONFIG_DIRS"))
+      && (p_env_str = strndup (p_env_str, PATH_MAX)))
     {
       char * pch = NULL;
+      char * p_save = NULL;
       TIZ_LOG (TIZ_PRIORITY_TRACE, "XDG_CONFIG_DIRS [%s] ...", p_env_str);
-      pch = strtok (p_env_str, ":");
+      pch = strtok_r (p_env_str, ":", &p_save);
       while (pch != NULL && found != 0)
         {
           TIZ_LOG (TIZ_PRIORITY_TRACE, "XDG_CONFIG_DIR - [%s] ...", pch);
           snprintf (rcfile, FILE_PATH_MAX, "%s/tizonia/tizonia.conf", pch);
           found = try_open_file (rcfile);
-          pch = strtok (NULL, ":");
+          pch = strtok_r (NULL, ":", &p_save);
         }
+      free (p_env_str);
     }
 
   /* Try /etc/xdg */
@@ -656,14 +867,14 @@ obtain_tizonia_rc_file_config (void)
     }
 }
 
-OMX_ERRORTYPE
-tiz_rcfile_init (tiz_rcfile_t ** pp_rc)
+static OMX_ERRORTYPE
+load_snapshot (tiz_rcfile_snapshot_t ** app_snap)
 {
   OMX_ERRORTYPE rc = OMX_ErrorNone;
+  rc_parser_t * p_parser = NULL;
   int i;
-  tiz_rcfile_t * p_rc = NULL;
 
-  assert (pp_rc);
+  assert (app_snap);
 
   /* Retrieve the config file from $XDG_CONFIG_DIRS (g_rcfiles[0]) */
   obtain_xdg_config_dir ();
@@ -677,11 +888,11 @@ tiz_rcfile_init (tiz_rcfile_t ** pp_rc)
   /* Load rc files */
   TIZ_LOG (TIZ_PRIORITY_TRACE, "Looking for [%d] rc files...", g_num_rcfiles);
 
-  if (!(p_rc = (tiz_rcfile_t *) tiz_mem_calloc (1, sizeof (tiz_rcfile_t))))
+  if (!(p_parser = (rc_parser_t *) tiz_mem_calloc (1, sizeof (rc_parser_t))))
     {
       TIZ_LOG (TIZ_PRIORITY_TRACE,
                "Could not allocate memory "
-               "for tiz_rcfile_t...");
+               "for rc_parser_t...");
       return OMX_ErrorInsufficientResources;
     }
 
@@ -708,10 +919,11 @@ tiz_rcfile_init (tiz_rcfile_t ** pp_rc)
           continue;
         }
 
-      if (0 != load_rc_file (&g_rcfiles[i], p_rc))
+      if (0 != load_rc_file (&g_rcfiles[i], p_parser))
         {
           TIZ_LOG (TIZ_PRIORITY_TRACE, "Loading [%s] rc file failed",
                    g_rcfiles[i].name);
+          free_keyvals (p_parser);
           continue;
         }
 
@@ -723,31 +935,91 @@ tiz_rcfile_init (tiz_rcfile_t ** pp_rc)
       break;
     }
 
-  if (p_rc->count)
+  if (p_parser->count)
     {
-      *pp_rc = p_rc;
+      rc = build_snapshot (p_parser, app_snap);
     }
   else
     {
-      *pp_rc = NULL;
-      tiz_mem_free (p_rc);
       rc = OMX_ErrorInsufficientResources;
     }
 
+  free_keyvals (p_parser);
+  tiz_mem_free (p_parser);
+
   return rc;
 }
 
-const char *
-tiz_rcfile_get_value (const char * ap_section, const char * ap_key)
+OMX_ERRORTYPE
+tiz_rcfile_init (tiz_rcfile_t ** pp_rc)
 {
-  keyval_t * p_kv = NULL;
-  tiz_rcfile_t * p_rc = tiz_rcfile_get_handle ();
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  tiz_rcfile_t * p_rc = NULL;
 
-  if (!p_rc)
+  assert (pp_rc);
+  *pp_rc = NULL;
+
+  if (!(p_rc = (tiz_rcfile_t *) tiz_mem_calloc (1, sizeof (tiz_rcfile_t))))
     {
-      return NULL;
+      TIZ_LOG (TIZ_PRIORITY_TRACE,
+               "Could not allocate memory "
+               "for tiz_rcfile_t...");
+      return OMX_ErrorInsufficientResources;
+    }
+
+  if (OMX_ErrorNone != (rc = load_snapshot (&(p_rc->p_snapshot))))
+    {
+      tiz_mem_free (p_rc);
+      return rc;
+    }
+
+  *pp_rc = p_rc;
+  return rc;
+}
+
+OMX_ERRORTYPE
+tiz_rcfile_reload (tiz_rcfile_t * p_rc)
+{
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  tiz_rcfile_snapshot_t * p_new = NULL;
+  tiz_rcfile_snapshot_t * p_old = NULL;
+
+  assert (p_rc);
+
+  if (OMX_ErrorNone != (rc = load_snapshot (&p_new)))
+    {
+      /* Keep using the current configuration */
+      TIZ_LOG (TIZ_PRIORITY_NOTICE,
+               "Unable to reload the configuration file; keeping the current "
+               "one");
+      return rc;
     }
 
+  p_old = __atomic_exchange_n (&(p_rc->p_snapshot), p_new, __ATOMIC_ACQ_REL);
+
+  /* Readers may still hold the strings handed out by tiz_rcfile_get_value, or
+     entries cached at their call sites, so the old snapshot is retired, not
+     freed. */
+  p_old->p_next_retired = p_rc->p_retired;
+  p_rc->p_retired = p_old;
+
+  TIZ_LOG (TIZ_PRIORITY_NOTICE, "Configuration reloaded (generation [%lu])",
+           p_new->generation);
+  return rc;
+}
+
+const char *
+tiz_rcfile_get_path (const int a_index)
+{
+  return (a_index >= 0 && a_index < g_num_rcfiles) ? g_rcfiles[a_index].name
+                                                   : NULL;
+}
+
+const char *
+tiz_rcfile_get_value (const char * ap_section, const char * ap_key)
+{
+  const tiz_rcfile_entry_t * p_entry = NULL;
+
   assert (ap_section);
   assert (ap_key);
   assert (is_list (ap_key) == false);
@@ -755,29 +1027,16 @@ tiz_rcfile_get_value (const char * ap_section, const char * ap_key)
   TIZ_LOG (TIZ_PRIORITY_TRACE, "Retrieving value for Key [%s] in section [%s]",
            ap_key, ap_section);
 
-  p_kv = find_node (p_rc, ap_key);
-  if (p_kv && p_kv->p_value_list)
-    {
-      return shell_expand_value_in_place (p_kv->p_value_list->p_value,
-                                          p_kv->p_value_list);
-    }
-
-  return NULL;
+  p_entry = find_entry (ap_section, ap_key);
+  return (p_entry && p_entry->nvalues > 0) ? p_entry->pp_values[0] : NULL;
 }
 
 char **
 tiz_rcfile_get_value_list (const char * ap_section, const char * ap_key,
                            unsigned long * ap_length)
 {
-  keyval_t * p_kv = NULL;
+  const tiz_rcfile_entry_t * p_entry = NULL;
   char ** pp_ret = NULL;
-  value_t * p_next_value = NULL;
-  tiz_rcfile_t * p_rc = tiz_rcfile_get_handle ();
-
-  if (!p_rc)
-    {
-      return NULL;
-    }
 
   assert (ap_section);
   assert (ap_key);
@@ -789,55 +1048,84 @@ tiz_rcfile_get_value_list (const char * ap_section, const char * ap_key,
            "for Key [%s] in section [%s]",
            ap_key, ap_section);
 
-  p_kv = find_node (p_rc, ap_key);
-  if (p_kv)
+  p_entry = find_entry (ap_section, ap_key);
+  if (p_entry && p_entry->nvalues > 0
+      && (pp_ret = (char **) tiz_mem_alloc (sizeof (char *) * p_entry->nvalues)))
     {
-      int i = 0;
-      *ap_length = p_kv->valcount;
-      pp_ret = (char **) tiz_mem_alloc (sizeof (char *) * p_kv->valcount);
-
-      p_next_value = p_kv->p_value_list;
-      for (i = 0; i < p_kv->valcount; ++i)
+      unsigned long i = 0;
+      *ap_length = p_entry->nvalues;
+      for (i = 0; i < p_entry->nvalues; ++i)
         {
-          if (p_next_value)
-            {
-              pp_ret[i] = shell_expand_value (p_next_value->p_value);
-              p_next_value = p_next_value->p_next;
-            }
+          pp_ret[i] = strndup (p_entry->pp_values[i], PATH_MAX);
         }
     }
 
   return pp_ret;
 }
 
+const char * const *
+tiz_rcfile_get_list (const char * ap_section, const char * ap_key,
+                     unsigned long * ap_length)
+{
+  const tiz_rcfile_entry_t * p_entry = find_entry (ap_section, ap_key);
+  assert (ap_length);
+  *ap_length = p_entry ? p_entry->nvalues : 0;
+  return p_entry ? (const char * const *) p_entry->pp_values : NULL;
+}
+
+long
+tiz_rcfile_get_int (const char * ap_section, const char * ap_key,
+                    const long a_default)
+{
+  const tiz_rcfile_entry_t * p_entry = find_entry (ap_section, ap_key);
+  return (p_entry && p_entry->is_int) ? p_entry->int_value : a_default;
+}
+
+bool
+tiz_rcfile_get_bool (const char * ap_section, const char * ap_key,
+                     const bool a_default)
+{
+  const tiz_rcfile_entry_t * p_entry = find_entry (ap_section, ap_key);
+  return (p_entry && p_entry->is_bool) ? p_entry->bool_value : a_default;
+}
+
+long
+tiz_rcfile_get_int_cached (tiz_rcfile_cache_t * ap_cache,
+                           const char * ap_section, const char * ap_key,
+                           const long a_default)
+{
+  const tiz_rcfile_entry_t * p_entry
+    = find_entry_cached (ap_cache, ap_section, ap_key);
+  return (p_entry && p_entry->is_int) ? p_entry->int_value : a_default;
+}
+
+bool
+tiz_rcfile_get_bool_cached (tiz_rcfile_cache_t * ap_cache,
+                            const char * ap_section, const char * ap_key,
+                            const bool a_default)
+{
+  const tiz_rcfile_entry_t * p_entry
+    = find_entry_cached (ap_cache, ap_section, ap_key);
+  return (p_entry && p_entry->is_bool) ? p_entry->bool_value : a_default;
+}
+
 void
 tiz_rcfile_destroy (tiz_rcfile_t * p_rc)
 {
-  keyval_t * p_kv_lst = NULL;
-  keyval_t * p_kvt = NULL;
-  value_t * p_val_lst = NULL;
+  tiz_rcfile_snapshot_t * p_snap = NULL;
 
   if (!p_rc)
     {
       return;
     }
 
-  p_kv_lst = p_rc->p_keyvals;
-  while (p_kv_lst)
+  destroy_snapshot (p_rc->p_snapshot);
+  p_snap = p_rc->p_retired;
+  while (p_snap)
     {
-      value_t * p_vt = NULL;
-      tiz_mem_free (p_kv_lst->p_key);
-      p_val_lst = p_kv_lst->p_value_list;
-      while (p_val_lst)
-        {
-          p_vt = p_val_lst;
-          p_val_lst = p_val_lst->p_next;
-          tiz_mem_free (p_vt->p_value);
-          tiz_mem_free (p_vt);
-        }
-      p_kvt = p_kv_lst;
-      p_kv_lst = p_kv_lst->p_next;
-      tiz_mem_free (p_kvt);
+      tiz_rcfile_snapshot_t * p_next = p_snap->p_next_retired;
+      destroy_snapshot (p_snap);
+      p_snap = p_next;
     }
 
   tiz_mem_free (p_rc);
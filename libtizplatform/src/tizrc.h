@@ -39,11 +39,55 @@ extern "C"
  * @ingroup libtizplatform
  */
 
+#include <stdbool.h>
+
 #include <OMX_Core.h>
 #include <OMX_Types.h>
 
 #define TIZ_RCFILE_PLUGINS_DATA_SECTION "plugins"
 
+  /**
+ * Per-call-site lookup cache, used by the TIZ_RCFILE_GET_* macros. The entry
+ * is only dereferenced when the generation matches the current snapshot's;
+ * generations are unique for the lifetime of the process.
+ *
+ * @ingroup tizrcfile
+ */
+  typedef struct tiz_rcfile_cache tiz_rcfile_cache_t;
+  struct tiz_rcfile_cache
+  {
+    const void * p_entry;
+    unsigned long generation;
+  };
+
+  /**
+ * Retrieve an integer value, caching the lookup at the call site. The cached
+ * entry is re-validated when the configuration file is reloaded. The section
+ * and key must be the same every time the call site is executed.
+ *
+ * @ingroup tizrcfile
+ */
+#define TIZ_RCFILE_GET_INT(section, key, default_value)                    \
+  __extension__({                                                          \
+    static tiz_rcfile_cache_t tiz_rcfile_cache__ = {NULL, 0};              \
+    tiz_rcfile_get_int_cached (&tiz_rcfile_cache__, (section), (key),      \
+                               (default_value));                           \
+  })
+
+  /**
+ * Retrieve a boolean value, caching the lookup at the call site. The cached
+ * entry is re-validated when the configuration file is reloaded. The section
+ * and key must be the same every time the call site is executed.
+ *
+ * @ingroup tizrcfile
+ */
+#define TIZ_RCFILE_GET_BOOL(section, key, default_value)                   \
+  __extension__({                                                          \
+    static tiz_rcfile_cache_t tiz_rcfile_cache__ = {NULL, 0};              \
+    tiz_rcfile_get_bool_cached (&tiz_rcfile_cache__, (section), (key),     \
+                                (default_value));                          \
+  })
+
   /**
  * Returns a value string from a give section using the value's key
  *
@@ -54,8 +98,9 @@ extern "C"
  *
  * @param key A search key in the specified section.
  *
- * @return A newly allocated string or NULL if the specified key cannot be
- *found.
+ * @return The value or NULL if the specified key cannot be found. The string
+ * is owned by the configuration store and stays valid for the lifetime of the
+ * process, even if the configuration file is reloaded.
  */
   const char *
   tiz_rcfile_get_value (const char * section, const char * key);
@@ -79,6 +124,78 @@ extern "C"
   tiz_rcfile_get_value_list (const char * section, const char * key,
                              unsigned long * length);
 
+  /**
+ * Returns the list of values of a key, without copying them.
+ *
+ * @ingroup tizrcfile
+ *
+ * @param section The section where the key is to be found.
+ *
+ * @param key A search key in the specified section.
+ *
+ * @param length On return, the length of the list (zero if not found).
+ *
+ * @return A NULL-terminated array owned by the configuration store, or NULL
+ * if the specified key cannot be found.
+ */
+  const char * const *
+  tiz_rcfile_get_list (const char * section, const char * key,
+                       unsigned long * length);
+
+  /**
+ * Returns an integer value.
+ *
+ * @ingroup tizrcfile
+ *
+ * @param section The section where the key is to be found.
+ *
+ * @param key A search key in the specified section.
+ *
+ * @param default_value The value returned if the key cannot be found or its
+ * value is not an integer.
+ *
+ * @return The value.
+ */
+  long
+  tiz_rcfile_get_int (const char * section, const char * key,
+                      const long default_value);
+
+  /**
+ * Returns a boolean value (true/false, yes/no, on/off or 1/0).
+ *
+ * @ingroup tizrcfile
+ *
+ * @param section The section where the key is to be found.
+ *
+ * @param key A search key in the specified section.
+ *
+ * @param default_value The value returned if the key cannot be found or its
+ * value is not a boolean.
+ *
+ * @return The value.
+ */
+  bool
+  tiz_rcfile_get_bool (const char * section, const char * key,
+                       const bool default_value);
+
+  /**
+ * Like tiz_rcfile_get_int, with a lookup cache. See TIZ_RCFILE_GET_INT.
+ *
+ * @ingroup tizrcfile
+ */
+  long
+  tiz_rcfile_get_int_cached (tiz_rcfile_cache_t * cache, const char * section,
+                             const char * key, const long default_value);
+
+  /**
+ * Like tiz_rcfile_get_bool, with a lookup cache. See TIZ_RCFILE_GET_BOOL.
+ *
+ * @ingroup tizrcfile
+ */
+  bool
+  tiz_rcfile_get_bool_cached (tiz_rcfile_cache_t * cache, const char * section,
+                              const char * key, const bool default_value);
+
   /**
  * Returns an integer less than, equal to, or greater than zero if the
  * section-key-value triad provided is respectively, not found, found and
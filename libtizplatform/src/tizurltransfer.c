@@ -206,6 +206,8 @@ struct tiz_urltrans
   unsigned int curl_version_;
   char curl_err[CURL_ERROR_SIZE];
   bool handshake_error_found;
+  bool icy_metadata_;
+  tiz_icy_t * p_icy_;
 };
 
 /*@observer@*/ const char *
@@ -666,6 +668,168 @@ report_connection_lost_event (tiz_urltrans_t * ap_trans)
     }
 }
 
+static void
+update_icy_demuxer (tiz_urltrans_t * ap_trans, const char * ap_line,
+                    const size_t a_len)
+{
+  tiz_http_header_t hdr;
+  assert (ap_trans);
+
+  if (!tiz_http_header_parse (ap_line, a_len, &hdr))
+    {
+      /* A status line starts a new response (e.g. after a redirection or a
+         reconnection); metadata is only expected if this response announces
+         it */
+      if (a_len > 4 && (strncmp (ap_line, "HTTP", 4) == 0
+                        || strncmp (ap_line, "ICY ", 4) == 0))
+        {
+          tiz_icy_destroy (ap_trans->p_icy_);
+          ap_trans->p_icy_ = NULL;
+        }
+    }
+  else if (tiz_http_header_is (&hdr, "icy-metaint"))
+    {
+      const long metaint = tiz_http_header_int (&hdr);
+      TIZ_LOG (TIZ_PRIORITY_TRACE, "icy-metaint : [%ld]", metaint);
+      if (metaint > 0)
+        {
+          if (ap_trans->p_icy_)
+            {
+              tiz_icy_reset (ap_trans->p_icy_, metaint);
+            }
+          else if (OMX_ErrorNone != tiz_icy_init (&(ap_trans->p_icy_), metaint))
+            {
+              TIZ_LOG (TIZ_PRIORITY_ERROR,
+                       "[OMX_ErrorInsufficientResources] : "
+                       "Unable to init the ICY metadata demuxer");
+            }
+        }
+    }
+}
+
+/* Hands the data over to the client's buffers once the internal buffer has
+   passed its high watermark. Returns the number of bytes that remain to be
+   stored. */
+static size_t
+send_data (tiz_urltrans_t * ap_trans, char ** app_ptr, size_t a_nbytes)
+{
+  OMX_BUFFERHEADERTYPE * p_out = NULL;
+  assert (ap_trans);
+  assert (app_ptr);
+
+  if (is_passed_buffer_high_watermark (ap_trans))
+    {
+      /* Reset the cache size */
+      ap_trans->internal_buffer_size_initial_ = 0;
+
+      send_from_internal_buffer (ap_trans);
+
+      while (a_nbytes > 0
+             && (p_out = ap_trans->buffer_cbacks_.pf_buf_emptied (
+                   ap_trans->p_parent_))
+                  != NULL)
+        {
+          int nbytes_copied = copy_to_omx_buffer (p_out, *app_ptr, a_nbytes);
+          TIZ_PRINTF_DBG_CYN ("Releasing buffer with size [%u]",
+                              (unsigned int) p_out->nFilledLen);
+          ap_trans->buffer_cbacks_.pf_buf_filled (p_out, ap_trans->p_parent_);
+          a_nbytes -= nbytes_copied;
+          *app_ptr += nbytes_copied;
+        }
+    }
+  return a_nbytes;
+}
+
+static void
+store_data (tiz_urltrans_t * ap_trans, char * ap_ptr, const size_t a_nbytes)
+{
+  int nbytes_available = 0;
+  assert (ap_trans);
+  if ((nbytes_available = tiz_buffer_push (ap_trans->p_store_, ap_ptr, a_nbytes))
+      < a_nbytes)
+    {
+      TIZ_LOG (TIZ_PRIORITY_ERROR,
+               "Unable to store all the data (wanted %d, "
+               "stored %d).",
+               a_nbytes, nbytes_available);
+    }
+}
+
+static inline bool
+is_cache_full (tiz_urltrans_t * ap_trans)
+{
+  assert (ap_trans);
+  return (tiz_buffer_available (ap_trans->p_store_)
+          > (ap_trans->internal_buffer_size_));
+}
+
+static size_t
+pause_curl (tiz_urltrans_t * ap_trans)
+{
+  assert (ap_trans);
+  set_curl_state (ap_trans, ECurlStatePaused);
+  /* Also stop the watchers */
+  stop_io_watcher (ap_trans);
+  stop_curl_timer_watcher (ap_trans);
+  return CURL_WRITEFUNC_PAUSE;
+}
+
+/* With ICY metadata, the stream is split into audio spans, which are passed
+   on exactly as plain stream data would be, and metadata blocks, which are
+   consumed here. Once metadata bytes have been consumed they can't be handed
+   back to curl, so the decision to pause the transfer is taken before any
+   demuxing. */
+static size_t
+write_icy_data (tiz_urltrans_t * ap_trans, char * ap_ptr, size_t a_nbytes)
+{
+  const size_t rc = a_nbytes;
+  const size_t ahead = tiz_icy_audio_ahead (ap_trans->p_icy_);
+  assert (ap_trans);
+
+  if (ahead > 0
+      && ap_trans->info_cbacks_.pf_data_avail (ap_trans->p_parent_, ap_ptr,
+                                               MIN (ahead, a_nbytes)))
+    {
+      return pause_curl (ap_trans);
+    }
+
+  if (!is_passed_buffer_high_watermark (ap_trans) && is_cache_full (ap_trans))
+    {
+      TIZ_PRINTF_DBG_GRN ("Pausing curl - cache size [%d]",
+                          tiz_buffer_available (ap_trans->p_store_));
+      return pause_curl (ap_trans);
+    }
+
+  while (a_nbytes > 0)
+    {
+      size_t audio_len = 0;
+      const size_t consumed = tiz_icy_demux (
+        ap_trans->p_icy_, (const OMX_U8 *) ap_ptr, a_nbytes, &audio_len);
+      if (audio_len > 0)
+        {
+          char * p_audio = ap_ptr;
+          const size_t remaining = send_data (ap_trans, &p_audio, audio_len);
+          if (remaining > 0)
+            {
+              store_data (ap_trans, p_audio, remaining);
+            }
+        }
+      else
+        {
+          const char * p_title = tiz_icy_take_title (ap_trans->p_icy_);
+          if (p_title && ap_trans->info_cbacks_.pf_stream_title)
+            {
+              ap_trans->info_cbacks_.pf_stream_title (ap_trans->p_parent_,
+                                                      p_title);
+            }
+        }
+      ap_ptr += consumed;
+      a_nbytes -= consumed;
+    }
+
+  return rc;
+}
+
 /* This function gets called by libcurl as soon as it has received header
    data. The header callback will be called once for each header and only
    complete header lines are passed on to the callback. Parsing headers is very
@@ -685,6 +849,10 @@ curl_header_cback (void * ptr, size_t size, size_t nmemb, void * userdata)
   assert (p_trans->info_cbacks_.pf_header_avail);
   URLTRANS_LOG_CBACK_START (p_trans);
   stop_reconnect_timer_watcher (p_trans);
+  if (p_trans->icy_metadata_)
+    {
+      update_icy_demuxer (p_trans, ptr, nbytes);
+    }
   p_trans->info_cbacks_.pf_header_avail (p_trans->p_parent_, ptr, nbytes);
   URLTRANS_LOG_CBACK_END (p_trans);
   return nbytes;
@@ -708,70 +876,34 @@ curl_write_cback (void * ptr, size_t size, size_t nmemb, void * userdata)
   if (nbytes > 0)
     {
       set_curl_state (p_trans, ECurlStateTransfering);
-      OMX_BUFFERHEADERTYPE * p_out = NULL;
 
-      if (p_trans->info_cbacks_.pf_data_avail (p_trans->p_parent_, ptr, nbytes))
+      if (p_trans->p_icy_)
         {
-          /* Stop the watchers */
-          stop_io_watcher (p_trans);
-          stop_curl_timer_watcher (p_trans);
-
-          /* Pause curl */
-
-          rc = CURL_WRITEFUNC_PAUSE;
-          set_curl_state (p_trans, ECurlStatePaused);
+          rc = write_icy_data (p_trans, ptr, nbytes);
+        }
+      else if (p_trans->info_cbacks_.pf_data_avail (p_trans->p_parent_, ptr,
+                                                    nbytes))
+        {
+          /* Pause curl, and stop the watchers */
+          rc = pause_curl (p_trans);
         }
       else
         {
-
-          if (is_passed_buffer_high_watermark (p_trans))
-            {
-              /* Reset the cache size */
-              p_trans->internal_buffer_size_initial_ = 0;
-
-              send_from_internal_buffer (p_trans);
-
-              while (nbytes > 0
-                     && (p_out = p_trans->buffer_cbacks_.pf_buf_emptied (
-                           p_trans->p_parent_))
-                          != NULL)
-                {
-                  int nbytes_copied = copy_to_omx_buffer (p_out, ptr, nbytes);
-                  TIZ_PRINTF_DBG_CYN ("Releasing buffer with size [%u]",
-                                      (unsigned int) p_out->nFilledLen);
-                  p_trans->buffer_cbacks_.pf_buf_filled (p_out,
-                                                         p_trans->p_parent_);
-                  nbytes -= nbytes_copied;
-                  ptr += nbytes_copied;
-                }
-            }
+          char * p_data = ptr;
+          nbytes = send_data (p_trans, &p_data, nbytes);
 
           if (nbytes > 0)
             {
-              if (tiz_buffer_available (p_trans->p_store_)
-                  > (p_trans->internal_buffer_size_))
+              if (is_cache_full (p_trans))
                 {
                   /* This is to pause curl */
                   TIZ_PRINTF_DBG_GRN ("Pausing curl - cache size [%d]",
                                       tiz_buffer_available (p_trans->p_store_));
-                  rc = CURL_WRITEFUNC_PAUSE;
-                  set_curl_state (p_trans, ECurlStatePaused);
-                  /* Also stop the watchers */
-                  stop_io_watcher (p_trans);
-                  stop_curl_timer_watcher (p_trans);
+                  rc = pause_curl (p_trans);
                 }
               else
                 {
-                  int nbytes_available = 0;
-                  if ((nbytes_available
-                       = tiz_buffer_push (p_trans->p_store_, ptr, nbytes))
-                      < nbytes)
-                    {
-                      TIZ_LOG (TIZ_PRIORITY_ERROR,
-                               "Unable to store all the data (wanted %d, "
-                               "stored %d).",
-                               nbytes, nbytes_available);
-                    }
+                  store_data (p_trans, p_data, nbytes);
                 }
             }
         }
@@ -1023,7 +1155,8 @@ allocate_curl_resources (tiz_urltrans_t * ap_trans)
   /* this is to ask libcurl to accept ICY OK headers*/
   bail_on_oom ((ap_trans->p_http_ok_aliases_ = curl_slist_append (
                   ap_trans->p_http_ok_aliases_, "ICY 200 OK")));
-  /* and this is to not ask the server for Icy metadata, for now */
+  /* and this is to not ask the server for Icy metadata, unless the client
+     requests it (see tiz_urltrans_request_icy_metadata) */
   bail_on_oom ((ap_trans->p_http_headers_ = curl_slist_append (
                   ap_trans->p_http_headers_, "Icy-MetaData:0")));
 
@@ -1114,6 +1247,8 @@ tiz_urltrans_init (tiz_urltrans_ptr_t * app_trans, void * ap_parent,
           p_trans->curl_state_ = ECurlStateStopped;
           p_trans->curl_version_ = 0;
           p_trans->handshake_error_found = false;
+          p_trans->icy_metadata_ = false;
+          p_trans->p_icy_ = NULL;
 
           rc = allocate_temp_data_store (p_trans);
           goto_end_on_omx_error (rc, "Unable to alloc the data store");
@@ -1145,6 +1280,7 @@ tiz_urltrans_destroy (tiz_urltrans_t * ap_trans)
       destroy_temp_data_store (ap_trans);
       destroy_events (ap_trans);
       destroy_curl_resources (ap_trans);
+      tiz_icy_destroy (ap_trans->p_icy_);
       curl_global_cleanup ();
     }
 }
@@ -1189,6 +1325,40 @@ tiz_urltrans_set_internal_buffer_size (tiz_urltrans_t * ap_trans,
   URLTRANS_LOG_API_END (ap_trans);
 }
 
+OMX_ERRORTYPE
+tiz_urltrans_request_icy_metadata (tiz_urltrans_t * ap_trans,
+                                   const bool a_enable)
+{
+  OMX_ERRORTYPE rc = OMX_ErrorInsufficientResources;
+  struct curl_slist * p_headers = NULL;
+  assert (ap_trans);
+  URLTRANS_LOG_API_START (ap_trans);
+
+  bail_on_oom ((p_headers = curl_slist_append (
+                  NULL, a_enable ? "Icy-MetaData:1" : "Icy-MetaData:0")));
+  bail_on_curl_error (
+    curl_easy_setopt (ap_trans->p_curl_, CURLOPT_HTTPHEADER, p_headers));
+
+  curl_slist_free_all (ap_trans->p_http_headers_);
+  ap_trans->p_http_headers_ = p_headers;
+  p_headers = NULL;
+  ap_trans->icy_metadata_ = a_enable;
+  if (!a_enable)
+    {
+      tiz_icy_destroy (ap_trans->p_icy_);
+      ap_trans->p_icy_ = NULL;
+    }
+
+  /* all ok */
+  rc = OMX_ErrorNone;
+
+end:
+
+  curl_slist_free_all (p_headers);
+  URLTRANS_LOG_API_END (ap_trans);
+  return rc;
+}
+
 OMX_ERRORTYPE
 tiz_urltrans_start (tiz_urltrans_t * ap_trans)
 {
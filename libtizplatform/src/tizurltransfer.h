@@ -111,6 +111,18 @@ extern "C"
  */
   typedef bool (*tiz_urltrans_connection_lost_f) (OMX_PTR ap_arg);
 
+  /**
+ * This callback is invoked when a new stream title is found in the ICY
+ * metadata interleaved with the audio data (see
+ * tiz_urltrans_request_icy_metadata).
+ *
+ * @param ap_arg The client data structure.
+ * @param ap_title The zero-terminated stream title.
+ *
+ */
+  typedef void (*tiz_urltrans_stream_title_f) (OMX_PTR ap_arg,
+                                               const char * ap_title);
+
   /**
  * @brief Buffer callbacks registration structure (typedef).
  * @ingroup tizurltransfer
@@ -147,6 +159,7 @@ extern "C"
     tiz_urltrans_header_available_f pf_header_avail;
     tiz_urltrans_data_available_f pf_data_avail;
     tiz_urltrans_connection_lost_f pf_connection_lost;
+    tiz_urltrans_stream_title_f pf_stream_title; /* may be NULL */
   };
 
   /**
@@ -308,6 +321,18 @@ extern "C"
   tiz_urltrans_set_internal_buffer_size (tiz_urltrans_t * ap_trans,
                                          const int a_nbytes);
 
+  /**
+ * @brief Ask the server for in-band ICY metadata ('Icy-MetaData:1') on the
+ * next connection. The metadata blocks are removed from the stream, and the
+ * stream titles are reported via the pf_stream_title callback. By default,
+ * no metadata is requested.
+ *
+ * @ingroup tizurltransfer
+ */
+  OMX_ERRORTYPE
+  tiz_urltrans_request_icy_metadata (tiz_urltrans_t * ap_trans,
+                                     const bool a_enable);
+
   OMX_ERRORTYPE
   tiz_urltrans_start (tiz_urltrans_t * ap_trans);
 
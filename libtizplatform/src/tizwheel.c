@@ -0,0 +1,360 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   tizwheel.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia Platform - Hierarchical timer wheel
+ *
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+
+#include "tizmem.h"
+#include "tizmacros.h"
+#include "tizwheel.h"
+
+#define TIZ_WHEEL_L0_BITS 8
+#define TIZ_WHEEL_L0_SIZE (1 << TIZ_WHEEL_L0_BITS)
+#define TIZ_WHEEL_L0_MASK (TIZ_WHEEL_L0_SIZE - 1)
+#define TIZ_WHEEL_LN_BITS 6
+#define TIZ_WHEEL_LN_SIZE (1 << TIZ_WHEEL_LN_BITS)
+#define TIZ_WHEEL_LN_MASK (TIZ_WHEEL_LN_SIZE - 1)
+#define TIZ_WHEEL_LN_LEVELS 3
+#define TIZ_WHEEL_SHIFT(level) \
+  (TIZ_WHEEL_L0_BITS + (level) *TIZ_WHEEL_LN_BITS)
+#define TIZ_WHEEL_MAX_DELTA \
+  ((UINT64_C (1) << TIZ_WHEEL_SHIFT (TIZ_WHEEL_LN_LEVELS)) - 1)
+
+struct tiz_wheel
+{
+  uint64_t now; /* The next tick to be processed */
+  size_t count;
+  tiz_wheel_timer_t l0[TIZ_WHEEL_L0_SIZE];
+  tiz_wheel_timer_t ln[TIZ_WHEEL_LN_LEVELS][TIZ_WHEEL_LN_SIZE];
+  tiz_wheel_timer_t expired;
+};
+
+/* The slots are circular lists with a sentinel head */
+
+static inline void
+list_init (tiz_wheel_timer_t * ap_head)
+{
+  ap_head->p_next = ap_head;
+  ap_head->p_prev = ap_head;
+}
+
+static inline bool
+list_is_empty (const tiz_wheel_timer_t * ap_head)
+{
+  return ap_head->p_next == ap_head;
+}
+
+static inline void
+list_append (tiz_wheel_timer_t * ap_head, tiz_wheel_timer_t * ap_timer)
+{
+  ap_timer->p_prev = ap_head->p_prev;
+  ap_timer->p_next = ap_head;
+  ap_head->p_prev->p_next = ap_timer;
+  ap_head->p_prev = ap_timer;
+}
+
+static inline void
+list_unlink (tiz_wheel_timer_t * ap_timer)
+{
+  ap_timer->p_prev->p_next = ap_timer->p_next;
+  ap_timer->p_next->p_prev = ap_timer->p_prev;
+  ap_timer->p_next = NULL;
+  ap_timer->p_prev = NULL;
+}
+
+static inline void
+list_splice (tiz_wheel_timer_t * ap_dst, tiz_wheel_timer_t * ap_src)
+{
+  if (!list_is_empty (ap_src))
+    {
+      ap_src->p_next->p_prev = ap_dst->p_prev;
+      ap_dst->p_prev->p_next = ap_src->p_next;
+      ap_src->p_prev->p_next = ap_dst;
+      ap_dst->p_prev = ap_src->p_prev;
+      list_init (ap_src);
+    }
+}
+
+static tiz_wheel_timer_t *
+find_slot (tiz_wheel_t * ap_wheel, uint64_t a_expiry)
+{
+  uint64_t delta = 0;
+  int level = 0;
+
+  assert (ap_wheel);
+
+  if (a_expiry < ap_wheel->now)
+    {
+      a_expiry = ap_wheel->now;
+    }
+
+  delta = a_expiry - ap_wheel->now;
+  if (delta < TIZ_WHEEL_L0_SIZE)
+    {
+      return &(ap_wheel->l0[a_expiry & TIZ_WHEEL_L0_MASK]);
+    }
+
+  if (delta > TIZ_WHEEL_MAX_DELTA)
+    {
+      /* Park it in the furthest slot; it'll be re-inserted from there */
+      a_expiry = ap_wheel->now + TIZ_WHEEL_MAX_DELTA;
+      delta = TIZ_WHEEL_MAX_DELTA;
+    }
+
+  for (level = 0; level < TIZ_WHEEL_LN_LEVELS - 1; ++level)
+    {
+      if (delta < (UINT64_C (1) << TIZ_WHEEL_SHIFT (level + 1)))
+        {
+          break;
+        }
+    }
+
+  return &(ap_wheel->ln[level][(a_expiry >> TIZ_WHEEL_SHIFT (level))
+                               & TIZ_WHEEL_LN_MASK]);
+}
+
+static void
+cascade (tiz_wheel_t * ap_wheel, tiz_wheel_timer_t * ap_slot)
+{
+  tiz_wheel_timer_t tmp;
+
+  assert (ap_wheel);
+  assert (ap_slot);
+
+  list_init (&tmp);
+  list_splice (&tmp, ap_slot);
+  while (!list_is_empty (&tmp))
+    {
+      tiz_wheel_timer_t * p_timer = tmp.p_next;
+      list_unlink (p_timer);
+      list_append (find_slot (ap_wheel, p_timer->expiry), p_timer);
+    }
+}
+
+static void
+run_tick (tiz_wheel_t * ap_wheel)
+{
+  const size_t idx = ap_wheel->now & TIZ_WHEEL_L0_MASK;
+
+  if (0 == idx)
+    {
+      /* Redistribute the upper level slots that are now in range */
+      int level = 0;
+      for (level = 0; level < TIZ_WHEEL_LN_LEVELS; ++level)
+        {
+          const size_t lidx = (ap_wheel->now >> TIZ_WHEEL_SHIFT (level))
+                              & TIZ_WHEEL_LN_MASK;
+          cascade (ap_wheel, &(ap_wheel->ln[level][lidx]));
+          if (0 != lidx)
+            {
+              break;
+            }
+        }
+    }
+
+  list_splice (&(ap_wheel->expired), &(ap_wheel->l0[idx]));
+  ++(ap_wheel->now);
+}
+
+OMX_ERRORTYPE
+tiz_wheel_init (tiz_wheel_ptr_t * app_wheel, const uint64_t a_now)
+{
+  tiz_wheel_t * p_wheel = NULL;
+  int i = 0;
+  int j = 0;
+
+  assert (app_wheel);
+
+  if (!(p_wheel = (tiz_wheel_t *) tiz_mem_calloc (1, sizeof (tiz_wheel_t))))
+    {
+      return OMX_ErrorInsufficientResources;
+    }
+
+  p_wheel->now = a_now;
+  p_wheel->count = 0;
+  for (i = 0; i < TIZ_WHEEL_L0_SIZE; ++i)
+    {
+      list_init (&(p_wheel->l0[i]));
+    }
+  for (i = 0; i < TIZ_WHEEL_LN_LEVELS; ++i)
+    {
+      for (j = 0; j < TIZ_WHEEL_LN_SIZE; ++j)
+        {
+          list_init (&(p_wheel->ln[i][j]));
+        }
+    }
+  list_init (&(p_wheel->expired));
+
+  *app_wheel = p_wheel;
+  return OMX_ErrorNone;
+}
+
+void
+tiz_wheel_destroy (tiz_wheel_t * ap_wheel)
+{
+  tiz_mem_free (ap_wheel);
+}
+
+void
+tiz_wheel_timer_init (tiz_wheel_timer_t * ap_timer)
+{
+  assert (ap_timer);
+  ap_timer->p_next = NULL;
+  ap_timer->p_prev = NULL;
+  ap_timer->expiry = 0;
+}
+
+bool
+tiz_wheel_timer_is_pending (const tiz_wheel_timer_t * ap_timer)
+{
+  assert (ap_timer);
+  return (NULL != ap_timer->p_next);
+}
+
+void
+tiz_wheel_add (tiz_wheel_t * ap_wheel, tiz_wheel_timer_t * ap_timer,
+               const uint64_t a_expiry)
+{
+  assert (ap_wheel);
+  assert (ap_timer);
+
+  tiz_wheel_remove (ap_wheel, ap_timer);
+  ap_timer->expiry = a_expiry;
+  list_append (find_slot (ap_wheel, a_expiry), ap_timer);
+  ++(ap_wheel->count);
+}
+
+void
+tiz_wheel_remove (tiz_wheel_t * ap_wheel, tiz_wheel_timer_t * ap_timer)
+{
+  assert (ap_wheel);
+  assert (ap_timer);
+
+  if (tiz_wheel_timer_is_pending (ap_timer))
+    {
+      assert (ap_wheel->count > 0);
+      list_unlink (ap_timer);
+      --(ap_wheel->count);
+    }
+}
+
+tiz_wheel_timer_t *
+tiz_wheel_expire (tiz_wheel_t * ap_wheel, const uint64_t a_now)
+{
+  tiz_wheel_timer_t * p_timer = NULL;
+
+  assert (ap_wheel);
+
+  if (0 == ap_wheel->count)
+    {
+      /* Nothing to process; just catch up */
+      if (a_now >= ap_wheel->now)
+        {
+          ap_wheel->now = a_now + 1;
+        }
+      return NULL;
+    }
+
+  while (list_is_empty (&(ap_wheel->expired)) && ap_wheel->now <= a_now)
+    {
+      run_tick (ap_wheel);
+    }
+
+  if (!list_is_empty (&(ap_wheel->expired)))
+    {
+      p_timer = ap_wheel->expired.p_next;
+      list_unlink (p_timer);
+      --(ap_wheel->count);
+    }
+
+  return p_timer;
+}
+
+uint64_t
+tiz_wheel_next_expiry (const tiz_wheel_t * ap_wheel)
+{
+  uint64_t next = UINT64_MAX;
+  uint64_t k = 0;
+  int level = 0;
+
+  assert (ap_wheel);
+
+  if (0 == ap_wheel->count)
+    {
+      return UINT64_MAX;
+    }
+
+  if (!list_is_empty (&(ap_wheel->expired)))
+    {
+      return ap_wheel->now;
+    }
+
+  /* First level timers are less than a turn away; their slot tells exactly
+     when they expire */
+  for (k = 0; k < TIZ_WHEEL_L0_SIZE; ++k)
+    {
+      if (!list_is_empty (
+            &(ap_wheel->l0[(ap_wheel->now + k) & TIZ_WHEEL_L0_MASK])))
+        {
+          next = ap_wheel->now + k;
+          break;
+        }
+    }
+
+  /* In the upper levels, the first occupied slot tells when its timers are
+     moved down. The current slot is still to be moved if the next tick is at
+     the start of it. */
+  for (level = 0; level < TIZ_WHEEL_LN_LEVELS; ++level)
+    {
+      const int shift = TIZ_WHEEL_SHIFT (level);
+      const uint64_t base = ap_wheel->now >> shift;
+      const uint64_t first
+        = (0 == (ap_wheel->now & ((UINT64_C (1) << shift) - 1))) ? 0 : 1;
+      for (k = first; k < first + TIZ_WHEEL_LN_SIZE; ++k)
+        {
+          if (!list_is_empty (
+                &(ap_wheel->ln[level][(base + k) & TIZ_WHEEL_LN_MASK])))
+            {
+              next = MIN (next, (base + k) << shift);
+              break;
+            }
+        }
+    }
+
+  return next;
+}
+
+size_t
+tiz_wheel_count (const tiz_wheel_t * ap_wheel)
+{
+  assert (ap_wheel);
+  return ap_wheel->count;
+}
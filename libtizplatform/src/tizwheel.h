@@ -0,0 +1,172 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   tizwheel.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia Platform - Hierarchical timer wheel
+ *
+ *
+ */
+
+#ifndef TIZWHEEL_H
+#define TIZWHEEL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  /**
+* @defgroup tizwheel Hierarchical timer wheel
+*
+* A hashed, hierarchical timer wheel with O(1) insertion and removal. Time is
+* measured in ticks; the wheel's resolution is decided by its user. The first
+* level has 256 one-tick slots, and each of the three upper levels has 64
+* slots covering the whole range of the level below. Timers further than 2^26
+* ticks away are re-inserted when their slot is reached.
+*
+* Timers are intrusive: the user embeds a tiz_wheel_timer_t in its own
+* structure. The wheel does not allocate any memory after initialisation, and
+* it is not thread-safe.
+*
+* @ingroup libtizplatform
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <OMX_Core.h>
+#include <OMX_Types.h>
+
+  /**
+ * A timer in the wheel. The fields are private to the wheel.
+ * @ingroup tizwheel
+ */
+  typedef struct tiz_wheel_timer tiz_wheel_timer_t;
+  struct tiz_wheel_timer
+  {
+    tiz_wheel_timer_t * p_next;
+    tiz_wheel_timer_t * p_prev;
+    uint64_t expiry;
+  };
+
+  /**
+ * Timer wheel opaque structure.
+ * @ingroup tizwheel
+ */
+  typedef struct tiz_wheel tiz_wheel_t;
+  typedef /*@null@ */ tiz_wheel_t * tiz_wheel_ptr_t;
+
+  /**
+ * @brief Initialise a timer wheel.
+ *
+ * @ingroup tizwheel
+ * @param app_wheel On return, the wheel.
+ * @param a_now The current time, in ticks.
+ * @return OMX_ErrorNone, or OMX_ErrorInsufficientResources if OOM.
+ */
+  OMX_ERRORTYPE
+  tiz_wheel_init (tiz_wheel_ptr_t * app_wheel, const uint64_t a_now);
+
+  void
+  tiz_wheel_destroy (tiz_wheel_t * ap_wheel);
+
+  /**
+ * @brief Initialise a timer before its first use.
+ *
+ * @ingroup tizwheel
+ */
+  void
+  tiz_wheel_timer_init (tiz_wheel_timer_t * ap_timer);
+
+  /**
+ * @brief Whether a timer is in a wheel (i.e. added and not yet expired or
+ * removed).
+ *
+ * @ingroup tizwheel
+ */
+  bool
+  tiz_wheel_timer_is_pending (const tiz_wheel_timer_t * ap_timer);
+
+  /**
+ * @brief Add a timer to the wheel, or move it if already pending.
+ *
+ * @ingroup tizwheel
+ * @param ap_wheel The wheel.
+ * @param ap_timer The timer.
+ * @param a_expiry The time, in ticks, when the timer expires. Timers in the
+ * past expire on the next call to tiz_wheel_expire.
+ */
+  void
+  tiz_wheel_add (tiz_wheel_t * ap_wheel, tiz_wheel_timer_t * ap_timer,
+                 const uint64_t a_expiry);
+
+  /**
+ * @brief Remove a timer from the wheel. Does nothing if the timer is not
+ * pending.
+ *
+ * @ingroup tizwheel
+ */
+  void
+  tiz_wheel_remove (tiz_wheel_t * ap_wheel, tiz_wheel_timer_t * ap_timer);
+
+  /**
+ * @brief Advance the wheel up to (and including) @a a_now and retrieve one
+ * expired timer.
+ *
+ * Call repeatedly until NULL is returned. Expired timers are removed from the
+ * wheel before being returned; their expiry time is preserved.
+ *
+ * @ingroup tizwheel
+ * @param ap_wheel The wheel.
+ * @param a_now The current time, in ticks.
+ * @return An expired timer, or NULL if there are none.
+ */
+  tiz_wheel_timer_t *
+  tiz_wheel_expire (tiz_wheel_t * ap_wheel, const uint64_t a_now);
+
+  /**
+ * @brief The earliest time at which tiz_wheel_expire may return a timer.
+ *
+ * This is exact for timers in the first level of the wheel, and a lower
+ * bound otherwise (i.e. the time at which the timer's slot is
+ * redistributed).
+ *
+ * @ingroup tizwheel
+ * @return The time, in ticks, or UINT64_MAX if the wheel is empty.
+ */
+  uint64_t
+  tiz_wheel_next_expiry (const tiz_wheel_t * ap_wheel);
+
+  /**
+ * @brief The number of pending timers.
+ *
+ * @ingroup tizwheel
+ */
+  size_t
+  tiz_wheel_count (const tiz_wheel_t * ap_wheel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIZWHEEL_H */
@@ -0,0 +1,165 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_buffer.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Dynamic buffer API unit tests
+ *
+ *
+ */
+
+
+#define BUFFER_TEST_SIZE 4096
+#define BUFFER_TEST_ROUNDS 5000
+
+static OMX_U8
+buffer_test_byte (const size_t a_pos)
+{
+  return (OMX_U8) ((a_pos * 131 + (a_pos >> 8)) & 0xff);
+}
+
+static void
+buffer_test_fill (OMX_U8 * ap_dst, const size_t a_pos, const size_t a_len)
+{
+  size_t i = 0;
+  for (i = 0; i < a_len; ++i)
+    {
+      ap_dst[i] = buffer_test_byte (a_pos + i);
+    }
+}
+
+static bool
+buffer_test_verify (const OMX_U8 * ap_src, const size_t a_pos,
+                    const size_t a_len)
+{
+  size_t i = 0;
+  for (i = 0; i < a_len; ++i)
+    {
+      if (ap_src[i] != buffer_test_byte (a_pos + i))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+START_TEST (test_buffer_wraparound)
+{
+  tiz_buffer_t * p_buf = NULL;
+  OMX_U8 chunk[BUFFER_TEST_SIZE];
+  size_t pushed = 0;
+  size_t consumed = 0;
+  size_t push_len = 1;
+  size_t pull_len = 1;
+  int i = 0;
+
+  fail_if (OMX_ErrorNone != tiz_buffer_init (&p_buf, BUFFER_TEST_SIZE));
+  fail_if (0 != tiz_buffer_available (p_buf));
+
+  /* Keep the buffer less than full, so that the data is pushed and consumed
+     in odd-sized chunks that wrap around the end of the store many times */
+  for (i = 0; i < BUFFER_TEST_ROUNDS; ++i)
+    {
+      const size_t avail = tiz_buffer_available (p_buf);
+      push_len = (push_len * 7 + 3) % (BUFFER_TEST_SIZE / 2) + 1;
+      pull_len = (pull_len * 5 + 1) % (BUFFER_TEST_SIZE / 2) + 1;
+
+      if (avail + push_len <= BUFFER_TEST_SIZE)
+        {
+          buffer_test_fill (chunk, pushed, push_len);
+          fail_if (tiz_buffer_push (p_buf, chunk, push_len) != push_len);
+          pushed += push_len;
+        }
+
+      /* All the data available is contiguous */
+      fail_if (tiz_buffer_available (p_buf) != pushed - consumed);
+      fail_if (!buffer_test_verify (tiz_buffer_get (p_buf), consumed,
+                                    pushed - consumed));
+
+      consumed += tiz_buffer_advance (p_buf, pull_len);
+      fail_if (tiz_buffer_offset (p_buf) < 0);
+    }
+
+  fail_if (pushed < 100 * BUFFER_TEST_SIZE);
+
+  consumed += tiz_buffer_advance (p_buf, tiz_buffer_available (p_buf));
+  fail_if (consumed != pushed);
+  fail_if (0 != tiz_buffer_available (p_buf));
+
+  tiz_buffer_destroy (p_buf);
+}
+END_TEST
+
+START_TEST (test_buffer_grow_and_seek)
+{
+  tiz_buffer_t * p_buf = NULL;
+  OMX_U8 * p_data = NULL;
+  const size_t len = 5 * BUFFER_TEST_SIZE / 2;
+  size_t pos = 0;
+
+  p_data = tiz_mem_alloc (len);
+  fail_if (NULL == p_data);
+  buffer_test_fill (p_data, 0, len);
+
+  fail_if (OMX_ErrorNone != tiz_buffer_init (&p_buf, BUFFER_TEST_SIZE));
+
+  /* Wrap around, then grow while the data is wrapped */
+  fail_if (tiz_buffer_push (p_buf, p_data, 3 * BUFFER_TEST_SIZE / 4)
+           != 3 * BUFFER_TEST_SIZE / 4);
+  fail_if (tiz_buffer_advance (p_buf, BUFFER_TEST_SIZE / 2)
+           != BUFFER_TEST_SIZE / 2);
+  pos = BUFFER_TEST_SIZE / 2;
+  fail_if (tiz_buffer_push (p_buf, p_data + 3 * BUFFER_TEST_SIZE / 4,
+                            BUFFER_TEST_SIZE / 2)
+           != BUFFER_TEST_SIZE / 2);
+  fail_if (tiz_buffer_push (p_buf, p_data + 5 * BUFFER_TEST_SIZE / 4,
+                            5 * BUFFER_TEST_SIZE / 4)
+           != 5 * BUFFER_TEST_SIZE / 4);
+  fail_if (tiz_buffer_available (p_buf) != len - pos);
+  fail_if (!buffer_test_verify (tiz_buffer_get (p_buf), pos, len - pos));
+
+  /* The data consumed since the last push can be revisited */
+  fail_if (tiz_buffer_advance (p_buf, 100) != 100);
+  fail_if (tiz_buffer_offset (p_buf) != 100);
+  fail_if (0 != tiz_buffer_seek (p_buf, -60, TIZ_BUFFER_SEEK_CUR));
+  fail_if (tiz_buffer_offset (p_buf) != 40);
+  fail_if (!buffer_test_verify (tiz_buffer_get (p_buf), pos + 40,
+                                len - pos - 40));
+
+  /* Switching modes keeps the data */
+  fail_if (TIZ_BUFFER_NON_SEEKABLE
+           != tiz_buffer_seek_mode (p_buf, TIZ_BUFFER_SEEKABLE));
+  fail_if (tiz_buffer_offset (p_buf) != 40);
+  fail_if (0 != tiz_buffer_seek (p_buf, 0, TIZ_BUFFER_SEEK_SET));
+  fail_if (!buffer_test_verify (tiz_buffer_get (p_buf), pos, len - pos));
+  fail_if (TIZ_BUFFER_SEEKABLE
+           != tiz_buffer_seek_mode (p_buf, TIZ_BUFFER_NON_SEEKABLE));
+  fail_if (tiz_buffer_advance (p_buf, 10) != 10);
+  fail_if (!buffer_test_verify (tiz_buffer_get (p_buf), pos + 10,
+                                len - pos - 10));
+
+  tiz_buffer_clear (p_buf);
+  fail_if (0 != tiz_buffer_available (p_buf));
+
+  tiz_mem_free (p_data);
+  tiz_buffer_destroy (p_buf);
+}
+END_TEST
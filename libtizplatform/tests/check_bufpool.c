@@ -0,0 +1,106 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_bufpool.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Buffer pool API unit tests
+ *
+ *
+ */
+
+START_TEST (test_bufpool_alignment)
+{
+  OMX_U8 * p_small = NULL;
+  OMX_U8 * p_large = NULL;
+  const long page_size = sysconf (_SC_PAGESIZE);
+
+  p_small = tiz_bufpool_alloc (100);
+  fail_if (NULL == p_small);
+  fail_if (((uintptr_t) p_small) % 64 != 0);
+  memset (p_small, 0xaa, 100);
+
+  p_large = tiz_bufpool_alloc (3 * page_size + 1);
+  fail_if (NULL == p_large);
+  fail_if (((uintptr_t) p_large) % page_size != 0);
+  memset (p_large, 0xaa, 3 * page_size + 1);
+
+  tiz_bufpool_free (p_small);
+  tiz_bufpool_free (p_large);
+  tiz_bufpool_free (NULL);
+  tiz_bufpool_trim ();
+}
+END_TEST
+
+START_TEST (test_bufpool_reuse_and_stats)
+{
+  tiz_bufpool_stats_t before;
+  tiz_bufpool_stats_t stats;
+  OMX_U8 * p_bufs[4];
+  OMX_U8 * p_buf = NULL;
+  int i = 0;
+
+  tiz_bufpool_trim ();
+  tiz_bufpool_get_stats (&before);
+  fail_if (before.cached_buffers != 0);
+  fail_if (before.cached_bytes != 0);
+
+  /* Populate */
+  for (i = 0; i < 4; ++i)
+    {
+      p_bufs[i] = tiz_bufpool_alloc (10000);
+      fail_if (NULL == p_bufs[i]);
+    }
+  tiz_bufpool_get_stats (&stats);
+  fail_if (stats.in_use_buffers != before.in_use_buffers + 4);
+  fail_if (stats.in_use_bytes < before.in_use_bytes + 4 * 10000);
+  fail_if (stats.misses != before.misses + 4);
+
+  /* Depopulate: the buffers stay in the pool */
+  for (i = 0; i < 4; ++i)
+    {
+      memset (p_bufs[i], 0xa5, 10000);
+      tiz_bufpool_free (p_bufs[i]);
+    }
+  tiz_bufpool_get_stats (&stats);
+  fail_if (stats.in_use_buffers != before.in_use_buffers);
+  fail_if (stats.cached_buffers != 4);
+  fail_if (stats.cached_bytes < 4 * 10000);
+
+  /* A slightly smaller request falls in the same size class */
+  p_buf = tiz_bufpool_alloc (9000);
+  fail_if (p_buf != p_bufs[3]);
+  /* Re-used buffers are zeroed by default, like fresh ones */
+  for (i = 0; i < 9000; ++i)
+    {
+      fail_if (0 != p_buf[i]);
+    }
+  tiz_bufpool_get_stats (&stats);
+  fail_if (stats.hits != before.hits + 1);
+  fail_if (stats.cached_buffers != 3);
+  tiz_bufpool_free (p_buf);
+
+  tiz_bufpool_trim ();
+  tiz_bufpool_get_stats (&stats);
+  fail_if (stats.cached_buffers != 0);
+  fail_if (stats.cached_bytes != 0);
+  fail_if (stats.max_cached_bytes == 0);
+}
+END_TEST
@@ -0,0 +1,183 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_icy.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  HTTP header and ICY metadata parsing API unit tests
+ *
+ *
+ */
+
+#include <time.h>
+
+#define ICY_TEST_METAINT 8192
+#define ICY_TEST_INTERVALS 512
+
+/* Build what an Icecast server would send with 'Icy-MetaData:1': metaint
+   audio bytes, followed by a length byte and a metadata block. The title
+   changes every 64 intervals; most intervals carry no metadata at all. */
+static OMX_U8 *
+icy_test_stream (size_t * ap_len, OMX_U8 ** app_audio, size_t * ap_audio_len)
+{
+  const size_t max_len
+    = ICY_TEST_INTERVALS * (ICY_TEST_METAINT + 1 + TIZ_ICY_MAX_METADATA_SIZE);
+  OMX_U8 * p_stream = tiz_mem_calloc (1, max_len);
+  OMX_U8 * p_audio = tiz_mem_calloc (1, ICY_TEST_INTERVALS * ICY_TEST_METAINT);
+  size_t len = 0;
+  size_t audio_len = 0;
+  int i = 0;
+  int j = 0;
+
+  fail_if (NULL == p_stream);
+  fail_if (NULL == p_audio);
+
+  for (i = 0; i < ICY_TEST_INTERVALS; ++i)
+    {
+      for (j = 0; j < ICY_TEST_METAINT; ++j)
+        {
+          /* Plenty of quotes and semicolons in the audio data */
+          const OMX_U8 byte = (OMX_U8) ((i * 31 + j * 7) & 0xff);
+          p_stream[len++] = byte;
+          p_audio[audio_len++] = byte;
+        }
+      if (0 == i % 64)
+        {
+          char meta[TIZ_ICY_MAX_METADATA_SIZE];
+          size_t meta_len = 0;
+          snprintf (meta, sizeof (meta),
+                    "StreamTitle='Artist %d - It's Title %d';StreamUrl='';",
+                    i / 64, i / 64);
+          meta_len = (strlen (meta) + 15) / 16;
+          p_stream[len++] = (OMX_U8) meta_len;
+          memcpy (p_stream + len, meta, strlen (meta));
+          len += meta_len * 16;
+        }
+      else
+        {
+          p_stream[len++] = 0;
+        }
+    }
+
+  *ap_len = len;
+  *app_audio = p_audio;
+  *ap_audio_len = audio_len;
+  return p_stream;
+}
+
+START_TEST (test_http_header_parse)
+{
+  const char * p_line = "Icy-MetaInt :  16000 \r\n";
+  const char * p_status = "ICY 200 OK\r\n";
+  const char * p_bad = "Icy-Br: 128k\r\n";
+  tiz_http_header_t hdr;
+  char value[8];
+
+  fail_if (!tiz_http_header_parse (p_line, strlen (p_line), &hdr));
+  fail_if (!tiz_http_header_is (&hdr, "icy-metaint"));
+  fail_if (tiz_http_header_is (&hdr, "icy-meta"));
+  fail_if (tiz_http_header_int (&hdr) != 16000);
+  fail_if (strcmp (tiz_http_header_value (&hdr, value, sizeof (value)), "16000")
+           != 0);
+  fail_if (strcmp (tiz_http_header_value (&hdr, value, 3), "16") != 0);
+
+  fail_if (tiz_http_header_parse (p_status, strlen (p_status), &hdr));
+
+  fail_if (!tiz_http_header_parse (p_bad, strlen (p_bad), &hdr));
+  fail_if (tiz_http_header_int (&hdr) != -1);
+}
+END_TEST
+
+START_TEST (test_icy_demux)
+{
+  tiz_icy_t * p_icy = NULL;
+  OMX_U8 * p_stream = NULL;
+  OMX_U8 * p_audio = NULL;
+  OMX_U8 * p_out = NULL;
+  size_t stream_len = 0;
+  size_t audio_len = 0;
+  size_t out_len = 0;
+  size_t offset = 0;
+  size_t chunk = 1;
+  int titles = 0;
+  const char * p_title = NULL;
+  struct timespec start, end;
+  double elapsed = 0;
+
+  fail_if (OMX_ErrorBadParameter != tiz_icy_init (&p_icy, 0));
+  fail_if (OMX_ErrorNone != tiz_icy_init (&p_icy, ICY_TEST_METAINT));
+  fail_if (tiz_icy_audio_ahead (p_icy) != ICY_TEST_METAINT);
+
+  p_stream = icy_test_stream (&stream_len, &p_audio, &audio_len);
+  p_out = tiz_mem_calloc (1, audio_len);
+  fail_if (NULL == p_out);
+
+  clock_gettime (CLOCK_MONOTONIC, &start);
+
+  /* Feed the stream in odd-sized chunks, as curl would */
+  while (offset < stream_len)
+    {
+      const size_t len = MIN (chunk, stream_len - offset);
+      size_t consumed = 0;
+      while (consumed < len)
+        {
+          size_t span = 0;
+          consumed += tiz_icy_demux (p_icy, p_stream + offset + consumed,
+                                     len - consumed, &span);
+          if (span > 0)
+            {
+              memcpy (p_out + out_len, p_stream + offset + consumed - span,
+                      span);
+              out_len += span;
+            }
+          else if ((p_title = tiz_icy_take_title (p_icy)))
+            {
+              char expected[64];
+              snprintf (expected, sizeof (expected),
+                        "Artist %d - It's Title %d", titles, titles);
+              fail_if (strcmp (p_title, expected) != 0);
+              ++titles;
+            }
+        }
+      offset += len;
+      chunk = (chunk * 7 + 1) % 16384 + 1;
+    }
+
+  clock_gettime (CLOCK_MONOTONIC, &end);
+  elapsed = (end.tv_sec - start.tv_sec) * 1e3
+            + (end.tv_nsec - start.tv_nsec) / 1e6;
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "demuxed %zu bytes in %.3f ms", stream_len,
+           elapsed);
+
+  fail_if (out_len != audio_len);
+  fail_if (memcmp (p_out, p_audio, audio_len) != 0);
+  fail_if (titles != ICY_TEST_INTERVALS / 64);
+  fail_if (NULL != tiz_icy_take_title (p_icy));
+
+  /* Ready for a new stream */
+  tiz_icy_reset (p_icy, ICY_TEST_METAINT);
+  fail_if (tiz_icy_audio_ahead (p_icy) != ICY_TEST_METAINT);
+
+  tiz_mem_free (p_out);
+  tiz_mem_free (p_audio);
+  tiz_mem_free (p_stream);
+  tiz_icy_destroy (p_icy);
+}
+END_TEST
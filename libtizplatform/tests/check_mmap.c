@@ -0,0 +1,188 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_mmap.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Memory-mapped file input API unit tests
+ *
+ *
+ */
+
+#define CHECK_MMAP_FILE_SIZE 10000
+
+static void
+check_mmap_create_file (char * ap_path)
+{
+  OMX_U8 data[CHECK_MMAP_FILE_SIZE];
+  int fd = -1;
+  int i = 0;
+
+  for (i = 0; i < CHECK_MMAP_FILE_SIZE; ++i)
+    {
+      data[i] = (OMX_U8) (i % 251);
+    }
+
+  strcpy (ap_path, "/tmp/check_mmap_XXXXXX");
+  fd = mkstemp (ap_path);
+  fail_if (fd < 0);
+  fail_if (write (fd, data, sizeof (data)) != sizeof (data));
+  close (fd);
+}
+
+START_TEST (test_mmap_read_get_advance)
+{
+  OMX_ERRORTYPE error = OMX_ErrorNone;
+  tiz_mmap_t * p_map = NULL;
+  char path[64];
+  OMX_U8 buf[100];
+  const OMX_U8 * p_data = NULL;
+  size_t avail = 0;
+  int i = 0;
+
+  check_mmap_create_file (path);
+
+  error = tiz_mmap_init (&p_map, path);
+  fail_if (error != OMX_ErrorNone);
+  fail_if (!tiz_mmap_is_mapped (p_map));
+  fail_if (tiz_mmap_size (p_map) != CHECK_MMAP_FILE_SIZE);
+
+  fail_if (tiz_mmap_read (p_map, buf, sizeof (buf)) != sizeof (buf));
+  for (i = 0; i < (int) sizeof (buf); ++i)
+    {
+      fail_if (buf[i] != (OMX_U8) (i % 251));
+    }
+  fail_if (tiz_mmap_tell (p_map) != sizeof (buf));
+
+  p_data = tiz_mmap_get (p_map, &avail);
+  fail_if (NULL == p_data);
+  fail_if (avail != CHECK_MMAP_FILE_SIZE - sizeof (buf));
+  fail_if (p_data[0] != (OMX_U8) (sizeof (buf) % 251));
+
+  fail_if (tiz_mmap_advance (p_map, avail + 10) != avail);
+  fail_if (!tiz_mmap_eof (p_map));
+  fail_if (tiz_mmap_read (p_map, buf, sizeof (buf)) != 0);
+
+  tiz_mmap_destroy (p_map);
+  unlink (path);
+}
+END_TEST
+
+START_TEST (test_mmap_seek_tell)
+{
+  OMX_ERRORTYPE error = OMX_ErrorNone;
+  tiz_mmap_t * p_map = NULL;
+  char path[64];
+  OMX_U8 byte = 0;
+
+  check_mmap_create_file (path);
+
+  error = tiz_mmap_init (&p_map, path);
+  fail_if (error != OMX_ErrorNone);
+
+  fail_if (tiz_mmap_seek (p_map, 5000, TIZ_MMAP_SEEK_SET) != 0);
+  fail_if (tiz_mmap_tell (p_map) != 5000);
+  fail_if (tiz_mmap_read (p_map, &byte, 1) != 1);
+  fail_if (byte != (OMX_U8) (5000 % 251));
+
+  fail_if (tiz_mmap_seek (p_map, -1001, TIZ_MMAP_SEEK_CUR) != 0);
+  fail_if (tiz_mmap_tell (p_map) != 4000);
+
+  fail_if (tiz_mmap_seek (p_map, -1, TIZ_MMAP_SEEK_END) != 0);
+  fail_if (tiz_mmap_read (p_map, &byte, 1) != 1);
+  fail_if (byte != (OMX_U8) ((CHECK_MMAP_FILE_SIZE - 1) % 251));
+  fail_if (!tiz_mmap_eof (p_map));
+
+  fail_if (tiz_mmap_seek (p_map, -1, TIZ_MMAP_SEEK_SET) != -1);
+  fail_if (tiz_mmap_seek (p_map, 0, TIZ_MMAP_SEEK_SET) != 0);
+  fail_if (tiz_mmap_eof (p_map));
+
+  tiz_mmap_destroy (p_map);
+  unlink (path);
+}
+END_TEST
+
+START_TEST (test_mmap_truncated)
+{
+  OMX_ERRORTYPE error = OMX_ErrorNone;
+  tiz_mmap_t * p_map = NULL;
+  char path[64];
+  OMX_U8 buf[CHECK_MMAP_FILE_SIZE];
+  const OMX_U8 * p_data = NULL;
+  size_t avail = 0;
+
+  check_mmap_create_file (path);
+
+  error = tiz_mmap_init (&p_map, path);
+  fail_if (error != OMX_ErrorNone);
+  fail_if (!tiz_mmap_is_mapped (p_map));
+  fail_if (tiz_mmap_read (p_map, buf, 100) != 100);
+
+  /* Reading the pages past the new end of file would raise SIGBUS */
+  fail_if (truncate (path, 1000) != 0);
+
+  p_data = tiz_mmap_get (p_map, &avail);
+  fail_if (NULL == p_data);
+  fail_if (avail != 900);
+
+  fail_if (tiz_mmap_read (p_map, buf, sizeof (buf)) != 900);
+  fail_if (buf[899] != (OMX_U8) (999 % 251));
+  fail_if (tiz_mmap_read (p_map, buf, sizeof (buf)) != 0);
+  fail_if (!tiz_mmap_eof (p_map));
+
+  fail_if (tiz_mmap_seek (p_map, 0, TIZ_MMAP_SEEK_END) != 0);
+  fail_if (tiz_mmap_tell (p_map) != 1000);
+
+  /* Truncated beyond the current position */
+  fail_if (tiz_mmap_seek (p_map, 500, TIZ_MMAP_SEEK_SET) != 0);
+  fail_if (truncate (path, 0) != 0);
+  fail_if (tiz_mmap_read (p_map, buf, sizeof (buf)) != 0);
+  fail_if (tiz_mmap_tell (p_map) != 0);
+
+  tiz_mmap_destroy (p_map);
+  unlink (path);
+}
+END_TEST
+
+START_TEST (test_mmap_fallback)
+{
+  OMX_ERRORTYPE error = OMX_ErrorNone;
+  tiz_mmap_t * p_map = NULL;
+  OMX_U8 buf[100];
+  size_t avail = 0;
+
+  /* Character devices can't be mapped; stdio is used instead */
+  error = tiz_mmap_init (&p_map, "/dev/zero");
+  fail_if (error != OMX_ErrorNone);
+  fail_if (tiz_mmap_is_mapped (p_map));
+  fail_if (tiz_mmap_size (p_map) != -1);
+  fail_if (tiz_mmap_get (p_map, &avail) != NULL);
+  fail_if (avail != 0);
+
+  memset (buf, 0xff, sizeof (buf));
+  fail_if (tiz_mmap_read (p_map, buf, sizeof (buf)) != sizeof (buf));
+  fail_if (buf[0] != 0 || buf[sizeof (buf) - 1] != 0);
+
+  tiz_mmap_destroy (p_map);
+
+  error = tiz_mmap_init (&p_map, "/this/path/does/not/exist");
+  fail_if (error != OMX_ErrorContentURIError);
+}
+END_TEST
@@ -445,6 +445,115 @@ START_TEST (test_pqueue_removep)
 }
 END_TEST
 
+typedef struct check_pqueue_msg check_pqueue_msg_t;
+struct check_pqueue_msg
+{
+  int id;
+  OMX_S32 port;
+  void * p_hdr;
+};
+
+static int g_pqueue_visited = 0;
+
+static void
+pqueue_keys (void * ap_data, OMX_S32 * ap_port, void ** app_hdr)
+{
+  check_pqueue_msg_t * p_msg = ap_data;
+  *ap_port = p_msg->port;
+  *app_hdr = p_msg->p_hdr;
+}
+
+static OMX_BOOL
+pqueue_match_port (void * ap_elem, OMX_S32 a_data1, void * ap_data2)
+{
+  check_pqueue_msg_t * p_msg = ap_elem;
+  ++g_pqueue_visited;
+  return (p_msg->port == a_data1 ? OMX_TRUE : OMX_FALSE);
+}
+
+static OMX_BOOL
+pqueue_match_hdr (void * ap_elem, OMX_S32 a_data1, void * ap_data2)
+{
+  check_pqueue_msg_t * p_msg = ap_elem;
+  ++g_pqueue_visited;
+  return (p_msg->p_hdr == ap_data2 ? OMX_TRUE : OMX_FALSE);
+}
+
+START_TEST (test_pqueue_remove_func_indexed)
+{
+  OMX_ERRORTYPE error = OMX_ErrorNone;
+  tiz_pqueue_t * p_queue = NULL;
+  tiz_soa_t * p_soa = NULL;
+  check_pqueue_msg_t msgs[30];
+  int hdrs[10];
+  OMX_PTR p_received = NULL;
+  check_pqueue_msg_t * p_msg = NULL;
+  int prev_id = -1;
+  OMX_S32 prev_prio = 0;
+  int i;
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "test_pqueue_remove_func_indexed");
+
+  fail_if (tiz_soa_init (&p_soa) != OMX_ErrorNone);
+  error = tiz_pqueue_init (&p_queue, 2, &pqueue_cmp, p_soa, "tizkrn");
+  fail_if (error != OMX_ErrorNone);
+  fail_if (tiz_pqueue_set_key_func (p_queue, &pqueue_keys) != OMX_ErrorNone);
+
+  /* Three ports, ten headers, two priority groups; the last two messages are
+     not indexed */
+  for (i = 0; i < 30; i++)
+    {
+      msgs[i].id = i;
+      msgs[i].port = (i < 28 ? i % 3 : -1);
+      msgs[i].p_hdr = (i < 28 ? &hdrs[i % 10] : NULL);
+      error = tiz_pqueue_send (p_queue, &msgs[i], 1 + (i % 2));
+      fail_if (error != OMX_ErrorNone);
+    }
+
+  /* Port 1 has messages 1, 4, 7, ..., 25: only those are visited */
+  g_pqueue_visited = 0;
+  fail_if (9 != tiz_pqueue_remove_func_port (p_queue, &pqueue_match_port, 1,
+                                             1, p_queue));
+  fail_if (9 != g_pqueue_visited);
+  fail_if (21 != tiz_pqueue_length (p_queue));
+
+  /* Header 0 has messages 0 and 20 left (10 was on port 1) */
+  g_pqueue_visited = 0;
+  fail_if (2 != tiz_pqueue_remove_func_hdr (p_queue, &pqueue_match_hdr,
+                                            &hdrs[0], 0, &hdrs[0]));
+  fail_if (2 != g_pqueue_visited);
+  fail_if (19 != tiz_pqueue_length (p_queue));
+
+  /* Nothing left to remove for that header */
+  fail_if (0 != tiz_pqueue_remove_func_hdr (p_queue, &pqueue_match_hdr,
+                                            &hdrs[0], 0, &hdrs[0]));
+
+  /* Unindexed removal still visits everything */
+  g_pqueue_visited = 0;
+  fail_if (0 != tiz_pqueue_remove_func_port (p_queue, &pqueue_match_port, -1,
+                                             1, p_queue));
+  fail_if (19 != g_pqueue_visited);
+
+  /* The remaining items keep their priority order */
+  while (OMX_ErrorNone == tiz_pqueue_receive (p_queue, &p_received))
+    {
+      OMX_S32 prio = 0;
+      p_msg = p_received;
+      prio = 1 + (p_msg->id % 2);
+      fail_if (1 == p_msg->port);
+      fail_if (p_msg->p_hdr == &hdrs[0]);
+      fail_if (prio < prev_prio);
+      fail_if (prio == prev_prio && p_msg->id <= prev_id);
+      prev_prio = prio;
+      prev_id = p_msg->id;
+    }
+
+  fail_if (0 != tiz_pqueue_length (p_queue));
+  tiz_pqueue_destroy (p_queue);
+  tiz_soa_destroy (p_soa);
+}
+END_TEST
+
 /* Local Variables: */
 /* c-default-style: gnu */
 /* fill-column: 79 */
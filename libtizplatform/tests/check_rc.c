@@ -55,7 +55,7 @@ START_TEST (test_rcfile_get_value_list)
   unsigned long length = 0;
   int i = 0;
 
-  pp_vlst = tiz_rcfile_get_value_list ("il-core", "component-paths", &length);
+  pp_vlst = tiz_rcfile_get_value_list ("ilcore", "component-paths", &length);
   fail_if (pp_vlst == NULL);
   fail_if (length == 0);
 
@@ -72,6 +72,73 @@ START_TEST (test_rcfile_get_value_list)
 }
 END_TEST
 
+START_TEST (test_rcfile_sections)
+{
+  const char * val = NULL;
+
+  /* Same key in two different sections */
+  val = tiz_rcfile_get_value ("resource-management", "rmdb");
+  fail_if (val == NULL);
+  fail_if (strcmp (val, "/home/juan/temp/share/tizrmd/tizrm.db") != 0);
+
+  val = tiz_rcfile_get_value ("check-rc", "rmdb");
+  fail_if (val == NULL);
+  fail_if (strcmp (val, "/this/is/not/the/resource-management/rmdb") != 0);
+
+  /* The key exists, but not in this section */
+  val = tiz_rcfile_get_value ("ilcore", "rmdb");
+  fail_if (val != NULL);
+}
+END_TEST
+
+START_TEST (test_rcfile_get_typed_values)
+{
+  const char * const * pp_list = NULL;
+  unsigned long length = 0;
+  int i = 0;
+
+  fail_if (tiz_rcfile_get_int ("check-rc", "int-value", -1) != 42);
+  fail_if (tiz_rcfile_get_int ("check-rc", "not-a-number", -1) != -1);
+  fail_if (tiz_rcfile_get_int ("check-rc", "unexistentvalue124", -1) != -1);
+
+  fail_if (tiz_rcfile_get_bool ("check-rc", "bool-value", false) != true);
+  fail_if (tiz_rcfile_get_bool ("resource-management", "enabled", false)
+           != true);
+  fail_if (tiz_rcfile_get_bool ("check-rc", "int-value", false) != false);
+
+  pp_list = tiz_rcfile_get_list ("ilcore", "component-paths", &length);
+  fail_if (pp_list == NULL);
+  fail_if (length != 2);
+  fail_if (strcmp (pp_list[0], "/home/juan/temp/lib") != 0);
+  fail_if (strcmp (pp_list[1], "/usr/lib") != 0);
+  fail_if (pp_list[2] != NULL);
+
+  /* Repeated lookups through the same call site */
+  for (i = 0; i < 3; ++i)
+    {
+      fail_if (TIZ_RCFILE_GET_INT ("check-rc", "int-value", -1) != 42);
+      fail_if (TIZ_RCFILE_GET_BOOL ("check-rc", "bool-value", false) != true);
+    }
+}
+END_TEST
+
+START_TEST (test_rcfile_stale_cache)
+{
+  /* A cache left over from a destroyed configuration store; its entry must
+     not be dereferenced */
+  tiz_rcfile_cache_t cache = {(const void *) 0x1, (unsigned long) -1};
+
+  fail_if (tiz_rcfile_get_int_cached (&cache, "check-rc", "int-value", -1)
+           != 42);
+  fail_if (cache.p_entry == (const void *) 0x1);
+  fail_if (cache.generation == (unsigned long) -1);
+
+  /* And the refreshed cache is used from now on */
+  fail_if (tiz_rcfile_get_int_cached (&cache, "check-rc", "int-value", -1)
+           != 42);
+}
+END_TEST
+
 /* Local Variables: */
 /* c-default-style: gnu */
 /* fill-column: 79 */
@@ -27,6 +27,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <check.h>
 #include <signal.h>
 #include <unistd.h>
@@ -50,6 +51,11 @@
 #include "./check_event.c"
 #include "./check_http_parser.c"
 #include "./check_map.c"
+#include "./check_mmap.c"
+#include "./check_bufpool.c"
+#include "./check_icy.c"
+#include "./check_wheel.c"
+#include "./check_buffer.c"
 
 #define EVENT_API_TEST_TIMEOUT 100
 
@@ -122,6 +128,7 @@ platform_pqueue_suite (void)
   tcase_add_test (tc_pqueue, test_pqueue_first);
   tcase_add_test (tc_pqueue, test_pqueue_remove);
   tcase_add_test (tc_pqueue, test_pqueue_removep);
+  tcase_add_test (tc_pqueue, test_pqueue_remove_func_indexed);
   suite_add_tcase (s, tc_pqueue);
 
   return s;
@@ -158,6 +165,9 @@ platform_rcfile_suite (void)
   tcase_add_test (tc_rc, test_rcfile_get_single_value);
   tcase_add_test (tc_rc, test_rcfile_get_unexistent_value);
   tcase_add_test (tc_rc, test_rcfile_get_value_list);
+  tcase_add_test (tc_rc, test_rcfile_sections);
+  tcase_add_test (tc_rc, test_rcfile_get_typed_values);
+  tcase_add_test (tc_rc, test_rcfile_stale_cache);
   suite_add_tcase (s, tc_rc);
 
   return s;
@@ -226,6 +236,83 @@ platform_map_suite (void)
   return s;
 }
 
+Suite *
+platform_mmap_suite (void)
+{
+  TCase * tc_mmap;
+  Suite * s = suite_create ("Memory-mapped file input");
+
+  /* mmap API test cases */
+  tc_mmap = tcase_create ("mmap API");
+  tcase_add_test (tc_mmap, test_mmap_read_get_advance);
+  tcase_add_test (tc_mmap, test_mmap_seek_tell);
+  tcase_add_test (tc_mmap, test_mmap_truncated);
+  tcase_add_test (tc_mmap, test_mmap_fallback);
+  suite_add_tcase (s, tc_mmap);
+
+  return s;
+}
+
+Suite *
+platform_bufpool_suite (void)
+{
+  TCase * tc_bufpool;
+  Suite * s = suite_create ("Buffer pool");
+
+  /* buffer pool API test cases */
+  tc_bufpool = tcase_create ("buffer pool API");
+  tcase_add_test (tc_bufpool, test_bufpool_alignment);
+  tcase_add_test (tc_bufpool, test_bufpool_reuse_and_stats);
+  suite_add_tcase (s, tc_bufpool);
+
+  return s;
+}
+
+Suite *
+platform_icy_suite (void)
+{
+  TCase * tc_icy;
+  Suite * s = suite_create ("HTTP header and ICY metadata parsing");
+
+  /* icy API test cases */
+  tc_icy = tcase_create ("icy API");
+  tcase_add_test (tc_icy, test_http_header_parse);
+  tcase_add_test (tc_icy, test_icy_demux);
+  suite_add_tcase (s, tc_icy);
+
+  return s;
+}
+
+Suite *
+platform_wheel_suite (void)
+{
+  TCase * tc_wheel;
+  Suite * s = suite_create ("Timer wheel");
+
+  /* timer wheel API test cases */
+  tc_wheel = tcase_create ("timer wheel API");
+  tcase_add_test (tc_wheel, test_wheel_add_remove_expire);
+  tcase_add_test (tc_wheel, test_wheel_random_timers);
+  suite_add_tcase (s, tc_wheel);
+
+  return s;
+}
+
+Suite *
+platform_buffer_suite (void)
+{
+  TCase * tc_buffer;
+  Suite * s = suite_create ("Dynamic buffer");
+
+  /* dynamic buffer API test cases */
+  tc_buffer = tcase_create ("dynamic buffer API");
+  tcase_add_test (tc_buffer, test_buffer_wraparound);
+  tcase_add_test (tc_buffer, test_buffer_grow_and_seek);
+  suite_add_tcase (s, tc_buffer);
+
+  return s;
+}
+
 int
 main (void)
 {
@@ -245,6 +332,11 @@ main (void)
   srunner_add_suite (sr, platform_soa_suite ());
   srunner_add_suite (sr, platform_http_parser_suite ());
   srunner_add_suite (sr, platform_map_suite ());
+  srunner_add_suite (sr, platform_mmap_suite ());
+  srunner_add_suite (sr, platform_bufpool_suite ());
+  srunner_add_suite (sr, platform_icy_suite ());
+  srunner_add_suite (sr, platform_wheel_suite ());
+  srunner_add_suite (sr, platform_buffer_suite ());
   /*   srunner_add_suite (sr, platform_event_suite ()); */
   srunner_run_all (sr, CK_VERBOSE);
   number_failed = srunner_ntests_failed (sr);
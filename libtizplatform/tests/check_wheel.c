@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_wheel.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Timer wheel API unit tests
+ *
+ *
+ */
+
+#define WHEEL_TEST_TIMERS 2000
+
+START_TEST (test_wheel_add_remove_expire)
+{
+  tiz_wheel_t * p_wheel = NULL;
+  tiz_wheel_timer_t t1, t2, t3;
+
+  fail_if (OMX_ErrorNone != tiz_wheel_init (&p_wheel, 1000));
+  fail_if (tiz_wheel_next_expiry (p_wheel) != UINT64_MAX);
+
+  tiz_wheel_timer_init (&t1);
+  tiz_wheel_timer_init (&t2);
+  tiz_wheel_timer_init (&t3);
+  fail_if (tiz_wheel_timer_is_pending (&t1));
+
+  tiz_wheel_add (p_wheel, &t1, 1010);
+  tiz_wheel_add (p_wheel, &t2, 1005);
+  tiz_wheel_add (p_wheel, &t3, 900); /* in the past */
+  fail_if (tiz_wheel_count (p_wheel) != 3);
+  fail_if (!tiz_wheel_timer_is_pending (&t1));
+  fail_if (tiz_wheel_next_expiry (p_wheel) != 1000);
+
+  fail_if (tiz_wheel_expire (p_wheel, 1000) != &t3);
+  fail_if (tiz_wheel_timer_is_pending (&t3));
+  fail_if (tiz_wheel_expire (p_wheel, 1000) != NULL);
+  fail_if (tiz_wheel_next_expiry (p_wheel) != 1005);
+
+  /* Moving a pending timer */
+  tiz_wheel_add (p_wheel, &t2, 1020);
+  fail_if (tiz_wheel_count (p_wheel) != 2);
+  fail_if (tiz_wheel_next_expiry (p_wheel) != 1010);
+
+  tiz_wheel_remove (p_wheel, &t1);
+  tiz_wheel_remove (p_wheel, &t1);
+  fail_if (tiz_wheel_count (p_wheel) != 1);
+  fail_if (tiz_wheel_expire (p_wheel, 1019) != NULL);
+  fail_if (tiz_wheel_expire (p_wheel, 1020) != &t2);
+  fail_if (t2.expiry != 1020);
+  fail_if (tiz_wheel_count (p_wheel) != 0);
+
+  tiz_wheel_destroy (p_wheel);
+}
+END_TEST
+
+START_TEST (test_wheel_random_timers)
+{
+  tiz_wheel_t * p_wheel = NULL;
+  tiz_wheel_timer_t * p_timers = NULL;
+  uint64_t now = 12345;
+  size_t expired = 0;
+  int i = 0;
+
+  srand (1234);
+  fail_if (OMX_ErrorNone != tiz_wheel_init (&p_wheel, now));
+  p_timers = tiz_mem_calloc (WHEEL_TEST_TIMERS, sizeof (tiz_wheel_timer_t));
+  fail_if (NULL == p_timers);
+
+  /* Spread the timers over all the levels, and beyond */
+  for (i = 0; i < WHEEL_TEST_TIMERS; ++i)
+    {
+      const int bits = rand () % 30;
+      tiz_wheel_timer_init (&(p_timers[i]));
+      tiz_wheel_add (p_wheel, &(p_timers[i]),
+                     now + ((uint64_t) rand () % (UINT64_C (1) << bits)));
+    }
+
+  /* Remove some of them */
+  for (i = 0; i < WHEEL_TEST_TIMERS; i += 7)
+    {
+      tiz_wheel_remove (p_wheel, &(p_timers[i]));
+    }
+
+  while (tiz_wheel_count (p_wheel) > 0)
+    {
+      tiz_wheel_timer_t * p_timer = NULL;
+      uint64_t earliest = UINT64_MAX;
+      const uint64_t next = tiz_wheel_next_expiry (p_wheel);
+
+      for (i = 0; i < WHEEL_TEST_TIMERS; ++i)
+        {
+          if (tiz_wheel_timer_is_pending (&(p_timers[i])))
+            {
+              earliest = MIN (earliest, p_timers[i].expiry);
+            }
+        }
+
+      /* Never later than the earliest timer */
+      fail_if (next > MAX (earliest, now + 1));
+
+      /* Nothing expires before its time */
+      if (next > now)
+        {
+          fail_if (NULL != tiz_wheel_expire (p_wheel, next - 1));
+        }
+      now = next;
+      while ((p_timer = tiz_wheel_expire (p_wheel, now)))
+        {
+          fail_if (p_timer->expiry != now);
+          ++expired;
+        }
+    }
+
+  fail_if (expired != WHEEL_TEST_TIMERS - (WHEEL_TEST_TIMERS + 6) / 7);
+
+  tiz_mem_free (p_timers);
+  tiz_wheel_destroy (p_wheel);
+}
+END_TEST
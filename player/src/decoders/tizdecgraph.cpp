@@ -49,8 +49,10 @@ namespace graph = tiz::graph;
 //
 graph::decoder::decoder (const std::string &graph_name)
   : graph::graph (graph_name),
-    fsm_ (new fsm (boost::msm::back::states_ << tiz::graph::fsm::configuring (
-                       &p_ops_) << tiz::graph::fsm::skipping (&p_ops_),
+    fsm_ (new fsm (boost::msm::back::states_
+                       << tiz::graph::fsm::configuring (&p_ops_)
+                       << tiz::graph::fsm::skipping (&p_ops_)
+                       << tiz::graph::fsm::seeking (&p_ops_),
                    &p_ops_))
 {
 }
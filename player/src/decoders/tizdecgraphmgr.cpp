@@ -79,7 +79,7 @@ graphmgr::ops *graphmgr::decodemgr::do_init (
   graphmgr_caps.can_go_previous_ = true;
   graphmgr_caps.can_play_ = true;
   graphmgr_caps.can_pause_ = true;
-  graphmgr_caps.can_seek_ = false;
+  graphmgr_caps.can_seek_ = true;
   graphmgr_caps.can_control_ = false;
 
   return new decodemgrops (this, playlist, termination_cback);
@@ -61,11 +61,13 @@ graph::ops *graph::pcmdecoder::do_init ()
   omx_comp_name_lst_t comp_list;
   comp_list.push_back ("OMX.Aratelia.file_reader.binary");
   comp_list.push_back ("OMX.Aratelia.audio_decoder.pcm");
+  comp_list.push_back ("OMX.Aratelia.audio_processor.pcm_conditioner");
   comp_list.push_back (tiz::graph::util::get_default_pcm_renderer ());
 
   omx_comp_role_lst_t role_list;
   role_list.push_back ("audio_reader.binary");
   role_list.push_back ("audio_decoder.pcm");
+  role_list.push_back ("audio_processor.pcm");
   role_list.push_back ("audio_renderer.pcm");
 
   return new pcmdecops (this, comp_list, role_list);
@@ -104,15 +106,30 @@ void graph::pcmdecops::do_configure ()
         "Unable to set OMX_IndexParamContentURI");
     OMX_ERRORTYPE rc = tiz::graph::util::normalize_tunnel_settings<
         OMX_AUDIO_PARAM_PCMMODETYPE, OMX_IndexParamAudioPcm > (
-        handles_, 1,  // tunneld id, i.e. this is decoder <-> renderer),
+        handles_, 1,  // tunneld id, i.e. this is decoder <-> conditioner),
         1,            // decoder's output port
-        0);           // renderer's input port
+        0);           // conditioner's input port
     G_OPS_BAIL_IF_ERROR (rc, "Unable to transfer OMX_IndexParamAudioPcm");
     G_OPS_BAIL_IF_ERROR (
         tiz::graph::util::set_pcm_mode (
             handles_[2], 0,
             boost::bind (&tiz::graph::pcmdecops::get_pcm_codec_info, this, _1)),
         "Unable to set OMX_IndexParamAudioPcm");
+    // The conditioner converts whatever the file contains (any sample size,
+    // sign or byte order) to its output port's format, which defaults to the
+    // renderer-friendly signed 16-bit little-endian.
+    G_OPS_BAIL_IF_ERROR (
+        tiz::graph::util::set_pcm_mode (
+            handles_[2], 1,
+            boost::bind (&tiz::graph::pcmdecops::get_conditioner_pcm_info,
+                         this, _1)),
+        "Unable to set OMX_IndexParamAudioPcm");
+    rc = tiz::graph::util::normalize_tunnel_settings<
+        OMX_AUDIO_PARAM_PCMMODETYPE, OMX_IndexParamAudioPcm > (
+        handles_, 2,  // tunneld id, i.e. this is conditioner <-> renderer),
+        1,            // conditioner's output port
+        0);           // renderer's input port
+    G_OPS_BAIL_IF_ERROR (rc, "Unable to transfer OMX_IndexParamAudioPcm");
   }
 }
 
@@ -135,3 +152,27 @@ void graph::pcmdecops::get_pcm_codec_info (OMX_AUDIO_PARAM_PCMMODETYPE &pcmtype)
   pcmtype.eNumData = dec_pcmtype.eNumData;
   pcmtype.bInterleaved = dec_pcmtype.bInterleaved;
 }
+
+void graph::pcmdecops::get_conditioner_pcm_info (
+    OMX_AUDIO_PARAM_PCMMODETYPE &pcmtype)
+{
+  OMX_U32 conditioner_port_id = 1;
+  OMX_AUDIO_PARAM_PCMMODETYPE stream_pcmtype;
+  TIZ_INIT_OMX_PORT_STRUCT (pcmtype, conditioner_port_id);
+
+  G_OPS_BAIL_IF_ERROR (
+      OMX_GetParameter (handles_[2], OMX_IndexParamAudioPcm, &pcmtype),
+      "Unable to get OMX_IndexParamAudioPcm from conditioner");
+
+  assert (probe_ptr_);
+  probe_ptr_->get_pcm_codec_info (stream_pcmtype);
+
+  // Keep the conditioner's sample format, but not its channel layout or rate
+  // (there is no resampling)
+  pcmtype.nChannels = stream_pcmtype.nChannels;
+  pcmtype.nSamplingRate = stream_pcmtype.nSamplingRate;
+  for (OMX_U32 i = 0; i < OMX_AUDIO_MAXCHANNELS; ++i)
+  {
+    pcmtype.eChannelMapping[i] = stream_pcmtype.eChannelMapping[i];
+  }
+}
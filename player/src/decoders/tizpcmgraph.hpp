@@ -62,6 +62,7 @@ namespace tiz
 
     private:
       void get_pcm_codec_info (OMX_AUDIO_PARAM_PCMMODETYPE &pcmtype);
+      void get_conditioner_pcm_info (OMX_AUDIO_PARAM_PCMMODETYPE &pcmtype);
     };
   }  // namespace graph
 }  // namespace tiz
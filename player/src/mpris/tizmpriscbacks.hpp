@@ -46,12 +46,14 @@ namespace tiz
     public:
       typedef boost::function< OMX_ERRORTYPE () > cback_func_t;
       typedef boost::function< OMX_ERRORTYPE (double) > cback_vol_func_t;
+      typedef boost::function< OMX_ERRORTYPE (int64_t) > cback_pos_func_t;
 
     public:
       mpris_callbacks (cback_func_t play, cback_func_t next,
                        cback_func_t previous, cback_func_t pause,
                        cback_func_t playpause, cback_func_t stop,
-                       cback_func_t quit, cback_vol_func_t volume)
+                       cback_func_t quit, cback_vol_func_t volume,
+                       cback_pos_func_t seek, cback_pos_func_t set_position)
         : play_ (play),
           next_ (next),
           previous_ (previous),
@@ -59,7 +61,9 @@ namespace tiz
           playpause_ (playpause),
           stop_ (stop),
           quit_ (quit),
-          volume_ (volume)
+          volume_ (volume),
+          seek_ (seek),
+          set_position_ (set_position)
       {
       }
 
@@ -72,6 +76,8 @@ namespace tiz
       cback_func_t stop_;
       cback_func_t quit_;
       cback_vol_func_t volume_;
+      cback_pos_func_t seek_;
+      cback_pos_func_t set_position_;
     };
 
     typedef class mpris_callbacks mpris_callbacks_t;
@@ -68,6 +68,24 @@ namespace
     }
     return dbus_meta;
   }
+
+  const char *DBUS_PROPERTIES_INTERFACE = "org.freedesktop.DBus.Properties";
+
+  typedef std::map< std::string, Tiz::DBus::Variant > dbus_props_t;
+
+  template < typename T >
+  void set_changed_prop (Tiz::DBus::InterfaceAdaptor &adaptor,
+                         Tiz::DBus::PropertyAdaptor< T > &prop, const T &value,
+                         const char *p_name, dbus_props_t &changed_props)
+  {
+    prop = value;
+    Tiz::DBus::Variant *p_var = adaptor.get_property (p_name);
+    if (p_var)
+    {
+      changed_props.insert (std::make_pair (std::string (p_name), *p_var));
+    }
+  }
+
 }  // namespace
 
 // Object path, a.k.a. node
@@ -153,13 +171,19 @@ void control::mprisif::Play ()
 
 void control::mprisif::Seek (const int64_t &Offset)
 {
-  // No-op for now
+  cbacks_.seek_ (Offset);
 }
 
 void control::mprisif::SetPosition (const ::Tiz::DBus::Path &TrackId,
                                     const int64_t &Position)
 {
-  // No-op for now
+  // Negative positions are ignored, as per the MPRIS spec
+  if (Position >= 0)
+  {
+    // Seeked is emitted once the graph has repositioned the stream, with the
+    // position it has actually landed on (see mprismgr::position_seeked).
+    cbacks_.set_position_ (Position);
+  }
 }
 
 void control::mprisif::OpenUri (const std::string &Uri)
@@ -196,3 +220,88 @@ void control::mprisif::UpdatePlayerProps (
   CanSeek = props.can_seek_;
   CanControl = props.can_control_;
 }
+
+void control::mprisif::PlayerPropsChanged (
+    const mpris_mediaplayer2_player_props_t &props, const uint32_t changed)
+{
+  typedef org::mpris::MediaPlayer2::Player_adaptor player_adaptor_t;
+  player_adaptor_t &adaptor = *this;
+  dbus_props_t changed_props;
+
+  if (changed & MprisPlayerPropPlaybackStatus)
+  {
+    set_changed_prop (adaptor, PlaybackStatus, props.playback_status_,
+                      "PlaybackStatus", changed_props);
+  }
+  if (changed & MprisPlayerPropLoopStatus)
+  {
+    set_changed_prop (adaptor, LoopStatus, props.loop_status_, "LoopStatus",
+                      changed_props);
+  }
+  if (changed & MprisPlayerPropRate)
+  {
+    set_changed_prop (adaptor, Rate, props.rate_, "Rate", changed_props);
+  }
+  if (changed & MprisPlayerPropShuffle)
+  {
+    set_changed_prop (adaptor, Shuffle, props.shuffle_, "Shuffle",
+                      changed_props);
+  }
+  if (changed & MprisPlayerPropMetadata)
+  {
+    set_changed_prop (adaptor, Metadata, toDbusMetadata (props.metadata_),
+                      "Metadata", changed_props);
+  }
+  if (changed & MprisPlayerPropVolume)
+  {
+    set_changed_prop (adaptor, Volume, props.volume_, "Volume", changed_props);
+  }
+  if (changed & MprisPlayerPropCanGoNext)
+  {
+    set_changed_prop (adaptor, CanGoNext, props.can_go_next_, "CanGoNext",
+                      changed_props);
+  }
+  if (changed & MprisPlayerPropCanGoPrevious)
+  {
+    set_changed_prop (adaptor, CanGoPrevious, props.can_go_previous_,
+                      "CanGoPrevious", changed_props);
+  }
+  if (changed & MprisPlayerPropCanPlay)
+  {
+    set_changed_prop (adaptor, CanPlay, props.can_play_, "CanPlay",
+                      changed_props);
+  }
+  if (changed & MprisPlayerPropCanPause)
+  {
+    set_changed_prop (adaptor, CanPause, props.can_pause_, "CanPause",
+                      changed_props);
+  }
+  if (changed & MprisPlayerPropCanSeek)
+  {
+    set_changed_prop (adaptor, CanSeek, props.can_seek_, "CanSeek",
+                      changed_props);
+  }
+
+  if (changed & MprisPlayerPropPosition)
+  {
+    // Position is not part of PropertiesChanged; clients are told that it
+    // has jumped instead.
+    Position = props.position_;
+    Seeked (props.position_);
+  }
+
+  if (!changed_props.empty ())
+  {
+    // All the changes go in one signal
+    Tiz::DBus::SignalMessage sig (TIZONIA_MPRIS_OBJECT_PATH,
+                                  DBUS_PROPERTIES_INTERFACE,
+                                  "PropertiesChanged");
+    Tiz::DBus::MessageIter wi = sig.writer ();
+    wi << adaptor.name ();
+    wi << changed_props;
+    wi << std::vector< std::string > ();
+    TIZ_LOG (TIZ_PRIORITY_TRACE, "PropertiesChanged : [%u] properties",
+             changed_props.size ());
+    adaptor.emit_signal (sig);
+  }
+}
@@ -29,6 +29,8 @@
 #ifndef TIZMPRISIF_HPP
 #define TIZMPRISIF_HPP
 
+#include <stdint.h>
+
 #include <dbus-c++/dbus.h>
 
 #include <mpris_dbus.hpp>
@@ -70,6 +72,15 @@ namespace tiz
       void UpdateProps (const mpris_mediaplayer2_props_t &props);
       void UpdatePlayerProps (const mpris_mediaplayer2_player_props_t &props);
 
+      /**
+       * Update the player properties flagged in @a changed (a mask of
+       * mpris_player_prop values), and announce them with a single
+       * PropertiesChanged signal. A Position change is announced with the
+       * Seeked signal instead.
+       */
+      void PlayerPropsChanged (const mpris_mediaplayer2_player_props_t &props,
+                               const uint32_t changed);
+
       /* Methods exported by the MediaPlayer2_adaptor */
       void Raise ();
       void Quit ();
@@ -54,6 +54,9 @@
 
 #define TIZ_MPRISMGR_QUEUE_MAX_ITEMS 30
 
+// Player property changes are coalesced, and signalled at most this often
+#define TIZ_MPRISMGR_PROPS_FLUSH_INTERVAL_MS 100
+
 namespace control = tiz::control;
 
 namespace
@@ -61,8 +64,6 @@ namespace
   // Bus name
   const char *TIZONIA_MPRIS_BUS_NAME = "org.mpris.MediaPlayer2.tizonia";
 
-  tiz::control::mpris_mediaplayer2_player_props_t *gp_player_props = NULL;
-
   std::string get_unique_bus_name ()
   {
     std::string bus_name (TIZONIA_MPRIS_BUS_NAME);
@@ -72,14 +73,17 @@ namespace
     return bus_name;
   }
 
+  // Runs on the MPRIS thread. The pipe only carries wake-ups; the actual
+  // changes are picked up by the flush timeout.
   void player_props_pipe_handler (const void *p_arg, void *p_buffer,
                                   unsigned int nbyte)
   {
-    tiz::control::mprisif *p_mif
-        = static_cast< tiz::control::mprisif * > (const_cast< void * > (p_arg));
-    if (p_mif && gp_player_props)
+    Tiz::DBus::DefaultTimeout *p_timeout
+        = static_cast< Tiz::DBus::DefaultTimeout * > (
+            const_cast< void * > (p_arg));
+    if (p_timeout)
     {
-      p_mif->UpdatePlayerProps (*gp_player_props);
+      p_timeout->enabled (true);
     }
   }
 
@@ -128,22 +132,23 @@ control::mprismgr::mprismgr (
     p_dispatcher_ (NULL),
     p_player_props_pipe_ (NULL),
     p_dbus_timeout_ (NULL),
+    p_flush_timeout_ (NULL),
     p_dbus_connection_ (NULL),
+    p_mif_ (NULL),
     playback_connections_ (),
     thread_ (),
     mutex_ (),
     sem_ (),
-    p_queue_ (NULL)
+    p_queue_ (NULL),
+    props_mutex_ (),
+    dirty_ (0),
+    wake_pending_ (false)
 {
-  gp_player_props = &player_props_;
   connect_slots (playback_events);
 }
 
 control::mprismgr::~mprismgr ()
 {
-  gp_player_props = NULL;
-  delete p_dbus_timeout_;
-  p_dbus_timeout_ = NULL;
   // NOTE: We need to leak this object. Its deletion produces a crash in
   // dbus-c++
   //
@@ -191,32 +196,37 @@ control::mprismgr::stop ()
 
 void control::mprismgr::deinit ()
 {
-  delete p_dispatcher_;
-  p_dispatcher_ = NULL;
   static_cast< void > (tiz_sem_wait (&sem_));
   void *p_result = NULL;
   static_cast< void > (tiz_thread_join (&thread_, &p_result));
+  // The timeouts must go before the dispatcher, which would otherwise delete
+  // them itself and leave these pointers dangling.
+  delete p_flush_timeout_;
+  p_flush_timeout_ = NULL;
+  delete p_dbus_timeout_;
+  p_dbus_timeout_ = NULL;
+  delete p_dispatcher_;
+  p_dispatcher_ = NULL;
   deinit_cmd_queue ();
 }
 
 void control::mprismgr::playback_status_changed (const playback_status_t status)
 {
-  if (p_player_props_pipe_)
+  tiz_check_true_ret_void (OMX_ErrorNone == tiz_mutex_lock (&props_mutex_));
+  if (control::Playing == status)
   {
-    if (control::Playing == status)
-    {
-      player_props_.playback_status_ = "Playing";
-    }
-    else if (control::Paused == status)
-    {
-      player_props_.playback_status_ = "Paused";
-    }
-    else if (control::Stopped == status)
-    {
-      player_props_.playback_status_ = "Stopped";
-    }
-    p_player_props_pipe_->write (&player_props_, sizeof (player_props_));
+    player_props_.playback_status_ = "Playing";
   }
+  else if (control::Paused == status)
+  {
+    player_props_.playback_status_ = "Paused";
+  }
+  else if (control::Stopped == status)
+  {
+    player_props_.playback_status_ = "Stopped";
+  }
+  props_changed (MprisPlayerPropPlaybackStatus);
+  tiz_check_true_ret_void (OMX_ErrorNone == tiz_mutex_unlock (&props_mutex_));
 }
 
 void control::mprismgr::loop_status_changed (const loop_status_t status)
@@ -228,19 +238,74 @@ void control::mprismgr::metadata_changed (const track_metadata_map_t &metadata)
 {
   // TODO
   //   player_props_.metadata_ = metadata;
-  //   p_player_props_pipe_->write(&player_props_, sizeof (player_props_));
+  //   props_changed (MprisPlayerPropMetadata);
 }
 
 void control::mprismgr::volume_changed (const double volume)
 {
+  tiz_check_true_ret_void (OMX_ErrorNone == tiz_mutex_lock (&props_mutex_));
   player_props_.volume_ = volume;
-  p_player_props_pipe_->write (&player_props_, sizeof (player_props_));
+  props_changed (MprisPlayerPropVolume);
+  tiz_check_true_ret_void (OMX_ErrorNone == tiz_mutex_unlock (&props_mutex_));
+}
+
+void control::mprismgr::position_seeked (const int64_t position)
+{
+  tiz_check_true_ret_void (OMX_ErrorNone == tiz_mutex_lock (&props_mutex_));
+  player_props_.position_ = position;
+  props_changed (MprisPlayerPropPosition);
+  tiz_check_true_ret_void (OMX_ErrorNone == tiz_mutex_unlock (&props_mutex_));
+}
+
+// Called with props_mutex_ held, from the player's threads. Only the first
+// change after a flush wakes up the MPRIS thread, so the pipe never holds
+// more than one message, however often the properties change.
+void control::mprismgr::props_changed (const uint32_t changed)
+{
+  dirty_ |= changed;
+  if (!wake_pending_ && p_player_props_pipe_)
+  {
+    const char wake = 1;
+    wake_pending_ = true;
+    p_player_props_pipe_->write (&wake, sizeof (wake));
+  }
+}
+
+// Runs on the MPRIS thread
+void control::mprismgr::flush_timeout_expired (
+    Tiz::DBus::DefaultTimeout &timeout)
+{
+  uint32_t dirty = 0;
+  mpris_mediaplayer2_player_props_scoped_ptr_t p_props;
+
+  if (OMX_ErrorNone == tiz_mutex_lock (&props_mutex_))
+  {
+    dirty = dirty_;
+    if (dirty)
+    {
+      p_props.reset (new mpris_mediaplayer2_player_props_t (player_props_));
+    }
+    dirty_ = 0;
+    wake_pending_ = false;
+    static_cast< void > (tiz_mutex_unlock (&props_mutex_));
+  }
+
+  if (dirty && p_props && p_mif_)
+  {
+    p_mif_->PlayerPropsChanged (*p_props, dirty);
+  }
+  else
+  {
+    // Nothing has changed for a whole interval; sleep until the next wake-up
+    timeout.enabled (false);
+  }
 }
 
 OMX_ERRORTYPE
 control::mprismgr::init_cmd_queue ()
 {
   tiz_check_omx_ret_oom (tiz_mutex_init (&mutex_));
+  tiz_check_omx_ret_oom (tiz_mutex_init (&props_mutex_));
   tiz_check_omx_ret_oom (tiz_sem_init (&sem_, 0));
   tiz_check_omx_ret_oom (
       tiz_queue_init (&p_queue_, TIZ_MPRISMGR_QUEUE_MAX_ITEMS));
@@ -250,6 +315,7 @@ control::mprismgr::init_cmd_queue ()
 void control::mprismgr::deinit_cmd_queue ()
 {
   tiz_mutex_destroy (&mutex_);
+  tiz_mutex_destroy (&props_mutex_);
   tiz_sem_destroy (&sem_);
   tiz_queue_destroy (p_queue_);
 }
@@ -285,19 +351,36 @@ bool control::mprismgr::dispatch_cmd (control::mprismgr *p_mgr,
       p_mgr->p_dbus_connection_
           = new Tiz::DBus::Connection (Tiz::DBus::Connection::SessionBus ());
       p_mgr->p_dbus_connection_->request_name (get_unique_bus_name ().c_str ());
+      p_mgr->p_flush_timeout_ = new Tiz::DBus::DefaultTimeout (
+          TIZ_MPRISMGR_PROPS_FLUSH_INTERVAL_MS, true, p_mgr->p_dispatcher_);
+      p_mgr->p_flush_timeout_->expired
+          = new Tiz::DBus::Callback< mprismgr, void,
+                                     Tiz::DBus::DefaultTimeout & > (
+              p_mgr, &mprismgr::flush_timeout_expired);
+      p_mgr->p_flush_timeout_->enabled (false);
+      tiz_check_true_ret_val (
+          OMX_ErrorNone == tiz_mutex_lock (&(p_mgr->props_mutex_)), false);
       mprisif mif (*(p_mgr->p_dbus_connection_), p_mgr->props_,
                    p_mgr->player_props_, p_mgr->cbacks_);
-      p_mgr->p_player_props_pipe_
-          = p_mgr->p_dispatcher_->add_pipe (player_props_pipe_handler, &mif);
+      p_mgr->p_mif_ = &mif;
+      p_mgr->p_player_props_pipe_ = p_mgr->p_dispatcher_->add_pipe (
+          player_props_pipe_handler, p_mgr->p_flush_timeout_);
+      tiz_check_true_ret_val (
+          OMX_ErrorNone == tiz_mutex_unlock (&(p_mgr->props_mutex_)), false);
       p_mgr->p_dispatcher_->enter ();
+      p_mgr->p_mif_ = NULL;
       TIZ_LOG (TIZ_PRIORITY_TRACE, "MPRIS dispatcher done...");
     }
     else if (p_cmd->is_stop ())
     {
       TIZ_LOG (TIZ_PRIORITY_TRACE, "MPRIS processing STOP cmd...");
       p_mgr->disconnect_slots ();
-      p_mgr->p_dispatcher_->del_pipe (p_mgr->p_player_props_pipe_);
-      p_mgr->p_player_props_pipe_ = NULL;
+      if (OMX_ErrorNone == tiz_mutex_lock (&(p_mgr->props_mutex_)))
+      {
+        p_mgr->p_dispatcher_->del_pipe (p_mgr->p_player_props_pipe_);
+        p_mgr->p_player_props_pipe_ = NULL;
+        static_cast< void > (tiz_mutex_unlock (&(p_mgr->props_mutex_)));
+      }
       terminated = true;
       TIZ_LOG (TIZ_PRIORITY_TRACE, "MPRIS interface terminating...");
     }
@@ -315,6 +398,8 @@ void control::mprismgr::connect_slots (playback_events_t &playback_events)
       boost::bind (&tiz::control::mprismgr::metadata_changed, this, _1));
   playback_connections_.volume_ = playback_events.volume_.connect (
       boost::bind (&tiz::control::mprismgr::volume_changed, this, _1));
+  playback_connections_.seeked_ = playback_events.seeked_.connect (
+      boost::bind (&tiz::control::mprismgr::position_seeked, this, _1));
 }
 
 void control::mprismgr::disconnect_slots ()
@@ -323,4 +408,5 @@ void control::mprismgr::disconnect_slots ()
   playback_connections_.loop_.disconnect ();
   playback_connections_.metadata_.disconnect ();
   playback_connections_.volume_.disconnect ();
+  playback_connections_.seeked_.disconnect ();
 }
@@ -63,6 +63,7 @@ namespace tiz
 
     // Forward declarations
     void *thread_func (void *p_arg);
+    class mprisif;
 
     struct cmd
     {
@@ -163,6 +164,9 @@ namespace tiz
       void loop_status_changed (const loop_status_t status);
       void metadata_changed (const track_metadata_map_t &metadata);
       void volume_changed (const double volume);
+      void position_seeked (const int64_t position);
+      void props_changed (const uint32_t changed);
+      void flush_timeout_expired (Tiz::DBus::DefaultTimeout &timeout);
 
     protected:
       mpris_mediaplayer2_props_t props_;
@@ -171,7 +175,9 @@ namespace tiz
       Tiz::DBus::BusDispatcher *p_dispatcher_;
       Tiz::DBus::Pipe *p_player_props_pipe_;  // Not owned
       Tiz::DBus::DefaultTimeout *p_dbus_timeout_;
+      Tiz::DBus::DefaultTimeout *p_flush_timeout_;
       Tiz::DBus::Connection *p_dbus_connection_;
+      mprisif *p_mif_;  // Not owned, only valid while the dispatcher runs
 
     private:
       OMX_ERRORTYPE init_cmd_queue ();
@@ -185,7 +191,7 @@ namespace tiz
       struct playback_connections
       {
         playback_connections ()
-          : playback_ (), loop_ (), metadata_ (), volume_ ()
+          : playback_ (), loop_ (), metadata_ (), volume_ (), seeked_ ()
         {
         }
 
@@ -194,6 +200,7 @@ namespace tiz
         boost::signals2::connection loop_;
         boost::signals2::connection metadata_;
         boost::signals2::connection volume_;
+        boost::signals2::connection seeked_;
       };
       typedef struct playback_connections playback_connections_t;
 
@@ -205,6 +212,11 @@ namespace tiz
       tiz_mutex_t mutex_;
       tiz_sem_t sem_;
       tiz_queue_t *p_queue_;
+      // Protects player_props_, dirty_ and wake_pending_, which are written
+      // from the player's threads and read from the MPRIS thread.
+      tiz_mutex_t props_mutex_;
+      uint32_t dirty_;
+      bool wake_pending_;
     };
 
     typedef boost::shared_ptr< mprismgr > mprismgr_ptr_t;
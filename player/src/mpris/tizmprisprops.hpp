@@ -97,6 +97,29 @@ namespace tiz
       bool can_control_;
     };
 
+    /**
+     * Bit flags that identify the player properties that have changed since
+     * they were last signalled. As per the MPRIS spec, Position changes are
+     * never part of PropertiesChanged; clients derive it from Rate. The
+     * Position flag marks a discontinuity instead, and is announced with the
+     * Seeked signal.
+     */
+    enum mpris_player_prop
+    {
+      MprisPlayerPropPlaybackStatus = 1 << 0,
+      MprisPlayerPropLoopStatus = 1 << 1,
+      MprisPlayerPropRate = 1 << 2,
+      MprisPlayerPropShuffle = 1 << 3,
+      MprisPlayerPropMetadata = 1 << 4,
+      MprisPlayerPropVolume = 1 << 5,
+      MprisPlayerPropCanGoNext = 1 << 6,
+      MprisPlayerPropCanGoPrevious = 1 << 7,
+      MprisPlayerPropCanPlay = 1 << 8,
+      MprisPlayerPropCanPause = 1 << 9,
+      MprisPlayerPropCanSeek = 1 << 10,
+      MprisPlayerPropPosition = 1 << 11
+    };
+
     typedef boost::shared_ptr< mpris_mediaplayer2_player_props_t >
         mpris_mediaplayer2_player_props_ptr_t;
     typedef boost::scoped_ptr< mpris_mediaplayer2_player_props_t >
@@ -166,9 +166,10 @@ graph::graph::pause ()
 }
 
 OMX_ERRORTYPE
-graph::graph::seek ()
+graph::graph::seek (const OMX_TICKS pos, const bool is_relative)
 {
-  return post_cmd (new tiz::graph::cmd (tiz::graph::seek_evt ()));
+  return post_cmd (
+      new tiz::graph::cmd (tiz::graph::seek_evt (pos, is_relative)));
 }
 
 OMX_ERRORTYPE
@@ -258,6 +259,15 @@ void graph::graph::omx_evt (const omx_event_info &evt_info)
       post_cmd (new tiz::graph::cmd (tiz::graph::omx_port_enabled_evt (
           evt_info.component_, evt_info.ndata2_, error)));
     }
+    else if (evt_info.event_ == OMX_EventCmdComplete
+             && static_cast< OMX_COMMANDTYPE > (evt_info.ndata1_)
+                    == OMX_CommandFlush)
+    {
+      OMX_ERRORTYPE error
+          = static_cast< OMX_ERRORTYPE > (*((int *)&((evt_info.pEventData_))));
+      post_cmd (new tiz::graph::cmd (tiz::graph::omx_port_flushed_evt (
+          evt_info.component_, evt_info.ndata2_, error)));
+    }
     else if (evt_info.event_ == OMX_EventError)
     {
       post_cmd (new tiz::graph::cmd (tiz::graph::omx_err_evt (
@@ -366,6 +376,14 @@ void graph::graph::graph_volume (const int volume)
   }
 }
 
+void graph::graph::graph_seeked (const OMX_TICKS position)
+{
+  if (p_mgr_)
+  {
+    p_mgr_->graph_seeked (position);
+  }
+}
+
 void graph::graph::graph_unloaded ()
 {
   if (p_mgr_)
@@ -434,6 +452,19 @@ void graph::graph::progress_display_resume ()
   }
 }
 
+void graph::graph::progress_display_seek (unsigned long position)
+{
+  if (p_progress_)
+  {
+    p_progress_->seek (position);
+  }
+}
+
+unsigned long graph::graph::progress_display_position () const
+{
+  return p_progress_ ? p_progress_->count () : 0;
+}
+
 void graph::graph::progress_display_stop ()
 {
   if (p_ev_timer_)
@@ -74,7 +74,7 @@ namespace tiz
       OMX_ERRORTYPE execute (const tizgraphconfig_ptr_t config
                              = tizgraphconfig_ptr_t ());
       OMX_ERRORTYPE pause ();
-      OMX_ERRORTYPE seek ();
+      OMX_ERRORTYPE seek (const OMX_TICKS pos, const bool is_relative);
       OMX_ERRORTYPE skip (const int jump);
       OMX_ERRORTYPE volume_step (const int step);
       OMX_ERRORTYPE volume (const double vol);
@@ -101,6 +101,7 @@ namespace tiz
       void graph_resumed ();
       void graph_metadata (const track_metadata_map_t &metadata);
       void graph_volume (const int volume);
+      void graph_seeked (const OMX_TICKS position);
       void graph_unloaded ();
       void graph_end_of_play ();
       void graph_error (const OMX_ERRORTYPE error, const std::string &msg);
@@ -109,6 +110,8 @@ namespace tiz
       void progress_display_increase ();
       void progress_display_pause ();
       void progress_display_resume ();
+      void progress_display_seek (unsigned long position);
+      unsigned long progress_display_position () const;
       void progress_display_stop ();
 
       std::string get_graph_name () const;
@@ -328,6 +328,19 @@ namespace tiz
       }
     };
 
+    struct do_store_seek
+    {
+      template < class FSM, class EVT, class SourceState, class TargetState >
+      void operator() (EVT const& evt, FSM& fsm, SourceState&, TargetState&)
+      {
+        G_ACTION_LOG ();
+        if (fsm.pp_ops_ && *(fsm.pp_ops_))
+        {
+          (*(fsm.pp_ops_))->do_store_seek (evt.pos_, evt.is_relative_);
+        }
+      }
+    };
+
     struct do_seek
     {
       template < class FSM, class EVT, class SourceState, class TargetState >
@@ -743,6 +756,32 @@ namespace tiz
       }
     };
 
+    struct do_ack_seeked
+    {
+      template < class FSM, class EVT, class SourceState, class TargetState >
+      void operator() (EVT const&, FSM& fsm, SourceState&, TargetState&)
+      {
+        G_ACTION_LOG ();
+        if (fsm.pp_ops_ && *(fsm.pp_ops_))
+        {
+          (*(fsm.pp_ops_))->do_ack_seeked ();
+        }
+      }
+    };
+
+    struct do_seek_progress_display
+    {
+      template < class FSM, class EVT, class SourceState, class TargetState >
+      void operator() (EVT const&, FSM& fsm, SourceState&, TargetState&)
+      {
+        G_ACTION_LOG ();
+        if (fsm.pp_ops_ && *(fsm.pp_ops_))
+        {
+          (*(fsm.pp_ops_))->do_seek_progress_display ();
+        }
+      }
+    };
+
     struct do_resume_progress_display
     {
       template < class FSM, class EVT, class SourceState, class TargetState >
@@ -105,6 +105,25 @@ namespace tiz
 
     struct seek_evt
     {
+      seek_evt (const OMX_TICKS a_pos, const bool a_is_relative)
+        : pos_ (a_pos), is_relative_ (a_is_relative)
+      {
+      }
+      OMX_TICKS pos_;  // microseconds
+      bool is_relative_;
+    };
+
+    // Make this state convertible from any state (this event exits a
+    // sub-machine)
+    struct seeked_evt
+    {
+      seeked_evt ()
+      {
+      }
+      template < class Event >
+      seeked_evt (Event const &)
+      {
+      }
     };
 
     struct volume_step_evt
@@ -68,9 +68,10 @@ namespace tiz
   namespace graph
   {
     static char const* const state_names[]
-        = { "inited",    "loaded",      "configuring", "executing",  "skipping",
-            "exe2pause", "pause",       "pause2exe",   "pause2idle", "exe2idle",
-            "idle",      "idle2loaded", "AllOk",       "unloaded" };
+        = { "inited",    "loaded",     "configuring", "executing",
+            "skipping",  "seeking",    "exe2pause",   "pause",
+            "pause2exe", "pause2idle", "exe2idle",    "idle",
+            "idle2loaded", "AllOk",    "unloaded" };
 
     // Concrete FSM implementation
     struct fsm_ : public boost::msm::front::state_machine_def< fsm_ >
@@ -298,6 +299,97 @@ namespace tiz
       // boost::msm::back::mpl_graph_fsm_check> skipping;
       typedef boost::msm::back::state_machine< skipping_ > skipping;
 
+      /* 'seeking' is a submachine */
+      struct seeking_
+        : public boost::msm::front::state_machine_def< seeking_ >
+      {
+        // no need for exception handling
+        typedef int no_exception_thrown;
+
+        // data members
+        ops** pp_ops_;
+
+        seeking_ () : pp_ops_ (NULL)
+        {
+        }
+        seeking_ (ops** pp_ops) : pp_ops_ (pp_ops)
+        {
+          assert (pp_ops);
+        }
+
+        // submachine states
+        struct flushing : public boost::msm::front::state<>
+        {
+          // Requests arriving while the tunnels are being flushed are
+          // processed once the graph is back in 'executing'.
+          typedef boost::mpl::vector< seek_evt, skip_evt, pause_evt, stop_evt,
+                                      unload_evt >
+              deferred_events;
+          template < class Event, class FSM >
+          void on_entry (Event const& evt, FSM& fsm)
+          {
+            G_FSM_LOG ();
+            if (fsm.pp_ops_ && *(fsm.pp_ops_))
+            {
+              (*(fsm.pp_ops_))->do_seek ();
+            }
+          }
+          template < class Event, class FSM >
+          void on_exit (Event const& evt, FSM& fsm)
+          {
+            G_FSM_LOG ();
+          }
+        };
+
+        struct seek_exit
+          : public boost::msm::front::exit_pseudo_state< seeked_evt >
+        {
+          template < class Event, class FSM >
+          void on_entry (Event const& evt, FSM& fsm)
+          {
+            G_FSM_LOG ();
+          }
+        };
+
+        // the initial state. Must be defined
+        typedef flushing initial_state;
+
+        // transition actions
+
+        // guard conditions
+
+        // Transition table for seeking
+        struct transition_table
+          : boost::mpl::vector<
+                //                       Start             Event            Next
+                //                       Action                           Guard
+                //    +-----------------+------------------+----------------+----------------------+--------------------------------+---------------------------+
+                boost::msm::front::Row< flushing, omx_port_flushed_evt,
+                                        seek_exit, boost::msm::front::none,
+                                        is_port_flushing_complete >,
+                // The end of stream was reached before the flush; the stream
+                // is being repositioned, so this is not the end of the track
+                boost::msm::front::Row< flushing, omx_eos_evt,
+                                        boost::msm::front::none,
+                                        boost::msm::front::none >
+                //    +-----------------+------------------+----------------+----------------------+--------------------------------+---------------------------+
+                >
+        {
+        };
+
+        // Replaces the default no-transition response.
+        template < class FSM, class Event >
+        void no_transition (Event const& e, FSM&, int state)
+        {
+          TIZ_LOG (TIZ_PRIORITY_ERROR,
+                   "no transition from state %d on event %s", state,
+                   typeid (e).name ());
+        }
+      };
+      // typedef boost::msm::back::state_machine<seeking_,
+      // boost::msm::back::mpl_graph_fsm_check> seeking;
+      typedef boost::msm::back::state_machine< seeking_ > seeking;
+
       // The initial state of the SM. Must be defined
       typedef boost::mpl::vector< inited, AllOk > initial_state;
 
@@ -341,8 +433,8 @@ namespace tiz
               //    +------------------------------+-----------------+-------------------------+-------------------------+----------------------+
               boost::msm::front::Row< executing, skip_evt, skipping,
                                       do_store_skip >,
-              boost::msm::front::Row< executing, seek_evt,
-                                      boost::msm::front::none, do_seek >,
+              boost::msm::front::Row< executing, seek_evt, seeking,
+                                      do_store_seek, is_seek_allowed >,
               boost::msm::front::Row< executing, volume_step_evt,
                                       boost::msm::front::none, do_volume_step >,
               boost::msm::front::Row< executing, volume_evt,
@@ -385,6 +477,17 @@ namespace tiz
                   configuring, do_stop_progress_display,
                   boost::msm::front::euml::Not_< is_end_of_play > >,
               //    +------------------------------+-----------------+-------------------------+-------------------------+----------------------+
+              boost::msm::front::Row<
+                  seeking ::exit_pt< seeking_ ::seek_exit >, seeked_evt,
+                  executing,
+                  boost::msm::front::ActionSequence_< boost::mpl::vector<
+                      do_ack_seeked, do_seek_progress_display > > >,
+              boost::msm::front::Row< seeking, omx_err_evt, skipping,
+                                      do_record_fatal_error, is_fatal_error >,
+              boost::msm::front::Row< seeking, timer_evt,
+                                      boost::msm::front::none,
+                                      do_increase_progress_display >,
+              //    +------------------------------+-----------------+-------------------------+-------------------------+----------------------+
               boost::msm::front::Row<
                   exe2pause, omx_trans_evt, pause,
                   boost::msm::front::ActionSequence_< boost::mpl::vector<
@@ -84,6 +84,23 @@ namespace tiz
       }
     };
 
+    struct is_port_flushing_complete
+    {
+      template < class EVT, class FSM, class SourceState, class TargetState >
+      bool operator() (EVT const& evt, FSM& fsm, SourceState& source,
+                       TargetState& target)
+      {
+        bool rc = false;
+        if (fsm.pp_ops_ && *(fsm.pp_ops_))
+        {
+          rc = (*(fsm.pp_ops_))
+                   ->is_port_flushing_complete (evt.handle_, evt.port_);
+        }
+        G_GUARD_LOG (rc);
+        return rc;
+      }
+    };
+
     struct is_disabled_evt_required
     {
       template < class EVT, class FSM, class SourceState, class TargetState >
@@ -368,6 +385,21 @@ namespace tiz
       }
     };
 
+    struct is_seek_allowed
+    {
+      template < class EVT, class FSM, class SourceState, class TargetState >
+      bool operator() (EVT const& evt, FSM& fsm, SourceState&, TargetState&)
+      {
+        bool rc = false;
+        if (fsm.pp_ops_ && *(fsm.pp_ops_))
+        {
+          rc = (*(fsm.pp_ops_))->is_seek_allowed ();
+        }
+        G_GUARD_LOG (rc);
+        return rc;
+      }
+    };
+
   }  // namespace graph
 }  // namespace tiz
 
@@ -197,15 +197,40 @@ graphmgr::mgr::print_playlist ()
 }
 
 OMX_ERRORTYPE
-graphmgr::mgr::fwd ()
+graphmgr::mgr::fwd (const int secs)
 {
-  return post_cmd (new graphmgr::cmd (graphmgr::fwd_evt ()));
+  return post_cmd (new graphmgr::cmd (graphmgr::fwd_evt (secs)));
 }
 
 OMX_ERRORTYPE
-graphmgr::mgr::rwd ()
+graphmgr::mgr::rwd (const int secs)
 {
-  return post_cmd (new graphmgr::cmd (graphmgr::rwd_evt ()));
+  return post_cmd (new graphmgr::cmd (graphmgr::rwd_evt (secs)));
+}
+
+OMX_ERRORTYPE
+graphmgr::mgr::seek (const int64_t offset_us)
+{
+  if (offset_us == 0)
+  {
+    return OMX_ErrorNone;
+  }
+
+  const int secs = static_cast< int > (offset_us / 1000000);
+  if (offset_us > 0)
+  {
+    return fwd (secs);
+  }
+  else
+  {
+    return rwd (-secs);
+  }
+}
+
+OMX_ERRORTYPE
+graphmgr::mgr::set_position (const int64_t pos_us)
+{
+  return post_cmd (new graphmgr::cmd (graphmgr::set_pos_evt (pos_us)));
 }
 
 OMX_ERRORTYPE
@@ -298,6 +323,12 @@ graphmgr::mgr::graph_volume (const int volume)
   return post_cmd (new graphmgr::cmd (graphmgr::graph_volume_evt (volume)));
 }
 
+OMX_ERRORTYPE
+graphmgr::mgr::graph_seeked (const OMX_TICKS position)
+{
+  return post_cmd (new graphmgr::cmd (graphmgr::graph_seeked_evt (position)));
+}
+
 OMX_ERRORTYPE
 graphmgr::mgr::graph_unloaded ()
 {
@@ -332,7 +363,9 @@ graphmgr::mgr::start_mpris (const graphmgr_capabilities_t &graphmgr_caps)
         boost::bind (&tiz::graphmgr::mgr::pause, this),
         boost::bind (&tiz::graphmgr::mgr::stop, this),
         boost::bind (&tiz::graphmgr::mgr::quit, this),
-        boost::bind (&tiz::graphmgr::mgr::volume, this, _1));
+        boost::bind (&tiz::graphmgr::mgr::volume, this, _1),
+        boost::bind (&tiz::graphmgr::mgr::seek, this, _1),
+        boost::bind (&tiz::graphmgr::mgr::set_position, this, _1));
 
     control::mpris_mediaplayer2_props_t props (
         graphmgr_caps.can_quit_, graphmgr_caps.can_raise_,
@@ -400,6 +433,13 @@ graphmgr::mgr::do_update_volume (const int volume)
   return OMX_ErrorNone;
 }
 
+OMX_ERRORTYPE
+graphmgr::mgr::do_update_position (const OMX_TICKS position)
+{
+  playback_events_.seeked_ (position);
+  return OMX_ErrorNone;
+}
+
 OMX_ERRORTYPE
 graphmgr::mgr::init_cmd_queue ()
 {
@@ -132,24 +132,46 @@ namespace tiz
       OMX_ERRORTYPE prev ();
 
       /**
-       * NOT IMPLEMENTED YET
+       * Move the playback position forward by a number of seconds.
        *
        * @pre init() has been called on this manager.
        *
        * @return OMX_ErrorInsuficientResources if OOM. OMX_ErrorNone in case of
        * success.
        */
-      OMX_ERRORTYPE fwd ();
+      OMX_ERRORTYPE fwd (const int secs);
 
       /**
-       * NOT IMPLEMENTED YET
+       * Move the playback position backwards by a number of seconds.
        *
        * @pre init() has been called on this manager.
        *
        * @return OMX_ErrorInsuficientResources if OOM. OMX_ErrorNone in case of
        * success.
        */
-      OMX_ERRORTYPE rwd ();
+      OMX_ERRORTYPE rwd (const int secs);
+
+      /**
+       * Move the playback position by a relative offset, in microseconds.
+       * Negative values seek backwards.
+       *
+       * @pre init() has been called on this manager.
+       *
+       * @return OMX_ErrorInsuficientResources if OOM. OMX_ErrorNone in case of
+       * success.
+       */
+      OMX_ERRORTYPE seek (const int64_t offset_us);
+
+      /**
+       * Set the playback position of the current track, in microseconds from
+       * the beginning of the track.
+       *
+       * @pre init() has been called on this manager.
+       *
+       * @return OMX_ErrorInsuficientResources if OOM. OMX_ErrorNone in case of
+       * success.
+       */
+      OMX_ERRORTYPE set_position (const int64_t pos_us);
 
       /**
        * Increments or decrements the volume by steps.
@@ -226,6 +248,7 @@ namespace tiz
       OMX_ERRORTYPE graph_resumed ();
       OMX_ERRORTYPE graph_metadata (const track_metadata_map_t &metadata);
       OMX_ERRORTYPE graph_volume (const int volume);
+      OMX_ERRORTYPE graph_seeked (const OMX_TICKS position);
       OMX_ERRORTYPE graph_unloaded ();
       OMX_ERRORTYPE graph_end_of_play ();
       OMX_ERRORTYPE graph_error (const OMX_ERRORTYPE error,
@@ -238,6 +261,7 @@ namespace tiz
           const std::string &current_song = std::string ());
       OMX_ERRORTYPE do_update_metadata (const track_metadata_map_t &metadata);
       OMX_ERRORTYPE do_update_volume (const int volume);
+      OMX_ERRORTYPE do_update_position (const OMX_TICKS position);
 
     protected:
       ops *p_ops_;
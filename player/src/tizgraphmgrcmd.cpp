@@ -78,8 +78,8 @@ void graphmgr::cmd::inject (fsm& machine) const
   }
 
   INJECT_EVENT (start_evt)
-  else INJECT_EVENT (next_evt) else INJECT_EVENT (prev_evt) else INJECT_EVENT (fwd_evt) else INJECT_EVENT (rwd_evt) else INJECT_EVENT (vol_up_evt) else INJECT_EVENT (vol_down_evt) else INJECT_EVENT (vol_evt) else INJECT_EVENT (mute_evt) else INJECT_EVENT (pause_evt) else INJECT_EVENT (stop_evt) else INJECT_EVENT (
-      quit_evt) else INJECT_EVENT (graph_eop_evt) else INJECT_EVENT (err_evt) else INJECT_EVENT (graph_loaded_evt) else INJECT_EVENT (graph_execd_evt) else INJECT_EVENT (graph_stopped_evt) else INJECT_EVENT (graph_paused_evt) else INJECT_EVENT (graph_resumed_evt) else INJECT_EVENT (graph_metadata_evt) else INJECT_EVENT (graph_volume_evt) else INJECT_EVENT (graph_unlded_evt) else
+  else INJECT_EVENT (next_evt) else INJECT_EVENT (prev_evt) else INJECT_EVENT (fwd_evt) else INJECT_EVENT (rwd_evt) else INJECT_EVENT (set_pos_evt) else INJECT_EVENT (vol_up_evt) else INJECT_EVENT (vol_down_evt) else INJECT_EVENT (vol_evt) else INJECT_EVENT (mute_evt) else INJECT_EVENT (pause_evt) else INJECT_EVENT (stop_evt) else INJECT_EVENT (
+      quit_evt) else INJECT_EVENT (graph_eop_evt) else INJECT_EVENT (err_evt) else INJECT_EVENT (graph_loaded_evt) else INJECT_EVENT (graph_execd_evt) else INJECT_EVENT (graph_stopped_evt) else INJECT_EVENT (graph_paused_evt) else INJECT_EVENT (graph_resumed_evt) else INJECT_EVENT (graph_metadata_evt) else INJECT_EVENT (graph_volume_evt) else INJECT_EVENT (graph_seeked_evt) else INJECT_EVENT (graph_unlded_evt) else
   {
     assert (0);
   }
@@ -83,9 +83,24 @@ namespace tiz
     };
     struct fwd_evt
     {
+      fwd_evt (const int secs) : secs_ (secs)
+      {
+      }
+      const int secs_;
     };
     struct rwd_evt
     {
+      rwd_evt (const int secs) : secs_ (secs)
+      {
+      }
+      const int secs_;
+    };
+    struct set_pos_evt
+    {
+      set_pos_evt (const int64_t pos_us) : pos_us_ (pos_us)
+      {
+      }
+      const int64_t pos_us_;
     };
     struct vol_up_evt
     {
@@ -160,6 +175,13 @@ namespace tiz
       }
       const int volume_;
     };
+    struct graph_seeked_evt
+    {
+      graph_seeked_evt (const OMX_TICKS& position) : position_ (position)
+      {
+      }
+      const OMX_TICKS position_;
+    };
     struct graph_unlded_evt
     {
     };
@@ -227,8 +249,9 @@ namespace tiz
         struct loading_graph : public boost::msm::front::state<>
         {
           typedef boost::mpl::vector< next_evt, prev_evt, fwd_evt, rwd_evt,
-                                      vol_up_evt, vol_down_evt, vol_evt,
-                                      mute_evt, pause_evt, stop_evt, quit_evt >
+                                      set_pos_evt, vol_up_evt, vol_down_evt,
+                                      vol_evt, mute_evt, pause_evt, stop_evt,
+                                      quit_evt >
               deferred_events;
           template < class Event, class FSM >
           void on_entry (Event const&, FSM& fsm)
@@ -241,8 +264,9 @@ namespace tiz
           : public boost::msm::front::exit_pseudo_state< graph_execd_evt >
         {
           typedef boost::mpl::vector< next_evt, prev_evt, fwd_evt, rwd_evt,
-                                      vol_up_evt, vol_down_evt, vol_evt,
-                                      mute_evt, pause_evt, stop_evt, quit_evt >
+                                      set_pos_evt, vol_up_evt, vol_down_evt,
+                                      vol_evt, mute_evt, pause_evt, stop_evt,
+                                      quit_evt >
               deferred_events;
           template < class Event, class FSM >
           void on_entry (Event const&, FSM&)
@@ -309,8 +333,9 @@ namespace tiz
           : public boost::msm::front::exit_pseudo_state< graph_unlded_evt >
         {
           typedef boost::mpl::vector< next_evt, prev_evt, fwd_evt, rwd_evt,
-                                      vol_up_evt, vol_down_evt, vol_evt,
-                                      mute_evt, pause_evt, stop_evt, quit_evt >
+                                      set_pos_evt, vol_up_evt, vol_down_evt,
+                                      vol_evt, mute_evt, pause_evt, stop_evt,
+                                      quit_evt >
               deferred_events;
           template < class Event, class FSM >
           void on_entry (Event const&, FSM&)
@@ -478,7 +503,8 @@ namespace tiz
       struct executing_graph : public boost::msm::front::state<>
       {
         typedef boost::mpl::vector< next_evt, prev_evt, fwd_evt, rwd_evt,
-                                    vol_up_evt, vol_down_evt, vol_evt, mute_evt,
+                                    set_pos_evt, vol_up_evt, vol_down_evt,
+                                    vol_evt, mute_evt,
                                     pause_evt, stop_evt, quit_evt >
             deferred_events;
         template < class Event, class FSM >
@@ -541,8 +567,8 @@ namespace tiz
       struct unloading_graph : public boost::msm::front::state<>
       {
         typedef boost::mpl::vector< next_evt, prev_evt, fwd_evt, rwd_evt,
-                                    vol_up_evt, vol_down_evt, vol_evt, mute_evt,
-                                    pause_evt >
+                                    set_pos_evt, vol_up_evt, vol_down_evt,
+                                    vol_evt, mute_evt, pause_evt >
             deferred_events;
         template < class Event, class FSM >
         void on_entry (Event const&, FSM& fsm)
@@ -626,12 +652,12 @@ namespace tiz
       struct do_fwd
       {
         template < class FSM, class EVT, class SourceState, class TargetState >
-        void operator() (EVT const&, FSM& fsm, SourceState&, TargetState&)
+        void operator() (EVT const& evt, FSM& fsm, SourceState&, TargetState&)
         {
           GMGR_FSM_LOG ();
           if (fsm.pp_ops_ && *(fsm.pp_ops_))
           {
-            (*(fsm.pp_ops_))->do_fwd ();
+            (*(fsm.pp_ops_))->do_fwd (evt.secs_);
           }
         }
       };
@@ -639,12 +665,25 @@ namespace tiz
       struct do_rwd
       {
         template < class FSM, class EVT, class SourceState, class TargetState >
-        void operator() (EVT const&, FSM& fsm, SourceState&, TargetState&)
+        void operator() (EVT const& evt, FSM& fsm, SourceState&, TargetState&)
+        {
+          GMGR_FSM_LOG ();
+          if (fsm.pp_ops_ && *(fsm.pp_ops_))
+          {
+            (*(fsm.pp_ops_))->do_rwd (evt.secs_);
+          }
+        }
+      };
+
+      struct do_set_position
+      {
+        template < class FSM, class EVT, class SourceState, class TargetState >
+        void operator() (EVT const& evt, FSM& fsm, SourceState&, TargetState&)
         {
           GMGR_FSM_LOG ();
           if (fsm.pp_ops_ && *(fsm.pp_ops_))
           {
-            (*(fsm.pp_ops_))->do_rwd ();
+            (*(fsm.pp_ops_))->do_set_position (evt.pos_us_);
           }
         }
       };
@@ -793,6 +832,19 @@ namespace tiz
         }
       };
 
+      struct do_update_position
+      {
+        template < class FSM, class EVT, class SourceState, class TargetState >
+        void operator() (EVT const& evt, FSM& fsm, SourceState&, TargetState&)
+        {
+          GMGR_FSM_LOG ();
+          if (fsm.pp_ops_ && *(fsm.pp_ops_))
+          {
+            (*(fsm.pp_ops_))->do_update_position (evt.position_);
+          }
+        }
+      };
+
       struct do_report_fatal_error
       {
         template < class FSM, class EVT, class SourceState, class TargetState >
@@ -869,6 +921,7 @@ namespace tiz
               bmf::Row< running, prev_evt, bmf::none, do_prev >,
               bmf::Row< running, fwd_evt, bmf::none, do_fwd >,
               bmf::Row< running, rwd_evt, bmf::none, do_rwd >,
+              bmf::Row< running, set_pos_evt, bmf::none, do_set_position >,
               bmf::Row< running, vol_up_evt, bmf::none, do_vol_up >,
               bmf::Row< running, vol_down_evt, bmf::none, do_vol_down >,
               bmf::Row< running, vol_evt, bmf::none, do_vol >,
@@ -882,6 +935,8 @@ namespace tiz
                         do_update_metadata >,
               bmf::Row< running, graph_volume_evt, bmf::none,
                         do_update_volume >,
+              bmf::Row< running, graph_seeked_evt, bmf::none,
+                        do_update_position >,
               bmf::Row< running, start_evt, bmf::none, do_pause >,
               bmf::Row< running, stop_evt, stopping, do_stop >,
               bmf::Row< running, quit_evt, quitting, do_unload >,
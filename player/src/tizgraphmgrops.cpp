@@ -252,14 +252,27 @@ void graphmgr::ops::do_prev ()
                           "Unable to skip to prev song.");
 }
 
-void graphmgr::ops::do_fwd ()
+void graphmgr::ops::do_fwd (const int secs)
 {
-  // TODO:
+  GMGR_OPS_BAIL_IF_ERROR (
+      p_managed_graph_,
+      p_managed_graph_->seek (static_cast< OMX_TICKS > (secs) * 1000000, true),
+      "Unable to seek forward.");
 }
 
-void graphmgr::ops::do_rwd ()
+void graphmgr::ops::do_rwd (const int secs)
 {
-  // TODO:
+  GMGR_OPS_BAIL_IF_ERROR (
+      p_managed_graph_,
+      p_managed_graph_->seek (static_cast< OMX_TICKS > (-secs) * 1000000, true),
+      "Unable to seek backwards.");
+}
+
+void graphmgr::ops::do_set_position (const int64_t pos_us)
+{
+  GMGR_OPS_BAIL_IF_ERROR (p_managed_graph_,
+                          p_managed_graph_->seek (pos_us, false),
+                          "Unable to set the playback position.");
 }
 
 void graphmgr::ops::do_vol_up ()
@@ -335,6 +348,14 @@ void graphmgr::ops::do_update_volume (const int volume)
   }
 }
 
+void graphmgr::ops::do_update_position (const OMX_TICKS position)
+{
+  if (p_mgr_)
+  {
+    p_mgr_->do_update_position (position);
+  }
+}
+
 bool graphmgr::ops::is_fatal_error (const OMX_ERRORTYPE error,
                                     const std::string &msg)
 {
@@ -94,8 +94,9 @@ namespace tiz
       virtual void do_deinit ();
       virtual void do_next ();
       virtual void do_prev ();
-      virtual void do_fwd ();
-      virtual void do_rwd ();
+      virtual void do_fwd (const int secs);
+      virtual void do_rwd (const int secs);
+      virtual void do_set_position (const int64_t pos_us);
       virtual void do_vol_up ();
       virtual void do_vol_down ();
       virtual void do_vol (const double vol);
@@ -108,6 +109,7 @@ namespace tiz
           const control::playback_status_t status);
       virtual void do_update_metadata (const track_metadata_map_t &metadata);
       virtual void do_update_volume (const int volume);
+      virtual void do_update_position (const OMX_TICKS position);
       virtual bool is_fatal_error (const OMX_ERRORTYPE error,
                                    const std::string &msg);
 
@@ -76,6 +76,7 @@ graph::ops::ops (graph *p_graph, const omx_comp_name_lst_t &comp_lst,
     expected_port_transitions_lst_ (),
     playlist_ (),
     jump_ (SKIP_DEFAULT_VALUE),
+    seek_pos_ (0),
     destination_state_ (OMX_StateMax),
     metadata_ (),
     volume_ (80),
@@ -218,7 +219,21 @@ void graph::ops::do_flush_tunnel (const int tunnel_id)
 {
   if (last_op_succeeded ())
   {
-    // TODO
+    OMX_U32 out_port_id = 0;
+    OMX_U32 in_port_id = 0;
+    std::string err_msg ("Unable to flush tunnel id [");
+    err_msg.append (boost::lexical_cast< std::string > (tunnel_id));
+    err_msg.append ("]");
+    G_OPS_BAIL_IF_ERROR (
+        util::get_tunnel_ports (handles_, tunnel_id, out_port_id, in_port_id),
+        err_msg);
+    G_OPS_BAIL_IF_ERROR (
+        util::flush_tunnel (handles_, tunnel_id, out_port_id, in_port_id),
+        err_msg);
+    add_expected_port_transition (handles_[tunnel_id], out_port_id,
+                                  OMX_CommandFlush);
+    add_expected_port_transition (handles_[tunnel_id + 1], in_port_id,
+                                  OMX_CommandFlush);
   }
 }
 
@@ -351,6 +366,25 @@ void graph::ops::do_ack_volume ()
   }
 }
 
+/**
+ * Default implementation of the do_ack_seeked () operation. The source may not
+ * land exactly on the requested position (e.g. it can only reposition on
+ * frame boundaries), so the position is read back from it before it is
+ * reported. The requested position is reported if the source can't tell.
+ */
+void graph::ops::do_ack_seeked ()
+{
+  if (last_op_succeeded () && p_graph_)
+  {
+    OMX_TICKS landed = seek_pos_;
+    if (OMX_ErrorNone == util::get_time_position (handles_[0], 0, landed))
+    {
+      seek_pos_ = landed;
+    }
+    p_graph_->graph_seeked (seek_pos_);
+  }
+}
+
 void graph::ops::do_exe2pause ()
 {
   assert (!handles_.empty ());
@@ -442,9 +476,59 @@ void graph::ops::do_idle2loaded_comp (const int comp_id)
   }
 }
 
+/**
+ * Records the target of a seek request. Relative requests are resolved
+ * against the playback clock kept by the progress display (i.e. what the user
+ * is currently hearing), not against the source position, which runs ahead by
+ * the amount of data buffered in the graph.
+ *
+ * @param pos The absolute position or the offset, in microseconds.
+ * @param is_relative Whether @a pos is an offset from the current position.
+ */
+void graph::ops::do_store_seek (const OMX_TICKS pos, const bool is_relative)
+{
+  OMX_TICKS target = pos;
+  if (is_relative && p_graph_)
+  {
+    target += static_cast< OMX_TICKS > (p_graph_->progress_display_position ())
+              * 1000000;
+  }
+  if (target < 0)
+  {
+    target = 0;
+  }
+  // Never seek past the last second of the track, so that the end-of-stream
+  // is always observed by the graph once the seek is complete.
+  if (duration_ > 1
+      && target > static_cast< OMX_TICKS > (duration_ - 1) * 1000000)
+  {
+    target = static_cast< OMX_TICKS > (duration_ - 1) * 1000000;
+  }
+  seek_pos_ = target;
+}
+
+/**
+ * Default implementation of the do_seek () operation. The target position is
+ * handed to the source component (the first element of the graph) via
+ * OMX_IndexConfigTimePosition and then every tunnel is flushed so that no
+ * stale data reaches the renderer. The source only repositions its stream
+ * when its output port is flushed, so nothing read from the new position is
+ * thrown away. The graph goes back to 'executing' once all the flush commands
+ * have completed.
+ */
 void graph::ops::do_seek ()
 {
-  // TODO
+  if (last_op_succeeded ())
+  {
+    G_OPS_BAIL_IF_ERROR (util::apply_time_position (handles_[0], 0, seek_pos_),
+                         "Unable to set OMX_IndexConfigTimePosition");
+    clear_expected_port_transitions ();
+    const int ntunnels = handles_.size () - 1;
+    for (int i = 0; i < ntunnels; ++i)
+    {
+      do_flush_tunnel (i);
+    }
+  }
 }
 
 void graph::ops::do_skip ()
@@ -676,6 +760,15 @@ void graph::ops::do_resume_progress_display ()
   }
 }
 
+void graph::ops::do_seek_progress_display ()
+{
+  if (last_op_succeeded () && p_graph_)
+  {
+    p_graph_->progress_display_seek (
+        static_cast< unsigned long > (seek_pos_ / 1000000));
+  }
+}
+
 void graph::ops::do_stop_progress_display ()
 {
   if (last_op_succeeded () && p_graph_)
@@ -725,6 +818,15 @@ bool graph::ops::is_skip_allowed () const
   return true;
 }
 
+bool graph::ops::is_seek_allowed () const
+{
+  // Seeking is possible only if the source component knows how to reposition
+  // its stream.
+  OMX_TICKS pos = 0;
+  return (!handles_.empty ()
+          && OMX_ErrorNone == util::get_time_position (handles_[0], 0, pos));
+}
+
 OMX_ERRORTYPE
 graph::ops::internal_error () const
 {
@@ -817,6 +919,12 @@ bool graph::ops::is_port_enabling_complete (const OMX_HANDLETYPE handle,
   return is_port_transition_complete (handle, port_id, OMX_CommandPortEnable);
 }
 
+bool graph::ops::is_port_flushing_complete (const OMX_HANDLETYPE handle,
+                                            const OMX_U32 port_id)
+{
+  return is_port_transition_complete (handle, port_id, OMX_CommandFlush);
+}
+
 bool graph::ops::last_op_succeeded () const
 {
 #ifdef _DEBUG
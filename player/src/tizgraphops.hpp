@@ -124,6 +124,7 @@ namespace tiz
       virtual void do_ack_resumed ();
       virtual void do_ack_metadata ();
       virtual void do_ack_volume ();
+      virtual void do_ack_seeked ();
       virtual void do_exe2pause ();
       virtual void do_pause2exe ();
       virtual void do_pause2idle ();
@@ -131,6 +132,7 @@ namespace tiz
       virtual void do_exe2idle_comp (const int comp_id);
       virtual void do_idle2loaded ();
       virtual void do_idle2loaded_comp (const int comp_id);
+      virtual void do_store_seek (const OMX_TICKS pos, const bool is_relative);
       virtual void do_seek ();
       virtual void do_skip ();
       virtual void do_store_skip (const int jump);
@@ -157,6 +159,7 @@ namespace tiz
                                                  const unsigned int a_id);
       virtual void do_pause_progress_display ();
       virtual void do_resume_progress_display ();
+      virtual void do_seek_progress_display ();
       virtual void do_stop_progress_display ();
 
       virtual bool is_port_settings_evt_required () const;
@@ -167,6 +170,7 @@ namespace tiz
                                       const OMX_U32 port_id,
                                       const OMX_INDEXTYPE index_id) const;
       virtual bool is_skip_allowed () const;
+      virtual bool is_seek_allowed () const;
 
       OMX_ERRORTYPE internal_error () const;
       std::string internal_error_msg () const;
@@ -183,6 +187,8 @@ namespace tiz
                                        const OMX_U32 port_id);
       bool is_port_enabling_complete (const OMX_HANDLETYPE handle,
                                       const OMX_U32 port_id);
+      bool is_port_flushing_complete (const OMX_HANDLETYPE handle,
+                                      const OMX_U32 port_id);
       bool last_op_succeeded () const;
       bool is_end_of_play () const;
       bool is_probing_result_ok () const;
@@ -247,6 +253,7 @@ namespace tiz
       omx_event_info_lst_t expected_port_transitions_lst_;
       tizplaylist_ptr_t playlist_;
       int jump_;
+      OMX_TICKS seek_pos_;
       OMX_STATETYPE destination_state_;
       track_metadata_map_t metadata_;
       int volume_;
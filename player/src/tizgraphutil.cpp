@@ -92,6 +92,29 @@ namespace  // Unnamed namespace
     OMX_ERRORTYPE error_;
     bool transition_verified_;
   };
+
+  // Find the first enabled audio port of a component that has the given
+  // direction.
+  OMX_ERRORTYPE find_audio_port (const OMX_HANDLETYPE handle,
+                                 const OMX_DIRTYPE dir, OMX_U32 &port_id)
+  {
+    OMX_PORT_PARAM_TYPE ports;
+    TIZ_INIT_OMX_STRUCT (ports);
+    tiz_check_omx (OMX_GetParameter (handle, OMX_IndexParamAudioInit, &ports));
+    for (OMX_U32 i = 0; i < ports.nPorts; ++i)
+    {
+      OMX_PARAM_PORTDEFINITIONTYPE portdef;
+      TIZ_INIT_OMX_PORT_STRUCT (portdef, ports.nStartPortNumber + i);
+      tiz_check_omx (
+          OMX_GetParameter (handle, OMX_IndexParamPortDefinition, &portdef));
+      if (dir == portdef.eDir && OMX_TRUE == portdef.bEnabled)
+      {
+        port_id = portdef.nPortIndex;
+        return OMX_ErrorNone;
+      }
+    }
+    return OMX_ErrorBadPortIndex;
+  }
 }  // namespace
 
 OMX_ERRORTYPE
@@ -558,6 +581,34 @@ graph::util::apply_playlist_jump (const OMX_HANDLETYPE handle,
   return rc;
 }
 
+OMX_ERRORTYPE
+graph::util::apply_time_position (const OMX_HANDLETYPE handle,
+                                  const OMX_U32 pid, const OMX_TICKS pos)
+{
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  OMX_TIME_CONFIG_TIMESTAMPTYPE timestamp;
+  TIZ_INIT_OMX_PORT_STRUCT (timestamp, pid);
+  tiz_check_omx (
+      OMX_GetConfig (handle, OMX_IndexConfigTimePosition, &timestamp));
+  timestamp.nTimestamp = pos;
+  tiz_check_omx (
+      OMX_SetConfig (handle, OMX_IndexConfigTimePosition, &timestamp));
+  return rc;
+}
+
+OMX_ERRORTYPE
+graph::util::get_time_position (const OMX_HANDLETYPE handle,
+                                const OMX_U32 pid, OMX_TICKS &pos)
+{
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  OMX_TIME_CONFIG_TIMESTAMPTYPE timestamp;
+  TIZ_INIT_OMX_PORT_STRUCT (timestamp, pid);
+  tiz_check_omx (
+      OMX_GetConfig (handle, OMX_IndexConfigTimePosition, &timestamp));
+  pos = timestamp.nTimestamp;
+  return rc;
+}
+
 OMX_ERRORTYPE
 graph::util::apply_playlist_position (const OMX_HANDLETYPE handle,
                                       const OMX_S32 pos)
@@ -645,6 +696,31 @@ graph::util::enable_tunnel (const omx_comp_handle_lst_t &hdl_list,
   return modify_tunnel (hdl_list, tunnel_id, OMX_CommandPortEnable);
 }
 
+OMX_ERRORTYPE
+graph::util::get_tunnel_ports (const omx_comp_handle_lst_t &hdl_list,
+                               const int tunnel_id, OMX_U32 &out_port_id,
+                               OMX_U32 &in_port_id)
+{
+  assert (tunnel_id < static_cast< int > (hdl_list.size ()) - 1);
+  tiz_check_omx (
+      find_audio_port (hdl_list[tunnel_id], OMX_DirOutput, out_port_id));
+  tiz_check_omx (
+      find_audio_port (hdl_list[tunnel_id + 1], OMX_DirInput, in_port_id));
+  return OMX_ErrorNone;
+}
+
+OMX_ERRORTYPE
+graph::util::flush_tunnel (const omx_comp_handle_lst_t &hdl_list,
+                           const int tunnel_id, const OMX_U32 out_port_id,
+                           const OMX_U32 in_port_id)
+{
+  assert (tunnel_id < static_cast< int > (hdl_list.size ()) - 1);
+  tiz_check_omx (OMX_SendCommand (hdl_list[tunnel_id], OMX_CommandFlush,
+                                  out_port_id, NULL));
+  return OMX_SendCommand (hdl_list[tunnel_id + 1], OMX_CommandFlush,
+                          in_port_id, NULL);
+}
+
 OMX_ERRORTYPE
 graph::util::set_content_uri (const OMX_HANDLETYPE handle,
                               const std::string &uri)
@@ -120,6 +120,13 @@ namespace tiz
       static OMX_ERRORTYPE apply_playlist_jump (const OMX_HANDLETYPE handle,
                                                 const OMX_S32 jump);
 
+      static OMX_ERRORTYPE apply_time_position (const OMX_HANDLETYPE handle,
+                                                const OMX_U32 pid,
+                                                const OMX_TICKS pos);
+      static OMX_ERRORTYPE get_time_position (const OMX_HANDLETYPE handle,
+                                              const OMX_U32 pid,
+                                              OMX_TICKS &pos);
+
       static OMX_ERRORTYPE disable_port (const OMX_HANDLETYPE handle,
                                          const OMX_U32 port_id);
       static OMX_ERRORTYPE enable_port (const OMX_HANDLETYPE handle,
@@ -140,6 +147,15 @@ namespace tiz
       static OMX_ERRORTYPE enable_tunnel (const omx_comp_handle_lst_t &hdl_list,
                                           const int tunnel_id);
 
+      static OMX_ERRORTYPE get_tunnel_ports (
+          const omx_comp_handle_lst_t &hdl_list, const int tunnel_id,
+          OMX_U32 &out_port_id, OMX_U32 &in_port_id);
+
+      static OMX_ERRORTYPE flush_tunnel (const omx_comp_handle_lst_t &hdl_list,
+                                         const int tunnel_id,
+                                         const OMX_U32 out_port_id,
+                                         const OMX_U32 in_port_id);
+
       template < typename ParamT >
       static OMX_ERRORTYPE get_channels_and_rate_from_audio_port (
           const OMX_HANDLETYPE handle, const OMX_U32 port_id,
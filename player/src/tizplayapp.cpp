@@ -271,23 +271,19 @@ namespace
             return ETIZPlayUserQuit;
 
           case 68:  // key left
-            // seek
-            // printf ("Seek (left key) - not implemented\n");
+            mgr_ptr->rwd (10);
             break;
 
           case 67:  // key right
-            // seek
-            // printf ("Seek (right key) - not implemented\n");
+            mgr_ptr->fwd (10);
             break;
 
           case 65:  // key up
-            // seek
-            // printf ("Seek (up key) - not implemented\n");
+            mgr_ptr->fwd (60);
             break;
 
           case 66:  // key down
-            // seek
-            // printf ("Seek (down key) - not implemented\n");
+            mgr_ptr->rwd (60);
             break;
 
           case ' ':
@@ -29,6 +29,8 @@
 #ifndef TIZPLAYBACKEVENTS_HPP
 #define TIZPLAYBACKEVENTS_HPP
 
+#include <stdint.h>
+
 #include <map>
 #include <string>
 #include <vector>
@@ -67,6 +69,11 @@ namespace tiz
           volume_event_t;
       typedef volume_event_t::slot_type volume_observer_t;
 
+      // The position (in microseconds) where playback resumed after a seek
+      typedef boost::signals2::signal< void (const int64_t position) >
+          seeked_event_t;
+      typedef seeked_event_t::slot_type seeked_observer_t;
+
     public:
       playback_events ();
 
@@ -75,6 +82,7 @@ namespace tiz
       loop_status_event_t loop_;
       metadata_event_t metadata_;
       volume_event_t volume_;
+      seeked_event_t seeked_;
     };
 
     typedef boost::shared_ptr< playback_events_t > playback_events_ptr_t;
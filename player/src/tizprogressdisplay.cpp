@@ -25,13 +25,14 @@
  *
  */
 
-#include <cstdlib>
-#include <unistd.h>
-#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/lexical_cast.hpp>
-#include <boost/progress.hpp>
 
 #include <tizplatform.h>
 
@@ -44,12 +45,17 @@
 #define C15 "C15"
 #define C16 "C16"
 #define RESET_COLOR "\x1B[0m"
+#define CLEAR_TO_EOL "\x1B[K"
+#define BAR_WIDTH 51
+#define MIN_DRAW_INTERVAL_MS 100
+// Pending output beyond this is discarded; the terminal isn't reading
+#define MAX_PENDING_BYTES 4096
 
 namespace graph = tiz::graph;
 
 graph::ansi_color_sequence::ansi_color_sequence (
     const graph::default_color color)
-  : m_code ()
+  : m_seq ()
 {
 #define CASE_COLOR_(COLOR_ENUM, COLOR)                                \
   case COLOR_ENUM:                                                    \
@@ -84,75 +90,139 @@ graph::ansi_color_sequence::ansi_color_sequence (
     };
   };
 
+  std::string code;
   if (p)
   {
-    m_code.assign (p);
-    boost::replace_all (m_code, ",", ";");
+    code.assign (p);
+    boost::replace_all (code, ",", ";");
   }
   else
   {
-    m_code = boost::lexical_cast< std::string > (color);
+    code = boost::lexical_cast< std::string > (color);
+  }
+  m_seq.assign ("\033[").append (code).append ("m");
+}
+
+namespace
+{
+  uint64_t now_ms ()
+  {
+    struct timespec ts;
+    (void)clock_gettime (CLOCK_MONOTONIC, &ts);
+    return static_cast< uint64_t > (ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+  }
+
+  int open_nonblocking (const int fd)
+  {
+    // Open the terminal again instead of setting O_NONBLOCK on fd: the flag
+    // belongs to the open file description, which is shared with stdio and
+    // with any other process writing to the terminal.
+    if (isatty (fd) != 1)
+    {
+      return -1;
+    }
+    const char *p_name = ttyname (fd);
+    return p_name ? open (p_name, O_WRONLY | O_NONBLOCK | O_NOCTTY | O_CLOEXEC)
+                  : -1;
   }
 }
 
 graph::progress_display::progress_display (unsigned long expected_count,
-                                           std::ostream &os,
-                                           const std::string &s1,
+                                           int fd, const std::string &s1,
                                            const std::string &s2,
                                            const std::string &s3)
   : noncopyable (),
-    m_os (os),
-    m_s1 (s1),
-    m_s2 (s2),
-    m_s3 (s3),
-    m_os_temp (),
+    m_fd (open_nonblocking (fd)),
+    m_enabled (m_fd >= 0),
+    m_pending (),
+    m_scale (),
+    m_bar_head (),
+    m_time_head (),
+    m_line (),
+    m_last_line (),
+    m_last_draw_ms (0),
     m_count (0),
     m_expected_count (0),
-    m_next_tic_count (0),
-    m_tic (0),
-    m_pctg_bar_color (FG_MAGENTA),
-    m_pctg_digits_color (FG_LIGHT_GREY),
-    m_elapsed_time_color (BG_RED),
-    m_progress_bar_color (BG_CYAN)
+    m_finished (false)
 {
+  if (m_enabled)
+  {
+    const ansi_color_sequence pctg_bar_color (FG_MAGENTA);
+    const ansi_color_sequence pctg_digits_color (FG_LIGHT_GREY);
+    const ansi_color_sequence elapsed_time_color (BG_RED);
+    const ansi_color_sequence progress_bar_color (BG_CYAN);
+    const char *pctgs[]
+        = {"0%", "10", "20", "30", "40", "50", "60", "70", "80", "90", "100%"};
+
+    m_scale.append (s1);
+    for (size_t i = 0; i < sizeof (pctgs) / sizeof (pctgs[0]); ++i)
+    {
+      m_scale.append ("   ")
+          .append (pctg_digits_color.str ())
+          .append (pctgs[i])
+          .append (RESET_COLOR);
+    }
+    m_scale.append ("\n")
+        .append (pctg_digits_color.str ())
+        .append (s2)
+        .append (RESET_COLOR)
+        .append (pctg_bar_color.str ())
+        .append ("|----|----|----|----|----|----|----|----|----|----|")
+        .append (RESET_COLOR)
+        .append (" ")
+        .append (pctg_digits_color.str ());
+
+    m_bar_head.assign ("\r").append (s3).append (progress_bar_color.str ());
+    m_time_head.assign (RESET_COLOR)
+        .append (" ")
+        .append (elapsed_time_color.str ());
+
+    m_line.reserve (m_bar_head.size () + BAR_WIDTH + m_time_head.size () + 64);
+    m_last_line.reserve (m_line.capacity ());
+  }
   restart (expected_count);
 }
 
 graph::progress_display::~progress_display ()
 {
-  m_os << std::endl << std::endl;  // endl implies flush, which ensures display
+  if (m_enabled)
+  {
+    (void)write_out ("\n\n");
+    (void)close (m_fd);
+  }
 }
 
 void graph::progress_display::restart (unsigned long expected_count)
 //  Effects: display appropriate scale
 //  Postconditions: count()==0, expected_count()==expected_count
 {
-  m_count = m_next_tic_count = m_tic = 0;
+  m_count = 0;
   m_expected_count = expected_count;
-  m_os_temp.clear ();
-  std::string _total_elapsed_time = calc_len (expected_count);
-  m_os << m_s1 << "   " << m_pctg_digits_color << "0%" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "10" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "20" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "30" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "40" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "50" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "60" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "70" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "80" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "90" << RESET_COLOR << "   "
-       << m_pctg_digits_color << "100%" << RESET_COLOR << "\n"
-       << m_pctg_digits_color << m_s2 << RESET_COLOR << m_pctg_bar_color
-       << "|----|----|----|----|----|----|----|----|----|----|" << RESET_COLOR
-       << " " << m_pctg_digits_color << _total_elapsed_time << RESET_COLOR
-       << std::endl  // endl implies flush, which ensures display
-       << m_s3;
+  m_finished = false;
+  m_last_line.clear ();
+  if (m_enabled)
+  {
+    std::string scale (m_scale);
+    append_len (scale, expected_count);
+    scale.append (RESET_COLOR "\n");
+    (void)write_out (scale);
+  }
   if (!m_expected_count)
   {
     m_expected_count = 1;  // prevent divide by zero
   }                        // restart
 }
 
+void graph::progress_display::seek (unsigned long count)
+{
+  m_count = std::min (count, m_expected_count);
+  m_finished = false;
+  if (m_enabled)
+  {
+    draw (false);
+  }
+}
+
 unsigned long graph::progress_display::count () const
 {
   return m_count;
@@ -163,72 +233,100 @@ unsigned long graph::progress_display::expected_count () const
   return m_expected_count;
 }
 
-std::string graph::progress_display::calc_len (unsigned long count)
+void graph::progress_display::append_len (std::string &str,
+                                          unsigned long count)
 {
-  std::string length_str;
-  int seconds = count % 60;
-  int minutes = (count - seconds) / 60;
-  int hours = 0;
-  if (minutes >= 60)
-  {
-    int total_minutes = minutes;
-    minutes = total_minutes % 60;
-    hours = (total_minutes - minutes) / 60;
-  }
+  char len[32];
+  const unsigned long seconds = count % 60;
+  const unsigned long minutes = (count / 60) % 60;
+  const unsigned long hours = count / 3600;
 
   if (hours > 0)
   {
-    length_str.append (boost::lexical_cast< std::string > (hours));
-    length_str.append ("h:");
+    (void)snprintf (len, sizeof (len), "%luh:%lum:%02lus", hours, minutes,
+                    seconds);
   }
-
-  if (minutes > 0)
+  else if (minutes > 0)
   {
-    length_str.append (boost::lexical_cast< std::string > (minutes));
-    length_str.append ("m:");
+    (void)snprintf (len, sizeof (len), "%lum:%02lus", minutes, seconds);
   }
-
-  char seconds_str[6];
-  sprintf (seconds_str, "%02i", seconds);
-  length_str.append (seconds_str);
-  length_str.append ("s");
-
-  return length_str;
+  else
+  {
+    (void)snprintf (len, sizeof (len), "%02lus", seconds);
+  }
+  str.append (len);
 }
 
-void graph::progress_display::add_tic ()
+void graph::progress_display::draw (const bool force)
 {
+  const uint64_t now = now_ms ();
+  if (m_finished || (!force && now - m_last_draw_ms < MIN_DRAW_INTERVAL_MS))
+  {
+    return;
+  }
+
   // use of floating point ensures that both large and small counts
-  // work correctly.  static_cast<>() is also used several places
-  // to suppress spurious compiler warnings.
-  unsigned int tics_needed = static_cast< unsigned int > (
-      (static_cast< double > (m_count) / m_expected_count) * 50.0);
-  do
+  // work correctly. The last tic is drawn when the track finishes.
+  const size_t tics
+      = force ? BAR_WIDTH
+              : static_cast< size_t > (
+                    (static_cast< double > (m_count) / m_expected_count)
+                    * 50.0);
+
+  m_line.assign (m_bar_head);
+  m_line.append (tics, ' ');
+  m_line.append (m_time_head);
+  append_len (m_line, m_count);
+  m_line.append (RESET_COLOR CLEAR_TO_EOL);
+  if (force)
   {
-    draw_tic ();
-  } while (++m_tic < tics_needed);
-  m_next_tic_count
-      = static_cast< unsigned long > ((m_tic / 50.0) * m_expected_count);
+    // The track is finished; leave the line as it is
+    m_line.append ("\n");
+  }
 
-  if (m_count == m_expected_count)
+  // While the tail of an earlier write is pending, intermediate lines are
+  // skipped; the final one is always queued.
+  if (m_line != m_last_line && (flush_pending () || force))
   {
-    if (m_tic < 51)
-    {
-      draw_tic ();
-    }
-    m_os << std::endl;
+    (void)write_out (m_line);
+    m_last_line.swap (m_line);
+    m_last_draw_ms = now;
+    m_finished = force;
   }
 }
 
-void graph::progress_display::draw_tic ()
+bool graph::progress_display::write_out (const std::string &str)
 {
-  m_os_temp.append (" ");
-  refresh_tic ();
+  // Queue the output behind anything still pending, and write as much as the
+  // terminal takes without blocking the caller (i.e. the graph's thread).
+  if (m_pending.size () + str.size () > MAX_PENDING_BYTES)
+  {
+    // Start afresh on a new line, with the colours reset
+    m_pending.assign (RESET_COLOR "\n");
+  }
+  m_pending.append (str);
+  return flush_pending ();
 }
 
-void graph::progress_display::refresh_tic ()
+bool graph::progress_display::flush_pending ()
 {
-  m_os << "\r" << m_s3 << m_progress_bar_color << m_os_temp << RESET_COLOR
-       << " " << m_elapsed_time_color << calc_len (m_count) << RESET_COLOR
-       << std::flush;
+  while (!m_pending.empty ())
+  {
+    const ssize_t ret = write (m_fd, m_pending.data (), m_pending.size ());
+    if (ret < 0)
+    {
+      if (EINTR == errno)
+      {
+        continue;
+      }
+      // EAGAIN: the terminal is full; anything else: give up on the output
+      if (EAGAIN != errno && EWOULDBLOCK != errno)
+      {
+        m_pending.clear ();
+      }
+      break;
+    }
+    m_pending.erase (0, static_cast< size_t > (ret));
+  }
+  return m_pending.empty ();
 }
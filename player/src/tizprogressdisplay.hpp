@@ -28,8 +28,11 @@
 #ifndef TIZPROGRESSDISPLAY_HPP
 #define TIZPROGRESSDISPLAY_HPP
 
-#include <cmath>
-#include <iostream>
+#include <stdint.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
 
 #include <boost/noncopyable.hpp>
 
@@ -50,21 +53,32 @@ namespace tiz
     public:
       explicit ansi_color_sequence (const default_color color);
 
-      friend std::ostream &operator<< (std::ostream &os,
-                                       const ansi_color_sequence &mod)
+      const std::string &str () const
       {
-        return os << "\033[" << mod.m_code << "m";
+        return m_seq;
       }
 
     private:
-      std::string m_code;
+      std::string m_seq;
     };
 
+    /**
+     *  @class progress_display
+     *  @brief Track progress display (based on boost::progress_display).
+     *
+     *  The output goes to the terminal behind a file descriptor (and nowhere
+     *  if it isn't a terminal), through a non-blocking descriptor of its own.
+     *  Everything that does not change during a track is formatted once. The
+     *  progress line is only written when its text changes, at most 10 times
+     *  a second (unless the track has finished). Whatever the terminal can't
+     *  take straight away is kept and written first on the next redraw; while
+     *  that is pending, intermediate progress lines are skipped.
+     */
     class progress_display : private boost::noncopyable
     {
     public:
       explicit progress_display (unsigned long expected_count,
-                                 std::ostream &os = std::cout,
+                                 int fd = STDOUT_FILENO,
                                  const std::string &s1
                                  = "  \n",  // leading strings
                                  const std::string &s2 = "0s ",
@@ -73,6 +87,10 @@ namespace tiz
 
       void restart (unsigned long expected_count);
 
+      void seek (unsigned long count);
+      //  Effects: Redraw the progress bar at the new count.
+      //  Postconditions: count()== min (count, expected_count())
+
       unsigned long operator+= (unsigned long increment)
       //  Effects: Display appropriate progress tic if needed.
       //  Postconditions: count()== original count() + increment
@@ -80,13 +98,10 @@ namespace tiz
       {
         if (m_count < m_expected_count)
         {
-          if ((m_count += increment) >= m_next_tic_count)
+          m_count = std::min (m_count + increment, m_expected_count);
+          if (m_enabled)
           {
-            add_tic ();
-          }
-          else
-          {
-            refresh_tic ();
+            draw (m_count == m_expected_count);
           }
         }
         return m_count;
@@ -102,30 +117,28 @@ namespace tiz
       unsigned long expected_count () const;
 
     private:
-      std::string calc_len (unsigned long count);
+      static void append_len (std::string &str, unsigned long count);
 
-      void add_tic ();
+      void draw (const bool force);
 
-      void draw_tic ();
+      bool write_out (const std::string &str);
 
-      void refresh_tic ();
+      bool flush_pending ();
 
     private:
-      std::ostream &m_os;      // may not be present in all imps
-      const std::string m_s1;  // string is more general, safer than
-      const std::string m_s2;  //  const char *, and efficiency or size are
-      const std::string m_s3;  //  not issues
-      std::string m_os_temp;
+      const int m_fd;          // non-blocking, or -1 if not a terminal
+      const bool m_enabled;
+      std::string m_pending;   // output the terminal hasn't taken yet
+      std::string m_scale;     // the scale, formatted once
+      std::string m_bar_head;  // everything before the bar
+      std::string m_time_head;  // everything between the bar and the time
+      std::string m_line;
+      std::string m_last_line;  // the last line written out
+      uint64_t m_last_draw_ms;
 
       unsigned long m_count;
       unsigned long m_expected_count;
-      unsigned long m_next_tic_count;
-      unsigned int m_tic;
-
-      ansi_color_sequence m_pctg_bar_color;
-      ansi_color_sequence m_pctg_digits_color;
-      ansi_color_sequence m_elapsed_time_color;
-      ansi_color_sequence m_progress_bar_color;
+      bool m_finished;
     };
   }  // namespace graph
 }  // namespace tiz
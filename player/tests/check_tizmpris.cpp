@@ -0,0 +1,400 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_tizmpris.cpp
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  MPRIS interface manager unit tests
+ *
+ * Each test starts a private session bus (dbus-daemon --session), runs an
+ * MPRIS manager on it, and counts the signals it emits using a second,
+ * plain libdbus connection.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <check.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <set>
+#include <string>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
+
+#include <dbus/dbus.h>
+
+#include <tizplatform.h>
+
+#include "tizplaybackevents.hpp"
+#include "tizmprisif.hpp"
+#include "tizmprismgr.hpp"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.play.control.mpris.check"
+#endif
+
+#define MPRIS_TEST_TIMEOUT 30
+#define MPRIS_NAME_WAIT_MS 5000
+// Several times the manager's flush interval
+#define MPRIS_COLLECT_MS 500
+
+namespace control = tiz::control;
+
+namespace
+{
+  const char *MPRIS_PLAYER_IFACE = "org.mpris.MediaPlayer2.Player";
+  const char *DBUS_PROPS_IFACE = "org.freedesktop.DBus.Properties";
+
+  struct signal_counts
+  {
+    signal_counts () : props_changed_ (0), seeked_ (0), seeked_pos_ (-1)
+    {
+    }
+    int props_changed_;
+    int seeked_;
+    int64_t seeked_pos_;
+    std::set< std::string > changed_props_;
+  };
+
+  OMX_ERRORTYPE noop ()
+  {
+    return OMX_ErrorNone;
+  }
+
+  OMX_ERRORTYPE noop_vol (double)
+  {
+    return OMX_ErrorNone;
+  }
+
+  OMX_ERRORTYPE noop_pos (int64_t)
+  {
+    return OMX_ErrorNone;
+  }
+
+  long now_ms ()
+  {
+    struct timeval tv;
+    gettimeofday (&tv, NULL);
+    return tv.tv_sec * 1000 + tv.tv_usec / 1000;
+  }
+
+  void record_changed_props (DBusMessage *p_msg, signal_counts &counts)
+  {
+    DBusMessageIter args;
+    DBusMessageIter dict;
+    // Interface name, then a{sv} with the changed properties
+    if (dbus_message_iter_init (p_msg, &args)
+        && dbus_message_iter_next (&args)
+        && DBUS_TYPE_ARRAY == dbus_message_iter_get_arg_type (&args))
+    {
+      dbus_message_iter_recurse (&args, &dict);
+      while (DBUS_TYPE_DICT_ENTRY == dbus_message_iter_get_arg_type (&dict))
+      {
+        DBusMessageIter entry;
+        const char *p_key = NULL;
+        dbus_message_iter_recurse (&dict, &entry);
+        dbus_message_iter_get_basic (&entry, &p_key);
+        counts.changed_props_.insert (p_key);
+        dbus_message_iter_next (&dict);
+      }
+    }
+  }
+
+  void collect_signals (DBusConnection *p_conn, const long duration_ms,
+                        signal_counts &counts)
+  {
+    const long deadline = now_ms () + duration_ms;
+    while (now_ms () < deadline)
+    {
+      DBusMessage *p_msg = NULL;
+      dbus_connection_read_write (p_conn, 50);
+      while ((p_msg = dbus_connection_pop_message (p_conn)))
+      {
+        if (dbus_message_is_signal (p_msg, DBUS_PROPS_IFACE,
+                                    "PropertiesChanged"))
+        {
+          counts.props_changed_++;
+          record_changed_props (p_msg, counts);
+        }
+        else if (dbus_message_is_signal (p_msg, MPRIS_PLAYER_IFACE, "Seeked"))
+        {
+          dbus_int64_t pos = -1;
+          counts.seeked_++;
+          fail_if (!dbus_message_get_args (p_msg, NULL, DBUS_TYPE_INT64, &pos,
+                                           DBUS_TYPE_INVALID));
+          counts.seeked_pos_ = pos;
+        }
+        dbus_message_unref (p_msg);
+      }
+    }
+  }
+
+  // The private bus, a connection to it that watches the MPRIS signals, and
+  // the manager under test
+  pid_t g_daemon_pid = -1;
+  DBusConnection *gp_conn = NULL;
+  control::playback_events_t *gp_events = NULL;
+  control::mprismgr *gp_mgr = NULL;
+
+  void start_private_bus ()
+  {
+    int fds[2];
+    char address[512];
+    ssize_t len = 0;
+    ssize_t n = 0;
+
+    fail_if (0 != pipe (fds));
+    g_daemon_pid = fork ();
+    fail_if (g_daemon_pid < 0);
+    if (0 == g_daemon_pid)
+    {
+      std::string print_address ("--print-address=");
+      print_address.append (boost::lexical_cast< std::string > (fds[1]));
+      close (fds[0]);
+      execlp ("dbus-daemon", "dbus-daemon", "--session", "--nofork",
+              print_address.c_str (), (char *)NULL);
+      _exit (EXIT_FAILURE);
+    }
+    close (fds[1]);
+
+    // The daemon prints its address followed by a newline
+    while (len < (ssize_t)sizeof (address) - 1
+           && (n = read (fds[0], address + len, sizeof (address) - 1 - len))
+                  > 0)
+    {
+      len += n;
+      if (memchr (address, '\n', len))
+      {
+        break;
+      }
+    }
+    close (fds[0]);
+    fail_if (len <= 0, "Unable to start dbus-daemon");
+    address[len] = '\0';
+    address[strcspn (address, "\n")] = '\0';
+    TIZ_LOG (TIZ_PRIORITY_TRACE, "Private bus : [%s]", address);
+
+    // The manager connects to the session bus
+    fail_if (0 != setenv ("DBUS_SESSION_BUS_ADDRESS", address, 1));
+
+    DBusError error;
+    dbus_error_init (&error);
+    gp_conn = dbus_connection_open_private (address, &error);
+    fail_if (NULL == gp_conn);
+    fail_if (!dbus_bus_register (gp_conn, &error));
+    std::string match ("type='signal',path='");
+    match.append (control::mprisif::TIZONIA_MPRIS_OBJECT_PATH).append ("'");
+    dbus_bus_add_match (gp_conn, match.c_str (), &error);
+    fail_if (dbus_error_is_set (&error));
+    dbus_connection_flush (gp_conn);
+  }
+
+  void stop_private_bus ()
+  {
+    if (gp_conn)
+    {
+      dbus_connection_close (gp_conn);
+      dbus_connection_unref (gp_conn);
+      gp_conn = NULL;
+    }
+    if (g_daemon_pid > 0)
+    {
+      kill (g_daemon_pid, SIGTERM);
+      waitpid (g_daemon_pid, NULL, 0);
+      g_daemon_pid = -1;
+    }
+  }
+
+  void wait_for_mpris_name ()
+  {
+    std::string name ("org.mpris.MediaPlayer2.tizonia.pid-");
+    name.append (boost::lexical_cast< std::string > (getpid ()));
+    const long deadline = now_ms () + MPRIS_NAME_WAIT_MS;
+    bool owned = false;
+    while (!owned && now_ms () < deadline)
+    {
+      owned = dbus_bus_name_has_owner (gp_conn, name.c_str (), NULL);
+      if (!owned)
+      {
+        boost::this_thread::sleep_for (boost::chrono::milliseconds (50));
+      }
+    }
+    fail_if (!owned, "The MPRIS bus name was never acquired");
+    // The name is requested right before the properties pipe is installed;
+    // give the manager a moment to enter its dispatcher.
+    boost::this_thread::sleep_for (boost::chrono::milliseconds (100));
+  }
+}  // namespace
+
+static void setup (void)
+{
+  start_private_bus ();
+
+  control::mpris_mediaplayer2_props_t props (
+      false, false, false, "tizonia", std::vector< std::string > (),
+      std::vector< std::string > ());
+  control::mpris_mediaplayer2_player_props_t player_props (
+      "Stopped", "Playlist", 1.0, false, track_metadata_map_t (), .80, 0, 1.0,
+      1.0, true, true, true, true, true, true);
+  control::mpris_callbacks_t cbacks (noop, noop, noop, noop, noop, noop, noop,
+                                     noop_vol, noop_pos, noop_pos);
+
+  gp_events = new control::playback_events_t ();
+  gp_mgr = new control::mprismgr (props, player_props, cbacks, *gp_events);
+  fail_if (OMX_ErrorNone != gp_mgr->init ());
+  fail_if (OMX_ErrorNone != gp_mgr->start ());
+  wait_for_mpris_name ();
+}
+
+static void teardown (void)
+{
+  if (gp_mgr)
+  {
+    fail_if (OMX_ErrorNone != gp_mgr->stop ());
+    // Same as the graph manager: let the dispatcher leave its loop before
+    // it is destroyed
+    boost::this_thread::sleep_for (boost::chrono::milliseconds (1000));
+    gp_mgr->deinit ();
+    delete gp_mgr;
+    gp_mgr = NULL;
+  }
+  delete gp_events;
+  gp_events = NULL;
+  stop_private_bus ();
+}
+
+START_TEST (test_mpris_props_coalesced)
+{
+  signal_counts burst;
+  signal_counts single;
+  signal_counts idle;
+  int i = 0;
+
+  // A burst of changes, much shorter than the flush interval...
+  for (i = 0; i < 100; ++i)
+  {
+    gp_events->volume_ ((double)(i % 100) / 100);
+    gp_events->playback_ (i % 2 ? control::Playing : control::Paused);
+  }
+  collect_signals (gp_conn, MPRIS_COLLECT_MS, burst);
+
+  // ... is announced with one signal (two, if it straddled a flush)
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "PropertiesChanged after the burst : [%d]",
+           burst.props_changed_);
+  fail_if (burst.props_changed_ < 1 || burst.props_changed_ > 2);
+  fail_if (burst.changed_props_.count ("Volume") != 1);
+  fail_if (burst.changed_props_.count ("PlaybackStatus") != 1);
+  fail_if (burst.changed_props_.count ("Position") != 0);
+  fail_if (burst.seeked_ != 0);
+
+  // Nothing more is signalled while nothing changes
+  collect_signals (gp_conn, MPRIS_COLLECT_MS, idle);
+  fail_if (idle.props_changed_ != 0);
+
+  // The flush timeout has gone to sleep, but it wakes up again
+  gp_events->volume_ (0.5);
+  collect_signals (gp_conn, MPRIS_COLLECT_MS, single);
+  fail_if (single.props_changed_ != 1);
+  fail_if (single.changed_props_.size () != 1);
+  fail_if (single.changed_props_.count ("Volume") != 1);
+}
+END_TEST
+
+START_TEST (test_mpris_seeked)
+{
+  const dbus_int64_t requested = 10000000;
+  const dbus_int64_t landed = 9976163;
+  const char *p_track = "/org/tizonia/track/0";
+  signal_counts before;
+  signal_counts after;
+  DBusMessage *p_call = NULL;
+  DBusMessage *p_reply = NULL;
+
+  std::string name ("org.mpris.MediaPlayer2.tizonia.pid-");
+  name.append (boost::lexical_cast< std::string > (getpid ()));
+
+  // SetPosition only requests the seek; nothing has moved yet
+  p_call = dbus_message_new_method_call (
+      name.c_str (), control::mprisif::TIZONIA_MPRIS_OBJECT_PATH,
+      MPRIS_PLAYER_IFACE, "SetPosition");
+  fail_if (NULL == p_call);
+  fail_if (!dbus_message_append_args (p_call, DBUS_TYPE_OBJECT_PATH, &p_track,
+                                      DBUS_TYPE_INT64, &requested,
+                                      DBUS_TYPE_INVALID));
+  p_reply = dbus_connection_send_with_reply_and_block (gp_conn, p_call, 5000,
+                                                       NULL);
+  fail_if (NULL == p_reply);
+  dbus_message_unref (p_reply);
+  dbus_message_unref (p_call);
+  collect_signals (gp_conn, MPRIS_COLLECT_MS, before);
+  fail_if (before.seeked_ != 0);
+
+  // The graph reports where the stream has actually landed
+  gp_events->seeked_ (landed);
+  collect_signals (gp_conn, MPRIS_COLLECT_MS, after);
+  fail_if (after.seeked_ != 1);
+  fail_if (after.seeked_pos_ != landed);
+  // Position is never part of PropertiesChanged
+  fail_if (after.props_changed_ != 0);
+}
+END_TEST
+
+static Suite *mpris_suite (void)
+{
+  TCase *tc_mpris;
+  Suite *s = suite_create ("MPRIS interface manager");
+
+  tc_mpris = tcase_create ("signals");
+  tcase_set_timeout (tc_mpris, MPRIS_TEST_TIMEOUT);
+  tcase_add_checked_fixture (tc_mpris, setup, teardown);
+  tcase_add_test (tc_mpris, test_mpris_props_coalesced);
+  tcase_add_test (tc_mpris, test_mpris_seeked);
+  suite_add_tcase (s, tc_mpris);
+
+  return s;
+}
+
+int main (void)
+{
+  int number_failed = 1;
+  SRunner *sr = NULL;
+
+  tiz_log_init ();
+
+  sr = srunner_create (mpris_suite ());
+  srunner_set_log (sr, "-");
+  srunner_run_all (sr, CK_VERBOSE);
+  number_failed = srunner_ntests_failed (sr);
+  srunner_free (sr);
+
+  tiz_log_deinit ();
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -38,7 +38,10 @@ extern "C"
 #include <OMX_Core.h>
 #include <OMX_Types.h>
 
-#define MAX_CHANNELS 6
+#define MAX_CHANNELS 8
+/* Samples per channel in the largest frame libfaad can output (1024, doubled
+   when SBR is upsampled) */
+#define AACDEC_MAX_FRAME_LEN 2048
 
 #define ARATELIA_AAC_DECODER_DEFAULT_ROLE "audio_decoder.aac"
 #define ARATELIA_AAC_DECODER_COMPONENT_NAME "OMX.Aratelia.audio_decoder.aac"
@@ -48,7 +51,10 @@ extern "C"
 #define ARATELIA_AAC_DECODER_PORT_MIN_BUF_COUNT 2
 #define ARATELIA_AAC_DECODER_PORT_MIN_INPUT_BUF_SIZE \
   FAAD_MIN_STREAMSIZE * MAX_CHANNELS * 10
-#define ARATELIA_AAC_DECODER_PORT_MIN_OUTPUT_BUF_SIZE 8192
+/* Large enough for libfaad to decode a 16-bit frame with any channel count
+   straight into the output buffer */
+#define ARATELIA_AAC_DECODER_PORT_MIN_OUTPUT_BUF_SIZE \
+  AACDEC_MAX_FRAME_LEN * MAX_CHANNELS * 2
 #define ARATELIA_AAC_DECODER_PORT_NONCONTIGUOUS OMX_FALSE
 #define ARATELIA_AAC_DECODER_PORT_ALIGNMENT 0
 #define ARATELIA_AAC_DECODER_PORT_SUPPLIERPREF OMX_BufferSupplyInput
@@ -32,6 +32,7 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <tizplatform.h>
@@ -47,6 +48,9 @@
 #define TIZ_LOG_CATEGORY_NAME "tiz.aac_decoder.prc"
 #endif
 
+/* libfaad's error code when the output buffer can't hold the decoded frame */
+#define AACDEC_FAAD_ERROR_OUTPUT_TOO_SMALL 27
+
 /* Forward declarations */
 static OMX_ERRORTYPE
 aacdec_prc_deallocate_resources (void *);
@@ -64,7 +68,12 @@ allocate_temp_data_store (aacdec_prc_t * ap_prc)
                           OMX_IndexParamPortDefinition, &port_def));
 
   assert (ap_prc->p_store_ == NULL);
-  return tiz_buffer_init (&(ap_prc->p_store_), port_def.nBufferSize);
+  tiz_check_omx (tiz_buffer_init (&(ap_prc->p_store_), port_def.nBufferSize));
+
+  /* Decoded PCM that did not fit in the current output buffer */
+  assert (ap_prc->p_pcm_store_ == NULL);
+  return tiz_buffer_init (&(ap_prc->p_pcm_store_),
+                          ARATELIA_AAC_DECODER_PORT_MIN_OUTPUT_BUF_SIZE);
 }
 
 static inline void
@@ -76,6 +85,8 @@ deallocate_temp_data_store (
   assert (ap_prc);
   tiz_buffer_destroy (ap_prc->p_store_);
   ap_prc->p_store_ = NULL;
+  tiz_buffer_destroy (ap_prc->p_pcm_store_);
+  ap_prc->p_pcm_store_ = NULL;
 }
 
 static void
@@ -112,6 +123,35 @@ retrieve_aac_settings (const void * ap_prc,
   return OMX_ErrorNone;
 }
 
+/* The libfaad output format that matches the output port's sample size. 32-bit
+   pcm is float, as with the other decoders and the renderers. */
+static unsigned char
+faad_output_format (const aacdec_prc_t * ap_prc)
+{
+  assert (ap_prc);
+  switch (ap_prc->pcmmode_.nBitPerSample)
+    {
+      case 24:
+        return FAAD_FMT_24BIT;
+      case 32:
+        return FAAD_FMT_FLOAT;
+      default:
+        return FAAD_FMT_16BIT;
+    };
+}
+
+/* The size of the largest frame, as laid out by libfaad; all formats other
+   than 16-bit use 32-bit containers. The channel count of the last frame
+   can't be used here: it may change with the next one (e.g. a new program in
+   an ADTS stream, or parametric stereo turning mono into stereo). */
+static inline OMX_U32
+max_frame_size (const aacdec_prc_t * ap_prc)
+{
+  assert (ap_prc);
+  return AACDEC_MAX_FRAME_LEN * MAX_CHANNELS
+         * (16 == ap_prc->pcmmode_.nBitPerSample ? 2 : 4);
+}
+
 static OMX_ERRORTYPE
 set_decoder_config (aacdec_prc_t * ap_prc)
 {
@@ -125,6 +165,21 @@ set_decoder_config (aacdec_prc_t * ap_prc)
   /* Retrieve the aac settings from the input port */
   tiz_check_omx (retrieve_aac_settings (ap_prc, &aactype));
 
+  if (FAAD_FMT_16BIT == faad_output_format (ap_prc)
+      && 16 != ap_prc->pcmmode_.nBitPerSample)
+    {
+      /* libfaad can't produce this sample size */
+      TIZ_DEBUG (handleOf (ap_prc), "Unsupported bits per sample [%d]",
+                 ap_prc->pcmmode_.nBitPerSample);
+      ap_prc->pcmmode_.nBitPerSample = 16;
+      tiz_check_omx (tiz_krn_SetParameter_internal (
+        tiz_get_krn (handleOf (ap_prc)), handleOf (ap_prc),
+        OMX_IndexParamAudioPcm, &(ap_prc->pcmmode_)));
+      tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventPortSettingsChanged,
+                           ARATELIA_AAC_DECODER_OUTPUT_PORT_INDEX,
+                           OMX_IndexParamAudioPcm, NULL);
+    }
+
   /* Set the default object type and samplerate */
   /* This is useful for RAW AAC files */
   p_config = NeAACDecGetCurrentConfiguration (ap_prc->p_aac_dec_);
@@ -132,9 +187,10 @@ set_decoder_config (aacdec_prc_t * ap_prc)
     {
       p_config->defSampleRate = aactype.nSampleRate;
       p_config->defObjectType = aactype.eAACProfile;
-      p_config->outputFormat
-        = FAAD_FMT_16BIT;             /* we making this fixed for now */
-      p_config->downMatrix = 1;       /* Down matrix 5.1 to 2 channels */
+      p_config->outputFormat = faad_output_format (ap_prc);
+      /* Down matrix 5.1 to 2 channels, unless the output port has been set
+         up for more */
+      p_config->downMatrix = (ap_prc->pcmmode_.nChannels <= 2);
       p_config->useOldADTSFormat = 0; /* we making this fixed for now */
       /* config->dontUpSampleImplicitSBR = 1; */
 
@@ -157,13 +213,102 @@ set_decoder_config (aacdec_prc_t * ap_prc)
   return rc;
 }
 
+static OMX_AUDIO_CHANNELTYPE
+faad_to_omx_channel (const unsigned char a_position)
+{
+  switch (a_position)
+    {
+      case FRONT_CHANNEL_CENTER:
+        return OMX_AUDIO_ChannelCF;
+      case FRONT_CHANNEL_LEFT:
+        return OMX_AUDIO_ChannelLF;
+      case FRONT_CHANNEL_RIGHT:
+        return OMX_AUDIO_ChannelRF;
+      case SIDE_CHANNEL_LEFT:
+        return OMX_AUDIO_ChannelLS;
+      case SIDE_CHANNEL_RIGHT:
+        return OMX_AUDIO_ChannelRS;
+      case BACK_CHANNEL_LEFT:
+        return OMX_AUDIO_ChannelLR;
+      case BACK_CHANNEL_RIGHT:
+        return OMX_AUDIO_ChannelRR;
+      case BACK_CHANNEL_CENTER:
+        return OMX_AUDIO_ChannelCS;
+      case LFE_CHANNEL:
+        return OMX_AUDIO_ChannelLFE;
+      default:
+        return OMX_AUDIO_ChannelNone;
+    };
+}
+
+static void
+channel_mapping (const OMX_U32 a_channels, const unsigned char * ap_positions,
+                 OMX_AUDIO_CHANNELTYPE * ap_mapping)
+{
+  /* The AAC channel configurations, in decoder output order; used until the
+     first frame tells the actual positions */
+  static const OMX_AUDIO_CHANNELTYPE mono[] = {OMX_AUDIO_ChannelCF};
+  static const OMX_AUDIO_CHANNELTYPE stereo[]
+    = {OMX_AUDIO_ChannelLF, OMX_AUDIO_ChannelRF};
+  static const OMX_AUDIO_CHANNELTYPE surround51[]
+    = {OMX_AUDIO_ChannelCF, OMX_AUDIO_ChannelLF, OMX_AUDIO_ChannelRF,
+       OMX_AUDIO_ChannelLR, OMX_AUDIO_ChannelRR, OMX_AUDIO_ChannelLFE};
+  static const OMX_AUDIO_CHANNELTYPE surround71[]
+    = {OMX_AUDIO_ChannelCF, OMX_AUDIO_ChannelLF,  OMX_AUDIO_ChannelRF,
+       OMX_AUDIO_ChannelLS, OMX_AUDIO_ChannelRS,  OMX_AUDIO_ChannelLR,
+       OMX_AUDIO_ChannelRR, OMX_AUDIO_ChannelLFE};
+  const OMX_AUDIO_CHANNELTYPE * p_layout = NULL;
+  OMX_U32 i = 0;
+
+  assert (ap_mapping);
+
+  switch (a_channels)
+    {
+      case 1:
+        p_layout = mono;
+        break;
+      case 2:
+        p_layout = stereo;
+        break;
+      case 6:
+        p_layout = surround51;
+        break;
+      case 8:
+        p_layout = surround71;
+        break;
+      default:
+        break;
+    };
+
+  for (i = 0; i < OMX_AUDIO_MAXCHANNELS; ++i)
+    {
+      if (i >= a_channels)
+        {
+          ap_mapping[i] = OMX_AUDIO_ChannelNone;
+        }
+      else if (ap_positions)
+        {
+          ap_mapping[i] = faad_to_omx_channel (ap_positions[i]);
+        }
+      else
+        {
+          ap_mapping[i] = p_layout ? p_layout[i] : OMX_AUDIO_ChannelNone;
+        }
+    }
+}
+
 static OMX_ERRORTYPE
 update_pcm_mode (aacdec_prc_t * ap_prc, const OMX_U32 a_samplerate,
-                 const OMX_U32 a_channels)
+                 const OMX_U32 a_channels, const unsigned char * ap_positions)
 {
+  OMX_AUDIO_CHANNELTYPE mapping[OMX_AUDIO_MAXCHANNELS];
+
   assert (ap_prc);
+
+  channel_mapping (a_channels, ap_positions, mapping);
   if (a_samplerate != ap_prc->pcmmode_.nSamplingRate
-      || a_channels != ap_prc->pcmmode_.nChannels)
+      || a_channels != ap_prc->pcmmode_.nChannels
+      || memcmp (mapping, ap_prc->pcmmode_.eChannelMapping, sizeof (mapping)))
     {
       TIZ_DEBUG (handleOf (ap_prc),
                  "Updating pcm mode : old samplerate [%d] new samplerate [%d]",
@@ -173,6 +318,7 @@ update_pcm_mode (aacdec_prc_t * ap_prc, const OMX_U32 a_samplerate,
                  ap_prc->pcmmode_.nChannels, a_channels);
       ap_prc->pcmmode_.nSamplingRate = a_samplerate;
       ap_prc->pcmmode_.nChannels = a_channels;
+      memcpy (ap_prc->pcmmode_.eChannelMapping, mapping, sizeof (mapping));
       tiz_check_omx (tiz_krn_SetParameter_internal (
         tiz_get_krn (handleOf (ap_prc)), handleOf (ap_prc),
         OMX_IndexParamAudioPcm, &(ap_prc->pcmmode_)));
@@ -387,8 +533,8 @@ init_aac_decoder (aacdec_prc_t * ap_prc)
   else
     {
       /* Make sure the the output port parameters are up to date */
-      tiz_check_omx (
-        update_pcm_mode (ap_prc, ap_prc->samplerate_, ap_prc->channels_));
+      tiz_check_omx (update_pcm_mode (ap_prc, ap_prc->samplerate_,
+                                      ap_prc->channels_, NULL));
       /* We will skip this many bytes the next time we read from this buffer */
       tiz_buffer_advance (ap_prc->p_store_, nbytes);
       TIZ_DEBUG (handleOf (ap_prc), "samplerate [%d] channels [%d]",
@@ -399,6 +545,166 @@ init_aac_decoder (aacdec_prc_t * ap_prc)
   return rc;
 }
 
+static inline OMX_U32
+output_room (const OMX_BUFFERHEADERTYPE * ap_hdr)
+{
+  assert (ap_hdr);
+  return ap_hdr->nAllocLen - ap_hdr->nOffset - ap_hdr->nFilledLen;
+}
+
+/* libfaad produces 24-bit samples in 32-bit containers; pack them, in place,
+   into three little-endian bytes */
+static size_t
+pack_s24 (OMX_U8 * ap_data, const unsigned long a_nsamples)
+{
+  OMX_U8 * p_to = ap_data;
+  unsigned long i = 0;
+  for (i = 0; i < a_nsamples; ++i)
+    {
+      int32_t sample = 0;
+      memcpy (&sample, ap_data + i * sizeof (int32_t), sizeof (int32_t));
+      p_to[0] = (OMX_U8) (sample & 0xFF);
+      p_to[1] = (OMX_U8) ((sample >> 8) & 0xFF);
+      p_to[2] = (OMX_U8) ((sample >> 16) & 0xFF);
+      p_to += 3;
+    }
+  return p_to - ap_data;
+}
+
+static void
+flush_pcm_store (aacdec_prc_t * ap_prc, OMX_BUFFERHEADERTYPE * ap_out)
+{
+  const OMX_U32 nbytes
+    = MIN (output_room (ap_out), tiz_buffer_available (ap_prc->p_pcm_store_));
+  if (nbytes > 0)
+    {
+      memcpy (ap_out->pBuffer + ap_out->nOffset + ap_out->nFilledLen,
+              tiz_buffer_get (ap_prc->p_pcm_store_), nbytes);
+      ap_out->nFilledLen += nbytes;
+      (void) tiz_buffer_advance (ap_prc->p_pcm_store_, nbytes);
+    }
+}
+
+static OMX_ERRORTYPE
+decode_frame (aacdec_prc_t * ap_prc, OMX_BUFFERHEADERTYPE * ap_out,
+              const bool a_eos)
+{
+  OMX_U8 * p_dst = ap_out->pBuffer + ap_out->nOffset + ap_out->nFilledLen;
+  OMX_U8 * p_samples = NULL;
+  size_t nbytes = 0;
+
+  assert (ap_prc);
+  assert (ap_out);
+
+  /* Decode the AAC data passed in the buffer. Info about the decoded frame is
+     filled in the NeAACDecFrameInfo structure. This structure holds
+     information about errors during decoding, number of sample, number of
+     channels and samplerate. The samples are channel interleaved. When the
+     largest possible frame fits, they are written straight into the output
+     buffer; otherwise they are copied from libfaad's own buffer. */
+  if (0 == tiz_buffer_available (ap_prc->p_pcm_store_)
+      && output_room (ap_out) >= max_frame_size (ap_prc))
+    {
+      p_samples = NeAACDecDecode2 (
+        ap_prc->p_aac_dec_, &(ap_prc->aac_info_),
+        tiz_buffer_get (ap_prc->p_store_),
+        tiz_buffer_available (ap_prc->p_store_), (void **) &p_dst,
+        output_room (ap_out));
+    }
+  else
+    {
+      p_samples
+        = NeAACDecDecode (ap_prc->p_aac_dec_, &(ap_prc->aac_info_),
+                          tiz_buffer_get (ap_prc->p_store_),
+                          tiz_buffer_available (ap_prc->p_store_));
+    }
+
+  if (ap_prc->first_buffer_read_ && !ap_prc->second_buffer_read_)
+    {
+      store_stream_metadata (ap_prc);
+      ap_prc->second_buffer_read_ = true;
+    }
+
+  TIZ_TRACE (handleOf (ap_prc),
+             "bytes_available = [%d] bytesconsumed = [%d] "
+             "samples = [%d] error [%d]",
+             tiz_buffer_available (ap_prc->p_store_),
+             ap_prc->aac_info_.bytesconsumed, ap_prc->aac_info_.samples,
+             ap_prc->aac_info_.error);
+
+  tiz_buffer_advance (ap_prc->p_store_, ap_prc->aac_info_.bytesconsumed);
+
+  if (a_eos
+      && (ap_prc->aac_info_.error != 0 || 0 == ap_prc->aac_info_.bytesconsumed))
+    {
+      /* A truncated frame at the end of the stream */
+      TIZ_DEBUG (handleOf (ap_prc), "Discarding [%d] bytes at EOS (%s)",
+                 tiz_buffer_available (ap_prc->p_store_),
+                 NeAACDecGetErrorMessage (ap_prc->aac_info_.error));
+      tiz_buffer_clear (ap_prc->p_store_);
+      return OMX_ErrorNone;
+    }
+
+  if (AACDEC_FAAD_ERROR_OUTPUT_TOO_SMALL == ap_prc->aac_info_.error)
+    {
+      /* A frame with more channels than the decoder is configured for; libfaad
+         has consumed it, so it is lost, but the stream can carry on */
+      TIZ_WARN (handleOf (ap_prc), "Dropping a frame (%s)",
+                NeAACDecGetErrorMessage (ap_prc->aac_info_.error));
+      return OMX_ErrorNone;
+    }
+
+  if (ap_prc->aac_info_.error != 0)
+    {
+      /* Some error occurred while decoding this frame */
+      TIZ_ERROR (handleOf (ap_prc),
+                 "[OMX_ErrorStreamCorruptFatal] : "
+                 "While decoding the input stream (%s).",
+                 NeAACDecGetErrorMessage (ap_prc->aac_info_.error));
+      return OMX_ErrorStreamCorruptFatal;
+    }
+
+  if (0 == ap_prc->aac_info_.samples || !p_samples)
+    {
+      return OMX_ErrorNone;
+    }
+
+  /* Channels and positions are only known for certain once a frame has been
+     decoded */
+  ap_prc->channels_ = ap_prc->aac_info_.channels;
+  tiz_check_omx (update_pcm_mode (ap_prc, ap_prc->aac_info_.samplerate,
+                                  ap_prc->aac_info_.channels,
+                                  ap_prc->aac_info_.channel_position));
+
+  if (24 == ap_prc->pcmmode_.nBitPerSample)
+    {
+      nbytes = pack_s24 (p_samples, ap_prc->aac_info_.samples);
+    }
+  else
+    {
+      nbytes = ap_prc->aac_info_.samples
+               * (16 == ap_prc->pcmmode_.nBitPerSample ? 2 : 4);
+    }
+
+  if (p_samples == p_dst)
+    {
+      ap_out->nFilledLen += nbytes;
+    }
+  else
+    {
+      if (tiz_buffer_push (ap_prc->p_pcm_store_, p_samples, nbytes) < nbytes)
+        {
+          TIZ_ERROR (handleOf (ap_prc),
+                     "[OMX_ErrorInsufficientResources] : "
+                     "Unable to store all the decoded data.");
+          return OMX_ErrorInsufficientResources;
+        }
+      flush_pcm_store (ap_prc, ap_out);
+    }
+
+  return OMX_ErrorNone;
+}
+
 static OMX_ERRORTYPE
 transform_buffer (aacdec_prc_t * ap_prc)
 {
@@ -407,6 +713,7 @@ transform_buffer (aacdec_prc_t * ap_prc)
     = tiz_filter_prc_get_header (ap_prc, ARATELIA_AAC_DECODER_INPUT_PORT_INDEX);
   OMX_BUFFERHEADERTYPE * p_out = tiz_filter_prc_get_header (
     ap_prc, ARATELIA_AAC_DECODER_OUTPUT_PORT_INDEX);
+  bool eos = false;
 
   if (NULL == p_in || NULL == p_out)
     {
@@ -418,11 +725,14 @@ transform_buffer (aacdec_prc_t * ap_prc)
   assert (ap_prc);
   assert (ap_prc->p_aac_dec_);
 
-  if (0 == p_in->nFilledLen && tiz_buffer_available (ap_prc->p_store_) == 0)
+  eos = (p_in->nFlags & OMX_BUFFERFLAG_EOS) > 0;
+
+  if (0 == p_in->nFilledLen && tiz_buffer_available (ap_prc->p_store_) == 0
+      && tiz_buffer_available (ap_prc->p_pcm_store_) == 0)
     {
       TIZ_TRACE (handleOf (ap_prc), "HEADER [%p] nFlags [%d] is empty", p_in,
                  p_in->nFlags);
-      if ((p_in->nFlags & OMX_BUFFERFLAG_EOS) > 0)
+      if (eos)
         {
           /* Inmediately propagate EOS flag to output */
           TIZ_TRACE (handleOf (ap_prc),
@@ -449,63 +759,39 @@ transform_buffer (aacdec_prc_t * ap_prc)
       p_in->nFilledLen = 0;
     }
 
-  if (tiz_buffer_available (ap_prc->p_store_) > 0)
-    {
-      /* Decode the AAC data passed in the buffer. Returns a pointer to a
-           sample buffer or NULL. Info about the decoded frame is filled in the
-           NeAACDecFrameInfo structure. This structure holds information about
-           errors during decoding, number of sample, number of channels and
-           samplerate. The returned buffer contains the channel interleaved
-           samples of the frame. */
-      short * p_sample_buf
-        = NeAACDecDecode (ap_prc->p_aac_dec_, &(ap_prc->aac_info_),
-                          tiz_buffer_get (ap_prc->p_store_),
-                          tiz_buffer_available (ap_prc->p_store_));
+  /* Previously decoded data goes first */
+  flush_pcm_store (ap_prc, p_out);
 
-      if (ap_prc->first_buffer_read_ && !ap_prc->second_buffer_read_)
-        {
-          store_stream_metadata (ap_prc);
-          ap_prc->second_buffer_read_ = true;
-        }
-
-      TIZ_TRACE (handleOf (ap_prc),
-                 "bytes_available = [%d] bytesconsumed = [%d] "
-                 "samples = [%d] error [%d]",
-                 tiz_buffer_available (ap_prc->p_store_),
-                 ap_prc->aac_info_.bytesconsumed, ap_prc->aac_info_.samples,
-                 ap_prc->aac_info_.error);
-
-      tiz_buffer_advance (ap_prc->p_store_, ap_prc->aac_info_.bytesconsumed);
-
-      if ((ap_prc->aac_info_.error == 0) && (ap_prc->aac_info_.samples > 0))
-        {
-          int i = 0;
-          char * p_data = (char *) (p_out->pBuffer + p_out->nOffset);
-          for (i = 0; i < ap_prc->aac_info_.samples; ++i)
-            {
-              p_data[i * 2] = (char) (p_sample_buf[i] & 0xFF);
-              p_data[i * 2 + 1] = (char) ((p_sample_buf[i] >> 8) & 0xFF);
-            }
-          p_out->nFilledLen = ap_prc->aac_info_.samples * ap_prc->channels_ * 1;
-        }
-      else if (ap_prc->aac_info_.error != 0)
+  if (tiz_buffer_available (ap_prc->p_pcm_store_) == 0
+      && tiz_buffer_available (ap_prc->p_store_) > 0)
+    {
+      rc = decode_frame (ap_prc, p_out, eos);
+
+      /* Keep filling the output buffer while there are whole frames to
+         decode */
+      while (OMX_ErrorNone == rc
+             && tiz_buffer_available (ap_prc->p_store_)
+                  >= FAAD_MIN_STREAMSIZE * ap_prc->channels_
+             && tiz_buffer_available (ap_prc->p_pcm_store_) == 0
+             && output_room (p_out) >= max_frame_size (ap_prc)
+             && ap_prc->aac_info_.bytesconsumed > 0)
         {
-          /* Some error occurred while decoding this frame */
-          TIZ_ERROR (handleOf (ap_prc),
-                     "[OMX_ErrorStreamCorruptFatal] : "
-                     "While decoding the input stream (%s).",
-                     NeAACDecGetErrorMessage (ap_prc->aac_info_.error));
-          rc = OMX_ErrorStreamCorruptFatal;
+          rc = decode_frame (ap_prc, p_out, eos);
         }
     }
 
+  /* More input is needed; at EOS, all the input is decoded and all the pcm
+     data delivered before the input buffer goes back */
   if (OMX_ErrorNone == rc && 0 == p_in->nFilledLen
       && tiz_buffer_available (ap_prc->p_store_)
-           < FAAD_MIN_STREAMSIZE * ap_prc->channels_)
+           < FAAD_MIN_STREAMSIZE * ap_prc->channels_
+      && (!eos
+          || (tiz_buffer_available (ap_prc->p_store_) == 0
+              && tiz_buffer_available (ap_prc->p_pcm_store_) == 0)))
     {
       TIZ_TRACE (handleOf (ap_prc), "HEADER [%p] nFlags [%d] is empty", p_in,
                  p_in->nFlags);
-      if ((p_in->nFlags & OMX_BUFFERFLAG_EOS) > 0)
+      if (eos)
         {
           /* Let's propagate EOS flag to output */
           TIZ_TRACE (handleOf (ap_prc), "Let's propagate EOS flag to output");
@@ -548,6 +834,10 @@ reset_stream_parameters (aacdec_prc_t * ap_prc)
   ap_prc->nbytes_read_ = 0;
   ap_prc->first_buffer_read_ = false;
   ap_prc->second_buffer_read_ = false;
+  if (ap_prc->p_pcm_store_)
+    {
+      tiz_buffer_clear (ap_prc->p_pcm_store_);
+    }
   tiz_filter_prc_update_eos_flag (ap_prc, false);
 }
 
@@ -564,8 +854,9 @@ aacdec_prc_ctor (void * ap_obj, va_list * app)
   TIZ_DEBUG (handleOf (ap_obj), "libfaad2 caps: %X", cap);
   /*   Open the faad library */
   p_prc->p_aac_dec_ = NeAACDecOpen ();
-  reset_stream_parameters (p_prc);
   p_prc->p_store_ = NULL;
+  p_prc->p_pcm_store_ = NULL;
+  reset_stream_parameters (p_prc);
   return p_prc;
 }
 
@@ -57,6 +57,7 @@ extern "C"
     bool first_buffer_read_;
     bool second_buffer_read_;
     tiz_buffer_t * p_store_;
+    tiz_buffer_t * p_pcm_store_;
   };
 
   typedef struct aacdec_prc_class aacdec_prc_class_t;
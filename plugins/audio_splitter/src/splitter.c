@@ -0,0 +1,228 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   splitter.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - PCM audio splitter component
+ *
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#include <OMX_Core.h>
+#include <OMX_Component.h>
+#include <OMX_Types.h>
+
+#include <tizplatform.h>
+
+#include <tizport.h>
+#include <tizscheduler.h>
+
+#include "splitterprc.h"
+#include "splitter.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.audio_splitter"
+#endif
+
+/**
+ *@defgroup libtizaudiosplitter 'libtizaudiosplitter' : OpenMAX IL PCM audio
+ *splitter
+ *
+ * - Component name : "OMX.Aratelia.audio_splitter.pcm"
+ * - Implements role: "audio_splitter.pcm"
+ *
+ * Feeds the same PCM stream to several output ports (e.g. one per encoder
+ * branch). The number of output ports is read from tizonia.conf.
+ *
+ *@ingroup plugins
+ */
+
+static OMX_VERSIONTYPE audio_splitter_version = {{1, 0, 0, 0}};
+
+OMX_U32
+splitter_output_count (void)
+{
+  const long outputs = TIZ_RCFILE_GET_INT (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION, "OMX.Aratelia.audio_splitter.pcm.outputs",
+    ARATELIA_AUDIO_SPLITTER_DEFAULT_OUTPUTS);
+  return (OMX_U32) MAX (1, MIN (outputs, ARATELIA_AUDIO_SPLITTER_MAX_OUTPUTS));
+}
+
+static OMX_U8 *
+splitter_buffer_alloc_hook (OMX_U32 * ap_size, OMX_PTR * app_port_priv,
+                            void * ap_args)
+{
+  OMX_U8 * p = NULL;
+  assert (ap_size && *ap_size > 0);
+  assert (app_port_priv);
+  p = tiz_mem_calloc ((size_t) *ap_size, sizeof (OMX_U8));
+  /* The processor may point the header's pBuffer into an input buffer; the
+     original address is kept here, so that it can always be restored and
+     freed. */
+  *app_port_priv = p;
+  return p;
+}
+
+static void
+splitter_buffer_free_hook (OMX_PTR ap_buf, OMX_PTR ap_port_priv,
+                           void * ap_args)
+{
+  tiz_mem_free (ap_port_priv ? ap_port_priv : ap_buf);
+}
+
+static OMX_PTR
+instantiate_pcm_port (OMX_HANDLETYPE ap_hdl, const OMX_U32 a_pid)
+{
+  const bool is_input = (ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX == a_pid);
+  OMX_AUDIO_PARAM_PCMMODETYPE pcmmode;
+  OMX_AUDIO_CONFIG_VOLUMETYPE volume;
+  OMX_AUDIO_CONFIG_MUTETYPE mute;
+  OMX_AUDIO_CODINGTYPE encodings[] = {OMX_AUDIO_CodingPCM, OMX_AUDIO_CodingMax};
+  tiz_port_options_t pcm_port_opts = {
+    OMX_PortDomainAudio,
+    is_input ? OMX_DirInput : OMX_DirOutput,
+    ARATELIA_AUDIO_SPLITTER_PORT_MIN_BUF_COUNT,
+    ARATELIA_AUDIO_SPLITTER_PORT_MIN_BUF_SIZE,
+    ARATELIA_AUDIO_SPLITTER_PORT_NONCONTIGUOUS,
+    ARATELIA_AUDIO_SPLITTER_PORT_ALIGNMENT,
+    ARATELIA_AUDIO_SPLITTER_PORT_SUPPLIERPREF,
+    {a_pid, is_input ? NULL : splitter_buffer_alloc_hook,
+     is_input ? NULL : splitter_buffer_free_hook, NULL},
+    /* The outputs are slaves of the input port; the processor copies the
+       input's pcm settings on to them */
+    is_input ? (OMX_U32) -1 : ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX};
+
+  pcmmode.nSize = sizeof (OMX_AUDIO_PARAM_PCMMODETYPE);
+  pcmmode.nVersion.nVersion = OMX_VERSION;
+  pcmmode.nPortIndex = a_pid;
+  pcmmode.nChannels = 2;
+  pcmmode.eNumData = OMX_NumericalDataSigned;
+  pcmmode.eEndian = OMX_EndianLittle;
+  pcmmode.bInterleaved = OMX_TRUE;
+  pcmmode.nBitPerSample = 16;
+  pcmmode.nSamplingRate = 48000;
+  pcmmode.ePCMMode = OMX_AUDIO_PCMModeLinear;
+  pcmmode.eChannelMapping[0] = OMX_AUDIO_ChannelLF;
+  pcmmode.eChannelMapping[1] = OMX_AUDIO_ChannelRF;
+
+  volume.nSize = sizeof (OMX_AUDIO_CONFIG_VOLUMETYPE);
+  volume.nVersion.nVersion = OMX_VERSION;
+  volume.nPortIndex = a_pid;
+  volume.bLinear = OMX_FALSE;
+  volume.sVolume.nValue = 50;
+  volume.sVolume.nMin = 0;
+  volume.sVolume.nMax = 100;
+
+  mute.nSize = sizeof (OMX_AUDIO_CONFIG_MUTETYPE);
+  mute.nVersion.nVersion = OMX_VERSION;
+  mute.nPortIndex = a_pid;
+  mute.bMute = OMX_FALSE;
+
+  return factory_new (tiz_get_type (ap_hdl, "tizpcmport"), &pcm_port_opts,
+                      &encodings, &pcmmode, &volume, &mute);
+}
+
+/* The role factory's port constructors don't receive the port index */
+#define SPLITTER_PORT_CTOR(pid)                                        \
+  static OMX_PTR instantiate_pcm_port_##pid (OMX_HANDLETYPE ap_hdl)    \
+  {                                                                    \
+    return instantiate_pcm_port (ap_hdl, pid);                         \
+  }
+
+SPLITTER_PORT_CTOR (0)
+SPLITTER_PORT_CTOR (1)
+SPLITTER_PORT_CTOR (2)
+SPLITTER_PORT_CTOR (3)
+SPLITTER_PORT_CTOR (4)
+SPLITTER_PORT_CTOR (5)
+SPLITTER_PORT_CTOR (6)
+SPLITTER_PORT_CTOR (7)
+SPLITTER_PORT_CTOR (8)
+
+static const tiz_role_port_init_f pcm_port_ctors[]
+  = {instantiate_pcm_port_0, instantiate_pcm_port_1, instantiate_pcm_port_2,
+     instantiate_pcm_port_3, instantiate_pcm_port_4, instantiate_pcm_port_5,
+     instantiate_pcm_port_6, instantiate_pcm_port_7, instantiate_pcm_port_8};
+
+static OMX_PTR
+instantiate_config_port (OMX_HANDLETYPE ap_hdl)
+{
+  return factory_new (tiz_get_type (ap_hdl, "tizconfigport"),
+                      NULL, /* this port does not take options */
+                      ARATELIA_AUDIO_SPLITTER_COMPONENT_NAME,
+                      audio_splitter_version);
+}
+
+static OMX_PTR
+instantiate_processor (OMX_HANDLETYPE ap_hdl)
+{
+  return factory_new (tiz_get_type (ap_hdl, "splitterprc"));
+}
+
+OMX_ERRORTYPE
+OMX_ComponentInit (OMX_HANDLETYPE ap_hdl)
+{
+  tiz_role_factory_t role_factory;
+  const tiz_role_factory_t * rf_list[] = {&role_factory};
+  tiz_type_factory_t splitterprc_type;
+  const tiz_type_factory_t * tf_list[] = {&splitterprc_type};
+  OMX_U32 i = 0;
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE,
+           "OMX_ComponentInit: "
+           "Inititializing [%s]",
+           ARATELIA_AUDIO_SPLITTER_COMPONENT_NAME);
+
+  strcpy ((OMX_STRING) role_factory.role,
+          ARATELIA_AUDIO_SPLITTER_DEFAULT_ROLE);
+  role_factory.pf_cport = instantiate_config_port;
+  role_factory.nports = 1 + splitter_output_count ();
+  for (i = 0; i < role_factory.nports; ++i)
+    {
+      role_factory.pf_port[i] = pcm_port_ctors[i];
+    }
+  role_factory.pf_proc = instantiate_processor;
+
+  strcpy ((OMX_STRING) splitterprc_type.class_name, "splitterprc_class");
+  splitterprc_type.pf_class_init = splitter_prc_class_init;
+  strcpy ((OMX_STRING) splitterprc_type.object_name, "splitterprc");
+  splitterprc_type.pf_object_init = splitter_prc_init;
+
+  /* Initialize the component infrastructure */
+  tiz_check_omx (
+    tiz_comp_init (ap_hdl, ARATELIA_AUDIO_SPLITTER_COMPONENT_NAME));
+
+  /* Register the "splitterprc" class */
+  tiz_check_omx (tiz_comp_register_types (ap_hdl, tf_list, 1));
+
+  /* Register the component role */
+  tiz_check_omx (tiz_comp_register_roles (ap_hdl, rf_list, 1));
+
+  return OMX_ErrorNone;
+}
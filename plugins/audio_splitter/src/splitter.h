@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   splitter.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - PCM audio splitter constants
+ *
+ *
+ */
+#ifndef SPLITTER_H
+#define SPLITTER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <OMX_Core.h>
+#include <OMX_Types.h>
+
+#define ARATELIA_AUDIO_SPLITTER_DEFAULT_ROLE "audio_splitter.pcm"
+#define ARATELIA_AUDIO_SPLITTER_COMPONENT_NAME "OMX.Aratelia.audio_splitter.pcm"
+/* With libtizonia, port indexes must start at index 0 */
+#define ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX 0
+#define ARATELIA_AUDIO_SPLITTER_FIRST_OUTPUT_PORT_INDEX 1
+#define ARATELIA_AUDIO_SPLITTER_DEFAULT_OUTPUTS 2
+#define ARATELIA_AUDIO_SPLITTER_MAX_OUTPUTS 8
+#define ARATELIA_AUDIO_SPLITTER_PORT_MIN_BUF_COUNT 4
+/* 50 ms of 16-bit stereo audio at 48KHz */
+#define ARATELIA_AUDIO_SPLITTER_PORT_MIN_BUF_SIZE (2 * 4800)
+#define ARATELIA_AUDIO_SPLITTER_PORT_NONCONTIGUOUS OMX_FALSE
+#define ARATELIA_AUDIO_SPLITTER_PORT_ALIGNMENT 0
+#define ARATELIA_AUDIO_SPLITTER_PORT_SUPPLIERPREF OMX_BufferSupplyInput
+
+  OMX_U32
+  splitter_output_count (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPLITTER_H */
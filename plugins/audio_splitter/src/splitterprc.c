@@ -0,0 +1,788 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   splitterprc.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - PCM audio splitter processor class
+ *
+ * Input buffers are held in a fifo of 'chunks' until every enabled output
+ * port (a 'branch') has been given their data. A branch either gets a copy of
+ * the data, or (with zero_copy_buffers) an output buffer that points straight
+ * into the input buffer; the chunk is then reference-counted, and the input
+ * buffer is returned only once all the output buffers that point into it are
+ * back.
+ *
+ * A branch that can't keep up stalls the input, unless its backpressure
+ * policy is 'drop': when the fifo is full and the oldest chunk is only waiting
+ * for 'drop' branches, those branches skip it.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#include <tizplatform.h>
+
+#include <tizkernel.h>
+
+#include "splitter.h"
+#include "splitterprc.h"
+#include "splitterprc_decls.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.audio_splitter.prc"
+#endif
+
+static inline splitter_chunk_t *
+chunk_at (splitter_prc_t * ap_prc, const OMX_U32 a_seq)
+{
+  return &(ap_prc->chunks_[a_seq % SPLITTER_MAX_CHUNKS]);
+}
+
+static inline bool
+is_eos (const OMX_BUFFERHEADERTYPE * ap_hdr)
+{
+  return (ap_hdr->nFlags & OMX_BUFFERFLAG_EOS) != 0;
+}
+
+static void
+unlend (splitter_prc_t * ap_prc, splitter_branch_t * ap_branch,
+        const OMX_U32 a_idx)
+{
+  splitter_chunk_t * p_chunk = NULL;
+  assert (a_idx < ap_branch->nlent);
+  p_chunk = chunk_at (ap_prc, ap_branch->lent[a_idx].seq);
+  assert (p_chunk->refs > 0);
+  --(p_chunk->refs);
+  ap_branch->lent[a_idx] = ap_branch->lent[--(ap_branch->nlent)];
+}
+
+static void
+unlend_all (splitter_prc_t * ap_prc, splitter_branch_t * ap_branch)
+{
+  while (ap_branch->nlent > 0)
+    {
+      unlend (ap_prc, ap_branch, 0);
+    }
+}
+
+static bool
+claim_from_port (splitter_prc_t * ap_prc, splitter_branch_t * ap_branch,
+                 OMX_BUFFERHEADERTYPE ** app_hdr)
+{
+  OMX_BUFFERHEADERTYPE * p_hdr = NULL;
+  OMX_U32 i = 0;
+
+  if (OMX_ErrorNone
+        != tiz_krn_claim_buffer (tiz_get_krn (handleOf (ap_prc)),
+                                 ap_branch->pid, 0, &p_hdr)
+      || !p_hdr)
+    {
+      return false;
+    }
+
+  /* A buffer that pointed into a chunk is back */
+  for (i = 0; i < ap_branch->nlent; ++i)
+    {
+      if (ap_branch->lent[i].p_hdr == p_hdr)
+        {
+          unlend (ap_prc, ap_branch, i);
+          break;
+        }
+    }
+  if (p_hdr->pOutputPortPrivate)
+    {
+      p_hdr->pBuffer = p_hdr->pOutputPortPrivate;
+    }
+
+  p_hdr->nFilledLen = 0;
+  p_hdr->nOffset = 0;
+  p_hdr->nFlags = 0;
+  *app_hdr = p_hdr;
+  return true;
+}
+
+static bool
+claim_output (splitter_prc_t * ap_prc, splitter_branch_t * ap_branch)
+{
+  assert (!ap_branch->p_hdr);
+
+  if (ap_branch->nidle > 0)
+    {
+      ap_branch->p_hdr = ap_branch->idle[--(ap_branch->nidle)];
+      return true;
+    }
+  return claim_from_port (ap_prc, ap_branch, &(ap_branch->p_hdr));
+}
+
+static void
+reclaim_lent (splitter_prc_t * ap_prc, splitter_branch_t * ap_branch,
+              bool * ap_progress)
+{
+  /* A lent buffer only lets go of its chunk when it is claimed back. Do that
+     even if there is no input waiting, or the input port may end up with all
+     its buffers lent out and nothing would ever move again. */
+  while (ap_branch->nlent > 0 && ap_branch->nidle < SPLITTER_MAX_LENT)
+    {
+      OMX_BUFFERHEADERTYPE * p_hdr = NULL;
+      if (!claim_from_port (ap_prc, ap_branch, &p_hdr))
+        {
+          break;
+        }
+      ap_branch->idle[ap_branch->nidle++] = p_hdr;
+      *ap_progress = true;
+    }
+}
+
+static OMX_ERRORTYPE
+release_output (splitter_prc_t * ap_prc, splitter_branch_t * ap_branch)
+{
+  OMX_BUFFERHEADERTYPE * p_hdr = ap_branch->p_hdr;
+  assert (p_hdr);
+  ap_branch->p_hdr = NULL;
+  return tiz_krn_release_buffer (tiz_get_krn (handleOf (ap_prc)),
+                                 ap_branch->pid, p_hdr);
+}
+
+static bool
+can_lend (const splitter_prc_t * ap_prc, const splitter_branch_t * ap_branch,
+          const OMX_BUFFERHEADERTYPE * ap_in)
+{
+  const OMX_BUFFERHEADERTYPE * p_out = ap_branch->p_hdr;
+  /* Only the buffers allocated by the output port can be re-pointed. 'drop'
+     branches always get copies, so that they never hold the input back. */
+  return ap_prc->zero_copy_ && !ap_branch->drop && p_out->pOutputPortPrivate
+         && 0 == ap_branch->offset && 0 == p_out->nFilledLen
+         && ap_in->nFilledLen <= p_out->nAllocLen
+         && ap_branch->nlent < SPLITTER_MAX_LENT;
+}
+
+static OMX_ERRORTYPE
+serve_branch (splitter_prc_t * ap_prc, splitter_branch_t * ap_branch,
+              bool * ap_progress)
+{
+  assert (ap_prc);
+  assert (ap_branch);
+
+  while (ap_branch->seq != ap_prc->tail_)
+    {
+      splitter_chunk_t * p_chunk = chunk_at (ap_prc, ap_branch->seq);
+      OMX_BUFFERHEADERTYPE * p_in = p_chunk->p_hdr;
+      OMX_BUFFERHEADERTYPE * p_out = NULL;
+
+      if (0 == p_in->nFilledLen && !is_eos (p_in))
+        {
+          ++(ap_branch->seq);
+          *ap_progress = true;
+          continue;
+        }
+
+      if (!ap_branch->p_hdr && !claim_output (ap_prc, ap_branch))
+        {
+          break;
+        }
+
+      p_out = ap_branch->p_hdr;
+      if (0 == p_out->nFilledLen)
+        {
+          p_out->nTimeStamp = p_in->nTimeStamp;
+        }
+
+      if (can_lend (ap_prc, ap_branch, p_in))
+        {
+          p_out->pBuffer = p_in->pBuffer + p_in->nOffset;
+          p_out->nFilledLen = p_in->nFilledLen;
+          ap_branch->lent[ap_branch->nlent].p_hdr = p_out;
+          ap_branch->lent[ap_branch->nlent].seq = ap_branch->seq;
+          ++(ap_branch->nlent);
+          ++(p_chunk->refs);
+          ap_branch->offset = p_in->nFilledLen;
+        }
+      else
+        {
+          const OMX_U32 len
+            = MIN (p_in->nFilledLen - ap_branch->offset,
+                   p_out->nAllocLen - p_out->nFilledLen);
+          memcpy (p_out->pBuffer + p_out->nFilledLen,
+                  p_in->pBuffer + p_in->nOffset + ap_branch->offset, len);
+          p_out->nFilledLen += len;
+          ap_branch->offset += len;
+        }
+      *ap_progress = true;
+
+      if (ap_branch->offset == p_in->nFilledLen)
+        {
+          /* Done with this chunk */
+          if (is_eos (p_in))
+            {
+              TIZ_TRACE (handleOf (ap_prc), "EOS on port [%u]",
+                         ap_branch->pid);
+              p_out->nFlags |= OMX_BUFFERFLAG_EOS;
+            }
+          ++(ap_branch->seq);
+          ap_branch->offset = 0;
+          tiz_check_omx (release_output (ap_prc, ap_branch));
+        }
+      else if (p_out->nFilledLen == p_out->nAllocLen)
+        {
+          tiz_check_omx (release_output (ap_prc, ap_branch));
+        }
+    }
+
+  return OMX_ErrorNone;
+}
+
+static bool
+chunk_pending (const splitter_prc_t * ap_prc, const OMX_U32 a_seq,
+               const bool a_drop_only)
+{
+  OMX_U32 i = 0;
+  for (i = 0; i < ap_prc->noutputs_; ++i)
+    {
+      const splitter_branch_t * p_branch = &(ap_prc->branches_[i]);
+      if (p_branch->enabled && p_branch->seq == a_seq
+          && (!a_drop_only || !p_branch->drop))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+static OMX_ERRORTYPE
+release_chunks (splitter_prc_t * ap_prc, bool * ap_progress)
+{
+  assert (ap_prc);
+
+  while (ap_prc->head_ != ap_prc->tail_)
+    {
+      splitter_chunk_t * p_chunk = chunk_at (ap_prc, ap_prc->head_);
+      OMX_BUFFERHEADERTYPE * p_hdr = p_chunk->p_hdr;
+
+      if (p_chunk->refs > 0 || chunk_pending (ap_prc, ap_prc->head_, false))
+        {
+          break;
+        }
+
+      p_chunk->p_hdr = NULL;
+      ++(ap_prc->head_);
+      *ap_progress = true;
+      p_hdr->nFilledLen = 0;
+      p_hdr->nOffset = 0;
+      tiz_check_omx (tiz_krn_release_buffer (
+        tiz_get_krn (handleOf (ap_prc)),
+        ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX, p_hdr));
+    }
+
+  return OMX_ErrorNone;
+}
+
+static bool
+drop_lagging (splitter_prc_t * ap_prc)
+{
+  splitter_chunk_t * p_chunk = NULL;
+  bool dropped = false;
+  OMX_U32 i = 0;
+
+  assert (ap_prc);
+
+  if (ap_prc->tail_ - ap_prc->head_ < ap_prc->max_chunks_)
+    {
+      return false;
+    }
+
+  /* The eos is never dropped */
+  p_chunk = chunk_at (ap_prc, ap_prc->head_);
+  if (p_chunk->refs > 0 || is_eos (p_chunk->p_hdr)
+      || chunk_pending (ap_prc, ap_prc->head_, true))
+    {
+      return false;
+    }
+
+  for (i = 0; i < ap_prc->noutputs_; ++i)
+    {
+      splitter_branch_t * p_branch = &(ap_prc->branches_[i]);
+      if (p_branch->enabled && p_branch->seq == ap_prc->head_)
+        {
+          ++(p_branch->seq);
+          p_branch->offset = 0;
+          ++(p_branch->dropped);
+          dropped = true;
+          TIZ_DEBUG (handleOf (ap_prc),
+                     "port [%u] is lagging; dropped [%u] buffers so far",
+                     p_branch->pid, p_branch->dropped);
+        }
+    }
+
+  return dropped;
+}
+
+static OMX_ERRORTYPE
+release_branch (splitter_prc_t * ap_prc, splitter_branch_t * ap_branch)
+{
+  /* Buffers that point into a chunk are returned (or freed) by the port; they
+     no longer hold the chunk */
+  unlend_all (ap_prc, ap_branch);
+  if (ap_branch->p_hdr)
+    {
+      tiz_check_omx (release_output (ap_prc, ap_branch));
+    }
+  while (ap_branch->nidle > 0)
+    {
+      tiz_check_omx (tiz_krn_release_buffer (
+        tiz_get_krn (handleOf (ap_prc)), ap_branch->pid,
+        ap_branch->idle[--(ap_branch->nidle)]));
+    }
+  ap_branch->seq = ap_prc->tail_;
+  ap_branch->offset = 0;
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+release_all (splitter_prc_t * ap_prc)
+{
+  OMX_U32 i = 0;
+  assert (ap_prc);
+
+  for (i = 0; i < ap_prc->noutputs_; ++i)
+    {
+      tiz_check_omx (release_branch (ap_prc, &(ap_prc->branches_[i])));
+    }
+
+  while (ap_prc->head_ != ap_prc->tail_)
+    {
+      splitter_chunk_t * p_chunk = chunk_at (ap_prc, ap_prc->head_++);
+      assert (0 == p_chunk->refs);
+      p_chunk->p_hdr->nFilledLen = 0;
+      p_chunk->p_hdr->nOffset = 0;
+      tiz_check_omx (tiz_krn_release_buffer (
+        tiz_get_krn (handleOf (ap_prc)),
+        ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX, p_chunk->p_hdr));
+      p_chunk->p_hdr = NULL;
+    }
+
+  return OMX_ErrorNone;
+}
+
+static splitter_branch_t *
+find_branch (splitter_prc_t * ap_prc, const OMX_U32 a_pid)
+{
+  if (a_pid >= ARATELIA_AUDIO_SPLITTER_FIRST_OUTPUT_PORT_INDEX
+      && a_pid < ARATELIA_AUDIO_SPLITTER_FIRST_OUTPUT_PORT_INDEX
+                   + ap_prc->noutputs_)
+    {
+      return &(ap_prc->branches_[a_pid
+                                 - ARATELIA_AUDIO_SPLITTER_FIRST_OUTPUT_PORT_INDEX]);
+    }
+  return NULL;
+}
+
+static OMX_ERRORTYPE
+propagate_pcm_settings (splitter_prc_t * ap_prc)
+{
+  OMX_AUDIO_PARAM_PCMMODETYPE in;
+  OMX_U32 i = 0;
+
+  assert (ap_prc);
+
+  TIZ_INIT_OMX_PORT_STRUCT (in, ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX);
+  tiz_check_omx (tiz_api_GetParameter (tiz_get_krn (handleOf (ap_prc)),
+                                       handleOf (ap_prc),
+                                       OMX_IndexParamAudioPcm, &in));
+
+  for (i = 0; i < ap_prc->noutputs_; ++i)
+    {
+      const OMX_U32 pid = ap_prc->branches_[i].pid;
+      OMX_AUDIO_PARAM_PCMMODETYPE out;
+      TIZ_INIT_OMX_PORT_STRUCT (out, pid);
+      tiz_check_omx (tiz_api_GetParameter (tiz_get_krn (handleOf (ap_prc)),
+                                           handleOf (ap_prc),
+                                           OMX_IndexParamAudioPcm, &out));
+      if (out.nChannels != in.nChannels
+          || out.nSamplingRate != in.nSamplingRate
+          || out.nBitPerSample != in.nBitPerSample
+          || out.eNumData != in.eNumData || out.eEndian != in.eEndian
+          || out.bInterleaved != in.bInterleaved
+          || memcmp (out.eChannelMapping, in.eChannelMapping,
+                     sizeof (in.eChannelMapping)))
+        {
+          out = in;
+          out.nPortIndex = pid;
+          tiz_check_omx (tiz_krn_SetParameter_internal (
+            tiz_get_krn (handleOf (ap_prc)), handleOf (ap_prc),
+            OMX_IndexParamAudioPcm, &out));
+          tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventPortSettingsChanged,
+                               pid, OMX_IndexParamAudioPcm, NULL);
+        }
+    }
+
+  return OMX_ErrorNone;
+}
+
+static bool
+is_port_enabled (splitter_prc_t * ap_prc, const OMX_U32 a_pid)
+{
+  OMX_PARAM_PORTDEFINITIONTYPE port_def;
+  TIZ_INIT_OMX_PORT_STRUCT (port_def, a_pid);
+  return (OMX_ErrorNone
+            == tiz_api_GetParameter (tiz_get_krn (handleOf (ap_prc)),
+                                     handleOf (ap_prc),
+                                     OMX_IndexParamPortDefinition, &port_def)
+          && OMX_TRUE == port_def.bEnabled);
+}
+
+static OMX_U32
+input_buffer_count (splitter_prc_t * ap_prc)
+{
+  OMX_PARAM_PORTDEFINITIONTYPE port_def;
+  TIZ_INIT_OMX_PORT_STRUCT (port_def, ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX);
+  if (OMX_ErrorNone
+      != tiz_api_GetParameter (tiz_get_krn (handleOf (ap_prc)),
+                               handleOf (ap_prc), OMX_IndexParamPortDefinition,
+                               &port_def))
+    {
+      return ARATELIA_AUDIO_SPLITTER_PORT_MIN_BUF_COUNT;
+    }
+  return port_def.nBufferCountActual;
+}
+
+static bool
+read_drop_policy (const OMX_U32 a_pid)
+{
+  char key[OMX_MAX_STRINGNAME_SIZE];
+  const char * p_policy = NULL;
+
+  snprintf (key, sizeof (key),
+            "OMX.Aratelia.audio_splitter.pcm.backpressure.port%u",
+            (unsigned int) a_pid);
+  p_policy = tiz_rcfile_get_value (TIZ_RCFILE_PLUGINS_DATA_SECTION, key);
+  return (p_policy && 0 == strcasecmp (p_policy, "drop"));
+}
+
+/*
+ * splitterprc
+ */
+
+static void *
+splitter_prc_ctor (void * ap_obj, va_list * app)
+{
+  splitter_prc_t * p_prc
+    = super_ctor (typeOf (ap_obj, "splitterprc"), ap_obj, app);
+  OMX_U32 i = 0;
+  assert (p_prc);
+  p_prc->noutputs_ = splitter_output_count ();
+  memset (p_prc->branches_, 0, sizeof (p_prc->branches_));
+  for (i = 0; i < p_prc->noutputs_; ++i)
+    {
+      p_prc->branches_[i].pid
+        = ARATELIA_AUDIO_SPLITTER_FIRST_OUTPUT_PORT_INDEX + i;
+    }
+  memset (p_prc->chunks_, 0, sizeof (p_prc->chunks_));
+  p_prc->head_ = 0;
+  p_prc->tail_ = 0;
+  p_prc->max_chunks_ = ARATELIA_AUDIO_SPLITTER_PORT_MIN_BUF_COUNT;
+  p_prc->in_enabled_ = true;
+  p_prc->zero_copy_ = false;
+  return p_prc;
+}
+
+static void *
+splitter_prc_dtor (void * ap_obj)
+{
+  return super_dtor (typeOf (ap_obj, "splitterprc"), ap_obj);
+}
+
+/*
+ * from tiz_srv class
+ */
+
+static OMX_ERRORTYPE
+splitter_prc_allocate_resources (void * ap_obj, OMX_U32 TIZ_UNUSED (a_pid))
+{
+  splitter_prc_t * p_prc = ap_obj;
+  OMX_U32 i = 0;
+  assert (p_prc);
+
+  p_prc->zero_copy_ = TIZ_RCFILE_GET_BOOL (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION,
+    "OMX.Aratelia.audio_splitter.pcm.zero_copy_buffers", false);
+  for (i = 0; i < p_prc->noutputs_; ++i)
+    {
+      p_prc->branches_[i].drop = read_drop_policy (p_prc->branches_[i].pid);
+    }
+
+  TIZ_TRACE (handleOf (p_prc), "outputs [%u] zero copy [%s]",
+             p_prc->noutputs_, p_prc->zero_copy_ ? "YES" : "NO");
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+splitter_prc_deallocate_resources (void * ap_obj)
+{
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+splitter_prc_prepare_to_transfer (void * ap_obj, OMX_U32 TIZ_UNUSED (a_pid))
+{
+  splitter_prc_t * p_prc = ap_obj;
+  OMX_U32 i = 0;
+  assert (p_prc);
+
+  p_prc->max_chunks_
+    = MAX (1, MIN (input_buffer_count (p_prc), SPLITTER_MAX_CHUNKS));
+  p_prc->in_enabled_
+    = is_port_enabled (p_prc, ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX);
+  for (i = 0; i < p_prc->noutputs_; ++i)
+    {
+      splitter_branch_t * p_branch = &(p_prc->branches_[i]);
+      p_branch->enabled = is_port_enabled (p_prc, p_branch->pid);
+      p_branch->seq = p_prc->tail_;
+      p_branch->offset = 0;
+      p_branch->dropped = 0;
+    }
+
+  return propagate_pcm_settings (p_prc);
+}
+
+static OMX_ERRORTYPE
+splitter_prc_transfer_and_process (void * ap_obj, OMX_U32 TIZ_UNUSED (a_pid))
+{
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+splitter_prc_stop_and_return (void * ap_obj)
+{
+  return release_all (ap_obj);
+}
+
+/*
+ * from tiz_prc class
+ */
+
+static OMX_ERRORTYPE
+splitter_prc_buffers_ready (const void * ap_obj)
+{
+  splitter_prc_t * p_prc = (splitter_prc_t *) ap_obj;
+  bool progress = true;
+
+  assert (p_prc);
+
+  while (progress)
+    {
+      OMX_U32 i = 0;
+      progress = false;
+
+      /* Take in as much input as the fifo allows */
+      while (p_prc->in_enabled_
+             && p_prc->tail_ - p_prc->head_ < p_prc->max_chunks_)
+        {
+          OMX_BUFFERHEADERTYPE * p_hdr = NULL;
+          if (OMX_ErrorNone
+                != tiz_krn_claim_buffer (
+                     tiz_get_krn (handleOf (p_prc)),
+                     ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX, 0, &p_hdr)
+              || !p_hdr)
+            {
+              break;
+            }
+          chunk_at (p_prc, p_prc->tail_)->p_hdr = p_hdr;
+          chunk_at (p_prc, p_prc->tail_)->refs = 0;
+          ++(p_prc->tail_);
+          progress = true;
+        }
+
+      for (i = 0; i < p_prc->noutputs_; ++i)
+        {
+          if (p_prc->branches_[i].enabled)
+            {
+              reclaim_lent (p_prc, &(p_prc->branches_[i]), &progress);
+              tiz_check_omx (
+                serve_branch (p_prc, &(p_prc->branches_[i]), &progress));
+            }
+        }
+
+      tiz_check_omx (release_chunks (p_prc, &progress));
+
+      if (!progress)
+        {
+          progress = drop_lagging (p_prc);
+        }
+    }
+
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+splitter_prc_port_flush (const void * ap_obj, OMX_U32 a_pid)
+{
+  splitter_prc_t * p_prc = (splitter_prc_t *) ap_obj;
+  splitter_branch_t * p_branch = find_branch (p_prc, a_pid);
+  bool progress = false;
+
+  if (OMX_ALL == a_pid || ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX == a_pid)
+    {
+      return release_all (p_prc);
+    }
+
+  if (p_branch)
+    {
+      /* The chunks that were only waiting for this branch can go now */
+      tiz_check_omx (release_branch (p_prc, p_branch));
+      return release_chunks (p_prc, &progress);
+    }
+
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+splitter_prc_port_disable (const void * ap_obj, OMX_U32 a_pid)
+{
+  splitter_prc_t * p_prc = (splitter_prc_t *) ap_obj;
+  splitter_branch_t * p_branch = find_branch (p_prc, a_pid);
+  OMX_U32 i = 0;
+
+  if (OMX_ALL == a_pid)
+    {
+      p_prc->in_enabled_ = false;
+      for (i = 0; i < p_prc->noutputs_; ++i)
+        {
+          p_prc->branches_[i].enabled = false;
+        }
+    }
+  else if (ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX == a_pid)
+    {
+      p_prc->in_enabled_ = false;
+    }
+  else if (p_branch)
+    {
+      p_branch->enabled = false;
+    }
+
+  return splitter_prc_port_flush (ap_obj, a_pid);
+}
+
+static OMX_ERRORTYPE
+splitter_prc_port_enable (const void * ap_obj, OMX_U32 a_pid)
+{
+  splitter_prc_t * p_prc = (splitter_prc_t *) ap_obj;
+  splitter_branch_t * p_branch = find_branch (p_prc, a_pid);
+  OMX_U32 i = 0;
+
+  if (OMX_ALL == a_pid || ARATELIA_AUDIO_SPLITTER_INPUT_PORT_INDEX == a_pid)
+    {
+      p_prc->in_enabled_ = true;
+      /* The input's pcm settings may have changed while disabled */
+      tiz_check_omx (propagate_pcm_settings (p_prc));
+    }
+
+  for (i = 0; i < p_prc->noutputs_; ++i)
+    {
+      if (OMX_ALL == a_pid || p_branch == &(p_prc->branches_[i]))
+        {
+          /* A re-enabled branch joins at the newest data */
+          p_prc->branches_[i].enabled = true;
+          p_prc->branches_[i].seq = p_prc->tail_;
+          p_prc->branches_[i].offset = 0;
+        }
+    }
+
+  return OMX_ErrorNone;
+}
+
+/*
+ * splitter_prc_class
+ */
+
+static void *
+splitter_prc_class_ctor (void * ap_obj, va_list * app)
+{
+  /* NOTE: Class methods might be added in the future. None for now. */
+  return super_ctor (typeOf (ap_obj, "splitterprc_class"), ap_obj, app);
+}
+
+/*
+ * initialization
+ */
+
+void *
+splitter_prc_class_init (void * ap_tos, void * ap_hdl)
+{
+  void * tizprc = tiz_get_type (ap_hdl, "tizprc");
+  void * splitterprc_class = factory_new
+    /* TIZ_CLASS_COMMENT: class type, class name, parent, size */
+    (classOf (tizprc), "splitterprc_class", classOf (tizprc),
+     sizeof (splitter_prc_class_t),
+     /* TIZ_CLASS_COMMENT: */
+     ap_tos, ap_hdl,
+     /* TIZ_CLASS_COMMENT: class constructor */
+     ctor, splitter_prc_class_ctor,
+     /* TIZ_CLASS_COMMENT: stop value */
+     0);
+  return splitterprc_class;
+}
+
+void *
+splitter_prc_init (void * ap_tos, void * ap_hdl)
+{
+  void * tizprc = tiz_get_type (ap_hdl, "tizprc");
+  void * splitterprc_class = tiz_get_type (ap_hdl, "splitterprc_class");
+  TIZ_LOG_CLASS (splitterprc_class);
+  void * splitterprc = factory_new
+    /* TIZ_CLASS_COMMENT: class type, class name, parent, size */
+    (splitterprc_class, "splitterprc", tizprc, sizeof (splitter_prc_t),
+     /* TIZ_CLASS_COMMENT: */
+     ap_tos, ap_hdl,
+     /* TIZ_CLASS_COMMENT: class constructor */
+     ctor, splitter_prc_ctor,
+     /* TIZ_CLASS_COMMENT: class destructor */
+     dtor, splitter_prc_dtor,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_allocate_resources, splitter_prc_allocate_resources,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_deallocate_resources, splitter_prc_deallocate_resources,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_prepare_to_transfer, splitter_prc_prepare_to_transfer,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_transfer_and_process, splitter_prc_transfer_and_process,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_stop_and_return, splitter_prc_stop_and_return,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_buffers_ready, splitter_prc_buffers_ready,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_port_flush, splitter_prc_port_flush,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_port_disable, splitter_prc_port_disable,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_port_enable, splitter_prc_port_enable,
+     /* TIZ_CLASS_COMMENT: stop value */
+     0);
+
+  return splitterprc;
+}
@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   splitterprc_decls.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - PCM audio splitter processor class declarations
+ *
+ *
+ */
+
+#ifndef SPLITTERPRC_DECLS_H
+#define SPLITTERPRC_DECLS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+
+#include <OMX_Core.h>
+
+#include <tizprc_decls.h>
+
+#include "splitter.h"
+
+/* Upper bound for the number of input buffers held at any time */
+#define SPLITTER_MAX_CHUNKS 32
+/* Upper bound for the number of buffers on an output port */
+#define SPLITTER_MAX_LENT 32
+
+  /* A held input buffer, shared by all the branches */
+  typedef struct splitter_chunk splitter_chunk_t;
+  struct splitter_chunk
+  {
+    OMX_BUFFERHEADERTYPE * p_hdr;
+    OMX_U32 refs; /* Output buffers still pointing into it */
+  };
+
+  /* An output buffer that points into a chunk */
+  typedef struct splitter_lent splitter_lent_t;
+  struct splitter_lent
+  {
+    OMX_BUFFERHEADERTYPE * p_hdr;
+    OMX_U32 seq;
+  };
+
+  /* One output port and its position in the input stream */
+  typedef struct splitter_branch splitter_branch_t;
+  struct splitter_branch
+  {
+    OMX_U32 pid;
+    bool enabled;
+    bool drop;    /* Backpressure policy: drop data instead of blocking */
+    OMX_U32 seq;  /* Next chunk to deliver */
+    OMX_U32 offset;
+    OMX_BUFFERHEADERTYPE * p_hdr;
+    splitter_lent_t lent[SPLITTER_MAX_LENT];
+    OMX_U32 nlent;
+    /* Output buffers reclaimed before there was input to put in them */
+    OMX_BUFFERHEADERTYPE * idle[SPLITTER_MAX_LENT];
+    OMX_U32 nidle;
+    OMX_U32 dropped;
+  };
+
+  typedef struct splitter_prc splitter_prc_t;
+  struct splitter_prc
+  {
+    /* Object */
+    const tiz_prc_t _;
+    OMX_U32 noutputs_;
+    splitter_branch_t branches_[ARATELIA_AUDIO_SPLITTER_MAX_OUTPUTS];
+    splitter_chunk_t chunks_[SPLITTER_MAX_CHUNKS];
+    OMX_U32 head_; /* Oldest chunk */
+    OMX_U32 tail_; /* Next chunk */
+    OMX_U32 max_chunks_;
+    bool in_enabled_;
+    bool zero_copy_;
+  };
+
+  typedef struct splitter_prc_class splitter_prc_class_t;
+  struct splitter_prc_class
+  {
+    /* Class */
+    const tiz_prc_class_t _;
+    /* NOTE: Class methods might be added in the future */
+  };
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPLITTERPRC_DECLS_H */
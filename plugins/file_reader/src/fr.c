@@ -64,6 +64,27 @@
 
 static OMX_VERSIONTYPE file_reader_version = {{1, 0, 0, 0}};
 
+static OMX_U8 *
+fr_buffer_alloc_hook (OMX_U32 * ap_size, OMX_PTR * app_port_priv,
+                      void * ap_args)
+{
+  OMX_U8 * p = NULL;
+  assert (ap_size && *ap_size > 0);
+  assert (app_port_priv);
+  p = tiz_mem_calloc ((size_t) *ap_size, sizeof (OMX_U8));
+  /* The processor may point the header's pBuffer somewhere else (i.e. into
+     the file mapping); the original address is kept here, so that it can
+     always be restored and freed. */
+  *app_port_priv = p;
+  return p;
+}
+
+static void
+fr_buffer_free_hook (OMX_PTR ap_buf, OMX_PTR ap_port_priv, void * ap_args)
+{
+  tiz_mem_free (ap_port_priv ? ap_port_priv : ap_buf);
+}
+
 static OMX_PTR
 instantiate_audio_port (OMX_HANDLETYPE ap_hdl)
 {
@@ -75,7 +96,8 @@ instantiate_audio_port (OMX_HANDLETYPE ap_hdl)
     ARATELIA_FILE_READER_PORT_NONCONTIGUOUS,
     ARATELIA_FILE_READER_PORT_ALIGNMENT,
     ARATELIA_FILE_READER_PORT_SUPPLIERPREF,
-    {ARATELIA_FILE_READER_PORT_INDEX, NULL, NULL, NULL},
+    {ARATELIA_FILE_READER_PORT_INDEX, fr_buffer_alloc_hook, fr_buffer_free_hook,
+     NULL},
     -1 /* use -1 for now */
   };
 
@@ -93,7 +115,8 @@ instantiate_video_port (OMX_HANDLETYPE ap_hdl)
     ARATELIA_FILE_READER_PORT_NONCONTIGUOUS,
     ARATELIA_FILE_READER_PORT_ALIGNMENT,
     ARATELIA_FILE_READER_PORT_SUPPLIERPREF,
-    {ARATELIA_FILE_READER_PORT_INDEX, NULL, NULL, NULL},
+    {ARATELIA_FILE_READER_PORT_INDEX, fr_buffer_alloc_hook, fr_buffer_free_hook,
+     NULL},
     -1 /* use -1 for now */
   };
 
@@ -111,7 +134,8 @@ instantiate_image_port (OMX_HANDLETYPE ap_hdl)
     ARATELIA_FILE_READER_PORT_NONCONTIGUOUS,
     ARATELIA_FILE_READER_PORT_ALIGNMENT,
     ARATELIA_FILE_READER_PORT_SUPPLIERPREF,
-    {ARATELIA_FILE_READER_PORT_INDEX, NULL, NULL, NULL},
+    {ARATELIA_FILE_READER_PORT_INDEX, fr_buffer_alloc_hook, fr_buffer_free_hook,
+     NULL},
     -1 /* use -1 for now */
   };
 
@@ -129,7 +153,8 @@ instantiate_other_port (OMX_HANDLETYPE ap_hdl)
     ARATELIA_FILE_READER_PORT_NONCONTIGUOUS,
     ARATELIA_FILE_READER_PORT_ALIGNMENT,
     ARATELIA_FILE_READER_PORT_SUPPLIERPREF,
-    {ARATELIA_FILE_READER_PORT_INDEX, NULL, NULL, NULL},
+    {ARATELIA_FILE_READER_PORT_INDEX, fr_buffer_alloc_hook, fr_buffer_free_hook,
+     NULL},
     -1 /* use -1 for now */
   };
 
@@ -140,7 +165,7 @@ static OMX_PTR
 instantiate_config_port (OMX_HANDLETYPE ap_hdl)
 {
   /* Instantiate the config port */
-  return factory_new (tiz_get_type (ap_hdl, "tizuricfgport"),
+  return factory_new (tiz_get_type (ap_hdl, "tizdemuxercfgport"),
                       NULL, /* this port does not take options */
                       ARATELIA_FILE_READER_COMPONENT_NAME, file_reader_version);
 }
@@ -30,7 +30,6 @@
 #include <config.h>
 #endif
 
-#include <stdio.h>
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
@@ -61,7 +60,7 @@ close_file (fr_prc_t * ap_prc)
   assert (ap_prc);
   if (ap_prc->p_file_)
     {
-      fclose (ap_prc->p_file_);
+      tiz_mmap_destroy (ap_prc->p_file_);
       ap_prc->p_file_ = NULL;
     }
 }
@@ -80,9 +79,11 @@ reset_stream_parameters (fr_prc_t * ap_prc)
   assert (ap_prc);
   ap_prc->counter_ = 0;
   ap_prc->eos_ = false;
+  ap_prc->position_ = 0;
+  ap_prc->seek_pending_ = false;
   if (ap_prc->p_file_)
     {
-      rewind (ap_prc->p_file_);
+      (void) tiz_mmap_seek (ap_prc->p_file_, 0, TIZ_MMAP_SEEK_SET);
     }
 }
 
@@ -129,6 +130,62 @@ obtain_uri (fr_prc_t * ap_prc)
   return rc;
 }
 
+static OMX_ERRORTYPE
+seek_to_time_position (fr_prc_t * ap_prc)
+{
+  long offset = 0;
+  OMX_TICKS landed = 0;
+  assert (ap_prc);
+
+  ap_prc->seek_pending_ = false;
+  if (!ap_prc->p_file_)
+    {
+      return OMX_ErrorNone;
+    }
+
+  tiz_check_omx (fr_seek_index_lookup (ap_prc->p_seek_idx_, ap_prc->seek_pos_,
+                                       &offset, &landed));
+  if (tiz_mmap_seek (ap_prc->p_file_, offset, TIZ_MMAP_SEEK_SET) != 0)
+    {
+      TIZ_ERROR (handleOf (ap_prc), "Unable to seek to offset [%ld] (%s)",
+                 offset, strerror (errno));
+      return OMX_ErrorUnsupportedSetting;
+    }
+
+  TIZ_DEBUG (handleOf (ap_prc),
+             "[%s] target [%lld] us - landed at [%lld] us - offset [%ld]",
+             fr_seek_index_format_str (ap_prc->p_seek_idx_),
+             (long long) ap_prc->seek_pos_, (long long) landed, offset);
+  ap_prc->counter_ = offset;
+  ap_prc->position_ = landed;
+  ap_prc->eos_ = false;
+  return OMX_ErrorNone;
+}
+
+static size_t
+map_into_buffer (fr_prc_t * ap_prc, OMX_BUFFERHEADERTYPE * p_hdr)
+{
+  size_t avail = 0;
+  const OMX_U8 * p_data = NULL;
+  assert (ap_prc);
+  assert (p_hdr);
+
+  /* The buffer is pointed at the file mapping instead of being filled with a
+     copy of it. The mapping is read-only, so this is only enabled by
+     configuration, for graphs whose consumers don't work in-place; the
+     others get a copy (see read_into_buffer). The original buffer is kept by
+     the port's allocation hook, which is what eventually gets freed (see
+     fr.c). */
+  p_data = tiz_mmap_get (ap_prc->p_file_, &avail);
+  if (!p_data || 0 == avail)
+    {
+      return 0;
+    }
+
+  p_hdr->pBuffer = (OMX_U8 *) p_data;
+  return tiz_mmap_advance (ap_prc->p_file_, MIN (avail, p_hdr->nAllocLen));
+}
+
 static OMX_ERRORTYPE
 read_into_buffer (const void * ap_obj, OMX_BUFFERHEADERTYPE * p_hdr)
 {
@@ -137,11 +194,29 @@ read_into_buffer (const void * ap_obj, OMX_BUFFERHEADERTYPE * p_hdr)
 
   if (p_prc->p_file_ && !(p_prc->eos_))
     {
-      int bytes_read = 0;
-      if (!(bytes_read
-            = fread (p_hdr->pBuffer, 1, p_hdr->nAllocLen, p_prc->p_file_)))
+      size_t bytes_read = 0;
+
+      /* Only the buffers allocated by this component's port (whose original
+         address is stored as port private data) can be re-pointed */
+      if (p_hdr->pOutputPortPrivate)
+        {
+          p_hdr->pBuffer = p_hdr->pOutputPortPrivate;
+        }
+
+      if (p_prc->zero_copy_ && p_hdr->pOutputPortPrivate
+          && tiz_mmap_is_mapped (p_prc->p_file_))
         {
-          if (feof (p_prc->p_file_))
+          bytes_read = map_into_buffer (p_prc, p_hdr);
+        }
+      else
+        {
+          bytes_read
+            = tiz_mmap_read (p_prc->p_file_, p_hdr->pBuffer, p_hdr->nAllocLen);
+        }
+
+      if (!bytes_read)
+        {
+          if (tiz_mmap_eof (p_prc->p_file_))
             {
               TIZ_NOTICE (
                 handleOf (p_prc),
@@ -157,7 +232,7 @@ read_into_buffer (const void * ap_obj, OMX_BUFFERHEADERTYPE * p_hdr)
             }
         }
 
-      p_hdr->nFilledLen = bytes_read;
+      p_hdr->nFilledLen = (OMX_U32) bytes_read;
       p_prc->counter_ += p_hdr->nFilledLen;
 
       TIZ_TRACE (handleOf (p_prc),
@@ -180,6 +255,9 @@ fr_prc_ctor (void * ap_obj, va_list * app)
   assert (p_prc);
   p_prc->p_file_ = NULL;
   p_prc->p_uri_param_ = NULL;
+  p_prc->p_seek_idx_ = NULL;
+  p_prc->seek_pos_ = 0;
+  p_prc->zero_copy_ = false;
   reset_stream_parameters (p_prc);
   return p_prc;
 }
@@ -205,21 +283,40 @@ fr_prc_allocate_resources (void * ap_obj, OMX_U32 TIZ_UNUSED (a_pid))
 
   tiz_check_omx (obtain_uri (p_prc));
 
-  if ((p_prc->p_file_
-       = fopen ((const char *) p_prc->p_uri_param_->contentURI, "r"))
-      == 0)
+  if (OMX_ErrorNone
+      != tiz_mmap_init (&(p_prc->p_file_),
+                        (const char *) p_prc->p_uri_param_->contentURI))
     {
       TIZ_ERROR (handleOf (p_prc), "Error opening file from URI (%s)",
                  strerror (errno));
       return OMX_ErrorInsufficientResources;
     }
 
+  p_prc->zero_copy_ = TIZ_RCFILE_GET_BOOL (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION,
+    "OMX.Aratelia.file_reader.binary.zero_copy_buffers", false);
+  TIZ_DEBUG (handleOf (p_prc), "mapped [%s] - zero copy [%s]",
+             tiz_mmap_is_mapped (p_prc->p_file_) ? "YES" : "NO",
+             p_prc->zero_copy_ ? "YES" : "NO");
+
+  /* Only the container headers are read here; the index does not touch the
+     file's current position */
+  tiz_check_omx (fr_seek_index_init (&(p_prc->p_seek_idx_),
+                                     tiz_mmap_fd (p_prc->p_file_)));
+  TIZ_DEBUG (handleOf (p_prc), "seek index [%s] - seekable [%s]",
+             fr_seek_index_format_str (p_prc->p_seek_idx_),
+             fr_seek_index_is_seekable (p_prc->p_seek_idx_) ? "YES" : "NO");
+
   return OMX_ErrorNone;
 }
 
 static OMX_ERRORTYPE
 fr_prc_deallocate_resources (void * ap_obj)
 {
+  fr_prc_t * p_prc = ap_obj;
+  assert (p_prc);
+  fr_seek_index_destroy (p_prc->p_seek_idx_);
+  p_prc->p_seek_idx_ = NULL;
   close_file (ap_obj);
   delete_uri (ap_obj);
   return OMX_ErrorNone;
@@ -277,6 +374,78 @@ fr_prc_buffers_ready (const void * ap_obj)
   return OMX_ErrorNone;
 }
 
+static OMX_ERRORTYPE
+fr_prc_port_flush (const void * ap_obj, OMX_U32 TIZ_UNUSED (a_pid))
+{
+  fr_prc_t * p_prc = (fr_prc_t *) ap_obj;
+  assert (p_prc);
+  /* A pending seek is applied here, so that nothing read from the new
+     position can be discarded by the flush that follows the request */
+  if (p_prc->seek_pending_)
+    {
+      return seek_to_time_position (p_prc);
+    }
+  /* No buffers are ever held by this processor */
+  return OMX_ErrorNone;
+}
+
+/*
+ * from tiz_api class
+ */
+
+static OMX_ERRORTYPE
+fr_prc_GetConfig (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
+                  OMX_INDEXTYPE a_index, OMX_PTR ap_struct)
+{
+  const fr_prc_t * p_prc = ap_obj;
+  assert (p_prc);
+
+  if (OMX_IndexConfigTimePosition == a_index)
+    {
+      OMX_TIME_CONFIG_TIMESTAMPTYPE * p_ts
+        = (OMX_TIME_CONFIG_TIMESTAMPTYPE *) ap_struct;
+      if (!fr_seek_index_is_seekable (p_prc->p_seek_idx_))
+        {
+          return OMX_ErrorUnsupportedIndex;
+        }
+      /* This is the position of the last repositioning of the stream */
+      p_ts->nTimestamp = p_prc->position_;
+      return OMX_ErrorNone;
+    }
+
+  return super_GetConfig (typeOf (ap_obj, "frprc"), ap_obj, ap_hdl, a_index,
+                          ap_struct);
+}
+
+static OMX_ERRORTYPE
+fr_prc_SetConfig (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
+                  OMX_INDEXTYPE a_index, OMX_PTR ap_struct)
+{
+  fr_prc_t * p_prc = (fr_prc_t *) ap_obj;
+  assert (p_prc);
+
+  if (OMX_IndexConfigTimePosition == a_index)
+    {
+      const OMX_TIME_CONFIG_TIMESTAMPTYPE * p_ts
+        = (OMX_TIME_CONFIG_TIMESTAMPTYPE *) ap_struct;
+      if (!fr_seek_index_is_seekable (p_prc->p_seek_idx_))
+        {
+          return OMX_ErrorUnsupportedSetting;
+        }
+      if (p_ts->nTimestamp < 0)
+        {
+          return OMX_ErrorBadParameter;
+        }
+      /* The actual repositioning happens in the processor's thread, when the
+         client flushes the output port (see fr_prc_port_flush). */
+      p_prc->seek_pos_ = p_ts->nTimestamp;
+      p_prc->seek_pending_ = true;
+    }
+
+  return super_SetConfig (typeOf (ap_obj, "frprc"), ap_obj, ap_hdl, a_index,
+                          ap_struct);
+}
+
 /*
  * fr_prc_class
  */
@@ -335,6 +504,12 @@ fr_prc_init (void * ap_tos, void * ap_hdl)
      tiz_srv_stop_and_return, fr_prc_stop_and_return,
      /* TIZ_CLASS_COMMENT: */
      tiz_prc_buffers_ready, fr_prc_buffers_ready,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_port_flush, fr_prc_port_flush,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_api_GetConfig, fr_prc_GetConfig,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_api_SetConfig, fr_prc_SetConfig,
      /* TIZ_CLASS_COMMENT: stop value */
      0);
 
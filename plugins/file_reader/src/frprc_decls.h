@@ -36,17 +36,25 @@ extern "C"
 
 #include <stdbool.h>
 
+#include <tizplatform.h>
 #include <tizprc_decls.h>
 
+#include "frseek.h"
+
   typedef struct fr_prc fr_prc_t;
   struct fr_prc
   {
     /* Object */
     const tiz_prc_t _;
-    FILE * p_file_;
+    tiz_mmap_t * p_file_;
     OMX_PARAM_CONTENTURITYPE * p_uri_param_;
     OMX_U32 counter_;
     bool eos_;
+    fr_seek_index_t * p_seek_idx_;
+    OMX_TICKS position_;
+    OMX_TICKS seek_pos_;
+    bool seek_pending_;
+    bool zero_copy_;
   };
 
   typedef struct fr_prc_class fr_prc_class_t;
@@ -0,0 +1,944 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   frseek.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief Tizonia - Binary file reader's time-to-byte seek index
+ *
+ * Supported formats:
+ *
+ * - FLAC: the SEEKTABLE metadata block (if any) narrows down the search, and
+ * then the frame headers are bisected until the frame that contains the
+ * target sample is found.
+ *
+ * - MP3: the Xing/Info TOC or the VBRI table is used when present; otherwise
+ * the stream is assumed to be CBR. The resulting offset is then moved forward
+ * to the next valid frame header.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <tizplatform.h>
+
+#include "frseek.h"
+
+#define FR_SEEK_PROBE_SIZE 4096
+#define FR_SEEK_SCAN_CHUNK_SIZE 8192
+#define FR_SEEK_MP3_MAX_SYNC_SCAN (64 * 1024)
+#define FR_SEEK_FLAC_LINEAR_SCAN_BYTES (64 * 1024)
+#define FR_SEEK_FLAC_MAX_HEADER_SIZE 16
+#define FR_SEEK_MP3_MAX_VBRI_ENTRIES 4096
+
+typedef enum fr_seek_format fr_seek_format_t;
+enum fr_seek_format
+{
+  EFrSeekFormatUnknown = 0,
+  EFrSeekFormatFlac,
+  EFrSeekFormatMp3
+};
+
+typedef struct fr_seek_point fr_seek_point_t;
+struct fr_seek_point
+{
+  OMX_U64 sample_;
+  OMX_U64 offset_; /* Relative to the first audio frame */
+};
+
+typedef struct fr_mp3_header fr_mp3_header_t;
+struct fr_mp3_header
+{
+  OMX_U32 version_; /* 1 = MPEG1, 2 = MPEG2, 25 = MPEG2.5 */
+  OMX_U32 layer_;
+  OMX_U32 bitrate_; /* kbps */
+  OMX_U32 sample_rate_;
+  OMX_U32 channels_;
+  OMX_U32 frame_size_;
+  OMX_U32 samples_;
+};
+
+struct fr_seek_index
+{
+  int fd_;
+  OMX_U64 file_size_;
+  fr_seek_format_t format_;
+  OMX_U64 audio_start_; /* Offset of the first audio frame */
+  OMX_U64 audio_size_;
+  OMX_U32 sample_rate_;
+  OMX_U64 total_samples_;
+  /* FLAC */
+  OMX_U32 min_blocksize_;
+  OMX_U32 max_blocksize_;
+  /* FLAC SEEKTABLE points or MP3 VBRI table */
+  fr_seek_point_t * p_points_;
+  OMX_U32 npoints_;
+  /* MP3 */
+  fr_mp3_header_t mp3_ref_;
+  bool has_toc_;
+  OMX_U8 toc_[100];
+};
+
+static const OMX_U32 mp3_bitrates[2][3][16] = {
+  /* MPEG1 - Layers I, II, III */
+  {{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0},
+   {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},
+   {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0}},
+  /* MPEG2/2.5 - Layers I, II, III */
+  {{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},
+   {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0},
+   {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}}};
+
+static const OMX_U32 mp3_sample_rates[3][3] = {{44100, 48000, 32000},
+                                               {22050, 24000, 16000},
+                                               {11025, 12000, 8000}};
+
+static inline OMX_U32
+read_be16 (const OMX_U8 * p)
+{
+  return ((OMX_U32) p[0] << 8) | p[1];
+}
+
+static inline OMX_U32
+read_be24 (const OMX_U8 * p)
+{
+  return ((OMX_U32) p[0] << 16) | ((OMX_U32) p[1] << 8) | p[2];
+}
+
+static inline OMX_U32
+read_be32 (const OMX_U8 * p)
+{
+  return ((OMX_U32) p[0] << 24) | ((OMX_U32) p[1] << 16)
+         | ((OMX_U32) p[2] << 8) | p[3];
+}
+
+static inline OMX_U64
+read_be64 (const OMX_U8 * p)
+{
+  return ((OMX_U64) read_be32 (p) << 32) | read_be32 (p + 4);
+}
+
+static ssize_t
+read_at (const fr_seek_index_t * ap_idx, OMX_U8 * ap_buf, const size_t a_len,
+         const OMX_U64 a_offset)
+{
+  ssize_t total = 0;
+  assert (ap_idx);
+  while ((size_t) total < a_len)
+    {
+      const ssize_t n = pread (ap_idx->fd_, ap_buf + total, a_len - total,
+                               (off_t) (a_offset + total));
+      if (n <= 0)
+        {
+          break;
+        }
+      total += n;
+    }
+  return total;
+}
+
+/*
+ * ID3v2
+ */
+
+static OMX_U64
+skip_id3v2 (const fr_seek_index_t * ap_idx, OMX_U64 a_offset)
+{
+  OMX_U8 hdr[10];
+  /* There might be several consecutive tags */
+  while (read_at (ap_idx, hdr, sizeof (hdr), a_offset) == sizeof (hdr)
+         && 0 == memcmp (hdr, "ID3", 3))
+    {
+      const OMX_U32 size = ((OMX_U32) (hdr[6] & 0x7f) << 21)
+                           | ((OMX_U32) (hdr[7] & 0x7f) << 14)
+                           | ((OMX_U32) (hdr[8] & 0x7f) << 7) | (hdr[9] & 0x7f);
+      /* Header, payload and optional footer */
+      a_offset += 10 + size + ((hdr[5] & 0x10) ? 10 : 0);
+    }
+  return a_offset;
+}
+
+/*
+ * FLAC
+ */
+
+static OMX_U8
+flac_crc8 (const OMX_U8 * ap_data, size_t a_len)
+{
+  OMX_U8 crc = 0;
+  while (a_len--)
+    {
+      int i = 0;
+      crc ^= *ap_data++;
+      for (i = 0; i < 8; ++i)
+        {
+          crc = (crc & 0x80) ? (OMX_U8) ((crc << 1) ^ 0x07)
+                             : (OMX_U8) (crc << 1);
+        }
+    }
+  return crc;
+}
+
+/* Parses a frame header at ap_data. On success returns true and fills in the
+   first sample number of the frame and the number of samples in it. */
+static bool
+parse_flac_frame_header (const fr_seek_index_t * ap_idx,
+                         const OMX_U8 * ap_data, const size_t a_avail,
+                         OMX_U64 * ap_sample, OMX_U32 * ap_blocksize)
+{
+  const OMX_U8 * p = ap_data;
+  OMX_U32 bs_code = 0;
+  OMX_U32 sr_code = 0;
+  OMX_U64 number = 0;
+  OMX_U32 blocksize = 0;
+  size_t len = 4;
+  int extra = 0;
+  int i = 0;
+
+  if (a_avail < FR_SEEK_FLAC_MAX_HEADER_SIZE || p[0] != 0xFF
+      || (p[1] & 0xFE) != 0xF8)
+    {
+      return false;
+    }
+
+  bs_code = p[2] >> 4;
+  sr_code = p[2] & 0x0F;
+  if (0 == bs_code || 0x0F == sr_code || (p[3] >> 4) > 10
+      || ((p[3] >> 1) & 0x07) == 3 || ((p[3] >> 1) & 0x07) == 7
+      || (p[3] & 0x01))
+    {
+      return false;
+    }
+
+  /* UTF-8-like coded frame or sample number */
+  if (!(p[len] & 0x80))
+    {
+      number = p[len];
+    }
+  else if ((p[len] & 0xE0) == 0xC0)
+    {
+      number = p[len] & 0x1F;
+      extra = 1;
+    }
+  else if ((p[len] & 0xF0) == 0xE0)
+    {
+      number = p[len] & 0x0F;
+      extra = 2;
+    }
+  else if ((p[len] & 0xF8) == 0xF0)
+    {
+      number = p[len] & 0x07;
+      extra = 3;
+    }
+  else if ((p[len] & 0xFC) == 0xF8)
+    {
+      number = p[len] & 0x03;
+      extra = 4;
+    }
+  else if ((p[len] & 0xFE) == 0xFC)
+    {
+      number = p[len] & 0x01;
+      extra = 5;
+    }
+  else if (p[len] == 0xFE)
+    {
+      number = 0;
+      extra = 6;
+    }
+  else
+    {
+      return false;
+    }
+  ++len;
+  for (i = 0; i < extra; ++i, ++len)
+    {
+      if ((p[len] & 0xC0) != 0x80)
+        {
+          return false;
+        }
+      number = (number << 6) | (p[len] & 0x3F);
+    }
+
+  if (1 == bs_code)
+    {
+      blocksize = 192;
+    }
+  else if (bs_code <= 5)
+    {
+      blocksize = 576 << (bs_code - 2);
+    }
+  else if (6 == bs_code)
+    {
+      blocksize = p[len++] + 1;
+    }
+  else if (7 == bs_code)
+    {
+      blocksize = read_be16 (p + len) + 1;
+      len += 2;
+    }
+  else
+    {
+      blocksize = 256 << (bs_code - 8);
+    }
+
+  if (12 == sr_code)
+    {
+      len += 1;
+    }
+  else if (13 == sr_code || 14 == sr_code)
+    {
+      len += 2;
+    }
+
+  if (flac_crc8 (p, len) != p[len])
+    {
+      return false;
+    }
+
+  /* Fixed-blocksize streams code the frame number */
+  *ap_sample = (p[1] & 0x01) ? number : number * ap_idx->min_blocksize_;
+  *ap_blocksize = blocksize;
+  return (*ap_sample < ap_idx->total_samples_ || 0 == ap_idx->total_samples_);
+}
+
+/* Finds the first frame header at or after a_offset (and before a_limit) */
+static bool
+find_flac_frame (const fr_seek_index_t * ap_idx, OMX_U64 a_offset,
+                 const OMX_U64 a_limit, OMX_U64 * ap_frame_offset,
+                 OMX_U64 * ap_sample, OMX_U32 * ap_blocksize)
+{
+  OMX_U8 buf[FR_SEEK_SCAN_CHUNK_SIZE + FR_SEEK_FLAC_MAX_HEADER_SIZE];
+  while (a_offset < a_limit)
+    {
+      const ssize_t n = read_at (ap_idx, buf, sizeof (buf), a_offset);
+      ssize_t i = 0;
+      if (n < FR_SEEK_FLAC_MAX_HEADER_SIZE)
+        {
+          break;
+        }
+      for (i = 0; i + FR_SEEK_FLAC_MAX_HEADER_SIZE <= n
+                  && a_offset + i < a_limit;
+           ++i)
+        {
+          if (buf[i] == 0xFF
+              && parse_flac_frame_header (ap_idx, buf + i, n - i, ap_sample,
+                                          ap_blocksize))
+            {
+              *ap_frame_offset = a_offset + i;
+              return true;
+            }
+        }
+      /* Overlap the chunks so that no header is missed */
+      a_offset += n - FR_SEEK_FLAC_MAX_HEADER_SIZE + 1;
+    }
+  return false;
+}
+
+static OMX_ERRORTYPE
+probe_flac (fr_seek_index_t * ap_idx, OMX_U64 a_offset)
+{
+  OMX_U8 hdr[4];
+  bool last = false;
+  assert (ap_idx);
+
+  a_offset += 4; /* "fLaC" */
+  while (!last && read_at (ap_idx, hdr, 4, a_offset) == 4)
+    {
+      const OMX_U32 type = hdr[0] & 0x7F;
+      const OMX_U32 len = read_be24 (hdr + 1);
+      last = (hdr[0] & 0x80) != 0;
+      a_offset += 4;
+
+      if (0 == type && len >= 34)
+        {
+          OMX_U8 si[34];
+          if (read_at (ap_idx, si, sizeof (si), a_offset) != sizeof (si))
+            {
+              return OMX_ErrorNone;
+            }
+          ap_idx->min_blocksize_ = read_be16 (si);
+          ap_idx->max_blocksize_ = read_be16 (si + 2);
+          ap_idx->sample_rate_ = read_be24 (si + 10) >> 4;
+          ap_idx->total_samples_
+            = ((OMX_U64) (si[13] & 0x0F) << 32) | read_be32 (si + 14);
+        }
+      else if (3 == type && len >= 18 && !ap_idx->p_points_)
+        {
+          const OMX_U32 npoints = len / 18;
+          OMX_U8 * p_table = tiz_mem_alloc (len);
+          OMX_U32 i = 0;
+          tiz_check_null_ret_oom (p_table);
+          ap_idx->p_points_
+            = tiz_mem_calloc (npoints, sizeof (fr_seek_point_t));
+          if (!ap_idx->p_points_)
+            {
+              tiz_mem_free (p_table);
+              return OMX_ErrorInsufficientResources;
+            }
+          if (read_at (ap_idx, p_table, len, a_offset) == (ssize_t) len)
+            {
+              for (i = 0; i < npoints; ++i)
+                {
+                  const OMX_U64 sample = read_be64 (p_table + i * 18);
+                  /* Skip placeholder points */
+                  if (sample != 0xFFFFFFFFFFFFFFFFULL)
+                    {
+                      ap_idx->p_points_[ap_idx->npoints_].sample_ = sample;
+                      ap_idx->p_points_[ap_idx->npoints_].offset_
+                        = read_be64 (p_table + i * 18 + 8);
+                      ap_idx->npoints_++;
+                    }
+                }
+            }
+          tiz_mem_free (p_table);
+        }
+      a_offset += len;
+    }
+
+  if (last && ap_idx->sample_rate_ > 0 && ap_idx->min_blocksize_ > 0)
+    {
+      ap_idx->format_ = EFrSeekFormatFlac;
+      ap_idx->audio_start_ = a_offset;
+    }
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+lookup_flac (fr_seek_index_t * ap_idx, const OMX_TICKS a_target,
+             long * ap_offset, OMX_TICKS * ap_landed)
+{
+  OMX_U64 target = (OMX_U64) a_target * ap_idx->sample_rate_ / 1000000;
+  OMX_U64 lo = ap_idx->audio_start_;
+  OMX_U64 hi = ap_idx->file_size_;
+  OMX_U64 frame_offset = 0;
+  OMX_U64 sample = 0;
+  OMX_U32 blocksize = 0;
+  OMX_U32 i = 0;
+
+  if (ap_idx->total_samples_ > 0 && target >= ap_idx->total_samples_)
+    {
+      target = ap_idx->total_samples_ - 1;
+    }
+
+  /* Narrow the search using the seek points */
+  for (i = 0; i < ap_idx->npoints_; ++i)
+    {
+      const OMX_U64 offset
+        = ap_idx->audio_start_ + ap_idx->p_points_[i].offset_;
+      if (ap_idx->p_points_[i].sample_ <= target)
+        {
+          lo = offset;
+        }
+      else
+        {
+          hi = offset < hi ? offset : hi;
+          break;
+        }
+    }
+
+  /* Bisect the frame headers... */
+  while (hi - lo > FR_SEEK_FLAC_LINEAR_SCAN_BYTES)
+    {
+      const OMX_U64 mid = lo + (hi - lo) / 2;
+      if (!find_flac_frame (ap_idx, mid, hi, &frame_offset, &sample,
+                            &blocksize))
+        {
+          hi = mid;
+        }
+      else if (sample <= target)
+        {
+          lo = frame_offset;
+          if (target < sample + blocksize)
+            {
+              hi = lo;
+            }
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  /* ... and then walk the frames that are left */
+  if (!find_flac_frame (ap_idx, lo, ap_idx->file_size_, &frame_offset, &sample,
+                        &blocksize))
+    {
+      return OMX_ErrorUnsupportedSetting;
+    }
+  for (;;)
+    {
+      OMX_U64 next_offset = 0;
+      OMX_U64 next_sample = 0;
+      OMX_U32 next_blocksize = 0;
+      if (target < sample + blocksize
+          || !find_flac_frame (ap_idx, frame_offset + 1, ap_idx->file_size_,
+                               &next_offset, &next_sample, &next_blocksize)
+          || next_sample > target)
+        {
+          break;
+        }
+      frame_offset = next_offset;
+      sample = next_sample;
+      blocksize = next_blocksize;
+    }
+
+  *ap_offset = (long) frame_offset;
+  *ap_landed = (OMX_TICKS) (sample * 1000000 / ap_idx->sample_rate_);
+  return OMX_ErrorNone;
+}
+
+/*
+ * MP3
+ */
+
+static bool
+parse_mp3_frame_header (const OMX_U8 * p, fr_mp3_header_t * ap_hdr)
+{
+  OMX_U32 version_bits = 0;
+  OMX_U32 layer_bits = 0;
+  OMX_U32 br_idx = 0;
+  OMX_U32 sr_idx = 0;
+  OMX_U32 padding = 0;
+  OMX_U32 lsf = 0;
+
+  if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0)
+    {
+      return false;
+    }
+
+  version_bits = (p[1] >> 3) & 0x03;
+  layer_bits = (p[1] >> 1) & 0x03;
+  br_idx = p[2] >> 4;
+  sr_idx = (p[2] >> 2) & 0x03;
+  padding = (p[2] >> 1) & 0x01;
+
+  if (1 == version_bits || 0 == layer_bits || 0 == br_idx || 15 == br_idx
+      || 3 == sr_idx)
+    {
+      return false;
+    }
+
+  ap_hdr->version_ = (3 == version_bits ? 1 : (2 == version_bits ? 2 : 25));
+  ap_hdr->layer_ = 4 - layer_bits;
+  lsf = (1 == ap_hdr->version_ ? 0 : 1);
+  ap_hdr->bitrate_ = mp3_bitrates[lsf][ap_hdr->layer_ - 1][br_idx];
+  ap_hdr->sample_rate_
+    = mp3_sample_rates[1 == ap_hdr->version_ ? 0
+                                             : (2 == ap_hdr->version_ ? 1 : 2)]
+                      [sr_idx];
+  ap_hdr->channels_ = ((p[3] >> 6) == 3) ? 1 : 2;
+
+  if (1 == ap_hdr->layer_)
+    {
+      ap_hdr->samples_ = 384;
+      ap_hdr->frame_size_
+        = (12 * ap_hdr->bitrate_ * 1000 / ap_hdr->sample_rate_ + padding) * 4;
+    }
+  else
+    {
+      ap_hdr->samples_ = (3 == ap_hdr->layer_ && lsf) ? 576 : 1152;
+      ap_hdr->frame_size_
+        = (ap_hdr->samples_ / 8) * ap_hdr->bitrate_ * 1000
+            / ap_hdr->sample_rate_
+          + padding;
+    }
+
+  return true;
+}
+
+static inline bool
+is_compatible_mp3_header (const fr_mp3_header_t * ap_ref,
+                          const fr_mp3_header_t * ap_hdr)
+{
+  return (ap_ref->version_ == ap_hdr->version_
+          && ap_ref->layer_ == ap_hdr->layer_
+          && ap_ref->sample_rate_ == ap_hdr->sample_rate_);
+}
+
+/* Finds the first frame at or after a_offset that is followed by another
+   valid frame header. When ap_ref is not NULL, both frames must be compatible
+   with it. */
+static bool
+find_mp3_frame (const fr_seek_index_t * ap_idx, OMX_U64 a_offset,
+                const OMX_U64 a_max_scan, const fr_mp3_header_t * ap_ref,
+                OMX_U64 * ap_frame_offset, fr_mp3_header_t * ap_hdr)
+{
+  OMX_U8 buf[FR_SEEK_SCAN_CHUNK_SIZE + 4];
+  const OMX_U64 limit = a_offset + a_max_scan;
+  while (a_offset < limit)
+    {
+      const ssize_t n = read_at (ap_idx, buf, sizeof (buf), a_offset);
+      ssize_t i = 0;
+      if (n < 4)
+        {
+          break;
+        }
+      for (i = 0; i + 4 <= n; ++i)
+        {
+          fr_mp3_header_t next;
+          OMX_U8 next_hdr[4];
+          if (buf[i] != 0xFF || !parse_mp3_frame_header (buf + i, ap_hdr)
+              || (ap_ref && !is_compatible_mp3_header (ap_ref, ap_hdr)))
+            {
+              continue;
+            }
+          if (read_at (ap_idx, next_hdr, 4, a_offset + i + ap_hdr->frame_size_)
+                == 4
+              && parse_mp3_frame_header (next_hdr, &next)
+              && is_compatible_mp3_header (ap_hdr, &next))
+            {
+              *ap_frame_offset = a_offset + i;
+              return true;
+            }
+        }
+      a_offset += n - 3;
+    }
+  return false;
+}
+
+static OMX_ERRORTYPE
+probe_vbri (fr_seek_index_t * ap_idx, const OMX_U8 * ap_frame,
+            const OMX_U64 a_frame_offset)
+{
+  const OMX_U8 * p = ap_frame + 4 + 32;
+  OMX_U32 nentries = 0;
+  OMX_U32 scale = 0;
+  OMX_U32 entry_size = 0;
+  OMX_U32 frames_per_entry = 0;
+  OMX_U32 frames = 0;
+  OMX_U8 * p_table = NULL;
+  OMX_U64 offset = 0;
+  OMX_U32 i = 0;
+
+  if (memcmp (p, "VBRI", 4))
+    {
+      return OMX_ErrorNone;
+    }
+
+  ap_idx->audio_size_ = read_be32 (p + 10);
+  frames = read_be32 (p + 14);
+  nentries = read_be16 (p + 18);
+  scale = read_be16 (p + 20);
+  entry_size = read_be16 (p + 22);
+  frames_per_entry = read_be16 (p + 24);
+  ap_idx->total_samples_ = (OMX_U64) frames * ap_idx->mp3_ref_.samples_;
+
+  if (0 == nentries || nentries > FR_SEEK_MP3_MAX_VBRI_ENTRIES
+      || 0 == entry_size || entry_size > 4)
+    {
+      return OMX_ErrorNone;
+    }
+
+  p_table = tiz_mem_alloc (nentries * entry_size);
+  tiz_check_null_ret_oom (p_table);
+  ap_idx->p_points_ = tiz_mem_calloc (nentries + 1, sizeof (fr_seek_point_t));
+  if (!ap_idx->p_points_)
+    {
+      tiz_mem_free (p_table);
+      return OMX_ErrorInsufficientResources;
+    }
+
+  if (read_at (ap_idx, p_table, nentries * entry_size,
+               a_frame_offset + 4 + 32 + 26)
+      == (ssize_t) (nentries * entry_size))
+    {
+      /* The first point is the start of the audio data */
+      ap_idx->npoints_ = 1;
+      for (i = 0; i < nentries; ++i)
+        {
+          OMX_U32 entry = 0;
+          OMX_U32 j = 0;
+          for (j = 0; j < entry_size; ++j)
+            {
+              entry = (entry << 8) | p_table[i * entry_size + j];
+            }
+          offset += (OMX_U64) entry * scale;
+          ap_idx->p_points_[ap_idx->npoints_].sample_
+            = (OMX_U64) (i + 1) * frames_per_entry * ap_idx->mp3_ref_.samples_;
+          ap_idx->p_points_[ap_idx->npoints_].offset_ = offset;
+          ap_idx->npoints_++;
+        }
+    }
+  tiz_mem_free (p_table);
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+probe_mp3 (fr_seek_index_t * ap_idx, const OMX_U64 a_offset)
+{
+  fr_mp3_header_t * p_ref = &(ap_idx->mp3_ref_);
+  OMX_U8 frame[FR_SEEK_PROBE_SIZE];
+  OMX_U64 frame_offset = 0;
+  const OMX_U8 * p_xing = NULL;
+  ssize_t n = 0;
+  assert (ap_idx);
+
+  if (!find_mp3_frame (ap_idx, a_offset, FR_SEEK_MP3_MAX_SYNC_SCAN, NULL,
+                       &frame_offset, p_ref))
+    {
+      return OMX_ErrorNone;
+    }
+
+  ap_idx->format_ = EFrSeekFormatMp3;
+  ap_idx->sample_rate_ = p_ref->sample_rate_;
+  ap_idx->audio_start_ = frame_offset;
+  ap_idx->audio_size_ = ap_idx->file_size_ - frame_offset;
+
+  n = read_at (ap_idx, frame, sizeof (frame), frame_offset);
+  if (n < (ssize_t) p_ref->frame_size_ || p_ref->frame_size_ < 4 + 32 + 26)
+    {
+      return OMX_ErrorNone;
+    }
+
+  /* The Xing/Info header sits right after the side information */
+  p_xing = frame + 4
+           + (1 == p_ref->version_ ? (1 == p_ref->channels_ ? 17 : 32)
+                                   : (1 == p_ref->channels_ ? 9 : 17));
+  if (p_xing + 8 <= frame + p_ref->frame_size_
+      && (!memcmp (p_xing, "Xing", 4) || !memcmp (p_xing, "Info", 4)))
+    {
+      const OMX_U32 flags = read_be32 (p_xing + 4);
+      const OMX_U8 * p = p_xing + 8;
+      if ((flags & 0x01) && p + 4 <= frame + n)
+        {
+          ap_idx->total_samples_ = (OMX_U64) read_be32 (p) * p_ref->samples_;
+          p += 4;
+        }
+      if ((flags & 0x02) && p + 4 <= frame + n)
+        {
+          const OMX_U32 bytes = read_be32 (p);
+          if (bytes > 0 && bytes <= ap_idx->audio_size_)
+            {
+              ap_idx->audio_size_ = bytes;
+            }
+          p += 4;
+        }
+      if ((flags & 0x04) && p + 100 <= frame + n)
+        {
+          memcpy (ap_idx->toc_, p, 100);
+          ap_idx->has_toc_ = true;
+        }
+      return OMX_ErrorNone;
+    }
+
+  return probe_vbri (ap_idx, frame, frame_offset);
+}
+
+static OMX_ERRORTYPE
+lookup_mp3 (fr_seek_index_t * ap_idx, const OMX_TICKS a_target,
+            long * ap_offset, OMX_TICKS * ap_landed)
+{
+  const fr_mp3_header_t * p_ref = &(ap_idx->mp3_ref_);
+  OMX_U64 offset = 0;
+  OMX_U64 frame_offset = 0;
+  OMX_TICKS landed = a_target;
+  fr_mp3_header_t hdr;
+
+  if (ap_idx->has_toc_ && ap_idx->total_samples_ > 0)
+    {
+      /* Xing TOC: 100 entries, one per percent of the duration */
+      const OMX_U64 duration
+        = ap_idx->total_samples_ * 1000000 / ap_idx->sample_rate_;
+      double percent = (double) a_target * 100.0 / (double) duration;
+      int idx = 0;
+      double fa = 0.0, fb = 0.0, fx = 0.0;
+      if (percent > 99.0)
+        {
+          percent = 99.0;
+        }
+      idx = (int) percent;
+      fa = ap_idx->toc_[idx];
+      fb = idx < 99 ? ap_idx->toc_[idx + 1] : 256.0;
+      fx = fa + (fb - fa) * (percent - idx);
+      offset = ap_idx->audio_start_
+               + (OMX_U64) (fx * (double) ap_idx->audio_size_ / 256.0);
+    }
+  else if (ap_idx->npoints_ > 0)
+    {
+      /* VBRI table: interpolate between the two surrounding points */
+      const OMX_U64 target
+        = (OMX_U64) a_target * ap_idx->sample_rate_ / 1000000;
+      OMX_U32 i = 0;
+      while (i + 1 < ap_idx->npoints_
+             && ap_idx->p_points_[i + 1].sample_ <= target)
+        {
+          ++i;
+        }
+      offset = ap_idx->audio_start_ + ap_idx->p_points_[i].offset_;
+      if (i + 1 < ap_idx->npoints_)
+        {
+          const fr_seek_point_t * p_a = &(ap_idx->p_points_[i]);
+          const fr_seek_point_t * p_b = &(ap_idx->p_points_[i + 1]);
+          offset += (p_b->offset_ - p_a->offset_) * (target - p_a->sample_)
+                    / (p_b->sample_ - p_a->sample_);
+        }
+    }
+  else
+    {
+      /* Assume a constant bitrate */
+      offset = ap_idx->audio_start_
+               + (OMX_U64) a_target * p_ref->bitrate_ / 8000;
+      if (offset >= ap_idx->audio_start_ + p_ref->frame_size_)
+        {
+          /* Make it a whole number of frames so that the time is exact */
+          const OMX_U64 nframes
+            = (offset - ap_idx->audio_start_) / p_ref->frame_size_;
+          offset = ap_idx->audio_start_ + nframes * p_ref->frame_size_;
+        }
+    }
+
+  if (offset >= ap_idx->file_size_
+      || !find_mp3_frame (ap_idx, offset, FR_SEEK_MP3_MAX_SYNC_SCAN, p_ref,
+                          &frame_offset, &hdr))
+    {
+      return OMX_ErrorUnsupportedSetting;
+    }
+
+  if (!ap_idx->has_toc_ && 0 == ap_idx->npoints_ && p_ref->bitrate_ > 0)
+    {
+      landed = (OMX_TICKS) ((frame_offset - ap_idx->audio_start_) * 8000
+                            / p_ref->bitrate_);
+    }
+
+  *ap_offset = (long) frame_offset;
+  *ap_landed = landed;
+  return OMX_ErrorNone;
+}
+
+/*
+ * Public functions
+ */
+
+OMX_ERRORTYPE
+fr_seek_index_init (fr_seek_index_t ** app_idx, const int a_fd)
+{
+  fr_seek_index_t * p_idx = NULL;
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  struct stat st;
+  OMX_U8 magic[4];
+  OMX_U64 offset = 0;
+
+  assert (app_idx);
+  assert (a_fd >= 0);
+
+  p_idx = tiz_mem_calloc (1, sizeof (fr_seek_index_t));
+  tiz_check_null_ret_oom (p_idx);
+  p_idx->fd_ = a_fd;
+  p_idx->format_ = EFrSeekFormatUnknown;
+  *app_idx = p_idx;
+
+  if (fstat (a_fd, &st) != 0 || !S_ISREG (st.st_mode))
+    {
+      return OMX_ErrorNone;
+    }
+  p_idx->file_size_ = st.st_size;
+
+  offset = skip_id3v2 (p_idx, 0);
+  if (read_at (p_idx, magic, sizeof (magic), offset) != sizeof (magic))
+    {
+      return OMX_ErrorNone;
+    }
+
+  if (!memcmp (magic, "fLaC", 4))
+    {
+      rc = probe_flac (p_idx, offset);
+    }
+  else if (memcmp (magic, "RIFF", 4) && memcmp (magic, "OggS", 4)
+           && memcmp (magic, "FORM", 4))
+    {
+      /* Anything else that is not a well-known container might be an MP3
+         elementary stream */
+      rc = probe_mp3 (p_idx, offset);
+    }
+
+  if (OMX_ErrorNone != rc)
+    {
+      fr_seek_index_destroy (p_idx);
+      *app_idx = NULL;
+    }
+  return rc;
+}
+
+void
+fr_seek_index_destroy (fr_seek_index_t * ap_idx)
+{
+  if (ap_idx)
+    {
+      tiz_mem_free (ap_idx->p_points_);
+      tiz_mem_free (ap_idx);
+    }
+}
+
+bool
+fr_seek_index_is_seekable (const fr_seek_index_t * ap_idx)
+{
+  return (ap_idx && EFrSeekFormatUnknown != ap_idx->format_);
+}
+
+const char *
+fr_seek_index_format_str (const fr_seek_index_t * ap_idx)
+{
+  if (ap_idx)
+    {
+      switch (ap_idx->format_)
+        {
+          case EFrSeekFormatFlac:
+            return "FLAC";
+          case EFrSeekFormatMp3:
+            return "MP3";
+          default:
+            break;
+        };
+    }
+  return "Unknown";
+}
+
+OMX_ERRORTYPE
+fr_seek_index_lookup (fr_seek_index_t * ap_idx, const OMX_TICKS a_target,
+                      long * ap_offset, OMX_TICKS * ap_landed)
+{
+  assert (ap_offset);
+  assert (ap_landed);
+
+  if (!fr_seek_index_is_seekable (ap_idx) || a_target < 0)
+    {
+      return OMX_ErrorUnsupportedSetting;
+    }
+
+  if (0 == a_target)
+    {
+      /* Always go back to the very first frame */
+      *ap_offset = (long) ap_idx->audio_start_;
+      *ap_landed = 0;
+      return OMX_ErrorNone;
+    }
+
+  return (EFrSeekFormatFlac == ap_idx->format_
+            ? lookup_flac (ap_idx, a_target, ap_offset, ap_landed)
+            : lookup_mp3 (ap_idx, a_target, ap_offset, ap_landed));
+}
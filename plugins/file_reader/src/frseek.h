@@ -0,0 +1,85 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   frseek.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief Tizonia - Binary file reader's time-to-byte seek index
+ *
+ *
+ */
+
+#ifndef FRSEEK_H
+#define FRSEEK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+
+#include <OMX_Core.h>
+#include <OMX_Types.h>
+
+  typedef struct fr_seek_index fr_seek_index_t;
+
+  /**
+   * Probe the file referred to by @a a_fd and create a seek index for it. The
+   * file is only accessed with pread, so the caller's file offset is not
+   * modified. Files in a format that is not supported result in a valid but
+   * non-seekable index.
+   *
+   * @return OMX_ErrorInsufficientResources if OOM, OMX_ErrorNone otherwise.
+   */
+  OMX_ERRORTYPE
+  fr_seek_index_init (fr_seek_index_t ** app_idx, const int a_fd);
+
+  void
+  fr_seek_index_destroy (fr_seek_index_t * ap_idx);
+
+  bool
+  fr_seek_index_is_seekable (const fr_seek_index_t * ap_idx);
+
+  const char *
+  fr_seek_index_format_str (const fr_seek_index_t * ap_idx);
+
+  /**
+   * Find the byte offset of the frame that contains the time position @a
+   * a_target (in microseconds).
+   *
+   * @param ap_offset On success, the offset in the file where reading should
+   * resume.
+   *
+   * @param ap_landed On success, the time position (in microseconds) of the
+   * frame found at @a ap_offset.
+   *
+   * @return OMX_ErrorUnsupportedSetting if the file is not seekable or the
+   * position could not be found.
+   */
+  OMX_ERRORTYPE
+  fr_seek_index_lookup (fr_seek_index_t * ap_idx, const OMX_TICKS a_target,
+                        long * ap_offset, OMX_TICKS * ap_landed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRSEEK_H */
@@ -0,0 +1,512 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_frseek.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  File reader seek index unit tests
+ *
+ * The fixture files are small, synthetic streams: the frame headers and
+ * container metadata are real, the audio payload is silence. They are
+ * written to /tmp before each test.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <check.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <tizplatform.h>
+
+#include "frseek.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.file_reader.check"
+#endif
+
+#define FRSEEK_TEST_TIMEOUT 10
+
+/* MPEG-1 Layer III, 128 kbps, 44.1 kHz, stereo, no padding */
+#define MP3_FRAME_SIZE 417
+#define MP3_FRAME_SAMPLES 1152
+#define MP3_SAMPLE_RATE 44100
+#define MP3_NFRAMES 200
+#define MP3_ID3_SIZE 118 /* tag payload, plus a 10-byte header */
+#define MP3_XING_OFFSET 36 /* after the header and the side info */
+#define MP3_VBRI_FRAMES_PER_ENTRY 20
+
+/* FLAC, fixed 4096-sample blocks, 44.1 kHz, stereo, 16 bits */
+#define FLAC_BLOCKSIZE 4096
+#define FLAC_SAMPLE_RATE 44100
+#define FLAC_FRAME_SIZE 300
+#define FLAC_NFRAMES 300
+#define FLAC_SEEKPOINT_INTERVAL 64 /* in frames */
+
+typedef struct fixture fixture_t;
+struct fixture
+{
+  char path[64];
+  int fd;
+  fr_seek_index_t * p_idx;
+  OMX_U8 * p_data;
+  size_t size;
+  size_t audio_start;
+};
+
+static fixture_t fx;
+
+static void
+put_be16 (OMX_U8 * p, const OMX_U32 v)
+{
+  p[0] = (OMX_U8) (v >> 8);
+  p[1] = (OMX_U8) v;
+}
+
+static void
+put_be24 (OMX_U8 * p, const OMX_U32 v)
+{
+  p[0] = (OMX_U8) (v >> 16);
+  put_be16 (p + 1, v);
+}
+
+static void
+put_be32 (OMX_U8 * p, const OMX_U32 v)
+{
+  put_be16 (p, v >> 16);
+  put_be16 (p + 2, v);
+}
+
+static void
+put_be64 (OMX_U8 * p, const OMX_U64 v)
+{
+  put_be32 (p, (OMX_U32) (v >> 32));
+  put_be32 (p + 4, (OMX_U32) v);
+}
+
+static OMX_U8 *
+fixture_alloc (const size_t a_size)
+{
+  fx.p_data = tiz_mem_calloc (1, a_size);
+  fail_if (NULL == fx.p_data);
+  fx.size = a_size;
+  return fx.p_data;
+}
+
+static void
+fixture_open_index (void)
+{
+  strcpy (fx.path, "/tmp/check_frseek_XXXXXX");
+  fx.fd = mkstemp (fx.path);
+  fail_if (fx.fd < 0);
+  fail_if (write (fx.fd, fx.p_data, fx.size) != (ssize_t) fx.size);
+  fail_if (OMX_ErrorNone != fr_seek_index_init (&(fx.p_idx), fx.fd));
+  fail_if (NULL == fx.p_idx);
+}
+
+static void
+setup (void)
+{
+  memset (&fx, 0, sizeof (fx));
+  fx.fd = -1;
+}
+
+static void
+teardown (void)
+{
+  fr_seek_index_destroy (fx.p_idx);
+  if (fx.fd >= 0)
+    {
+      close (fx.fd);
+      unlink (fx.path);
+    }
+  tiz_mem_free (fx.p_data);
+  memset (&fx, 0, sizeof (fx));
+}
+
+/*
+ * MP3 fixtures
+ */
+
+static OMX_U8 *
+mp3_frame (const int a_frame)
+{
+  return fx.p_data + fx.audio_start + (size_t) a_frame * MP3_FRAME_SIZE;
+}
+
+/* An ID3v2 tag followed by MP3_NFRAMES frames */
+static void
+make_mp3 (void)
+{
+  OMX_U8 * p = fixture_alloc (10 + MP3_ID3_SIZE
+                              + MP3_NFRAMES * MP3_FRAME_SIZE);
+  int i = 0;
+
+  memcpy (p, "ID3", 3);
+  p[3] = 4; /* v2.4 */
+  p[9] = MP3_ID3_SIZE; /* syncsafe size, < 128 */
+  fx.audio_start = 10 + MP3_ID3_SIZE;
+
+  for (i = 0; i < MP3_NFRAMES; ++i)
+    {
+      OMX_U8 * p_frame = mp3_frame (i);
+      p_frame[0] = 0xFF;
+      p_frame[1] = 0xFB; /* MPEG-1, Layer III, no CRC */
+      p_frame[2] = 0x90; /* 128 kbps, 44.1 kHz, no padding */
+      p_frame[3] = 0x00; /* stereo */
+    }
+}
+
+static OMX_TICKS
+mp3_frame_time (const int a_frame)
+{
+  return (OMX_TICKS) a_frame * MP3_FRAME_SAMPLES * 1000000 / MP3_SAMPLE_RATE;
+}
+
+static void
+assert_mp3_frame_boundary (const long a_offset)
+{
+  fail_if (a_offset < (long) fx.audio_start);
+  fail_if ((a_offset - (long) fx.audio_start) % MP3_FRAME_SIZE != 0);
+}
+
+START_TEST (test_frseek_mp3_cbr)
+{
+  const OMX_TICKS target = 2000000;
+  long offset = 0;
+  OMX_TICKS landed = 0;
+
+  make_mp3 ();
+  fixture_open_index ();
+
+  fail_if (!fr_seek_index_is_seekable (fx.p_idx));
+  fail_if (0 != strcmp ("MP3", fr_seek_index_format_str (fx.p_idx)));
+
+  /* The ID3v2 tag is skipped */
+  fail_if (OMX_ErrorNone
+           != fr_seek_index_lookup (fx.p_idx, 0, &offset, &landed));
+  fail_if (offset != (long) fx.audio_start);
+  fail_if (landed != 0);
+
+  /* The bitrate estimate is rounded down to a whole frame */
+  fail_if (OMX_ErrorNone
+           != fr_seek_index_lookup (fx.p_idx, target, &offset, &landed));
+  assert_mp3_frame_boundary (offset);
+  fail_if (offset
+           != (long) (fx.audio_start
+                      + (target * 128 / 8000) / MP3_FRAME_SIZE
+                          * MP3_FRAME_SIZE));
+  fail_if (landed > target);
+  fail_if (target - landed > mp3_frame_time (1));
+
+  /* Past the end of the file */
+  fail_if (OMX_ErrorUnsupportedSetting
+           != fr_seek_index_lookup (fx.p_idx, mp3_frame_time (MP3_NFRAMES * 2),
+                                    &offset, &landed));
+}
+END_TEST
+
+START_TEST (test_frseek_mp3_xing_toc)
+{
+  const OMX_U32 audio_size = MP3_NFRAMES * MP3_FRAME_SIZE;
+  const OMX_TICKS duration = mp3_frame_time (MP3_NFRAMES);
+  OMX_U8 * p_xing = NULL;
+  long offset = 0;
+  OMX_TICKS landed = 0;
+  int i = 0;
+
+  make_mp3 ();
+  p_xing = mp3_frame (0) + MP3_XING_OFFSET;
+  memcpy (p_xing, "Xing", 4);
+  put_be32 (p_xing + 4, 0x07); /* frames, bytes and TOC */
+  put_be32 (p_xing + 8, MP3_NFRAMES);
+  put_be32 (p_xing + 12, audio_size);
+  /* A TOC that does not match the constant bitrate, so that the test can
+     tell whether it is used: x percent of the time is at (x/100)^2 of the
+     bytes */
+  for (i = 0; i < 100; ++i)
+    {
+      p_xing[16 + i] = (OMX_U8) (i * i * 256 / 10000);
+    }
+  fixture_open_index ();
+
+  fail_if (!fr_seek_index_is_seekable (fx.p_idx));
+
+  /* Half-way through the duration is a quarter into the data */
+  fail_if (OMX_ErrorNone
+           != fr_seek_index_lookup (fx.p_idx, duration / 2, &offset, &landed));
+  assert_mp3_frame_boundary (offset);
+  fail_if (offset < (long) (fx.audio_start + audio_size / 4));
+  fail_if (offset >= (long) (fx.audio_start + audio_size / 4 + MP3_FRAME_SIZE));
+  fail_if (landed != duration / 2);
+}
+END_TEST
+
+START_TEST (test_frseek_mp3_vbri)
+{
+  const int nentries = MP3_NFRAMES / MP3_VBRI_FRAMES_PER_ENTRY;
+  const int frame = 50;
+  OMX_U8 * p_vbri = NULL;
+  long offset = 0;
+  OMX_TICKS landed = 0;
+  int i = 0;
+
+  make_mp3 ();
+  p_vbri = mp3_frame (0) + MP3_XING_OFFSET;
+  memcpy (p_vbri, "VBRI", 4);
+  put_be16 (p_vbri + 4, 1); /* version */
+  put_be32 (p_vbri + 10, MP3_NFRAMES * MP3_FRAME_SIZE);
+  put_be32 (p_vbri + 14, MP3_NFRAMES);
+  put_be16 (p_vbri + 18, nentries);
+  put_be16 (p_vbri + 20, 1); /* scale */
+  put_be16 (p_vbri + 22, 2); /* entry size */
+  put_be16 (p_vbri + 24, MP3_VBRI_FRAMES_PER_ENTRY);
+  for (i = 0; i < nentries; ++i)
+    {
+      put_be16 (p_vbri + 26 + i * 2,
+                MP3_VBRI_FRAMES_PER_ENTRY * MP3_FRAME_SIZE);
+    }
+  fixture_open_index ();
+
+  fail_if (!fr_seek_index_is_seekable (fx.p_idx));
+
+  /* Interpolated between the 2nd and 3rd table entries */
+  fail_if (OMX_ErrorNone
+           != fr_seek_index_lookup (fx.p_idx, mp3_frame_time (frame), &offset,
+                                    &landed));
+  fail_if (offset != (long) (fx.audio_start + frame * MP3_FRAME_SIZE));
+  fail_if (landed != mp3_frame_time (frame));
+}
+END_TEST
+
+/*
+ * FLAC fixtures
+ */
+
+static OMX_U8
+crc8 (const OMX_U8 * ap_data, size_t a_len)
+{
+  OMX_U8 crc = 0;
+  while (a_len--)
+    {
+      int i = 0;
+      crc ^= *ap_data++;
+      for (i = 0; i < 8; ++i)
+        {
+          crc = (crc & 0x80) ? (OMX_U8) ((crc << 1) ^ 0x07)
+                             : (OMX_U8) (crc << 1);
+        }
+    }
+  return crc;
+}
+
+static void
+put_flac_frame_header (OMX_U8 * p, const OMX_U32 a_frame)
+{
+  size_t len = 4;
+  p[0] = 0xFF;
+  p[1] = 0xF8; /* fixed blocksize */
+  p[2] = 0xC9; /* 4096 samples, 44.1 kHz */
+  p[3] = 0x18; /* stereo, 16 bits */
+  /* UTF-8-like coded frame number */
+  if (a_frame < 0x80)
+    {
+      p[len++] = (OMX_U8) a_frame;
+    }
+  else
+    {
+      assert (a_frame < 0x800);
+      p[len++] = (OMX_U8) (0xC0 | (a_frame >> 6));
+      p[len++] = (OMX_U8) (0x80 | (a_frame & 0x3F));
+    }
+  p[len] = crc8 (p, len);
+}
+
+/* STREAMINFO, an optional SEEKTABLE and FLAC_NFRAMES frames */
+static void
+make_flac (const bool a_with_seektable)
+{
+  const int npoints = FLAC_NFRAMES / FLAC_SEEKPOINT_INTERVAL;
+  const size_t seektable_size = a_with_seektable ? 4 + npoints * 18 : 0;
+  const OMX_U64 total_samples = (OMX_U64) FLAC_NFRAMES * FLAC_BLOCKSIZE;
+  OMX_U8 * p = NULL;
+  OMX_U8 * p_si = NULL;
+  int i = 0;
+
+  fx.audio_start = 4 + 4 + 34 + seektable_size;
+  p = fixture_alloc (fx.audio_start + FLAC_NFRAMES * FLAC_FRAME_SIZE);
+
+  memcpy (p, "fLaC", 4);
+  p[4] = a_with_seektable ? 0x00 : 0x80; /* STREAMINFO, last? */
+  put_be24 (p + 5, 34);
+  p_si = p + 8;
+  put_be16 (p_si, FLAC_BLOCKSIZE);
+  put_be16 (p_si + 2, FLAC_BLOCKSIZE);
+  /* 20-bit sample rate, 3-bit channels - 1, 5-bit bps - 1, 36-bit total */
+  put_be24 (p_si + 10, (FLAC_SAMPLE_RATE << 4) | (1 << 1));
+  p_si[13] = (OMX_U8) ((15 << 4) | ((total_samples >> 32) & 0x0F));
+  put_be32 (p_si + 14, (OMX_U32) total_samples);
+
+  if (a_with_seektable)
+    {
+      OMX_U8 * p_st = p + 8 + 34;
+      p_st[0] = 0x83; /* SEEKTABLE, last */
+      put_be24 (p_st + 1, npoints * 18);
+      for (i = 0; i < npoints; ++i)
+        {
+          const OMX_U32 frame = i * FLAC_SEEKPOINT_INTERVAL;
+          OMX_U8 * p_point = p_st + 4 + i * 18;
+          put_be64 (p_point, (OMX_U64) frame * FLAC_BLOCKSIZE);
+          put_be64 (p_point + 8, (OMX_U64) frame * FLAC_FRAME_SIZE);
+          put_be16 (p_point + 16, FLAC_BLOCKSIZE);
+        }
+    }
+
+  for (i = 0; i < FLAC_NFRAMES; ++i)
+    {
+      put_flac_frame_header (p + fx.audio_start + i * FLAC_FRAME_SIZE, i);
+    }
+}
+
+static OMX_TICKS
+flac_frame_time (const int a_frame)
+{
+  return (OMX_TICKS) a_frame * FLAC_BLOCKSIZE * 1000000 / FLAC_SAMPLE_RATE;
+}
+
+static void
+check_flac_lookups (void)
+{
+  /* Includes frames whose numbers are coded in more than one byte, and a
+     target right at the beginning of a frame */
+  const int frames[] = {1, 10, 63, 64, 65, 127, 128, 200, FLAC_NFRAMES - 1};
+  size_t i = 0;
+
+  fail_if (!fr_seek_index_is_seekable (fx.p_idx));
+  fail_if (0 != strcmp ("FLAC", fr_seek_index_format_str (fx.p_idx)));
+
+  for (i = 0; i < sizeof (frames) / sizeof (frames[0]); ++i)
+    {
+      const int frame = frames[i];
+      const OMX_TICKS starts[] = {flac_frame_time (frame) + 1,
+                                  (flac_frame_time (frame)
+                                   + flac_frame_time (frame + 1))
+                                    / 2};
+      size_t j = 0;
+      for (j = 0; j < sizeof (starts) / sizeof (starts[0]); ++j)
+        {
+          long offset = 0;
+          OMX_TICKS landed = 0;
+          fail_if (OMX_ErrorNone
+                   != fr_seek_index_lookup (fx.p_idx, starts[j], &offset,
+                                            &landed));
+          TIZ_LOG (TIZ_PRIORITY_TRACE,
+                   "target [%lld] us : offset [%ld] landed [%lld] us",
+                   (long long) starts[j], offset, (long long) landed);
+          ck_assert_int_eq (offset,
+                            (long) (fx.audio_start + frame * FLAC_FRAME_SIZE));
+          ck_assert_int_eq (landed, flac_frame_time (frame));
+        }
+    }
+}
+
+START_TEST (test_frseek_flac_seektable)
+{
+  make_flac (true);
+  fixture_open_index ();
+  check_flac_lookups ();
+}
+END_TEST
+
+START_TEST (test_frseek_flac_bisection)
+{
+  make_flac (false);
+  fixture_open_index ();
+  check_flac_lookups ();
+}
+END_TEST
+
+START_TEST (test_frseek_unsupported)
+{
+  long offset = 0;
+  OMX_TICKS landed = 0;
+  OMX_U8 * p = fixture_alloc (4096);
+  memcpy (p, "OggS", 4);
+  fixture_open_index ();
+
+  fail_if (fr_seek_index_is_seekable (fx.p_idx));
+  fail_if (0 != strcmp ("Unknown", fr_seek_index_format_str (fx.p_idx)));
+  fail_if (OMX_ErrorUnsupportedSetting
+           != fr_seek_index_lookup (fx.p_idx, 0, &offset, &landed));
+}
+END_TEST
+
+Suite *
+frseek_suite (void)
+{
+  TCase * tc_frseek;
+  Suite * s = suite_create ("file reader seek index");
+
+  tc_frseek = tcase_create ("seek index");
+  tcase_set_timeout (tc_frseek, FRSEEK_TEST_TIMEOUT);
+  tcase_add_checked_fixture (tc_frseek, setup, teardown);
+  tcase_add_test (tc_frseek, test_frseek_mp3_cbr);
+  tcase_add_test (tc_frseek, test_frseek_mp3_xing_toc);
+  tcase_add_test (tc_frseek, test_frseek_mp3_vbri);
+  tcase_add_test (tc_frseek, test_frseek_flac_seektable);
+  tcase_add_test (tc_frseek, test_frseek_flac_bisection);
+  tcase_add_test (tc_frseek, test_frseek_unsupported);
+  suite_add_tcase (s, tc_frseek);
+
+  return s;
+}
+
+int
+main (void)
+{
+  int number_failed = 1;
+  SRunner * sr = NULL;
+
+  tiz_log_init ();
+
+  sr = srunner_create (frseek_suite ());
+  srunner_set_log (sr, "-");
+  srunner_run_all (sr, CK_VERBOSE);
+  number_failed = srunner_ntests_failed (sr);
+  srunner_free (sr);
+
+  tiz_log_deinit ();
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Local Variables: */
+/* c-default-style: gnu */
+/* fill-column: 79 */
+/* indent-tabs-mode: nil */
+/* compile-command: "make check" */
+/* End: */
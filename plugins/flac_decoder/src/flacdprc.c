@@ -741,6 +741,35 @@ flacd_prc_buffers_ready (const void * ap_obj)
   return transform_stream (ap_obj);
 }
 
+static OMX_ERRORTYPE
+flacd_prc_port_flush (const void * ap_obj, OMX_U32 a_pid)
+{
+  flacd_prc_t * p_prc = (flacd_prc_t *) ap_obj;
+  assert (p_prc);
+
+  if (ARATELIA_FLAC_DECODER_INPUT_PORT_INDEX == a_pid || OMX_ALL == a_pid)
+    {
+      /* The upstream component may have repositioned the stream (e.g. a seek
+         request); drop any encoded data still held and make the decoder look
+         for the next frame sync. Only do this once the metadata has been
+         processed, otherwise the STREAMINFO block would be skipped. */
+      p_prc->store_offset_ = 0;
+      p_prc->eos_ = false;
+      if (p_prc->p_flac_dec_)
+        {
+          const FLAC__StreamDecoderState state
+            = FLAC__stream_decoder_get_state (p_prc->p_flac_dec_);
+          if (FLAC__STREAM_DECODER_SEARCH_FOR_FRAME_SYNC == state
+              || FLAC__STREAM_DECODER_READ_FRAME == state
+              || FLAC__STREAM_DECODER_END_OF_STREAM == state)
+            {
+              (void) FLAC__stream_decoder_flush (p_prc->p_flac_dec_);
+            }
+        }
+    }
+  return release_all_headers (p_prc, a_pid);
+}
+
 /*
  * flacd_prc_class
  */
@@ -791,6 +820,8 @@ flacd_prc_init (void * ap_tos, void * ap_hdl)
      /* TIZ_CLASS_COMMENT: */
      tiz_prc_buffers_ready, flacd_prc_buffers_ready,
      /* TIZ_CLASS_COMMENT: */
+     tiz_prc_port_flush, flacd_prc_port_flush,
+     /* TIZ_CLASS_COMMENT: */
      tiz_srv_allocate_resources, flacd_prc_allocate_resources,
      /* TIZ_CLASS_COMMENT: */
      tiz_srv_deallocate_resources, flacd_prc_deallocate_resources,
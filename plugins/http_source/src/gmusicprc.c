@@ -297,68 +297,59 @@ delete_uri (gmusic_prc_t * ap_prc)
 static OMX_ERRORTYPE
 update_metadata (gmusic_prc_t * ap_prc)
 {
+  tiz_gmusic_metadata_t md;
   assert (ap_prc);
 
+  /* The metadata is retrieved by libtizgmusic in the background once the
+     queue moves. Until it is ready, the previous song's metadata is kept and
+     this is tried again when the next chunk of data arrives. */
+  if (!ap_prc->metadata_pending_
+      || 0 != tiz_gmusic_get_current_song_metadata (ap_prc->p_gmusic_, &md))
+    {
+      return OMX_ErrorNone;
+    }
+
+  ap_prc->metadata_pending_ = false;
+
   /* Clear previous metatada items */
   tiz_krn_clear_metadata (tiz_get_krn (handleOf (ap_prc)));
 
   /* Artist and song title */
-  tiz_check_omx (store_metadata (
-    ap_prc, tiz_gmusic_get_current_song_artist (ap_prc->p_gmusic_),
-    tiz_gmusic_get_current_song_title (ap_prc->p_gmusic_)));
+  tiz_check_omx (store_metadata (ap_prc, md.p_artist, md.p_title));
 
   /* Album */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Album", tiz_gmusic_get_current_song_album (ap_prc->p_gmusic_)));
+  tiz_check_omx (store_metadata (ap_prc, "Album", md.p_album));
 
   /* Store the genre if not NULL */
-  {
-    const char * p_genre
-      = tiz_gmusic_get_current_song_genre (ap_prc->p_gmusic_);
-    if (p_genre)
-      {
-        tiz_check_omx (store_metadata (ap_prc, "Genre", p_genre));
-      }
-  }
+  if (md.p_genre)
+    {
+      tiz_check_omx (store_metadata (ap_prc, "Genre", md.p_genre));
+    }
 
   /* Store the year if not 0 */
-  {
-    const char * p_year = tiz_gmusic_get_current_song_year (ap_prc->p_gmusic_);
-    if (p_year && strncmp (p_year, "0", 4) != 0)
-      {
-        tiz_check_omx (store_metadata (ap_prc, "Year", p_year));
-      }
-  }
+  if (md.p_year && strncmp (md.p_year, "0", 4) != 0)
+    {
+      tiz_check_omx (store_metadata (ap_prc, "Year", md.p_year));
+    }
 
   /* Song duration */
-  tiz_check_omx (
-    store_metadata (ap_prc, "Duration",
-                    tiz_gmusic_get_current_song_duration (ap_prc->p_gmusic_)));
+  tiz_check_omx (store_metadata (ap_prc, "Duration", md.p_duration));
 
   /* Track number */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Track #",
-    tiz_gmusic_get_current_song_track_number (ap_prc->p_gmusic_)));
+  tiz_check_omx (store_metadata (ap_prc, "Track #", md.p_track_number));
 
   /* Store total tracks if not 0 */
-  {
-    const char * p_total_tracks
-      = tiz_gmusic_get_current_song_tracks_in_album (ap_prc->p_gmusic_);
-    if (p_total_tracks && strncmp (p_total_tracks, "0", 2) != 0)
-      {
-        tiz_check_omx (store_metadata (ap_prc, "Total tracks", p_total_tracks));
-      }
-  }
+  if (md.p_tracks_in_album && strncmp (md.p_tracks_in_album, "0", 2) != 0)
+    {
+      tiz_check_omx (
+        store_metadata (ap_prc, "Total tracks", md.p_tracks_in_album));
+    }
 
   /* Store album art if not NULL */
-  {
-    const char * p_album_art
-      = tiz_gmusic_get_current_song_album_art (ap_prc->p_gmusic_);
-    if (p_album_art)
-      {
-        tiz_check_omx (store_metadata (ap_prc, "Album art", p_album_art));
-      }
-  }
+  if (md.p_album_art)
+    {
+      tiz_check_omx (store_metadata (ap_prc, "Album art", md.p_album_art));
+    }
 
   /* Signal that a new set of metatadata items is available */
   (void) tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventIndexSettingChanged,
@@ -414,7 +405,9 @@ obtain_next_url (gmusic_prc_t * ap_prc, int a_skip_value)
                    url_len);
           ap_prc->p_uri_param_->contentURI[url_len] = '\0';
 
-          /* Song metadata is now available, update the IL client */
+          /* Song metadata is on its way; the IL client is updated as soon
+             as it is available */
+          ap_prc->metadata_pending_ = true;
           rc = update_metadata (ap_prc);
         }
     }
@@ -524,6 +517,8 @@ data_available (OMX_PTR ap_arg, const void * ap_ptr, const size_t a_nbytes)
   assert (p_prc);
   assert (ap_ptr);
 
+  (void) update_metadata (p_prc);
+
   if (p_prc->auto_detect_on_ && a_nbytes > 0)
     {
       p_prc->auto_detect_on_ = false;
@@ -717,6 +712,7 @@ gmusic_prc_ctor (void * ap_obj, va_list * app)
   p_prc->buffer_bytes_ = ((p_prc->bitrate_ * 1000) / 8)
                          * ARATELIA_HTTP_SOURCE_DEFAULT_BUFFER_SECONDS_GMUSIC;
   p_prc->connection_closed_ = false;
+  p_prc->metadata_pending_ = false;
   return p_prc;
 }
 
@@ -67,6 +67,7 @@ extern "C"
     int bitrate_;
     int buffer_bytes_;
     bool connection_closed_;
+    bool metadata_pending_;
   };
 
   typedef struct gmusic_prc_class gmusic_prc_class_t;
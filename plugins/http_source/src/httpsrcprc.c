@@ -114,12 +114,6 @@ identify_ogg_codec (httpsrc_prc_t * ap_prc, unsigned char * ap_data, long a_len)
   return rc;
 }
 
-static inline bool
-is_valid_character (const char c)
-{
-  return (unsigned char) c > 0x20;
-}
-
 static void
 obtain_coding_type (httpsrc_prc_t * ap_prc, char * ap_info)
 {
@@ -240,16 +234,18 @@ obtain_audio_info (httpsrc_prc_t * ap_prc, char * ap_info)
 }
 
 static void
-obtain_bit_rate (httpsrc_prc_t * ap_prc, char * ap_info)
+obtain_bit_rate (httpsrc_prc_t * ap_prc, const tiz_http_header_t * ap_hdr)
 {
-  char * p_end = NULL;
+  const long bitrate = tiz_http_header_int (ap_hdr);
 
   assert (ap_prc);
-  assert (ap_info);
 
-  TIZ_TRACE (handleOf (ap_prc), "bit rate  : [%s]", ap_info);
+  TIZ_TRACE (handleOf (ap_prc), "bit rate  : [%ld]", bitrate);
 
-  ap_prc->bitrate_ = convert_str_to_int (ap_prc, ap_info, &p_end);
+  if (bitrate > 0)
+    {
+      ap_prc->bitrate_ = bitrate;
+    }
 }
 
 static OMX_ERRORTYPE
@@ -442,69 +438,114 @@ store_metadata (httpsrc_prc_t * ap_prc, const char * ap_header_name,
   return rc;
 }
 
+static void
+cache_header (httpsrc_prc_t * ap_prc, const char * ap_name,
+              const char * ap_info)
+{
+  assert (ap_prc);
+  if (ap_prc->p_headers_)
+    {
+      (void) tiz_buffer_push (ap_prc->p_headers_, ap_name,
+                              strlen (ap_name) + 1);
+      (void) tiz_buffer_push (ap_prc->p_headers_, ap_info,
+                              strlen (ap_info) + 1);
+    }
+}
+
 static void
 obtain_audio_encoding_from_headers (httpsrc_prc_t * ap_prc,
                                     const char * ap_header, const size_t a_size)
 {
+  tiz_http_header_t hdr;
+  char name[64];
+  char * p_info = NULL;
+
   assert (ap_prc);
   assert (ap_header);
-  {
-    const char * p_end = ap_header + a_size;
-    const char * p_value = (const char *) memchr (ap_header, ':', a_size);
-    char name[64];
 
-    if (p_value && (size_t) (p_value - ap_header) < sizeof (name))
-      {
-        memcpy (name, ap_header, p_value - ap_header);
-        name[p_value - ap_header] = 0;
+  if (!tiz_http_header_parse (ap_header, a_size, &hdr))
+    {
+      /* A new response (e.g. after a redirection) replaces the headers seen
+         so far */
+      if (ap_prc->p_headers_)
+        {
+          tiz_buffer_clear (ap_prc->p_headers_);
+        }
+      return;
+    }
+
+  if (hdr.name_len >= sizeof (name)
+      || !(p_info = tiz_mem_calloc (1, hdr.value_len + 1)))
+    {
+      return;
+    }
 
-        /* skip the colon */
-        ++p_value;
+  memcpy (name, hdr.p_name, hdr.name_len);
+  name[hdr.name_len] = '\0';
+  (void) tiz_http_header_value (&hdr, p_info, hdr.value_len + 1);
 
-        /* strip the value */
-        while (p_value < p_end && !is_valid_character (*p_value))
-          {
-            ++p_value;
-          }
+  TIZ_TRACE (handleOf (ap_prc), "header name  : [%s]", name);
+  TIZ_TRACE (handleOf (ap_prc), "header value : [%s]", p_info);
 
-        while (p_end > p_value && !is_valid_character (p_end[-1]))
-          {
-            --p_end;
-          }
+  (void) store_metadata (ap_prc, name, p_info);
+  cache_header (ap_prc, name, p_info);
 
-        {
-          char * p_info = tiz_mem_calloc (1, (p_end - p_value) + 1);
-          memcpy (p_info, p_value, p_end - p_value);
-          p_info[(p_end - p_value)] = '\0';
-          TIZ_TRACE (handleOf (ap_prc), "header name  : [%s]", name);
-          TIZ_TRACE (handleOf (ap_prc), "header value : [%s]", p_info);
+  if (tiz_http_header_is (&hdr, "content-type"))
+    {
+      obtain_coding_type (ap_prc, p_info);
+      /* Now set the new coding type value on the output port */
+      (void) set_audio_coding_on_port (ap_prc);
+    }
+  else if (tiz_http_header_is (&hdr, "ice-audio-info"))
+    {
+      obtain_audio_info (ap_prc, p_info);
+      /* Now set the pcm info on the output port */
+      (void) set_audio_info_on_port (ap_prc);
+      /* Sometimes, the bitrate is provided in the ice-audio-info
+         header */
+      update_cache_size (ap_prc);
+    }
+  else if (tiz_http_header_is (&hdr, "icy-br"))
+    {
+      obtain_bit_rate (ap_prc, &hdr);
+      update_cache_size (ap_prc);
+    }
+  tiz_mem_free (p_info);
+}
 
-          (void) store_metadata (ap_prc, name, p_info);
+static OMX_ERRORTYPE
+update_stream_title (httpsrc_prc_t * ap_prc, const char * ap_title)
+{
+  assert (ap_prc);
+  assert (ap_title);
 
-          if (strncasecmp (name, "content-type", 12) == 0)
-            {
-              obtain_coding_type (ap_prc, p_info);
-              /* Now set the new coding type value on the output port */
-              (void) set_audio_coding_on_port (ap_prc);
-            }
-          else if (strncasecmp (name, "ice-audio-info", 14) == 0)
-            {
-              obtain_audio_info (ap_prc, p_info);
-              /* Now set the pcm info on the output port */
-              (void) set_audio_info_on_port (ap_prc);
-              /* Sometimes, the bitrate is provided in the ice-audio-info
-                       header */
-              update_cache_size (ap_prc);
-            }
-          else if (strncasecmp (name, "icy-br", 6) == 0)
-            {
-              obtain_bit_rate (ap_prc, p_info);
-              update_cache_size (ap_prc);
-            }
-          tiz_mem_free (p_info);
+  /* The metadata list is append-only; rebuild it so that titles don't
+     accumulate over a long-running stream */
+  tiz_krn_clear_metadata (tiz_get_krn (handleOf (ap_prc)));
+
+  if (ap_prc->p_headers_)
+    {
+      const char * p_next = tiz_buffer_get (ap_prc->p_headers_);
+      const char * p_end = p_next + tiz_buffer_available (ap_prc->p_headers_);
+      while (p_next < p_end)
+        {
+          const char * p_name = p_next;
+          const char * p_info = p_name + strlen (p_name) + 1;
+          p_next = p_info + strlen (p_info) + 1;
+          tiz_check_omx (store_metadata (ap_prc, p_name, p_info));
         }
-      }
-  }
+    }
+
+  tiz_check_omx (store_metadata (ap_prc, "Title", ap_title));
+
+  /* Signal that a new set of metatadata items is available */
+  (void) tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventIndexSettingChanged,
+                              OMX_ALL, /* no particular port associated */
+                              OMX_IndexConfigMetadataItem, /* index of the
+                                                             struct that has
+                                                             been modififed */
+                              NULL);
+  return OMX_ErrorNone;
 }
 
 static void
@@ -711,6 +752,16 @@ connection_lost (OMX_PTR ap_arg)
   return true;
 }
 
+static void
+stream_title_available (OMX_PTR ap_arg, const char * ap_title)
+{
+  httpsrc_prc_t * p_prc = ap_arg;
+  assert (p_prc);
+  assert (ap_title);
+  TIZ_NOTICE (handleOf (p_prc), "Stream title [%s]", ap_title);
+  (void) update_stream_title (p_prc, ap_title);
+}
+
 static OMX_ERRORTYPE
 prepare_for_port_auto_detection (httpsrc_prc_t * ap_prc)
 {
@@ -753,6 +804,7 @@ httpsrc_prc_ctor (void * ap_obj, va_list * app)
   p_prc->bitrate_ = ARATELIA_HTTP_SOURCE_DEFAULT_BIT_RATE_KBITS;
   p_prc->connection_closed_ = false;
   p_prc->first_buffer_delivered_ = false;
+  p_prc->p_headers_ = NULL;
   update_cache_size (p_prc);
   return p_prc;
 }
@@ -781,7 +833,8 @@ httpsrc_prc_allocate_resources (void * ap_obj, OMX_U32 a_pid)
     const tiz_urltrans_buffer_cbacks_t buffer_cbacks
       = {buffer_filled, buffer_emptied};
     const tiz_urltrans_info_cbacks_t info_cbacks
-      = {header_available, data_available, connection_lost};
+      = {header_available, data_available, connection_lost,
+         stream_title_available};
     const tiz_urltrans_event_io_cbacks_t io_cbacks
       = {tiz_srv_io_watcher_init, tiz_srv_io_watcher_destroy,
          tiz_srv_io_watcher_start, tiz_srv_io_watcher_stop};
@@ -796,6 +849,16 @@ httpsrc_prc_allocate_resources (void * ap_obj, OMX_U32 a_pid)
                            ARATELIA_HTTP_SOURCE_DEFAULT_RECONNECT_TIMEOUT,
                            buffer_cbacks, info_cbacks, io_cbacks, timer_cbacks);
   }
+  if (OMX_ErrorNone == rc)
+    {
+      /* Icecast/Shoutcast servers interleave the stream titles with the
+         audio data, if asked to */
+      rc = tiz_urltrans_request_icy_metadata (p_prc->p_trans_, true);
+    }
+  if (OMX_ErrorNone == rc)
+    {
+      rc = tiz_buffer_init (&(p_prc->p_headers_), 1024);
+    }
   return rc;
 }
 
@@ -806,6 +869,8 @@ httpsrc_prc_deallocate_resources (void * ap_prc)
   assert (p_prc);
   tiz_urltrans_destroy (p_prc->p_trans_);
   p_prc->p_trans_ = NULL;
+  tiz_buffer_destroy (p_prc->p_headers_);
+  p_prc->p_headers_ = NULL;
   delete_uri (p_prc);
   return OMX_ErrorNone;
 }
@@ -59,6 +59,7 @@ extern "C"
     int buffer_bytes_;
     bool connection_closed_;
     bool first_buffer_delivered_;
+    tiz_buffer_t * p_headers_; /* "name\0value\0" pairs, for metadata */
   };
 
   typedef struct httpsrc_prc_class httpsrc_prc_class_t;
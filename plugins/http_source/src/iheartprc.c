@@ -328,8 +328,20 @@ delete_uri (iheart_prc_t * ap_prc)
 static OMX_ERRORTYPE
 update_metadata (iheart_prc_t * ap_prc)
 {
+  tiz_iheart_metadata_t md;
   assert (ap_prc);
 
+  /* The metadata is retrieved by libtiziheart in the background once the
+     queue moves. Until it is ready, the previous station's metadata is kept and
+     this is tried again when the next chunk of data arrives. */
+  if (!ap_prc->metadata_pending_
+      || 0 != tiz_iheart_get_current_radio_metadata (ap_prc->p_iheart_, &md))
+    {
+      return OMX_ErrorNone;
+    }
+
+  ap_prc->metadata_pending_ = false;
+
   /* Clear previous metatada items */
   tiz_krn_clear_metadata (tiz_get_krn (handleOf (ap_prc)));
 
@@ -337,45 +349,33 @@ update_metadata (iheart_prc_t * ap_prc)
   {
     char name_str[IHEARTSRC_MAX_STRING_SIZE];
     snprintf (name_str, IHEARTSRC_MAX_STRING_SIZE - 1, "%s  (%s)",
-              tiz_iheart_get_current_radio_name (ap_prc->p_iheart_),
-              tiz_iheart_get_current_queue_progress (ap_prc->p_iheart_));
+              md.p_name, md.p_queue_progress);
 
     tiz_check_omx (store_metadata (ap_prc, "Station", name_str));
   }
 
   /* Station Description */
-  tiz_check_omx (
-    store_metadata (ap_prc, "Description",
-                    tiz_iheart_get_current_radio_description (ap_prc->p_iheart_)));
+  tiz_check_omx (store_metadata (ap_prc, "Description", md.p_description));
 
   /* City */
-  tiz_check_omx (
-    store_metadata (ap_prc, "City",
-                    tiz_iheart_get_current_radio_city (ap_prc->p_iheart_)));
+  tiz_check_omx (store_metadata (ap_prc, "City", md.p_city));
 
   /* State */
-  tiz_check_omx (
-    store_metadata (ap_prc, "State",
-                    tiz_iheart_get_current_radio_state (ap_prc->p_iheart_)));
+  tiz_check_omx (store_metadata (ap_prc, "State", md.p_state));
 
   /* Audio Encoding */
-  tiz_check_omx (
-    store_metadata (ap_prc, "Encoding",
-                    tiz_iheart_get_current_radio_audio_encoding (ap_prc->p_iheart_)));
+  tiz_check_omx (store_metadata (ap_prc, "Encoding", md.p_audio_encoding));
 
   /* Website */
-  tiz_check_omx (
-    store_metadata (ap_prc, "Website",
-                    tiz_iheart_get_current_radio_website_url (ap_prc->p_iheart_)));
+  tiz_check_omx (store_metadata (ap_prc, "Website", md.p_website_url));
 
   /* Streaming URL */
   tiz_check_omx (store_metadata (
     ap_prc, "Streaming URL", (const char *) ap_prc->p_uri_param_->contentURI));
 
   /* Thumbnail */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Thumbnail URL",
-    tiz_iheart_get_current_radio_thumbnail_url (ap_prc->p_iheart_)));
+  tiz_check_omx (
+    store_metadata (ap_prc, "Thumbnail URL", md.p_thumbnail_url));
 
   /* Signal that a new set of metatadata items is available */
   (void) tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventIndexSettingChanged,
@@ -457,7 +457,9 @@ obtain_next_url (iheart_prc_t * ap_prc, int a_skip_value,
                    url_len);
           ap_prc->p_uri_param_->contentURI[url_len] = '\0';
 
-          /* Song metadata is now available, update the IL client */
+          /* Song metadata is on its way; the IL client is updated as soon
+             as it is available */
+          ap_prc->metadata_pending_ = true;
           rc = update_metadata (ap_prc);
         }
     }
@@ -558,6 +560,8 @@ data_available (OMX_PTR ap_arg, const void * ap_ptr, const size_t a_nbytes)
   TIZ_DEBUG (handleOf (p_prc), "p_prc->auto_detect_on_ [%s]",
              (p_prc->auto_detect_on_ ? "TRUE" : "FALSE"));
 
+  (void) update_metadata (p_prc);
+
   if (p_prc->auto_detect_on_ && a_nbytes > 0)
     {
       p_prc->auto_detect_on_ = false;
@@ -720,6 +724,7 @@ iheart_prc_ctor (void * ap_obj, va_list * app)
   p_prc->remove_current_url_ = false;
   p_prc->connection_closed_ = false;
   p_prc->first_buffer_delivered_ = false;
+  p_prc->metadata_pending_ = false;
   return p_prc;
 }
 
@@ -67,6 +67,7 @@ struct iheart_prc
   bool remove_current_url_;
   bool connection_closed_;
   bool first_buffer_delivered_;
+  bool metadata_pending_;
 };
 
 typedef struct iheart_prc_class iheart_prc_class_t;
@@ -341,47 +341,47 @@ delete_uri (plex_prc_t * ap_prc)
 static OMX_ERRORTYPE
 update_metadata (plex_prc_t * ap_prc)
 {
+  tiz_plex_metadata_t md;
   assert (ap_prc);
 
+  /* The metadata is retrieved by libtizplex in the background once the
+     queue moves. Until it is ready, the previous track's metadata is kept and
+     this is tried again when the next chunk of data arrives. */
+  if (!ap_prc->metadata_pending_
+      || 0 != tiz_plex_get_current_audio_track_metadata (ap_prc->p_plex_,
+                                                        &md))
+    {
+      return OMX_ErrorNone;
+    }
+
+  ap_prc->metadata_pending_ = false;
+
   /* Clear previous metadata items */
   tiz_krn_clear_metadata (tiz_get_krn (handleOf (ap_prc)));
 
   /* Audio stream title */
-  tiz_check_omx (store_metadata (
-    ap_prc, tiz_plex_get_current_audio_track_artist (ap_prc->p_plex_),
-    tiz_plex_get_current_audio_track_title (ap_prc->p_plex_)));
+  tiz_check_omx (store_metadata (ap_prc, md.p_artist, md.p_title));
 
   /* Playback queue progress */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Track #", tiz_plex_get_current_queue_progress (ap_prc->p_plex_)));
+  tiz_check_omx (store_metadata (ap_prc, "Track #", md.p_queue_progress));
 
   /* Album */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Album", tiz_plex_get_current_audio_track_album (ap_prc->p_plex_)));
+  tiz_check_omx (store_metadata (ap_prc, "Album", md.p_album));
 
   /* Publication year */
-  {
-    const char * p_year
-      = tiz_plex_get_current_audio_track_year (ap_prc->p_plex_);
-    if (p_year && strncmp (p_year, "0", 4) != 0)
-      {
-        tiz_check_omx (store_metadata (ap_prc, "Published", p_year));
-      }
-  }
+  if (md.p_year && strncmp (md.p_year, "0", 4) != 0)
+    {
+      tiz_check_omx (store_metadata (ap_prc, "Published", md.p_year));
+    }
 
   /* File size */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Size",
-    tiz_plex_get_current_audio_track_file_size (ap_prc->p_plex_)));
+  tiz_check_omx (store_metadata (ap_prc, "Size", md.p_file_size));
 
   /* Duration */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Duration",
-    tiz_plex_get_current_audio_track_duration (ap_prc->p_plex_)));
+  tiz_check_omx (store_metadata (ap_prc, "Duration", md.p_duration));
 
   /* File Format */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Codec", tiz_plex_get_current_audio_track_codec (ap_prc->p_plex_)));
+  tiz_check_omx (store_metadata (ap_prc, "Codec", md.p_codec));
 
   /* Signal that a new set of metadata items is available */
   (void) tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventIndexSettingChanged,
@@ -441,7 +441,9 @@ obtain_next_url (plex_prc_t * ap_prc, int a_skip_value)
                    url_len);
           ap_prc->p_uri_param_->contentURI[url_len] = '\0';
 
-          /* Song metadata is now available, update the IL client */
+          /* Song metadata is on its way; the IL client is updated as soon
+             as it is available */
+          ap_prc->metadata_pending_ = true;
           rc = update_metadata (ap_prc);
         }
     }
@@ -577,6 +579,8 @@ data_available (OMX_PTR ap_arg, const void * ap_ptr, const size_t a_nbytes)
   TIZ_DEBUG (handleOf (p_prc), "p_prc->auto_detect_on_ [%s]",
              (p_prc->auto_detect_on_ ? "TRUE" : "FALSE"));
 
+  (void) update_metadata (p_prc);
+
   if (p_prc->auto_detect_on_ && a_nbytes > 0)
     {
       p_prc->auto_detect_on_ = false;
@@ -738,6 +742,7 @@ plex_prc_ctor (void * ap_obj, va_list * app)
                          * ARATELIA_HTTP_SOURCE_DEFAULT_BUFFER_SECONDS_PLEX;
   p_prc->remove_current_url_ = false;
   p_prc->connection_closed_ = false;
+  p_prc->metadata_pending_ = false;
   return p_prc;
 }
 
@@ -68,6 +68,7 @@ extern "C"
     int buffer_bytes_;
     bool remove_current_url_;
     bool connection_closed_;
+    bool metadata_pending_;
   };
 
   typedef struct plex_prc_class plex_prc_class_t;
@@ -32,7 +32,6 @@
 
 #include <stdlib.h>
 #include <assert.h>
-#include <errno.h>
 #include <string.h>
 
 #include <OMX_TizoniaExt.h>
@@ -77,12 +76,6 @@ scloud_prc_transfer_and_process (void * ap_prc, OMX_U32 a_pid);
     }                                                                        \
   while (0)
 
-static inline bool
-is_valid_character (const char c)
-{
-  return (unsigned char) c > 0x20;
-}
-
 static void
 obtain_coding_type (scloud_prc_t * ap_prc, char * ap_info)
 {
@@ -103,44 +96,22 @@ obtain_coding_type (scloud_prc_t * ap_prc, char * ap_info)
     }
 }
 
-static int
-convert_str_to_int (scloud_prc_t * ap_prc, const char * ap_start,
-                    char ** ap_end)
+static void
+obtain_content_length (scloud_prc_t * ap_prc, const tiz_http_header_t * ap_hdr)
 {
-  long val = -1;
-  assert (ap_prc);
-  assert (ap_start);
-  assert (ap_end);
+  const long length = tiz_http_header_int (ap_hdr);
 
-  errno = 0;
-  val = strtol (ap_start, ap_end, 0);
+  assert (ap_prc);
 
-  if ((errno == ERANGE && (val == LONG_MAX || val == LONG_MIN))
-      || (errno != 0 && val == 0))
+  if (length < 0)
     {
-      TIZ_ERROR (handleOf (ap_prc),
-                 "Error retrieving the number of channels : [%s]",
-                 strerror (errno));
+      TIZ_ERROR (handleOf (ap_prc), "Invalid content length : [%.*s]",
+                 (int) ap_hdr->value_len, ap_hdr->p_value);
+      return;
     }
-  else if (*ap_end == ap_start)
-    {
-      TIZ_ERROR (handleOf (ap_prc),
-                 "Error retrieving the number of channels : "
-                 "[No digits were found]");
-    }
-
-  TIZ_TRACE (handleOf (ap_prc), "Value : [%d]", val);
-  return val;
-}
-
-static void
-obtain_content_length (scloud_prc_t * ap_prc, char * ap_info)
-{
-  char * p_end = NULL;
 
-  assert (ap_prc);
-  assert (ap_info);
-  ap_prc->content_length_bytes_ = convert_str_to_int (ap_prc, ap_info, &p_end);
+  TIZ_TRACE (handleOf (ap_prc), "Value : [%ld]", length);
+  ap_prc->content_length_bytes_ = length;
   ap_prc->bytes_before_eos_ = ap_prc->content_length_bytes_;
 }
 
@@ -217,53 +188,30 @@ static void
 obtain_audio_encoding_from_headers (scloud_prc_t * ap_prc,
                                     const char * ap_header, const size_t a_size)
 {
+  tiz_http_header_t hdr;
   assert (ap_prc);
   assert (ap_header);
-  {
-    const char * p_end = ap_header + a_size;
-    const char * p_value = (const char *) memchr (ap_header, ':', a_size);
-    char name[64];
-
-    if (p_value && (size_t) (p_value - ap_header) < sizeof (name))
-      {
-        memcpy (name, ap_header, p_value - ap_header);
-        name[p_value - ap_header] = 0;
 
-        /* skip the colon */
-        ++p_value;
-
-        /* strip the value */
-        while (p_value < p_end && !is_valid_character (*p_value))
-          {
-            ++p_value;
-          }
-
-        while (p_end > p_value && !is_valid_character (p_end[-1]))
-          {
-            --p_end;
-          }
+  if (tiz_http_header_parse (ap_header, a_size, &hdr))
+    {
+      TIZ_TRACE (handleOf (ap_prc), "header name  : [%.*s]",
+                 (int) hdr.name_len, hdr.p_name);
+      TIZ_TRACE (handleOf (ap_prc), "header value : [%.*s]",
+                 (int) hdr.value_len, hdr.p_value);
 
+      if (tiz_http_header_is (&hdr, "Content-Type"))
         {
-          char * p_info = tiz_mem_calloc (1, (p_end - p_value) + 1);
-          memcpy (p_info, p_value, p_end - p_value);
-          p_info[(p_end - p_value)] = '\0';
-          TIZ_TRACE (handleOf (ap_prc), "header name  : [%s]", name);
-          TIZ_TRACE (handleOf (ap_prc), "header value : [%s]", p_info);
-
-          if (strncasecmp (name, "Content-Type", 12) == 0)
-            {
-              obtain_coding_type (ap_prc, p_info);
-              /* Now set the new coding type value on the output port */
-              (void) set_audio_coding_on_port (ap_prc);
-            }
-          else if (strncasecmp (name, "Content-Length", 14) == 0)
-            {
-              obtain_content_length (ap_prc, p_info);
-            }
-          tiz_mem_free (p_info);
+          char info[OMX_MAX_STRINGNAME_SIZE];
+          char * p_info = tiz_http_header_value (&hdr, info, sizeof (info));
+          obtain_coding_type (ap_prc, p_info);
+          /* Now set the new coding type value on the output port */
+          (void) set_audio_coding_on_port (ap_prc);
         }
-      }
-  }
+      else if (tiz_http_header_is (&hdr, "Content-Length"))
+        {
+          obtain_content_length (ap_prc, &hdr);
+        }
+    }
 }
 
 static void
@@ -302,44 +250,43 @@ delete_uri (scloud_prc_t * ap_prc)
 static OMX_ERRORTYPE
 update_metadata (scloud_prc_t * ap_prc)
 {
+  tiz_scloud_metadata_t md;
   assert (ap_prc);
 
+  /* The metadata is retrieved by libtizsoundcloud in the background once the
+     queue moves. Until it is ready, the previous track's metadata is kept and
+     this is tried again when the next chunk of data arrives. */
+  if (!ap_prc->metadata_pending_
+      || 0 != tiz_scloud_get_current_track_metadata (ap_prc->p_scloud_, &md))
+    {
+      return OMX_ErrorNone;
+    }
+
+  ap_prc->metadata_pending_ = false;
+
   /* Clear previous metatada items */
   tiz_krn_clear_metadata (tiz_get_krn (handleOf (ap_prc)));
 
   /* User and track title */
-  tiz_check_omx (store_metadata (
-    ap_prc, tiz_scloud_get_current_track_user (ap_prc->p_scloud_),
-    tiz_scloud_get_current_track_title (ap_prc->p_scloud_)));
+  tiz_check_omx (store_metadata (ap_prc, md.p_user, md.p_title));
 
   /* Store the year if not 0 */
-  {
-    const char * p_year = tiz_scloud_get_current_track_year (ap_prc->p_scloud_);
-    if (p_year && strncmp (p_year, "0", 4) != 0)
-      {
-        tiz_check_omx (store_metadata (ap_prc, "Year", p_year));
-      }
-  }
+  if (md.p_year && strncmp (md.p_year, "0", 4) != 0)
+    {
+      tiz_check_omx (store_metadata (ap_prc, "Year", md.p_year));
+    }
 
   /* Duration */
-  tiz_check_omx (
-    store_metadata (ap_prc, "Duration",
-                    tiz_scloud_get_current_track_duration (ap_prc->p_scloud_)));
+  tiz_check_omx (store_metadata (ap_prc, "Duration", md.p_duration));
 
   /* Likes */
-  tiz_check_omx (
-    store_metadata (ap_prc, "Likes count",
-                    tiz_scloud_get_current_track_likes (ap_prc->p_scloud_)));
+  tiz_check_omx (store_metadata (ap_prc, "Likes count", md.p_likes));
 
   /* Permalink */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Permalink",
-    tiz_scloud_get_current_track_permalink (ap_prc->p_scloud_)));
+  tiz_check_omx (store_metadata (ap_prc, "Permalink", md.p_permalink));
 
   /* License */
-  tiz_check_omx (
-    store_metadata (ap_prc, "License",
-                    tiz_scloud_get_current_track_license (ap_prc->p_scloud_)));
+  tiz_check_omx (store_metadata (ap_prc, "License", md.p_license));
 
   /* Signal that a new set of metatadata items is available */
   (void) tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventIndexSettingChanged,
@@ -396,7 +343,9 @@ obtain_next_url (scloud_prc_t * ap_prc, int a_skip_value)
                    url_len);
           ap_prc->p_uri_param_->contentURI[url_len] = '\0';
 
-          /* Song metadata is now available, update the IL client */
+          /* Song metadata is on its way; the IL client is updated as soon
+             as it is available */
+          ap_prc->metadata_pending_ = true;
           rc = update_metadata (ap_prc);
         }
     }
@@ -500,6 +449,8 @@ data_available (OMX_PTR ap_arg, const void * ap_ptr, const size_t a_nbytes)
   assert (p_prc);
   assert (ap_ptr);
 
+  (void) update_metadata (p_prc);
+
   if (p_prc->auto_detect_on_ && a_nbytes > 0)
     {
       p_prc->auto_detect_on_ = false;
@@ -671,6 +622,7 @@ scloud_prc_ctor (void * ap_obj, va_list * app)
   p_prc->bitrate_ = ARATELIA_HTTP_SOURCE_DEFAULT_BIT_RATE_KBITS;
   p_prc->buffer_bytes_ = ((p_prc->bitrate_ * 1000) / 8)
                          * ARATELIA_HTTP_SOURCE_DEFAULT_BUFFER_SECONDS_SCLOUD;
+  p_prc->metadata_pending_ = false;
   return p_prc;
 }
 
@@ -66,6 +66,7 @@ extern "C"
     bool auto_detect_on_;
     int bitrate_;
     int buffer_bytes_;
+    bool metadata_pending_;
   };
 
   typedef struct scloud_prc_class scloud_prc_class_t;
@@ -326,51 +326,51 @@ delete_uri (tunein_prc_t * ap_prc)
 static OMX_ERRORTYPE
 update_metadata (tunein_prc_t * ap_prc)
 {
+  tiz_tunein_metadata_t md;
   assert (ap_prc);
 
+  /* The metadata is retrieved by libtiztunein in the background once the
+     queue moves. Until it is ready, the previous station's metadata is kept and
+     this is tried again when the next chunk of data arrives. */
+  if (!ap_prc->metadata_pending_
+      || 0 != tiz_tunein_get_current_radio_metadata (ap_prc->p_tunein_, &md))
+    {
+      return OMX_ErrorNone;
+    }
+
+  ap_prc->metadata_pending_ = false;
+
   /* Clear previous metatada items */
   tiz_krn_clear_metadata (tiz_get_krn (handleOf (ap_prc)));
 
   /* Station Name */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Station", tiz_tunein_get_current_radio_name (ap_prc->p_tunein_)));
+  tiz_check_omx (store_metadata (ap_prc, "Station", md.p_name));
 
   /* Playback queue progress */
-  tiz_check_omx (
-    store_metadata (ap_prc, "Item #",
-                    tiz_tunein_get_current_queue_progress (ap_prc->p_tunein_)));
+  tiz_check_omx (store_metadata (ap_prc, "Item #", md.p_queue_progress));
 
   /* Station Description */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Description",
-    tiz_tunein_get_current_radio_description (ap_prc->p_tunein_)));
+  tiz_check_omx (store_metadata (ap_prc, "Description", md.p_description));
 
   /* Type */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Type", tiz_tunein_get_current_radio_type (ap_prc->p_tunein_)));
+  tiz_check_omx (store_metadata (ap_prc, "Type", md.p_type));
 
   /* Station formats */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Format", tiz_tunein_get_current_radio_format (ap_prc->p_tunein_)));
+  tiz_check_omx (store_metadata (ap_prc, "Format", md.p_format));
 
   /* Station Bitrate */
-  tiz_check_omx (
-    store_metadata (ap_prc, "Bitrate",
-                    tiz_tunein_get_current_radio_bitrate (ap_prc->p_tunein_)));
+  tiz_check_omx (store_metadata (ap_prc, "Bitrate", md.p_bitrate));
 
   /* Reliability */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Reliability",
-    tiz_tunein_get_current_radio_reliability (ap_prc->p_tunein_)));
+  tiz_check_omx (store_metadata (ap_prc, "Reliability", md.p_reliability));
 
   /* Streaming URL */
   tiz_check_omx (store_metadata (
     ap_prc, "Streaming URL", (const char *) ap_prc->p_uri_param_->contentURI));
 
   /* Thumbnail */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Thumbnail URL",
-    tiz_tunein_get_current_radio_thumbnail_url (ap_prc->p_tunein_)));
+  tiz_check_omx (
+    store_metadata (ap_prc, "Thumbnail URL", md.p_thumbnail_url));
 
   /* Signal that a new set of metatadata items is available */
   (void) tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventIndexSettingChanged,
@@ -437,7 +437,9 @@ obtain_next_url (tunein_prc_t * ap_prc, int a_skip_value)
                    url_len);
           ap_prc->p_uri_param_->contentURI[url_len] = '\0';
 
-          /* Song metadata is now available, update the IL client */
+          /* Song metadata is on its way; the IL client is updated as soon
+             as it is available */
+          ap_prc->metadata_pending_ = true;
           rc = update_metadata (ap_prc);
         }
     }
@@ -538,6 +540,8 @@ data_available (OMX_PTR ap_arg, const void * ap_ptr, const size_t a_nbytes)
   TIZ_DEBUG (handleOf (p_prc), "p_prc->auto_detect_on_ [%s]",
              (p_prc->auto_detect_on_ ? "TRUE" : "FALSE"));
 
+  (void) update_metadata (p_prc);
+
   if (p_prc->auto_detect_on_ && a_nbytes > 0)
     {
       p_prc->auto_detect_on_ = false;
@@ -737,6 +741,7 @@ tunein_prc_ctor (void * ap_obj, va_list * app)
   p_prc->remove_current_url_ = false;
   p_prc->connection_closed_ = false;
   p_prc->first_buffer_delivered_ = false;
+  p_prc->metadata_pending_ = false;
   return p_prc;
 }
 
@@ -67,6 +67,7 @@ extern "C"
     bool remove_current_url_;
     bool connection_closed_;
     bool first_buffer_delivered_;
+    bool metadata_pending_;
   };
 
   typedef struct tunein_prc_class tunein_prc_class_t;
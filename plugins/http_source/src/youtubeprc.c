@@ -32,7 +32,6 @@
 
 #include <stdlib.h>
 #include <assert.h>
-#include <errno.h>
 #include <string.h>
 
 #include <OMX_TizoniaExt.h>
@@ -78,12 +77,6 @@ youtube_prc_transfer_and_process (void * ap_prc, OMX_U32 a_pid);
     }                                                                        \
   while (0)
 
-static inline bool
-is_valid_character (const char c)
-{
-  return (unsigned char) c > 0x20;
-}
-
 static OMX_ERRORTYPE
 obtain_coding_type (youtube_prc_t * ap_prc, char * ap_info)
 {
@@ -110,42 +103,22 @@ obtain_coding_type (youtube_prc_t * ap_prc, char * ap_info)
   return rc;
 }
 
-static int
-convert_str_to_int (youtube_prc_t * ap_prc, const char * ap_start,
-                    char ** ap_end)
+static void
+obtain_content_length (youtube_prc_t * ap_prc, const tiz_http_header_t * ap_hdr)
 {
-  long val = -1;
-  assert (ap_prc);
-  assert (ap_start);
-  assert (ap_end);
+  const long length = tiz_http_header_int (ap_hdr);
 
-  errno = 0;
-  val = strtol (ap_start, ap_end, 0);
+  assert (ap_prc);
 
-  if ((errno == ERANGE && (val == LONG_MAX || val == LONG_MIN))
-      || (errno != 0 && val == 0))
-    {
-      TIZ_ERROR (handleOf (ap_prc),
-                 "Error retrieving the number of channels : [%s]",
-                 strerror (errno));
-    }
-  else if (*ap_end == ap_start)
+  if (length < 0)
     {
-      TIZ_ERROR (handleOf (ap_prc),
-                 "Error retrieving the number of channels : "
-                 "[No digits were found]");
+      TIZ_ERROR (handleOf (ap_prc), "Invalid content length : [%.*s]",
+                 (int) ap_hdr->value_len, ap_hdr->p_value);
+      return;
     }
-  return val;
-}
 
-static void
-obtain_content_length (youtube_prc_t * ap_prc, char * ap_info)
-{
-  char * p_end = NULL;
-
-  assert (ap_prc);
-  assert (ap_info);
-  ap_prc->content_length_bytes_ = convert_str_to_int (ap_prc, ap_info, &p_end);
+  TIZ_TRACE (handleOf (ap_prc), "Value : [%ld]", length);
+  ap_prc->content_length_bytes_ = length;
   ap_prc->bytes_before_eos_ = ap_prc->content_length_bytes_;
 }
 
@@ -244,55 +217,32 @@ static void
 obtain_audio_encoding_from_headers (youtube_prc_t * ap_prc,
                                     const char * ap_header, const size_t a_size)
 {
+  tiz_http_header_t hdr;
   assert (ap_prc);
   assert (ap_header);
-  {
-    const char * p_end = ap_header + a_size;
-    const char * p_value = (const char *) memchr (ap_header, ':', a_size);
-    char name[64];
-
-    if (p_value && (size_t) (p_value - ap_header) < sizeof (name))
-      {
-        memcpy (name, ap_header, p_value - ap_header);
-        name[p_value - ap_header] = 0;
-
-        /* skip the colon */
-        ++p_value;
-
-        /* strip the value */
-        while (p_value < p_end && !is_valid_character (*p_value))
-          {
-            ++p_value;
-          }
 
-        while (p_end > p_value && !is_valid_character (p_end[-1]))
-          {
-            --p_end;
-          }
+  if (tiz_http_header_parse (ap_header, a_size, &hdr))
+    {
+      TIZ_TRACE (handleOf (ap_prc), "header name  : [%.*s]",
+                 (int) hdr.name_len, hdr.p_name);
+      TIZ_TRACE (handleOf (ap_prc), "header value : [%.*s]",
+                 (int) hdr.value_len, hdr.p_value);
 
+      if (tiz_http_header_is (&hdr, "Content-Type"))
         {
-          char * p_info = tiz_mem_calloc (1, (p_end - p_value) + 1);
-          memcpy (p_info, p_value, p_end - p_value);
-          p_info[(p_end - p_value)] = '\0';
-          TIZ_TRACE (handleOf (ap_prc), "header name  : [%s]", name);
-          TIZ_TRACE (handleOf (ap_prc), "header value : [%s]", p_info);
-
-          if (strncasecmp (name, "Content-Type", 12) == 0)
-            {
-              if (OMX_ErrorNone == obtain_coding_type (ap_prc, p_info))
-                {
-                  /* Now set the new coding type value on the output port */
-                  (void) set_audio_coding_on_port (ap_prc);
-                }
-            }
-          else if (strncasecmp (name, "Content-Length", 14) == 0)
+          char info[OMX_MAX_STRINGNAME_SIZE];
+          char * p_info = tiz_http_header_value (&hdr, info, sizeof (info));
+          if (OMX_ErrorNone == obtain_coding_type (ap_prc, p_info))
             {
-              obtain_content_length (ap_prc, p_info);
+              /* Now set the new coding type value on the output port */
+              (void) set_audio_coding_on_port (ap_prc);
             }
-          tiz_mem_free (p_info);
         }
-      }
-  }
+      else if (tiz_http_header_is (&hdr, "Content-Length"))
+        {
+          obtain_content_length (ap_prc, &hdr);
+        }
+    }
 }
 
 static void
@@ -346,60 +296,53 @@ delete_uri (youtube_prc_t * ap_prc)
 static OMX_ERRORTYPE
 update_metadata (youtube_prc_t * ap_prc)
 {
+  tiz_youtube_metadata_t md;
   assert (ap_prc);
 
+  /* The metadata is retrieved by libtizyoutube in the background once the
+     queue moves. Until it is ready, the previous stream's metadata is kept and
+     this is tried again when the next chunk of data arrives. */
+  if (!ap_prc->metadata_pending_
+      || 0 != tiz_youtube_get_current_audio_stream_metadata (ap_prc->p_youtube_,
+                                                             &md))
+    {
+      return OMX_ErrorNone;
+    }
+
+  ap_prc->metadata_pending_ = false;
+
   /* Clear previous metadata items */
   tiz_krn_clear_metadata (tiz_get_krn (handleOf (ap_prc)));
 
   /* Audio stream title */
-  tiz_check_omx (store_metadata (
-    ap_prc, tiz_youtube_get_current_audio_stream_author (ap_prc->p_youtube_),
-    tiz_youtube_get_current_audio_stream_title (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, md.p_author, md.p_title));
 
   /* Playback queue progress */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Stream #",
-    tiz_youtube_get_current_queue_progress (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, "Stream #", md.p_queue_progress));
 
   /* ID */
-  tiz_check_omx (store_metadata (
-    ap_prc, "YouTube Id",
-    tiz_youtube_get_current_audio_stream_video_id (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, "YouTube Id", md.p_video_id));
 
   /* Duration */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Duration",
-    tiz_youtube_get_current_audio_stream_duration (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, "Duration", md.p_duration));
 
   /* File Format */
-  tiz_check_omx (store_metadata (
-    ap_prc, "File Format",
-    tiz_youtube_get_current_audio_stream_file_extension (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, "File Format", md.p_file_extension));
 
   /* Bitrate */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Bitrate",
-    tiz_youtube_get_current_audio_stream_bitrate (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, "Bitrate", md.p_bitrate));
 
   /* File Size */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Size",
-    tiz_youtube_get_current_audio_stream_file_size (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, "Size", md.p_file_size));
 
   /* View count */
-  tiz_check_omx (store_metadata (
-    ap_prc, "View Count",
-    tiz_youtube_get_current_audio_stream_view_count (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, "View Count", md.p_view_count));
 
   /* Description */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Description",
-    tiz_youtube_get_current_audio_stream_description (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, "Description", md.p_description));
 
   /* Publication date/time */
-  tiz_check_omx (store_metadata (
-    ap_prc, "Published",
-    tiz_youtube_get_current_audio_stream_published (ap_prc->p_youtube_)));
+  tiz_check_omx (store_metadata (ap_prc, "Published", md.p_published));
 
   /* Signal that a new set of metadata items is available */
   (void) tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventIndexSettingChanged,
@@ -459,7 +402,9 @@ obtain_next_url (youtube_prc_t * ap_prc, int a_skip_value)
                    url_len);
           ap_prc->p_uri_param_->contentURI[url_len] = '\0';
 
-          /* Song metadata is now available, update the IL client */
+          /* Song metadata is on its way; the IL client is updated as soon
+             as it is available */
+          ap_prc->metadata_pending_ = true;
           rc = update_metadata (ap_prc);
         }
     }
@@ -571,6 +516,8 @@ data_available (OMX_PTR ap_arg, const void * ap_ptr, const size_t a_nbytes)
   TIZ_DEBUG (handleOf (p_prc), "p_prc->auto_detect_on_ [%s]",
              (p_prc->auto_detect_on_ ? "TRUE" : "FALSE"));
 
+  (void) update_metadata (p_prc);
+
   if (p_prc->auto_detect_on_ && a_nbytes > 0)
     {
       p_prc->auto_detect_on_ = false;
@@ -767,6 +714,7 @@ youtube_prc_ctor (void * ap_obj, va_list * app)
   p_prc->buffer_bytes_ = ((p_prc->bitrate_ * 1000) / 8)
                          * ARATELIA_HTTP_SOURCE_DEFAULT_BUFFER_SECONDS_YOUTUBE;
   p_prc->remove_current_url_ = false;
+  p_prc->metadata_pending_ = false;
   return p_prc;
 }
 
@@ -67,6 +67,7 @@ extern "C"
     int bitrate_;
     int buffer_bytes_;
     bool remove_current_url_;
+    bool metadata_pending_;
   };
 
   typedef struct youtube_prc_class youtube_prc_class_t;
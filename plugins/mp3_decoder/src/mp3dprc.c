@@ -34,6 +34,8 @@
 #include <limits.h>
 #include <string.h>
 
+#include <OMX_TizoniaExt.h>
+
 #include <tizplatform.h>
 
 #include <tizkernel.h>
@@ -96,6 +98,15 @@ release_headers (const void * ap_obj, OMX_U32 a_pid)
               p_obj->eos_ = true;
             }
 
+          if (p_obj->stream_in_hdr_)
+            {
+              /* The header is being returned before libmad has consumed all
+                 of its data (e.g. flush or port disable); drop the rest so
+                 that the stream does not reference the buffer anymore */
+              mad_stream_buffer (&p_obj->stream_, p_obj->in_buff_, 0);
+              p_obj->stream_in_hdr_ = false;
+            }
+          p_obj->bridged_ = 0;
           p_obj->p_inhdr_->nOffset = 0;
           tiz_check_omx (tiz_krn_release_buffer (
             tiz_get_krn (handleOf (ap_obj)),
@@ -353,6 +364,88 @@ read_from_omx_buffer (const mp3d_prc_t * ap_prc, void * ap_dst, size_t bytes,
   return to_read;
 }
 
+static bool
+attach_input_buffer (mp3d_prc_t * ap_prc)
+{
+  OMX_BUFFERHEADERTYPE * p_hdr = NULL;
+  size_t leftover = 0;
+
+  assert (ap_prc);
+  assert (ap_prc->p_inhdr_);
+
+  p_hdr = ap_prc->p_inhdr_;
+  if (ap_prc->stream_.next_frame != NULL)
+    {
+      leftover = ap_prc->stream_.bufend - ap_prc->stream_.next_frame;
+    }
+
+  if (ap_prc->stream_in_hdr_)
+    {
+      /* The input buffer has been exhausted. The partial frame at its end is
+         moved to the local store, so that the header can be returned */
+      const unsigned char * p_partial = ap_prc->stream_.next_frame;
+      if (leftover > INPUT_BUFFER_SIZE / 2)
+        {
+          TIZ_TRACE (handleOf (ap_prc), "dropping [%zu] unsynced bytes",
+                     leftover - INPUT_BUFFER_SIZE / 2);
+          p_partial += leftover - INPUT_BUFFER_SIZE / 2;
+          leftover = INPUT_BUFFER_SIZE / 2;
+        }
+      if (leftover > 0)
+        {
+          memcpy (ap_prc->in_buff_, p_partial, leftover);
+        }
+      mad_stream_buffer (&ap_prc->stream_, ap_prc->in_buff_, leftover);
+      ap_prc->stream_in_hdr_ = false;
+      p_hdr->nOffset += p_hdr->nFilledLen;
+      p_hdr->nFilledLen = 0;
+      return false;
+    }
+
+  if (leftover > 0)
+    {
+      if (leftover > ap_prc->bridged_)
+        {
+          /* The partial frame in the local store still includes data from a
+             previous buffer */
+          return false;
+        }
+      /* All of the unconsumed data came from the current header; read it
+         from there again */
+      p_hdr->nOffset -= leftover;
+      p_hdr->nFilledLen += leftover;
+    }
+
+  if (0 == p_hdr->nFilledLen)
+    {
+      return false;
+    }
+
+  ap_prc->bridged_ = 0;
+  ap_prc->stream_in_hdr_ = true;
+  mad_stream_buffer (&ap_prc->stream_, p_hdr->pBuffer + p_hdr->nOffset,
+                     p_hdr->nFilledLen);
+  ap_prc->stream_.error = 0;
+  return true;
+}
+
+static void
+update_in_place_mode (mp3d_prc_t * ap_prc)
+{
+  OMX_TIZONIA_PARAM_BUFFER_INPLACEMODETYPE ipmode;
+  assert (ap_prc);
+  TIZ_INIT_OMX_PORT_STRUCT (ipmode, ARATELIA_MP3_DECODER_INPUT_PORT_INDEX);
+  ap_prc->in_place_
+    = (OMX_ErrorNone
+         == tiz_api_GetParameter (tiz_get_krn (handleOf (ap_prc)),
+                                  handleOf (ap_prc),
+                                  OMX_TizoniaIndexParamBufferInPlaceMode,
+                                  &ipmode)
+       && OMX_TRUE == ipmode.bEnabled);
+  TIZ_TRACE (handleOf (ap_prc), "in-place mode [%s]",
+             ap_prc->in_place_ ? "ENABLED" : "DISABLED");
+}
+
 static OMX_ERRORTYPE
 update_pcm_mode (mp3d_prc_t * ap_prc, const OMX_U32 a_samplerate,
                  const OMX_U32 a_channels)
@@ -496,6 +589,12 @@ decode_buffer (const void * ap_obj)
           unsigned char * p_read_start = NULL;
           p_obj->remaining_ = 0;
 
+          if (p_obj->in_place_ && attach_input_buffer (p_obj))
+            {
+              /* libmad now reads straight from the input header */
+              continue;
+            }
+
           if (p_obj->stream_.next_frame != NULL)
             {
               p_obj->remaining_
@@ -512,6 +611,13 @@ decode_buffer (const void * ap_obj)
               p_obj->remaining_ = 0;
             }
 
+          if (p_obj->in_place_ && read_size > IN_PLACE_BRIDGE_SIZE)
+            {
+              /* Just enough to get past the frame that straddles the two
+                 buffers; the rest is read in place */
+              read_size = IN_PLACE_BRIDGE_SIZE;
+            }
+
           /* Fill-in the buffer. If an error occurs print a message
              * and leave the decoding loop. If the end of stream is
              * reached we also leave the loop but the return status is
@@ -519,6 +625,7 @@ decode_buffer (const void * ap_obj)
              */
           read_size = read_from_omx_buffer (p_obj, p_read_start, read_size,
                                             p_obj->p_inhdr_);
+          p_obj->bridged_ = read_size;
           if (read_size == 0)
             {
               if ((p_obj->p_inhdr_->nFlags & OMX_BUFFERFLAG_EOS) != 0)
@@ -715,6 +822,9 @@ mp3d_proc_ctor (void * ap_obj, va_list * app)
   p_obj->eos_ = false;
   p_obj->in_port_disabled_ = false;
   p_obj->out_port_disabled_ = false;
+  p_obj->in_place_ = false;
+  p_obj->stream_in_hdr_ = false;
+  p_obj->bridged_ = 0;
   return p_obj;
 }
 
@@ -773,6 +883,7 @@ mp3d_proc_prepare_to_transfer (void * ap_obj, OMX_U32 a_pid)
              "sample rate renderer = [%d] channels renderer = [%d]",
              p_prc->pcmmode_.nSamplingRate, p_prc->pcmmode_.nChannels);
 
+  update_in_place_mode (p_prc);
   reset_stream_parameters (ap_obj);
 
   return OMX_ErrorNone;
@@ -882,6 +993,7 @@ mp3d_proc_port_enable (const void * ap_obj, OMX_U32 a_pid)
   assert (p_obj);
   if (OMX_ALL == a_pid || ARATELIA_MP3_DECODER_INPUT_PORT_INDEX == a_pid)
     {
+      update_in_place_mode (p_obj);
       reset_stream_parameters (p_obj);
       p_obj->in_port_disabled_ = false;
     }
@@ -43,6 +43,9 @@ extern "C"
 
 #define INPUT_BUFFER_SIZE (5 * 8192)
 #define OUTPUT_BUFFER_SIZE 8192 /* Must be an integer multiple of 4. */
+/* In in-place mode, the amount of data copied from a new input buffer to
+   complete a frame that straddles two buffers. */
+#define IN_PLACE_BRIDGE_SIZE 8192
 
   typedef struct mp3d_prc mp3d_prc_t;
   struct mp3d_prc
@@ -63,6 +66,9 @@ extern "C"
     bool eos_;
     bool in_port_disabled_;
     bool out_port_disabled_;
+    bool in_place_;
+    bool stream_in_hdr_; /* libmad is reading straight from p_inhdr_ */
+    size_t bridged_; /* Bytes of p_inhdr_ last copied to in_buff_ */
   };
 
   typedef struct mp3d_prc_class mp3d_prc_class_t;
@@ -33,6 +33,8 @@
 #include <assert.h>
 #include <limits.h>
 #include <string.h>
+#include <strings.h>
+#include <unistd.h>
 
 #include <tizplatform.h>
 
@@ -49,11 +51,29 @@
 
 #define TIZ_LAME_MP3_ENC_MIN_BUFFER_SIZE 7200
 
+static void
+reset_segments (mp3e_prc_t * ap_prc)
+{
+  assert (ap_prc);
+
+  mp3e_seg_reset (&(ap_prc->seg_));
+  ap_prc->eos_ = false;
+  if (ap_prc->p_pcm_)
+    {
+      tiz_buffer_clear (ap_prc->p_pcm_);
+    }
+}
+
 static OMX_ERRORTYPE
 release_buffers (const void * ap_obj)
 {
   mp3e_prc_t * p_obj = (mp3e_prc_t *) ap_obj;
 
+  if (p_obj->nworkers_ > 1)
+    {
+      reset_segments (p_obj);
+    }
+
   if (p_obj->p_inhdr_)
     {
       tiz_check_omx (tiz_krn_release_buffer (
@@ -242,6 +262,62 @@ claim_output (const void * ap_obj)
   return rc;
 }
 
+static void
+read_encoder_settings (mp3e_prc_t * ap_prc)
+{
+  const char * p_vbr_mode = tiz_rcfile_get_value (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION, "OMX.Aratelia.audio_encoder.mp3.vbr_mode");
+  long workers = TIZ_RCFILE_GET_INT (TIZ_RCFILE_PLUGINS_DATA_SECTION,
+                                     "OMX.Aratelia.audio_encoder.mp3.workers",
+                                     1);
+
+  assert (ap_prc);
+
+  /* 0 = best and slowest, 9 = worst and fastest */
+  ap_prc->settings_.quality = MAX (
+    0, MIN (9, TIZ_RCFILE_GET_INT (TIZ_RCFILE_PLUGINS_DATA_SECTION,
+                                   "OMX.Aratelia.audio_encoder.mp3.quality",
+                                   2)));
+  ap_prc->settings_.vbr_quality = MAX (
+    0, MIN (9, TIZ_RCFILE_GET_INT (TIZ_RCFILE_PLUGINS_DATA_SECTION,
+                                   "OMX.Aratelia.audio_encoder.mp3.vbr_quality",
+                                   4)));
+
+  ap_prc->settings_.vbr_mode = EMp3eVbrModeCbr;
+  if (p_vbr_mode && 0 == strcasecmp (p_vbr_mode, "abr"))
+    {
+      ap_prc->settings_.vbr_mode = EMp3eVbrModeAbr;
+    }
+  else if (p_vbr_mode && 0 == strcasecmp (p_vbr_mode, "vbr"))
+    {
+      ap_prc->settings_.vbr_mode = EMp3eVbrModeVbr;
+    }
+  else if (p_vbr_mode && 0 != strcasecmp (p_vbr_mode, "cbr"))
+    {
+      TIZ_WARN (handleOf (ap_prc), "Ignoring unknown vbr mode [%s]",
+                p_vbr_mode);
+    }
+
+  if (workers < 0)
+    {
+      TIZ_WARN (handleOf (ap_prc), "Ignoring invalid worker count [%ld]",
+                workers);
+      workers = 1;
+    }
+
+  if (0 == workers)
+    {
+      /* Auto: one worker per online cpu */
+      workers = sysconf (_SC_NPROCESSORS_ONLN);
+    }
+
+  ap_prc->nworkers_ = (OMX_U32) MAX (1, MIN (workers, MP3E_MAX_WORKERS));
+
+  TIZ_TRACE (handleOf (ap_prc), "quality [%d] vbr mode [%d] workers [%u]",
+             ap_prc->settings_.quality, ap_prc->settings_.vbr_mode,
+             ap_prc->nworkers_);
+}
+
 static OMX_ERRORTYPE
 set_lame_pcm_settings (void * ap_obj, OMX_HANDLETYPE ap_hdl, void * ap_krn)
 {
@@ -284,7 +360,6 @@ set_lame_mp3_settings (void * ap_obj, OMX_HANDLETYPE ap_hdl, void * ap_krn)
 {
   mp3e_prc_t * p_prc = ap_obj;
   OMX_ERRORTYPE ret_val = OMX_ErrorNone;
-  int lame_mode = 0;
 
   assert (p_prc);
   assert (ap_hdl);
@@ -312,44 +387,216 @@ set_lame_mp3_settings (void * ap_obj, OMX_HANDLETYPE ap_hdl, void * ap_krn)
              p_prc->mp3type_.nSampleRate, p_prc->mp3type_.nAudioBandWidth,
              p_prc->mp3type_.eChannelMode, p_prc->mp3type_.eFormat);
 
-  (void) lame_set_num_channels (p_prc->lame_, p_prc->mp3type_.nChannels);
-  (void) lame_set_in_samplerate (p_prc->lame_, p_prc->mp3type_.nSampleRate);
-  (void) lame_set_brate (p_prc->lame_, p_prc->mp3type_.nBitRate);
+  mp3e_configure_lame (&(p_prc->settings_), &(p_prc->mp3type_),
+                       p_prc->lame_);
+
+  return ret_val;
+}
+
+/*
+ * Segment-parallel encoding
+ */
+
+static OMX_ERRORTYPE
+deliver_segments (mp3e_prc_t * ap_prc)
+{
+  mp3e_job_t * p_job = NULL;
+  assert (ap_prc);
 
-  switch (p_prc->mp3type_.eChannelMode)
+  while ((p_job = mp3e_seg_peek (&(ap_prc->seg_))))
     {
-      case OMX_AUDIO_ChannelModeStereo:
+      OMX_BUFFERHEADERTYPE * p_hdr = NULL;
+
+      if (!ap_prc->p_outhdr_ && !claim_output (ap_prc))
         {
-          lame_mode = 0;
+          break;
         }
-        break;
-      case OMX_AUDIO_ChannelModeJointStereo:
+
+      /* Whole frames only */
+      p_hdr = ap_prc->p_outhdr_;
+      while (p_job->mp3_offset < p_job->mp3_end)
         {
-          lame_mode = 1;
+          const size_t len
+            = mp3e_frame_len (p_job->p_mp3 + p_job->mp3_offset,
+                              p_job->mp3_end - p_job->mp3_offset);
+          assert (len > 0);
+          if (len > p_hdr->nAllocLen - p_hdr->nFilledLen)
+            {
+              break;
+            }
+          memcpy (p_hdr->pBuffer + p_hdr->nFilledLen,
+                  p_job->p_mp3 + p_job->mp3_offset, len);
+          p_hdr->nFilledLen += len;
+          p_job->mp3_offset += len;
         }
-        break;
-      case OMX_AUDIO_ChannelModeDual:
+
+      if (p_job->mp3_offset < p_job->mp3_end)
         {
-          /* Not supported, default to 0 (stereo) */
-          lame_mode = 0;
+          /* The output buffer is full */
+          tiz_check_omx (tiz_krn_release_buffer (
+            tiz_get_krn (handleOf (ap_prc)),
+            ARATELIA_MP3_ENCODER_OUTPUT_PORT_INDEX, p_hdr));
+          ap_prc->p_outhdr_ = NULL;
+          continue;
         }
-        break;
-      case OMX_AUDIO_ChannelModeMono:
+
+      (void) mp3e_seg_pop (&(ap_prc->seg_));
+      if (p_job->last)
         {
-          lame_mode = 3;
+          TIZ_TRACE (handleOf (ap_prc), "EOS OUTPUT HEADER [%p]...", p_hdr);
+          p_hdr->nFlags |= OMX_BUFFERFLAG_EOS;
+          tiz_check_omx (tiz_krn_release_buffer (
+            tiz_get_krn (handleOf (ap_prc)),
+            ARATELIA_MP3_ENCODER_OUTPUT_PORT_INDEX, p_hdr));
+          ap_prc->p_outhdr_ = NULL;
         }
-        break;
+      mp3e_job_free (p_job);
+    }
 
-      default:
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+cut_segment (mp3e_prc_t * ap_prc, const bool a_last)
+{
+  mp3e_job_t * p_job = NULL;
+  assert (ap_prc);
+
+  if (!(p_job = mp3e_seg_cut (&(ap_prc->seg_), ap_prc->p_pcm_, a_last)))
+    {
+      return OMX_ErrorInsufficientResources;
+    }
+
+  if (a_last)
+    {
+      ap_prc->eos_ = false;
+    }
+
+  return mp3e_workers_submit (&(ap_prc->workers_), p_job);
+}
+
+static OMX_ERRORTYPE
+encode_segments (mp3e_prc_t * ap_prc)
+{
+  assert (ap_prc);
+
+  tiz_check_omx (deliver_segments (ap_prc));
+
+  while (mp3e_seg_pending (&(ap_prc->seg_)) < 2 * ap_prc->nworkers_)
+    {
+      OMX_BUFFERHEADERTYPE * p_hdr = NULL;
+
+      if (mp3e_seg_ready (&(ap_prc->seg_),
+                          tiz_buffer_available (ap_prc->p_pcm_)))
         {
-          lame_mode = 3;
+          tiz_check_omx (cut_segment (ap_prc, false));
+          continue;
         }
-    };
 
-  (void) lame_set_mode (p_prc->lame_, lame_mode);
-  (void) lame_set_quality (p_prc->lame_, 2); /* 2=high  5 = medium  7=low */
+      if (ap_prc->eos_)
+        {
+          /* All the remaining pcm goes in the last segment */
+          tiz_check_omx (cut_segment (ap_prc, true));
+          continue;
+        }
 
-  return ret_val;
+      if (!ap_prc->p_inhdr_ && !claim_input (ap_prc))
+        {
+          break;
+        }
+
+      p_hdr = ap_prc->p_inhdr_;
+      if (p_hdr->nFilledLen > 0
+          && tiz_buffer_push (ap_prc->p_pcm_, p_hdr->pBuffer + p_hdr->nOffset,
+                              p_hdr->nFilledLen)
+               < (int) p_hdr->nFilledLen)
+        {
+          return OMX_ErrorInsufficientResources;
+        }
+      if ((p_hdr->nFlags & OMX_BUFFERFLAG_EOS) != 0)
+        {
+          ap_prc->eos_ = true;
+        }
+      p_hdr->nFilledLen = 0;
+      p_hdr->nOffset = 0;
+      ap_prc->p_inhdr_ = NULL;
+      tiz_check_omx (tiz_krn_release_buffer (
+        tiz_get_krn (handleOf (ap_prc)), ARATELIA_MP3_ENCODER_INPUT_PORT_INDEX,
+        p_hdr));
+    }
+
+  return OMX_ErrorNone;
+}
+
+static void
+segment_done (OMX_PTR ap_prc, tiz_event_pluggable_t * ap_event)
+{
+  mp3e_prc_t * p_prc = ap_prc;
+  mp3e_job_t * p_job = NULL;
+
+  assert (p_prc);
+  assert (ap_event);
+
+  /* The event is part of the job, and goes away with it */
+  p_job = ap_event->p_data;
+  TIZ_TRACE (handleOf (p_prc), "Segment [%u] done", p_job->seq);
+
+  if (mp3e_seg_done (&(p_prc->seg_), p_job) && !p_prc->paused_)
+    {
+      (void) encode_segments (p_prc);
+    }
+}
+
+/* Runs in a worker thread */
+static void
+post_segment_done (void * ap_prc, mp3e_job_t * ap_job)
+{
+  mp3e_prc_t * p_prc = ap_prc;
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+
+  assert (p_prc);
+  assert (ap_job);
+
+  ap_job->event.p_servant = p_prc;
+  ap_job->event.p_data = ap_job;
+  ap_job->event.pf_hdlr = segment_done;
+  if (OMX_ErrorNone
+      != (rc = tiz_comp_event_pluggable (handleOf (p_prc), &(ap_job->event))))
+    {
+      TIZ_ERROR (handleOf (p_prc), "[%s] : Unable to return segment [%u]",
+                 tiz_err_to_str (rc), ap_job->seq);
+    }
+}
+
+static void
+stop_workers (mp3e_prc_t * ap_prc)
+{
+  assert (ap_prc);
+
+  /* The jobs still queued are posted back before the workers quit, and are
+     discarded as stale once they reach segment_done */
+  mp3e_workers_stop (&(ap_prc->workers_));
+  reset_segments (ap_prc);
+  tiz_buffer_destroy (ap_prc->p_pcm_);
+  ap_prc->p_pcm_ = NULL;
+}
+
+static OMX_ERRORTYPE
+start_workers (mp3e_prc_t * ap_prc)
+{
+  assert (ap_prc);
+
+  tiz_check_omx (tiz_buffer_init (&(ap_prc->p_pcm_), INPUT_BUFFER_SIZE));
+  if (OMX_ErrorNone
+      != mp3e_workers_start (&(ap_prc->workers_), ap_prc->nworkers_,
+                             post_segment_done, ap_prc))
+    {
+      tiz_buffer_destroy (ap_prc->p_pcm_);
+      ap_prc->p_pcm_ = NULL;
+      return OMX_ErrorInsufficientResources;
+    }
+
+  return OMX_ErrorNone;
 }
 
 /*
@@ -367,6 +614,14 @@ mp3e_proc_ctor (void * ap_obj, va_list * app)
   p_prc->p_outhdr_ = 0;
   p_prc->eos_ = false;
   p_prc->lame_flushed_ = true;
+  p_prc->settings_.quality = 2;
+  p_prc->settings_.vbr_mode = EMp3eVbrModeCbr;
+  p_prc->settings_.vbr_quality = 4;
+  p_prc->nworkers_ = 1;
+  memset (&(p_prc->workers_), 0, sizeof (p_prc->workers_));
+  mp3e_seg_init (&(p_prc->seg_));
+  p_prc->p_pcm_ = NULL;
+  p_prc->paused_ = false;
   return p_prc;
 }
 
@@ -410,6 +665,14 @@ mp3e_proc_allocate_resources (void * ap_obj, OMX_U32 a_pid)
   (void) lame_set_debugf (p_prc->lame_, lame_debugf);
   (void) lame_set_msgf (p_prc->lame_, lame_debugf);
 
+  read_encoder_settings (p_prc);
+  if (p_prc->nworkers_ > 1 && OMX_ErrorNone != start_workers (p_prc))
+    {
+      TIZ_WARN (handleOf (p_prc),
+                "Could not start the encoding workers; encoding sequentially");
+      p_prc->nworkers_ = 1;
+    }
+
   return OMX_ErrorNone;
 }
 
@@ -419,6 +682,11 @@ mp3e_proc_deallocate_resources (void * ap_obj)
   mp3e_prc_t * p_prc = ap_obj;
   assert (p_prc);
 
+  if (p_prc->workers_.p_jobs)
+    {
+      stop_workers (p_prc);
+    }
+
   if (p_prc->lame_)
     {
       lame_close (p_prc->lame_);
@@ -464,6 +732,12 @@ mp3e_proc_prepare_to_transfer (void * ap_obj, OMX_U32 TIZ_UNUSED (a_pid))
     }
 
   p_prc->lame_flushed_ = false;
+  p_prc->seg_.settings = p_prc->settings_;
+  p_prc->seg_.mp3type = p_prc->mp3type_;
+  p_prc->seg_.sample_len
+    = p_prc->pcmmode_.nChannels * (p_prc->pcmmode_.nBitPerSample / 8);
+  p_prc->seg_.frame_samples = lame_get_framesize (p_prc->lame_);
+  p_prc->paused_ = false;
 
   return OMX_ErrorNone;
 }
@@ -490,6 +764,11 @@ mp3e_proc_buffers_ready (const void * ap_obj)
   mp3e_prc_t * p_prc = (mp3e_prc_t *) ap_obj;
   assert (p_prc);
 
+  if (p_prc->nworkers_ > 1)
+    {
+      return encode_segments (p_prc);
+    }
+
   while (1)
     {
 
@@ -536,6 +815,25 @@ mp3e_proc_buffers_ready (const void * ap_obj)
   return OMX_ErrorNone;
 }
 
+static OMX_ERRORTYPE
+mp3e_proc_pause (const void * ap_obj)
+{
+  mp3e_prc_t * p_prc = (mp3e_prc_t *) ap_obj;
+  assert (p_prc);
+  p_prc->paused_ = true;
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+mp3e_proc_resume (const void * ap_obj)
+{
+  mp3e_prc_t * p_prc = (mp3e_prc_t *) ap_obj;
+  assert (p_prc);
+  p_prc->paused_ = false;
+  /* Segments may have been completed while paused */
+  return (p_prc->nworkers_ > 1 ? encode_segments (p_prc) : OMX_ErrorNone);
+}
+
 static OMX_ERRORTYPE
 mp3e_proc_port_flush (const void * ap_obj, OMX_U32 TIZ_UNUSED (a_pid))
 {
@@ -616,6 +914,10 @@ mp3e_prc_init (void * ap_tos, void * ap_hdl)
      /* TIZ_CLASS_COMMENT: */
      tiz_prc_buffers_ready, mp3e_proc_buffers_ready,
      /* TIZ_CLASS_COMMENT: */
+     tiz_prc_pause, mp3e_proc_pause,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_resume, mp3e_proc_resume,
+     /* TIZ_CLASS_COMMENT: */
      tiz_prc_port_flush, mp3e_proc_port_flush,
      /* TIZ_CLASS_COMMENT: */
      tiz_prc_port_disable, mp3e_proc_port_disable,
@@ -35,6 +35,7 @@ extern "C"
 #endif
 
 #include "mp3eprc.h"
+#include "mp3eseg.h"
 #include "tizprc_decls.h"
 
 #include "OMX_Core.h"
@@ -42,6 +43,8 @@ extern "C"
 #include <stdbool.h>
 #include <lame/lame.h>
 
+#include <tizplatform.h>
+
 #define INPUT_BUFFER_SIZE (5 * 8192)
 #define OUTPUT_BUFFER_SIZE 8192 /* Must be an integer multiple of 4. */
 
@@ -58,6 +61,13 @@ extern "C"
     OMX_BUFFERHEADERTYPE * p_outhdr_;
     bool eos_;
     bool lame_flushed_;
+    mp3e_settings_t settings_;
+    /* Segment-parallel encoding; only used with more than one worker */
+    OMX_U32 nworkers_;
+    mp3e_workers_t workers_;
+    mp3e_seg_t seg_;
+    tiz_buffer_t * p_pcm_;
+    bool paused_;
   };
 
   typedef struct mp3e_prc_class mp3e_prc_class_t;
@@ -0,0 +1,497 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   mp3eseg.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief Tizonia - Mp3 Encoder's segment-parallel encoding
+ *
+ * The processor cuts pcm into jobs, the workers encode them, and the jobs
+ * are put back in sequence before their frames are written out. Nothing in
+ * here touches OpenMAX IL buffers, so that it can be tested on its own.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#include <tizplatform.h>
+
+#include "mp3eseg.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.mp3_encoder.seg"
+#endif
+
+#define MP3E_LAME_MIN_BUFFER_SIZE 7200
+#define MP3E_WORKER_STACK_SIZE (1024 * 1024)
+
+void
+mp3e_configure_lame (const mp3e_settings_t * ap_settings,
+                     const OMX_AUDIO_PARAM_MP3TYPE * ap_mp3type,
+                     lame_t ap_lame)
+{
+  /* OMX bit rates are in bits per second; lame's are in kbps */
+  const int kbps = ap_mp3type->nBitRate >= 1000 ? ap_mp3type->nBitRate / 1000
+                                                : ap_mp3type->nBitRate;
+  int lame_mode = 0;
+
+  assert (ap_settings);
+  assert (ap_mp3type);
+  assert (ap_lame);
+
+  (void) lame_set_num_channels (ap_lame, ap_mp3type->nChannels);
+  (void) lame_set_in_samplerate (ap_lame, ap_mp3type->nSampleRate);
+
+  switch (ap_settings->vbr_mode)
+    {
+      case EMp3eVbrModeAbr:
+        {
+          (void) lame_set_VBR (ap_lame, vbr_abr);
+          (void) lame_set_VBR_mean_bitrate_kbps (ap_lame,
+                                                 kbps > 0 ? kbps : 128);
+        }
+        break;
+      case EMp3eVbrModeVbr:
+        {
+          (void) lame_set_VBR (ap_lame, vbr_default);
+          (void) lame_set_VBR_q (ap_lame, ap_settings->vbr_quality);
+        }
+        break;
+      case EMp3eVbrModeCbr:
+      default:
+        {
+          (void) lame_set_VBR (ap_lame, vbr_off);
+          (void) lame_set_brate (ap_lame, kbps);
+        }
+        break;
+    };
+
+  switch (ap_mp3type->eChannelMode)
+    {
+      case OMX_AUDIO_ChannelModeStereo:
+        {
+          lame_mode = 0;
+        }
+        break;
+      case OMX_AUDIO_ChannelModeJointStereo:
+        {
+          lame_mode = 1;
+        }
+        break;
+      case OMX_AUDIO_ChannelModeDual:
+        {
+          /* Not supported, default to 0 (stereo) */
+          lame_mode = 0;
+        }
+        break;
+      case OMX_AUDIO_ChannelModeMono:
+        {
+          lame_mode = 3;
+        }
+        break;
+
+      default:
+        {
+          lame_mode = 3;
+        }
+    };
+
+  (void) lame_set_mode (ap_lame, lame_mode);
+  (void) lame_set_quality (ap_lame, ap_settings->quality);
+}
+
+size_t
+mp3e_frame_len (const OMX_U8 * ap_hdr, const size_t a_len)
+{
+  static const int bitrates[2][15]
+    = {/* MPEG-1 */
+       {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},
+       /* MPEG-2 and 2.5 */
+       {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}};
+  static const int samplerates[3] = {44100, 48000, 32000};
+  int version = 0;
+  int bitrate_idx = 0;
+  int rate_idx = 0;
+  int samplerate = 0;
+  bool lsf = false;
+
+  assert (ap_hdr);
+
+  if (a_len < 4 || 0xff != ap_hdr[0] || 0xe0 != (ap_hdr[1] & 0xe0))
+    {
+      return 0;
+    }
+
+  /* 0 = MPEG-2.5, 1 = reserved, 2 = MPEG-2, 3 = MPEG-1 */
+  version = (ap_hdr[1] >> 3) & 0x3;
+  bitrate_idx = ap_hdr[2] >> 4;
+  rate_idx = (ap_hdr[2] >> 2) & 0x3;
+  if (1 == version || 1 != ((ap_hdr[1] >> 1) & 0x3) || 0 == bitrate_idx
+      || 15 == bitrate_idx || 3 == rate_idx)
+    {
+      return 0;
+    }
+
+  lsf = (3 != version);
+  samplerate = samplerates[rate_idx] >> (3 == version ? 0 : 3 - version);
+  return (size_t) ((lsf ? 72000 : 144000) * bitrates[lsf][bitrate_idx]
+                   / samplerate)
+         + ((ap_hdr[2] >> 1) & 0x1);
+}
+
+void
+mp3e_job_free (mp3e_job_t * ap_job)
+{
+  if (ap_job)
+    {
+      tiz_mem_free (ap_job->p_pcm);
+      tiz_mem_free (ap_job->p_mp3);
+      tiz_mem_free (ap_job);
+    }
+}
+
+static void
+select_frames (mp3e_job_t * ap_job, const size_t a_len)
+{
+  size_t offset = 0;
+  OMX_U32 frame = 0;
+
+  assert (ap_job);
+
+  ap_job->mp3_offset = 0;
+  ap_job->mp3_end = 0;
+  while (offset < a_len)
+    {
+      const size_t len
+        = mp3e_frame_len (ap_job->p_mp3 + offset, a_len - offset);
+      if (0 == len || offset + len > a_len)
+        {
+          TIZ_LOG (TIZ_PRIORITY_ERROR,
+                   "Bad mp3 frame at offset [%zu] of segment [%u]", offset,
+                   ap_job->seq);
+          break;
+        }
+      offset += len;
+      if (frame < ap_job->lead_in)
+        {
+          ap_job->mp3_offset = offset;
+        }
+      if (ap_job->last || frame < ap_job->lead_in + MP3E_SEGMENT_FRAMES)
+        {
+          ap_job->mp3_end = offset;
+        }
+      ++frame;
+    }
+  ap_job->mp3_end = MAX (ap_job->mp3_end, ap_job->mp3_offset);
+}
+
+void
+mp3e_job_encode (mp3e_job_t * ap_job)
+{
+  size_t max_len = 0;
+  lame_t lame = NULL;
+  int len = 0;
+  int flushed = 0;
+
+  assert (ap_job);
+
+  ap_job->mp3_offset = 0;
+  ap_job->mp3_end = 0;
+  if (0 == ap_job->nsamples)
+    {
+      return;
+    }
+
+  max_len = 5 * ap_job->nsamples / 4 + MP3E_LAME_MIN_BUFFER_SIZE;
+  if (!(ap_job->p_mp3 = tiz_mem_alloc (max_len)) || !(lame = lame_init ()))
+    {
+      TIZ_LOG (TIZ_PRIORITY_ERROR,
+               "[OMX_ErrorInsufficientResources] : segment [%u]",
+               ap_job->seq);
+    }
+  else
+    {
+      mp3e_configure_lame (&(ap_job->settings), &(ap_job->mp3type), lame);
+      (void) lame_set_disable_reservoir (lame, 1);
+      (void) lame_set_bWriteVbrTag (lame, 0);
+      (void) lame_set_write_id3tag_automatic (lame, 0);
+      if (lame_init_params (lame) < 0
+          || (len = lame_encode_buffer_interleaved (
+                lame, (short int *) ap_job->p_pcm, ap_job->nsamples,
+                ap_job->p_mp3, max_len))
+               < 0
+          || (flushed = lame_encode_flush (lame, ap_job->p_mp3 + len,
+                                           max_len - len))
+               < 0)
+        {
+          TIZ_LOG (TIZ_PRIORITY_ERROR,
+                   "lame error [%d] while encoding segment [%u]",
+                   MIN (len, flushed), ap_job->seq);
+        }
+      else
+        {
+          select_frames (ap_job, len + flushed);
+        }
+    }
+
+  if (lame)
+    {
+      lame_close (lame);
+    }
+  tiz_mem_free (ap_job->p_pcm);
+  ap_job->p_pcm = NULL;
+}
+
+void
+mp3e_seg_init (mp3e_seg_t * ap_seg)
+{
+  assert (ap_seg);
+  memset (ap_seg, 0, sizeof (mp3e_seg_t));
+}
+
+void
+mp3e_seg_reset (mp3e_seg_t * ap_seg)
+{
+  int i = 0;
+  assert (ap_seg);
+
+  /* Jobs still with the workers are discarded when they come back */
+  ++(ap_seg->generation);
+  for (i = 0; i < MP3E_MAX_JOBS_IN_FLIGHT; ++i)
+    {
+      mp3e_job_free (ap_seg->p_done[i]);
+      ap_seg->p_done[i] = NULL;
+    }
+  ap_seg->next_seq_out = ap_seg->next_seq_in;
+  ap_seg->lead_in = 0;
+}
+
+size_t
+mp3e_seg_pcm_frame_len (const mp3e_seg_t * ap_seg)
+{
+  assert (ap_seg);
+  return (size_t) ap_seg->frame_samples * ap_seg->sample_len;
+}
+
+bool
+mp3e_seg_ready (const mp3e_seg_t * ap_seg, const size_t a_avail)
+{
+  assert (ap_seg);
+  return a_avail >= (ap_seg->lead_in + MP3E_SEGMENT_FRAMES
+                     + MP3E_LEAD_OUT_FRAMES)
+                      * mp3e_seg_pcm_frame_len (ap_seg);
+}
+
+mp3e_job_t *
+mp3e_seg_cut (mp3e_seg_t * ap_seg, tiz_buffer_t * ap_pcm, const bool a_last)
+{
+  const size_t frame_len = mp3e_seg_pcm_frame_len (ap_seg);
+  const size_t avail = tiz_buffer_available (ap_pcm);
+  const size_t len
+    = a_last ? avail
+             : (ap_seg->lead_in + MP3E_SEGMENT_FRAMES + MP3E_LEAD_OUT_FRAMES)
+                 * frame_len;
+  mp3e_job_t * p_job = NULL;
+
+  assert (ap_seg);
+  assert (ap_pcm);
+  assert (ap_seg->sample_len > 0);
+  assert (len <= avail);
+
+  if (!(p_job = tiz_mem_calloc (1, sizeof (mp3e_job_t)))
+      || (len > 0 && !(p_job->p_pcm = tiz_mem_alloc (len))))
+    {
+      tiz_mem_free (p_job);
+      return NULL;
+    }
+
+  if (len > 0)
+    {
+      memcpy (p_job->p_pcm, tiz_buffer_get (ap_pcm), len);
+    }
+  p_job->settings = ap_seg->settings;
+  p_job->mp3type = ap_seg->mp3type;
+  p_job->seq = ap_seg->next_seq_in++;
+  p_job->generation = ap_seg->generation;
+  p_job->lead_in = ap_seg->lead_in;
+  p_job->last = a_last;
+  p_job->nsamples = len / ap_seg->sample_len;
+
+  if (a_last)
+    {
+      /* The next segment starts a new stream */
+      tiz_buffer_clear (ap_pcm);
+      ap_seg->lead_in = 0;
+    }
+  else
+    {
+      /* Keep the next segment's lead-in */
+      (void) tiz_buffer_advance (
+        ap_pcm, (ap_seg->lead_in + MP3E_SEGMENT_FRAMES - MP3E_LEAD_IN_FRAMES)
+                  * frame_len);
+      ap_seg->lead_in = MP3E_LEAD_IN_FRAMES;
+    }
+
+  ++(ap_seg->jobs_in_flight);
+  return p_job;
+}
+
+bool
+mp3e_seg_done (mp3e_seg_t * ap_seg, mp3e_job_t * ap_job)
+{
+  assert (ap_seg);
+  assert (ap_job);
+  assert (ap_seg->jobs_in_flight > 0);
+
+  --(ap_seg->jobs_in_flight);
+  if (ap_job->generation != ap_seg->generation)
+    {
+      mp3e_job_free (ap_job);
+      return false;
+    }
+
+  ap_seg->p_done[ap_job->seq % MP3E_MAX_JOBS_IN_FLIGHT] = ap_job;
+  return true;
+}
+
+mp3e_job_t *
+mp3e_seg_peek (const mp3e_seg_t * ap_seg)
+{
+  assert (ap_seg);
+  return ap_seg->p_done[ap_seg->next_seq_out % MP3E_MAX_JOBS_IN_FLIGHT];
+}
+
+mp3e_job_t *
+mp3e_seg_pop (mp3e_seg_t * ap_seg)
+{
+  mp3e_job_t * p_job = NULL;
+  assert (ap_seg);
+
+  p_job = ap_seg->p_done[ap_seg->next_seq_out % MP3E_MAX_JOBS_IN_FLIGHT];
+  if (p_job)
+    {
+      ap_seg->p_done[ap_seg->next_seq_out % MP3E_MAX_JOBS_IN_FLIGHT] = NULL;
+      ++(ap_seg->next_seq_out);
+    }
+  return p_job;
+}
+
+OMX_U32
+mp3e_seg_pending (const mp3e_seg_t * ap_seg)
+{
+  assert (ap_seg);
+  return MAX (ap_seg->next_seq_in - ap_seg->next_seq_out,
+              ap_seg->jobs_in_flight);
+}
+
+static void *
+worker_thread_func (void * ap_arg)
+{
+  mp3e_workers_t * p_workers = ap_arg;
+  assert (p_workers);
+
+  while (1)
+    {
+      mp3e_job_t * p_job = NULL;
+
+      (void) tiz_queue_receive (p_workers->p_jobs, (OMX_PTR *) &p_job);
+      if (p_job == &(p_workers->quit_job))
+        {
+          break;
+        }
+
+      /* The job always goes back, encoded or not, so the sequence never
+         stalls */
+      mp3e_job_encode (p_job);
+      p_workers->pf_done (p_workers->p_arg, p_job);
+    }
+
+  return NULL;
+}
+
+OMX_ERRORTYPE
+mp3e_workers_start (mp3e_workers_t * ap_workers, const OMX_U32 a_nworkers,
+                    mp3e_job_done_f apf_done, void * ap_arg)
+{
+  OMX_U32 i = 0;
+  assert (ap_workers);
+  assert (apf_done);
+  assert (a_nworkers <= MP3E_MAX_WORKERS);
+
+  ap_workers->nworkers = 0;
+  ap_workers->pf_done = apf_done;
+  ap_workers->p_arg = ap_arg;
+  tiz_check_omx (
+    tiz_queue_init (&(ap_workers->p_jobs), MP3E_MAX_JOBS_IN_FLIGHT));
+
+  for (i = 0; i < a_nworkers; ++i)
+    {
+      if (OMX_ErrorNone
+          != tiz_thread_create (&(ap_workers->threads[i]),
+                                MP3E_WORKER_STACK_SIZE, 0, worker_thread_func,
+                                ap_workers))
+        {
+          mp3e_workers_stop (ap_workers);
+          return OMX_ErrorInsufficientResources;
+        }
+      (void) tiz_thread_setname (&(ap_workers->threads[i]),
+                                 (OMX_STRING) "tizmp3enc");
+      ap_workers->nworkers = i + 1;
+    }
+
+  return OMX_ErrorNone;
+}
+
+OMX_ERRORTYPE
+mp3e_workers_submit (mp3e_workers_t * ap_workers, mp3e_job_t * ap_job)
+{
+  assert (ap_workers);
+  assert (ap_job);
+  return tiz_queue_send (ap_workers->p_jobs, ap_job);
+}
+
+void
+mp3e_workers_stop (mp3e_workers_t * ap_workers)
+{
+  OMX_U32 i = 0;
+  assert (ap_workers);
+
+  /* The quit jobs go behind the pending ones, which are still encoded and
+     handed back */
+  for (i = 0; i < ap_workers->nworkers; ++i)
+    {
+      (void) tiz_queue_send (ap_workers->p_jobs, &(ap_workers->quit_job));
+    }
+  for (i = 0; i < ap_workers->nworkers; ++i)
+    {
+      void * p_result = NULL;
+      (void) tiz_thread_join (&(ap_workers->threads[i]), &p_result);
+    }
+  ap_workers->nworkers = 0;
+
+  tiz_queue_destroy (ap_workers->p_jobs);
+  ap_workers->p_jobs = NULL;
+}
@@ -0,0 +1,220 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   mp3eseg.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief Tizonia - Mp3 Encoder's segment-parallel encoding
+ *
+ *
+ */
+
+#ifndef MP3ESEG_H
+#define MP3ESEG_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <lame/lame.h>
+
+#include <OMX_Audio.h>
+#include <OMX_Core.h>
+#include <OMX_Types.h>
+
+#include <tizplatform.h>
+#include <tizscheduler.h>
+
+#define MP3E_MAX_WORKERS 16
+#define MP3E_MAX_JOBS_IN_FLIGHT (2 * MP3E_MAX_WORKERS)
+
+/* Pcm is split in segments of MP3E_SEGMENT_FRAMES mp3 frames, which are
+   encoded independently. Each segment is preceded by MP3E_LEAD_IN_FRAMES
+   frames of the previous one, and followed by MP3E_LEAD_OUT_FRAMES frames of
+   the next one, so that the encoder's delay and look-ahead see the same
+   signal as in a single pass. The bit reservoir is disabled, which makes
+   every frame self-contained, and only the segment's own frames are kept. */
+#define MP3E_SEGMENT_FRAMES 64
+#define MP3E_LEAD_IN_FRAMES 3
+#define MP3E_LEAD_OUT_FRAMES 2
+
+  typedef enum mp3e_vbr_mode mp3e_vbr_mode_t;
+  enum mp3e_vbr_mode
+  {
+    EMp3eVbrModeCbr,
+    EMp3eVbrModeAbr,
+    EMp3eVbrModeVbr
+  };
+
+  typedef struct mp3e_settings mp3e_settings_t;
+  struct mp3e_settings
+  {
+    int quality;
+    mp3e_vbr_mode_t vbr_mode;
+    int vbr_quality;
+  };
+
+  /* A segment of pcm, and the mp3 frames it has been encoded to */
+  typedef struct mp3e_job mp3e_job_t;
+  struct mp3e_job
+  {
+    /* Allocated with the job, so that handing the result back to the
+       component thread never depends on a further allocation */
+    tiz_event_pluggable_t event;
+    mp3e_settings_t settings;
+    OMX_AUDIO_PARAM_MP3TYPE mp3type;
+    OMX_U32 seq;
+    OMX_U32 generation;
+    OMX_U32 lead_in; /* Frames encoded only to prime the encoder */
+    bool last;       /* Keep all the frames after the lead-in */
+    OMX_U8 * p_pcm;
+    int nsamples;
+    OMX_U8 * p_mp3;
+    size_t mp3_offset;
+    size_t mp3_end;
+  };
+
+  /* Cuts pcm into jobs, and puts the encoded jobs back in sequence */
+  typedef struct mp3e_seg mp3e_seg_t;
+  struct mp3e_seg
+  {
+    mp3e_settings_t settings;
+    OMX_AUDIO_PARAM_MP3TYPE mp3type;
+    size_t sample_len;  /* Bytes per interleaved sample */
+    int frame_samples;  /* Samples per mp3 frame */
+    OMX_U32 lead_in;
+    OMX_U32 generation;
+    OMX_U32 next_seq_in;
+    OMX_U32 next_seq_out;
+    OMX_U32 jobs_in_flight;
+    mp3e_job_t * p_done[MP3E_MAX_JOBS_IN_FLIGHT];
+  };
+
+  typedef void (*mp3e_job_done_f) (void * ap_arg, mp3e_job_t * ap_job);
+
+  typedef struct mp3e_workers mp3e_workers_t;
+  struct mp3e_workers
+  {
+    OMX_U32 nworkers;
+    tiz_thread_t threads[MP3E_MAX_WORKERS];
+    tiz_queue_t * p_jobs;
+    mp3e_job_t quit_job;
+    mp3e_job_done_f pf_done;
+    void * p_arg;
+  };
+
+  void
+  mp3e_configure_lame (const mp3e_settings_t * ap_settings,
+                       const OMX_AUDIO_PARAM_MP3TYPE * ap_mp3type,
+                       lame_t ap_lame);
+
+  /**
+   * The length of the Layer III frame starting at @a ap_hdr, or 0 if there
+   * is no valid frame header there.
+   */
+  size_t
+  mp3e_frame_len (const OMX_U8 * ap_hdr, const size_t a_len);
+
+  void
+  mp3e_job_free (mp3e_job_t * ap_job);
+
+  /**
+   * Encode the job's pcm with a fresh lame instance, and select the frames
+   * that belong to the segment (between mp3_offset and mp3_end). On error,
+   * no frames are selected.
+   */
+  void
+  mp3e_job_encode (mp3e_job_t * ap_job);
+
+  void
+  mp3e_seg_init (mp3e_seg_t * ap_seg);
+
+  /**
+   * Discard the jobs waiting to be delivered, and make the ones still being
+   * encoded stale, so that they are discarded when they are done.
+   */
+  void
+  mp3e_seg_reset (mp3e_seg_t * ap_seg);
+
+  /* Bytes of pcm per mp3 frame */
+  size_t
+  mp3e_seg_pcm_frame_len (const mp3e_seg_t * ap_seg);
+
+  /* Whether @a a_avail bytes of pcm are enough to cut a segment that is not
+     the last one */
+  bool
+  mp3e_seg_ready (const mp3e_seg_t * ap_seg, const size_t a_avail);
+
+  /**
+   * Cut the next segment from the front of @a ap_pcm. With @a a_last, all
+   * the remaining pcm goes in the segment, and the next one starts a new
+   * stream. Otherwise, the next segment's lead-in is left in the buffer.
+   *
+   * @return The new job, in flight until passed to mp3e_seg_done, or NULL if
+   * OOM.
+   */
+  mp3e_job_t *
+  mp3e_seg_cut (mp3e_seg_t * ap_seg, tiz_buffer_t * ap_pcm, const bool a_last);
+
+  /**
+   * Take back a job that has been encoded.
+   *
+   * @return false if the job was stale and has been freed.
+   */
+  bool
+  mp3e_seg_done (mp3e_seg_t * ap_seg, mp3e_job_t * ap_job);
+
+  /* The next job in sequence, if it has been encoded already */
+  mp3e_job_t *
+  mp3e_seg_peek (const mp3e_seg_t * ap_seg);
+
+  /* Remove the job returned by mp3e_seg_peek; the caller frees it */
+  mp3e_job_t *
+  mp3e_seg_pop (mp3e_seg_t * ap_seg);
+
+  OMX_U32
+  mp3e_seg_pending (const mp3e_seg_t * ap_seg);
+
+  /**
+   * Start @a a_nworkers threads that encode the jobs submitted, and pass each
+   * of them to @a apf_done, from the worker's thread, when it is done.
+   */
+  OMX_ERRORTYPE
+  mp3e_workers_start (mp3e_workers_t * ap_workers, const OMX_U32 a_nworkers,
+                      mp3e_job_done_f apf_done, void * ap_arg);
+
+  OMX_ERRORTYPE
+  mp3e_workers_submit (mp3e_workers_t * ap_workers, mp3e_job_t * ap_job);
+
+  /**
+   * Stop the workers. Every job submitted before this call has been passed to
+   * the done callback when it returns.
+   */
+  void
+  mp3e_workers_stop (mp3e_workers_t * ap_workers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MP3ESEG_H */
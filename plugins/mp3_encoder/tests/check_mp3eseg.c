@@ -0,0 +1,527 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_mp3eseg.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Mp3 encoder's segment-parallel encoding unit tests
+ *
+ * The pcm is a synthetic, deterministic signal. It is encoded at 48 kHz and
+ * 128 kbps CBR, where every frame is exactly 384 bytes long (no padding
+ * slots), so that the segmented and the single-pass streams can be compared
+ * frame by frame.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <check.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tizplatform.h>
+
+#include "mp3eseg.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.mp3_encoder.check"
+#endif
+
+#define MP3ESEG_TEST_TIMEOUT 60
+
+#define PCM_SAMPLE_RATE 48000
+#define PCM_CHANNELS 2
+#define PCM_SAMPLE_LEN (PCM_CHANNELS * sizeof (int16_t))
+#define PCM_SECONDS 10
+/* The size of the encoder's input buffers */
+#define PCM_CHUNK_SIZE (5 * 8192)
+
+#define MP3_BIT_RATE 128000
+#define MP3_FRAME_SIZE 384
+#define MP3_FRAME_SAMPLES 1152
+
+typedef struct mp3_stream mp3_stream_t;
+struct mp3_stream
+{
+  OMX_U8 * p_data;
+  size_t len;
+  size_t nframes;
+};
+
+static OMX_U8 * gp_pcm = NULL;
+static size_t g_pcm_len = 0;
+
+static void
+make_pcm (void)
+{
+  const size_t nsamples = PCM_SAMPLE_RATE * PCM_SECONDS;
+  int16_t * p_pcm = NULL;
+  uint32_t noise = 12345;
+  size_t i = 0;
+
+  g_pcm_len = nsamples * PCM_SAMPLE_LEN;
+  gp_pcm = tiz_mem_alloc (g_pcm_len);
+  fail_if (NULL == gp_pcm);
+
+  /* Two tones, a sweep and some noise, different on each channel */
+  p_pcm = (int16_t *) gp_pcm;
+  for (i = 0; i < nsamples; ++i)
+    {
+      const double t = (double) i / PCM_SAMPLE_RATE;
+      noise = noise * 1103515245 + 12345;
+      p_pcm[2 * i] = (int16_t) (8000 * sin (2 * M_PI * 440 * t)
+                                + 3000 * sin (2 * M_PI * (200 + 400 * t) * t)
+                                + (int) ((noise >> 16) & 0x3ff) - 512);
+      p_pcm[2 * i + 1] = (int16_t) (8000 * sin (2 * M_PI * 660 * t)
+                                    + (int) ((noise >> 8) & 0x3ff) - 512);
+    }
+}
+
+static void
+setup (void)
+{
+  make_pcm ();
+}
+
+static void
+teardown (void)
+{
+  tiz_mem_free (gp_pcm);
+  gp_pcm = NULL;
+  g_pcm_len = 0;
+}
+
+static void
+init_settings (mp3e_settings_t * ap_settings,
+               OMX_AUDIO_PARAM_MP3TYPE * ap_mp3type)
+{
+  ap_settings->quality = 2;
+  ap_settings->vbr_mode = EMp3eVbrModeCbr;
+  ap_settings->vbr_quality = 4;
+
+  memset (ap_mp3type, 0, sizeof (OMX_AUDIO_PARAM_MP3TYPE));
+  ap_mp3type->nChannels = PCM_CHANNELS;
+  ap_mp3type->nSampleRate = PCM_SAMPLE_RATE;
+  ap_mp3type->nBitRate = MP3_BIT_RATE;
+  ap_mp3type->eChannelMode = OMX_AUDIO_ChannelModeJointStereo;
+  ap_mp3type->eFormat = OMX_AUDIO_MP3StreamFormatMP1Layer3;
+}
+
+static void
+init_seg (mp3e_seg_t * ap_seg)
+{
+  mp3e_seg_init (ap_seg);
+  init_settings (&(ap_seg->settings), &(ap_seg->mp3type));
+  ap_seg->sample_len = PCM_SAMPLE_LEN;
+  ap_seg->frame_samples = MP3_FRAME_SAMPLES;
+}
+
+static void
+append_frames (mp3_stream_t * ap_stream, const OMX_U8 * ap_data,
+               const size_t a_len)
+{
+  size_t offset = 0;
+
+  ap_stream->p_data = realloc (ap_stream->p_data, ap_stream->len + a_len);
+  fail_if (NULL == ap_stream->p_data);
+  memcpy (ap_stream->p_data + ap_stream->len, ap_data, a_len);
+  ap_stream->len += a_len;
+
+  while (offset < a_len)
+    {
+      const size_t len = mp3e_frame_len (ap_data + offset, a_len - offset);
+      fail_if (0 == len, "Bad frame header at offset [%zu]", offset);
+      offset += len;
+      ap_stream->nframes++;
+    }
+  fail_if (offset != a_len);
+}
+
+static void
+append_job (mp3_stream_t * ap_stream, const mp3e_job_t * ap_job)
+{
+  fail_if (ap_job->mp3_end < ap_job->mp3_offset);
+  append_frames (ap_stream, ap_job->p_mp3 + ap_job->mp3_offset,
+                 ap_job->mp3_end - ap_job->mp3_offset);
+}
+
+static void
+encode_single_pass (mp3_stream_t * ap_stream)
+{
+  const int max_len = 5 * (g_pcm_len / PCM_SAMPLE_LEN) / 4 + 7200;
+  mp3e_settings_t settings;
+  OMX_AUDIO_PARAM_MP3TYPE mp3type;
+  OMX_U8 * p_mp3 = NULL;
+  lame_t lame = NULL;
+  int len = 0;
+  int flushed = 0;
+
+  init_settings (&settings, &mp3type);
+  fail_if (NULL == (lame = lame_init ()));
+  mp3e_configure_lame (&settings, &mp3type, lame);
+  /* Same as the segments, so that the streams only differ in the use of the
+     bit reservoir */
+  (void) lame_set_bWriteVbrTag (lame, 0);
+  (void) lame_set_write_id3tag_automatic (lame, 0);
+  fail_if (lame_init_params (lame) < 0);
+  fail_if (MP3_FRAME_SAMPLES != lame_get_framesize (lame));
+
+  p_mp3 = tiz_mem_alloc (max_len);
+  fail_if (NULL == p_mp3);
+  len = lame_encode_buffer_interleaved (lame, (short int *) gp_pcm,
+                                        g_pcm_len / PCM_SAMPLE_LEN, p_mp3,
+                                        max_len);
+  fail_if (len < 0);
+  flushed = lame_encode_flush (lame, p_mp3 + len, max_len - len);
+  fail_if (flushed < 0);
+  lame_close (lame);
+
+  append_frames (ap_stream, p_mp3, len + flushed);
+  tiz_mem_free (p_mp3);
+}
+
+/* Feed the pcm in input-buffer sized chunks, and cut segments the way the
+   processor does */
+static void
+encode_segmented (mp3_stream_t * ap_stream)
+{
+  mp3e_seg_t seg;
+  tiz_buffer_t * p_pcm = NULL;
+  size_t offset = 0;
+  bool eos = false;
+
+  init_seg (&seg);
+  fail_if (OMX_ErrorNone != tiz_buffer_init (&p_pcm, PCM_CHUNK_SIZE));
+
+  while (!eos)
+    {
+      const size_t len = MIN (PCM_CHUNK_SIZE, g_pcm_len - offset);
+      mp3e_job_t * p_job = NULL;
+
+      fail_if (tiz_buffer_push (p_pcm, gp_pcm + offset, len) < (int) len);
+      offset += len;
+      eos = (offset == g_pcm_len);
+
+      while (mp3e_seg_ready (&seg, tiz_buffer_available (p_pcm)) || eos)
+        {
+          const bool last
+            = !mp3e_seg_ready (&seg, tiz_buffer_available (p_pcm));
+          fail_if (NULL == (p_job = mp3e_seg_cut (&seg, p_pcm, last)));
+          mp3e_job_encode (p_job);
+          fail_if (!mp3e_seg_done (&seg, p_job));
+          fail_if (p_job != mp3e_seg_pop (&seg));
+          append_job (ap_stream, p_job);
+          mp3e_job_free (p_job);
+          if (last)
+            {
+              break;
+            }
+        }
+    }
+
+  fail_if (0 != seg.jobs_in_flight);
+  fail_if (0 != tiz_buffer_available (p_pcm));
+  tiz_buffer_destroy (p_pcm);
+}
+
+/* Stands in for the component's event queue; runs in a worker thread */
+static void
+queue_done_job (void * ap_queue, mp3e_job_t * ap_job)
+{
+  OMX_ERRORTYPE rc = tiz_queue_send (ap_queue, ap_job);
+  assert (OMX_ErrorNone == rc);
+  (void) rc;
+}
+
+static void
+receive_done_jobs (mp3e_seg_t * ap_seg, tiz_queue_t * ap_done,
+                   mp3_stream_t * ap_stream)
+{
+  mp3e_job_t * p_job = NULL;
+
+  fail_if (OMX_ErrorNone != tiz_queue_receive (ap_done, (OMX_PTR *) &p_job));
+  fail_if (!mp3e_seg_done (ap_seg, p_job));
+  while ((p_job = mp3e_seg_pop (ap_seg)))
+    {
+      append_job (ap_stream, p_job);
+      mp3e_job_free (p_job);
+    }
+}
+
+static void
+encode_with_workers (mp3_stream_t * ap_stream, const OMX_U32 a_nworkers)
+{
+  mp3e_seg_t seg;
+  mp3e_workers_t workers;
+  tiz_queue_t * p_done = NULL;
+  tiz_buffer_t * p_pcm = NULL;
+  size_t offset = 0;
+  bool last_cut = false;
+
+  init_seg (&seg);
+  memset (&workers, 0, sizeof (workers));
+  fail_if (OMX_ErrorNone
+           != tiz_queue_init (&p_done, MP3E_MAX_JOBS_IN_FLIGHT));
+  fail_if (OMX_ErrorNone != tiz_buffer_init (&p_pcm, PCM_CHUNK_SIZE));
+  fail_if (OMX_ErrorNone
+           != mp3e_workers_start (&workers, a_nworkers, queue_done_job,
+                                  p_done));
+
+  while (!last_cut || mp3e_seg_pending (&seg) > 0)
+    {
+      /* Keep the workers busy, within the processor's limit */
+      while (!last_cut && mp3e_seg_pending (&seg) < 2 * a_nworkers)
+        {
+          mp3e_job_t * p_job = NULL;
+          const bool eos = (offset == g_pcm_len);
+
+          if (!eos && !mp3e_seg_ready (&seg, tiz_buffer_available (p_pcm)))
+            {
+              const size_t len = MIN (PCM_CHUNK_SIZE, g_pcm_len - offset);
+              fail_if (tiz_buffer_push (p_pcm, gp_pcm + offset, len)
+                       < (int) len);
+              offset += len;
+              continue;
+            }
+
+          last_cut = !mp3e_seg_ready (&seg, tiz_buffer_available (p_pcm));
+          fail_if (NULL == (p_job = mp3e_seg_cut (&seg, p_pcm, last_cut)));
+          fail_if (OMX_ErrorNone != mp3e_workers_submit (&workers, p_job));
+        }
+
+      if (mp3e_seg_pending (&seg) > 0)
+        {
+          receive_done_jobs (&seg, p_done, ap_stream);
+        }
+    }
+
+  mp3e_workers_stop (&workers);
+  fail_if (0 != tiz_queue_length (p_done));
+  tiz_queue_destroy (p_done);
+  tiz_buffer_destroy (p_pcm);
+}
+
+static void
+free_stream (mp3_stream_t * ap_stream)
+{
+  free (ap_stream->p_data);
+  memset (ap_stream, 0, sizeof (mp3_stream_t));
+}
+
+START_TEST (test_mp3eseg_frame_len)
+{
+  /* MPEG-1 Layer III, 128 kbps */
+  const OMX_U8 mpeg1_44k[] = {0xff, 0xfb, 0x90, 0x44};
+  const OMX_U8 mpeg1_44k_padded[] = {0xff, 0xfb, 0x92, 0x44};
+  const OMX_U8 mpeg1_48k[] = {0xff, 0xfb, 0x94, 0x44};
+  /* MPEG-2 Layer III, 64 kbps, 24 kHz */
+  const OMX_U8 mpeg2_24k[] = {0xff, 0xf3, 0x84, 0x44};
+  /* Free format, layer II, and no sync word */
+  const OMX_U8 free_format[] = {0xff, 0xfb, 0x04, 0x44};
+  const OMX_U8 layer2[] = {0xff, 0xfd, 0x90, 0x44};
+  const OMX_U8 no_sync[] = {0x00, 0xfb, 0x90, 0x44};
+
+  ck_assert_int_eq (mp3e_frame_len (mpeg1_44k, 4), 417);
+  ck_assert_int_eq (mp3e_frame_len (mpeg1_44k_padded, 4), 418);
+  ck_assert_int_eq (mp3e_frame_len (mpeg1_48k, 4), MP3_FRAME_SIZE);
+  ck_assert_int_eq (mp3e_frame_len (mpeg2_24k, 4), 192);
+  ck_assert_int_eq (mp3e_frame_len (free_format, 4), 0);
+  ck_assert_int_eq (mp3e_frame_len (layer2, 4), 0);
+  ck_assert_int_eq (mp3e_frame_len (no_sync, 4), 0);
+  ck_assert_int_eq (mp3e_frame_len (mpeg1_48k, 3), 0);
+}
+END_TEST
+
+START_TEST (test_mp3eseg_matches_single_pass)
+{
+  mp3_stream_t single;
+  mp3_stream_t segmented;
+  size_t offset = 0;
+
+  memset (&single, 0, sizeof (single));
+  memset (&segmented, 0, sizeof (segmented));
+  encode_single_pass (&single);
+  encode_segmented (&segmented);
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "single pass [%zu] frames, segmented [%zu]",
+           single.nframes, segmented.nframes);
+
+  /* Covers several segments, and ends in a partial one */
+  fail_if (single.nframes < 4 * MP3E_SEGMENT_FRAMES);
+  fail_if (0 == single.nframes % MP3E_SEGMENT_FRAMES);
+
+  /* The lead-in and lead-out frames have all been dropped, and no frame is
+     missing at the segment boundaries or at the end of the stream */
+  ck_assert_int_eq (segmented.nframes, single.nframes);
+  ck_assert_int_eq (segmented.len, single.len);
+  ck_assert_int_eq (single.len, single.nframes * MP3_FRAME_SIZE);
+
+  /* Same bit rate, sample rate and mode, frame by frame */
+  for (offset = 0; offset < single.len; offset += MP3_FRAME_SIZE)
+    {
+      fail_if (0 != memcmp (single.p_data + offset, segmented.p_data + offset,
+                            3),
+               "Frame [%zu] headers differ", offset / MP3_FRAME_SIZE);
+    }
+
+  free_stream (&single);
+  free_stream (&segmented);
+}
+END_TEST
+
+START_TEST (test_mp3eseg_workers_keep_order)
+{
+  mp3_stream_t segmented;
+  mp3_stream_t one_worker;
+  mp3_stream_t four_workers;
+
+  memset (&segmented, 0, sizeof (segmented));
+  memset (&one_worker, 0, sizeof (one_worker));
+  memset (&four_workers, 0, sizeof (four_workers));
+  encode_segmented (&segmented);
+  encode_with_workers (&one_worker, 1);
+  encode_with_workers (&four_workers, 4);
+
+  /* Segments are independent of each other, so the output does not depend
+     on how many of them were encoded at the same time */
+  ck_assert_int_eq (one_worker.len, segmented.len);
+  ck_assert_int_eq (four_workers.len, segmented.len);
+  fail_if (0 != memcmp (one_worker.p_data, segmented.p_data, segmented.len));
+  fail_if (0 != memcmp (four_workers.p_data, segmented.p_data,
+                        segmented.len));
+
+  free_stream (&segmented);
+  free_stream (&one_worker);
+  free_stream (&four_workers);
+}
+END_TEST
+
+START_TEST (test_mp3eseg_stop_with_results_queued)
+{
+  const OMX_U32 nworkers = 2;
+  mp3e_seg_t seg;
+  mp3e_workers_t workers;
+  tiz_queue_t * p_done = NULL;
+  tiz_buffer_t * p_pcm = NULL;
+  mp3e_job_t * p_job = NULL;
+  OMX_U32 submitted = 0;
+
+  init_seg (&seg);
+  memset (&workers, 0, sizeof (workers));
+  fail_if (OMX_ErrorNone
+           != tiz_queue_init (&p_done, MP3E_MAX_JOBS_IN_FLIGHT));
+  fail_if (OMX_ErrorNone != tiz_buffer_init (&p_pcm, g_pcm_len));
+  fail_if (tiz_buffer_push (p_pcm, gp_pcm, g_pcm_len) < (int) g_pcm_len);
+  fail_if (OMX_ErrorNone
+           != mp3e_workers_start (&workers, nworkers, queue_done_job,
+                                  p_done));
+
+  for (submitted = 0; submitted < 2 * nworkers; ++submitted)
+    {
+      fail_if (NULL == (p_job = mp3e_seg_cut (&seg, p_pcm, false)));
+      fail_if (OMX_ErrorNone != mp3e_workers_submit (&workers, p_job));
+    }
+
+  /* Stop while jobs are still queued or being encoded, and before any of
+     the results has been received, as when the component goes to Loaded */
+  mp3e_workers_stop (&workers);
+  mp3e_seg_reset (&seg);
+
+  /* Every job has been handed back, none has been lost */
+  ck_assert_int_eq (tiz_queue_length (p_done), submitted);
+  ck_assert_int_eq (seg.jobs_in_flight, submitted);
+
+  /* The results arriving after the reset are stale, and are discarded */
+  while (tiz_queue_length (p_done) > 0)
+    {
+      fail_if (OMX_ErrorNone
+               != tiz_queue_receive (p_done, (OMX_PTR *) &p_job));
+      fail_if (mp3e_seg_done (&seg, p_job));
+    }
+  ck_assert_int_eq (seg.jobs_in_flight, 0);
+  ck_assert_int_eq (mp3e_seg_pending (&seg), 0);
+  fail_if (NULL != mp3e_seg_peek (&seg));
+
+  /* A new stream starts cleanly after the reset */
+  tiz_buffer_clear (p_pcm);
+  fail_if (tiz_buffer_push (p_pcm, gp_pcm, g_pcm_len) < (int) g_pcm_len);
+  fail_if (NULL == (p_job = mp3e_seg_cut (&seg, p_pcm, false)));
+  ck_assert_int_eq (p_job->lead_in, 0);
+  mp3e_job_encode (p_job);
+  fail_if (!mp3e_seg_done (&seg, p_job));
+  fail_if (p_job != mp3e_seg_pop (&seg));
+  ck_assert_int_eq (p_job->mp3_end - p_job->mp3_offset,
+                    MP3E_SEGMENT_FRAMES * MP3_FRAME_SIZE);
+  mp3e_job_free (p_job);
+
+  tiz_queue_destroy (p_done);
+  tiz_buffer_destroy (p_pcm);
+}
+END_TEST
+
+Suite *
+mp3eseg_suite (void)
+{
+  TCase * tc_mp3eseg;
+  Suite * s = suite_create ("mp3 encoder segments");
+
+  tc_mp3eseg = tcase_create ("segment-parallel encoding");
+  tcase_set_timeout (tc_mp3eseg, MP3ESEG_TEST_TIMEOUT);
+  tcase_add_checked_fixture (tc_mp3eseg, setup, teardown);
+  tcase_add_test (tc_mp3eseg, test_mp3eseg_frame_len);
+  tcase_add_test (tc_mp3eseg, test_mp3eseg_matches_single_pass);
+  tcase_add_test (tc_mp3eseg, test_mp3eseg_workers_keep_order);
+  tcase_add_test (tc_mp3eseg, test_mp3eseg_stop_with_results_queued);
+  suite_add_tcase (s, tc_mp3eseg);
+
+  return s;
+}
+
+int
+main (void)
+{
+  int number_failed = 1;
+  SRunner * sr = NULL;
+
+  tiz_log_init ();
+
+  sr = srunner_create (mp3eseg_suite ());
+  srunner_set_log (sr, "-");
+  srunner_run_all (sr, CK_VERBOSE);
+  number_failed = srunner_ntests_failed (sr);
+  srunner_free (sr);
+
+  tiz_log_deinit ();
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Local Variables: */
+/* c-default-style: gnu */
+/* fill-column: 79 */
+/* indent-tabs-mode: nil */
+/* compile-command: "make check" */
+/* End: */
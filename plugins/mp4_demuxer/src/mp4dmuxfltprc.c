@@ -56,11 +56,17 @@
 #define TIZ_LOG_CATEGORY_NAME "tiz.mp4_demuxer.filter.prc"
 #endif
 
-static mp4dmuxflt_prc_t * gp_prc = NULL;
-
 #define FILE_SIZE 7747480
 #define MP4V2_INT_MAX_FAILED_ATTEMPTS 20
 
+/* The name handed to MP4ReadProvider; it carries the processor instance so
+   that the I/O callbacks can find it without any global state */
+#define MP4V2_PROVIDER_NAME_FMT "tizonia-mp4dmux:%p"
+#define MP4V2_PROVIDER_NAME_MAX 64
+
+/* Minimum size of the window through which mp4v2's reads are served */
+#define MP4V2_READ_CACHE_MIN_SIZE (64 * 1024)
+
 /* Forward declarations */
 static OMX_ERRORTYPE
 mp4dmuxflt_prc_deallocate_resources (void *);
@@ -70,6 +76,9 @@ static void
 reset_mp4v2_members (mp4dmuxflt_prc_t * ap_prc);
 static OMX_ERRORTYPE
 send_port_auto_detect_events (mp4dmuxflt_prc_t * ap_prc);
+static int64_t
+read_spooled_data (mp4dmuxflt_prc_t * ap_prc, OMX_U8 * ap_dst,
+                   const int64_t a_size);
 
 #define on_nestegg_error_ret_omx_oom(expr)                            \
   do                                                                  \
@@ -100,6 +109,9 @@ mp4_log_cback (MP4LogLevel loglevel, const char * fmt, va_list ap)
   char * buffer = alloca (MAX_ALLOCA_BUF);
   vsnprintf (buffer, MAX_ALLOCA_BUF, fmt, ap);
 
+  /* NOTE: mp4v2's log callback is process-wide and carries no user data, so
+     these messages can't be attributed to a particular component instance */
+
   /* typedef enum {
      MP4_LOG_NONE = 0,
      MP4_LOG_ERROR = 1,
@@ -116,22 +128,22 @@ mp4_log_cback (MP4LogLevel loglevel, const char * fmt, va_list ap)
     {
     case MP4_LOG_ERROR:
       {
-        TIZ_ERROR(handleOf(gp_prc), "%s", buffer);
+        TIZ_LOG(TIZ_PRIORITY_ERROR, "%s", buffer);
       }
       break;
     case MP4_LOG_INFO:
       {
-        TIZ_NOTICE(handleOf(gp_prc), "%s", buffer);
+        TIZ_LOG(TIZ_PRIORITY_NOTICE, "%s", buffer);
       }
       break;
     case MP4_LOG_WARNING:
       {
-        TIZ_DEBUG(handleOf(gp_prc), "%s", buffer);
+        TIZ_LOG(TIZ_PRIORITY_DEBUG, "%s", buffer);
       }
       break;
     default:
       {
-        TIZ_TRACE(handleOf(gp_prc), "%s", buffer);
+        TIZ_LOG(TIZ_PRIORITY_TRACE, "%s", buffer);
       }
       break;
     };
@@ -140,18 +152,31 @@ mp4_log_cback (MP4LogLevel loglevel, const char * fmt, va_list ap)
 static void *
 mp4_open_cback (const char * name, MP4FileMode mode)
 {
-  TIZ_TRACE(handleOf(gp_prc), "file name [%s]", name);
-  return gp_prc;
+  void * p_prc = NULL;
+  assert (name);
+  /* The instance pointer was encoded in the name by alloc_mp4v2 */
+  if (1 != sscanf (name, MP4V2_PROVIDER_NAME_FMT, &p_prc) || !p_prc)
+    {
+      TIZ_LOG (TIZ_PRIORITY_ERROR, "Unexpected file name [%s]", name);
+      return NULL;
+    }
+  TIZ_TRACE(handleOf(p_prc), "file name [%s]", name);
+  return p_prc;
 }
 
 static int
 mp4_seek_cback (void * ap_handle, int64_t pos)
 {
   mp4dmuxflt_prc_t * p_prc = ap_handle;
-  assert (gp_prc == ap_handle);
   assert (p_prc);
-  TIZ_TRACE(handleOf(gp_prc), "pos [%lld]", pos);
-  (void)tiz_buffer_seek (p_prc->p_mp4_store_, pos, TIZ_BUFFER_SEEK_SET);
+  TIZ_TRACE(handleOf(p_prc), "pos [%lld]", pos);
+  if (pos < 0)
+    {
+      return -1;
+    }
+  /* Seeking beyond the data received so far is fine; the next read will
+     simply fail until the data arrives */
+  p_prc->read_pos_ = pos;
   return 0;
 }
 
@@ -162,7 +187,6 @@ mp4_read_cback (void * ap_handle, void * ap_buffer, int64_t a_size,
   mp4dmuxflt_prc_t * p_prc = ap_handle;
   int retval = -1;
 
-  assert (gp_prc == ap_handle);
   assert (p_prc);
   assert (ap_buffer);
   assert (ap_nin);
@@ -170,7 +194,7 @@ mp4_read_cback (void * ap_handle, void * ap_buffer, int64_t a_size,
   *ap_nin = 0;
 
   if (tiz_filter_prc_is_eos (p_prc)
-      && tiz_buffer_available (p_prc->p_mp4_store_) == 0)
+      && p_prc->read_pos_ >= p_prc->spooled_len_)
     {
       TIZ_DEBUG (handleOf (p_prc), "out of compressed data");
       return 1;
@@ -180,12 +204,10 @@ mp4_read_cback (void * ap_handle, void * ap_buffer, int64_t a_size,
 
   if (ap_buffer && a_size > 0)
     {
-      if (tiz_buffer_available (p_prc->p_mp4_store_) >= a_size)
+      if (p_prc->spooled_len_ - p_prc->read_pos_ >= a_size)
         {
-          memcpy (ap_buffer, tiz_buffer_get (p_prc->p_mp4_store_), a_size);
-          tiz_buffer_advance (p_prc->p_mp4_store_, a_size);
-          *ap_nin = a_size;
-          retval = 0;
+          *ap_nin = read_spooled_data (p_prc, ap_buffer, a_size);
+          retval = (*ap_nin == a_size) ? 0 : -1;
         }
       else
         {
@@ -203,24 +225,17 @@ static int
 mp4_write_cback (void * handle, const void * buffer, int64_t size, int64_t * nout,
            int64_t maxChunkSize)
 {
-  TIZ_TRACE(handleOf(gp_prc), "");
+  TIZ_TRACE(handleOf(handle), "");
   return 0;
 }
 
 static int
 mp4_close_cback (void * handle)
 {
-  TIZ_TRACE(handleOf(gp_prc), "");
+  TIZ_TRACE(handleOf(handle), "");
   return 0;
 }
 
-/* static int64_t */
-/* mp4_get_size (void * handle) */
-/* { */
-/*   TIZ_TRACE(handleOf(gp_prc), "FILE_SIZE"); */
-/*   return FILE_SIZE; */
-/* } */
-
 static void
 propagate_eos_if_required (mp4dmuxflt_prc_t * ap_prc,
                            OMX_BUFFERHEADERTYPE * ap_out_hdr)
@@ -230,7 +245,7 @@ propagate_eos_if_required (mp4dmuxflt_prc_t * ap_prc,
 
   /* If EOS, propagate the flag to the next component */
   if (tiz_filter_prc_is_eos (ap_prc)
-      && tiz_buffer_available (ap_prc->p_mp4_store_) == 0)
+      && ap_prc->read_pos_ >= ap_prc->spooled_len_)
     {
       ap_out_hdr->nFlags |= OMX_BUFFERFLAG_EOS;
       tiz_filter_prc_update_eos_flag (ap_prc, false);
@@ -463,8 +478,8 @@ get_temp_file(mp4dmuxflt_prc_t * ap_prc)
   OMX_ERRORTYPE rc = OMX_ErrorNone;
   assert(ap_prc);
 
-  static char template[] = "/tmp/tizonia-mp4dmux-XXXXXX";
-  if (!ap_prc->tmp_fd_1_)
+  static const char template[] = "/tmp/tizonia-mp4dmux-XXXXXX";
+  if (ap_prc->tmp_fd_1_ < 0)
     {
       char fname[PATH_MAX];
       strcpy(fname, template);
@@ -474,6 +489,11 @@ get_temp_file(mp4dmuxflt_prc_t * ap_prc)
                      strerror (errno));
           rc = OMX_ErrorInsufficientResources;
         }
+      else
+        {
+          /* The file goes away as soon as the descriptor is closed */
+          (void) unlink (fname);
+        }
     }
   return rc;
 }
@@ -481,26 +501,133 @@ get_temp_file(mp4dmuxflt_prc_t * ap_prc)
 static OMX_ERRORTYPE
 store_data (mp4dmuxflt_prc_t * ap_prc)
 {
-  bool rc = OMX_ErrorNone;
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
   assert (ap_prc);
 
   OMX_BUFFERHEADERTYPE * p_in = get_mp4_hdr (ap_prc);
   if (p_in)
     {
-      const void *p_buf = p_in->pBuffer + p_in->nOffset;
-      const size_t count = p_in->nFilledLen;
+      const OMX_U8 *p_buf = p_in->pBuffer + p_in->nOffset;
+      size_t remaining = p_in->nFilledLen;
       tiz_check_omx (get_temp_file (ap_prc));
-      if (write (ap_prc->tmp_fd_1_, p_buf, count) != count)
+      /* The input is spooled to the temp file, at the current end of it;
+         mp4v2's random reads are served from there through the read cache */
+      while (remaining > 0)
         {
-          TIZ_ERROR (handleOf (ap_prc),
-                     "Error writing to temp file (%s)",
-                     strerror (errno));
+          const ssize_t n = write (ap_prc->tmp_fd_1_, p_buf, remaining);
+          if (n < 0 && EINTR == errno)
+            {
+              continue;
+            }
+          if (n <= 0)
+            {
+              TIZ_ERROR (handleOf (ap_prc),
+                         "Error writing to temp file (%s)",
+                         strerror (errno));
+              return OMX_ErrorInsufficientResources;
+            }
+          p_buf += n;
+          remaining -= n;
+          ap_prc->spooled_len_ += n;
         }
       rc = release_input_header (ap_prc);
     }
   return rc;
 }
 
+static int64_t
+pread_spooled_data (mp4dmuxflt_prc_t * ap_prc, OMX_U8 * ap_dst,
+                    const size_t a_len, const int64_t a_offset)
+{
+  size_t total = 0;
+  assert (ap_prc);
+  while (total < a_len)
+    {
+      const ssize_t n = pread (ap_prc->tmp_fd_1_, ap_dst + total,
+                               a_len - total, (off_t) (a_offset + total));
+      if (n < 0 && EINTR == errno)
+        {
+          continue;
+        }
+      if (n <= 0)
+        {
+          TIZ_ERROR (handleOf (ap_prc), "Error reading temp file (%s)",
+                     n < 0 ? strerror (errno) : "EOF");
+          break;
+        }
+      total += n;
+    }
+  return total;
+}
+
+static int64_t
+read_spooled_data (mp4dmuxflt_prc_t * ap_prc, OMX_U8 * ap_dst,
+                   const int64_t a_size)
+{
+  int64_t nread = 0;
+  assert (ap_prc);
+  assert (ap_dst);
+  assert (ap_prc->p_read_cache_);
+  assert (ap_prc->read_pos_ + a_size <= ap_prc->spooled_len_);
+
+  if (a_size >= (int64_t) ap_prc->read_cache_size_)
+    {
+      /* Large reads (e.g. video samples) go straight to the spool file */
+      nread = pread_spooled_data (ap_prc, ap_dst, a_size, ap_prc->read_pos_);
+      ap_prc->read_pos_ += nread;
+      return nread;
+    }
+
+  while (nread < a_size)
+    {
+      const int64_t cache_end
+        = ap_prc->read_cache_offset_ + (int64_t) ap_prc->read_cache_len_;
+      size_t len = 0;
+      if (ap_prc->read_pos_ < ap_prc->read_cache_offset_
+          || ap_prc->read_pos_ >= cache_end)
+        {
+          /* Refill the window, starting at the current read position */
+          len = MIN ((int64_t) ap_prc->read_cache_size_,
+                     ap_prc->spooled_len_ - ap_prc->read_pos_);
+          ap_prc->read_cache_offset_ = ap_prc->read_pos_;
+          ap_prc->read_cache_len_ = pread_spooled_data (
+            ap_prc, ap_prc->p_read_cache_, len, ap_prc->read_pos_);
+          if (0 == ap_prc->read_cache_len_)
+            {
+              break;
+            }
+          continue;
+        }
+      len = MIN (cache_end - ap_prc->read_pos_, a_size - nread);
+      memcpy (ap_dst + nread,
+              ap_prc->p_read_cache_
+                + (ap_prc->read_pos_ - ap_prc->read_cache_offset_),
+              len);
+      nread += len;
+      ap_prc->read_pos_ += len;
+    }
+  return nread;
+}
+
+static void
+reset_spooled_data (mp4dmuxflt_prc_t * ap_prc)
+{
+  assert (ap_prc);
+  if (ap_prc->tmp_fd_1_ >= 0)
+    {
+      if (ftruncate (ap_prc->tmp_fd_1_, 0) != 0
+          || lseek (ap_prc->tmp_fd_1_, 0, SEEK_SET) != 0)
+        {
+          TIZ_ERROR (handleOf (ap_prc), "Error resetting temp file (%s)",
+                     strerror (errno));
+        }
+    }
+  ap_prc->spooled_len_ = 0;
+  ap_prc->read_pos_ = 0;
+  ap_prc->read_cache_offset_ = 0;
+  ap_prc->read_cache_len_ = 0;
+}
+
 /* static OMX_ERRORTYPE */
 /* extract_track_data (mp4dmuxflt_prc_t * ap_prc, const unsigned int a_track, */
 /*                     const OMX_U32 a_pid) */
@@ -615,12 +742,16 @@ alloc_input_store (mp4dmuxflt_prc_t * ap_prc)
     tiz_api_GetParameter (tiz_get_krn (handleOf (ap_prc)), handleOf (ap_prc),
                           OMX_IndexParamPortDefinition, &port_def));
 
-  assert (ap_prc->p_mp4_store_ == NULL);
-  tiz_check_omx (
-    tiz_buffer_init (&(ap_prc->p_mp4_store_), port_def.nBufferSize * 4));
+  /* The input stream is spooled to a temp file; only this window is kept in
+     memory (mp4v2 keeps its own copy of the moov atom) */
+  assert (ap_prc->p_read_cache_ == NULL);
+  ap_prc->read_cache_size_
+    = MAX (port_def.nBufferSize * 4, MP4V2_READ_CACHE_MIN_SIZE);
+  tiz_check_null_ret_oom (
+    (ap_prc->p_read_cache_ = tiz_mem_alloc (ap_prc->read_cache_size_)));
+  reset_spooled_data (ap_prc);
 
-  /* Will need to seek on this buffer  */
-  return tiz_buffer_seek_mode (ap_prc->p_mp4_store_, TIZ_BUFFER_SEEKABLE);
+  return get_temp_file (ap_prc);
 }
 
 static OMX_ERRORTYPE
@@ -689,7 +820,9 @@ alloc_mp4v2 (mp4dmuxflt_prc_t * ap_prc)
       const MP4FileProvider provider
         = {mp4_open_cback, mp4_seek_cback, mp4_read_cback, mp4_write_cback,
            mp4_close_cback};
-      ap_prc->mp4v2_hdl_ = MP4ReadProvider ("Tizonia", &provider);
+      char name[MP4V2_PROVIDER_NAME_MAX];
+      snprintf (name, sizeof (name), MP4V2_PROVIDER_NAME_FMT, (void *) ap_prc);
+      ap_prc->mp4v2_hdl_ = MP4ReadProvider (name, &provider);
       TIZ_TRACE(handleOf(ap_prc), "MP4ReadProvider");
       if (!MP4_IS_VALID_FILE_HANDLE (ap_prc->mp4v2_hdl_))
         {
@@ -698,7 +831,7 @@ alloc_mp4v2 (mp4dmuxflt_prc_t * ap_prc)
              we'll also give up after the max number of failed attempts. */
           dealloc_mp4v2 (ap_prc);
           reset_mp4v2_members (ap_prc);
-          tiz_buffer_seek (ap_prc->p_mp4_store_, 0, TIZ_BUFFER_SEEK_SET);
+          ap_prc->read_pos_ = 0;
           ap_prc->mp4v2_failed_init_count_ += 1;
           rc = OMX_ErrorNotReady;
           TIZ_ERROR (handleOf (ap_prc),
@@ -743,7 +876,7 @@ reset_stream_parameters (mp4dmuxflt_prc_t * ap_prc)
   reset_mp4v2_members (ap_prc);
   ap_prc->mp4v2_failed_init_count_ = 0;
 
-  tiz_buffer_clear (ap_prc->p_mp4_store_);
+  reset_spooled_data (ap_prc);
   tiz_buffer_clear (ap_prc->p_aud_store_);
   tiz_buffer_clear (ap_prc->p_vid_store_);
   tiz_vector_clear (ap_prc->p_aud_header_lengths_);
@@ -755,12 +888,19 @@ reset_stream_parameters (mp4dmuxflt_prc_t * ap_prc)
 static inline void
 dealloc_input_store (
   /*@special@ */ mp4dmuxflt_prc_t * ap_prc)
-/*@releases ap_prc->p_mp4_store_@ */
-/*@ensures isnull ap_prc->p_mp4_store_@ */
+/*@releases ap_prc->p_read_cache_@ */
+/*@ensures isnull ap_prc->p_read_cache_@ */
 {
   assert (ap_prc);
-  tiz_buffer_destroy (ap_prc->p_mp4_store_);
-  ap_prc->p_mp4_store_ = NULL;
+  tiz_mem_free (ap_prc->p_read_cache_);
+  ap_prc->p_read_cache_ = NULL;
+  ap_prc->read_cache_size_ = 0;
+  if (ap_prc->tmp_fd_1_ >= 0)
+    {
+      close (ap_prc->tmp_fd_1_);
+      ap_prc->tmp_fd_1_ = -1;
+    }
+  reset_spooled_data (ap_prc);
 }
 
 static inline void
@@ -1003,14 +1143,18 @@ mp4dmuxflt_prc_ctor (void * ap_prc, va_list * app)
   p_prc->mp4v2_hdl_ = MP4_INVALID_FILE_HANDLE;
   p_prc->mp4v2_inited_ = false;
   p_prc->mp4v2_duration_ = 0;
-  p_prc->p_mp4_store_ = NULL;
+  p_prc->spooled_len_ = 0;
+  p_prc->read_pos_ = 0;
+  p_prc->p_read_cache_ = NULL;
+  p_prc->read_cache_size_ = 0;
+  p_prc->read_cache_offset_ = 0;
+  p_prc->read_cache_len_ = 0;
   p_prc->p_aud_store_ = NULL;
   p_prc->p_vid_store_ = NULL;
   p_prc->p_aud_header_lengths_ = NULL;
   p_prc->p_vid_header_lengths_ = NULL;
   reset_stream_parameters (p_prc);
   MP4SetLogCallback(mp4_log_cback);
-  gp_prc = ap_prc;
   return p_prc;
 }
 
@@ -1018,7 +1162,6 @@ static void *
 mp4dmuxflt_prc_dtor (void * ap_obj)
 {
   (void) mp4dmuxflt_prc_deallocate_resources (ap_obj);
-  gp_prc = NULL;
   return super_dtor (typeOf (ap_obj, "mp4dmuxfltprc"), ap_obj);
 }
 
@@ -59,7 +59,12 @@ struct mp4dmuxflt_prc
   mp4_audio_type_t audio_type_;
   mp4_video_type_t video_type_;
   int mp4v2_failed_init_count_;
-  tiz_buffer_t * p_mp4_store_;
+  int64_t spooled_len_;
+  int64_t read_pos_;
+  OMX_U8 * p_read_cache_;
+  size_t read_cache_size_;
+  int64_t read_cache_offset_;
+  size_t read_cache_len_;
   tiz_buffer_t * p_aud_store_;
   tiz_buffer_t * p_vid_store_;
   tiz_vector_t * p_aud_header_lengths_;
@@ -44,14 +44,13 @@ extern "C"
 #define ARATELIA_MPG123_DECODER_OUTPUT_PORT_INDEX 1
 #define ARATELIA_MPG123_DECODER_PORT_MIN_BUF_COUNT 2
 #define ARATELIA_MPG123_DECODER_PORT_MIN_INPUT_BUF_SIZE 8192
-#define ARATELIA_MPG123_DECODER_PORT_MIN_OUTPUT_BUF_SIZE 8192
+/* Frames are decoded straight into the output buffers, which hold a whole
+   number of the largest frames (1152 samples, 2 channels, float) */
+#define ARATELIA_MPG123_DECODER_PORT_MIN_OUTPUT_BUF_SIZE (4 * 1152 * 2 * 4)
 #define ARATELIA_MPG123_DECODER_PORT_NONCONTIGUOUS OMX_FALSE
 #define ARATELIA_MPG123_DECODER_PORT_ALIGNMENT 0
 #define ARATELIA_MPG123_DECODER_PORT_SUPPLIERPREF OMX_BufferSupplyInput
 
-#define ARATELIA_MPG123_DECODER_BUF_FILL_THRESHOLD \
-  2 * ARATELIA_MPG123_DECODER_PORT_MIN_INPUT_BUF_SIZE
-
 #ifdef __cplusplus
 }
 #endif
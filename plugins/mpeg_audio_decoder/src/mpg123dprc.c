@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <limits.h>
 #include <string.h>
+#include <strings.h>
 
 #include <tizplatform.h>
 
@@ -216,17 +217,6 @@ release_in_hdr (mpg123d_prc_t * ap_prc)
   return OMX_ErrorNone;
 }
 
-static long
-get_mpg123_buffer_fill (mpg123d_prc_t * ap_prc)
-{
-  double fval;
-  long buffer_fill;
-  assert (ap_prc);
-  (void) mpg123_getstate (ap_prc->p_mpg123_, MPG123_BUFFERFILL, &buffer_fill,
-                          &fval);
-  return buffer_fill;
-}
-
 OMX_ERRORTYPE
 release_out_hdr (mpg123d_prc_t * ap_prc)
 {
@@ -234,12 +224,9 @@ release_out_hdr (mpg123d_prc_t * ap_prc)
     ap_prc, ARATELIA_MPG123_DECODER_OUTPUT_PORT_INDEX);
   if (p_out)
     {
-      if (tiz_filter_prc_is_eos (ap_prc)
-          && (get_mpg123_buffer_fill (ap_prc) == 0
-              || ap_prc->need_to_feed_more_))
+      if (tiz_filter_prc_is_eos (ap_prc) && ap_prc->need_to_feed_more_)
         {
-          TIZ_TRACE (handleOf (ap_prc), "Propagating EOS flag - fill [%ld]",
-                     get_mpg123_buffer_fill (ap_prc));
+          TIZ_TRACE (handleOf (ap_prc), "Propagating EOS flag");
           tiz_util_set_eos_flag (p_out);
         }
       TIZ_TRACE (handleOf (ap_prc),
@@ -251,91 +238,127 @@ release_out_hdr (mpg123d_prc_t * ap_prc)
   return OMX_ErrorNone;
 }
 
-static void
-retrieve_stream_format (mpg123d_prc_t * ap_prc)
+/* mpg123 always produces native endian samples */
+static OMX_ENDIANTYPE
+native_endianness (void)
 {
-  struct mpg123_frameinfo mi;
-  long rate;
-  int channels;
-  int encoding;
-
-  (void) mpg123_info (ap_prc->p_mpg123_, &mi);
-  TIZ_TRACE (handleOf (ap_prc),
-             "stream info : version [%s] layer [%d] rate [%ld] mode [%s]",
-             mpeg_version_to_str (mi.version), mi.layer, mi.rate,
-             mpeg_audio_mode_to_str (mi.mode));
+  const OMX_U16 one = 1;
+  return (1 == *((const OMX_U8 *) &one) ? OMX_EndianLittle : OMX_EndianBig);
+}
 
-  (void) mpg123_getformat (ap_prc->p_mpg123_, &rate, &channels, &encoding);
-  TIZ_TRACE (handleOf (ap_prc),
-             "output format : rate [%ld] channels [%d] encoding [%s]", rate,
-             channels, mpeg_output_encoding_to_str (encoding));
+/* The output encoding selected in the configuration file. 32-bit pcm is float
+   elsewhere in Tizonia (e.g. in the renderers), so signed 32-bit integer
+   output is not offered. */
+static int
+configured_encoding (void)
+{
+  const char * p_format = tiz_rcfile_get_value (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION,
+    "OMX.Aratelia.audio_decoder.mpeg.sample_format");
+  return ((p_format && 0 == strcasecmp (p_format, "float"))
+            ? MPG123_ENC_FLOAT_32
+            : MPG123_ENC_SIGNED_16);
 }
 
 static OMX_ERRORTYPE
-consume_decoded_data (mpg123d_prc_t * ap_prc)
+set_output_format (mpg123d_prc_t * ap_prc)
 {
-  OMX_ERRORTYPE rc = OMX_ErrorNone;
-  OMX_BUFFERHEADERTYPE * p_out = tiz_filter_prc_get_header (
-    ap_prc, ARATELIA_MPG123_DECODER_OUTPUT_PORT_INDEX);
+  const long * p_rates = NULL;
+  size_t nrates = 0;
+  size_t i = 0;
 
-  if (p_out)
-    {
-      size_t bytes_decoded;
-      const int ret
-        = mpg123_read (ap_prc->p_mpg123_, TIZ_OMX_BUF_PTR (p_out),
-                       TIZ_OMX_BUF_ALLOC_LEN (p_out), &bytes_decoded);
-      switch (ret)
-        {
-          case MPG123_OK:
-            ap_prc->need_to_feed_more_ = false;
-            break;
-          case MPG123_NEED_MORE:
-            ap_prc->need_to_feed_more_ = true;
-            break;
-          default:
-            {
-              TIZ_ERROR (handleOf (ap_prc),
-                         "[OMX_ErrorInsufficientResources] : "
-                         "mpg123_read error : [%s]",
-                         mpg123_plain_strerror (ret));
-              rc = OMX_ErrorInsufficientResources;
-            }
-            break;
-        };
+  assert (ap_prc);
+  assert (ap_prc->p_mpg123_);
 
-      if (OMX_ErrorNone == rc)
+  ap_prc->encoding_ = configured_encoding ();
+  mpg123_rates (&p_rates, &nrates);
+  if (MPG123_OK != mpg123_format_none (ap_prc->p_mpg123_))
+    {
+      return OMX_ErrorInsufficientResources;
+    }
+  for (i = 0; i < nrates; ++i)
+    {
+      if (MPG123_OK
+          != mpg123_format (ap_prc->p_mpg123_, p_rates[i],
+                            MPG123_MONO | MPG123_STEREO, ap_prc->encoding_))
         {
-          p_out->nFilledLen = bytes_decoded;
-          if (p_out->nFilledLen > 0)
-            {
-              rc = release_out_hdr (ap_prc);
-            }
+          return OMX_ErrorInsufficientResources;
         }
     }
-  return rc;
+  return OMX_ErrorNone;
 }
 
-static bool
-need_to_feed_more_data (mpg123d_prc_t * ap_prc)
+static OMX_ERRORTYPE
+update_pcm_settings (mpg123d_prc_t * ap_prc)
 {
-  bool rc = false;
-  if (get_mpg123_buffer_fill (ap_prc)
-      < ARATELIA_MPG123_DECODER_BUF_FILL_THRESHOLD)
+  OMX_AUDIO_PARAM_PCMMODETYPE pcmmode;
+  long rate = 0;
+  int channels = 0;
+  int encoding = 0;
+  OMX_U32 bits = 16;
+
+  assert (ap_prc);
+
+  (void) mpg123_getformat (ap_prc->p_mpg123_, &rate, &channels, &encoding);
+  bits = (MPG123_ENC_FLOAT_32 == encoding ? 32 : 16);
+
+  TIZ_INIT_OMX_PORT_STRUCT (pcmmode,
+                            ARATELIA_MPG123_DECODER_OUTPUT_PORT_INDEX);
+  tiz_check_omx (tiz_api_GetParameter (tiz_get_krn (handleOf (ap_prc)),
+                                       handleOf (ap_prc),
+                                       OMX_IndexParamAudioPcm, &pcmmode));
+
+  if (pcmmode.nSamplingRate != (OMX_U32) rate
+      || pcmmode.nChannels != (OMX_U32) channels
+      || pcmmode.nBitPerSample != bits
+      || pcmmode.eNumData != OMX_NumericalDataSigned
+      || pcmmode.eEndian != native_endianness ())
     {
-      rc = true;
+      pcmmode.nSamplingRate = rate;
+      pcmmode.nChannels = channels;
+      pcmmode.nBitPerSample = bits;
+      pcmmode.eNumData = OMX_NumericalDataSigned;
+      pcmmode.eEndian = native_endianness ();
+      if (1 == channels)
+        {
+          pcmmode.eChannelMapping[0] = OMX_AUDIO_ChannelCF;
+        }
+      else
+        {
+          pcmmode.eChannelMapping[0] = OMX_AUDIO_ChannelLF;
+          pcmmode.eChannelMapping[1] = OMX_AUDIO_ChannelRF;
+        }
+      TIZ_TRACE (handleOf (ap_prc),
+                 "pcm settings : rate [%ld] channels [%d] bits [%u]", rate,
+                 channels, bits);
+      tiz_check_omx (tiz_krn_SetParameter_internal (
+        tiz_get_krn (handleOf (ap_prc)), handleOf (ap_prc),
+        OMX_IndexParamAudioPcm, &pcmmode));
+      tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventPortSettingsChanged,
+                           ARATELIA_MPG123_DECODER_OUTPUT_PORT_INDEX,
+                           OMX_IndexParamAudioPcm, NULL);
     }
-  return rc;
+  return OMX_ErrorNone;
 }
 
-static bool
-may_consume_more_data (mpg123d_prc_t * ap_prc)
+static void
+retrieve_stream_format (mpg123d_prc_t * ap_prc)
 {
-  bool rc = false;
-  assert (ap_prc);
-  rc = !(ap_prc->need_to_feed_more_)
-       && (tiz_filter_prc_get_header (
-         ap_prc, ARATELIA_MPG123_DECODER_OUTPUT_PORT_INDEX));
-  return rc;
+  struct mpg123_frameinfo mi;
+  long rate;
+  int channels;
+  int encoding;
+
+  (void) mpg123_info (ap_prc->p_mpg123_, &mi);
+  TIZ_TRACE (handleOf (ap_prc),
+             "stream info : version [%s] layer [%d] rate [%ld] mode [%s]",
+             mpeg_version_to_str (mi.version), mi.layer, mi.rate,
+             mpeg_audio_mode_to_str (mi.mode));
+
+  (void) mpg123_getformat (ap_prc->p_mpg123_, &rate, &channels, &encoding);
+  TIZ_TRACE (handleOf (ap_prc),
+             "output format : rate [%ld] channels [%d] encoding [%s]", rate,
+             channels, mpeg_output_encoding_to_str (encoding));
 }
 
 static OMX_ERRORTYPE
@@ -368,52 +391,118 @@ feed_encoded_data (mpg123d_prc_t * ap_prc)
   return rc;
 }
 
+/* Decode one frame straight into the output buffer. mpg123 is only given
+   more input when it has run out of it, so there is never more than one input
+   buffer's worth of data queued inside the library. Gapless trimming (LAME/Xing
+   encoder delay and padding) is applied by mpg123_decode_frame itself, by
+   adjusting the number of bytes it reports. */
 static OMX_ERRORTYPE
-decode_stream (mpg123d_prc_t * ap_prc)
+decode_frame (mpg123d_prc_t * ap_prc, OMX_BUFFERHEADERTYPE * ap_out,
+              bool * ap_progress)
 {
+  OMX_U8 * p_dst = TIZ_OMX_BUF_PTR (ap_out) + ap_out->nFilledLen;
+  unsigned char * p_audio = NULL;
+  size_t bytes = 0;
+  off_t num = 0;
+  int ret = 0;
+
   assert (ap_prc);
-  do
+  assert (ap_out);
+  assert (ap_progress);
+
+  ret = mpg123_replace_buffer (ap_prc->p_mpg123_, p_dst,
+                               TIZ_OMX_BUF_AVAIL (ap_out));
+  if (MPG123_OK == ret)
     {
-      if (need_to_feed_more_data (ap_prc))
+      ret = mpg123_decode_frame (ap_prc->p_mpg123_, &num, &p_audio, &bytes);
+    }
+
+  *ap_progress = false;
+  switch (ret)
+    {
+      case MPG123_OK:
         {
-          tiz_check_omx (feed_encoded_data (ap_prc));
+          if (bytes > 0 && p_audio != p_dst)
+            {
+              memmove (p_dst, p_audio, bytes);
+            }
+          ap_out->nFilledLen += bytes;
+          ap_prc->need_to_feed_more_ = false;
+          *ap_progress = true;
         }
-      tiz_check_omx (consume_decoded_data (ap_prc));
-    }
-  while (may_consume_more_data (ap_prc));
+        break;
+      case MPG123_NEW_FORMAT:
+        {
+          TIZ_TRACE (handleOf (ap_prc), "Found new format");
+          ap_prc->found_format_ = true;
+          retrieve_stream_format (ap_prc);
+          tiz_check_omx (update_pcm_settings (ap_prc));
+          *ap_progress = true;
+        }
+        break;
+      case MPG123_NEED_MORE:
+        {
+          ap_prc->need_to_feed_more_ = true;
+          if (tiz_filter_prc_get_header (
+                ap_prc, ARATELIA_MPG123_DECODER_INPUT_PORT_INDEX))
+            {
+              tiz_check_omx (feed_encoded_data (ap_prc));
+              *ap_progress = true;
+            }
+        }
+        break;
+      default:
+        {
+          TIZ_ERROR (handleOf (ap_prc),
+                     "[OMX_ErrorInsufficientResources] : "
+                     "mpg123_decode_frame error : [%s]",
+                     mpg123_plain_strerror (ret));
+          return OMX_ErrorInsufficientResources;
+        }
+    };
+
   return OMX_ErrorNone;
 }
 
 static OMX_ERRORTYPE
-query_format (mpg123d_prc_t * ap_prc)
+decode_stream (mpg123d_prc_t * ap_prc)
 {
-  OMX_ERRORTYPE rc = OMX_ErrorNone;
-  OMX_BUFFERHEADERTYPE * p_in = tiz_filter_prc_get_header (
-    ap_prc, ARATELIA_MPG123_DECODER_INPUT_PORT_INDEX);
+  OMX_BUFFERHEADERTYPE * p_out = NULL;
+  const size_t outblock = mpg123_outblock (ap_prc->p_mpg123_);
+  bool progress = true;
 
-  if (p_in)
+  assert (ap_prc);
+
+  while (progress
+         && (p_out = tiz_filter_prc_get_header (
+               ap_prc, ARATELIA_MPG123_DECODER_OUTPUT_PORT_INDEX)))
     {
-      int mpg123_ret = 0;
-      size_t bytes_decoded = 0;
-      assert (ap_prc);
-      assert (ap_prc->p_mpg123_);
+      if (TIZ_OMX_BUF_AVAIL (p_out) < outblock)
+        {
+          if (0 == p_out->nFilledLen)
+            {
+              TIZ_ERROR (handleOf (ap_prc),
+                         "[OMX_ErrorInsufficientResources] : "
+                         "output buffer too small [%d] - need [%zu]",
+                         p_out->nAllocLen, outblock);
+              return OMX_ErrorInsufficientResources;
+            }
+          /* No room for another frame */
+          tiz_check_omx (release_out_hdr (ap_prc));
+          continue;
+        }
 
-      mpg123_ret
-        = mpg123_decode (ap_prc->p_mpg123_, TIZ_OMX_BUF_PTR (p_in),
-                         TIZ_OMX_BUF_FILL_LEN (p_in), NULL, 0, &bytes_decoded);
-      p_in->nFilledLen = 0;
+      tiz_check_omx (decode_frame (ap_prc, p_out, &progress));
 
-      if (MPG123_NEW_FORMAT == mpg123_ret)
+      if (!progress && tiz_filter_prc_is_eos (ap_prc)
+          && ap_prc->need_to_feed_more_)
         {
-          TIZ_TRACE (handleOf (ap_prc), "Found new format");
-          ap_prc->found_format_ = true;
-          retrieve_stream_format (ap_prc);
-          rc = consume_decoded_data (ap_prc);
+          /* All the input has been decoded */
+          tiz_check_omx (release_out_hdr (ap_prc));
+          tiz_filter_prc_update_eos_flag (ap_prc, false);
         }
-      (void) release_in_hdr (ap_prc);
     }
-
-  return rc;
+  return OMX_ErrorNone;
 }
 
 static void
@@ -436,6 +525,7 @@ mpg123d_prc_ctor (void * ap_obj, va_list * app)
     = super_ctor (typeOf (ap_obj, "mpg123dprc"), ap_obj, app);
   assert (p_prc);
   p_prc->p_mpg123_ = NULL;
+  p_prc->encoding_ = MPG123_ENC_SIGNED_16;
   reset_stream_parameters (p_prc);
   if (MPG123_OK != mpg123_init ())
     {
@@ -472,6 +562,17 @@ mpg123d_prc_allocate_resources (void * ap_prc, OMX_U32 a_pid)
   ret = mpg123_open_feed (p_prc->p_mpg123_);
   goto_end_on_mpg123_error (ret);
 
+  /* Trim the encoder delay and padding, when the stream says what they are;
+     this fails harmlessly if libmpg123 was built without gapless support */
+  (void) mpg123_param (p_prc->p_mpg123_, MPG123_ADD_FLAGS, MPG123_GAPLESS, 0.);
+
+  if (OMX_ErrorNone != set_output_format (p_prc))
+    {
+      TIZ_ERROR (handleOf (p_prc), "[OMX_ErrorInsufficientResources] : "
+                                   "while setting the output format");
+      goto end;
+    }
+
   /* Everything went well  */
   rc = OMX_ErrorNone;
 
@@ -529,7 +630,7 @@ mpg123d_prc_buffers_ready (const void * ap_prc)
 
   assert (ap_prc);
 
-  rc = !p_prc->found_format_ ? query_format (p_prc) : decode_stream (p_prc);
+  rc = decode_stream (p_prc);
 
   return rc;
 }
@@ -539,6 +640,13 @@ mpg123d_proc_port_flush (const void * ap_prc, OMX_U32 a_pid)
 {
   mpg123d_prc_t * p_prc = (mpg123d_prc_t *) ap_prc;
   reset_stream_parameters (p_prc);
+  if (p_prc->p_mpg123_
+      && (OMX_ALL == a_pid
+          || ARATELIA_MPG123_DECODER_INPUT_PORT_INDEX == a_pid))
+    {
+      /* Drop whatever input is still queued in the library */
+      (void) mpg123_open_feed (p_prc->p_mpg123_);
+    }
   return tiz_filter_prc_release_header (p_prc, a_pid);
 }
 
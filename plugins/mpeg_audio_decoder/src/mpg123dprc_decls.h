@@ -49,6 +49,7 @@ extern "C"
     mpg123_handle * p_mpg123_;
     bool found_format_;
     bool need_to_feed_more_;
+    int encoding_;
   };
 
   typedef struct mpg123d_prc_class mpg123d_prc_class_t;
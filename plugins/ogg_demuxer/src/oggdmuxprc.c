@@ -107,13 +107,11 @@ static size_t
 og_io_read (void * ap_user_handle, void * ap_buf, size_t n)
 {
   oggdmux_prc_t * p_prc = ap_user_handle;
-  FILE * f = NULL;
-  ssize_t bytes_read = 0;
+  size_t bytes_read = 0;
 
   assert (p_prc);
-  f = p_prc->p_file_;
 
-  bytes_read = read (fileno (f), ap_buf, n);
+  bytes_read = tiz_mmap_read (p_prc->p_file_, ap_buf, n);
   if (0 == bytes_read)
     {
       TIZ_TRACE (handleOf (p_prc), "Zero bytes_read buf [%p] n [%d]", ap_buf,
@@ -126,20 +124,16 @@ static int
 og_io_seek (void * ap_user_handle, long offset, int whence)
 {
   oggdmux_prc_t * p_prc = ap_user_handle;
-  FILE * f = NULL;
   assert (p_prc);
-  f = p_prc->p_file_;
-  return (fseek (f, offset, whence));
+  return tiz_mmap_seek (p_prc->p_file_, offset, whence);
 }
 
 static long
 og_io_tell (void * ap_user_handle)
 {
   oggdmux_prc_t * p_prc = ap_user_handle;
-  FILE * f = NULL;
   assert (p_prc);
-  f = p_prc->p_file_;
-  return ftell (f);
+  return tiz_mmap_tell (p_prc->p_file_);
 }
 
 static OMX_ERRORTYPE
@@ -185,12 +179,10 @@ alloc_uri (oggdmux_prc_t * ap_prc)
 static OMX_ERRORTYPE
 alloc_file (oggdmux_prc_t * ap_prc)
 {
-  OMX_ERRORTYPE rc = OMX_ErrorNone;
   assert (ap_prc);
   assert (!ap_prc->p_file_);
-  tiz_check_null_ret_oom (
-    (ap_prc->p_file_ = fopen ((const char *) ap_prc->p_uri_->contentURI, "r")));
-  return rc;
+  return tiz_mmap_init (&(ap_prc->p_file_),
+                        (const char *) ap_prc->p_uri_->contentURI);
 }
 
 static OMX_ERRORTYPE
@@ -235,7 +227,10 @@ alloc_oggz (oggdmux_prc_t * ap_prc)
   assert (!ap_prc->p_oggz_);
 
   /* Allocate the oggz object */
-  tiz_check_null_ret_oom ((ap_prc->p_oggz_ = oggz_new (OGGZ_READ)));
+  /* OGGZ_AUTO is needed so that oggz learns the granule rate of each
+     logical stream; this is what makes oggz_seek_units work. */
+  tiz_check_null_ret_oom (
+    (ap_prc->p_oggz_ = oggz_new (OGGZ_READ | OGGZ_AUTO)));
 
   /* Allocate a table */
   tiz_check_null_ret_oom ((ap_prc->p_tracks_ = oggz_table_new ()));
@@ -259,7 +254,7 @@ dealloc_file (/*@special@ */ oggdmux_prc_t * ap_prc)
   assert (ap_prc);
   if (ap_prc->p_file_)
     {
-      (void) fclose (ap_prc->p_file_);
+      tiz_mmap_destroy (ap_prc->p_file_);
       ap_prc->p_file_ = NULL;
     }
 }
@@ -1046,6 +1041,14 @@ demux_file (oggdmux_prc_t * ap_prc)
     }
   while (buffers_available (ap_prc) && run_status > 0);
 
+  {
+    const ogg_int64_t units = oggz_tell_units (ap_prc->p_oggz_);
+    if (units >= 0)
+      {
+        ap_prc->position_ = (OMX_TICKS) units * 1000;
+      }
+  }
+
   if (0 == run_status) /* This indicates end of file */
     {
       int remaining = 0;
@@ -1072,6 +1075,36 @@ demux_file (oggdmux_prc_t * ap_prc)
   return OMX_ErrorNone;
 }
 
+static OMX_ERRORTYPE
+seek_to_time_position (oggdmux_prc_t * ap_prc)
+{
+  ogg_int64_t units = 0;
+  assert (ap_prc);
+
+  ap_prc->seek_pending_ = false;
+  tiz_check_omx (do_flush (ap_prc));
+
+  /* oggz bisects the physical stream using the granule positions of the
+     pages, which lands on the page that contains the requested time. */
+  units = oggz_seek_units (ap_prc->p_oggz_, ap_prc->seek_pos_ / 1000, SEEK_SET);
+  TIZ_DEBUG (handleOf (ap_prc), "target [%lld] ms - landed at [%lld] ms",
+             (long long) (ap_prc->seek_pos_ / 1000), (long long) units);
+  if (units < 0)
+    {
+      TIZ_ERROR (handleOf (ap_prc),
+                 "[OMX_ErrorUnsupportedSetting] : "
+                 "Could not seek to [%lld] ms",
+                 (long long) (ap_prc->seek_pos_ / 1000));
+      return OMX_ErrorUnsupportedSetting;
+    }
+
+  ap_prc->position_ = (OMX_TICKS) units * 1000;
+  ap_prc->aud_eos_ = false;
+  ap_prc->vid_eos_ = false;
+  ap_prc->file_eos_ = false;
+  return OMX_ErrorNone;
+}
+
 /*
  * oggdmuxprc
  */
@@ -1103,6 +1136,9 @@ oggdmux_prc_ctor (void * ap_obj, va_list * app)
   p_prc->vid_eos_ = false;
   p_prc->aud_port_disabled_ = false;
   p_prc->vid_port_disabled_ = false;
+  p_prc->position_ = 0;
+  p_prc->seek_pos_ = 0;
+  p_prc->seek_pending_ = false;
 
   return p_prc;
 }
@@ -1166,6 +1202,8 @@ oggdmux_prc_stop_and_return (void * ap_obj)
   p_prc->aud_eos_ = false;
   p_prc->vid_eos_ = false;
   p_prc->file_eos_ = false;
+  p_prc->position_ = 0;
+  p_prc->seek_pending_ = false;
   TIZ_TRACE (handleOf (p_prc), "stop_and_return");
   return do_flush (p_prc);
 }
@@ -1205,6 +1243,12 @@ oggdmux_prc_port_flush (const void * ap_obj, OMX_U32 TIZ_UNUSED (a_pid))
 {
   oggdmux_prc_t * p_prc = (oggdmux_prc_t *) ap_obj;
   assert (p_prc);
+  /* A pending seek is applied here, so that nothing read from the new
+     position can be discarded by the flush that follows the request */
+  if (p_prc->seek_pending_)
+    {
+      return seek_to_time_position (p_prc);
+    }
   return do_flush (p_prc);
 }
 
@@ -1243,6 +1287,50 @@ oggdmux_prc_port_enable (const void * ap_obj, OMX_U32 a_pid)
   return OMX_ErrorNone;
 }
 
+static OMX_ERRORTYPE
+oggdmux_prc_GetConfig (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
+                       OMX_INDEXTYPE a_index, OMX_PTR ap_struct)
+{
+  const oggdmux_prc_t * p_prc = ap_obj;
+  assert (p_prc);
+
+  if (OMX_IndexConfigTimePosition == a_index)
+    {
+      OMX_TIME_CONFIG_TIMESTAMPTYPE * p_ts
+        = (OMX_TIME_CONFIG_TIMESTAMPTYPE *) ap_struct;
+      p_ts->nTimestamp = p_prc->position_;
+      return OMX_ErrorNone;
+    }
+
+  return super_GetConfig (typeOf (ap_obj, "oggdmuxprc"), ap_obj, ap_hdl,
+                          a_index, ap_struct);
+}
+
+static OMX_ERRORTYPE
+oggdmux_prc_SetConfig (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
+                       OMX_INDEXTYPE a_index, OMX_PTR ap_struct)
+{
+  oggdmux_prc_t * p_prc = (oggdmux_prc_t *) ap_obj;
+  assert (p_prc);
+
+  if (OMX_IndexConfigTimePosition == a_index)
+    {
+      const OMX_TIME_CONFIG_TIMESTAMPTYPE * p_ts
+        = (OMX_TIME_CONFIG_TIMESTAMPTYPE *) ap_struct;
+      if (p_ts->nTimestamp < 0)
+        {
+          return OMX_ErrorBadParameter;
+        }
+      /* The actual repositioning happens in the processor's thread, when the
+         client flushes the output ports (see oggdmux_prc_port_flush). */
+      p_prc->seek_pos_ = p_ts->nTimestamp;
+      p_prc->seek_pending_ = true;
+    }
+
+  return super_SetConfig (typeOf (ap_obj, "oggdmuxprc"), ap_obj, ap_hdl,
+                          a_index, ap_struct);
+}
+
 /*
  * oggdmux_prc_class
  */
@@ -1307,6 +1395,10 @@ oggdmux_prc_init (void * ap_tos, void * ap_hdl)
      tiz_prc_port_enable, oggdmux_prc_port_enable,
      /* TIZ_CLASS_COMMENT: */
      tiz_prc_buffers_ready, oggdmux_prc_buffers_ready,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_api_GetConfig, oggdmux_prc_GetConfig,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_api_SetConfig, oggdmux_prc_SetConfig,
      /* TIZ_CLASS_COMMENT: stop value*/
      0);
 
@@ -37,6 +37,7 @@ extern "C"
 #include <stdbool.h>
 #include <oggz/oggz.h>
 
+#include <tizplatform.h>
 #include <tizprc_decls.h>
 
   typedef struct oggdmux_prc oggdmux_prc_t;
@@ -44,7 +45,7 @@ extern "C"
   {
     /* Object */
     const tiz_prc_t _;
-    FILE * p_file_;
+    tiz_mmap_t * p_file_;
     OMX_PARAM_CONTENTURITYPE * p_uri_;
     OGGZ * p_oggz_;
     OggzTable * p_tracks_;
@@ -64,6 +65,9 @@ extern "C"
     bool vid_eos_;
     bool aud_port_disabled_;
     bool vid_port_disabled_;
+    OMX_TICKS position_;
+    OMX_TICKS seek_pos_;
+    bool seek_pending_;
   };
 
   typedef struct oggdmux_prc_class oggdmux_prc_class_t;
@@ -46,6 +46,7 @@
 #include <tizscheduler.h>
 
 #include "oggmux.h"
+#include "oggmuxpage.h"
 #include "oggmuxfltprc.h"
 #include "oggmuxfltprc_decls.h"
 
@@ -84,6 +85,9 @@
     }                                                                        \
   while (0)
 
+#define OGGMUXFLT_DEFAULT_MAX_PAGE_DURATION_MS 100
+#define OGGMUXFLT_DEFAULT_MAX_PAGE_BYTES 4096
+
 /* Forward declarations */
 static OMX_ERRORTYPE
 oggmuxflt_prc_deallocate_resources (void *);
@@ -208,31 +212,78 @@ enqueue_opus_tags (oggmuxflt_prc_t * ap_prc)
   return OMX_ErrorNone;
 }
 
+static OMX_ERRORTYPE
+release_fed_audio_header (oggmuxflt_prc_t * ap_prc)
+{
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  assert (ap_prc);
+  if (ap_prc->audio_in_flight_ && ap_prc->oggz_audio_guard_)
+    {
+      OMX_BUFFERHEADERTYPE * p_hdr = get_aud_hdr (ap_prc);
+      ap_prc->audio_in_flight_ = false;
+      if (p_hdr)
+        {
+          p_hdr->nFilledLen = 0;
+          rc = release_input_header (
+            ap_prc, ARATELIA_OGG_MUXER_FILTER_PORT_0_INDEX, p_hdr);
+        }
+    }
+  return rc;
+}
+
 static OMX_ERRORTYPE
 enqueue_opus_packet (oggmuxflt_prc_t * ap_prc)
 {
   OMX_ERRORTYPE rc = OMX_ErrorNotReady;
   ogg_packet op;
-  OMX_BUFFERHEADERTYPE * p_hdr = get_aud_hdr (ap_prc);
+  OMX_BUFFERHEADERTYPE * p_hdr = NULL;
 
   OGGMUXFLT_LOG_STATE (ap_prc);
-  if (p_hdr)
+
+  /* The last packet fed is still in use by oggz */
+  tiz_check_true_ret_val (!ap_prc->audio_in_flight_, OMX_ErrorNotReady);
+
+  if ((p_hdr = get_aud_hdr (ap_prc)))
     {
-      op.packet = p_hdr->pBuffer + p_hdr->nOffset;
+      const bool eos = ((p_hdr->nFlags & OMX_BUFFERFLAG_EOS) > 0);
+      long samples = oggmux_opus_packet_samples (TIZ_OMX_BUF_PTR (p_hdr),
+                                                 p_hdr->nFilledLen);
+      if (0 == samples && p_hdr->nFilledLen > 0)
+        {
+          TIZ_WARN (handleOf (ap_prc),
+                    "Malformed opus packet; assuming [%ld] samples",
+                    ap_prc->audio_packet_samples_);
+          samples = ap_prc->audio_packet_samples_;
+        }
+      else if (samples > 0)
+        {
+          ap_prc->audio_packet_samples_ = samples;
+        }
+
+      /* The granule position of a packet is the sample count at its end */
+      ap_prc->oggz_audio_granulepos_ += samples;
+
+      op.packet = TIZ_OMX_BUF_PTR (p_hdr);
       op.bytes = p_hdr->nFilledLen;
       op.granulepos = ap_prc->oggz_audio_granulepos_;
       op.packetno = ap_prc->oggz_audio_packetno_;
       op.b_o_s = 0;
-      op.e_o_s = (((p_hdr->nFlags & OMX_BUFFERFLAG_EOS) > 0) ? 1 : 0);
-      TIZ_DEBUG (handleOf (ap_prc), "written [%d]", op.bytes);
-      on_oggz_error_ret_omx_oom (oggz_write_feed (ap_prc->p_oggz_, &op,
-                                                  ap_prc->oggz_audio_serialno_,
-                                                  OGGZ_FLUSH_AFTER, NULL));
-      p_hdr->nFilledLen = 0;
-      rc = release_input_header (ap_prc, ARATELIA_OGG_MUXER_FILTER_PORT_0_INDEX,
-                                 p_hdr);
-      ap_prc->oggz_audio_granulepos_ += 100;
+      op.e_o_s = (eos ? 1 : 0);
+      TIZ_DEBUG (handleOf (ap_prc), "written [%d] granulepos [%ld]", op.bytes,
+                 ap_prc->oggz_audio_granulepos_);
+
+      /* The payload is not copied; oggz sets the guard once it is done with
+         it, and the header is returned then. */
+      ap_prc->oggz_audio_guard_ = 0;
+      on_oggz_error_ret_omx_oom (oggz_write_feed (
+        ap_prc->p_oggz_, &op, ap_prc->oggz_audio_serialno_,
+        (oggmux_pager_add (&(ap_prc->pager_), samples, op.bytes, eos)
+           ? OGGZ_FLUSH_AFTER
+           : 0),
+        &(ap_prc->oggz_audio_guard_)));
+      ap_prc->audio_in_flight_ = true;
       ap_prc->oggz_audio_packetno_++;
+      rc = OMX_ErrorNone;
     }
 
   return rc;
@@ -305,6 +356,10 @@ og_hungry (OGGZ * oggz, int empty, void * user_data)
   assert (p_prc);
   TIZ_DEBUG (handleOf (p_prc), "ogg queue is [%s]",
              (empty == 0 ? "NOT EMPTY" : "EMPTY"));
+  if (OMX_ErrorNone != release_fed_audio_header (p_prc))
+    {
+      return OGGZ_ERR_STOP_ERR;
+    }
   audio_rc = audio_hungry (p_prc);
   video_rc = video_hungry (p_prc);
   if (OMX_ErrorNone == audio_rc || OMX_ErrorNone == video_rc)
@@ -329,47 +384,6 @@ og_hungry (OGGZ * oggz, int empty, void * user_data)
   return oggz_rc;
 }
 
-static size_t
-og_io_write (void * ap_user_handle, void * ap_buf, size_t n)
-{
-  oggmuxflt_prc_t * p_prc = ap_user_handle;
-  ssize_t bytes_written = 0;
-
-  OGGMUXFLT_LOG_STATE (p_prc);
-
-  if (n > 0 && ap_buf)
-    {
-      OMX_BUFFERHEADERTYPE * p_hdr = p_hdr = get_out_hdr (p_prc);
-
-      assert (p_prc);
-
-      if (p_hdr)
-        {
-          bytes_written = MIN (n, TIZ_OMX_BUF_AVAIL (p_hdr));
-          (void) memcpy (TIZ_OMX_BUF_PTR (p_hdr) + p_hdr->nFilledLen, ap_buf,
-                         bytes_written);
-          p_hdr->nFilledLen += bytes_written;
-          TIZ_DEBUG (handleOf (p_prc), "bytes - n [%d] nFilledLen [%d]", n,
-                     p_hdr->nFilledLen);
-          if (0 == TIZ_OMX_BUF_AVAIL (p_hdr) || tiz_filter_prc_is_eos (p_prc))
-            {
-              release_output_header (p_prc, p_hdr);
-            }
-        }
-      else
-        {
-          TIZ_DEBUG (handleOf (p_prc), "No output headers available");
-        }
-    }
-  return bytes_written;
-}
-
-static int
-og_io_flush (void * ap_user_handle)
-{
-  return 0;
-}
-
 static OMX_ERRORTYPE
 alloc_oggz (oggmuxflt_prc_t * ap_prc)
 {
@@ -387,12 +401,6 @@ alloc_oggz (oggmuxflt_prc_t * ap_prc)
   on_oggz_error_ret_omx_oom (
     oggz_write_set_hungry_callback (ap_prc->p_oggz_, og_hungry, 1, ap_prc));
 
-  /* Set the io callbacks */
-  on_oggz_error_ret_omx_oom (
-    oggz_io_set_write (ap_prc->p_oggz_, og_io_write, ap_prc));
-  on_oggz_error_ret_omx_oom (
-    oggz_io_set_flush (ap_prc->p_oggz_, og_io_flush, ap_prc));
-
   return rc;
 }
 
@@ -431,11 +439,53 @@ dealloc_oggz (
     }
 }
 
+static OMX_ERRORTYPE
+reset_oggz (oggmuxflt_prc_t * ap_prc)
+{
+  assert (ap_prc);
+  assert (ap_prc->p_oggz_);
+
+  /* Closing oggz drops the packets still queued, and sets their guards */
+  (void) oggz_close (ap_prc->p_oggz_);
+  ap_prc->p_oggz_ = NULL;
+
+  /* What follows is muxed as a new chained stream, headers included */
+  ap_prc->oggz_audio_granulepos_ = 0;
+  ap_prc->oggz_video_granulepos_ = 0;
+  ap_prc->oggz_audio_packetno_ = 0;
+  ap_prc->oggz_video_packetno_ = 0;
+  ap_prc->audio_in_flight_ = false;
+  oggmux_pager_reset (&(ap_prc->pager_));
+
+  return alloc_oggz (ap_prc);
+}
+
+/* Called before the audio header is returned without waiting for oggz */
+static OMX_ERRORTYPE
+reclaim_audio_payload (oggmuxflt_prc_t * ap_prc, OMX_U32 a_pid)
+{
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  assert (ap_prc);
+  if (OMX_ALL == a_pid || ARATELIA_OGG_MUXER_FILTER_PORT_0_INDEX == a_pid)
+    {
+      /* oggz only copies a fed packet into a page, and sets the guard, when
+         it gets to it while producing output. Until then it still points at
+         the payload of the header that is about to be returned. */
+      if (ap_prc->audio_in_flight_ && !ap_prc->oggz_audio_guard_)
+        {
+          rc = reset_oggz (ap_prc);
+        }
+      ap_prc->audio_in_flight_ = false;
+    }
+  return rc;
+}
+
 static inline OMX_ERRORTYPE
 do_flush (oggmuxflt_prc_t * ap_prc, OMX_U32 a_pid)
 {
   assert (ap_prc);
   TIZ_TRACE (handleOf (ap_prc), "do_flush");
+  tiz_check_omx (reclaim_audio_payload (ap_prc, a_pid));
   if (OMX_ALL == a_pid)
     {
       reset_stream_parameters (ap_prc);
@@ -506,16 +556,30 @@ mux_streams (oggmuxflt_prc_t * ap_prc)
   long oggz_rc = OGGZ_ERR_OK;
   while ((OGGZ_ERR_OK == oggz_rc) && (p_hdr = get_out_hdr (ap_prc)))
     {
-      long n = MIN (32, TIZ_OMX_BUF_AVAIL (p_hdr));
-      oggz_rc = oggz_write (ap_prc->p_oggz_, n);
+      /* Pages are written straight into the output buffer */
+      const long n = TIZ_OMX_BUF_AVAIL (p_hdr);
+      oggz_rc = oggz_write_output (
+        ap_prc->p_oggz_, TIZ_OMX_BUF_PTR (p_hdr) + p_hdr->nFilledLen, n);
       if (oggz_rc > 0)
         {
+          TIZ_DEBUG (handleOf (ap_prc), "OGGZ_ERR_OK written [%ld]", oggz_rc);
+          p_hdr->nFilledLen += oggz_rc;
+          /* A short write means that there are no more pages ready; send the
+             buffer now, so that no page waits for more data */
+          if (oggz_rc < n || 0 == TIZ_OMX_BUF_AVAIL (p_hdr)
+              || tiz_filter_prc_is_eos (ap_prc))
+            {
+              tiz_check_omx (release_output_header (ap_prc, p_hdr));
+            }
           oggz_rc = OGGZ_ERR_OK;
-          TIZ_DEBUG (handleOf (ap_prc), "OGGZ_ERR_OK written [%d]", oggz_rc);
         }
       else if (0 == oggz_rc)
         {
           /* eos */
+          if (tiz_filter_prc_is_eos (ap_prc))
+            {
+              tiz_check_omx (release_output_header (ap_prc, p_hdr));
+            }
           rc = OMX_ErrorNotReady;
           TIZ_DEBUG (handleOf (ap_prc), "eos, OMX_ErrorNotReady");
         }
@@ -558,6 +622,10 @@ oggmuxflt_prc_ctor (void * ap_prc, va_list * app)
   p_prc->oggz_video_granulepos_ = 0;
   p_prc->oggz_audio_packetno_ = 0;
   p_prc->oggz_video_packetno_ = 0;
+  p_prc->oggz_audio_guard_ = 0;
+  p_prc->audio_in_flight_ = false;
+  p_prc->audio_packet_samples_ = 0;
+  oggmux_pager_init (&(p_prc->pager_), 0, 0);
   reset_stream_parameters (p_prc);
   return p_prc;
 }
@@ -577,7 +645,25 @@ static OMX_ERRORTYPE
 oggmuxflt_prc_allocate_resources (void * ap_prc, OMX_U32 a_pid)
 {
   oggmuxflt_prc_t * p_prc = ap_prc;
+  long duration_ms = 0;
+  long page_bytes = 0;
   assert (p_prc);
+
+  /* Page flush policy; 0 means one page per packet */
+  duration_ms = TIZ_RCFILE_GET_INT (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION,
+    "OMX.Aratelia.container_muxer.ogg.max_page_duration",
+    OGGMUXFLT_DEFAULT_MAX_PAGE_DURATION_MS);
+  page_bytes = TIZ_RCFILE_GET_INT (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION,
+    "OMX.Aratelia.container_muxer.ogg.max_page_bytes",
+    OGGMUXFLT_DEFAULT_MAX_PAGE_BYTES);
+  oggmux_pager_init (&(p_prc->pager_),
+                     MAX (0, duration_ms) * (OGGMUX_OPUS_GRANULE_RATE / 1000),
+                     MAX (0, page_bytes));
+  TIZ_TRACE (handleOf (p_prc), "max page duration [%ld] ms bytes [%ld]",
+             duration_ms, page_bytes);
+
   tiz_check_omx (alloc_oggz (p_prc));
   return OMX_ErrorNone;
 }
@@ -659,7 +745,9 @@ static OMX_ERRORTYPE
 oggmuxflt_prc_port_disable (const void * ap_prc, OMX_U32 a_pid)
 {
   oggmuxflt_prc_t * p_prc = (oggmuxflt_prc_t *) ap_prc;
-  OMX_ERRORTYPE rc = tiz_filter_prc_release_header (p_prc, a_pid);
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+  tiz_check_omx (reclaim_audio_payload (p_prc, a_pid));
+  rc = tiz_filter_prc_release_header (p_prc, a_pid);
   reset_stream_parameters (p_prc);
   tiz_filter_prc_update_port_disabled_flag (p_prc, a_pid, true);
   return rc;
@@ -44,6 +44,8 @@ extern "C"
 #include <tizfilterprc.h>
 #include <tizfilterprc_decls.h>
 
+#include "oggmuxpage.h"
+
   typedef struct oggmuxflt_prc oggmuxflt_prc_t;
   struct oggmuxflt_prc
   {
@@ -56,6 +58,10 @@ extern "C"
     long oggz_video_granulepos_;
     long oggz_audio_packetno_;
     long oggz_video_packetno_;
+    int oggz_audio_guard_;
+    bool audio_in_flight_;
+    long audio_packet_samples_;
+    oggmux_pager_t pager_;
   };
 
   typedef struct oggmuxflt_prc_class oggmuxflt_prc_class_t;
@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   oggmuxpage.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - Ogg muxer's Opus packet durations and page flush policy
+ *
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+
+#include "oggmuxpage.h"
+
+long
+oggmux_opus_packet_samples (const OMX_U8 * ap_data, const OMX_U32 a_len)
+{
+  static const long frame_samples[32]
+    = {480, 960, 1920, 2880, /* SILK NB */
+       480, 960, 1920, 2880, /* SILK MB */
+       480, 960, 1920, 2880, /* SILK WB */
+       480, 960,             /* Hybrid SWB */
+       480, 960,             /* Hybrid FB */
+       120, 240, 480, 960,   /* CELT NB */
+       120, 240, 480, 960,   /* CELT WB */
+       120, 240, 480, 960,   /* CELT SWB */
+       120, 240, 480, 960};  /* CELT FB */
+  long nframes = 0;
+  long samples = 0;
+
+  if (0 == a_len)
+    {
+      return 0;
+    }
+
+  assert (ap_data);
+
+  switch (ap_data[0] & 0x3)
+    {
+      case 0:
+        nframes = 1;
+        break;
+      case 1:
+      case 2:
+        nframes = 2;
+        break;
+      default:
+        nframes = (a_len < 2 ? 0 : (ap_data[1] & 0x3f));
+        break;
+    };
+
+  samples = nframes * frame_samples[ap_data[0] >> 3];
+  /* A packet can't be longer than 120 ms */
+  return (samples > 5760 ? 0 : samples);
+}
+
+void
+oggmux_pager_init (oggmux_pager_t * ap_pager, const long a_max_samples,
+                   const long a_max_bytes)
+{
+  assert (ap_pager);
+  ap_pager->max_samples = a_max_samples;
+  ap_pager->max_bytes = a_max_bytes;
+  oggmux_pager_reset (ap_pager);
+}
+
+void
+oggmux_pager_reset (oggmux_pager_t * ap_pager)
+{
+  assert (ap_pager);
+  ap_pager->samples = 0;
+  ap_pager->bytes = 0;
+}
+
+bool
+oggmux_pager_add (oggmux_pager_t * ap_pager, const long a_samples,
+                  const long a_bytes, const bool a_eos)
+{
+  assert (ap_pager);
+  ap_pager->samples += a_samples;
+  ap_pager->bytes += a_bytes;
+  if (a_eos || ap_pager->samples >= ap_pager->max_samples
+      || ap_pager->bytes >= ap_pager->max_bytes)
+    {
+      oggmux_pager_reset (ap_pager);
+      return true;
+    }
+  return false;
+}
@@ -0,0 +1,87 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   oggmuxpage.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - Ogg muxer's Opus packet durations and page flush policy
+ *
+ *
+ */
+
+#ifndef OGGMUXPAGE_H
+#define OGGMUXPAGE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+
+#include <OMX_Types.h>
+
+/* Opus granule positions are always in 48 kHz samples */
+#define OGGMUX_OPUS_GRANULE_RATE 48000
+
+  /* Packets go to the current page until the page reaches its duration or
+     size limits, or the stream ends. Shorter pages lower the latency of a
+     live stream, at the cost of more page headers. A limit of 0 means one
+     page per packet. */
+  typedef struct oggmux_pager oggmux_pager_t;
+  struct oggmux_pager
+  {
+    long max_samples;
+    long max_bytes;
+    long samples;
+    long bytes;
+  };
+
+  /**
+   * The number of 48 kHz samples in an Opus packet, from its TOC byte (RFC
+   * 6716, section 3.1).
+   *
+   * @return 0 if the packet is malformed.
+   */
+  long
+  oggmux_opus_packet_samples (const OMX_U8 * ap_data, const OMX_U32 a_len);
+
+  void
+  oggmux_pager_init (oggmux_pager_t * ap_pager, const long a_max_samples,
+                     const long a_max_bytes);
+
+  /* Forget the packets added to the current page */
+  void
+  oggmux_pager_reset (oggmux_pager_t * ap_pager);
+
+  /**
+   * Add a packet to the current page.
+   *
+   * @return true if the page must be flushed after this packet.
+   */
+  bool
+  oggmux_pager_add (oggmux_pager_t * ap_pager, const long a_samples,
+                    const long a_bytes, const bool a_eos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OGGMUXPAGE_H */
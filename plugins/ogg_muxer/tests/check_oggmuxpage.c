@@ -0,0 +1,519 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_oggmuxpage.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Ogg muxer packetisation unit tests
+ *
+ * Synthetic Opus packets (real TOC bytes, patterned payload) are muxed with
+ * liboggz the way the filter processor does it, i.e. fed with a guard and
+ * written out in OMX-buffer-sized chunks, and the result is demuxed again
+ * with liboggz.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <check.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <oggz/oggz.h>
+
+#include <tizplatform.h>
+
+#include "oggmuxpage.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.ogg_muxer.check"
+#endif
+
+#define OGGMUXPAGE_TEST_TIMEOUT 10
+
+#define MUX_NPACKETS 500
+#define MUX_MAX_PACKET_SIZE 320
+#define MUX_OUT_SIZE (MUX_NPACKETS * (MUX_MAX_PACKET_SIZE + 32) + 4096)
+#define MUX_OUT_CHUNK 1024 /* as if written into OMX buffers */
+#define MUX_READ_CHUNK 4096
+#define MUX_MAX_PAGE_SAMPLES (100 * (OGGMUX_OPUS_GRANULE_RATE / 1000))
+#define MUX_MAX_PAGE_BYTES 4096
+#define OPUS_MAX_PACKET_SAMPLES 5760
+
+typedef struct mux mux_t;
+struct mux
+{
+  OGGZ * p_oggz;
+  long serialno;
+  long packetno;
+  ogg_int64_t granulepos;
+  oggmux_pager_t pager;
+  int guard;
+  bool in_flight;
+  int next; /* next packet to feed */
+  OMX_U8 * p_packets[MUX_NPACKETS];
+  long lens[MUX_NPACKETS];
+  ogg_int64_t ends[MUX_NPACKETS]; /* sample count at the end of each */
+  OMX_U8 * p_out;
+  long out_len;
+};
+
+typedef struct demux demux_t;
+struct demux
+{
+  long npackets; /* audio packets, i.e. after OpusHead and OpusTags */
+  long nheaders;
+  ogg_int64_t samples;
+  bool eos;
+  long npages;
+  ogg_int64_t page_granules[MUX_NPACKETS + 2];
+};
+
+static mux_t mx;
+static demux_t dx;
+
+/* TOC byte, and frame count byte for code 3 packets */
+static const OMX_U8 opus_tocs[][2] = {
+  {0xF8, 0x00}, /* CELT FB 20 ms, one frame */
+  {0xF9, 0x00}, /* CELT FB 20 ms, two frames */
+  {0x83, 0x03}, /* CELT NB 2.5 ms, three frames */
+  {0x18, 0x00}, /* SILK NB 60 ms, one frame */
+  {0x0A, 0x00}  /* SILK NB 20 ms, two frames */
+};
+
+static void
+setup (void)
+{
+  int i = 0;
+  ogg_int64_t samples = 0;
+  memset (&mx, 0, sizeof (mx));
+  memset (&dx, 0, sizeof (dx));
+
+  for (i = 0; i < MUX_NPACKETS; ++i)
+    {
+      const OMX_U8 * p_toc = opus_tocs[i % (sizeof (opus_tocs) / 2)];
+      const long len = 20 + (37 * i) % (MUX_MAX_PACKET_SIZE - 20);
+      long j = 0;
+      mx.p_packets[i] = tiz_mem_calloc (1, len);
+      fail_if (NULL == mx.p_packets[i]);
+      mx.lens[i] = len;
+      mx.p_packets[i][0] = p_toc[0];
+      mx.p_packets[i][1] = p_toc[1];
+      for (j = 2; j < len; ++j)
+        {
+          mx.p_packets[i][j] = (OMX_U8) (i + j);
+        }
+      samples += oggmux_opus_packet_samples (mx.p_packets[i], len);
+      mx.ends[i] = samples;
+    }
+
+  mx.p_out = tiz_mem_calloc (1, MUX_OUT_SIZE);
+  fail_if (NULL == mx.p_out);
+}
+
+static void
+teardown (void)
+{
+  int i = 0;
+  if (mx.p_oggz)
+    {
+      oggz_close (mx.p_oggz);
+    }
+  for (i = 0; i < MUX_NPACKETS; ++i)
+    {
+      tiz_mem_free (mx.p_packets[i]);
+    }
+  tiz_mem_free (mx.p_out);
+  memset (&mx, 0, sizeof (mx));
+}
+
+/* The same OpusHead the filter processor writes */
+static int
+feed_opus_head (void)
+{
+  OMX_U8 data[19];
+  ogg_packet op;
+  memset (data, 0, sizeof (data));
+  memcpy (data, "OpusHead", 8);
+  data[8] = 1; /* version */
+  data[9] = 2; /* channels */
+  data[12] = 0x80; /* 48000 Hz, little endian */
+  data[13] = 0xBB;
+  op.packet = data;
+  op.bytes = sizeof (data);
+  op.b_o_s = 1;
+  op.e_o_s = 0;
+  op.granulepos = 0;
+  op.packetno = mx.packetno++;
+  return oggz_write_feed (mx.p_oggz, &op, mx.serialno, OGGZ_FLUSH_AFTER,
+                          NULL);
+}
+
+static int
+feed_opus_tags (void)
+{
+  OMX_U8 data[16];
+  ogg_packet op;
+  memset (data, 0, sizeof (data));
+  memcpy (data, "OpusTags", 8); /* no vendor string, no comments */
+  op.packet = data;
+  op.bytes = sizeof (data);
+  op.b_o_s = 0;
+  op.e_o_s = 0;
+  op.granulepos = 0;
+  op.packetno = mx.packetno++;
+  return oggz_write_feed (mx.p_oggz, &op, mx.serialno, OGGZ_FLUSH_AFTER,
+                          NULL);
+}
+
+/* Mirrors the filter processor's hungry callback: one guarded packet in
+   flight at a time, released once oggz has set the guard */
+static int
+mux_hungry (OGGZ * ap_oggz, int a_empty, void * ap_arg)
+{
+  ogg_packet op;
+  long samples = 0;
+  bool eos = false;
+  (void) ap_oggz;
+  (void) a_empty;
+  (void) ap_arg;
+
+  if (mx.in_flight && mx.guard)
+    {
+      mx.in_flight = false;
+    }
+
+  if (0 == mx.packetno)
+    {
+      return feed_opus_head ();
+    }
+  if (1 == mx.packetno)
+    {
+      return feed_opus_tags ();
+    }
+  if (mx.in_flight || mx.next >= MUX_NPACKETS)
+    {
+      return OGGZ_ERR_STOP_OK;
+    }
+
+  eos = (MUX_NPACKETS - 1 == mx.next);
+  samples = oggmux_opus_packet_samples (mx.p_packets[mx.next],
+                                        mx.lens[mx.next]);
+  mx.granulepos += samples;
+  op.packet = mx.p_packets[mx.next];
+  op.bytes = mx.lens[mx.next];
+  op.b_o_s = 0;
+  op.e_o_s = (eos ? 1 : 0);
+  op.granulepos = mx.granulepos;
+  op.packetno = mx.packetno++;
+  mx.guard = 0;
+  mx.in_flight = true;
+  mx.next++;
+  return oggz_write_feed (
+    mx.p_oggz, &op, mx.serialno,
+    (oggmux_pager_add (&(mx.pager), samples, op.bytes, eos) ? OGGZ_FLUSH_AFTER
+                                                             : 0),
+    &(mx.guard));
+}
+
+static void
+mux_all (const long a_max_page_samples, const long a_max_page_bytes)
+{
+  long rc = 0;
+  int stalls = 0;
+
+  mx.p_oggz = oggz_new (OGGZ_WRITE);
+  fail_if (NULL == mx.p_oggz);
+  mx.serialno = oggz_serialno_new (mx.p_oggz);
+  oggmux_pager_init (&(mx.pager), a_max_page_samples, a_max_page_bytes);
+  fail_if (OGGZ_ERR_OK
+           != oggz_write_set_hungry_callback (mx.p_oggz, mux_hungry, 1, NULL));
+
+  /* Until the last packet has been paged */
+  while (!(MUX_NPACKETS == mx.next && mx.guard))
+    {
+      const long avail = MUX_OUT_SIZE - mx.out_len;
+      rc = oggz_write_output (mx.p_oggz, mx.p_out + mx.out_len,
+                              (avail < MUX_OUT_CHUNK ? avail : MUX_OUT_CHUNK));
+      if (rc > 0)
+        {
+          mx.out_len += rc;
+          stalls = 0;
+        }
+      else
+        {
+          fail_if (rc < 0 && OGGZ_ERR_STOP_OK != rc);
+          fail_if (++stalls > 8);
+        }
+    }
+
+  /* Nothing else is left in oggz */
+  while ((rc = oggz_write_output (mx.p_oggz, mx.p_out + mx.out_len,
+                                  MUX_OUT_SIZE - mx.out_len))
+         > 0)
+    {
+      mx.out_len += rc;
+    }
+}
+
+static int
+demux_page (OGGZ * ap_oggz, const ogg_page * ap_og, long a_serialno,
+            void * ap_arg)
+{
+  const ogg_int64_t granulepos = ogg_page_granulepos ((ogg_page *) ap_og);
+  (void) ap_oggz;
+  (void) ap_arg;
+  ck_assert_int_eq (a_serialno, mx.serialno);
+  /* Pages where no packet ends carry -1 */
+  if (granulepos > 0)
+    {
+      fail_if (dx.npages >= MUX_NPACKETS + 2);
+      dx.page_granules[dx.npages++] = granulepos;
+    }
+  return OGGZ_CONTINUE;
+}
+
+static int
+demux_packet (OGGZ * ap_oggz, oggz_packet * ap_zp, long a_serialno,
+              void * ap_arg)
+{
+  ogg_packet * p_op = &(ap_zp->op);
+  const long i = dx.npackets;
+  (void) ap_oggz;
+  (void) ap_arg;
+
+  ck_assert_int_eq (a_serialno, mx.serialno);
+  if (dx.nheaders < 2)
+    {
+      fail_if (0 != memcmp (p_op->packet,
+                            (0 == dx.nheaders ? "OpusHead" : "OpusTags"), 8));
+      dx.nheaders++;
+      return OGGZ_CONTINUE;
+    }
+
+  fail_if (i >= MUX_NPACKETS);
+  fail_if (dx.eos);
+  ck_assert_int_eq (p_op->bytes, mx.lens[i]);
+  fail_if (0 != memcmp (p_op->packet, mx.p_packets[i], mx.lens[i]));
+
+  dx.samples += oggmux_opus_packet_samples (p_op->packet, p_op->bytes);
+  ck_assert_int_eq (dx.samples, mx.ends[i]);
+  /* Only the last packet of a page is required to carry a granule position,
+     but any that does must be the sample count at its end */
+  if (-1 != p_op->granulepos)
+    {
+      ck_assert_int_eq (p_op->granulepos, dx.samples);
+    }
+  dx.eos = (p_op->e_o_s != 0);
+  dx.npackets++;
+  return OGGZ_CONTINUE;
+}
+
+static void
+demux_all (void)
+{
+  OGGZ * p_oggz = oggz_new (OGGZ_READ);
+  long offset = 0;
+  fail_if (NULL == p_oggz);
+  fail_if (0 != oggz_set_read_callback (p_oggz, -1, demux_packet, NULL));
+  fail_if (0 != oggz_set_read_page (p_oggz, -1, demux_page, NULL));
+  while (offset < mx.out_len)
+    {
+      const long len = (mx.out_len - offset < MUX_READ_CHUNK
+                          ? mx.out_len - offset
+                          : MUX_READ_CHUNK);
+      fail_if (oggz_read_input (p_oggz, mx.p_out + offset, len) < 0);
+      offset += len;
+    }
+  oggz_close (p_oggz);
+}
+
+/* Every page's granule position is the end of one of its packets, and they
+   increase up to the total sample count */
+static void
+assert_granule_continuity (void)
+{
+  long i = 0;
+  long k = 0;
+  ck_assert_int_eq (dx.nheaders, 2);
+  ck_assert_int_eq (dx.npackets, MUX_NPACKETS);
+  fail_if (!dx.eos);
+  fail_if (0 == dx.npages);
+  for (i = 0; i < dx.npages; ++i)
+    {
+      while (k < MUX_NPACKETS && mx.ends[k] < dx.page_granules[i])
+        {
+          ++k;
+        }
+      fail_if (k == MUX_NPACKETS);
+      ck_assert_int_eq (dx.page_granules[i], mx.ends[k]);
+      fail_if (i > 0 && dx.page_granules[i] <= dx.page_granules[i - 1]);
+    }
+  ck_assert_int_eq (dx.page_granules[dx.npages - 1],
+                    mx.ends[MUX_NPACKETS - 1]);
+}
+
+START_TEST (test_oggmuxpage_opus_packet_samples)
+{
+  const OMX_U8 celt_fb_20ms[] = {0xF8, 0x00};
+  const OMX_U8 celt_fb_2x20ms[] = {0xF9, 0x00};
+  const OMX_U8 celt_fb_2x20ms_vbr[] = {0xFA, 0x00};
+  const OMX_U8 celt_nb_3x2_5ms[] = {0x83, 0x03};
+  const OMX_U8 silk_wb_60ms[] = {0x58};
+  const OMX_U8 hybrid_swb_10ms[] = {0x60};
+  const OMX_U8 no_frames[] = {0xFB, 0x00};
+  const OMX_U8 too_long[] = {0x1B, 0x03}; /* 3 x 60 ms */
+
+  ck_assert_int_eq (oggmux_opus_packet_samples (celt_fb_20ms, 2), 960);
+  ck_assert_int_eq (oggmux_opus_packet_samples (celt_fb_2x20ms, 2), 1920);
+  ck_assert_int_eq (oggmux_opus_packet_samples (celt_fb_2x20ms_vbr, 2), 1920);
+  ck_assert_int_eq (oggmux_opus_packet_samples (celt_nb_3x2_5ms, 2), 360);
+  ck_assert_int_eq (oggmux_opus_packet_samples (silk_wb_60ms, 1), 2880);
+  ck_assert_int_eq (oggmux_opus_packet_samples (hybrid_swb_10ms, 1), 480);
+  ck_assert_int_eq (oggmux_opus_packet_samples (no_frames, 2), 0);
+  ck_assert_int_eq (oggmux_opus_packet_samples (no_frames, 1), 0);
+  ck_assert_int_eq (oggmux_opus_packet_samples (too_long, 2), 0);
+  ck_assert_int_eq (oggmux_opus_packet_samples (celt_fb_20ms, 0), 0);
+}
+END_TEST
+
+START_TEST (test_oggmuxpage_pager)
+{
+  oggmux_pager_t pager;
+  oggmux_pager_init (&pager, 4800, 4096);
+  fail_if (oggmux_pager_add (&pager, 960, 200, false));
+  fail_if (oggmux_pager_add (&pager, 2880, 200, false));
+  fail_if (!oggmux_pager_add (&pager, 960, 200, false));
+  /* A new page starts after a flush */
+  fail_if (oggmux_pager_add (&pager, 960, 4000, false));
+  fail_if (!oggmux_pager_add (&pager, 960, 96, false));
+  fail_if (!oggmux_pager_add (&pager, 960, 10, true));
+  /* No limits, one page per packet */
+  oggmux_pager_init (&pager, 0, 0);
+  fail_if (!oggmux_pager_add (&pager, 960, 10, false));
+}
+END_TEST
+
+START_TEST (test_oggmuxpage_round_trip)
+{
+  long i = 0;
+  mux_all (MUX_MAX_PAGE_SAMPLES, MUX_MAX_PAGE_BYTES);
+  demux_all ();
+  assert_granule_continuity ();
+
+  /* Pages are flushed by duration, never much later than the limit */
+  for (i = 1; i < dx.npages; ++i)
+    {
+      fail_if (dx.page_granules[i] - dx.page_granules[i - 1]
+               >= MUX_MAX_PAGE_SAMPLES + OPUS_MAX_PACKET_SAMPLES);
+    }
+  fail_if (dx.npages < mx.ends[MUX_NPACKETS - 1]
+                         / (MUX_MAX_PAGE_SAMPLES + OPUS_MAX_PACKET_SAMPLES));
+  fail_if (dx.npages >= MUX_NPACKETS);
+}
+END_TEST
+
+START_TEST (test_oggmuxpage_round_trip_page_per_packet)
+{
+  mux_all (0, 0);
+  demux_all ();
+  assert_granule_continuity ();
+  ck_assert_int_eq (dx.npages, MUX_NPACKETS);
+}
+END_TEST
+
+/* The filter processor relies on this when a port is flushed while oggz still
+   references a payload */
+START_TEST (test_oggmuxpage_close_releases_guarded_packet)
+{
+  ogg_packet op;
+  int guard = 0;
+
+  mx.p_oggz = oggz_new (OGGZ_WRITE);
+  fail_if (NULL == mx.p_oggz);
+  mx.serialno = oggz_serialno_new (mx.p_oggz);
+
+  fail_if (OGGZ_ERR_OK != feed_opus_head ());
+  op.packet = mx.p_packets[0];
+  op.bytes = mx.lens[0];
+  op.b_o_s = 0;
+  op.e_o_s = 0;
+  op.granulepos = mx.ends[0];
+  op.packetno = mx.packetno++;
+  fail_if (OGGZ_ERR_OK
+           != oggz_write_feed (mx.p_oggz, &op, mx.serialno, 0, &guard));
+
+  /* Queued, not yet paged */
+  ck_assert_int_eq (guard, 0);
+  oggz_close (mx.p_oggz);
+  mx.p_oggz = NULL;
+  ck_assert_int_eq (guard, 1);
+}
+END_TEST
+
+static Suite *
+oggmuxpage_suite (void)
+{
+  TCase * tc_oggmuxpage;
+  Suite * s = suite_create ("ogg muxer packetisation");
+
+  tc_oggmuxpage = tcase_create ("packetisation");
+  tcase_set_timeout (tc_oggmuxpage, OGGMUXPAGE_TEST_TIMEOUT);
+  tcase_add_checked_fixture (tc_oggmuxpage, setup, teardown);
+  tcase_add_test (tc_oggmuxpage, test_oggmuxpage_opus_packet_samples);
+  tcase_add_test (tc_oggmuxpage, test_oggmuxpage_pager);
+  tcase_add_test (tc_oggmuxpage, test_oggmuxpage_round_trip);
+  tcase_add_test (tc_oggmuxpage, test_oggmuxpage_round_trip_page_per_packet);
+  tcase_add_test (tc_oggmuxpage,
+                  test_oggmuxpage_close_releases_guarded_packet);
+  suite_add_tcase (s, tc_oggmuxpage);
+
+  return s;
+}
+
+int
+main (void)
+{
+  int number_failed = 1;
+  SRunner * sr = NULL;
+
+  tiz_log_init ();
+
+  sr = srunner_create (oggmuxpage_suite ());
+  srunner_set_log (sr, "-");
+  srunner_run_all (sr, CK_VERBOSE);
+  number_failed = srunner_ntests_failed (sr);
+  srunner_free (sr);
+
+  tiz_log_deinit ();
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Local Variables: */
+/* c-default-style: gnu */
+/* fill-column: 79 */
+/* indent-tabs-mode: nil */
+/* compile-command: "make check" */
+/* End: */
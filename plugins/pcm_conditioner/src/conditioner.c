@@ -0,0 +1,199 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   conditioner.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - PCM conditioner component
+ *
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <string.h>
+
+#include <OMX_Core.h>
+#include <OMX_Component.h>
+#include <OMX_Types.h>
+
+#include <tizplatform.h>
+
+#include <tizport.h>
+#include <tizscheduler.h>
+
+#include "conditionerprc.h"
+#include "conditioner.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.pcm_conditioner"
+#endif
+
+/**
+ *@defgroup libtizpcmconditioner 'libtizpcmconditioner' : OpenMAX IL PCM
+ *conditioner
+ *
+ * - Component name : "OMX.Aratelia.audio_processor.pcm_conditioner"
+ * - Implements role: "audio_processor.pcm"
+ *
+ * Converts the PCM stream on its input port (8, 16 or 24-bit integer, any
+ * signedness and endianness, or 32-bit float) to the format configured on its
+ * output port, i.e. the one preferred by the renderer. It also applies the
+ * output port's volume and mute settings, remaps or mixes the channels
+ * according to the ports' channel mappings, and dithers when the sample size
+ * is reduced.
+ *
+ *@ingroup plugins
+ */
+
+static OMX_VERSIONTYPE pcm_conditioner_version = {{1, 0, 0, 0}};
+
+static OMX_U32
+default_output_bits (void)
+{
+  const long bits = TIZ_RCFILE_GET_INT (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION,
+    "OMX.Aratelia.audio_processor.pcm_conditioner.output_bits", 16);
+  return (24 == bits || 32 == bits) ? (OMX_U32) bits : 16;
+}
+
+static OMX_PTR
+instantiate_pcm_port (OMX_HANDLETYPE ap_hdl, const OMX_U32 a_pid)
+{
+  const bool is_input = (ARATELIA_PCM_CONDITIONER_INPUT_PORT_INDEX == a_pid);
+  OMX_AUDIO_PARAM_PCMMODETYPE pcmmode;
+  OMX_AUDIO_CONFIG_VOLUMETYPE volume;
+  OMX_AUDIO_CONFIG_MUTETYPE mute;
+  OMX_AUDIO_CODINGTYPE encodings[] = {OMX_AUDIO_CodingPCM, OMX_AUDIO_CodingMax};
+  tiz_port_options_t pcm_port_opts = {
+    OMX_PortDomainAudio,
+    is_input ? OMX_DirInput : OMX_DirOutput,
+    ARATELIA_PCM_CONDITIONER_PORT_MIN_BUF_COUNT,
+    ARATELIA_PCM_CONDITIONER_PORT_MIN_BUF_SIZE,
+    ARATELIA_PCM_CONDITIONER_PORT_NONCONTIGUOUS,
+    ARATELIA_PCM_CONDITIONER_PORT_ALIGNMENT,
+    ARATELIA_PCM_CONDITIONER_PORT_SUPPLIERPREF,
+    {a_pid, NULL, NULL, NULL},
+    /* The ports are independent; only the sampling rate is copied from the
+       input to the output, by the processor */
+    -1};
+
+  pcmmode.nSize = sizeof (OMX_AUDIO_PARAM_PCMMODETYPE);
+  pcmmode.nVersion.nVersion = OMX_VERSION;
+  pcmmode.nPortIndex = a_pid;
+  pcmmode.nChannels = 2;
+  pcmmode.eNumData = OMX_NumericalDataSigned;
+  pcmmode.eEndian = OMX_EndianLittle;
+  pcmmode.bInterleaved = OMX_TRUE;
+  pcmmode.nBitPerSample = is_input ? 16 : default_output_bits ();
+  pcmmode.nSamplingRate = 48000;
+  pcmmode.ePCMMode = OMX_AUDIO_PCMModeLinear;
+  pcmmode.eChannelMapping[0] = OMX_AUDIO_ChannelLF;
+  pcmmode.eChannelMapping[1] = OMX_AUDIO_ChannelRF;
+
+  volume.nSize = sizeof (OMX_AUDIO_CONFIG_VOLUMETYPE);
+  volume.nVersion.nVersion = OMX_VERSION;
+  volume.nPortIndex = a_pid;
+  volume.bLinear = OMX_FALSE;
+  volume.sVolume.nValue = ARATELIA_PCM_CONDITIONER_DEFAULT_VOLUME_VALUE;
+  volume.sVolume.nMin = ARATELIA_PCM_CONDITIONER_MIN_VOLUME_VALUE;
+  volume.sVolume.nMax = ARATELIA_PCM_CONDITIONER_MAX_VOLUME_VALUE;
+
+  mute.nSize = sizeof (OMX_AUDIO_CONFIG_MUTETYPE);
+  mute.nVersion.nVersion = OMX_VERSION;
+  mute.nPortIndex = a_pid;
+  mute.bMute = OMX_FALSE;
+
+  return factory_new (tiz_get_type (ap_hdl, "tizpcmport"), &pcm_port_opts,
+                      &encodings, &pcmmode, &volume, &mute);
+}
+
+static OMX_PTR
+instantiate_input_port (OMX_HANDLETYPE ap_hdl)
+{
+  return instantiate_pcm_port (ap_hdl,
+                               ARATELIA_PCM_CONDITIONER_INPUT_PORT_INDEX);
+}
+
+static OMX_PTR
+instantiate_output_port (OMX_HANDLETYPE ap_hdl)
+{
+  return instantiate_pcm_port (ap_hdl,
+                               ARATELIA_PCM_CONDITIONER_OUTPUT_PORT_INDEX);
+}
+
+static OMX_PTR
+instantiate_config_port (OMX_HANDLETYPE ap_hdl)
+{
+  return factory_new (tiz_get_type (ap_hdl, "tizconfigport"),
+                      NULL, /* this port does not take options */
+                      ARATELIA_PCM_CONDITIONER_COMPONENT_NAME,
+                      pcm_conditioner_version);
+}
+
+static OMX_PTR
+instantiate_processor (OMX_HANDLETYPE ap_hdl)
+{
+  return factory_new (tiz_get_type (ap_hdl, "conditionerprc"));
+}
+
+OMX_ERRORTYPE
+OMX_ComponentInit (OMX_HANDLETYPE ap_hdl)
+{
+  tiz_role_factory_t role_factory;
+  const tiz_role_factory_t * rf_list[] = {&role_factory};
+  tiz_type_factory_t conditionerprc_type;
+  const tiz_type_factory_t * tf_list[] = {&conditionerprc_type};
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE,
+           "OMX_ComponentInit: "
+           "Inititializing [%s]",
+           ARATELIA_PCM_CONDITIONER_COMPONENT_NAME);
+
+  strcpy ((OMX_STRING) role_factory.role,
+          ARATELIA_PCM_CONDITIONER_DEFAULT_ROLE);
+  role_factory.pf_cport = instantiate_config_port;
+  role_factory.pf_port[0] = instantiate_input_port;
+  role_factory.pf_port[1] = instantiate_output_port;
+  role_factory.nports = 2;
+  role_factory.pf_proc = instantiate_processor;
+
+  strcpy ((OMX_STRING) conditionerprc_type.class_name,
+          "conditionerprc_class");
+  conditionerprc_type.pf_class_init = conditioner_prc_class_init;
+  strcpy ((OMX_STRING) conditionerprc_type.object_name, "conditionerprc");
+  conditionerprc_type.pf_object_init = conditioner_prc_init;
+
+  /* Initialize the component infrastructure */
+  tiz_check_omx (
+    tiz_comp_init (ap_hdl, ARATELIA_PCM_CONDITIONER_COMPONENT_NAME));
+
+  /* Register the "conditionerprc" class */
+  tiz_check_omx (tiz_comp_register_types (ap_hdl, tf_list, 1));
+
+  /* Register the component role */
+  tiz_check_omx (tiz_comp_register_roles (ap_hdl, rf_list, 1));
+
+  return OMX_ErrorNone;
+}
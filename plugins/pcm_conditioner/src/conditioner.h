@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   conditioner.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - PCM conditioner constants
+ *
+ *
+ */
+#ifndef CONDITIONER_H
+#define CONDITIONER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <OMX_Core.h>
+#include <OMX_Types.h>
+
+#define ARATELIA_PCM_CONDITIONER_DEFAULT_ROLE "audio_processor.pcm"
+#define ARATELIA_PCM_CONDITIONER_COMPONENT_NAME \
+  "OMX.Aratelia.audio_processor.pcm_conditioner"
+/* With libtizonia, port indexes must start at index 0 */
+#define ARATELIA_PCM_CONDITIONER_INPUT_PORT_INDEX 0
+#define ARATELIA_PCM_CONDITIONER_OUTPUT_PORT_INDEX 1
+#define ARATELIA_PCM_CONDITIONER_MAX_CHANNELS 8
+#define ARATELIA_PCM_CONDITIONER_PORT_MIN_BUF_COUNT 4
+/* 50 ms of 32-bit stereo audio at 48KHz */
+#define ARATELIA_PCM_CONDITIONER_PORT_MIN_BUF_SIZE (4 * 4800)
+#define ARATELIA_PCM_CONDITIONER_PORT_NONCONTIGUOUS OMX_FALSE
+#define ARATELIA_PCM_CONDITIONER_PORT_ALIGNMENT 0
+#define ARATELIA_PCM_CONDITIONER_PORT_SUPPLIERPREF OMX_BufferSupplyInput
+#define ARATELIA_PCM_CONDITIONER_DEFAULT_VOLUME_VALUE 100
+#define ARATELIA_PCM_CONDITIONER_MAX_VOLUME_VALUE 100
+#define ARATELIA_PCM_CONDITIONER_MIN_VOLUME_VALUE 0
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONDITIONER_H */
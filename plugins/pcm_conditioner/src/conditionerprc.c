@@ -0,0 +1,1216 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   conditionerprc.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - PCM conditioner processor class implementation
+ *
+ * Every input block goes through three stages: the input samples are decoded
+ * to interleaved floats, the channel matrix (with the gain folded into it) is
+ * applied, and the result is quantised (with TPDF dither when precision is
+ * lost) to the output format. Each stage works on blocks of up to
+ * CONDITIONER_BLOCK_FRAMES frames, with vector kernels where the compiler
+ * supports them.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tizplatform.h>
+
+#include <tizkernel.h>
+
+#include "conditioner.h"
+#include "conditionerprc.h"
+#include "conditionerprc_decls.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.pcm_conditioner.prc"
+#endif
+
+#define CONDITIONER_DOWNMIX_COEF 0.70710678f
+
+static inline bool
+is_float_format (const OMX_AUDIO_PARAM_PCMMODETYPE * ap_pcm)
+{
+  /* In Tizonia, 32-bit PCM is always float */
+  return (32 == ap_pcm->nBitPerSample);
+}
+
+static OMX_U32
+sample_len (const OMX_AUDIO_PARAM_PCMMODETYPE * ap_pcm)
+{
+  assert (ap_pcm);
+  switch (ap_pcm->nBitPerSample)
+    {
+      case 8:
+      case 16:
+      case 24:
+      case 32:
+        return ap_pcm->nBitPerSample / 8;
+      default:
+        return 0;
+    };
+}
+
+static bool
+is_supported_format (const OMX_AUDIO_PARAM_PCMMODETYPE * ap_pcm)
+{
+  assert (ap_pcm);
+  return (sample_len (ap_pcm) > 0 && ap_pcm->nChannels > 0
+          && ap_pcm->nChannels <= ARATELIA_PCM_CONDITIONER_MAX_CHANNELS
+          && OMX_TRUE == ap_pcm->bInterleaved);
+}
+
+static inline bool
+same_format (const OMX_AUDIO_PARAM_PCMMODETYPE * ap_a,
+             const OMX_AUDIO_PARAM_PCMMODETYPE * ap_b)
+{
+  return (ap_a->nChannels == ap_b->nChannels
+          && ap_a->nBitPerSample == ap_b->nBitPerSample
+          && (is_float_format (ap_a)
+              || (ap_a->eNumData == ap_b->eNumData
+                  && (8 == ap_a->nBitPerSample
+                      || ap_a->eEndian == ap_b->eEndian))));
+}
+
+/*
+ * The kernels run the bulk of each block on GCC/Clang generic vector types,
+ * which the compiler lowers to SSE2 on x86-64 and NEON on ARM, independently
+ * of the optimisation level. The scalar loops take the remaining samples, and
+ * the whole block with other compilers; both produce the same results.
+ */
+
+#if defined(__GNUC__) && (defined(__clang__) || __GNUC__ >= 9)
+#define CONDITIONER_HAVE_VECTORS 1
+typedef float cond_v4sf __attribute__ ((vector_size (16)));
+typedef int32_t cond_v4si __attribute__ ((vector_size (16)));
+typedef uint32_t cond_v4su __attribute__ ((vector_size (16)));
+typedef float cond_v8sf __attribute__ ((vector_size (32)));
+typedef int32_t cond_v8si __attribute__ ((vector_size (32)));
+typedef int16_t cond_v8hi __attribute__ ((vector_size (16)));
+typedef uint16_t cond_v8hu __attribute__ ((vector_size (16)));
+typedef float cond_v16sf __attribute__ ((vector_size (64)));
+typedef int32_t cond_v16si __attribute__ ((vector_size (64)));
+typedef int8_t cond_v16qi __attribute__ ((vector_size (16)));
+typedef uint8_t cond_v16qu __attribute__ ((vector_size (16)));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define CONDITIONER_HOST_IS_BIG_ENDIAN true
+#else
+#define CONDITIONER_HOST_IS_BIG_ENDIAN false
+#endif
+#endif
+
+/*
+ * Decoders: input bytes to floats in [-1.0, 1.0)
+ */
+
+static void
+decode_8 (const OMX_U8 * ap_in, float * ap_out, const size_t a_nsamples,
+          const bool a_unsigned)
+{
+  const uint8_t bias = a_unsigned ? 0x80 : 0;
+  size_t i = 0;
+#ifdef CONDITIONER_HAVE_VECTORS
+  for (; i + 16 <= a_nsamples; i += 16)
+    {
+      cond_v16qu v;
+      cond_v16sf f;
+      memcpy (&v, ap_in + i, sizeof (v));
+      v ^= bias;
+      f = __builtin_convertvector ((cond_v16qi) v, cond_v16sf)
+          * (1.0f / 128.0f);
+      memcpy (ap_out + i, &f, sizeof (f));
+    }
+#endif
+  for (; i < a_nsamples; ++i)
+    {
+      ap_out[i] = (float) (int8_t) (ap_in[i] ^ bias) * (1.0f / 128.0f);
+    }
+}
+
+static void
+decode_16 (const OMX_U8 * ap_in, float * ap_out, const size_t a_nsamples,
+           const bool a_unsigned, const bool a_big_endian)
+{
+  const size_t hi = a_big_endian ? 0 : 1;
+  const size_t lo = 1 - hi;
+  const uint16_t bias = a_unsigned ? 0x8000 : 0;
+  size_t i = 0;
+#ifdef CONDITIONER_HAVE_VECTORS
+  const bool swap = (a_big_endian != CONDITIONER_HOST_IS_BIG_ENDIAN);
+  for (; i + 8 <= a_nsamples; i += 8)
+    {
+      cond_v8hu v;
+      cond_v8sf f;
+      memcpy (&v, ap_in + 2 * i, sizeof (v));
+      if (swap)
+        {
+          v = (v << 8) | (v >> 8);
+        }
+      v ^= bias;
+      f = __builtin_convertvector ((cond_v8hi) v, cond_v8sf)
+          * (1.0f / 32768.0f);
+      memcpy (ap_out + i, &f, sizeof (f));
+    }
+#endif
+  for (; i < a_nsamples; ++i)
+    {
+      const uint16_t v = (uint16_t) ((ap_in[2 * i + hi] << 8)
+                                     | ap_in[2 * i + lo]);
+      ap_out[i] = (float) (int16_t) (v ^ bias) * (1.0f / 32768.0f);
+    }
+}
+
+static void
+decode_24 (const OMX_U8 * ap_in, float * ap_out, const size_t a_nsamples,
+           const bool a_unsigned, const bool a_big_endian)
+{
+  const size_t hi = a_big_endian ? 0 : 2;
+  const size_t lo = 2 - hi;
+  const int32_t bias = a_unsigned ? 0x800000 : 0;
+  size_t i = 0;
+#ifdef CONDITIONER_HAVE_VECTORS
+  /* The 3-byte samples are gathered one by one; the sign extension and the
+     conversion run on the vector */
+  for (; i + 8 <= a_nsamples; i += 8)
+    {
+      cond_v8si v;
+      cond_v8sf f;
+      size_t k = 0;
+      for (k = 0; k < 8; ++k)
+        {
+          const OMX_U8 * p_in = ap_in + 3 * (i + k);
+          v[k] = (p_in[hi] << 16) | (p_in[1] << 8) | p_in[lo];
+        }
+      v ^= bias;
+      v = (v ^ 0x800000) - 0x800000;
+      f = __builtin_convertvector (v, cond_v8sf) * (1.0f / 8388608.0f);
+      memcpy (ap_out + i, &f, sizeof (f));
+    }
+#endif
+  for (; i < a_nsamples; ++i)
+    {
+      const int32_t v = ((ap_in[3 * i + hi] << 16) | (ap_in[3 * i + 1] << 8)
+                         | ap_in[3 * i + lo])
+                        ^ bias;
+      /* Sign-extend from 24 bits */
+      ap_out[i] = (float) ((v ^ 0x800000) - 0x800000) * (1.0f / 8388608.0f);
+    }
+}
+
+static void
+decode_block (const conditioner_prc_t * ap_prc, const OMX_U8 * ap_in,
+              float * ap_out, const size_t a_nsamples)
+{
+  const OMX_AUDIO_PARAM_PCMMODETYPE * p_pcm = &(ap_prc->in_pcmmode_);
+  const bool is_unsigned = (OMX_NumericalDataUnsigned == p_pcm->eNumData);
+  const bool is_be = (OMX_EndianBig == p_pcm->eEndian);
+  switch (p_pcm->nBitPerSample)
+    {
+      case 8:
+        decode_8 (ap_in, ap_out, a_nsamples, is_unsigned);
+        break;
+      case 16:
+        decode_16 (ap_in, ap_out, a_nsamples, is_unsigned, is_be);
+        break;
+      case 24:
+        decode_24 (ap_in, ap_out, a_nsamples, is_unsigned, is_be);
+        break;
+      default:
+        memcpy (ap_out, ap_in, a_nsamples * sizeof (float));
+        break;
+    };
+}
+
+/*
+ * Channel matrix
+ */
+
+static void
+scale_block (const float * ap_pattern, const OMX_U32 a_pattern_len,
+             const float * ap_in, float * ap_out, const size_t a_nsamples)
+{
+  /* The gains repeat every a_pattern_len samples, a multiple of both the
+     channel count and the vector width */
+  size_t i = 0;
+  OMX_U32 j = 0;
+#ifdef CONDITIONER_HAVE_VECTORS
+  for (; i + 4 <= a_nsamples; i += 4)
+    {
+      cond_v4sf v;
+      cond_v4sf g;
+      memcpy (&v, ap_in + i, sizeof (v));
+      memcpy (&g, ap_pattern + j, sizeof (g));
+      v *= g;
+      memcpy (ap_out + i, &v, sizeof (v));
+      j += 4;
+      if (j == a_pattern_len)
+        {
+          j = 0;
+        }
+    }
+#endif
+  for (; i < a_nsamples; ++i)
+    {
+      ap_out[i] = ap_in[i] * ap_pattern[j];
+      if (++j == a_pattern_len)
+        {
+          j = 0;
+        }
+    }
+}
+
+static void
+mix_block (const float ap_matrix[][ARATELIA_PCM_CONDITIONER_MAX_CHANNELS],
+           const float * ap_in, float * ap_out, const size_t a_nframes,
+           const OMX_U32 a_in_channels, const OMX_U32 a_out_channels)
+{
+  size_t f = 0;
+  OMX_U32 o = 0;
+  OMX_U32 i = 0;
+  for (f = 0; f < a_nframes; ++f)
+    {
+      const float * p_in = ap_in + f * a_in_channels;
+      float * p_out = ap_out + f * a_out_channels;
+      for (o = 0; o < a_out_channels; ++o)
+        {
+          float acc = 0.0f;
+          for (i = 0; i < a_in_channels; ++i)
+            {
+              acc += ap_matrix[o][i] * p_in[i];
+            }
+          p_out[o] = acc;
+        }
+    }
+}
+
+/*
+ * Encoders: floats to output bytes, quantised with the dither in LSBs
+ */
+
+static void
+quantise_block (const float * ap_in, const float * ap_dither,
+                int32_t * ap_out, const size_t a_nsamples, const float a_scale,
+                const float a_min, const float a_max)
+{
+  /* Out-of-range samples (and NaNs) are clamped, and the rest are rounded
+     half away from zero */
+  size_t i = 0;
+#ifdef CONDITIONER_HAVE_VECTORS
+  const cond_v8sf vmin = (cond_v8sf){0} + a_min;
+  const cond_v8sf vmax = (cond_v8sf){0} + a_max;
+  const cond_v8si vhalf = (cond_v8si) ((cond_v8sf){0} + 0.5f);
+  for (; i + 8 <= a_nsamples; i += 8)
+    {
+      cond_v8sf v;
+      cond_v8sf d;
+      cond_v8si keep;
+      cond_v8si q;
+      memcpy (&v, ap_in + i, sizeof (v));
+      memcpy (&d, ap_dither + i, sizeof (d));
+      v = v * a_scale + d;
+      keep = (v > vmin);
+      v = (cond_v8sf) (((cond_v8si) v & keep) | ((cond_v8si) vmin & ~keep));
+      keep = (v < vmax);
+      v = (cond_v8sf) (((cond_v8si) v & keep) | ((cond_v8si) vmax & ~keep));
+      v += (cond_v8sf) (vhalf | ((cond_v8si) v & INT32_MIN));
+      q = __builtin_convertvector (v, cond_v8si);
+      memcpy (ap_out + i, &q, sizeof (q));
+    }
+#endif
+  for (; i < a_nsamples; ++i)
+    {
+      float v = ap_in[i] * a_scale + ap_dither[i];
+      v = v > a_min ? v : a_min;
+      v = v < a_max ? v : a_max;
+      ap_out[i] = (int32_t) (v + copysignf (0.5f, v));
+    }
+}
+
+static void
+encode_8 (const int32_t * ap_in, OMX_U8 * ap_out, const size_t a_nsamples,
+          const bool a_unsigned)
+{
+  const uint8_t bias = a_unsigned ? 0x80 : 0;
+  size_t i = 0;
+#ifdef CONDITIONER_HAVE_VECTORS
+  for (; i + 16 <= a_nsamples; i += 16)
+    {
+      cond_v16si q;
+      cond_v16qu v;
+      memcpy (&q, ap_in + i, sizeof (q));
+      v = (cond_v16qu) __builtin_convertvector (q, cond_v16qi);
+      v ^= bias;
+      memcpy (ap_out + i, &v, sizeof (v));
+    }
+#endif
+  for (; i < a_nsamples; ++i)
+    {
+      ap_out[i] = (OMX_U8) ap_in[i] ^ bias;
+    }
+}
+
+static void
+encode_16 (const int32_t * ap_in, OMX_U8 * ap_out, const size_t a_nsamples,
+           const bool a_unsigned, const bool a_big_endian)
+{
+  const size_t hi = a_big_endian ? 0 : 1;
+  const size_t lo = 1 - hi;
+  const uint16_t bias = a_unsigned ? 0x8000 : 0;
+  size_t i = 0;
+#ifdef CONDITIONER_HAVE_VECTORS
+  const bool swap = (a_big_endian != CONDITIONER_HOST_IS_BIG_ENDIAN);
+  for (; i + 8 <= a_nsamples; i += 8)
+    {
+      cond_v8si q;
+      cond_v8hu v;
+      memcpy (&q, ap_in + i, sizeof (q));
+      v = (cond_v8hu) __builtin_convertvector (q, cond_v8hi);
+      v ^= bias;
+      if (swap)
+        {
+          v = (v << 8) | (v >> 8);
+        }
+      memcpy (ap_out + 2 * i, &v, sizeof (v));
+    }
+#endif
+  for (; i < a_nsamples; ++i)
+    {
+      const uint16_t v = (uint16_t) ap_in[i] ^ bias;
+      ap_out[2 * i + hi] = (OMX_U8) (v >> 8);
+      ap_out[2 * i + lo] = (OMX_U8) v;
+    }
+}
+
+static void
+encode_24 (const int32_t * ap_in, OMX_U8 * ap_out, const size_t a_nsamples,
+           const bool a_unsigned, const bool a_big_endian)
+{
+  /* Only the byte packing is left at this point; there is no 3-byte vector
+     store, so this one stays scalar */
+  const size_t hi = a_big_endian ? 0 : 2;
+  const size_t lo = 2 - hi;
+  const uint32_t bias = a_unsigned ? 0x800000 : 0;
+  size_t i = 0;
+  for (i = 0; i < a_nsamples; ++i)
+    {
+      const uint32_t v = (uint32_t) ap_in[i] ^ bias;
+      ap_out[3 * i + hi] = (OMX_U8) (v >> 16);
+      ap_out[3 * i + 1] = (OMX_U8) (v >> 8);
+      ap_out[3 * i + lo] = (OMX_U8) v;
+    }
+}
+
+static void
+encode_block (conditioner_prc_t * ap_prc, const float * ap_in,
+              OMX_U8 * ap_out, const size_t a_nsamples)
+{
+  const OMX_AUDIO_PARAM_PCMMODETYPE * p_pcm = &(ap_prc->out_pcmmode_);
+  const bool is_unsigned = (OMX_NumericalDataUnsigned == p_pcm->eNumData);
+  const bool is_be = (OMX_EndianBig == p_pcm->eEndian);
+  switch (p_pcm->nBitPerSample)
+    {
+      case 8:
+        quantise_block (ap_in, ap_prc->dither_block_, ap_prc->quant_block_,
+                        a_nsamples, 128.0f, -128.0f, 127.0f);
+        encode_8 (ap_prc->quant_block_, ap_out, a_nsamples, is_unsigned);
+        break;
+      case 16:
+        quantise_block (ap_in, ap_prc->dither_block_, ap_prc->quant_block_,
+                        a_nsamples, 32768.0f, -32768.0f, 32767.0f);
+        encode_16 (ap_prc->quant_block_, ap_out, a_nsamples, is_unsigned,
+                   is_be);
+        break;
+      case 24:
+        quantise_block (ap_in, ap_prc->dither_block_, ap_prc->quant_block_,
+                        a_nsamples, 8388608.0f, -8388608.0f, 8388607.0f);
+        encode_24 (ap_prc->quant_block_, ap_out, a_nsamples, is_unsigned,
+                   is_be);
+        break;
+      default:
+        memcpy (ap_out, ap_in, a_nsamples * sizeof (float));
+        break;
+    };
+}
+
+static void
+generate_dither (conditioner_prc_t * ap_prc, const size_t a_nsamples)
+{
+  /* Triangular PDF dither, +/- 1 LSB, from the difference of two uniform
+     draws. Four xorshift32 generators run side by side, one per lane, so the
+     block is filled in groups of four */
+  size_t i = 0;
+#ifdef CONDITIONER_HAVE_VECTORS
+  cond_v4su x;
+#endif
+
+  assert (a_nsamples <= CONDITIONER_BLOCK_SAMPLES);
+  assert (0 == CONDITIONER_BLOCK_SAMPLES % 4);
+
+#ifdef CONDITIONER_HAVE_VECTORS
+  memcpy (&x, ap_prc->rng_, sizeof (x));
+  for (i = 0; i < a_nsamples; i += 4)
+    {
+      cond_v4si u1;
+      cond_v4si u2;
+      cond_v4sf d;
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      u1 = (cond_v4si) (x >> 8);
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      u2 = (cond_v4si) (x >> 8);
+      d = (__builtin_convertvector (u1, cond_v4sf)
+           - __builtin_convertvector (u2, cond_v4sf))
+          * (1.0f / 16777216.0f);
+      memcpy (ap_prc->dither_block_ + i, &d, sizeof (d));
+    }
+  memcpy (ap_prc->rng_, &x, sizeof (x));
+#else
+  for (i = 0; i < a_nsamples; i += 4)
+    {
+      size_t k = 0;
+      for (k = 0; k < 4; ++k)
+        {
+          uint32_t x = ap_prc->rng_[k];
+          int32_t u1 = 0;
+          int32_t u2 = 0;
+          x ^= x << 13;
+          x ^= x >> 17;
+          x ^= x << 5;
+          u1 = (int32_t) (x >> 8);
+          x ^= x << 13;
+          x ^= x >> 17;
+          x ^= x << 5;
+          u2 = (int32_t) (x >> 8);
+          ap_prc->dither_block_[i + k]
+            = ((float) u1 - (float) u2) * (1.0f / 16777216.0f);
+          ap_prc->rng_[k] = x;
+        }
+    }
+#endif
+}
+
+static void
+condition_frames (conditioner_prc_t * ap_prc, const OMX_U8 * ap_in,
+                  OMX_U8 * ap_out, const size_t a_nframes)
+{
+  const OMX_U32 in_channels = ap_prc->in_pcmmode_.nChannels;
+  const OMX_U32 out_channels = ap_prc->out_pcmmode_.nChannels;
+
+  assert (a_nframes <= CONDITIONER_BLOCK_FRAMES);
+
+  if (ap_prc->passthrough_)
+    {
+      memcpy (ap_out, ap_in, a_nframes * ap_prc->in_frame_len_);
+      return;
+    }
+
+  decode_block (ap_prc, ap_in, ap_prc->in_block_, a_nframes * in_channels);
+  if (ap_prc->matrix_is_diagonal_)
+    {
+      scale_block (ap_prc->gain_pattern_, 4 * out_channels, ap_prc->in_block_,
+                   ap_prc->out_block_, a_nframes * out_channels);
+    }
+  else
+    {
+      mix_block ((const float(*)[ARATELIA_PCM_CONDITIONER_MAX_CHANNELS])
+                   ap_prc->matrix_,
+                 ap_prc->in_block_, ap_prc->out_block_, a_nframes,
+                 in_channels, out_channels);
+    }
+  if (ap_prc->dither_active_)
+    {
+      generate_dither (ap_prc, a_nframes * out_channels);
+    }
+  encode_block (ap_prc, ap_prc->out_block_, ap_out, a_nframes * out_channels);
+}
+
+/*
+ * Configuration
+ */
+
+static OMX_S32
+find_channel (const OMX_AUDIO_PARAM_PCMMODETYPE * ap_pcm,
+              const OMX_AUDIO_CHANNELTYPE a_channel)
+{
+  OMX_U32 i = 0;
+  if (OMX_AUDIO_ChannelNone != a_channel)
+    {
+      for (i = 0; i < ap_pcm->nChannels; ++i)
+        {
+          if (a_channel == ap_pcm->eChannelMapping[i])
+            {
+              return (OMX_S32) i;
+            }
+        }
+    }
+  return -1;
+}
+
+static void
+downmix_unrouted (conditioner_prc_t * ap_prc, const bool * ap_routed)
+{
+  const OMX_AUDIO_PARAM_PCMMODETYPE * p_in = &(ap_prc->in_pcmmode_);
+  const OMX_AUDIO_PARAM_PCMMODETYPE * p_out = &(ap_prc->out_pcmmode_);
+  const OMX_S32 left = find_channel (p_out, OMX_AUDIO_ChannelLF);
+  const OMX_S32 right = find_channel (p_out, OMX_AUDIO_ChannelRF);
+  OMX_U32 i = 0;
+
+  /* Fold the centre and surround channels that have no counterpart on the
+     output into the front pair; LFE is dropped */
+  for (i = 0; i < p_in->nChannels; ++i)
+    {
+      if (ap_routed[i])
+        {
+          continue;
+        }
+      switch (p_in->eChannelMapping[i])
+        {
+          case OMX_AUDIO_ChannelCF:
+          case OMX_AUDIO_ChannelCS:
+            {
+              if (left >= 0)
+                {
+                  ap_prc->route_[left][i] = CONDITIONER_DOWNMIX_COEF;
+                }
+              if (right >= 0)
+                {
+                  ap_prc->route_[right][i] = CONDITIONER_DOWNMIX_COEF;
+                }
+            }
+            break;
+          case OMX_AUDIO_ChannelLS:
+          case OMX_AUDIO_ChannelLR:
+            {
+              if (left >= 0)
+                {
+                  ap_prc->route_[left][i] = CONDITIONER_DOWNMIX_COEF;
+                }
+            }
+            break;
+          case OMX_AUDIO_ChannelRS:
+          case OMX_AUDIO_ChannelRR:
+            {
+              if (right >= 0)
+                {
+                  ap_prc->route_[right][i] = CONDITIONER_DOWNMIX_COEF;
+                }
+            }
+            break;
+          default:
+            break;
+        };
+    }
+}
+
+static void
+build_route (conditioner_prc_t * ap_prc)
+{
+  const OMX_AUDIO_PARAM_PCMMODETYPE * p_in = &(ap_prc->in_pcmmode_);
+  const OMX_AUDIO_PARAM_PCMMODETYPE * p_out = &(ap_prc->out_pcmmode_);
+  bool routed[ARATELIA_PCM_CONDITIONER_MAX_CHANNELS];
+  OMX_U32 o = 0;
+  OMX_U32 i = 0;
+
+  tiz_mem_set (ap_prc->route_, 0, sizeof (ap_prc->route_));
+  tiz_mem_set (routed, 0, sizeof (routed));
+
+  if (1 == p_in->nChannels)
+    {
+      /* Mono goes to every output channel */
+      for (o = 0; o < p_out->nChannels; ++o)
+        {
+          ap_prc->route_[o][0] = 1.0f;
+        }
+    }
+  else if (1 == p_out->nChannels)
+    {
+      for (i = 0; i < p_in->nChannels; ++i)
+        {
+          ap_prc->route_[0][i] = 1.0f / (float) p_in->nChannels;
+        }
+    }
+  else
+    {
+      for (o = 0; o < p_out->nChannels; ++o)
+        {
+          OMX_S32 match = find_channel (p_in, p_out->eChannelMapping[o]);
+          if (match < 0 && o < p_in->nChannels
+              && find_channel (p_out, p_in->eChannelMapping[o]) < 0)
+            {
+              /* Unknown mapping; fall back to the channel's position */
+              match = (OMX_S32) o;
+            }
+          if (match >= 0)
+            {
+              ap_prc->route_[o][match] = 1.0f;
+              routed[match] = true;
+            }
+        }
+      downmix_unrouted (ap_prc, routed);
+
+      /* Keep each output channel within full scale */
+      for (o = 0; o < p_out->nChannels; ++o)
+        {
+          float sum = 0.0f;
+          for (i = 0; i < p_in->nChannels; ++i)
+            {
+              sum += ap_prc->route_[o][i];
+            }
+          for (i = 0; i < p_in->nChannels && sum > 1.0f; ++i)
+            {
+              ap_prc->route_[o][i] /= sum;
+            }
+        }
+    }
+
+  ap_prc->route_is_identity_ = (p_in->nChannels == p_out->nChannels);
+  for (o = 0; o < p_out->nChannels && ap_prc->route_is_identity_; ++o)
+    {
+      for (i = 0; i < p_in->nChannels; ++i)
+        {
+          if (ap_prc->route_[o][i] != (o == i ? 1.0f : 0.0f))
+            {
+              ap_prc->route_is_identity_ = false;
+              break;
+            }
+        }
+    }
+}
+
+static void
+update_matrix (conditioner_prc_t * ap_prc)
+{
+  const float gain
+    = ap_prc->muted_ ? 0.0f : ap_prc->pre_gain_ * ap_prc->volume_gain_;
+  const OMX_U32 in_bits = ap_prc->in_pcmmode_.nBitPerSample;
+  const OMX_U32 out_bits = ap_prc->out_pcmmode_.nBitPerSample;
+  const bool unity = (1.0f == gain && ap_prc->route_is_identity_);
+  OMX_U32 o = 0;
+  OMX_U32 i = 0;
+
+  for (o = 0; o < ARATELIA_PCM_CONDITIONER_MAX_CHANNELS; ++o)
+    {
+      for (i = 0; i < ARATELIA_PCM_CONDITIONER_MAX_CHANNELS; ++i)
+        {
+          ap_prc->matrix_[o][i] = ap_prc->route_[o][i] * gain;
+        }
+    }
+
+  /* A matrix with no cross terms is a per-channel gain, applied in sample
+     order */
+  ap_prc->matrix_is_diagonal_
+    = (ap_prc->in_pcmmode_.nChannels == ap_prc->out_pcmmode_.nChannels);
+  for (o = 0; o < ARATELIA_PCM_CONDITIONER_MAX_CHANNELS
+              && ap_prc->matrix_is_diagonal_;
+       ++o)
+    {
+      for (i = 0; i < ARATELIA_PCM_CONDITIONER_MAX_CHANNELS; ++i)
+        {
+          if (o != i && 0.0f != ap_prc->matrix_[o][i])
+            {
+              ap_prc->matrix_is_diagonal_ = false;
+              break;
+            }
+        }
+    }
+  if (ap_prc->matrix_is_diagonal_ && ap_prc->out_pcmmode_.nChannels > 0)
+    {
+      const OMX_U32 channels = ap_prc->out_pcmmode_.nChannels;
+      for (i = 0; i < 4 * channels; ++i)
+        {
+          ap_prc->gain_pattern_[i]
+            = ap_prc->matrix_[i % channels][i % channels];
+        }
+    }
+
+  ap_prc->passthrough_
+    = unity && same_format (&(ap_prc->in_pcmmode_), &(ap_prc->out_pcmmode_));
+
+  /* Dither only when the output can't represent the result exactly */
+  ap_prc->dither_active_
+    = ap_prc->dither_enabled_ && !is_float_format (&(ap_prc->out_pcmmode_))
+      && (!unity || is_float_format (&(ap_prc->in_pcmmode_))
+          || in_bits > out_bits);
+  if (!ap_prc->dither_active_)
+    {
+      tiz_mem_set (ap_prc->dither_block_, 0, sizeof (ap_prc->dither_block_));
+    }
+
+  TIZ_DEBUG (handleOf (ap_prc), "gain [%f] passthrough [%s] dither [%s]",
+             gain, ap_prc->passthrough_ ? "YES" : "NO",
+             ap_prc->dither_active_ ? "YES" : "NO");
+}
+
+static void
+read_rc_settings (conditioner_prc_t * ap_prc)
+{
+  const char * p_gain_db = tiz_rcfile_get_value (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION,
+    "OMX.Aratelia.audio_processor.pcm_conditioner.gain_db");
+  ap_prc->pre_gain_ = 1.0f;
+  if (p_gain_db)
+    {
+      char * p_end = NULL;
+      const double db = strtod (p_gain_db, &p_end);
+      if (p_end != p_gain_db)
+        {
+          ap_prc->pre_gain_ = (float) pow (10.0, db / 20.0);
+        }
+    }
+  ap_prc->dither_enabled_ = TIZ_RCFILE_GET_BOOL (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION,
+    "OMX.Aratelia.audio_processor.pcm_conditioner.dither", true);
+}
+
+static OMX_ERRORTYPE
+update_output_rate (conditioner_prc_t * ap_prc)
+{
+  assert (ap_prc);
+  /* There is no resampling; the output runs at the input's rate */
+  if (ap_prc->out_pcmmode_.nSamplingRate != ap_prc->in_pcmmode_.nSamplingRate)
+    {
+      TIZ_DEBUG (handleOf (ap_prc),
+                 "Updating output sample rate : old [%u] new [%u]",
+                 ap_prc->out_pcmmode_.nSamplingRate,
+                 ap_prc->in_pcmmode_.nSamplingRate);
+      ap_prc->out_pcmmode_.nSamplingRate = ap_prc->in_pcmmode_.nSamplingRate;
+      tiz_check_omx (tiz_krn_SetParameter_internal (
+        tiz_get_krn (handleOf (ap_prc)), handleOf (ap_prc),
+        OMX_IndexParamAudioPcm, &(ap_prc->out_pcmmode_)));
+      tiz_srv_issue_event ((OMX_PTR) ap_prc, OMX_EventPortSettingsChanged,
+                           ARATELIA_PCM_CONDITIONER_OUTPUT_PORT_INDEX,
+                           OMX_IndexParamAudioPcm, /* the index of the
+                                                      struct that has
+                                                      been modififed */
+                           NULL);
+    }
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+configure (conditioner_prc_t * ap_prc)
+{
+  assert (ap_prc);
+
+  TIZ_INIT_OMX_PORT_STRUCT (ap_prc->in_pcmmode_,
+                            ARATELIA_PCM_CONDITIONER_INPUT_PORT_INDEX);
+  tiz_check_omx (tiz_api_GetParameter (
+    tiz_get_krn (handleOf (ap_prc)), handleOf (ap_prc), OMX_IndexParamAudioPcm,
+    &(ap_prc->in_pcmmode_)));
+  TIZ_INIT_OMX_PORT_STRUCT (ap_prc->out_pcmmode_,
+                            ARATELIA_PCM_CONDITIONER_OUTPUT_PORT_INDEX);
+  tiz_check_omx (tiz_api_GetParameter (
+    tiz_get_krn (handleOf (ap_prc)), handleOf (ap_prc), OMX_IndexParamAudioPcm,
+    &(ap_prc->out_pcmmode_)));
+
+  if (!is_supported_format (&(ap_prc->in_pcmmode_))
+      || !is_supported_format (&(ap_prc->out_pcmmode_)))
+    {
+      TIZ_ERROR (handleOf (ap_prc),
+                 "[OMX_ErrorUnsupportedSetting] : in [%u ch, %u bits] "
+                 "out [%u ch, %u bits]",
+                 ap_prc->in_pcmmode_.nChannels,
+                 ap_prc->in_pcmmode_.nBitPerSample,
+                 ap_prc->out_pcmmode_.nChannels,
+                 ap_prc->out_pcmmode_.nBitPerSample);
+      return OMX_ErrorUnsupportedSetting;
+    }
+
+  ap_prc->in_frame_len_
+    = sample_len (&(ap_prc->in_pcmmode_)) * ap_prc->in_pcmmode_.nChannels;
+  ap_prc->out_frame_len_
+    = sample_len (&(ap_prc->out_pcmmode_)) * ap_prc->out_pcmmode_.nChannels;
+  ap_prc->carry_len_ = 0;
+
+  TIZ_NOTICE (handleOf (ap_prc),
+              "in [%u ch, %u bits, %u Hz] out [%u ch, %u bits]",
+              ap_prc->in_pcmmode_.nChannels, ap_prc->in_pcmmode_.nBitPerSample,
+              ap_prc->in_pcmmode_.nSamplingRate,
+              ap_prc->out_pcmmode_.nChannels,
+              ap_prc->out_pcmmode_.nBitPerSample);
+
+  build_route (ap_prc);
+  update_matrix (ap_prc);
+  return update_output_rate (ap_prc);
+}
+
+/*
+ * Buffer processing
+ */
+
+static inline OMX_U32
+out_space (const OMX_BUFFERHEADERTYPE * ap_hdr)
+{
+  return ap_hdr->nAllocLen - ap_hdr->nOffset - ap_hdr->nFilledLen;
+}
+
+static inline OMX_U8 *
+out_write_ptr (OMX_BUFFERHEADERTYPE * ap_hdr)
+{
+  return ap_hdr->pBuffer + ap_hdr->nOffset + ap_hdr->nFilledLen;
+}
+
+static inline void
+consume_input (OMX_BUFFERHEADERTYPE * ap_hdr, const OMX_U32 a_nbytes)
+{
+  assert (ap_hdr->nFilledLen >= a_nbytes);
+  ap_hdr->nOffset += a_nbytes;
+  ap_hdr->nFilledLen -= a_nbytes;
+}
+
+static OMX_ERRORTYPE
+transform_buffer (conditioner_prc_t * ap_prc)
+{
+  OMX_BUFFERHEADERTYPE * p_in = tiz_filter_prc_get_header (
+    ap_prc, ARATELIA_PCM_CONDITIONER_INPUT_PORT_INDEX);
+  OMX_BUFFERHEADERTYPE * p_out = tiz_filter_prc_get_header (
+    ap_prc, ARATELIA_PCM_CONDITIONER_OUTPUT_PORT_INDEX);
+
+  if (!p_in || !p_out)
+    {
+      TIZ_TRACE (handleOf (ap_prc), "IN HEADER [%p] OUT HEADER [%p]", p_in,
+                 p_out);
+      return OMX_ErrorNone;
+    }
+
+  assert (ap_prc->in_frame_len_ > 0);
+  assert (ap_prc->out_frame_len_ > 0);
+
+  while (p_in->nFilledLen > 0)
+    {
+      const OMX_U32 space = out_space (p_out);
+      if (space < ap_prc->out_frame_len_)
+        {
+          /* Output is full; the input buffer is kept for the next round */
+          return tiz_filter_prc_release_header (
+            ap_prc, ARATELIA_PCM_CONDITIONER_OUTPUT_PORT_INDEX);
+        }
+
+      if (ap_prc->carry_len_ > 0 || p_in->nFilledLen < ap_prc->in_frame_len_)
+        {
+          /* A frame split across input buffers */
+          const OMX_U32 nbytes
+            = MIN (ap_prc->in_frame_len_ - ap_prc->carry_len_,
+                   p_in->nFilledLen);
+          memcpy (ap_prc->carry_ + ap_prc->carry_len_,
+                  p_in->pBuffer + p_in->nOffset, nbytes);
+          consume_input (p_in, nbytes);
+          ap_prc->carry_len_ += nbytes;
+          if (ap_prc->carry_len_ == ap_prc->in_frame_len_)
+            {
+              condition_frames (ap_prc, ap_prc->carry_, out_write_ptr (p_out),
+                                1);
+              p_out->nFilledLen += ap_prc->out_frame_len_;
+              ap_prc->carry_len_ = 0;
+            }
+        }
+      else
+        {
+          const OMX_U32 nframes
+            = MIN (MIN (p_in->nFilledLen / ap_prc->in_frame_len_,
+                        space / ap_prc->out_frame_len_),
+                   CONDITIONER_BLOCK_FRAMES);
+          condition_frames (ap_prc, p_in->pBuffer + p_in->nOffset,
+                            out_write_ptr (p_out), nframes);
+          consume_input (p_in, nframes * ap_prc->in_frame_len_);
+          p_out->nFilledLen += nframes * ap_prc->out_frame_len_;
+        }
+    }
+
+  if ((p_in->nFlags & OMX_BUFFERFLAG_EOS) > 0)
+    {
+      TIZ_TRACE (handleOf (ap_prc), "Propagating EOS flag to output");
+      p_out->nFlags |= OMX_BUFFERFLAG_EOS;
+      p_in->nFlags &= ~OMX_BUFFERFLAG_EOS;
+      /* A partial frame at the end of the stream is discarded */
+      ap_prc->carry_len_ = 0;
+    }
+
+  tiz_check_omx (tiz_filter_prc_release_header (
+    ap_prc, ARATELIA_PCM_CONDITIONER_INPUT_PORT_INDEX));
+
+  /* Don't hold on to converted data while waiting for more input */
+  if (p_out->nFilledLen > 0 || (p_out->nFlags & OMX_BUFFERFLAG_EOS) > 0)
+    {
+      tiz_check_omx (tiz_filter_prc_release_header (
+        ap_prc, ARATELIA_PCM_CONDITIONER_OUTPUT_PORT_INDEX));
+    }
+
+  return OMX_ErrorNone;
+}
+
+static inline OMX_ERRORTYPE
+do_flush (conditioner_prc_t * ap_prc, OMX_U32 a_pid)
+{
+  assert (ap_prc);
+  if (OMX_ALL == a_pid || ARATELIA_PCM_CONDITIONER_INPUT_PORT_INDEX == a_pid)
+    {
+      ap_prc->carry_len_ = 0;
+    }
+  /* Release any buffers held  */
+  return tiz_filter_prc_release_header (ap_prc, a_pid);
+}
+
+/*
+ * conditionerprc
+ */
+
+static void *
+conditioner_prc_ctor (void * ap_obj, va_list * app)
+{
+  conditioner_prc_t * p_prc
+    = super_ctor (typeOf (ap_obj, "conditionerprc"), ap_obj, app);
+  assert (p_prc);
+  tiz_mem_set (&(p_prc->in_pcmmode_), 0, sizeof (p_prc->in_pcmmode_));
+  tiz_mem_set (&(p_prc->out_pcmmode_), 0, sizeof (p_prc->out_pcmmode_));
+  p_prc->in_frame_len_ = 0;
+  p_prc->out_frame_len_ = 0;
+  tiz_mem_set (p_prc->route_, 0, sizeof (p_prc->route_));
+  tiz_mem_set (p_prc->matrix_, 0, sizeof (p_prc->matrix_));
+  p_prc->route_is_identity_ = false;
+  p_prc->volume_gain_ = 1.0f;
+  p_prc->muted_ = false;
+  p_prc->dither_active_ = false;
+  p_prc->passthrough_ = false;
+  p_prc->matrix_is_diagonal_ = false;
+  p_prc->rng_[0] = 0x9e3779b9;
+  p_prc->rng_[1] = 0x7f4a7c15;
+  p_prc->rng_[2] = 0x85ebca6b;
+  p_prc->rng_[3] = 0xc2b2ae35;
+  p_prc->carry_len_ = 0;
+  read_rc_settings (p_prc);
+  return p_prc;
+}
+
+static void *
+conditioner_prc_dtor (void * ap_obj)
+{
+  return super_dtor (typeOf (ap_obj, "conditionerprc"), ap_obj);
+}
+
+/*
+ * from tizsrv class
+ */
+
+static OMX_ERRORTYPE
+conditioner_prc_allocate_resources (void * ap_obj, OMX_U32 a_pid)
+{
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+conditioner_prc_deallocate_resources (void * ap_obj)
+{
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+conditioner_prc_prepare_to_transfer (void * ap_obj, OMX_U32 a_pid)
+{
+  return configure (ap_obj);
+}
+
+static OMX_ERRORTYPE
+conditioner_prc_transfer_and_process (void * ap_obj, OMX_U32 a_pid)
+{
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+conditioner_prc_stop_and_return (void * ap_obj)
+{
+  return tiz_filter_prc_release_all_headers (ap_obj);
+}
+
+/*
+ * from tizprc class
+ */
+
+static OMX_ERRORTYPE
+conditioner_prc_buffers_ready (const void * ap_obj)
+{
+  conditioner_prc_t * p_prc = (conditioner_prc_t *) ap_obj;
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+
+  assert (p_prc);
+
+  while (tiz_filter_prc_headers_available (p_prc) && OMX_ErrorNone == rc)
+    {
+      rc = transform_buffer (p_prc);
+    }
+  return rc;
+}
+
+static OMX_ERRORTYPE
+conditioner_prc_port_flush (const void * ap_obj, OMX_U32 a_pid)
+{
+  conditioner_prc_t * p_prc = (conditioner_prc_t *) ap_obj;
+  return do_flush (p_prc, a_pid);
+}
+
+static OMX_ERRORTYPE
+conditioner_prc_port_disable (const void * ap_obj, OMX_U32 a_pid)
+{
+  conditioner_prc_t * p_prc = (conditioner_prc_t *) ap_obj;
+  assert (p_prc);
+  tiz_filter_prc_update_port_disabled_flag (p_prc, a_pid, true);
+  return do_flush (p_prc, a_pid);
+}
+
+static OMX_ERRORTYPE
+conditioner_prc_port_enable (const void * ap_obj, OMX_U32 a_pid)
+{
+  conditioner_prc_t * p_prc = (conditioner_prc_t *) ap_obj;
+  assert (p_prc);
+  tiz_filter_prc_update_port_disabled_flag (p_prc, a_pid, false);
+  /* The settings of either port may have changed while disabled */
+  return configure (p_prc);
+}
+
+static OMX_ERRORTYPE
+conditioner_prc_config_change (void * ap_obj, OMX_U32 a_pid,
+                               OMX_INDEXTYPE a_config_idx)
+{
+  conditioner_prc_t * p_prc = ap_obj;
+
+  assert (p_prc);
+
+  if (OMX_IndexConfigAudioVolume == a_config_idx)
+    {
+      OMX_AUDIO_CONFIG_VOLUMETYPE volume;
+      TIZ_INIT_OMX_PORT_STRUCT (volume, a_pid);
+      tiz_check_omx (tiz_api_GetConfig (tiz_get_krn (handleOf (p_prc)),
+                                        handleOf (p_prc),
+                                        OMX_IndexConfigAudioVolume, &volume));
+      TIZ_TRACE (handleOf (p_prc),
+                 "[OMX_IndexConfigAudioVolume] : volume.sVolume.nValue = %ld",
+                 volume.sVolume.nValue);
+      if (volume.sVolume.nValue <= ARATELIA_PCM_CONDITIONER_MAX_VOLUME_VALUE
+          && volume.sVolume.nValue >= ARATELIA_PCM_CONDITIONER_MIN_VOLUME_VALUE)
+        {
+          /* A squared curve is a cheap approximation of a perceptual scale */
+          const float v = (float) volume.sVolume.nValue
+                          / ARATELIA_PCM_CONDITIONER_MAX_VOLUME_VALUE;
+          p_prc->volume_gain_ = v * v;
+          update_matrix (p_prc);
+        }
+    }
+  else if (OMX_IndexConfigAudioMute == a_config_idx)
+    {
+      OMX_AUDIO_CONFIG_MUTETYPE mute;
+      TIZ_INIT_OMX_PORT_STRUCT (mute, a_pid);
+      tiz_check_omx (tiz_api_GetConfig (tiz_get_krn (handleOf (p_prc)),
+                                        handleOf (p_prc),
+                                        OMX_IndexConfigAudioMute, &mute));
+      TIZ_TRACE (handleOf (p_prc), "[OMX_IndexConfigAudioMute] : bMute = [%s]",
+                 (mute.bMute == OMX_FALSE ? "FALSE" : "TRUE"));
+      p_prc->muted_ = (OMX_TRUE == mute.bMute);
+      update_matrix (p_prc);
+    }
+  return OMX_ErrorNone;
+}
+
+/*
+ * conditioner_prc_class
+ */
+
+static void *
+conditioner_prc_class_ctor (void * ap_obj, va_list * app)
+{
+  /* NOTE: Class methods might be added in the future. None for now. */
+  return super_ctor (typeOf (ap_obj, "conditionerprc_class"), ap_obj, app);
+}
+
+/*
+ * initialization
+ */
+
+void *
+conditioner_prc_class_init (void * ap_tos, void * ap_hdl)
+{
+  void * tizfilterprc = tiz_get_type (ap_hdl, "tizfilterprc");
+  void * conditionerprc_class = factory_new
+    /* TIZ_CLASS_COMMENT: class type, class name, parent, size */
+    (classOf (tizfilterprc), "conditionerprc_class", classOf (tizfilterprc),
+     sizeof (conditioner_prc_class_t),
+     /* TIZ_CLASS_COMMENT: */
+     ap_tos, ap_hdl,
+     /* TIZ_CLASS_COMMENT: class constructor */
+     ctor, conditioner_prc_class_ctor,
+     /* TIZ_CLASS_COMMENT: stop value*/
+     0);
+  return conditionerprc_class;
+}
+
+void *
+conditioner_prc_init (void * ap_tos, void * ap_hdl)
+{
+  void * tizfilterprc = tiz_get_type (ap_hdl, "tizfilterprc");
+  void * conditionerprc_class = tiz_get_type (ap_hdl, "conditionerprc_class");
+  TIZ_LOG_CLASS (conditionerprc_class);
+  void * conditionerprc = factory_new
+    /* TIZ_CLASS_COMMENT: class type, class name, parent, size */
+    (conditionerprc_class, "conditionerprc", tizfilterprc,
+     sizeof (conditioner_prc_t),
+     /* TIZ_CLASS_COMMENT: */
+     ap_tos, ap_hdl,
+     /* TIZ_CLASS_COMMENT: class constructor */
+     ctor, conditioner_prc_ctor,
+     /* TIZ_CLASS_COMMENT: class destructor */
+     dtor, conditioner_prc_dtor,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_allocate_resources, conditioner_prc_allocate_resources,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_deallocate_resources, conditioner_prc_deallocate_resources,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_prepare_to_transfer, conditioner_prc_prepare_to_transfer,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_transfer_and_process, conditioner_prc_transfer_and_process,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_srv_stop_and_return, conditioner_prc_stop_and_return,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_buffers_ready, conditioner_prc_buffers_ready,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_port_flush, conditioner_prc_port_flush,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_port_disable, conditioner_prc_port_disable,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_port_enable, conditioner_prc_port_enable,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_prc_config_change, conditioner_prc_config_change,
+     /* TIZ_CLASS_COMMENT: stop value*/
+     0);
+
+  return conditionerprc;
+}
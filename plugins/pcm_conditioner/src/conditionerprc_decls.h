@@ -0,0 +1,100 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   conditionerprc_decls.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  Tizonia - PCM conditioner processor class declarations
+ *
+ *
+ */
+
+#ifndef CONDITIONERPRC_DECLS_H
+#define CONDITIONERPRC_DECLS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <OMX_Core.h>
+
+#include <tizfilterprc.h>
+#include <tizfilterprc_decls.h>
+
+#include "conditioner.h"
+
+/* Number of frames converted in one go */
+#define CONDITIONER_BLOCK_FRAMES 256
+#define CONDITIONER_BLOCK_SAMPLES \
+  (CONDITIONER_BLOCK_FRAMES * ARATELIA_PCM_CONDITIONER_MAX_CHANNELS)
+
+  typedef struct conditioner_prc conditioner_prc_t;
+  struct conditioner_prc
+  {
+    /* Object */
+    const tiz_filter_prc_t _;
+    OMX_AUDIO_PARAM_PCMMODETYPE in_pcmmode_;
+    OMX_AUDIO_PARAM_PCMMODETYPE out_pcmmode_;
+    OMX_U32 in_frame_len_;
+    OMX_U32 out_frame_len_;
+    /* Channel routing, [out][in], and the same with the gain applied */
+    float route_[ARATELIA_PCM_CONDITIONER_MAX_CHANNELS]
+                [ARATELIA_PCM_CONDITIONER_MAX_CHANNELS];
+    float matrix_[ARATELIA_PCM_CONDITIONER_MAX_CHANNELS]
+                 [ARATELIA_PCM_CONDITIONER_MAX_CHANNELS];
+    bool route_is_identity_;
+    /* When the matrix has no cross terms, its diagonal repeated to span a
+       whole number of 4-float vectors */
+    bool matrix_is_diagonal_;
+    float gain_pattern_[4 * ARATELIA_PCM_CONDITIONER_MAX_CHANNELS];
+    float pre_gain_;
+    float volume_gain_;
+    bool muted_;
+    bool dither_enabled_;
+    bool dither_active_;
+    bool passthrough_;
+    /* One xorshift32 state per vector lane */
+    uint32_t rng_[4];
+    /* A frame split across two input buffers */
+    OMX_U8 carry_[ARATELIA_PCM_CONDITIONER_MAX_CHANNELS * sizeof (float)];
+    OMX_U32 carry_len_;
+    float in_block_[CONDITIONER_BLOCK_SAMPLES];
+    float out_block_[CONDITIONER_BLOCK_SAMPLES];
+    float dither_block_[CONDITIONER_BLOCK_SAMPLES];
+    int32_t quant_block_[CONDITIONER_BLOCK_SAMPLES];
+  };
+
+  typedef struct conditioner_prc_class conditioner_prc_class_t;
+  struct conditioner_prc_class
+  {
+    /* Class */
+    const tiz_filter_prc_class_t _;
+    /* NOTE: Class methods might be added in the future */
+  };
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONDITIONERPRC_DECLS_H */
@@ -42,6 +42,7 @@
 #include <tizport.h>
 #include <tizscheduler.h>
 
+#include "arport.h"
 #include "arprc.h"
 #include "ar.h"
 
@@ -108,7 +109,7 @@ instantiate_pcm_port (OMX_HANDLETYPE ap_hdl)
   mute.nPortIndex = ARATELIA_AUDIO_RENDERER_PORT_INDEX;
   mute.bMute = OMX_FALSE;
 
-  return factory_new (tiz_get_type (ap_hdl, "tizpcmport"), &port_opts,
+  return factory_new (tiz_get_type (ap_hdl, "arport"), &port_opts,
                       &encodings, &pcmmode, &volume, &mute);
 }
 
@@ -133,8 +134,9 @@ OMX_ComponentInit (OMX_HANDLETYPE ap_hdl)
 {
   tiz_role_factory_t role_factory;
   const tiz_role_factory_t * rf_list[] = {&role_factory};
-  tiz_type_factory_t type_factory;
-  const tiz_type_factory_t * tf_list[] = {&type_factory};
+  tiz_type_factory_t arport_type;
+  tiz_type_factory_t arprc_type;
+  const tiz_type_factory_t * tf_list[] = {&arport_type, &arprc_type};
 
   strcpy ((OMX_STRING) role_factory.role, ARATELIA_AUDIO_RENDERER_DEFAULT_ROLE);
   role_factory.pf_cport = instantiate_config_port;
@@ -142,17 +144,22 @@ OMX_ComponentInit (OMX_HANDLETYPE ap_hdl)
   role_factory.nports = 1;
   role_factory.pf_proc = instantiate_processor;
 
-  strcpy ((OMX_STRING) type_factory.class_name, "arprc_class");
-  type_factory.pf_class_init = ar_prc_class_init;
-  strcpy ((OMX_STRING) type_factory.object_name, "arprc");
-  type_factory.pf_object_init = ar_prc_init;
+  strcpy ((OMX_STRING) arport_type.class_name, "arport_class");
+  arport_type.pf_class_init = ar_port_class_init;
+  strcpy ((OMX_STRING) arport_type.object_name, "arport");
+  arport_type.pf_object_init = ar_port_init;
+
+  strcpy ((OMX_STRING) arprc_type.class_name, "arprc_class");
+  arprc_type.pf_class_init = ar_prc_class_init;
+  strcpy ((OMX_STRING) arprc_type.object_name, "arprc");
+  arprc_type.pf_object_init = ar_prc_init;
 
   /* Initialize the component infrastructure */
   tiz_check_omx (
     tiz_comp_init (ap_hdl, ARATELIA_AUDIO_RENDERER_COMPONENT_NAME));
 
-  /* Register the "arprc" processor class */
-  tiz_check_omx (tiz_comp_register_types (ap_hdl, tf_list, 1));
+  /* Register the "arport" and "arprc" classes */
+  tiz_check_omx (tiz_comp_register_types (ap_hdl, tf_list, 2));
 
   /* Register pcm renderer role */
   tiz_check_omx (tiz_comp_register_roles (ap_hdl, rf_list, 1));
@@ -59,6 +59,18 @@ extern "C"
 
 #define ARATELIA_AUDIO_RENDERER_DEFAULT_RAMP_STEP_COUNT 20
 
+/* Overall device latency used when no period size and count have been
+   configured */
+#define ARATELIA_AUDIO_RENDERER_DEFAULT_LATENCY_US 100000
+#define ARATELIA_AUDIO_RENDERER_DEFAULT_PERIOD_SIZE 0
+#define ARATELIA_AUDIO_RENDERER_DEFAULT_PERIOD_COUNT 0
+#define ARATELIA_AUDIO_RENDERER_PERIOD_SIZE_RC_KEY \
+  "OMX.Aratelia.audio_renderer.alsa.pcm.period_size"
+#define ARATELIA_AUDIO_RENDERER_PERIOD_COUNT_RC_KEY \
+  "OMX.Aratelia.audio_renderer.alsa.pcm.period_count"
+#define ARATELIA_AUDIO_RENDERER_MMAP_RC_KEY \
+  "OMX.Aratelia.audio_renderer.alsa.pcm.mmap"
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,280 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   arport.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief A specialised port class for the ALSA pcm renderer component -
+ * implementation
+ *
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#include <tizplatform.h>
+
+#include <tizkernel.h>
+#include <tizscheduler.h>
+#include <tizfsm.h>
+#include <tizport-macros.h>
+
+#include "ar.h"
+#include "arport.h"
+#include "arport_decls.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.audio_renderer.port"
+#endif
+
+static OMX_U32
+get_rc_u32_value (const void * ap_obj, const char * ap_key,
+                  const OMX_U32 a_default)
+{
+  const char * p_value
+    = tiz_rcfile_get_value (TIZ_RCFILE_PLUGINS_DATA_SECTION, ap_key);
+  OMX_U32 value = a_default;
+  if (p_value)
+    {
+      char * p_end = NULL;
+      long lvalue = 0;
+      errno = 0;
+      lvalue = strtol (p_value, &p_end, 10);
+      if (p_end != p_value && 0 == errno && lvalue >= 0)
+        {
+          value = (OMX_U32) lvalue;
+        }
+      else
+        {
+          TIZ_WARN (handleOf (ap_obj), "Ignoring invalid value [%s] for [%s]",
+                    p_value, ap_key);
+        }
+    }
+  return value;
+}
+
+/*
+ * arport class
+ */
+
+static void *
+ar_port_ctor (void * ap_obj, va_list * app)
+{
+  ar_port_t * p_obj = super_ctor (typeOf (ap_obj, "arport"), ap_obj, app);
+  assert (p_obj);
+
+  tiz_check_omx_ret_null (tiz_port_register_index (
+    p_obj, OMX_TizoniaIndexConfigAudioPcmBuffering)); /* r/w */
+  tiz_check_omx_ret_null (tiz_port_register_index (
+    p_obj, OMX_TizoniaIndexConfigAudioPcmDelay)); /* read-only */
+
+  /* OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE */
+  p_obj->buffering_.nSize = sizeof (OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE);
+  p_obj->buffering_.nVersion.nVersion = OMX_VERSION;
+  p_obj->buffering_.nPortIndex = ARATELIA_AUDIO_RENDERER_PORT_INDEX;
+  p_obj->buffering_.nPeriodSize = get_rc_u32_value (
+    p_obj, ARATELIA_AUDIO_RENDERER_PERIOD_SIZE_RC_KEY,
+    ARATELIA_AUDIO_RENDERER_DEFAULT_PERIOD_SIZE);
+  p_obj->buffering_.nPeriodCount = get_rc_u32_value (
+    p_obj, ARATELIA_AUDIO_RENDERER_PERIOD_COUNT_RC_KEY,
+    ARATELIA_AUDIO_RENDERER_DEFAULT_PERIOD_COUNT);
+  p_obj->buffering_.bMmapAccess
+    = (TIZ_RCFILE_GET_BOOL (TIZ_RCFILE_PLUGINS_DATA_SECTION,
+                            ARATELIA_AUDIO_RENDERER_MMAP_RC_KEY, false)
+         ? OMX_TRUE
+         : OMX_FALSE);
+
+  return p_obj;
+}
+
+static void *
+ar_port_dtor (void * ap_obj)
+{
+  return super_dtor (typeOf (ap_obj, "arport"), ap_obj);
+}
+
+/*
+ * from tiz_api
+ */
+
+static OMX_ERRORTYPE
+ar_port_GetConfig (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
+                   OMX_INDEXTYPE a_index, OMX_PTR ap_struct)
+{
+  const ar_port_t * p_obj = ap_obj;
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+
+  assert (p_obj);
+
+  TIZ_TRACE (ap_hdl, "GetConfig [%s]...", tiz_idx_to_str (a_index));
+
+  if (OMX_TizoniaIndexConfigAudioPcmBuffering == a_index)
+    {
+      OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE * p_buffering
+        = (OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE *) ap_struct;
+      *p_buffering = p_obj->buffering_;
+    }
+  else if (OMX_TizoniaIndexConfigAudioPcmDelay == a_index)
+    {
+      /* Only the processor knows about the current state of the alsa
+         device. So lets get the processor to fill this info for us. */
+      void * p_prc = tiz_get_prc (ap_hdl);
+      assert (p_prc);
+      if (OMX_ErrorNone
+          != (rc = tiz_api_GetConfig (p_prc, ap_hdl, a_index, ap_struct)))
+        {
+          TIZ_ERROR (ap_hdl,
+                     "[%s] : Error retrieving [%s] "
+                     "from the processor",
+                     tiz_err_to_str (rc), tiz_idx_to_str (a_index));
+        }
+    }
+  else
+    {
+      /* Try the parent's indexes */
+      rc = super_GetConfig (typeOf (ap_obj, "arport"), ap_obj, ap_hdl, a_index,
+                            ap_struct);
+    }
+
+  return rc;
+}
+
+static OMX_ERRORTYPE
+ar_port_SetConfig (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
+                   OMX_INDEXTYPE a_index, OMX_PTR ap_struct)
+{
+  ar_port_t * p_obj = (ar_port_t *) ap_obj;
+  OMX_ERRORTYPE rc = OMX_ErrorNone;
+
+  assert (p_obj);
+
+  TIZ_TRACE (ap_hdl, "SetConfig [%s]...", tiz_idx_to_str (a_index));
+
+  if (OMX_TizoniaIndexConfigAudioPcmBuffering == a_index)
+    {
+      const OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE * p_buffering
+        = (OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE *) ap_struct;
+
+      const tiz_fsm_state_id_t now
+        = tiz_fsm_get_substate (tiz_get_fsm (ap_hdl));
+
+      /* The buffering is only applied when the alsa device is configured */
+      if (EStateLoaded != now && TIZ_PORT_IS_ENABLED (p_obj))
+        {
+          TIZ_ERROR (ap_hdl,
+                     "[OMX_ErrorIncorrectStateOperation] : "
+                     "(In state %s, port enabled)...",
+                     tiz_fsm_state_to_str (now));
+          rc = OMX_ErrorIncorrectStateOperation;
+        }
+      else if (p_buffering->nPeriodCount == 1)
+        {
+          TIZ_ERROR (ap_hdl,
+                     "[OMX_ErrorBadParameter] : "
+                     "At least two periods are needed [%u]",
+                     p_buffering->nPeriodCount);
+          rc = OMX_ErrorBadParameter;
+        }
+      else
+        {
+          p_obj->buffering_.nPeriodSize = p_buffering->nPeriodSize;
+          p_obj->buffering_.nPeriodCount = p_buffering->nPeriodCount;
+          p_obj->buffering_.bMmapAccess = p_buffering->bMmapAccess;
+        }
+    }
+  else if (OMX_TizoniaIndexConfigAudioPcmDelay == a_index)
+    {
+      /* This is a read-only index. Simply ignore it. */
+      TIZ_NOTICE (ap_hdl, "Ignoring read-only index [%s] ",
+                  tiz_idx_to_str (a_index));
+    }
+  else
+    {
+      /* Try the parent's indexes */
+      rc = super_SetConfig (typeOf (ap_obj, "arport"), ap_obj, ap_hdl, a_index,
+                            ap_struct);
+    }
+
+  return rc;
+}
+
+/*
+ * arport_class
+ */
+
+static void *
+ar_port_class_ctor (void * ap_obj, va_list * app)
+{
+  /* NOTE: Class methods might be added in the future. None for now. */
+  return super_ctor (typeOf (ap_obj, "arport_class"), ap_obj, app);
+}
+
+/*
+ * initialization
+ */
+
+void *
+ar_port_class_init (void * ap_tos, void * ap_hdl)
+{
+  void * tizpcmport = tiz_get_type (ap_hdl, "tizpcmport");
+  void * arport_class = factory_new
+    /* TIZ_CLASS_COMMENT: class type, class name, parent, size */
+    (classOf (tizpcmport), "arport_class", classOf (tizpcmport),
+     sizeof (ar_port_class_t),
+     /* TIZ_CLASS_COMMENT: */
+     ap_tos, ap_hdl,
+     /* TIZ_CLASS_COMMENT: class constructor */
+     ctor, ar_port_class_ctor,
+     /* TIZ_CLASS_COMMENT: stop value*/
+     0);
+  return arport_class;
+}
+
+void *
+ar_port_init (void * ap_tos, void * ap_hdl)
+{
+  void * tizpcmport = tiz_get_type (ap_hdl, "tizpcmport");
+  void * arport_class = tiz_get_type (ap_hdl, "arport_class");
+  TIZ_LOG_CLASS (arport_class);
+  void * arport = factory_new
+    /* TIZ_CLASS_COMMENT: class type, class name, parent, size */
+    (arport_class, "arport", tizpcmport, sizeof (ar_port_t),
+     /* TIZ_CLASS_COMMENT: */
+     ap_tos, ap_hdl,
+     /* TIZ_CLASS_COMMENT: class constructor */
+     ctor, ar_port_ctor,
+     /* TIZ_CLASS_COMMENT: class destructor */
+     dtor, ar_port_dtor,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_api_GetConfig, ar_port_GetConfig,
+     /* TIZ_CLASS_COMMENT: */
+     tiz_api_SetConfig, ar_port_SetConfig,
+     /* TIZ_CLASS_COMMENT: stop value*/
+     0);
+
+  return arport;
+}
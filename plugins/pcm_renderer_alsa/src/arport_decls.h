@@ -0,0 +1,63 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   arport_decls.h
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief A specialised port class for the ALSA pcm renderer component
+ *
+ *
+ */
+
+#ifndef ARPORT_DECLS_H
+#define ARPORT_DECLS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <OMX_Audio.h>
+#include <OMX_TizoniaExt.h>
+#include <OMX_Types.h>
+
+#include <tizpcmport_decls.h>
+
+  typedef struct ar_port ar_port_t;
+  struct ar_port
+  {
+    /* Object */
+    const tiz_pcmport_t _;
+    OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE buffering_;
+  };
+
+  typedef struct ar_port_class ar_port_class_t;
+  struct ar_port_class
+  {
+    /* Class */
+    const tiz_pcmport_class_t _;
+    /* NOTE: Class methods might be added in the future */
+  };
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARPORT_DECLS_H */
@@ -314,6 +314,165 @@ retrieve_alsa_pcm_format_and_num_channels (ar_prc_t * ap_prc,
   return OMX_ErrorNone;
 }
 
+static OMX_ERRORTYPE
+retrieve_buffering_config (ar_prc_t * ap_prc)
+{
+  assert (ap_prc);
+  TIZ_INIT_OMX_PORT_STRUCT (ap_prc->buffering_,
+                            ARATELIA_AUDIO_RENDERER_PORT_INDEX);
+  tiz_check_omx (tiz_api_GetConfig (
+    tiz_get_krn (handleOf (ap_prc)), handleOf (ap_prc),
+    OMX_TizoniaIndexConfigAudioPcmBuffering, &ap_prc->buffering_));
+  TIZ_NOTICE (handleOf (ap_prc),
+              "period size = [%u] period count = [%u] mmap access = [%s]",
+              ap_prc->buffering_.nPeriodSize, ap_prc->buffering_.nPeriodCount,
+              ap_prc->buffering_.bMmapAccess == OMX_TRUE ? "YES" : "NO");
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+set_alsa_hw_params (ar_prc_t * ap_prc, const snd_pcm_format_t a_format)
+{
+  snd_pcm_t * p_pcm = NULL;
+  snd_pcm_hw_params_t * p_hw = NULL;
+  snd_pcm_access_t access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  unsigned int rate = 0;
+
+  assert (ap_prc);
+  assert (ap_prc->p_pcm_);
+  assert (ap_prc->p_hw_params_);
+
+  p_pcm = ap_prc->p_pcm_;
+  p_hw = ap_prc->p_hw_params_;
+  rate = ap_prc->pcmmode_.nSamplingRate;
+  ap_prc->mmap_access_ = false;
+
+  if (OMX_TRUE == ap_prc->buffering_.bMmapAccess)
+    {
+      if (0
+          == snd_pcm_hw_params_test_access (p_pcm, p_hw,
+                                            SND_PCM_ACCESS_MMAP_INTERLEAVED))
+        {
+          access = SND_PCM_ACCESS_MMAP_INTERLEAVED;
+          ap_prc->mmap_access_ = true;
+        }
+      else
+        {
+          TIZ_NOTICE (handleOf (ap_prc),
+                      "mmap access not supported by the alsa pcm; "
+                      "using read/write access");
+        }
+    }
+
+  bail_on_snd_pcm_error (snd_pcm_hw_params_set_access (p_pcm, p_hw, access));
+  bail_on_snd_pcm_error (
+    snd_pcm_hw_params_set_format (p_pcm, p_hw, a_format));
+  bail_on_snd_pcm_error (snd_pcm_hw_params_set_channels (
+    p_pcm, p_hw, ap_prc->num_channels_supported_));
+  /* allow alsa-lib resampling */
+  bail_on_snd_pcm_error (snd_pcm_hw_params_set_rate_resample (p_pcm, p_hw, 1));
+  bail_on_snd_pcm_error (
+    snd_pcm_hw_params_set_rate_near (p_pcm, p_hw, &rate, 0));
+
+  if (ap_prc->buffering_.nPeriodSize > 0 || ap_prc->buffering_.nPeriodCount > 0)
+    {
+      if (ap_prc->buffering_.nPeriodSize > 0)
+        {
+          snd_pcm_uframes_t period_size = ap_prc->buffering_.nPeriodSize;
+          bail_on_snd_pcm_error (snd_pcm_hw_params_set_period_size_near (
+            p_pcm, p_hw, &period_size, 0));
+        }
+      if (ap_prc->buffering_.nPeriodCount > 0)
+        {
+          unsigned int periods = ap_prc->buffering_.nPeriodCount;
+          bail_on_snd_pcm_error (
+            snd_pcm_hw_params_set_periods_near (p_pcm, p_hw, &periods, 0));
+        }
+    }
+  else
+    {
+      /* Same defaults that snd_pcm_set_params would use */
+      unsigned int buffer_time = ARATELIA_AUDIO_RENDERER_DEFAULT_LATENCY_US;
+      unsigned int period_time = buffer_time / 4;
+      bail_on_snd_pcm_error (
+        snd_pcm_hw_params_set_buffer_time_near (p_pcm, p_hw, &buffer_time, 0));
+      bail_on_snd_pcm_error (
+        snd_pcm_hw_params_set_period_time_near (p_pcm, p_hw, &period_time, 0));
+    }
+
+  /* Install the hardware configuration */
+  bail_on_snd_pcm_error (snd_pcm_hw_params (p_pcm, p_hw));
+
+  bail_on_snd_pcm_error (
+    snd_pcm_hw_params_get_period_size (p_hw, &ap_prc->period_size_, 0));
+  bail_on_snd_pcm_error (
+    snd_pcm_hw_params_get_buffer_size (p_hw, &ap_prc->buffer_size_));
+
+  TIZ_NOTICE (handleOf (ap_prc),
+              "access = [%s] rate = [%u] period size = [%lu] "
+              "buffer size = [%lu] frames",
+              snd_pcm_access_name (access), rate, ap_prc->period_size_,
+              ap_prc->buffer_size_);
+
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+set_alsa_sw_params (ar_prc_t * ap_prc)
+{
+  snd_pcm_sw_params_t * p_sw = NULL;
+
+  assert (ap_prc);
+  assert (ap_prc->p_pcm_);
+  assert (ap_prc->period_size_ > 0);
+
+  snd_pcm_sw_params_alloca (&p_sw);
+  bail_on_snd_pcm_error (snd_pcm_sw_params_current (ap_prc->p_pcm_, p_sw));
+  /* Start the transfer when the buffer is full... */
+  bail_on_snd_pcm_error (snd_pcm_sw_params_set_start_threshold (
+    ap_prc->p_pcm_, p_sw,
+    (ap_prc->buffer_size_ / ap_prc->period_size_) * ap_prc->period_size_));
+  /* ... and wake up when there is space for at least one period */
+  bail_on_snd_pcm_error (snd_pcm_sw_params_set_avail_min (
+    ap_prc->p_pcm_, p_sw, ap_prc->period_size_));
+  bail_on_snd_pcm_error (snd_pcm_sw_params (ap_prc->p_pcm_, p_sw));
+
+  return OMX_ErrorNone;
+}
+
+static void
+start_alsa_pcm_if_prepared (ar_prc_t * ap_prc)
+{
+  assert (ap_prc);
+  /* The start threshold is only honoured by snd_pcm_writei. With mmap access
+     (or when there are no more samples to come) the stream needs to be
+     started explicitly. */
+  if (ap_prc->p_pcm_
+      && SND_PCM_STATE_PREPARED == snd_pcm_state (ap_prc->p_pcm_))
+    {
+      const int err = snd_pcm_start (ap_prc->p_pcm_);
+      if (err < 0)
+        {
+          TIZ_ERROR (handleOf (ap_prc), "snd_pcm_start error: %s",
+                     snd_strerror (err));
+        }
+    }
+}
+
+static void
+update_alsa_delay (ar_prc_t * ap_prc)
+{
+  snd_pcm_sframes_t delay = 0;
+  assert (ap_prc);
+  /* There is nothing queued when the device is not running, paused or
+     draining, e.g. after EOS or a flush */
+  if (!ap_prc->p_pcm_ || 0 != snd_pcm_delay (ap_prc->p_pcm_, &delay))
+    {
+      delay = 0;
+    }
+  ap_prc->delay_ = delay > 0 ? delay : 0;
+}
+
 /*@null@*/ static char *
 get_alsa_device (ar_prc_t * ap_prc)
 {
@@ -851,6 +1010,74 @@ arrange_samples_buffer (ar_prc_t * ap_prc, OMX_BUFFERHEADERTYPE * ap_hdr,
   return OMX_ErrorNone;
 }
 
+static snd_pcm_sframes_t
+write_mmap_frames (ar_prc_t * ap_prc, OMX_BUFFERHEADERTYPE * ap_hdr,
+                   const unsigned long int a_sample_size,
+                   const unsigned long int a_step,
+                   const snd_pcm_uframes_t a_samples_per_channel)
+{
+  const snd_pcm_channel_area_t * p_areas = NULL;
+  snd_pcm_uframes_t offset = 0;
+  snd_pcm_uframes_t frames = a_samples_per_channel;
+  snd_pcm_sframes_t avail = 0;
+  snd_pcm_sframes_t committed = 0;
+  const OMX_U8 * p_src = NULL;
+  OMX_U8 * p_dst = NULL;
+  int err = 0;
+
+  assert (ap_prc);
+  assert (ap_hdr);
+
+  if ((avail = snd_pcm_avail_update (ap_prc->p_pcm_)) < 0)
+    {
+      return avail;
+    }
+  else if (0 == avail)
+    {
+      return -EAGAIN;
+    }
+
+  if ((err = snd_pcm_mmap_begin (ap_prc->p_pcm_, &p_areas, &offset, &frames))
+      < 0)
+    {
+      return err;
+    }
+
+  /* Interleaved access: all channels share the first area */
+  assert (p_areas[0].step / 8
+          == a_sample_size * ap_prc->num_channels_supported_);
+  p_src = ap_hdr->pBuffer + ap_hdr->nOffset;
+  p_dst = (OMX_U8 *) p_areas[0].addr + (p_areas[0].first / 8)
+          + offset * (p_areas[0].step / 8);
+
+  if (ap_prc->pcmmode_.nChannels < ap_prc->num_channels_supported_)
+    {
+      /* Replicate each sample into all the device channels, straight into
+         the DMA area */
+      snd_pcm_uframes_t i = 0;
+      for (i = 0; i < frames; ++i)
+        {
+          unsigned int j = 0;
+          for (j = 0; j < ap_prc->num_channels_supported_; ++j)
+            {
+              memcpy (p_dst, p_src + (a_step * i), a_sample_size);
+              p_dst += a_sample_size;
+            }
+        }
+    }
+  else
+    {
+      memcpy (p_dst, p_src, frames * a_step);
+    }
+
+  committed = snd_pcm_mmap_commit (ap_prc->p_pcm_, offset, frames);
+  if (committed >= 0 && (snd_pcm_uframes_t) committed != frames)
+    {
+      committed = -EPIPE;
+    }
+  return committed;
+}
+
 static OMX_ERRORTYPE
 render_buffer (ar_prc_t * ap_prc, OMX_BUFFERHEADERTYPE * ap_hdr)
 {
@@ -872,13 +1099,20 @@ render_buffer (ar_prc_t * ap_prc, OMX_BUFFERHEADERTYPE * ap_hdr)
 
   while (samples_per_channel > 0 && OMX_ErrorNone == rc)
     {
-      const void * p_buffer = NULL;
       snd_pcm_sframes_t err = 0;
 
-      tiz_check_omx (arrange_samples_buffer (ap_prc, ap_hdr, sample_size, step,
-                                             samples_per_channel, &p_buffer));
-
-      err = snd_pcm_writei (ap_prc->p_pcm_, p_buffer, samples_per_channel);
+      if (ap_prc->mmap_access_)
+        {
+          err = write_mmap_frames (ap_prc, ap_hdr, sample_size, step,
+                                   samples_per_channel);
+        }
+      else
+        {
+          const void * p_buffer = NULL;
+          tiz_check_omx (arrange_samples_buffer (
+            ap_prc, ap_hdr, sample_size, step, samples_per_channel, &p_buffer));
+          err = snd_pcm_writei (ap_prc->p_pcm_, p_buffer, samples_per_channel);
+        }
 
       if (-EAGAIN == err)
         {
@@ -958,6 +1192,9 @@ buffer_emptied (ar_prc_t * ap_prc)
       /* Record the fact that EOS shown up. We'll signal it to the client on a
            timer event */
       ap_prc->nflags_ = ap_prc->p_inhdr_->nFlags;
+      /* No more samples are coming; make sure the device plays out what it
+         has, even if the start threshold has not been reached. */
+      start_alsa_pcm_if_prepared (ap_prc);
       tiz_check_omx (start_eos_timer (ap_prc));
     }
 
@@ -986,9 +1223,15 @@ render_pcm_data (ar_prc_t * ap_prc)
 
   if (OMX_ErrorNoMore == rc)
     {
+      if (ap_prc->mmap_access_)
+        {
+          start_alsa_pcm_if_prepared (ap_prc);
+        }
       rc = start_io_watcher (ap_prc);
     }
 
+  update_alsa_delay (ap_prc);
+
   return rc;
 }
 
@@ -1000,8 +1243,14 @@ static void *
 ar_prc_ctor (void * ap_prc, va_list * app)
 {
   ar_prc_t * p_prc = super_ctor (typeOf (ap_prc, "arprc"), ap_prc, app);
+  TIZ_INIT_OMX_PORT_STRUCT (p_prc->buffering_,
+                            ARATELIA_AUDIO_RENDERER_PORT_INDEX);
   p_prc->p_pcm_ = NULL;
   p_prc->p_hw_params_ = NULL;
+  p_prc->period_size_ = 0;
+  p_prc->buffer_size_ = 0;
+  p_prc->delay_ = 0;
+  p_prc->mmap_access_ = false;
   p_prc->p_pcm_name_ = NULL;
   p_prc->p_mixer_name_ = NULL;
   p_prc->swap_byte_order_ = false;
@@ -1115,13 +1364,13 @@ ar_prc_prepare_to_transfer (void * ap_prc, OMX_U32 TIZ_UNUSED (a_pid))
       tiz_check_omx (retrieve_alsa_pcm_format_and_num_channels (
         p_prc, &snd_pcm_format, &p_prc->num_channels_supported_));
 
-      /* This sets the hardware and software parameters in a convenient way. */
-      bail_on_snd_pcm_error (snd_pcm_set_params (
-        p_prc->p_pcm_, snd_pcm_format, SND_PCM_ACCESS_RW_INTERLEAVED,
-        (unsigned int) p_prc->num_channels_supported_,
-        p_prc->pcmmode_.nSamplingRate, 0, /* allow alsa-lib resampling */
-        100000                            /* overall latency in us */
-        ));
+      /* Retrieve the period size and count, and the access mode */
+      tiz_check_omx (retrieve_buffering_config (p_prc));
+
+      /* Now set the hardware and software parameters */
+      tiz_check_omx (set_alsa_hw_params (p_prc, snd_pcm_format));
+      tiz_check_omx (set_alsa_sw_params (p_prc));
+      p_prc->delay_ = 0;
 
       bail_on_snd_pcm_error (snd_pcm_poll_descriptors (
         p_prc->p_pcm_, p_prc->p_fds_, p_prc->descriptor_count_));
@@ -1409,6 +1658,33 @@ ar_prc_config_change (void * ap_prc, OMX_U32 a_pid, OMX_INDEXTYPE a_config_idx)
   return rc;
 }
 
+static OMX_ERRORTYPE
+ar_prc_GetConfig (const void * ap_obj, OMX_HANDLETYPE ap_hdl,
+                  OMX_INDEXTYPE a_index, OMX_PTR ap_struct)
+{
+  ar_prc_t * p_prc = (ar_prc_t *) ap_obj;
+  assert (p_prc);
+
+  if (OMX_TizoniaIndexConfigAudioPcmDelay == a_index)
+    {
+      OMX_TIZONIA_AUDIO_CONFIG_PCMDELAYTYPE * p_delay
+        = (OMX_TIZONIA_AUDIO_CONFIG_PCMDELAYTYPE *) ap_struct;
+      const OMX_U32 rate = p_prc->pcmmode_.nSamplingRate;
+      /* The device keeps playing (or stops) between writes */
+      update_alsa_delay (p_prc);
+      p_delay->nDelay = p_prc->delay_;
+      p_delay->nDelayUs
+        = rate > 0 ? (OMX_U32) (((OMX_U64) p_prc->delay_ * 1000000) / rate)
+                   : 0;
+      p_delay->nPeriodSize = p_prc->period_size_;
+      p_delay->nBufferSize = p_prc->buffer_size_;
+      return OMX_ErrorNone;
+    }
+
+  return super_GetConfig (typeOf (ap_obj, "arprc"), ap_obj, ap_hdl, a_index,
+                          ap_struct);
+}
+
 /*
  * ar_prc_class
  */
@@ -1456,6 +1732,8 @@ ar_prc_init (void * ap_tos, void * ap_hdl)
      /* TIZ_CLASS_COMMENT: class destructor */
      dtor, ar_prc_dtor,
      /* TIZ_CLASS_COMMENT: */
+     tiz_api_GetConfig, ar_prc_GetConfig,
+     /* TIZ_CLASS_COMMENT: */
      tiz_srv_allocate_resources, ar_prc_allocate_resources,
      /* TIZ_CLASS_COMMENT: */
      tiz_srv_deallocate_resources, ar_prc_deallocate_resources,
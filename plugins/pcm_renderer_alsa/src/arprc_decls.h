@@ -39,6 +39,7 @@ extern "C"
 #include <poll.h>
 
 #include <OMX_Core.h>
+#include <OMX_TizoniaExt.h>
 
 #include <tizprc_decls.h>
 
@@ -48,8 +49,13 @@ extern "C"
     /* Object */
     const tiz_prc_t _;
     OMX_AUDIO_PARAM_PCMMODETYPE pcmmode_;
+    OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE buffering_;
     snd_pcm_t * p_pcm_;
     snd_pcm_hw_params_t * p_hw_params_;
+    snd_pcm_uframes_t period_size_;
+    snd_pcm_uframes_t buffer_size_;
+    snd_pcm_sframes_t delay_;
+    bool mmap_access_;
     char * p_pcm_name_;
     char * p_mixer_name_;
     bool swap_byte_order_;
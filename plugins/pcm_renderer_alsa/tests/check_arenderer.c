@@ -0,0 +1,379 @@
+/**
+ * Copyright (C) 2011-2020 Aratelia Limited - Juan A. Rubio and contributors
+ *
+ * This file is part of Tizonia
+ *
+ * Tizonia is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Tizonia is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Tizonia.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file   check_arenderer.c
+ * @author Juan A. Rubio <juan.rubio@aratelia.com>
+ *
+ * @brief  ALSA pcm renderer unit tests
+ *
+ * The component is driven through the IL Core on ALSA's "null" device, once
+ * with interleaved writes and once with mmap writes.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <check.h>
+
+#include <OMX_Component.h>
+#include <OMX_Core.h>
+#include <OMX_TizoniaExt.h>
+#include <OMX_Types.h>
+
+#include <tizplatform.h>
+
+#include "ar.h"
+#include "check_arenderer.h"
+
+#ifdef TIZ_LOG_CATEGORY_NAME
+#undef TIZ_LOG_CATEGORY_NAME
+#define TIZ_LOG_CATEGORY_NAME "tiz.audio_renderer.check"
+#endif
+
+/* Must match the values in tizonia.conf */
+#define PERIOD_SIZE 1024
+#define PERIOD_COUNT 4
+
+#define MAX_BUFFERS 16
+/* Roughly a second of 48KHz, stereo, 16-bit audio with the minimum port
+   buffer size */
+#define BUFFERS_TO_RENDER 48
+/* duration of event timeout in msec when we expect event to be set */
+#define TIMEOUT_EXPECTING_SUCCESS 5000
+
+typedef struct check_ar_context check_ar_context_t;
+struct check_ar_context
+{
+  tiz_mutex_t mutex;
+  tiz_cond_t cond;
+  OMX_STATETYPE state;
+  OMX_ERRORTYPE error;
+  bool eos;
+  OMX_BUFFERHEADERTYPE * p_free_hdrs[MAX_BUFFERS];
+  OMX_U32 num_free_hdrs;
+};
+
+static OMX_ERRORTYPE
+check_EventHandler (OMX_HANDLETYPE ap_hdl, OMX_PTR ap_app_data,
+                    OMX_EVENTTYPE eEvent, OMX_U32 nData1, OMX_U32 nData2,
+                    OMX_PTR pEventData)
+{
+  check_ar_context_t * p_ctx = ap_app_data;
+  assert (p_ctx);
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "Component Event [%s]", tiz_evt_to_str (eEvent));
+
+  tiz_mutex_lock (&p_ctx->mutex);
+  if (OMX_EventCmdComplete == eEvent && OMX_CommandStateSet == nData1)
+    {
+      p_ctx->state = (OMX_STATETYPE) nData2;
+    }
+  else if (OMX_EventBufferFlag == eEvent)
+    {
+      p_ctx->eos = true;
+    }
+  else if (OMX_EventError == eEvent)
+    {
+      p_ctx->error = (OMX_ERRORTYPE) nData1;
+    }
+  tiz_cond_broadcast (&p_ctx->cond);
+  tiz_mutex_unlock (&p_ctx->mutex);
+
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+check_EmptyBufferDone (OMX_HANDLETYPE ap_hdl, OMX_PTR ap_app_data,
+                       OMX_BUFFERHEADERTYPE * ap_buf)
+{
+  check_ar_context_t * p_ctx = ap_app_data;
+  assert (p_ctx);
+  assert (ap_buf);
+
+  tiz_mutex_lock (&p_ctx->mutex);
+  assert (p_ctx->num_free_hdrs < MAX_BUFFERS);
+  p_ctx->p_free_hdrs[p_ctx->num_free_hdrs++] = ap_buf;
+  tiz_cond_broadcast (&p_ctx->cond);
+  tiz_mutex_unlock (&p_ctx->mutex);
+
+  return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE
+check_FillBufferDone (OMX_HANDLETYPE ap_hdl, OMX_PTR ap_app_data,
+                      OMX_BUFFERHEADERTYPE * ap_buf)
+{
+  return OMX_ErrorNone;
+}
+
+static OMX_CALLBACKTYPE _check_cbacks
+  = {check_EventHandler, check_EmptyBufferDone, check_FillBufferDone};
+
+/* Waits until the component has reached a_state, or has reported an error */
+static bool
+wait_for_state (check_ar_context_t * ap_ctx, OMX_STATETYPE a_state)
+{
+  bool timedout = false;
+  bool reached = false;
+  tiz_mutex_lock (&ap_ctx->mutex);
+  while (!timedout && ap_ctx->state != a_state
+         && OMX_ErrorNone == ap_ctx->error)
+    {
+      timedout = (OMX_ErrorNone
+                  != tiz_cond_timedwait (&ap_ctx->cond, &ap_ctx->mutex,
+                                         TIMEOUT_EXPECTING_SUCCESS));
+    }
+  reached = (ap_ctx->state == a_state);
+  tiz_mutex_unlock (&ap_ctx->mutex);
+  return reached;
+}
+
+static OMX_BUFFERHEADERTYPE *
+wait_for_free_hdr (check_ar_context_t * ap_ctx)
+{
+  OMX_BUFFERHEADERTYPE * p_hdr = NULL;
+  bool timedout = false;
+  tiz_mutex_lock (&ap_ctx->mutex);
+  while (!timedout && 0 == ap_ctx->num_free_hdrs
+         && OMX_ErrorNone == ap_ctx->error)
+    {
+      timedout = (OMX_ErrorNone
+                  != tiz_cond_timedwait (&ap_ctx->cond, &ap_ctx->mutex,
+                                         TIMEOUT_EXPECTING_SUCCESS));
+    }
+  if (ap_ctx->num_free_hdrs > 0)
+    {
+      p_hdr = ap_ctx->p_free_hdrs[--ap_ctx->num_free_hdrs];
+    }
+  tiz_mutex_unlock (&ap_ctx->mutex);
+  return p_hdr;
+}
+
+static bool
+wait_for_eos (check_ar_context_t * ap_ctx)
+{
+  bool timedout = false;
+  bool eos = false;
+  tiz_mutex_lock (&ap_ctx->mutex);
+  while (!timedout && !ap_ctx->eos && OMX_ErrorNone == ap_ctx->error)
+    {
+      timedout = (OMX_ErrorNone
+                  != tiz_cond_timedwait (&ap_ctx->cond, &ap_ctx->mutex,
+                                         TIMEOUT_EXPECTING_SUCCESS));
+    }
+  eos = ap_ctx->eos;
+  tiz_mutex_unlock (&ap_ctx->mutex);
+  return eos;
+}
+
+static void
+get_delay (OMX_HANDLETYPE ap_hdl,
+           OMX_TIZONIA_AUDIO_CONFIG_PCMDELAYTYPE * ap_delay)
+{
+  OMX_ERRORTYPE error = OMX_ErrorNone;
+  TIZ_INIT_OMX_PORT_STRUCT (*ap_delay, ARATELIA_AUDIO_RENDERER_PORT_INDEX);
+  error = OMX_GetConfig (ap_hdl, OMX_TizoniaIndexConfigAudioPcmDelay, ap_delay);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+}
+
+static void
+render_pcm (const OMX_BOOL a_mmap)
+{
+  OMX_ERRORTYPE error = OMX_ErrorNone;
+  OMX_HANDLETYPE p_hdl = NULL;
+  OMX_PARAM_PORTDEFINITIONTYPE port_def;
+  OMX_TIZONIA_AUDIO_CONFIG_PCMBUFFERINGTYPE buffering;
+  OMX_TIZONIA_AUDIO_CONFIG_PCMDELAYTYPE delay;
+  OMX_BUFFERHEADERTYPE * p_hdrs[MAX_BUFFERS];
+  check_ar_context_t ctx;
+  OMX_U32 i = 0;
+
+  memset (&ctx, 0, sizeof (ctx));
+  ctx.state = OMX_StateMax;
+  ctx.error = OMX_ErrorNone;
+  fail_if (OMX_ErrorNone != tiz_mutex_init (&ctx.mutex));
+  fail_if (OMX_ErrorNone != tiz_cond_init (&ctx.cond));
+
+  error = OMX_Init ();
+  ck_assert_int_eq (error, OMX_ErrorNone);
+
+  error = OMX_GetHandle (&p_hdl, ARATELIA_AUDIO_RENDERER_COMPONENT_NAME, &ctx,
+                         &_check_cbacks);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+
+  /* Select the write path; this is only allowed before the device is
+     configured */
+  TIZ_INIT_OMX_PORT_STRUCT (buffering, ARATELIA_AUDIO_RENDERER_PORT_INDEX);
+  error = OMX_GetConfig (p_hdl, OMX_TizoniaIndexConfigAudioPcmBuffering,
+                         &buffering);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+  fail_if (buffering.nPeriodSize != PERIOD_SIZE);
+  fail_if (buffering.nPeriodCount != PERIOD_COUNT);
+  ck_assert_int_eq (buffering.bMmapAccess, OMX_FALSE);
+  buffering.bMmapAccess = a_mmap;
+  error = OMX_SetConfig (p_hdl, OMX_TizoniaIndexConfigAudioPcmBuffering,
+                         &buffering);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+
+  TIZ_INIT_OMX_PORT_STRUCT (port_def, ARATELIA_AUDIO_RENDERER_PORT_INDEX);
+  error = OMX_GetParameter (p_hdl, OMX_IndexParamPortDefinition, &port_def);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+  fail_if (port_def.nBufferCountActual > MAX_BUFFERS);
+
+  /* Loaded -> Idle */
+  error = OMX_SendCommand (p_hdl, OMX_CommandStateSet, OMX_StateIdle, NULL);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+  for (i = 0; i < port_def.nBufferCountActual; ++i)
+    {
+      error = OMX_AllocateBuffer (p_hdl, &p_hdrs[i],
+                                  ARATELIA_AUDIO_RENDERER_PORT_INDEX, NULL,
+                                  port_def.nBufferSize);
+      ck_assert_int_eq (error, OMX_ErrorNone);
+      ctx.p_free_hdrs[ctx.num_free_hdrs++] = p_hdrs[i];
+    }
+  fail_if (!wait_for_state (&ctx, OMX_StateIdle));
+
+  /* Idle -> Executing */
+  error = OMX_SendCommand (p_hdl, OMX_CommandStateSet, OMX_StateExecuting,
+                           NULL);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+  fail_if (!wait_for_state (&ctx, OMX_StateExecuting));
+
+  /* The device is now configured, so the buffering can't change any more */
+  error = OMX_SetConfig (p_hdl, OMX_TizoniaIndexConfigAudioPcmBuffering,
+                         &buffering);
+  ck_assert_int_eq (error, OMX_ErrorIncorrectStateOperation);
+
+  for (i = 0; i < BUFFERS_TO_RENDER; ++i)
+    {
+      OMX_BUFFERHEADERTYPE * p_hdr = wait_for_free_hdr (&ctx);
+      fail_if (!p_hdr);
+      memset (p_hdr->pBuffer, 0, p_hdr->nAllocLen);
+      p_hdr->nOffset = 0;
+      p_hdr->nFilledLen = p_hdr->nAllocLen;
+      p_hdr->nFlags = (i == BUFFERS_TO_RENDER - 1) ? OMX_BUFFERFLAG_EOS : 0;
+      error = OMX_EmptyThisBuffer (p_hdl, p_hdr);
+      ck_assert_int_eq (error, OMX_ErrorNone);
+
+      if (i == BUFFERS_TO_RENDER / 2)
+        {
+          get_delay (p_hdl, &delay);
+          fail_if (0 == delay.nPeriodSize);
+          fail_if (delay.nBufferSize < 2 * delay.nPeriodSize);
+          fail_if (delay.nDelay > delay.nBufferSize);
+        }
+    }
+
+  fail_if (!wait_for_eos (&ctx));
+  ck_assert_int_eq (ctx.error, OMX_ErrorNone);
+
+  /* Executing -> Idle; the device is stopped, nothing is queued any more */
+  error = OMX_SendCommand (p_hdl, OMX_CommandStateSet, OMX_StateIdle, NULL);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+  fail_if (!wait_for_state (&ctx, OMX_StateIdle));
+  get_delay (p_hdl, &delay);
+  fail_if (delay.nDelay != 0);
+  fail_if (delay.nDelayUs != 0);
+
+  /* Idle -> Loaded */
+  error = OMX_SendCommand (p_hdl, OMX_CommandStateSet, OMX_StateLoaded, NULL);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+  for (i = 0; i < port_def.nBufferCountActual; ++i)
+    {
+      error = OMX_FreeBuffer (p_hdl, ARATELIA_AUDIO_RENDERER_PORT_INDEX,
+                              p_hdrs[i]);
+      ck_assert_int_eq (error, OMX_ErrorNone);
+    }
+  fail_if (!wait_for_state (&ctx, OMX_StateLoaded));
+
+  error = OMX_FreeHandle (p_hdl);
+  ck_assert_int_eq (error, OMX_ErrorNone);
+
+  error = OMX_Deinit ();
+  ck_assert_int_eq (error, OMX_ErrorNone);
+
+  tiz_cond_destroy (&ctx.cond);
+  tiz_mutex_destroy (&ctx.mutex);
+}
+
+/*
+ * Unit tests
+ */
+
+START_TEST (test_arenderer_rw_access)
+{
+  render_pcm (OMX_FALSE);
+}
+END_TEST
+
+START_TEST (test_arenderer_mmap_access)
+{
+  render_pcm (OMX_TRUE);
+}
+END_TEST
+
+Suite *
+arenderer_suite (void)
+{
+  TCase * tc_ar;
+  Suite * s = suite_create ("pcm_renderer_alsa");
+
+  /* test case */
+  tc_ar = tcase_create ("ALSA pcm renderer");
+  tcase_set_timeout (tc_ar, 30);
+  tcase_add_test (tc_ar, test_arenderer_rw_access);
+  tcase_add_test (tc_ar, test_arenderer_mmap_access);
+  suite_add_tcase (s, tc_ar);
+
+  return s;
+}
+
+int
+main (void)
+{
+  int number_failed;
+  SRunner * sr = srunner_create (arenderer_suite ());
+
+  putenv (TIZ_PLATFORM_RC_FILE_ENV);
+
+  tiz_log_init ();
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "Tizonia - ALSA pcm renderer unit tests");
+
+  srunner_run_all (sr, CK_VERBOSE);
+  number_failed = srunner_ntests_failed (sr);
+  srunner_free (sr);
+
+  tiz_log_deinit ();
+
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* Local Variables: */
+/* c-default-style: gnu */
+/* fill-column: 79 */
+/* indent-tabs-mode: nil */
+/* compile-command: "make check" */
+/* End: */
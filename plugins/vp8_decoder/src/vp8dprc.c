@@ -34,8 +34,10 @@
 
 #include <stdlib.h>
 #include <assert.h>
+#include <errno.h>
 #include <limits.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <tizplatform.h>
 
@@ -696,18 +698,64 @@ read_frame (vp8d_prc_t * ap_prc, OMX_BUFFERHEADERTYPE * ap_inhdr)
 }
 
 static void
-out_put (OMX_BUFFERHEADERTYPE * p_hdr, const uint8_t * buf, unsigned int len)
+copy_plane (OMX_BUFFERHEADERTYPE * p_hdr, const uint8_t * ap_src,
+            const int a_src_stride, const unsigned int a_width,
+            const unsigned int a_height)
 {
-  memcpy (p_hdr->pBuffer + p_hdr->nOffset, buf, len);
-  p_hdr->nOffset += len;
+  uint8_t * p_dst = p_hdr->pBuffer + p_hdr->nOffset;
+  const size_t plane_len = (size_t) a_width * a_height;
+
+  if (p_hdr->nOffset + plane_len > p_hdr->nAllocLen)
+    {
+      TIZ_LOG (TIZ_PRIORITY_TRACE,
+               "plane len [%zu] nOffset [%d] nAllocLen [%d]", plane_len,
+               p_hdr->nOffset, p_hdr->nAllocLen);
+      assert (p_hdr->nOffset + plane_len <= p_hdr->nAllocLen);
+      return;
+    }
+
+  if ((unsigned int) a_src_stride == a_width)
+    {
+      memcpy (p_dst, ap_src, plane_len);
+    }
+  else
+    {
+      unsigned int y = 0;
+      for (y = 0; y < a_height; y++)
+        {
+          memcpy (p_dst, ap_src, a_width);
+          p_dst += a_width;
+          ap_src += a_src_stride;
+        }
+    }
+
+  p_hdr->nOffset += plane_len;
   p_hdr->nFilledLen = p_hdr->nOffset;
+}
+
+static unsigned int
+get_decoder_threads (vp8d_prc_t * ap_prc)
+{
+  long threads = TIZ_RCFILE_GET_INT (
+    TIZ_RCFILE_PLUGINS_DATA_SECTION, "OMX.Aratelia.video_decoder.vp8.threads",
+    0);
+
+  assert (ap_prc);
 
-  if (p_hdr->nFilledLen > p_hdr->nAllocLen)
+  if (threads < 0)
     {
-      TIZ_LOG (TIZ_PRIORITY_TRACE, "len [%d] nFilledLen [%d] nAllocLen [%d]",
-               len, p_hdr->nFilledLen, p_hdr->nAllocLen);
-      assert (p_hdr->nFilledLen <= p_hdr->nAllocLen);
+      TIZ_WARN (handleOf (ap_prc), "Ignoring invalid thread count [%ld]",
+                threads);
+      threads = 0;
     }
+
+  if (0 == threads)
+    {
+      /* Auto: one thread per online cpu */
+      threads = sysconf (_SC_NPROCESSORS_ONLN);
+    }
+
+  return (unsigned int) MAX (1, MIN (threads, MAX_DECODER_THREADS));
 }
 
 static OMX_ERRORTYPE
@@ -729,9 +777,6 @@ decode_frame (vp8d_prc_t * ap_prc)
 
   if ((img = vpx_codec_get_frame (&(ap_prc->vp8ctx_), &iter)))
     {
-      unsigned int y;
-      uint8_t * buf = img->planes[VPX_PLANE_Y];
-
 #if 0
         {
             TIZ_DEBUG (handleOf (ap_prc),
@@ -749,27 +794,14 @@ decode_frame (vp8d_prc_t * ap_prc)
         }
 #endif
 
-      for (y = 0; y < img->d_h; y++)
-        {
-          out_put (ap_prc->p_outhdr_, buf, img->d_w);
-          buf += img->stride[VPX_PLANE_Y];
-        }
-
-      buf = img->planes[VPX_PLANE_U];
-
-      for (y = 0; y < (1 + img->d_h) / 2; y++)
-        {
-          out_put (ap_prc->p_outhdr_, buf, (1 + img->d_w) / 2);
-          buf += img->stride[VPX_PLANE_U];
-        }
-
-      buf = img->planes[VPX_PLANE_V];
-
-      for (y = 0; y < (1 + img->d_h) / 2; y++)
-        {
-          out_put (ap_prc->p_outhdr_, buf, (1 + img->d_w) / 2);
-          buf += img->stride[VPX_PLANE_V];
-        }
+      const unsigned int chroma_w = (1 + img->d_w) / 2;
+      const unsigned int chroma_h = (1 + img->d_h) / 2;
+      copy_plane (ap_prc->p_outhdr_, img->planes[VPX_PLANE_Y],
+                  img->stride[VPX_PLANE_Y], img->d_w, img->d_h);
+      copy_plane (ap_prc->p_outhdr_, img->planes[VPX_PLANE_U],
+                  img->stride[VPX_PLANE_U], chroma_w, chroma_h);
+      copy_plane (ap_prc->p_outhdr_, img->planes[VPX_PLANE_V],
+                  img->stride[VPX_PLANE_V], chroma_w, chroma_h);
     }
 
 end:
@@ -917,6 +949,7 @@ vp8d_prc_allocate_resources (void * ap_obj, OMX_U32 a_pid)
 {
   OMX_ERRORTYPE rc = OMX_ErrorNone;
   vp8d_prc_t * ap_prc = ap_obj;
+  vpx_codec_dec_cfg_t cfg;
   int flags = 0;
 
   assert (ap_prc);
@@ -925,9 +958,14 @@ vp8d_prc_allocate_resources (void * ap_obj, OMX_U32 a_pid)
   /*   flags = (postprc ? VPX_CODEC_USE_POSTPRC : 0) | */
   /*     (ec_enabled ? VPX_CODEC_USE_ERROR_CONCEALMENT : 0); */
 
+  /* The frame size is taken from the stream */
+  tiz_mem_set (&cfg, 0, sizeof (cfg));
+  cfg.threads = get_decoder_threads (ap_prc);
+  TIZ_DEBUG (handleOf (ap_prc), "decoder threads [%u]", cfg.threads);
+
   /* Initialize codec */
   bail_on_vpx_err_with_omx_err (
-    vpx_codec_dec_init (&(ap_prc->vp8ctx_), ifaces[0].iface, NULL, flags),
+    vpx_codec_dec_init (&(ap_prc->vp8ctx_), ifaces[0].iface, &cfg, flags),
     OMX_ErrorInsufficientResources);
 
 end:
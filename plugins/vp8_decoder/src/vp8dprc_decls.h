@@ -50,6 +50,7 @@ extern "C"
 
 #define CORRUPT_FRAME_THRESHOLD (256 * 1024 * 1024)
 #define FRAME_TOO_SMALL_THRESHOLD (256 * 1024)
+#define MAX_DECODER_THREADS 8
 
   typedef enum vp8d_stream_type vp8d_stream_type_t;
   enum vp8d_stream_type
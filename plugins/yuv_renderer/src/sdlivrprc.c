@@ -52,6 +52,27 @@
 static OMX_ERRORTYPE
 sdlivr_prc_deallocate_resources (void * ap_obj);
 
+static void
+copy_plane (uint8_t * ap_dst, const int a_dst_pitch, const uint8_t * ap_src,
+            const int a_src_pitch, const int a_width, const int a_height)
+{
+  if (a_dst_pitch == a_src_pitch)
+    {
+      memcpy (ap_dst, ap_src, a_src_pitch * a_height);
+    }
+  else
+    {
+      const int row_len = MIN (a_width, MIN (a_dst_pitch, a_src_pitch));
+      int h = 0;
+      for (h = 0; h < a_height; h++)
+        {
+          memcpy (ap_dst, ap_src, row_len);
+          ap_dst += a_dst_pitch;
+          ap_src += a_src_pitch;
+        }
+    }
+}
+
 static OMX_ERRORTYPE
 sdlivr_prc_render_buffer (const sdlivr_prc_t * ap_prc,
                           OMX_BUFFERHEADERTYPE * p_hdr)
@@ -61,16 +82,15 @@ sdlivr_prc_render_buffer (const sdlivr_prc_t * ap_prc,
   if (ap_prc->p_overlay)
     {
       const OMX_VIDEO_PORTDEFINITIONTYPE * p_vpd = &(ap_prc->port_def_);
-
-      /* AVPicture pict; */
+      SDL_Overlay * p_overlay = ap_prc->p_overlay;
       SDL_Rect rect;
       uint8_t * y;
       uint8_t * u;
       uint8_t * v;
-      unsigned int bytes;
       int pitch0, pitch1;
+      int slice0, slice1;
 
-      if (p_vpd->nStride == 0)
+      if (p_vpd->nStride <= 0)
         {
           /* align pitch on 16-pixel boundary. */
           pitch0 = (p_vpd->nFrameWidth + 15) & ~15;
@@ -81,64 +101,57 @@ sdlivr_prc_render_buffer (const sdlivr_prc_t * ap_prc,
         }
       pitch1 = pitch0 / 2;
 
-      /* hard-coded to be YUV420 plannar */
-      y = p_hdr->pBuffer;
-      u = y + pitch0 * p_vpd->nFrameHeight;
-      v = u + pitch1 * p_vpd->nFrameHeight / 2;
+      /* The planes are nSliceHeight rows apart; the visible area is
+         nFrameHeight rows */
+      slice0 = p_vpd->nSliceHeight >= p_vpd->nFrameHeight
+                 ? p_vpd->nSliceHeight
+                 : p_vpd->nFrameHeight;
+      slice1 = (slice0 + 1) / 2;
 
-      SDL_LockYUVOverlay (ap_prc->p_overlay);
+      /* hard-coded to be YUV420 plannar */
+      y = p_hdr->pBuffer + p_hdr->nOffset;
+      u = y + pitch0 * slice0;
+      v = u + pitch1 * slice1;
 
-      if (ap_prc->p_overlay->pitches[0] != pitch0
-          || ap_prc->p_overlay->pitches[1] != pitch1
-          || ap_prc->p_overlay->pitches[2] != pitch1)
+      if (!p_overlay->hw_overlay && p_overlay->pitches[0] == pitch0
+          && p_overlay->pitches[1] == pitch1
+          && p_overlay->pitches[2] == pitch1)
         {
-          int hh;
-          uint8_t * y2;
-          uint8_t * u2;
-          uint8_t * v2;
-
-          y2 = ap_prc->p_overlay->pixels[0];
-          u2 = ap_prc->p_overlay->pixels[2];
-          v2 = ap_prc->p_overlay->pixels[1];
-
-          for (hh = 0; hh < p_vpd->nFrameHeight; hh++)
-            {
-              memcpy (y2, y, ap_prc->p_overlay->pitches[0]);
-              y2 += ap_prc->p_overlay->pitches[0];
-              y += pitch0;
-            }
-          for (hh = 0; hh < p_vpd->nFrameHeight / 2; hh++)
-            {
-              memcpy (u2, u, ap_prc->p_overlay->pitches[2]);
-              u2 += ap_prc->p_overlay->pitches[2];
-              u += pitch1;
-            }
-          for (hh = 0; hh < p_vpd->nFrameHeight / 2; hh++)
-            {
-              memcpy (v2, v, ap_prc->p_overlay->pitches[1]);
-              v2 += ap_prc->p_overlay->pitches[1];
-              v += pitch1;
-            }
+          /* Software overlays are converted straight from the pixel
+             pointers at display time, so these can point to the OMX buffer
+             for the duration of the call, instead of copying the frame
+             into the overlay's own planes. NOTE: YV12 planes are Y, V, U */
+          Uint8 * planes[3];
+          Uint8 ** pp_overlay_planes = p_overlay->pixels;
+          planes[0] = y;
+          planes[1] = v;
+          planes[2] = u;
+          p_overlay->pixels = planes;
+          rect.x = 0;
+          rect.y = 0;
+          rect.w = p_vpd->nFrameWidth;
+          rect.h = p_vpd->nFrameHeight;
+          SDL_DisplayYUVOverlay (p_overlay, &rect);
+          p_overlay->pixels = pp_overlay_planes;
         }
       else
         {
-          bytes = pitch0 * p_vpd->nFrameHeight;
-          memcpy (ap_prc->p_overlay->pixels[0], y, bytes);
-
-          bytes = pitch1 * p_vpd->nFrameHeight / 2;
-          memcpy (ap_prc->p_overlay->pixels[2], u, bytes);
-
-          bytes = pitch1 * p_vpd->nFrameHeight / 2;
-          memcpy (ap_prc->p_overlay->pixels[1], v, bytes);
+          const int height1 = (p_vpd->nFrameHeight + 1) / 2;
+          SDL_LockYUVOverlay (p_overlay);
+          copy_plane (p_overlay->pixels[0], p_overlay->pitches[0], y, pitch0,
+                      p_vpd->nFrameWidth, p_vpd->nFrameHeight);
+          copy_plane (p_overlay->pixels[2], p_overlay->pitches[2], u, pitch1,
+                      (p_vpd->nFrameWidth + 1) / 2, height1);
+          copy_plane (p_overlay->pixels[1], p_overlay->pitches[1], v, pitch1,
+                      (p_vpd->nFrameWidth + 1) / 2, height1);
+          SDL_UnlockYUVOverlay (p_overlay);
+
+          rect.x = 0;
+          rect.y = 0;
+          rect.w = p_vpd->nFrameWidth;
+          rect.h = p_vpd->nFrameHeight;
+          SDL_DisplayYUVOverlay (p_overlay, &rect);
         }
-
-      SDL_UnlockYUVOverlay (ap_prc->p_overlay);
-
-      rect.x = 0;
-      rect.y = 0;
-      rect.w = p_vpd->nFrameWidth;
-      rect.h = p_vpd->nFrameHeight;
-      SDL_DisplayYUVOverlay (ap_prc->p_overlay, &rect);
     }
 
   p_hdr->nFilledLen = 0;
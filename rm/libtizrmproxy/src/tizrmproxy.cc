@@ -128,6 +128,84 @@ tizrmproxy::acquire (const tiz_rm_t * ap_rm, const uint32_t & rid,
                    quantity);
 }
 
+int32_t
+tizrmproxy::acquire_batch (const tiz_rm_t * const ap_rms[],
+                           const uint32_t a_rids[],
+                           const uint32_t a_quantities[],
+                           const uint32_t a_count, int32_t a_results[])
+{
+  typedef ::Tiz::DBus::Struct< uint32_t, uint32_t, std::string,
+                               std::vector< uint8_t >, uint32_t, uint32_t >
+    request_t;
+  int32_t rc = TIZ_RM_SUCCESS;
+  std::vector< request_t > requests;
+  std::vector< int32_t > retcodes;
+
+  assert (ap_rms);
+  assert (a_rids);
+  assert (a_quantities);
+  assert (a_results);
+
+  requests.reserve (a_count);
+  for (uint32_t i = 0; i < a_count; ++i)
+    {
+      assert (ap_rms[i]);
+      const std::vector< unsigned char > * p_uuid_vec
+        = static_cast< std::vector< unsigned char > * > (*ap_rms[i]);
+      assert (p_uuid_vec);
+      clients_map_t::iterator it = clients_.find (*p_uuid_vec);
+      a_results[i] = TIZ_RM_MISUSE;
+      if (it == clients_.end ())
+        {
+          char uuid_str[128];
+          tiz_uuid_str (&((*p_uuid_vec)[0]), uuid_str);
+          TIZ_LOG (TIZ_PRIORITY_TRACE,
+                   "Could not find the client with uuid [%s]...", uuid_str);
+          return TIZ_RM_MISUSE;
+        }
+      request_t req;
+      req._1 = a_rids[i];
+      req._2 = a_quantities[i];
+      req._3 = it->second.cname_;
+      req._4 = *p_uuid_vec;
+      req._5 = it->second.grp_id_;
+      req._6 = it->second.pri_;
+      requests.push_back (req);
+    }
+
+  try
+    {
+      retcodes = com::aratelia::tiz::tizrmif_proxy::acquire_batch (requests);
+    }
+  catch (Tiz::DBus::Error const & e)
+    {
+      TIZ_LOG (TIZ_PRIORITY_ERROR, "DBus error [%s]...", e.what ());
+      rc = TIZ_RM_DBUS;
+    }
+  catch (std::exception const & e)
+    {
+      TIZ_LOG (TIZ_PRIORITY_ERROR, "Standard exception error [%s]...",
+               e.what ());
+      rc = TIZ_RM_UNKNOWN;
+    }
+  catch (...)
+    {
+      TIZ_LOG (TIZ_PRIORITY_ERROR, "Uknonwn exception error...");
+      rc = TIZ_RM_UNKNOWN;
+    }
+
+  for (uint32_t i = 0; i < a_count && i < retcodes.size (); ++i)
+    {
+      a_results[i] = retcodes[i];
+      if (TIZ_RM_SUCCESS == rc && TIZ_RM_SUCCESS != retcodes[i])
+        {
+          rc = retcodes[i];
+        }
+    }
+
+  return rc;
+}
+
 int32_t
 tizrmproxy::release (const tiz_rm_t * ap_rm, const uint32_t & rid,
                      const uint32_t & quantity)
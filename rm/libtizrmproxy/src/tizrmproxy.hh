@@ -64,6 +64,11 @@ public:
   acquire (const tiz_rm_t * ap_rm, const uint32_t & rid,
            const uint32_t & quantity);
 
+  int32_t
+  acquire_batch (const tiz_rm_t * const ap_rms[], const uint32_t a_rids[],
+                 const uint32_t a_quantities[], const uint32_t a_count,
+                 int32_t a_results[]);
+
   int32_t
   release (const tiz_rm_t * ap_rm, const uint32_t & rid,
            const uint32_t & quantity);
@@ -31,6 +31,8 @@
 
 #include <assert.h>
 
+#include <vector>
+
 #include "tizrmproxy_c.h"
 #include "tizrmproxy.hh"
 #include "tizplatform.h"
@@ -314,6 +316,38 @@ tiz_rm_proxy_acquire (const tiz_rm_t * ap_rm, OMX_U32 a_rid, OMX_U32 a_quantity)
   return (tiz_rm_error_t) p_rm->p_proxy->acquire (ap_rm, a_rid, a_quantity);
 }
 
+extern "C" tiz_rm_error_t
+tiz_rm_proxy_acquire_batch (const tiz_rm_t * const ap_rms[],
+                            const OMX_U32 a_rids[], const OMX_U32 a_quantities[],
+                            OMX_U32 a_count, tiz_rm_error_t a_results[])
+{
+  tiz_rm_int_t * p_rm = NULL;
+  tiz_rm_error_t rc = TIZ_RM_SUCCESS;
+  if (!ap_rms || !a_rids || !a_quantities || !a_results)
+    {
+      return TIZ_RM_MISUSE;
+    }
+
+  if (0 == a_count)
+    {
+      return TIZ_RM_SUCCESS;
+    }
+
+  p_rm = get_rm ();
+  assert (p_rm);
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "tiz_rm_proxy_acquire_batch [%u]", a_count);
+
+  std::vector< int32_t > results (a_count, TIZ_RM_MISUSE);
+  rc = (tiz_rm_error_t) p_rm->p_proxy->acquire_batch (
+    ap_rms, a_rids, a_quantities, a_count, &results[0]);
+  for (OMX_U32 i = 0; i < a_count; ++i)
+    {
+      a_results[i] = (tiz_rm_error_t) results[i];
+    }
+  return rc;
+}
+
 extern "C" tiz_rm_error_t
 tiz_rm_proxy_release (const tiz_rm_t * ap_rm, OMX_U32 a_rid, OMX_U32 a_quantity)
 {
@@ -65,6 +65,14 @@ extern "C"
   tiz_rm_error_t
   tiz_rm_proxy_acquire (const tiz_rm_t * ap_rm, OMX_U32 rid, OMX_U32 quantity);
 
+  /* All-or-nothing acquisition of a_count resources, in one round trip to
+     the daemon. Each request may belong to a different client. */
+  tiz_rm_error_t
+  tiz_rm_proxy_acquire_batch (const tiz_rm_t * const ap_rms[],
+                              const OMX_U32 a_rids[],
+                              const OMX_U32 a_quantities[], OMX_U32 a_count,
+                              tiz_rm_error_t a_results[]);
+
   tiz_rm_error_t
   tiz_rm_proxy_release (const tiz_rm_t * ap_rm, OMX_U32 rid, OMX_U32 quantity);
 
@@ -36,6 +36,7 @@
 #include <assert.h>
 #include <sys/types.h>
 #include <limits.h>
+#include <time.h>
 
 #include "tizplatform.h"
 #include "OMX_Core.h"
@@ -563,6 +564,168 @@ START_TEST (test_proxy_acquire_and_release)
 }
 
 END_TEST
+#define BATCH_TEST_ROUNDS 50
+
+static double
+check_tizrmproxy_elapsed_ms (const struct timespec * ap_start)
+{
+  struct timespec now;
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - ap_start->tv_sec) * 1000.0
+         + (now.tv_nsec - ap_start->tv_nsec) / 1000000.0;
+}
+
+START_TEST (test_proxy_acquire_batch)
+{
+  tiz_rm_error_t error = TIZ_RM_SUCCESS;
+  int rc, daemon_existed = 1;
+  tiz_rm_t p_rm1, p_rm2;
+  pid_t pid;
+  OMX_UUIDTYPE uuid_omx1, uuid_omx2;
+  OMX_PRIORITYMGMTTYPE primgmt;
+  tiz_rm_proxy_callbacks_t cbacks;
+  const tiz_rm_t * rms[2];
+  const OMX_U32 rids[2] = {TIZ_RM_RESOURCE_DUMMY, TIZ_RM_RESOURCE_DUMMY};
+  const OMX_U32 quantities[2] = {1, 1};
+  const OMX_U32 too_much[2] = {1, 2};
+  tiz_rm_error_t results[2];
+  struct timespec start;
+  double seq_ms = 0, batch_ms = 0;
+  int i = 0;
+
+  /* Init RM database */
+  fail_if (!refresh_rm_db ());
+  rc = system ("./updatedb.sh db_acquire_and_release.sql3");
+
+  /* Dump its initial contents */
+  fail_if (!dump_rmdb ("test_proxy_acquire_batch.before.dump"));
+
+  /* Check if an RM daemon is running already */
+  if ((pid = check_tizrmproxy_find_proc ("tizrmd"))
+      || (pid = check_tizrmproxy_find_proc ("lt-tizrmd")))
+    {
+      TIZ_LOG (TIZ_PRIORITY_TRACE, "RM Process [PID %d] FOUND", pid);
+    }
+
+  if (-1 == pid)
+    {
+      /* Start the rm daemon */
+      pid = fork ();
+      fail_if (pid == -1);
+      daemon_existed = 0;
+    }
+
+  if (pid)
+    {
+
+      sleep (1);
+
+      /* Generate the uuids */
+      tiz_uuid_generate (&uuid_omx1);
+      tiz_uuid_generate (&uuid_omx2);
+
+      primgmt.nSize = sizeof (OMX_PRIORITYMGMTTYPE);
+      primgmt.nVersion.nVersion = OMX_VERSION;
+      primgmt.nGroupPriority = COMPONENT1_PRIORITY;
+      primgmt.nGroupID = COMPONENT1_GROUP_ID;
+
+      cbacks.pf_waitend = &check_tizrmproxy_comp1_wait_complete;
+      cbacks.pf_preempt = &check_tizrmproxy_comp1_preemption_req;
+      cbacks.pf_preempt_end = &check_tizrmproxy_comp1_preemption_complete;
+
+      error = tiz_rm_proxy_init (&p_rm1, COMPONENT1_NAME,
+                                 (const OMX_UUIDTYPE *) &uuid_omx1, &primgmt,
+                                 &cbacks, NULL);
+      fail_if (error != TIZ_RM_SUCCESS);
+
+      error = tiz_rm_proxy_init (&p_rm2, COMPONENT2_NAME,
+                                 (const OMX_UUIDTYPE *) &uuid_omx2, &primgmt,
+                                 &cbacks, NULL);
+      fail_if (error != TIZ_RM_SUCCESS);
+
+      rms[0] = &p_rm1;
+      rms[1] = &p_rm2;
+
+      /* Both components are provisioned with 1 unit of the resource: the
+         second request exceeds that, and the whole batch must be undone */
+      error = tiz_rm_proxy_acquire_batch (rms, rids, too_much, 2, results);
+      TIZ_LOG (TIZ_PRIORITY_TRACE,
+               "tiz_rm_proxy_acquire_batch returned [%d] - [%d] [%d]", error,
+               results[0], results[1]);
+      fail_if (error != TIZ_RM_NOT_ENOUGH_RESOURCE_PROVISIONED);
+      fail_if (results[1] != TIZ_RM_NOT_ENOUGH_RESOURCE_PROVISIONED);
+      error = tiz_rm_proxy_release (&p_rm1, TIZ_RM_RESOURCE_DUMMY, 1);
+      fail_if (error != TIZ_RM_NOT_ENOUGH_RESOURCE_ACQUIRED);
+
+      /* One round trip per acquisition... */
+      clock_gettime (CLOCK_MONOTONIC, &start);
+      for (i = 0; i < BATCH_TEST_ROUNDS; ++i)
+        {
+          error = tiz_rm_proxy_acquire (&p_rm1, TIZ_RM_RESOURCE_DUMMY, 1);
+          fail_if (error != TIZ_RM_SUCCESS);
+          error = tiz_rm_proxy_acquire (&p_rm2, TIZ_RM_RESOURCE_DUMMY, 1);
+          fail_if (error != TIZ_RM_SUCCESS);
+          error = tiz_rm_proxy_release (&p_rm1, TIZ_RM_RESOURCE_DUMMY, 1);
+          fail_if (error != TIZ_RM_SUCCESS);
+          error = tiz_rm_proxy_release (&p_rm2, TIZ_RM_RESOURCE_DUMMY, 1);
+          fail_if (error != TIZ_RM_SUCCESS);
+        }
+      seq_ms = check_tizrmproxy_elapsed_ms (&start);
+
+      /* ... vs one round trip for both */
+      clock_gettime (CLOCK_MONOTONIC, &start);
+      for (i = 0; i < BATCH_TEST_ROUNDS; ++i)
+        {
+          error = tiz_rm_proxy_acquire_batch (rms, rids, quantities, 2,
+                                              results);
+          fail_if (error != TIZ_RM_SUCCESS);
+          fail_if (results[0] != TIZ_RM_SUCCESS);
+          fail_if (results[1] != TIZ_RM_SUCCESS);
+          error = tiz_rm_proxy_release (&p_rm1, TIZ_RM_RESOURCE_DUMMY, 1);
+          fail_if (error != TIZ_RM_SUCCESS);
+          error = tiz_rm_proxy_release (&p_rm2, TIZ_RM_RESOURCE_DUMMY, 1);
+          fail_if (error != TIZ_RM_SUCCESS);
+        }
+      batch_ms = check_tizrmproxy_elapsed_ms (&start);
+
+      TIZ_LOG (TIZ_PRIORITY_NOTICE,
+               "[%d] rounds : sequential acquire [%.2f ms] - "
+               "batched acquire [%.2f ms]",
+               BATCH_TEST_ROUNDS, seq_ms, batch_ms);
+
+      error = tiz_rm_proxy_destroy (&p_rm1);
+      fail_if (error != TIZ_RM_SUCCESS);
+      error = tiz_rm_proxy_destroy (&p_rm2);
+      fail_if (error != TIZ_RM_SUCCESS);
+
+      if (!daemon_existed)
+        {
+          error = kill (pid, SIGTERM);
+          fail_if (error == -1);
+        }
+
+      /* Check db */
+      fail_if (!dump_rmdb ("test_proxy_acquire_batch.after.dump"));
+
+      rc = system (
+        "cmp -s /tmp/test_proxy_acquire_batch.before.dump "
+        "/tmp/test_proxy_acquire_batch.after.dump");
+
+      TIZ_LOG (TIZ_PRIORITY_TRACE, "DB comparison check [%s]",
+               (rc == 0 ? "SUCCESS" : "FAILED"));
+      fail_if (rc != 0);
+    }
+  else
+    {
+      TIZ_LOG (TIZ_PRIORITY_TRACE, "Starting the RM Daemon");
+      const char * arg0 = "";
+      error = execlp (pg_rmd_path, arg0, (char *) NULL);
+      fail_if (error == -1);
+    }
+}
+
+END_TEST
+
 START_TEST (test_proxy_acquire_and_destroy_no_release)
 {
   tiz_rm_error_t error = TIZ_RM_SUCCESS;
@@ -1129,6 +1292,7 @@ rmproxy_suite (void)
   tcase_add_unchecked_fixture (tc_proxy, setup, teardown);
   tcase_set_timeout (tc_proxy, RMPROXY_TEST_TIMEOUT);
   tcase_add_test (tc_proxy, test_proxy_acquire_and_release);
+  tcase_add_test (tc_proxy, test_proxy_acquire_batch);
   tcase_add_test (tc_proxy, test_proxy_acquire_and_destroy_no_release);
   tcase_add_test (tc_proxy, test_proxy_wait_cancel_wait);
   tcase_add_test (tc_proxy, test_proxy_busy_resource_management);
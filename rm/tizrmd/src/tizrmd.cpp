@@ -53,6 +53,26 @@ static const char *TIZ_RM_DAEMON_NAME = "com.aratelia.tiz.tizrmd";
 // Object path, a.k.a. node
 static const char *TIZ_RM_DAEMON_PATH = "/com/aratelia/tiz/tizrmd";
 
+namespace
+{
+  // Writes the db modifications made while handling a request to disk before
+  // the reply is sent back to the client
+  class rmdb_flusher
+  {
+  public:
+    explicit rmdb_flusher (tizrmdb &a_rmdb) : rmdb_ (a_rmdb)
+    {
+    }
+    ~rmdb_flusher ()
+    {
+      (void)rmdb_.flush ();
+    }
+
+  private:
+    tizrmdb &rmdb_;
+  };
+}
+
 tizrmd::tizrmd (Tiz::DBus::Connection &a_connection, char const *ap_dbname)
   : Tiz::DBus::ObjectAdaptor (a_connection, TIZ_RM_DAEMON_PATH),
     rmdb_ (ap_dbname),
@@ -73,6 +93,7 @@ int32_t tizrmd::acquire (const uint32_t &rid, const uint32_t &quantity,
                          const uint32_t &grpid, const uint32_t &pri)
 {
   tiz_rm_error_t rc = TIZ_RM_SUCCESS;
+  rmdb_flusher flusher (rmdb_);
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "tizrmd::acquire : '%s': acquiring rid [%d] -"
            "quantity [%d] - grpid [%d] - pri [%d]...",
@@ -170,12 +191,58 @@ int32_t tizrmd::acquire (const uint32_t &rid, const uint32_t &quantity,
   return rc;
 }
 
+std::vector< int32_t > tizrmd::acquire_batch (
+    const std::vector< ::Tiz::DBus::Struct< uint32_t, uint32_t, std::string,
+                                            std::vector< uint8_t >, uint32_t,
+                                            uint32_t > > &requests)
+{
+  std::vector< int32_t > retcodes (requests.size (), TIZ_RM_MISUSE);
+  rmdb_flusher flusher (rmdb_);
+  size_t i = 0;
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE, "tizrmd::acquire_batch : [%d] requests",
+           requests.size ());
+
+  for (i = 0; i < requests.size (); ++i)
+  {
+    const ::Tiz::DBus::Struct< uint32_t, uint32_t, std::string,
+                               std::vector< uint8_t >, uint32_t, uint32_t >
+        &req = requests[i];
+    retcodes[i] = rmdb_.acquire_resource (req._1, req._2, req._3, req._4,
+                                          req._5, req._6);
+    if (TIZ_RM_SUCCESS != retcodes[i])
+    {
+      TIZ_LOG (TIZ_PRIORITY_TRACE,
+               "tizrmd::acquire_batch : '%s': "
+               "Could not reserve [%d] units of resource [%d] - rc [%d]",
+               req._3.c_str (), req._2, req._1, retcodes[i]);
+      break;
+    }
+  }
+
+  if (i < requests.size ())
+  {
+    // Undo the partial batch
+    while (i-- > 0)
+    {
+      const ::Tiz::DBus::Struct< uint32_t, uint32_t, std::string,
+                                 std::vector< uint8_t >, uint32_t, uint32_t >
+          &req = requests[i];
+      (void)rmdb_.release_resource (req._1, req._2, req._3, req._4, req._5,
+                                    req._6);
+    }
+  }
+
+  return retcodes;
+}
+
 int32_t tizrmd::release (const uint32_t &rid, const uint32_t &quantity,
                          const std::string &cname,
                          const std::vector< uint8_t > &uuid,
                          const uint32_t &grpid, const uint32_t &pri)
 {
   tiz_rm_error_t ret_val = TIZ_RM_SUCCESS;
+  rmdb_flusher flusher (rmdb_);
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "tizrmd::release : '%s': releasing rid [%d] - "
            "quantity [%d]",
@@ -234,6 +301,7 @@ int32_t tizrmd::wait (const uint32_t &rid, const uint32_t &quantity,
                       const uint32_t &pri)
 {
   tiz_rm_error_t ret_val = TIZ_RM_SUCCESS;
+  rmdb_flusher flusher (rmdb_);
 
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "'%s': waiting for rid [%d] - "
@@ -339,6 +407,7 @@ int32_t tizrmd::preemption_conf (const uint32_t &rid, const uint32_t &quantity,
                                  const uint32_t &grpid, const uint32_t &pri)
 {
   tiz_rm_error_t ret_val = TIZ_RM_SUCCESS;
+  rmdb_flusher flusher (rmdb_);
   preemptlist_t::iterator it
       = preemptions_.find (tizrmowner (cname, uuid, grpid, pri, rid, quantity));
 
@@ -416,6 +485,7 @@ int32_t tizrmd::relinquish_all (const std::string &cname,
                                 const std::vector< unsigned char > &uuid)
 {
   tiz_rm_error_t ret_val = TIZ_RM_SUCCESS;
+  rmdb_flusher flusher (rmdb_);
 
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "tizrmd::relinquish_all: '%s' : "
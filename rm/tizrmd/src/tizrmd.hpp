@@ -79,6 +79,22 @@ public:
                    const std::string &cname, const std::vector< uint8_t > &uuid,
                    const uint32_t &grpid, const uint32_t &pri);
 
+  /**
+   * \brief Acquire several resources, possibly on behalf of several
+   * components, in one call. The batch is all-or-nothing: if any of the
+   * requests fails, the resources acquired for the preceding ones are
+   * released. No preemption takes place in this path.
+   *
+   * @param requests A list of (rid, quantity, cname, uuid, grpid, pri) tuples
+   *
+   * @return A list of tiz_rm_error_t error codes, one per request. Requests
+   * that were not attempted are reported as TIZ_RM_MISUSE.
+   */
+  std::vector< int32_t > acquire_batch (const std::vector< ::Tiz::DBus::Struct<
+                                            uint32_t, uint32_t, std::string,
+                                            std::vector< uint8_t >, uint32_t,
+                                            uint32_t > > &requests);
+
   /**
    * \brief RM API for OMX_StateIdle to OMX_StateLoaded transitions where RM is
    * present
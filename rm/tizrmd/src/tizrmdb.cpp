@@ -33,8 +33,7 @@
 #include <sqlite3.h>
 #include <stdlib.h>
 
-#include <iostream>
-#include <sstream>
+#include <algorithm>
 #include <vector>
 
 #include <tizplatform.h>
@@ -52,16 +51,47 @@ static const char *TIZ_RM_DB_CREATE_ALLOC_TABLE
     = "create table allocation(cname varchar(255), uuid varchar(16), grpid "
       "smallint, pri smallint, resid smallint, allocation mediumint)";
 
-// static const char *TIZ_RM_DB_RESNAMES_FROM_RESOURCES
-//     = "select resname from resources";
-// static const char *TIZ_RM_DB_RESIDS_FROM_RESOURCES
-//     = "select resid from resources";
+static const char *TIZ_RM_DB_SELECT_RESOURCES
+    = "select resid, initial, current from resources";
 
-static const char *TIZ_RM_DB_CNAMES_FROM_COMPONENTS
-    = "select cname from components";
+static const char *TIZ_RM_DB_SELECT_COMPONENTS
+    = "select cname, resid, requirement from components";
 
-tizrmdb::tizrmdb (char const *ap_dbname) : pdb_ (0), dbname_ (ap_dbname)
+// Cached statements, indexed by tizrmdb::stmt_id
+static const char *TIZ_RM_DB_STMTS[] = {
+  "begin immediate transaction",
+  "commit transaction",
+  "rollback transaction",
+  "update resources set current=?1 where resid=?2",
+  "delete from allocation where uuid=?1 and resid=?2",
+  "insert into allocation (cname, uuid, grpid, pri, resid, allocation) "
+  "values(?1, ?2, ?3, ?4, ?5, ?6)"
+};
+
+namespace
 {
+  struct by_seq
+  {
+    bool operator() (const std::pair< unsigned long, tizrmowner > &lhs,
+                     const std::pair< unsigned long, tizrmowner > &rhs) const
+    {
+      return lhs.first < rhs.first;
+    }
+  };
+}
+
+tizrmdb::tizrmdb (char const *ap_dbname)
+  : pdb_ (0),
+    dbname_ (ap_dbname),
+    resources_ (),
+    provisions_ (),
+    comps_ (),
+    allocations_ (),
+    alloc_seq_ (0),
+    dirty_resources_ (),
+    dirty_allocations_ ()
+{
+  std::fill (stmts_, stmts_ + EStmtMax, static_cast< sqlite3_stmt * > (0));
 }
 
 tizrmdb::~tizrmdb ()
@@ -84,11 +114,12 @@ tiz_rm_error_t tizrmdb::connect ()
     }
     else
     {
-      rc = reset_alloc_table ();
-      if (rc != SQLITE_OK)
+      if (SQLITE_OK != (rc = reset_alloc_table ())
+          || SQLITE_OK != (rc = prepare_statements ())
+          || SQLITE_OK != (rc = load_tables ()))
       {
-        TIZ_LOG (TIZ_PRIORITY_TRACE, "Could not init db [%s]",
-                 dbname_.c_str ());
+        TIZ_LOG (TIZ_PRIORITY_TRACE, "Could not init db [%s] - [%s]",
+                 dbname_.c_str (), sqlite_error_str (rc).c_str ());
         ret_val = TIZ_RM_DATABASE_INIT_ERROR;
       }
     }
@@ -105,7 +136,10 @@ tiz_rm_error_t tizrmdb::connect ()
 tiz_rm_error_t tizrmdb::disconnect ()
 {
   tiz_rm_error_t ret_val = TIZ_RM_SUCCESS;
-  int rc = close ();
+  int rc = SQLITE_OK;
+
+  (void)flush ();
+  rc = close ();
 
   if (SQLITE_OK != rc)
   {
@@ -128,6 +162,7 @@ int tizrmdb::close ()
   int rc = SQLITE_OK;
   if (pdb_)
   {
+    finalize_statements ();
     rc = sqlite3_close (pdb_);
     pdb_ = 0;
     dbname_.clear ();
@@ -150,6 +185,7 @@ int tizrmdb::reset_alloc_table ()
     {
       TIZ_LOG (TIZ_PRIORITY_TRACE, "Could not drop allocation table [%s]",
                p_errmsg);
+      sqlite3_free (p_errmsg);
     }
 
     rc = sqlite3_exec (pdb_, TIZ_RM_DB_CREATE_ALLOC_TABLE, NULL, NULL,
@@ -158,33 +194,219 @@ int tizrmdb::reset_alloc_table ()
     {
       TIZ_LOG (TIZ_PRIORITY_TRACE, "Could not create allocation table [%s]",
                p_errmsg);
+      sqlite3_free (p_errmsg);
       return rc;
     }
     TIZ_LOG (TIZ_PRIORITY_TRACE, "Created allocation table succesfully");
   }
 
+  allocations_.clear ();
+  dirty_allocations_.clear ();
+
   return rc;
 }
 
+int tizrmdb::prepare_statements ()
+{
+  int rc = SQLITE_OK;
+  assert (pdb_);
+
+  for (int i = 0; i < EStmtMax && SQLITE_OK == rc; ++i)
+  {
+    rc = sqlite3_prepare_v2 (pdb_, TIZ_RM_DB_STMTS[i], -1, &stmts_[i], NULL);
+    if (SQLITE_OK != rc)
+    {
+      TIZ_LOG (TIZ_PRIORITY_TRACE, "Could not prepare [%s] - [%s]",
+               TIZ_RM_DB_STMTS[i], sqlite3_errmsg (pdb_));
+    }
+  }
+
+  return rc;
+}
+
+void tizrmdb::finalize_statements ()
+{
+  for (int i = 0; i < EStmtMax; ++i)
+  {
+    sqlite3_finalize (stmts_[i]);
+    stmts_[i] = 0;
+  }
+}
+
+int tizrmdb::load_tables ()
+{
+  sqlite3_stmt *p_stmt = NULL;
+  int rc = SQLITE_OK;
+
+  assert (pdb_);
+
+  resources_.clear ();
+  provisions_.clear ();
+  comps_.clear ();
+  dirty_resources_.clear ();
+
+  rc = sqlite3_prepare_v2 (pdb_, TIZ_RM_DB_SELECT_RESOURCES, -1, &p_stmt, NULL);
+  while (SQLITE_OK == rc && SQLITE_ROW == (rc = sqlite3_step (p_stmt)))
+  {
+    resource &res = resources_[sqlite3_column_int (p_stmt, 0)];
+    res.initial_ = sqlite3_column_int (p_stmt, 1);
+    res.current_ = sqlite3_column_int (p_stmt, 2);
+    rc = SQLITE_OK;
+  }
+  sqlite3_finalize (p_stmt);
+  p_stmt = NULL;
+
+  if (SQLITE_DONE == rc)
+  {
+    rc = sqlite3_prepare_v2 (pdb_, TIZ_RM_DB_SELECT_COMPONENTS, -1, &p_stmt,
+                             NULL);
+    while (SQLITE_OK == rc && SQLITE_ROW == (rc = sqlite3_step (p_stmt)))
+    {
+      const char *p_cname = (const char *)sqlite3_column_text (p_stmt, 0);
+      if (p_cname)
+      {
+        // As with the old per-query lookups, the last row provisioned for a
+        // component and resource wins
+        comps_.insert (p_cname);
+        provisions_[std::make_pair (std::string (p_cname),
+                                    (unsigned int)sqlite3_column_int (p_stmt,
+                                                                      1))]
+            = sqlite3_column_int (p_stmt, 2);
+      }
+      rc = SQLITE_OK;
+    }
+    sqlite3_finalize (p_stmt);
+  }
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE,
+           "Loaded [%d] resources and [%d] component provisions - rc [%s]",
+           resources_.size (), provisions_.size (),
+           sqlite_error_str (rc).c_str ());
+
+  return (SQLITE_DONE == rc ? SQLITE_OK : rc);
+}
+
+int tizrmdb::run_stmt (const stmt_id id)
+{
+  int rc = SQLITE_OK;
+  assert (id < EStmtMax);
+  assert (stmts_[id]);
+
+  rc = sqlite3_step (stmts_[id]);
+  sqlite3_reset (stmts_[id]);
+  sqlite3_clear_bindings (stmts_[id]);
+
+  if (SQLITE_DONE != rc)
+  {
+    TIZ_LOG (TIZ_PRIORITY_TRACE, "Statement [%s] failed - [%s]",
+             TIZ_RM_DB_STMTS[id], sqlite_error_str (rc).c_str ());
+    return rc;
+  }
+
+  return SQLITE_OK;
+}
+
+int tizrmdb::write_allocation (const alloc_key_t &key)
+{
+  int rc = SQLITE_OK;
+  char uuid_str[129];
+  allocations_map_t::const_iterator it = allocations_.find (key);
+
+  tiz_uuid_str (&(key.first[0]), uuid_str);
+
+  sqlite3_bind_text (stmts_[EStmtDeleteAllocation], 1, uuid_str, -1,
+                     SQLITE_TRANSIENT);
+  sqlite3_bind_int (stmts_[EStmtDeleteAllocation], 2, key.second);
+  rc = run_stmt (EStmtDeleteAllocation);
+
+  if (SQLITE_OK == rc && it != allocations_.end ())
+  {
+    const allocation &alloc = it->second;
+    sqlite3_stmt *p_stmt = stmts_[EStmtInsertAllocation];
+    sqlite3_bind_text (p_stmt, 1, alloc.cname_.c_str (), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text (p_stmt, 2, uuid_str, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int (p_stmt, 3, alloc.grpid_);
+    sqlite3_bind_int (p_stmt, 4, alloc.pri_);
+    sqlite3_bind_int (p_stmt, 5, key.second);
+    sqlite3_bind_int (p_stmt, 6, alloc.quantity_);
+    rc = run_stmt (EStmtInsertAllocation);
+  }
+
+  return rc;
+}
+
+tiz_rm_error_t tizrmdb::flush ()
+{
+  int rc = SQLITE_OK;
+
+  if (!pdb_ || (dirty_resources_.empty () && dirty_allocations_.empty ()))
+  {
+    return TIZ_RM_SUCCESS;
+  }
+
+  TIZ_LOG (TIZ_PRIORITY_TRACE,
+           "Flushing [%d] resources and [%d] allocations to the db",
+           dirty_resources_.size (), dirty_allocations_.size ());
+
+  rc = run_stmt (EStmtBegin);
+
+  for (std::set< unsigned int >::const_iterator it = dirty_resources_.begin ();
+       SQLITE_OK == rc && it != dirty_resources_.end (); ++it)
+  {
+    sqlite3_bind_int (stmts_[EStmtUpdateCurrent], 1,
+                      resources_[*it].current_);
+    sqlite3_bind_int (stmts_[EStmtUpdateCurrent], 2, *it);
+    rc = run_stmt (EStmtUpdateCurrent);
+  }
+
+  // Allocations are written in the order they were made, so that the table
+  // looks the same as if each request had been written through
+  std::vector< std::pair< unsigned long, alloc_key_t > > keys;
+  for (std::set< alloc_key_t >::const_iterator it = dirty_allocations_.begin ();
+       it != dirty_allocations_.end (); ++it)
+  {
+    allocations_map_t::const_iterator alloc_it = allocations_.find (*it);
+    keys.push_back (std::make_pair (
+        alloc_it != allocations_.end () ? alloc_it->second.seq_ : 0, *it));
+  }
+  std::sort (keys.begin (), keys.end ());
+
+  for (size_t i = 0; SQLITE_OK == rc && i < keys.size (); ++i)
+  {
+    rc = write_allocation (keys[i].second);
+  }
+
+  if (SQLITE_OK == rc)
+  {
+    rc = run_stmt (EStmtCommit);
+  }
+
+  if (SQLITE_OK != rc)
+  {
+    TIZ_LOG (TIZ_PRIORITY_ERROR, "Could not flush the rm db - [%s]",
+             sqlite_error_str (rc).c_str ());
+    (void)run_stmt (EStmtRollback);
+    // Keep the dirty sets; the write will be retried on the next flush
+    return TIZ_RM_DATABASE_ACCESS_ERROR;
+  }
+
+  dirty_resources_.clear ();
+  dirty_allocations_.clear ();
+  return TIZ_RM_SUCCESS;
+}
+
 bool tizrmdb::resource_available (const unsigned int &rid,
                                   const unsigned int &quantity) const
 {
   bool ret_val = false;
-  int rc = SQLITE_OK;
-  char query[255];
+  resources_map_t::const_iterator it = resources_.find (rid);
 
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "tizrmdb::resource_available : Checking resource "
            " availability for resid [%d] - quantity [%d]",
            rid, quantity);
 
-  snprintf (query, sizeof (query),
-            "select * from resources where resid='%d' and current>='%d'", rid,
-            quantity);
-
-  rc = run_query (query);
-
-  if (SQLITE_OK == rc && !vdata_.empty ())
+  if (it != resources_.end () && it->second.current_ >= (int)quantity)
   {
     TIZ_LOG (TIZ_PRIORITY_TRACE,
              "tizrmdb::resource_available : "
@@ -198,21 +420,7 @@ bool tizrmdb::resource_available (const unsigned int &rid,
 
 bool tizrmdb::resource_provisioned (const unsigned int &rid) const
 {
-  bool ret_val = false;
-  int rc = SQLITE_OK;
-  char query[255];
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE, "tizrmdb::resource_provisioned");
-
-  snprintf (query, sizeof (query), "select * from resources where resid='%d'",
-            rid);
-
-  rc = run_query (query);
-
-  if (SQLITE_OK == rc && !vdata_.empty ())
-  {
-    ret_val = true;
-  }
+  const bool ret_val = (resources_.find (rid) != resources_.end ());
 
   TIZ_LOG (TIZ_PRIORITY_TRACE, "Resource id [%d] is [%s]", rid,
            (ret_val == true ? "PROVISIONED" : "NOT PROVISIONED"));
@@ -225,60 +433,26 @@ bool tizrmdb::resource_acquired (const std::vector< unsigned char > &uuid,
                                  const unsigned int &quantity) const
 {
   bool ret_val = false;
-  int rc = SQLITE_OK;
-  char query[255];
-  char uuid_str[129];
-
-  tiz_uuid_str (&uuid[0], uuid_str);
+  allocations_map_t::const_iterator it
+      = allocations_.find (std::make_pair (uuid, rid));
 
-  TIZ_LOG (TIZ_PRIORITY_TRACE,
-           "tizrmdb::resource_acquired : uuid [%s] - "
-           "rid [%d] - quantity [%d]",
-           uuid_str, rid, quantity);
-
-  snprintf (query, sizeof (query),
-            "select * from allocation where uuid='%s' and resid='%d' "
-            "and allocation>='%d'",
-            uuid_str, rid, quantity);
-
-  rc = run_query (query);
-
-  if (SQLITE_OK == rc && !vdata_.empty ())
+  if (it != allocations_.end () && it->second.quantity_ >= quantity)
   {
     ret_val = true;
   }
 
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "tizrmdb::resource_acquired : "
-           "'%s' : allocated [%s] units "
+           "allocated [%s] units "
            "of resource id [%d] (at least [%d] units were expected)",
-           uuid_str, (true == ret_val ? "ENOUGH" : "NOT ENOUGH"), rid,
-           quantity);
+           (true == ret_val ? "ENOUGH" : "NOT ENOUGH"), rid, quantity);
 
   return ret_val;
 }
 
 bool tizrmdb::comp_provisioned (const std::string &cname) const
 {
-  bool ret_val = false;
-  int rc = SQLITE_OK;
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE, "tizrmdb::comp_provisioned : Checking [%s]",
-           cname.c_str ());
-
-  rc = run_query (TIZ_RM_DB_CNAMES_FROM_COMPONENTS);
-
-  if (SQLITE_OK == rc)
-  {
-    for (std::vector< std::string >::iterator it = vdata_.begin ();
-         it < vdata_.end (); ++it)
-    {
-      if (cname.compare (*it) == 0)
-      {
-        ret_val = true;
-      }
-    }
-  }
+  const bool ret_val = (comps_.find (cname) != comps_.end ());
 
   TIZ_LOG (TIZ_PRIORITY_TRACE, "'%s' is [%s]", cname.c_str (),
            (true == ret_val ? "PROVISIONED" : "NOT PROVISIONED"));
@@ -289,26 +463,8 @@ bool tizrmdb::comp_provisioned (const std::string &cname) const
 bool tizrmdb::comp_provisioned_with_resid (const std::string &cname,
                                            const unsigned int &rid) const
 {
-  bool ret_val = false;
-  int rc = SQLITE_OK;
-  char query[255];
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE,
-           "tizrmdb::comp_provisioned_with_resid : "
-           "'%s' : Checking component provisioning for "
-           "resource id [%d]",
-           cname.c_str (), rid);
-
-  snprintf (query, sizeof (query),
-            "select * from components where cname='%s' and resid=%d",
-            cname.c_str (), rid);
-
-  rc = run_query (query);
-
-  if (SQLITE_OK == rc && !vdata_.empty ())
-  {
-    ret_val = true;
-  }
+  const bool ret_val
+      = (provisions_.find (std::make_pair (cname, rid)) != provisions_.end ());
 
   TIZ_LOG (TIZ_PRIORITY_TRACE, "'%s' : is [%s] with resource id [%d]",
            cname.c_str (),
@@ -322,23 +478,18 @@ tiz_rm_error_t tizrmdb::acquire_resource (
     const std::string &cname, const std::vector< unsigned char > &uuid,
     const unsigned int &grpid, const unsigned int &pri)
 {
-  int rc = SQLITE_OK;
-  char query[500];
-  char uuid_str[129];
-  int current = 0;
-  int requirement = 0;
-
-  tiz_uuid_str (&uuid[0], uuid_str);
+  provisions_map_t::const_iterator prov_it
+      = provisions_.find (std::make_pair (cname, rid));
+  resources_map_t::iterator res_it = resources_.find (rid);
 
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "tizrmdb::acquire_resource : "
-           "'%s': Acquiring [%d] units of resource [%d] "
-           "uuid [%s]",
-           cname.c_str (), quantity, rid, uuid_str);
+           "'%s': Acquiring [%d] units of resource [%d]",
+           cname.c_str (), quantity, rid);
 
   // Check that the component is provisioned and is allowed access to the
   // resource
-  if (!comp_provisioned_with_resid (cname, rid))
+  if (prov_it == provisions_.end ())
   {
     TIZ_LOG (TIZ_PRIORITY_TRACE,
              "tizrmdb::acquire_resource : "
@@ -347,28 +498,18 @@ tiz_rm_error_t tizrmdb::acquire_resource (
     return TIZ_RM_COMPONENT_NOT_PROVISIONED;
   }
 
-  requirement = strtol (vdata_[vdata_.size () - 1].c_str (), NULL, 0);
-  // TODO: Replace this with proper error check
-  assert (requirement >= 0);
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE,
-           "tizrmdb::acquire_resource : "
-           "[%s]: provisioned requirement [%d] units, "
-           "actually requested [%d] ...",
-           cname.c_str (), requirement, quantity);
-
-  if (quantity > (unsigned int)requirement)
+  if (quantity > prov_it->second)
   {
     TIZ_LOG (TIZ_PRIORITY_TRACE,
              "tizrmdb::acquire_resource : "
              "[%s]: requested [%d] units, but provisioned "
              "only [%d]",
-             cname.c_str (), quantity, requirement);
+             cname.c_str (), quantity, prov_it->second);
     return TIZ_RM_NOT_ENOUGH_RESOURCE_PROVISIONED;
   }
 
   // Check that the requested resource is provisioned and there is availability
-  if (!resource_available (rid, quantity))
+  if (res_it == resources_.end () || res_it->second.current_ < (int)quantity)
   {
     TIZ_LOG (TIZ_PRIORITY_TRACE,
              "tizrmdb::acquire_resource : "
@@ -377,50 +518,23 @@ tiz_rm_error_t tizrmdb::acquire_resource (
     return TIZ_RM_NOT_ENOUGH_RESOURCE_AVAILABLE;
   }
 
-  current = strtol (vdata_[vdata_.size () - 1].c_str (), NULL, 0);
+  // Both tables are updated together, or not at all
+  const alloc_key_t key (uuid, rid);
+  allocation &alloc = allocations_[key];
+  alloc.cname_ = cname;
+  alloc.grpid_ = grpid;
+  alloc.pri_ = pri;
+  // One record per component and resource; repeated acquisitions add up
+  alloc.quantity_ += quantity;
+  alloc.seq_ = ++alloc_seq_;
+  res_it->second.current_ -= quantity;
+  dirty_allocations_.insert (key);
+  dirty_resources_.insert (rid);
 
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "tizrmdb::acquire_resource: "
-           "Resource [%d]: available [%d] units ...",
-           rid, current);
-
-  snprintf (query, sizeof (query),
-            "insert or replace into allocation (cname, uuid, grpid, "
-            "pri, resid, allocation) "
-            "values('%s', '%s', %d, %d, %d, %d)",
-            cname.c_str (), uuid_str, grpid, pri, rid, quantity);
-
-  rc = run_query (query);
-
-  if (SQLITE_OK != rc)
-  {
-    TIZ_LOG (TIZ_PRIORITY_TRACE,
-             "tizrmdb::acquire_resource : "
-             "'%s' : Could not update allocation table",
-             cname.c_str ());
-    return TIZ_RM_DATABASE_ERROR;
-  }
-
-  snprintf (query, sizeof (query),
-            "update resources set current=%d where resid=%d",
-            current - quantity, rid);
-
-  rc = run_query (query);
-
-  if (SQLITE_OK != rc)
-  {
-    TIZ_LOG (TIZ_PRIORITY_TRACE,
-             "tizrmdb::acquire_resource : "
-             "Could not update resource table "
-             "for resource [%s]",
-             rid);
-    return TIZ_RM_DATABASE_ERROR;
-  }
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE,
-           "tizrmdb::acquire_resource: "
-           "Succesfully acquired resource [%d] for [%s]",
-           rid, cname.c_str ());
+           "Succesfully acquired resource [%d] for [%s] - available [%d]",
+           rid, cname.c_str (), res_it->second.current_);
 
   return TIZ_RM_SUCCESS;
 }
@@ -430,11 +544,11 @@ tiz_rm_error_t tizrmdb::release_resource (
     const std::string &cname, const std::vector< unsigned char > &uuid,
     const unsigned int &grpid, const unsigned int &pri)
 {
-  int rc = SQLITE_OK;
-  char query[500];
-  char uuid_str[129];
-  int current = 0;
-  int requirement = 0;
+  provisions_map_t::const_iterator prov_it
+      = provisions_.find (std::make_pair (cname, rid));
+  resources_map_t::iterator res_it = resources_.find (rid);
+  const alloc_key_t key (uuid, rid);
+  allocations_map_t::iterator alloc_it = allocations_.find (key);
 
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "tizrmdb::release_resource : "
@@ -443,32 +557,23 @@ tiz_rm_error_t tizrmdb::release_resource (
 
   // Check that the component is provisioned and is allowed to access the
   // resource
-  if (!comp_provisioned_with_resid (cname, rid))
+  if (prov_it == provisions_.end ())
   {
     TIZ_LOG (TIZ_PRIORITY_TRACE, "'%s' is not provisioned...", cname.c_str ());
     return TIZ_RM_COMPONENT_NOT_PROVISIONED;
   }
 
-  requirement = strtol (vdata_[vdata_.size () - 1].c_str (), NULL, 0);
-  // TODO: Replace this with proper error check
-  assert (requirement >= 0);
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE,
-           "'%s': provisioned requirement [%d] units, "
-           "actually requested [%d] ...",
-           cname.c_str (), requirement, quantity);
-
-  if (quantity > (unsigned int)requirement)
+  if (quantity > prov_it->second)
   {
     TIZ_LOG (TIZ_PRIORITY_TRACE,
              "'%s': releasing [%d] units, "
              "but provisioned only [%d]",
-             cname.c_str (), quantity, requirement);
+             cname.c_str (), quantity, prov_it->second);
     return TIZ_RM_NOT_ENOUGH_RESOURCE_PROVISIONED;
   }
 
   // Check that the resource was effectively acquired by the component
-  if (!resource_acquired (uuid, rid, quantity))
+  if (alloc_it == allocations_.end () || alloc_it->second.quantity_ < quantity)
   {
     TIZ_LOG (TIZ_PRIORITY_TRACE,
              "Resource [%d] cannot be released: "
@@ -477,76 +582,27 @@ tiz_rm_error_t tizrmdb::release_resource (
     return TIZ_RM_NOT_ENOUGH_RESOURCE_ACQUIRED;
   }
 
-  current = strtol (vdata_[vdata_.size () - 1].c_str (), NULL, 0);
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE,
-           "Resource [%d]: current allocation [%d] units ...", rid, current);
-
-  tiz_uuid_str (&uuid[0], uuid_str);
-
-  // Update allocation table to reflect the resource release...
-
-  // ... first delete the the row...
-  snprintf (query, sizeof (query),
-            "delete from allocation where "
-            "cname='%s' and uuid='%s' and resid=%d",
-            cname.c_str (), uuid_str, rid);
-
-  rc = run_query (query);
-
-  if (SQLITE_OK != rc)
-  {
-    TIZ_LOG (TIZ_PRIORITY_TRACE,
-             "'%s' : Could not update allocation "
-             "table ",
-             cname.c_str ());
-    return TIZ_RM_DATABASE_ACCESS_ERROR;
-  }
-
-  //... now create a new one, only if there's some resource allocation
-  // remaining
-  if (current - quantity)
-  {
-    // TODO : This string is duplicated. Move to a constant
-    snprintf (query, sizeof (query),
-              "insert or replace into allocation (cname, uuid, grpid, pri, "
-              "resid, allocation) values('%s', '%s', %d, %d, %d, %d)",
-              cname.c_str (), uuid_str, grpid, pri, rid, current - quantity);
-
-    rc = run_query (query);
-
-    if (SQLITE_OK != rc)
-    {
-      TIZ_LOG (TIZ_PRIORITY_TRACE, "'%s' : Could not update allocation table",
-               cname.c_str ());
-      return TIZ_RM_DATABASE_ACCESS_ERROR;
-    }
-  }
-
-  // Now, obtain the current resource availability
-  if (!resource_available (rid, 0))
+  if (res_it == resources_.end ())
   {
     TIZ_LOG (TIZ_PRIORITY_TRACE, "Resource [%d] not available...", rid);
     return TIZ_RM_NOT_ENOUGH_RESOURCE_AVAILABLE;
   }
 
-  current = strtol (vdata_[vdata_.size () - 1].c_str (), NULL, 0);
-
-  // Now update the resource table...
-  snprintf (query, sizeof (query),
-            "update resources set current=%d where resid=%d",
-            current + quantity, rid);
-
-  rc = run_query (query);
-
-  if (SQLITE_OK != rc)
+  // Keep the remaining allocation, if any
+  if (alloc_it->second.quantity_ - quantity)
   {
-    TIZ_LOG (TIZ_PRIORITY_TRACE,
-             "Could not update resource table "
-             "for resource [%s]",
-             rid);
-    return TIZ_RM_DATABASE_ACCESS_ERROR;
+    alloc_it->second.quantity_ -= quantity;
+    alloc_it->second.grpid_ = grpid;
+    alloc_it->second.pri_ = pri;
+    alloc_it->second.seq_ = ++alloc_seq_;
   }
+  else
+  {
+    allocations_.erase (alloc_it);
+  }
+  res_it->second.current_ += quantity;
+  dirty_allocations_.insert (key);
+  dirty_resources_.insert (rid);
 
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "'%s' : Succesfully released [%d] units of "
@@ -559,74 +615,31 @@ tiz_rm_error_t tizrmdb::release_resource (
 tiz_rm_error_t tizrmdb::release_all (const std::string &cname,
                                      const std::vector< unsigned char > &uuid)
 {
-  int rc = SQLITE_OK;
-  char query[500];
-  char uuid_str[129];
-  int current = 0;
-  int remaining = 0;
-
-  tiz_uuid_str (&uuid[0], uuid_str);
-
   TIZ_LOG (TIZ_PRIORITY_TRACE,
-           "tizrmdb::release_all : Releasing resources for "
-           "component with uuid [%s]",
-           uuid_str);
+           "tizrmdb::release_all : '%s' : Releasing resources", cname.c_str ());
 
-  for (int rid = 0; rid < TIZ_RM_RESOURCE_MAX; ++rid)
+  for (unsigned int rid = 0; rid < TIZ_RM_RESOURCE_MAX; ++rid)
   {
-    if (resource_acquired (uuid, rid, 0))
+    const alloc_key_t key (uuid, rid);
+    allocations_map_t::iterator alloc_it = allocations_.find (key);
+    if (alloc_it != allocations_.end ())
     {
-      const std::string cname = vdata_[0];
-      current = strtol (vdata_[vdata_.size () - 1].c_str (), NULL, 0);
-
-      TIZ_LOG (TIZ_PRIORITY_TRACE,
-               "'%s' uuid [%s] : Resource [%d] "
-               "current allocation is "
-               "[%d] units ...",
-               cname.c_str (), uuid_str, rid, current);
+      const unsigned int current = alloc_it->second.quantity_;
+      resources_map_t::iterator res_it = resources_.find (rid);
 
-      // Update allocation table to reflect the resource release...
-      snprintf (query, sizeof (query),
-                "delete from allocation where "
-                "cname='%s' and uuid='%s' and resid=%d",
-                cname.c_str (), uuid_str, rid);
-
-      rc = run_query (query);
-
-      if (SQLITE_OK != rc)
+      if (res_it != resources_.end ())
       {
-        TIZ_LOG (TIZ_PRIORITY_TRACE,
-                 "'%s' : Could not update allocation "
-                 "table ",
-                 cname.c_str ());
-        return TIZ_RM_DATABASE_ACCESS_ERROR;
-      }
-
-      // Now, obtain the current resource availability
-      resource_available (rid, 0);
-
-      remaining = strtol (vdata_[vdata_.size () - 1].c_str (), NULL, 0);
-
-      // Now update the resource table...
-      snprintf (query, sizeof (query),
-                "update resources set current=%d where resid=%d",
-                remaining + current, rid);
-
-      rc = run_query (query);
-
-      if (SQLITE_OK != rc)
-      {
-        TIZ_LOG (TIZ_PRIORITY_TRACE,
-                 "Could not update resource table "
-                 "for resource [%s]",
-                 rid);
-        return TIZ_RM_DATABASE_ACCESS_ERROR;
+        res_it->second.current_ += current;
+        dirty_resources_.insert (rid);
       }
 
       TIZ_LOG (TIZ_PRIORITY_TRACE,
                "'%s':  Released [%d] units of "
                "resource  id [%d]",
-               cname.c_str (), current, rid);
+               alloc_it->second.cname_.c_str (), current, rid);
+
+      allocations_.erase (alloc_it);
+      dirty_allocations_.insert (key);
     }
   }
 
@@ -637,8 +650,7 @@ tiz_rm_error_t tizrmdb::find_owners (const unsigned int &rid,
                                      const unsigned int &pri,
                                      tiz_rm_owners_list_t &owners) const
 {
-  int rc = SQLITE_OK;
-  char query[500];
+  std::vector< std::pair< unsigned long, tizrmowner > > found;
 
   TIZ_LOG (TIZ_PRIORITY_TRACE,
            "tizrmdb::find_owners : resource id [%d] "
@@ -647,41 +659,24 @@ tiz_rm_error_t tizrmdb::find_owners (const unsigned int &rid,
 
   owners.clear ();
 
-  snprintf (query, sizeof (query),
-            "select * from allocation where resid='%d' and pri>'%d'", rid, pri);
-
-  rc = run_query (query);
-
-  if (SQLITE_OK != rc)
+  for (allocations_map_t::const_iterator it = allocations_.begin ();
+       it != allocations_.end (); ++it)
   {
-    return TIZ_RM_DATABASE_ERROR;
+    const allocation &alloc = it->second;
+    if (it->first.second == rid && alloc.pri_ > pri)
+    {
+      found.push_back (std::make_pair (
+          alloc.seq_, tizrmowner (alloc.cname_, it->first.first, alloc.grpid_,
+                                  alloc.pri_, rid, alloc.quantity_)));
+    }
   }
 
-  int headingsize = vcol_head_.size ();
-  int datasize = vdata_.size ();
-  int num_cols = headingsize ? datasize / headingsize : 0;
-  for (int i = 0; i < num_cols; ++i)
+  // Owners are listed in allocation order, the same order in which the rows
+  // were stored in the allocation table
+  std::sort (found.begin (), found.end (), by_seq ());
+  for (size_t i = 0; i < found.size (); ++i)
   {
-    int idx = i * headingsize;
-    std::vector< unsigned char > uuid_vec;
-    OMX_UUIDTYPE uuid_array;
-    tiz_str_uuid (vdata_[idx + 1].data (), &uuid_array);
-
-    uuid_vec.assign (&uuid_array[0], &uuid_array[0] + 128);
-
-    int owner_grpid = strtol (vdata_[idx + 2].c_str (), NULL, 0);
-    int owner_pri = strtol (vdata_[idx + 3].c_str (), NULL, 0);
-    int owner_rid = strtol (vdata_[idx + 4].c_str (), NULL, 0);
-    int owner_quantity = strtol (vdata_[idx + 5].c_str (), NULL, 0);
-
-    TIZ_LOG (TIZ_PRIORITY_TRACE,
-             "tizrmdb::find_owners : owner [%s] "
-             "uuid [%s] grpid [%d] pri [%d] rid [%d] quantity [%d]",
-             vdata_[idx].c_str (), vdata_[idx + 1].c_str (), owner_grpid,
-             owner_pri, owner_rid, owner_quantity);
-
-    owners.push_back (tizrmowner (vdata_[idx], uuid_vec, owner_grpid, owner_pri,
-                                  owner_rid, owner_quantity));
+    owners.push_back (found[i].second);
   }
 
   // Sort the owners list in ascending priority order, using tizrmowner's
@@ -697,84 +692,6 @@ tiz_rm_error_t tizrmdb::find_owners (const unsigned int &rid,
   return TIZ_RM_SUCCESS;
 }
 
-int tizrmdb::run_query (char const *ap_sql)
-{
-  int rc = SQLITE_OK;
-  char *p_errmsg;
-  char **pp_result;
-  int nrow, ncol;
-
-  assert (ap_sql);
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE, "Running query [%s]", ap_sql);
-
-  vcol_head_.clear ();
-  vdata_.clear ();
-
-  rc = sqlite3_get_table (pdb_, ap_sql, &pp_result, &nrow, &ncol, &p_errmsg);
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE, "Running query [%s] rc [%d] nrow [%d] ncol [%d]",
-           ap_sql, rc, nrow, ncol);
-
-  if (SQLITE_OK == rc)
-  {
-    for (int i = 0; i < ncol; ++i)
-    {
-      vcol_head_.push_back (pp_result[i]);
-    }
-
-    for (int i = 0; i < ncol * nrow; ++i)
-    {
-      vdata_.push_back (pp_result[ncol + i]);
-    }
-  }
-  else
-  {
-    TIZ_LOG (TIZ_PRIORITY_TRACE, "Query execution failure: [%s] - [%s]",
-             sqlite_error_str (rc).c_str (), p_errmsg);
-  }
-
-  TIZ_LOG (TIZ_PRIORITY_TRACE, "Run query [%s] rc [%d]", ap_sql, rc);
-
-  sqlite3_free_table (pp_result);
-
-  print_query_result ();
-
-  return rc;
-}
-
-int tizrmdb::run_query (char const *ap_sql) const
-{
-  return const_cast< tizrmdb * > (this)->run_query (ap_sql);
-}
-
-void tizrmdb::print_query_result () const
-{
-  TIZ_LOG (TIZ_PRIORITY_TRACE,
-           "tizrmdb::print_query_result : vdata_.size() [%d]"
-           " vcol_head_.size() [%d]",
-           vdata_.size (), vcol_head_.size ());
-
-  if (!vcol_head_.empty ())
-  {
-    int headingsize = vcol_head_.size ();
-    std::stringstream headings;
-    for (int i = 0; i < headingsize; ++i)
-    {
-      headings << "[" << vcol_head_[i] << "] \t\t\t ";
-    }
-    TIZ_LOG (TIZ_PRIORITY_TRACE, "%s", headings.str ().c_str ());
-
-    int datasize = vdata_.size ();
-    std::stringstream data;
-    for (int i = 0; i < datasize; ++i)
-    {
-      data << "[" << vdata_[i] << "] \t\t ";
-    }
-    TIZ_LOG (TIZ_PRIORITY_TRACE, "%s", data.str ().c_str ());
-  }
-}
-
 std::string tizrmdb::sqlite_error_str (int error) const
 {
   switch (error)
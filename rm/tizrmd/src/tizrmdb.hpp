@@ -29,13 +29,25 @@
 #define TIZRMDB_HPP
 
 class sqlite3;
+struct sqlite3_stmt;
 
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <tizrmtypes.h>
 
 #include "tizrmowner.hpp"
 
+/**
+ * The resources, components and allocation tables are loaded into memory at
+ * connection time. All queries are answered from memory, which is the
+ * authoritative copy of the data while the daemon runs. Modifications are
+ * written behind to the database file by 'flush', in a single transaction
+ * that uses cached prepared statements.
+ */
 class tizrmdb
 {
 
@@ -80,6 +92,51 @@ public:
   bool comp_provisioned_with_resid (const std::string &cname,
                                     const unsigned int &rid) const;
 
+  /**
+   * Persist all the pending modifications to the database file.
+   */
+  tiz_rm_error_t flush ();
+
+private:
+  enum stmt_id
+  {
+    EStmtBegin = 0,
+    EStmtCommit,
+    EStmtRollback,
+    EStmtUpdateCurrent,
+    EStmtDeleteAllocation,
+    EStmtInsertAllocation,
+    EStmtMax
+  };
+
+  struct resource
+  {
+    resource () : initial_ (0), current_ (0)
+    {
+    }
+    int initial_;
+    int current_;
+  };
+
+  struct allocation
+  {
+    allocation () : grpid_ (0), pri_ (0), quantity_ (0), seq_ (0)
+    {
+    }
+    std::string cname_;
+    unsigned int grpid_;
+    unsigned int pri_;
+    unsigned int quantity_;
+    // Insertion order, as rows would appear in the allocation table
+    unsigned long seq_;
+  };
+
+  typedef std::pair< std::vector< unsigned char >, unsigned int > alloc_key_t;
+  typedef std::pair< std::string, unsigned int > prov_key_t;
+  typedef std::map< unsigned int, resource > resources_map_t;
+  typedef std::map< prov_key_t, unsigned int > provisions_map_t;
+  typedef std::map< alloc_key_t, allocation > allocations_map_t;
+
 private:
   // Disallow copy constructor
   tizrmdb (const tizrmdb &);
@@ -88,18 +145,25 @@ private:
   int open (char const *ap_dbname);
   int close ();
   int reset_alloc_table ();
+  int prepare_statements ();
+  void finalize_statements ();
+  int load_tables ();
+  int run_stmt (const stmt_id id);
+  int write_allocation (const alloc_key_t &key);
 
-  int run_query (char const *ap_sql);
-  int run_query (char const *ap_sql) const;
-
-  void print_query_result () const;
   std::string sqlite_error_str (int error) const;
 
 private:
   sqlite3 *pdb_;
   std::string dbname_;
-  mutable std::vector< std::string > vcol_head_;
-  mutable std::vector< std::string > vdata_;
+  sqlite3_stmt *stmts_[EStmtMax];
+  resources_map_t resources_;
+  provisions_map_t provisions_;
+  std::set< std::string > comps_;
+  allocations_map_t allocations_;
+  unsigned long alloc_seq_;
+  std::set< unsigned int > dirty_resources_;
+  std::set< alloc_key_t > dirty_allocations_;
 };
 
 #endif  // TIZRMDB_HPP